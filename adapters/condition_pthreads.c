@@ -64,6 +64,28 @@ COND_RESULT Condition_Post(COND_HANDLE handle)
     return result;
 }
 
+COND_RESULT Condition_PostAll(COND_HANDLE handle)
+{
+    COND_RESULT result;
+    // Codes_SRS_CONDITION_01_001: [ Condition_PostAll shall return COND_INVALID_ARG if handle is NULL ]
+    if (handle == NULL)
+    {
+        result = COND_INVALID_ARG;
+    }
+    // Codes_SRS_CONDITION_01_002: [ Condition_PostAll shall unblock every thread waiting on the condition and return COND_OK ]
+    else if (pthread_cond_broadcast((pthread_cond_t*)handle) == 0)
+    {
+        result = COND_OK;
+    }
+    else
+    {
+        // Codes_SRS_CONDITION_01_003: [ Condition_PostAll shall return COND_ERROR if it fails to unblock the waiting threads ]
+        LogError("Failed to pthread_cond_broadcast");
+        result = COND_ERROR;
+    }
+    return result;
+}
+
 COND_RESULT Condition_Wait(COND_HANDLE handle, LOCK_HANDLE lock, int timeout_milliseconds)
 {
     COND_RESULT result;
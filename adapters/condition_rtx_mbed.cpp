@@ -25,6 +25,20 @@ COND_RESULT Condition_Post(COND_HANDLE handle)
     return result;
 }
 
+COND_RESULT Condition_PostAll(COND_HANDLE handle)
+{
+    COND_RESULT result;
+    if (handle == NULL)
+    {
+        result = COND_INVALID_ARG;
+    }
+    else
+    {
+        result = COND_ERROR;
+    }
+    return result;
+}
+
 COND_RESULT Condition_Wait(COND_HANDLE  handle, LOCK_HANDLE lock, int timeout_milliseconds)
 {
     COND_RESULT result;
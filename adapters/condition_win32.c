@@ -4,16 +4,22 @@
 #include <stdlib.h>
 
 #include "azure_c_shared_utility/condition.h"
+#include <limits.h>
 #include "windows.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/gballoc.h"
 
 DEFINE_ENUM_STRINGS(COND_RESULT, COND_RESULT_VALUES);
 
+/*waiters take a permit of the semaphore. The counts are kept under guard so that permits are only
+released for waiters that have none pending: pending_signal_count never exceeds waiting_thread_count,
+so posts without waiters are lost like pthread signals and no permit outlives the waiters*/
 typedef struct CONDITION_TAG
 {
-    volatile LONG waiting_thread_count;
-    HANDLE event_handle;
+    SRWLOCK guard;
+    LONG waiting_thread_count;
+    LONG pending_signal_count;
+    HANDLE semaphore_handle;
 }
 CONDITION;
 
@@ -26,18 +32,20 @@ COND_HANDLE Condition_Init(void)
     // Codes_SRS_CONDITION_18_008: [ Condition_Init shall return NULL if it fails to allocate the CONDITION_HANDLE ]
     if (cond != NULL)
     {
-        cond->event_handle = CreateEvent(NULL, FALSE, FALSE, NULL);
+        cond->semaphore_handle = CreateSemaphoreW(NULL, 0, LONG_MAX, NULL);
 
-        if (cond->event_handle == INVALID_HANDLE_VALUE)
+        if (cond->semaphore_handle == NULL)
         {
-            LogError("CreateEvent failed with error %d", GetLastError());
+            LogError("CreateSemaphore failed with error %d", GetLastError());
             free(cond);
             cond = NULL;
         }
         else
         {
-            /* Needed to emulate pthread_signal as we only signal the event when there are waiting threads */
+            /* Needed to emulate pthread_signal as we only release the semaphore when there are waiting threads */
+            InitializeSRWLock(&cond->guard);
             cond->waiting_thread_count = 0;
+            cond->pending_signal_count = 0;
         }
     }
     else
@@ -62,18 +70,70 @@ COND_RESULT Condition_Post(COND_HANDLE handle)
     {
         CONDITION* cond = (CONDITION*)handle;
 
-        /* Emulate pthreads signalling, by only unblocking *one* waiting thread if there is one waiting */
-        if (cond->waiting_thread_count == 0 || SetEvent(cond->event_handle))
+        AcquireSRWLockExclusive(&cond->guard);
+
+        /* Emulate pthreads signalling, by only unblocking *one* waiting thread if there is one not already unblocked */
+        // Codes_SRS_CONDITION_01_004: [ A post shall only unblock threads that are waiting on the condition when it is made; posts beyond the number of waiters shall not unblock a later Condition_Wait ]
+        if (cond->pending_signal_count >= cond->waiting_thread_count)
         {
             // Codes_SRS_CONDITION_18_003: [ Condition_Post shall return COND_OK if it succcessfully posts the condition ]
             result = COND_OK;
         }
+        else if (ReleaseSemaphore(cond->semaphore_handle, 1, NULL))
+        {
+            cond->pending_signal_count++;
+            result = COND_OK;
+        }
+        else
+        {
+            LogError("Failed ReleaseSemaphore call with error %d", GetLastError());
+
+            result = COND_ERROR;
+        }
+
+        ReleaseSRWLockExclusive(&cond->guard);
+    }
+    return result;
+}
+
+COND_RESULT Condition_PostAll(COND_HANDLE handle)
+{
+    COND_RESULT result;
+    if (handle == NULL)
+    {
+        LogError("Null argument handle passed to Condition_PostAll");
+
+        // Codes_SRS_CONDITION_01_001: [ Condition_PostAll shall return COND_INVALID_ARG if handle is NULL ]
+        result = COND_INVALID_ARG;
+    }
+    else
+    {
+        CONDITION* cond = (CONDITION*)handle;
+        LONG unsignalled_thread_count;
+
+        AcquireSRWLockExclusive(&cond->guard);
+
+        unsignalled_thread_count = cond->waiting_thread_count - cond->pending_signal_count;
+
+        // Codes_SRS_CONDITION_01_002: [ Condition_PostAll shall unblock every thread waiting on the condition and return COND_OK ]
+        if (unsignalled_thread_count <= 0)
+        {
+            result = COND_OK;
+        }
+        else if (ReleaseSemaphore(cond->semaphore_handle, unsignalled_thread_count, NULL))
+        {
+            cond->pending_signal_count += unsignalled_thread_count;
+            result = COND_OK;
+        }
         else
         {
-            LogError("Failed SetEvent call with error %d", GetLastError());
+            // Codes_SRS_CONDITION_01_003: [ Condition_PostAll shall return COND_ERROR if it fails to unblock the waiting threads ]
+            LogError("Failed ReleaseSemaphore call with error %d", GetLastError());
 
             result = COND_ERROR;
         }
+
+        ReleaseSRWLockExclusive(&cond->guard);
     }
     return result;
 }
@@ -89,52 +149,75 @@ COND_RESULT Condition_Wait(COND_HANDLE handle, LOCK_HANDLE lock, int timeout_mil
     {
         result = COND_INVALID_ARG;
     }
-    else if (Unlock(lock) == 0)
+    else
     {
         CONDITION* cond = (CONDITION*)handle;
-        DWORD wait_result;
 
-        /* Increment the waiting thread count, unlock the lock and wait */
-        (void)InterlockedIncrement(&cond->waiting_thread_count);
+        /* Increment the waiting thread count while still holding the lock, so that a post made after the unlock counts this thread */
+        AcquireSRWLockExclusive(&cond->guard);
+        cond->waiting_thread_count++;
+        ReleaseSRWLockExclusive(&cond->guard);
 
-        // Codes_SRS_CONDITION_18_013: [ Condition_Wait shall accept relative timeouts ]
-        wait_result = WaitForSingleObject(cond->event_handle, timeout_milliseconds == 0 ? INFINITE : timeout_milliseconds);
-
-        /* If we unlocked ok, it means the lock handle is valid, lock must succeed since it wraps EnterCriticalSection */
-        (void)Lock(lock);
-
-        if (wait_result != WAIT_OBJECT_0 && wait_result != WAIT_TIMEOUT)
+        if (Unlock(lock) != 0)
         {
-            LogError("Failed wait, wait returned with %x", wait_result);
-
-            /* cond might be freed at this point, just return error and do not touch condition */
+            AcquireSRWLockExclusive(&cond->guard);
+            cond->waiting_thread_count--;
+            ReleaseSRWLockExclusive(&cond->guard);
+            LogError("Invalid lock passed which failed to unlock");
             result = COND_ERROR;
         }
         else
         {
-            /* To handle the chance of a race condition reset the event again when there are no more waiting threads */
-            if (InterlockedDecrement(&cond->waiting_thread_count) == 0)
-            {
-                (void)ResetEvent(cond->event_handle);
-            }
+            DWORD wait_result;
+
+            // Codes_SRS_CONDITION_18_013: [ Condition_Wait shall accept relative timeouts ]
+            wait_result = WaitForSingleObject(cond->semaphore_handle, timeout_milliseconds == 0 ? INFINITE : timeout_milliseconds);
 
-            if (wait_result == WAIT_TIMEOUT)
+            /* If we unlocked ok, it means the lock handle is valid, lock must succeed since it wraps a semaphore wait */
+            (void)Lock(lock);
+
+            if (wait_result != WAIT_OBJECT_0 && wait_result != WAIT_TIMEOUT)
             {
-                // Codes_SRS_CONDITION_18_011: [ Condition_Wait shall return COND_TIMEOUT if the condition is NOT triggered and timeout_milliseconds is not 0 ]
-                result = COND_TIMEOUT;
+                LogError("Failed wait, wait returned with %x", wait_result);
+
+                /* cond might be freed at this point, just return error and do not touch condition */
+                result = COND_ERROR;
             }
             else
             {
-                // Codes_SRS_CONDITION_18_012: [ Condition_Wait shall return COND_OK if the condition is triggered and timeout_milliseconds is not 0 ]
-                result = COND_OK;
+                AcquireSRWLockExclusive(&cond->guard);
+
+                cond->waiting_thread_count--;
+
+                /* A post that raced with the timeout left a permit that no remaining waiter is counted for: take it,
+                so that it does not wake a later wait that nothing posted for */
+                if ((wait_result == WAIT_TIMEOUT) &&
+                    (cond->pending_signal_count > cond->waiting_thread_count) &&
+                    (WaitForSingleObject(cond->semaphore_handle, 0) == WAIT_OBJECT_0))
+                {
+                    wait_result = WAIT_OBJECT_0;
+                }
+
+                if (wait_result == WAIT_OBJECT_0)
+                {
+                    cond->pending_signal_count--;
+                }
+
+                ReleaseSRWLockExclusive(&cond->guard);
+
+                if (wait_result == WAIT_TIMEOUT)
+                {
+                    // Codes_SRS_CONDITION_18_011: [ Condition_Wait shall return COND_TIMEOUT if the condition is NOT triggered and timeout_milliseconds is not 0 ]
+                    result = COND_TIMEOUT;
+                }
+                else
+                {
+                    // Codes_SRS_CONDITION_18_012: [ Condition_Wait shall return COND_OK if the condition is triggered and timeout_milliseconds is not 0 ]
+                    result = COND_OK;
+                }
             }
         }
     }
-    else
-    {
-        LogError("Invalid lock passed which failed to unlock");
-        result = COND_ERROR;
-    }
     return result;
 }
 
@@ -146,8 +229,8 @@ void Condition_Deinit(COND_HANDLE handle)
     {
         CONDITION* cond = (CONDITION*)handle;
 
-        (void)CloseHandle(cond->event_handle);
-        cond->event_handle = INVALID_HANDLE_VALUE;
+        (void)CloseHandle(cond->semaphore_handle);
+        cond->semaphore_handle = NULL;
 
         free(cond);
     }
@@ -0,0 +1,898 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/event_loop.h"
+#include "azure_c_shared_utility/doublylinkedlist.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+/*
+ * Descriptors are watched with a level triggered epoll instance and timers are kept in a
+ * binary min-heap ordered by due time, so one iteration of the loop costs one epoll_wait
+ * plus the work of the descriptors and timers that are actually ready. An eventfd
+ * registered with a NULL watch wakes the loop up when event_loop_stop is called from
+ * another thread.
+ */
+
+#define EVENT_LOOP_MAX_EVENTS           64
+#define TIMER_HEAP_INITIAL_CAPACITY     16
+#define TIMER_NOT_IN_HEAP               SIZE_MAX
+
+typedef struct EVENT_LOOP_TAG
+{
+    int epoll_fd;
+    int wake_fd;
+    TICK_COUNTER_HANDLE tick_counter;
+    DLIST_ENTRY watches;
+    /*watches released while events are being dispatched, freed once the dispatch is over*/
+    DLIST_ENTRY released_watches;
+    bool dispatching;
+    DLIST_ENTRY timers;
+    struct EVENT_LOOP_TIMER_TAG** timer_heap;
+    size_t timer_count;
+    size_t timer_capacity;
+    bool stop_requested;
+} EVENT_LOOP;
+
+typedef struct EVENT_LOOP_WATCH_TAG
+{
+    EVENT_LOOP* event_loop;
+    DLIST_ENTRY entry;
+    int fd;
+    unsigned int events;
+    ON_EVENT_LOOP_FD_READY on_fd_ready;
+    void* context;
+    bool released;
+} EVENT_LOOP_WATCH;
+
+typedef struct EVENT_LOOP_TIMER_TAG
+{
+    EVENT_LOOP* event_loop;
+    DLIST_ENTRY entry;
+    tickcounter_ms_t due_ms;
+    uint32_t period_ms;
+    ON_EVENT_LOOP_TIMER on_timer;
+    void* context;
+    size_t heap_index;
+    bool firing;
+    bool cancelled;
+} EVENT_LOOP_TIMER;
+
+/*a descriptor of a driven xio and the watch the loop keeps for it*/
+typedef struct XIO_FD_TAG
+{
+    DLIST_ENTRY entry;
+    int fd;
+    EVENT_LOOP_WATCH_HANDLE watch;
+} XIO_FD;
+
+typedef struct EVENT_LOOP_XIO_TAG
+{
+    EVENT_LOOP* event_loop;
+    XIO_HANDLE xio;
+    EVENT_LOOP_TIMER_HANDLE housekeeping_timer;
+    DLIST_ENTRY fds;
+} EVENT_LOOP_XIO;
+
+static uint32_t to_epoll_events(unsigned int events)
+{
+    uint32_t result = 0;
+
+    if ((events & EVENT_LOOP_READABLE) != 0)
+    {
+        result |= EPOLLIN;
+    }
+    if ((events & EVENT_LOOP_WRITABLE) != 0)
+    {
+        result |= EPOLLOUT;
+    }
+
+    return result;
+}
+
+/*errors and hang ups are reported as every event the watch waits for, so the owner finds them when it reads or writes*/
+static unsigned int from_epoll_events(uint32_t epoll_events, unsigned int watched_events)
+{
+    unsigned int result;
+
+    if ((epoll_events & (EPOLLERR | EPOLLHUP)) != 0)
+    {
+        result = watched_events;
+    }
+    else
+    {
+        result = 0;
+        if ((epoll_events & EPOLLIN) != 0)
+        {
+            result |= EVENT_LOOP_READABLE;
+        }
+        if ((epoll_events & EPOLLOUT) != 0)
+        {
+            result |= EVENT_LOOP_WRITABLE;
+        }
+        result &= watched_events;
+    }
+
+    return result;
+}
+
+static void timer_heap_swap(EVENT_LOOP* event_loop, size_t a, size_t b)
+{
+    EVENT_LOOP_TIMER* timer = event_loop->timer_heap[a];
+    event_loop->timer_heap[a] = event_loop->timer_heap[b];
+    event_loop->timer_heap[b] = timer;
+    event_loop->timer_heap[a]->heap_index = a;
+    event_loop->timer_heap[b]->heap_index = b;
+}
+
+static void timer_heap_sift_up(EVENT_LOOP* event_loop, size_t index)
+{
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+        if (event_loop->timer_heap[parent]->due_ms <= event_loop->timer_heap[index]->due_ms)
+        {
+            break;
+        }
+        timer_heap_swap(event_loop, parent, index);
+        index = parent;
+    }
+}
+
+static void timer_heap_sift_down(EVENT_LOOP* event_loop, size_t index)
+{
+    for (;;)
+    {
+        size_t smallest = index;
+        size_t left = (index * 2) + 1;
+        size_t right = left + 1;
+
+        if ((left < event_loop->timer_count) && (event_loop->timer_heap[left]->due_ms < event_loop->timer_heap[smallest]->due_ms))
+        {
+            smallest = left;
+        }
+        if ((right < event_loop->timer_count) && (event_loop->timer_heap[right]->due_ms < event_loop->timer_heap[smallest]->due_ms))
+        {
+            smallest = right;
+        }
+        if (smallest == index)
+        {
+            break;
+        }
+        timer_heap_swap(event_loop, smallest, index);
+        index = smallest;
+    }
+}
+
+static int timer_heap_push(EVENT_LOOP* event_loop, EVENT_LOOP_TIMER* timer)
+{
+    int result;
+
+    if (event_loop->timer_count == event_loop->timer_capacity)
+    {
+        size_t new_capacity = (event_loop->timer_capacity == 0) ? TIMER_HEAP_INITIAL_CAPACITY : event_loop->timer_capacity * 2;
+        EVENT_LOOP_TIMER** new_heap = (EVENT_LOOP_TIMER**)realloc(event_loop->timer_heap, new_capacity * sizeof(EVENT_LOOP_TIMER*));
+        if (new_heap == NULL)
+        {
+            LogError("Cannot grow the timer heap");
+            result = __FAILURE__;
+        }
+        else
+        {
+            event_loop->timer_heap = new_heap;
+            event_loop->timer_capacity = new_capacity;
+            result = 0;
+        }
+    }
+    else
+    {
+        result = 0;
+    }
+
+    if (result == 0)
+    {
+        timer->heap_index = event_loop->timer_count;
+        event_loop->timer_heap[event_loop->timer_count] = timer;
+        event_loop->timer_count++;
+        timer_heap_sift_up(event_loop, timer->heap_index);
+    }
+
+    return result;
+}
+
+static void timer_heap_remove(EVENT_LOOP* event_loop, EVENT_LOOP_TIMER* timer)
+{
+    size_t index = timer->heap_index;
+
+    event_loop->timer_count--;
+    if (index != event_loop->timer_count)
+    {
+        timer_heap_swap(event_loop, index, event_loop->timer_count);
+        timer_heap_sift_down(event_loop, index);
+        timer_heap_sift_up(event_loop, index);
+    }
+    timer->heap_index = TIMER_NOT_IN_HEAP;
+}
+
+static void free_timer(EVENT_LOOP_TIMER* timer)
+{
+    if (timer->heap_index != TIMER_NOT_IN_HEAP)
+    {
+        timer_heap_remove(timer->event_loop, timer);
+    }
+    (void)DList_RemoveEntryList(&timer->entry);
+    free(timer);
+}
+
+static void free_released_watches(EVENT_LOOP* event_loop)
+{
+    while (!DList_IsListEmpty(&event_loop->released_watches))
+    {
+        PDLIST_ENTRY entry = DList_RemoveHeadList(&event_loop->released_watches);
+        free(containingRecord(entry, EVENT_LOOP_WATCH, entry));
+    }
+}
+
+/*milliseconds epoll_wait may sleep before the first timer is due, -1 for ever*/
+static int get_wait_timeout(EVENT_LOOP* event_loop, uint32_t max_wait_ms)
+{
+    int result;
+    uint32_t wait_ms = max_wait_ms;
+
+    if (event_loop->timer_count > 0)
+    {
+        tickcounter_ms_t now_ms;
+        if (tickcounter_get_current_ms(event_loop->tick_counter, &now_ms) != 0)
+        {
+            LogError("Cannot read the tick counter");
+            wait_ms = 0;
+        }
+        else if (event_loop->timer_heap[0]->due_ms <= now_ms)
+        {
+            wait_ms = 0;
+        }
+        else if (event_loop->timer_heap[0]->due_ms - now_ms < wait_ms)
+        {
+            wait_ms = (uint32_t)(event_loop->timer_heap[0]->due_ms - now_ms);
+        }
+    }
+
+    if (wait_ms == EVENT_LOOP_WAIT_INFINITE)
+    {
+        result = -1;
+    }
+    else if (wait_ms > INT_MAX)
+    {
+        result = INT_MAX;
+    }
+    else
+    {
+        result = (int)wait_ms;
+    }
+
+    return result;
+}
+
+static void dispatch_events(EVENT_LOOP* event_loop, const struct epoll_event* events, int count)
+{
+    int i;
+
+    event_loop->dispatching = true;
+    for (i = 0; i < count; i++)
+    {
+        EVENT_LOOP_WATCH* watch = (EVENT_LOOP_WATCH*)events[i].data.ptr;
+        if (watch == NULL)
+        {
+            uint64_t wake_count;
+            if (read(event_loop->wake_fd, &wake_count, sizeof(wake_count)) != (ssize_t)sizeof(wake_count))
+            {
+                LogError("Cannot read the wake up descriptor");
+            }
+            event_loop->stop_requested = true;
+        }
+        else if (!watch->released)
+        {
+            unsigned int ready_events = from_epoll_events(events[i].events, watch->events);
+            if (ready_events != 0)
+            {
+                /* Codes_SRS_EVENT_LOOP_01_011: [ When the descriptor is ready for one of the events of a watch, event_loop_run_once shall call on_fd_ready with the context and the ready events. ]*/
+                watch->on_fd_ready(watch->context, ready_events);
+            }
+        }
+    }
+    event_loop->dispatching = false;
+
+    free_released_watches(event_loop);
+}
+
+static void fire_due_timers(EVENT_LOOP* event_loop)
+{
+    tickcounter_ms_t now_ms;
+
+    if (tickcounter_get_current_ms(event_loop->tick_counter, &now_ms) != 0)
+    {
+        LogError("Cannot read the tick counter");
+    }
+    else
+    {
+        /*timers started or rescheduled by the callbacks are due after now_ms, so this ends*/
+        while ((event_loop->timer_count > 0) &&
+            (event_loop->timer_heap[0]->due_ms <= now_ms))
+        {
+            EVENT_LOOP_TIMER* timer = event_loop->timer_heap[0];
+            timer_heap_remove(event_loop, timer);
+
+            /* Codes_SRS_EVENT_LOOP_01_018: [ When a timer is due, event_loop_run_once shall call its on_timer with its context. ]*/
+            timer->firing = true;
+            timer->on_timer(timer->context);
+            timer->firing = false;
+
+            if (timer->cancelled)
+            {
+                /* Codes_SRS_EVENT_LOOP_01_021: [ A timer cancelled from its own on_timer shall be freed once on_timer returns. ]*/
+                free_timer(timer);
+            }
+            else if (timer->period_ms != 0)
+            {
+                /* Codes_SRS_EVENT_LOOP_01_019: [ A periodic timer shall be due again period_ms after its on_timer returns. ]*/
+                tickcounter_ms_t fired_ms;
+                if (tickcounter_get_current_ms(event_loop->tick_counter, &fired_ms) != 0)
+                {
+                    fired_ms = now_ms;
+                }
+                timer->due_ms = ((fired_ms > now_ms) ? fired_ms : now_ms) + timer->period_ms;
+                if (timer_heap_push(event_loop, timer) != 0)
+                {
+                    LogError("Cannot reschedule a periodic timer");
+                }
+            }
+        }
+    }
+}
+
+EVENT_LOOP_HANDLE event_loop_create(void)
+{
+    EVENT_LOOP* result;
+
+    /* Codes_SRS_EVENT_LOOP_01_001: [ event_loop_create shall allocate a loop, create an epoll instance, an eventfd registered with it and a tick counter. ]*/
+    result = (EVENT_LOOP*)malloc(sizeof(EVENT_LOOP));
+    if (result == NULL)
+    {
+        /* Codes_SRS_EVENT_LOOP_01_002: [ If any of the above fails, event_loop_create shall free everything it created and return NULL. ]*/
+        LogError("Cannot allocate the event loop");
+    }
+    else
+    {
+        result->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (result->epoll_fd < 0)
+        {
+            LogError("epoll_create1 failed, errno=%d", errno);
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            result->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (result->wake_fd < 0)
+            {
+                LogError("eventfd failed, errno=%d", errno);
+                (void)close(result->epoll_fd);
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                struct epoll_event wake_event;
+                wake_event.events = EPOLLIN;
+                wake_event.data.ptr = NULL;
+
+                if (epoll_ctl(result->epoll_fd, EPOLL_CTL_ADD, result->wake_fd, &wake_event) != 0)
+                {
+                    LogError("Cannot watch the wake up descriptor, errno=%d", errno);
+                    (void)close(result->wake_fd);
+                    (void)close(result->epoll_fd);
+                    free(result);
+                    result = NULL;
+                }
+                else if ((result->tick_counter = tickcounter_create()) == NULL)
+                {
+                    LogError("tickcounter_create failed");
+                    (void)close(result->wake_fd);
+                    (void)close(result->epoll_fd);
+                    free(result);
+                    result = NULL;
+                }
+                else
+                {
+                    DList_InitializeListHead(&result->watches);
+                    DList_InitializeListHead(&result->released_watches);
+                    DList_InitializeListHead(&result->timers);
+                    result->dispatching = false;
+                    result->timer_heap = NULL;
+                    result->timer_count = 0;
+                    result->timer_capacity = 0;
+                    result->stop_requested = false;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+void event_loop_destroy(EVENT_LOOP_HANDLE event_loop)
+{
+    if (event_loop == NULL)
+    {
+        /* Codes_SRS_EVENT_LOOP_01_003: [ If event_loop is NULL, event_loop_destroy shall return. ]*/
+        LogError("Invalid argument: event_loop is NULL");
+    }
+    else
+    {
+        /* Codes_SRS_EVENT_LOOP_01_004: [ event_loop_destroy shall free the watches and timers that were not released, close the descriptors of the loop and free it. ]*/
+        while (!DList_IsListEmpty(&event_loop->watches))
+        {
+            PDLIST_ENTRY entry = DList_RemoveHeadList(&event_loop->watches);
+            free(containingRecord(entry, EVENT_LOOP_WATCH, entry));
+        }
+        while (!DList_IsListEmpty(&event_loop->timers))
+        {
+            free_timer(containingRecord(event_loop->timers.Flink, EVENT_LOOP_TIMER, entry));
+        }
+
+        free(event_loop->timer_heap);
+        tickcounter_destroy(event_loop->tick_counter);
+        (void)close(event_loop->wake_fd);
+        (void)close(event_loop->epoll_fd);
+        free(event_loop);
+    }
+}
+
+int event_loop_run_once(EVENT_LOOP_HANDLE event_loop, uint32_t max_wait_ms)
+{
+    int result;
+
+    if (event_loop == NULL)
+    {
+        /* Codes_SRS_EVENT_LOOP_01_005: [ If event_loop is NULL, event_loop_run_once shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: event_loop is NULL");
+        result = __FAILURE__;
+    }
+    else
+    {
+        struct epoll_event events[EVENT_LOOP_MAX_EVENTS];
+
+        /* Codes_SRS_EVENT_LOOP_01_006: [ event_loop_run_once shall wait with epoll_wait up to max_wait_ms, or less if a timer is due earlier, or without limit if max_wait_ms is EVENT_LOOP_WAIT_INFINITE and no timer is running. ]*/
+        int count = epoll_wait(event_loop->epoll_fd, events, EVENT_LOOP_MAX_EVENTS, get_wait_timeout(event_loop, max_wait_ms));
+        if ((count < 0) && (errno != EINTR))
+        {
+            /* Codes_SRS_EVENT_LOOP_01_007: [ If epoll_wait fails, event_loop_run_once shall fail and return a non-zero value. ]*/
+            LogError("epoll_wait failed, errno=%d", errno);
+            result = __FAILURE__;
+        }
+        else
+        {
+            if (count > 0)
+            {
+                dispatch_events(event_loop, events, count);
+            }
+            fire_due_timers(event_loop);
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+int event_loop_run(EVENT_LOOP_HANDLE event_loop)
+{
+    int result;
+
+    if (event_loop == NULL)
+    {
+        /* Codes_SRS_EVENT_LOOP_01_008: [ If event_loop is NULL, event_loop_run shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: event_loop is NULL");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_EVENT_LOOP_01_009: [ event_loop_run shall call event_loop_run_once until event_loop_stop is called and then return 0, or return a non-zero value as soon as event_loop_run_once fails. ]*/
+        result = 0;
+        while ((result == 0) && !event_loop->stop_requested)
+        {
+            result = event_loop_run_once(event_loop, EVENT_LOOP_WAIT_INFINITE);
+        }
+        event_loop->stop_requested = false;
+    }
+
+    return result;
+}
+
+void event_loop_stop(EVENT_LOOP_HANDLE event_loop)
+{
+    if (event_loop == NULL)
+    {
+        LogError("Invalid argument: event_loop is NULL");
+    }
+    else
+    {
+        /* Codes_SRS_EVENT_LOOP_01_010: [ event_loop_stop shall write to the eventfd of the loop, which makes event_loop_run return after the current iteration. ]*/
+        uint64_t one = 1;
+        if (write(event_loop->wake_fd, &one, sizeof(one)) != (ssize_t)sizeof(one))
+        {
+            LogError("Cannot write the wake up descriptor, errno=%d", errno);
+        }
+    }
+}
+
+EVENT_LOOP_WATCH_HANDLE event_loop_watch_fd(EVENT_LOOP_HANDLE event_loop, int fd, unsigned int events, ON_EVENT_LOOP_FD_READY on_fd_ready, void* context)
+{
+    EVENT_LOOP_WATCH* result;
+
+    if ((event_loop == NULL) || (fd < 0) || (on_fd_ready == NULL))
+    {
+        /* Codes_SRS_EVENT_LOOP_01_012: [ If event_loop or on_fd_ready is NULL or fd is negative, event_loop_watch_fd shall fail and return NULL. ]*/
+        LogError("Invalid arguments: event_loop=%p, fd=%d, on_fd_ready=%p", event_loop, fd, on_fd_ready);
+        result = NULL;
+    }
+    else if ((result = (EVENT_LOOP_WATCH*)malloc(sizeof(EVENT_LOOP_WATCH))) == NULL)
+    {
+        /* Codes_SRS_EVENT_LOOP_01_013: [ If allocating the watch or adding fd to the epoll instance fails, event_loop_watch_fd shall fail and return NULL. ]*/
+        LogError("Cannot allocate the watch");
+    }
+    else
+    {
+        result->event_loop = event_loop;
+        result->fd = fd;
+        result->events = 0;
+        result->on_fd_ready = on_fd_ready;
+        result->context = context;
+        result->released = false;
+
+        /* Codes_SRS_EVENT_LOOP_01_014: [ event_loop_watch_fd shall add fd to the epoll instance for events and return the watch; a watch for no event is not added until its events are set. ]*/
+        if (event_loop_watch_set_events(result, events) != 0)
+        {
+            LogError("Cannot watch fd %d", fd);
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            DList_InsertTailList(&event_loop->watches, &result->entry);
+        }
+    }
+
+    return result;
+}
+
+int event_loop_watch_set_events(EVENT_LOOP_WATCH_HANDLE watch, unsigned int events)
+{
+    int result;
+
+    if (watch == NULL)
+    {
+        /* Codes_SRS_EVENT_LOOP_01_015: [ If watch is NULL, event_loop_watch_set_events shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: watch is NULL");
+        result = __FAILURE__;
+    }
+    else if (events == watch->events)
+    {
+        result = 0;
+    }
+    else
+    {
+        struct epoll_event epoll_event;
+        int operation;
+
+        /*a descriptor stays in the epoll instance only while it waits for something, else hang ups would still wake the loop*/
+        if (events == 0)
+        {
+            operation = EPOLL_CTL_DEL;
+        }
+        else if (watch->events == 0)
+        {
+            operation = EPOLL_CTL_ADD;
+        }
+        else
+        {
+            operation = EPOLL_CTL_MOD;
+        }
+
+        epoll_event.events = to_epoll_events(events);
+        epoll_event.data.ptr = watch;
+
+        /* Codes_SRS_EVENT_LOOP_01_016: [ event_loop_watch_set_events shall add, modify or remove the descriptor in the epoll instance so that it waits for events, and return 0. ]*/
+        if (epoll_ctl(watch->event_loop->epoll_fd, operation, watch->fd, &epoll_event) != 0)
+        {
+            /* Codes_SRS_EVENT_LOOP_01_017: [ If epoll_ctl fails, event_loop_watch_set_events shall fail and return a non-zero value. ]*/
+            LogError("epoll_ctl failed for fd %d, errno=%d", watch->fd, errno);
+            result = __FAILURE__;
+        }
+        else
+        {
+            watch->events = events;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+void event_loop_unwatch_fd(EVENT_LOOP_WATCH_HANDLE watch)
+{
+    if (watch == NULL)
+    {
+        /* Codes_SRS_EVENT_LOOP_01_022: [ If watch is NULL, event_loop_unwatch_fd shall return. ]*/
+        LogError("Invalid argument: watch is NULL");
+    }
+    else
+    {
+        EVENT_LOOP* event_loop = watch->event_loop;
+
+        /* Codes_SRS_EVENT_LOOP_01_023: [ event_loop_unwatch_fd shall remove the descriptor from the epoll instance and free the watch. ]*/
+        if (watch->events != 0)
+        {
+            (void)event_loop_watch_set_events(watch, 0);
+        }
+        (void)DList_RemoveEntryList(&watch->entry);
+
+        if (event_loop->dispatching)
+        {
+            /* Codes_SRS_EVENT_LOOP_01_024: [ A watch released while events are dispatched shall get no further callback and be freed once the dispatch is over. ]*/
+            watch->released = true;
+            DList_InsertTailList(&event_loop->released_watches, &watch->entry);
+        }
+        else
+        {
+            free(watch);
+        }
+    }
+}
+
+EVENT_LOOP_TIMER_HANDLE event_loop_timer_start(EVENT_LOOP_HANDLE event_loop, uint32_t delay_ms, uint32_t period_ms, ON_EVENT_LOOP_TIMER on_timer, void* context)
+{
+    EVENT_LOOP_TIMER* result;
+    tickcounter_ms_t now_ms;
+
+    if ((event_loop == NULL) || (on_timer == NULL))
+    {
+        /* Codes_SRS_EVENT_LOOP_01_025: [ If event_loop or on_timer is NULL, event_loop_timer_start shall fail and return NULL. ]*/
+        LogError("Invalid arguments: event_loop=%p, on_timer=%p", event_loop, on_timer);
+        result = NULL;
+    }
+    else if (tickcounter_get_current_ms(event_loop->tick_counter, &now_ms) != 0)
+    {
+        /* Codes_SRS_EVENT_LOOP_01_026: [ If reading the tick counter, allocating the timer or growing the heap fails, event_loop_timer_start shall fail and return NULL. ]*/
+        LogError("Cannot read the tick counter");
+        result = NULL;
+    }
+    else if ((result = (EVENT_LOOP_TIMER*)malloc(sizeof(EVENT_LOOP_TIMER))) == NULL)
+    {
+        LogError("Cannot allocate the timer");
+    }
+    else
+    {
+        result->event_loop = event_loop;
+        result->due_ms = now_ms + delay_ms;
+        result->period_ms = period_ms;
+        result->on_timer = on_timer;
+        result->context = context;
+        result->heap_index = TIMER_NOT_IN_HEAP;
+        result->firing = false;
+        result->cancelled = false;
+
+        /* Codes_SRS_EVENT_LOOP_01_027: [ event_loop_timer_start shall put the timer in the heap of the loop, due delay_ms from now, and return it. ]*/
+        if (timer_heap_push(event_loop, result) != 0)
+        {
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            DList_InsertTailList(&event_loop->timers, &result->entry);
+        }
+    }
+
+    return result;
+}
+
+void event_loop_timer_cancel(EVENT_LOOP_TIMER_HANDLE timer)
+{
+    if (timer == NULL)
+    {
+        /* Codes_SRS_EVENT_LOOP_01_028: [ If timer is NULL, event_loop_timer_cancel shall return. ]*/
+        LogError("Invalid argument: timer is NULL");
+    }
+    else if (timer->firing)
+    {
+        timer->cancelled = true;
+    }
+    else
+    {
+        /* Codes_SRS_EVENT_LOOP_01_020: [ event_loop_timer_cancel shall take the timer out of the heap and free it. ]*/
+        free_timer(timer);
+    }
+}
+
+static void on_xio_fd_ready(void* context, unsigned int events)
+{
+    EVENT_LOOP_XIO* event_loop_xio = (EVENT_LOOP_XIO*)context;
+    (void)events;
+
+    /* Codes_SRS_EVENT_LOOP_01_033: [ When a descriptor of the xio is ready, the loop shall call xio_dowork on the xio. ]*/
+    xio_dowork(event_loop_xio->xio);
+}
+
+static void on_xio_housekeeping(void* context)
+{
+    EVENT_LOOP_XIO* event_loop_xio = (EVENT_LOOP_XIO*)context;
+
+    /* Codes_SRS_EVENT_LOOP_01_034: [ Every housekeeping_ms the loop shall call xio_dowork on the xio. ]*/
+    xio_dowork(event_loop_xio->xio);
+}
+
+static XIO_FD* find_xio_fd(EVENT_LOOP_XIO* event_loop_xio, int fd)
+{
+    XIO_FD* result = NULL;
+    PDLIST_ENTRY entry = event_loop_xio->fds.Flink;
+
+    while (entry != &event_loop_xio->fds)
+    {
+        XIO_FD* xio_fd = containingRecord(entry, XIO_FD, entry);
+        if (xio_fd->fd == fd)
+        {
+            result = xio_fd;
+            break;
+        }
+        entry = entry->Flink;
+    }
+
+    return result;
+}
+
+static void free_xio_fd(XIO_FD* xio_fd)
+{
+    event_loop_unwatch_fd(xio_fd->watch);
+    (void)DList_RemoveEntryList(&xio_fd->entry);
+    free(xio_fd);
+}
+
+/*the set_interest of the XIO_EVENT_BINDING the loop hands to the xio*/
+static int set_xio_interest(void* context, int fd, unsigned int events)
+{
+    int result;
+    EVENT_LOOP_XIO* event_loop_xio = (EVENT_LOOP_XIO*)context;
+    XIO_FD* xio_fd = find_xio_fd(event_loop_xio, fd);
+
+    /* Codes_SRS_EVENT_LOOP_01_032: [ When the xio sets its interest in a descriptor, the loop shall watch the descriptor for those events, or stop watching it when events is 0. ]*/
+    if (xio_fd != NULL)
+    {
+        if (events == 0)
+        {
+            free_xio_fd(xio_fd);
+            result = 0;
+        }
+        else
+        {
+            result = event_loop_watch_set_events(xio_fd->watch, events);
+        }
+    }
+    else if (events == 0)
+    {
+        result = 0;
+    }
+    else if ((xio_fd = (XIO_FD*)malloc(sizeof(XIO_FD))) == NULL)
+    {
+        LogError("Cannot allocate the descriptor of the xio");
+        result = __FAILURE__;
+    }
+    else if ((xio_fd->watch = event_loop_watch_fd(event_loop_xio->event_loop, fd, events, on_xio_fd_ready, event_loop_xio)) == NULL)
+    {
+        LogError("Cannot watch the descriptor of the xio");
+        free(xio_fd);
+        result = __FAILURE__;
+    }
+    else
+    {
+        xio_fd->fd = fd;
+        DList_InsertTailList(&event_loop_xio->fds, &xio_fd->entry);
+        result = 0;
+    }
+
+    return result;
+}
+
+static void free_event_loop_xio(EVENT_LOOP_XIO* event_loop_xio)
+{
+    while (!DList_IsListEmpty(&event_loop_xio->fds))
+    {
+        free_xio_fd(containingRecord(event_loop_xio->fds.Flink, XIO_FD, entry));
+    }
+    if (event_loop_xio->housekeeping_timer != NULL)
+    {
+        event_loop_timer_cancel(event_loop_xio->housekeeping_timer);
+    }
+    free(event_loop_xio);
+}
+
+EVENT_LOOP_XIO_HANDLE event_loop_add_xio(EVENT_LOOP_HANDLE event_loop, XIO_HANDLE xio, uint32_t housekeeping_ms)
+{
+    EVENT_LOOP_XIO* result;
+
+    if ((event_loop == NULL) || (xio == NULL))
+    {
+        /* Codes_SRS_EVENT_LOOP_01_029: [ If event_loop or xio is NULL, event_loop_add_xio shall fail and return NULL. ]*/
+        LogError("Invalid arguments: event_loop=%p, xio=%p", event_loop, xio);
+        result = NULL;
+    }
+    else if ((result = (EVENT_LOOP_XIO*)malloc(sizeof(EVENT_LOOP_XIO))) == NULL)
+    {
+        /* Codes_SRS_EVENT_LOOP_01_030: [ If allocating, starting the housekeeping timer or setting the option fails, event_loop_add_xio shall free everything it created and return NULL. ]*/
+        LogError("Cannot allocate the xio of the loop");
+    }
+    else
+    {
+        result->event_loop = event_loop;
+        result->xio = xio;
+        result->housekeeping_timer = NULL;
+        DList_InitializeListHead(&result->fds);
+
+        if ((housekeeping_ms != 0) &&
+            ((result->housekeeping_timer = event_loop_timer_start(event_loop, housekeeping_ms, housekeeping_ms, on_xio_housekeeping, result)) == NULL))
+        {
+            LogError("Cannot start the housekeeping timer");
+            free_event_loop_xio(result);
+            result = NULL;
+        }
+        else
+        {
+            XIO_EVENT_BINDING event_binding;
+            event_binding.set_interest = set_xio_interest;
+            event_binding.context = result;
+
+            /* Codes_SRS_EVENT_LOOP_01_031: [ event_loop_add_xio shall set the OPTION_XIO_EVENT_BINDING option of the xio to a binding whose set_interest watches the descriptors of the xio, and return a handle for it. ]*/
+            if (xio_setoption(xio, OPTION_XIO_EVENT_BINDING, &event_binding) != 0)
+            {
+                LogError("The xio does not support OPTION_XIO_EVENT_BINDING");
+                free_event_loop_xio(result);
+                result = NULL;
+            }
+        }
+    }
+
+    return result;
+}
+
+void event_loop_remove_xio(EVENT_LOOP_XIO_HANDLE event_loop_xio)
+{
+    if (event_loop_xio == NULL)
+    {
+        /* Codes_SRS_EVENT_LOOP_01_035: [ If event_loop_xio is NULL, event_loop_remove_xio shall return. ]*/
+        LogError("Invalid argument: event_loop_xio is NULL");
+    }
+    else
+    {
+        XIO_EVENT_BINDING no_binding;
+        no_binding.set_interest = NULL;
+        no_binding.context = NULL;
+
+        /* Codes_SRS_EVENT_LOOP_01_036: [ event_loop_remove_xio shall set the OPTION_XIO_EVENT_BINDING option of the xio to a binding with a NULL set_interest, stop watching its descriptors, cancel the housekeeping timer and free the handle. ]*/
+        if (xio_setoption(event_loop_xio->xio, OPTION_XIO_EVENT_BINDING, &no_binding) != 0)
+        {
+            LogError("Cannot detach the xio from the loop");
+        }
+        free_event_loop_xio(event_loop_xio);
+    }
+}
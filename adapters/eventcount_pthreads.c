@@ -0,0 +1,373 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define _DEFAULT_SOURCE
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#define EVENTCOUNT_USE_FUTEX
+#endif
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/eventcount.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#define MILLISECONDS_IN_1_SECOND        1000
+#define NANOSECONDS_IN_1_MILLISECOND    1000000L
+#define NANOSECONDS_IN_1_SECOND         1000000000L
+
+/*the clock of the deadlines: futex timeouts are measured on CLOCK_MONOTONIC, condition variables
+on CLOCK_REALTIME unless they can be told otherwise*/
+#if defined(EVENTCOUNT_USE_FUTEX) || !defined(__APPLE__)
+#define EVENTCOUNT_CLOCK CLOCK_MONOTONIC
+#else
+#define EVENTCOUNT_CLOCK CLOCK_REALTIME
+#endif
+
+DEFINE_ENUM_STRINGS(EVENTCOUNT_RESULT, EVENTCOUNT_RESULT_VALUES);
+
+typedef struct EVENTCOUNT_TAG
+{
+    /*bumped by every notification that finds a registered waiter; the futex word*/
+    uint32_t epoch;
+    uint32_t waiter_count;
+#ifndef EVENTCOUNT_USE_FUTEX
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+#endif
+} EVENTCOUNT;
+
+static void get_deadline(int timeout_milliseconds, struct timespec* deadline)
+{
+    (void)clock_gettime(EVENTCOUNT_CLOCK, deadline);
+    deadline->tv_sec += timeout_milliseconds / MILLISECONDS_IN_1_SECOND;
+    deadline->tv_nsec += (timeout_milliseconds % MILLISECONDS_IN_1_SECOND) * NANOSECONDS_IN_1_MILLISECOND;
+    if (deadline->tv_nsec >= NANOSECONDS_IN_1_SECOND)
+    {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= NANOSECONDS_IN_1_SECOND;
+    }
+}
+
+static bool epoch_is(EVENTCOUNT* eventcount, uint32_t key)
+{
+    return __atomic_load_n(&eventcount->epoch, __ATOMIC_ACQUIRE) == key;
+}
+
+#ifdef EVENTCOUNT_USE_FUTEX
+
+/*false once the deadline has passed*/
+static bool get_remaining_time(const struct timespec* deadline, struct timespec* remaining)
+{
+    struct timespec now;
+    (void)clock_gettime(EVENTCOUNT_CLOCK, &now);
+    remaining->tv_sec = deadline->tv_sec - now.tv_sec;
+    remaining->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+    if (remaining->tv_nsec < 0)
+    {
+        remaining->tv_sec--;
+        remaining->tv_nsec += NANOSECONDS_IN_1_SECOND;
+    }
+
+    return (remaining->tv_sec > 0) || ((remaining->tv_sec == 0) && (remaining->tv_nsec > 0));
+}
+
+static int init_wait_primitives(EVENTCOUNT* eventcount)
+{
+    (void)eventcount;
+    return 0;
+}
+
+static void deinit_wait_primitives(EVENTCOUNT* eventcount)
+{
+    (void)eventcount;
+}
+
+static EVENTCOUNT_RESULT wait_for_epoch_change(EVENTCOUNT* eventcount, uint32_t key, const struct timespec* deadline)
+{
+    EVENTCOUNT_RESULT result = EVENTCOUNT_OK;
+
+    /*the kernel only puts the thread to sleep if the epoch still equals key, so a notification
+    between the check and the sleep is not lost*/
+    while ((result == EVENTCOUNT_OK) && epoch_is(eventcount, key))
+    {
+        struct timespec remaining;
+        long wait_result;
+
+        if (deadline == NULL)
+        {
+            wait_result = syscall(SYS_futex, &eventcount->epoch, FUTEX_WAIT_PRIVATE, key, NULL, NULL, 0);
+        }
+        else if (get_remaining_time(deadline, &remaining))
+        {
+            wait_result = syscall(SYS_futex, &eventcount->epoch, FUTEX_WAIT_PRIVATE, key, &remaining, NULL, 0);
+        }
+        else
+        {
+            /* Codes_SRS_EVENTCOUNT_01_012: [ If timeout_milliseconds is greater than 0, eventcount_wait shall return EVENTCOUNT_TIMEOUT once timeout_milliseconds have passed since the call without such a notification. ]*/
+            result = EVENTCOUNT_TIMEOUT;
+            wait_result = 0;
+        }
+
+        if ((wait_result != 0) && (errno != EAGAIN) && (errno != EINTR) && (errno != ETIMEDOUT))
+        {
+            /* Codes_SRS_EVENTCOUNT_01_014: [ If waiting fails, eventcount_wait shall return EVENTCOUNT_ERROR. ]*/
+            LogError("futex wait failed with errno %d", errno);
+            result = EVENTCOUNT_ERROR;
+        }
+    }
+
+    return result;
+}
+
+static void wake(EVENTCOUNT* eventcount, bool wake_all)
+{
+    (void)__atomic_fetch_add(&eventcount->epoch, 1, __ATOMIC_SEQ_CST);
+    (void)syscall(SYS_futex, &eventcount->epoch, FUTEX_WAKE_PRIVATE, wake_all ? INT_MAX : 1, NULL, NULL, 0);
+}
+
+#else
+
+static int init_wait_primitives(EVENTCOUNT* eventcount)
+{
+    int result;
+    pthread_condattr_t cond_attributes;
+
+    if (pthread_mutex_init(&eventcount->mutex, NULL) != 0)
+    {
+        LogError("pthread_mutex_init failed");
+        result = __FAILURE__;
+    }
+    else if (pthread_condattr_init(&cond_attributes) != 0)
+    {
+        LogError("pthread_condattr_init failed");
+        (void)pthread_mutex_destroy(&eventcount->mutex);
+        result = __FAILURE__;
+    }
+    else
+    {
+#ifndef __APPLE__
+        (void)pthread_condattr_setclock(&cond_attributes, EVENTCOUNT_CLOCK);
+#endif
+        if (pthread_cond_init(&eventcount->cond, &cond_attributes) != 0)
+        {
+            LogError("pthread_cond_init failed");
+            (void)pthread_mutex_destroy(&eventcount->mutex);
+            result = __FAILURE__;
+        }
+        else
+        {
+            result = 0;
+        }
+        (void)pthread_condattr_destroy(&cond_attributes);
+    }
+
+    return result;
+}
+
+static void deinit_wait_primitives(EVENTCOUNT* eventcount)
+{
+    (void)pthread_cond_destroy(&eventcount->cond);
+    (void)pthread_mutex_destroy(&eventcount->mutex);
+}
+
+static EVENTCOUNT_RESULT wait_for_epoch_change(EVENTCOUNT* eventcount, uint32_t key, const struct timespec* deadline)
+{
+    EVENTCOUNT_RESULT result = EVENTCOUNT_OK;
+
+    /*notifiers bump the epoch under the mutex, so it cannot change between the check and the wait*/
+    (void)pthread_mutex_lock(&eventcount->mutex);
+    while ((result == EVENTCOUNT_OK) && epoch_is(eventcount, key))
+    {
+        int wait_result = (deadline == NULL) ?
+            pthread_cond_wait(&eventcount->cond, &eventcount->mutex) :
+            pthread_cond_timedwait(&eventcount->cond, &eventcount->mutex, deadline);
+        if (wait_result == ETIMEDOUT)
+        {
+            if (epoch_is(eventcount, key))
+            {
+                /* Codes_SRS_EVENTCOUNT_01_012: [ If timeout_milliseconds is greater than 0, eventcount_wait shall return EVENTCOUNT_TIMEOUT once timeout_milliseconds have passed since the call without such a notification. ]*/
+                result = EVENTCOUNT_TIMEOUT;
+            }
+        }
+        else if (wait_result != 0)
+        {
+            /* Codes_SRS_EVENTCOUNT_01_014: [ If waiting fails, eventcount_wait shall return EVENTCOUNT_ERROR. ]*/
+            LogError("waiting on the condition variable failed with %d", wait_result);
+            result = EVENTCOUNT_ERROR;
+        }
+    }
+    (void)pthread_mutex_unlock(&eventcount->mutex);
+
+    return result;
+}
+
+static void wake(EVENTCOUNT* eventcount, bool wake_all)
+{
+    (void)pthread_mutex_lock(&eventcount->mutex);
+    (void)__atomic_fetch_add(&eventcount->epoch, 1, __ATOMIC_SEQ_CST);
+    if (wake_all)
+    {
+        (void)pthread_cond_broadcast(&eventcount->cond);
+    }
+    else
+    {
+        (void)pthread_cond_signal(&eventcount->cond);
+    }
+    (void)pthread_mutex_unlock(&eventcount->mutex);
+}
+
+#endif
+
+static void notify(EVENTCOUNT* eventcount, bool wake_all)
+{
+    /*pairs with the fence in eventcount_prepare_wait: either the waiter sees the state the caller
+    changed before notifying, or this sees the waiter*/
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&eventcount->waiter_count, __ATOMIC_RELAXED) == 0)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_016: [ If no thread is registered, eventcount_notify_one and eventcount_notify_all shall return without making a system call. ]*/
+    }
+    else
+    {
+        wake(eventcount, wake_all);
+    }
+}
+
+EVENTCOUNT_HANDLE eventcount_create(void)
+{
+    /* Codes_SRS_EVENTCOUNT_01_001: [ eventcount_create shall allocate an eventcount with no waiters and return it. ]*/
+    EVENTCOUNT* result = (EVENTCOUNT*)malloc(sizeof(EVENTCOUNT));
+    if (result == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_002: [ If any error occurs, eventcount_create shall fail and return NULL. ]*/
+        LogError("malloc failed");
+    }
+    else if (init_wait_primitives(result) != 0)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_002: [ If any error occurs, eventcount_create shall fail and return NULL. ]*/
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        result->epoch = 0;
+        result->waiter_count = 0;
+    }
+
+    return result;
+}
+
+void eventcount_destroy(EVENTCOUNT_HANDLE eventcount)
+{
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_003: [ If eventcount is NULL, eventcount_destroy shall return. ]*/
+        LogError("NULL eventcount");
+    }
+    else
+    {
+        /* Codes_SRS_EVENTCOUNT_01_004: [ eventcount_destroy shall free the eventcount. ]*/
+        deinit_wait_primitives(eventcount);
+        free(eventcount);
+    }
+}
+
+uint32_t eventcount_prepare_wait(EVENTCOUNT_HANDLE eventcount)
+{
+    uint32_t result;
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_005: [ If eventcount is NULL, eventcount_prepare_wait shall return 0. ]*/
+        LogError("NULL eventcount");
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_EVENTCOUNT_01_006: [ eventcount_prepare_wait shall register the calling thread as a waiter and then return the number of notifications that found a waiter as the key. ]*/
+        (void)__atomic_fetch_add(&eventcount->waiter_count, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        result = __atomic_load_n(&eventcount->epoch, __ATOMIC_ACQUIRE);
+    }
+
+    return result;
+}
+
+void eventcount_cancel_wait(EVENTCOUNT_HANDLE eventcount)
+{
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_007: [ If eventcount is NULL, eventcount_cancel_wait shall return. ]*/
+        LogError("NULL eventcount");
+    }
+    else
+    {
+        /* Codes_SRS_EVENTCOUNT_01_008: [ eventcount_cancel_wait shall withdraw the registration made by eventcount_prepare_wait. ]*/
+        (void)__atomic_fetch_sub(&eventcount->waiter_count, 1, __ATOMIC_RELEASE);
+    }
+}
+
+EVENTCOUNT_RESULT eventcount_wait(EVENTCOUNT_HANDLE eventcount, uint32_t key, int timeout_milliseconds)
+{
+    EVENTCOUNT_RESULT result;
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_009: [ If eventcount is NULL, eventcount_wait shall fail and return EVENTCOUNT_INVALID_ARG. ]*/
+        LogError("NULL eventcount");
+        result = EVENTCOUNT_INVALID_ARG;
+    }
+    else
+    {
+        /*the deadline is computed once, so waking up early does not extend the wait*/
+        struct timespec deadline;
+        if (timeout_milliseconds > 0)
+        {
+            get_deadline(timeout_milliseconds, &deadline);
+        }
+
+        /* Codes_SRS_EVENTCOUNT_01_010: [ eventcount_wait shall return EVENTCOUNT_OK without blocking if a notification found a waiter since the eventcount_prepare_wait that returned key. ]*/
+        /* Codes_SRS_EVENTCOUNT_01_011: [ Otherwise eventcount_wait shall block until such a notification and return EVENTCOUNT_OK. ]*/
+        result = wait_for_epoch_change(eventcount, key, (timeout_milliseconds > 0) ? &deadline : NULL);
+
+        /* Codes_SRS_EVENTCOUNT_01_013: [ eventcount_wait shall withdraw the registration made by eventcount_prepare_wait before returning. ]*/
+        (void)__atomic_fetch_sub(&eventcount->waiter_count, 1, __ATOMIC_RELEASE);
+    }
+
+    return result;
+}
+
+void eventcount_notify_one(EVENTCOUNT_HANDLE eventcount)
+{
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_015: [ If eventcount is NULL, eventcount_notify_one and eventcount_notify_all shall return. ]*/
+        LogError("NULL eventcount");
+    }
+    else
+    {
+        /* Codes_SRS_EVENTCOUNT_01_017: [ Otherwise eventcount_notify_one shall make the key of every registered thread stale and wake one thread blocked in eventcount_wait. ]*/
+        notify(eventcount, false);
+    }
+}
+
+void eventcount_notify_all(EVENTCOUNT_HANDLE eventcount)
+{
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_015: [ If eventcount is NULL, eventcount_notify_one and eventcount_notify_all shall return. ]*/
+        LogError("NULL eventcount");
+    }
+    else
+    {
+        /* Codes_SRS_EVENTCOUNT_01_018: [ Otherwise eventcount_notify_all shall make the key of every registered thread stale and wake every thread blocked in eventcount_wait. ]*/
+        notify(eventcount, true);
+    }
+}
@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "windows.h"
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/eventcount.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+DEFINE_ENUM_STRINGS(EVENTCOUNT_RESULT, EVENTCOUNT_RESULT_VALUES);
+
+/*the lock and the condition variable are only touched by notifications that find a registered waiter*/
+typedef struct EVENTCOUNT_TAG
+{
+    /*bumped by every notification that finds a registered waiter*/
+    volatile LONG epoch;
+    volatile LONG waiter_count;
+    SRWLOCK lock;
+    CONDITION_VARIABLE cond;
+} EVENTCOUNT;
+
+static void notify(EVENTCOUNT* eventcount, BOOL wake_all)
+{
+    /*pairs with the interlocked increment in eventcount_prepare_wait: either the waiter sees the
+    state the caller changed before notifying, or this sees the waiter*/
+    MemoryBarrier();
+    if (eventcount->waiter_count == 0)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_016: [ If no thread is registered, eventcount_notify_one and eventcount_notify_all shall return without making a system call. ]*/
+    }
+    else
+    {
+        /*bumping the epoch under the lock keeps it from changing between a waiter's check and its sleep*/
+        AcquireSRWLockExclusive(&eventcount->lock);
+        (void)InterlockedIncrement(&eventcount->epoch);
+        ReleaseSRWLockExclusive(&eventcount->lock);
+        if (wake_all)
+        {
+            WakeAllConditionVariable(&eventcount->cond);
+        }
+        else
+        {
+            WakeConditionVariable(&eventcount->cond);
+        }
+    }
+}
+
+EVENTCOUNT_HANDLE eventcount_create(void)
+{
+    /* Codes_SRS_EVENTCOUNT_01_001: [ eventcount_create shall allocate an eventcount with no waiters and return it. ]*/
+    EVENTCOUNT* result = (EVENTCOUNT*)malloc(sizeof(EVENTCOUNT));
+    if (result == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_002: [ If any error occurs, eventcount_create shall fail and return NULL. ]*/
+        LogError("malloc failed");
+    }
+    else
+    {
+        result->epoch = 0;
+        result->waiter_count = 0;
+        InitializeSRWLock(&result->lock);
+        InitializeConditionVariable(&result->cond);
+    }
+
+    return result;
+}
+
+void eventcount_destroy(EVENTCOUNT_HANDLE eventcount)
+{
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_003: [ If eventcount is NULL, eventcount_destroy shall return. ]*/
+        LogError("NULL eventcount");
+    }
+    else
+    {
+        /* Codes_SRS_EVENTCOUNT_01_004: [ eventcount_destroy shall free the eventcount. ]*/
+        free(eventcount);
+    }
+}
+
+uint32_t eventcount_prepare_wait(EVENTCOUNT_HANDLE eventcount)
+{
+    uint32_t result;
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_005: [ If eventcount is NULL, eventcount_prepare_wait shall return 0. ]*/
+        LogError("NULL eventcount");
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_EVENTCOUNT_01_006: [ eventcount_prepare_wait shall register the calling thread as a waiter and then return the number of notifications that found a waiter as the key. ]*/
+        (void)InterlockedIncrement(&eventcount->waiter_count);
+        result = (uint32_t)InterlockedCompareExchange(&eventcount->epoch, 0, 0);
+    }
+
+    return result;
+}
+
+void eventcount_cancel_wait(EVENTCOUNT_HANDLE eventcount)
+{
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_007: [ If eventcount is NULL, eventcount_cancel_wait shall return. ]*/
+        LogError("NULL eventcount");
+    }
+    else
+    {
+        /* Codes_SRS_EVENTCOUNT_01_008: [ eventcount_cancel_wait shall withdraw the registration made by eventcount_prepare_wait. ]*/
+        (void)InterlockedDecrement(&eventcount->waiter_count);
+    }
+}
+
+EVENTCOUNT_RESULT eventcount_wait(EVENTCOUNT_HANDLE eventcount, uint32_t key, int timeout_milliseconds)
+{
+    EVENTCOUNT_RESULT result;
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_009: [ If eventcount is NULL, eventcount_wait shall fail and return EVENTCOUNT_INVALID_ARG. ]*/
+        LogError("NULL eventcount");
+        result = EVENTCOUNT_INVALID_ARG;
+    }
+    else
+    {
+        /*the deadline is computed once, so waking up early does not extend the wait*/
+        ULONGLONG deadline = GetTickCount64() + ((timeout_milliseconds > 0) ? (ULONGLONG)timeout_milliseconds : 0);
+
+        result = EVENTCOUNT_OK;
+
+        /* Codes_SRS_EVENTCOUNT_01_010: [ eventcount_wait shall return EVENTCOUNT_OK without blocking if a notification found a waiter since the eventcount_prepare_wait that returned key. ]*/
+        /* Codes_SRS_EVENTCOUNT_01_011: [ Otherwise eventcount_wait shall block until such a notification and return EVENTCOUNT_OK. ]*/
+        AcquireSRWLockExclusive(&eventcount->lock);
+        while ((result == EVENTCOUNT_OK) && ((uint32_t)eventcount->epoch == key))
+        {
+            DWORD wait_milliseconds;
+            if (timeout_milliseconds <= 0)
+            {
+                wait_milliseconds = INFINITE;
+            }
+            else
+            {
+                ULONGLONG now = GetTickCount64();
+                wait_milliseconds = (now >= deadline) ? 0 : (DWORD)(deadline - now);
+            }
+
+            if (wait_milliseconds == 0)
+            {
+                /* Codes_SRS_EVENTCOUNT_01_012: [ If timeout_milliseconds is greater than 0, eventcount_wait shall return EVENTCOUNT_TIMEOUT once timeout_milliseconds have passed since the call without such a notification. ]*/
+                result = EVENTCOUNT_TIMEOUT;
+            }
+            else if (!SleepConditionVariableSRW(&eventcount->cond, &eventcount->lock, wait_milliseconds, 0) &&
+                (GetLastError() != ERROR_TIMEOUT))
+            {
+                /* Codes_SRS_EVENTCOUNT_01_014: [ If waiting fails, eventcount_wait shall return EVENTCOUNT_ERROR. ]*/
+                LogError("SleepConditionVariableSRW failed with error %d", GetLastError());
+                result = EVENTCOUNT_ERROR;
+            }
+        }
+        ReleaseSRWLockExclusive(&eventcount->lock);
+
+        /* Codes_SRS_EVENTCOUNT_01_013: [ eventcount_wait shall withdraw the registration made by eventcount_prepare_wait before returning. ]*/
+        (void)InterlockedDecrement(&eventcount->waiter_count);
+    }
+
+    return result;
+}
+
+void eventcount_notify_one(EVENTCOUNT_HANDLE eventcount)
+{
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_015: [ If eventcount is NULL, eventcount_notify_one and eventcount_notify_all shall return. ]*/
+        LogError("NULL eventcount");
+    }
+    else
+    {
+        /* Codes_SRS_EVENTCOUNT_01_017: [ Otherwise eventcount_notify_one shall make the key of every registered thread stale and wake one thread blocked in eventcount_wait. ]*/
+        notify(eventcount, FALSE);
+    }
+}
+
+void eventcount_notify_all(EVENTCOUNT_HANDLE eventcount)
+{
+    if (eventcount == NULL)
+    {
+        /* Codes_SRS_EVENTCOUNT_01_015: [ If eventcount is NULL, eventcount_notify_one and eventcount_notify_all shall return. ]*/
+        LogError("NULL eventcount");
+    }
+    else
+    {
+        /* Codes_SRS_EVENTCOUNT_01_018: [ Otherwise eventcount_notify_all shall make the key of every registered thread stale and wake every thread blocked in eventcount_wait. ]*/
+        notify(eventcount, TRUE);
+    }
+}
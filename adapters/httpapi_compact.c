@@ -15,6 +15,9 @@
 #include "azure_c_shared_utility/tlsio.h"
 #include "azure_c_shared_utility/threadapi.h"
 #include "azure_c_shared_utility/shared_util_options.h"
+#ifdef USE_ZLIB
+#include "zlib.h"
+#endif
 
 #ifdef _MSC_VER
 #define snprintf _snprintf
@@ -41,6 +44,13 @@
 
 DEFINE_ENUM_STRINGS(HTTPAPI_RESULT, HTTPAPI_RESULT_VALUES)
 
+typedef enum HTTP_CONTENT_ENCODING_TAG
+{
+    HTTP_CONTENT_ENCODING_IDENTITY,
+    HTTP_CONTENT_ENCODING_GZIP,
+    HTTP_CONTENT_ENCODING_DEFLATE
+} HTTP_CONTENT_ENCODING;
+
 typedef struct HTTP_HANDLE_DATA_TAG
 {
     char*           certificate;
@@ -49,9 +59,11 @@ typedef struct HTTP_HANDLE_DATA_TAG
     XIO_HANDLE      xio_handle;
     size_t          received_bytes_count;
     unsigned char*  received_bytes;
+    HTTP_CONTENT_ENCODING content_encoding;
     unsigned int    is_io_error : 1;
     unsigned int    is_connected : 1;
     unsigned int    send_completed : 1;
+    unsigned int    decompress_response : 1;
 } HTTP_HANDLE_DATA;
 
 /*the following function does the same as sscanf(pos2, "%d", &sec)*/
@@ -243,6 +255,8 @@ HTTP_HANDLE HTTPAPI_CreateConnection(const char* hostName)
                 http_instance->certificate = NULL;
                 http_instance->x509ClientCertificate = NULL;
                 http_instance->x509ClientPrivateKey = NULL;
+                http_instance->content_encoding = HTTP_CONTENT_ENCODING_IDENTITY;
+                http_instance->decompress_response = 0;
             }
         }
     }
@@ -822,7 +836,7 @@ const char* get_request_type(HTTPAPI_REQUEST_TYPE requestType)
 }
 
 /*Codes_SRS_HTTPAPI_COMPACT_21_026: [ If the open process succeed, the HTTPAPI_ExecuteRequest shall send the request message to the host. ]*/
-static HTTPAPI_RESULT SendHeadsToXIO(HTTP_HANDLE_DATA* http_instance, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath, HTTP_HEADERS_HANDLE httpHeadersHandle, size_t headersCount)
+static HTTPAPI_RESULT SendHeadsToXIO(HTTP_HANDLE_DATA* http_instance, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath, HTTP_HEADERS_HANDLE httpHeadersHandle, size_t headersCount, bool chunkedContent)
 {
     HTTPAPI_RESULT result;
     char    buf[TEMP_BUFFER_SIZE];
@@ -845,22 +859,50 @@ static HTTPAPI_RESULT SendHeadsToXIO(HTTP_HANDLE_DATA* http_instance, HTTPAPI_RE
         /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
         for (i = 0; ((i < headersCount) && (result == HTTPAPI_OK)); i++)
         {
-            char* header;
-            if (HTTPHeaders_GetHeader(httpHeadersHandle, i, &header) != HTTP_HEADERS_OK)
+            const char* name;
+            const char* value;
+            if (HTTPHeaders_GetHeaderNameValue(httpHeadersHandle, i, &name, &value) != HTTP_HEADERS_OK)
             {
                 /*Codes_SRS_HTTPAPI_COMPACT_21_027: [ If the HTTPAPI_ExecuteRequest cannot create a buffer to send the request, it shall not send any request and return HTTPAPI_STRING_PROCESSING_ERROR. ]*/
                 result = HTTPAPI_STRING_PROCESSING_ERROR;
             }
             else
             {
-                if ((result = conn_send_all(http_instance, (const unsigned char*)header, strlen(header))) == HTTPAPI_OK)
+                /*headers are formatted in the stack buffer, the ones that do not fit are sent in pieces*/
+                if (((ret = snprintf(buf, sizeof(buf), "%s: %s", name, value)) >= 0) &&
+                    ((size_t)ret < sizeof(buf)))
+                {
+                    result = conn_send_all(http_instance, (const unsigned char*)buf, (size_t)ret);
+                }
+                else if (((result = conn_send_all(http_instance, (const unsigned char*)name, strlen(name))) == HTTPAPI_OK) &&
+                    ((result = conn_send_all(http_instance, (const unsigned char*)": ", (size_t)2)) == HTTPAPI_OK))
+                {
+                    result = conn_send_all(http_instance, (const unsigned char*)value, strlen(value));
+                }
+
+                if (result == HTTPAPI_OK)
                 {
                     result = conn_send_all(http_instance, (const unsigned char*)"\r\n", (size_t)2);
                 }
-                free(header);
             }
         }
 
+        /*Codes_SRS_HTTPAPI_COMPACT_21_098: [ If response decompression is enabled and the request headers do not contain `Accept-Encoding`, the request shall carry the header `Accept-Encoding: gzip, deflate`. ]*/
+        if ((result == HTTPAPI_OK) &&
+            (http_instance->decompress_response != 0) &&
+            (HTTPHeaders_FindHeaderValue(httpHeadersHandle, "Accept-Encoding") == NULL))
+        {
+            static const char AcceptEncoding[] = "Accept-Encoding: gzip, deflate\r\n";
+            result = conn_send_all(http_instance, (const unsigned char*)AcceptEncoding, sizeof(AcceptEncoding) - 1);
+        }
+
+        /*Codes_SRS_HTTPAPI_COMPACT_21_090: [ If a request body callback is provided, the HTTPAPI_ExecuteStreamingRequest shall add the header `Transfer-Encoding: chunked`. ]*/
+        if ((result == HTTPAPI_OK) && chunkedContent)
+        {
+            static const char TransferEncodingChunked[] = "Transfer-Encoding: chunked\r\n";
+            result = conn_send_all(http_instance, (const unsigned char*)TransferEncodingChunked, sizeof(TransferEncodingChunked) - 1);
+        }
+
         //Close headers
         if (result == HTTPAPI_OK)
         {
@@ -891,6 +933,53 @@ static HTTPAPI_RESULT SendContentToXIO(HTTP_HANDLE_DATA* http_instance, const un
     return result;
 }
 
+/*Codes_SRS_HTTPAPI_COMPACT_21_091: [ The HTTPAPI_ExecuteStreamingRequest shall send the request body as a sequence of chunks read from the request body callback, terminated by a zero length chunk. ]*/
+static HTTPAPI_RESULT SendStreamedContentToXIO(HTTP_HANDLE_DATA* http_instance, HTTPAPI_REQUEST_BODY_READ_CALLBACK requestBodyCallback, void* requestBodyContext)
+{
+    HTTPAPI_RESULT result;
+    unsigned char buf[TEMP_BUFFER_SIZE];
+    char chunkHeader[20];
+    size_t bytesRead;
+
+    /*Codes_SRS_HTTPAPI_COMPACT_21_033: [ If the whole process succeed, the HTTPAPI_ExecuteRequest shall retur HTTPAPI_OK. ]*/
+    result = HTTPAPI_OK;
+    do
+    {
+        int ret;
+        bytesRead = 0;
+        if (requestBodyCallback(requestBodyContext, buf, sizeof(buf), &bytesRead) != 0)
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_092: [ If the request body callback fails, the HTTPAPI_ExecuteStreamingRequest shall return HTTPAPI_SEND_REQUEST_FAILED. ]*/
+            LogError("request body callback failed");
+            result = HTTPAPI_SEND_REQUEST_FAILED;
+        }
+        else if (bytesRead > sizeof(buf))
+        {
+            LogError("request body callback returned more bytes (%zu) than requested (%zu)", bytesRead, sizeof(buf));
+            result = HTTPAPI_SEND_REQUEST_FAILED;
+        }
+        else if (((ret = snprintf(chunkHeader, sizeof(chunkHeader), "%x\r\n", (unsigned int)bytesRead)) < 0) ||
+            ((size_t)ret >= sizeof(chunkHeader)))
+        {
+            result = HTTPAPI_STRING_PROCESSING_ERROR;
+        }
+        else if ((result = conn_send_all(http_instance, (const unsigned char*)chunkHeader, (size_t)ret)) == HTTPAPI_OK)
+        {
+            if ((bytesRead > 0) &&
+                ((result = conn_send_all(http_instance, buf, bytesRead)) != HTTPAPI_OK))
+            {
+                LogError("failed sending request body chunk");
+            }
+            else
+            {
+                result = conn_send_all(http_instance, (const unsigned char*)"\r\n", (size_t)2);
+            }
+        }
+    } while ((result == HTTPAPI_OK) && (bytesRead > 0));
+
+    return result;
+}
+
 /*Codes_SRS_HTTPAPI_COMPACT_21_030: [ At the end of the transmission, the HTTPAPI_ExecuteRequest shall receive the response from the host. ]*/
 static HTTPAPI_RESULT ReceiveHeaderFromXIO(HTTP_HANDLE_DATA* http_instance, unsigned int* statusCode)
 {
@@ -944,8 +1033,11 @@ static HTTPAPI_RESULT ReceiveContentInfoFromXIO(HTTP_HANDLE_DATA* http_instance,
     const size_t TransferEncodingSize = sizeof(TransferEncoding) - 1;
     const char Chunked[] = "chunked";
     const size_t ChunkedSize = sizeof(Chunked) - 1;
+    const char ContentEncoding[] = "content-encoding:";
+    const size_t ContentEncodingSize = sizeof(ContentEncoding) - 1;
 
     http_instance->is_io_error = 0;
+    http_instance->content_encoding = HTTP_CONTENT_ENCODING_IDENTITY;
 
     //Read HTTP response headers
     if (readLine(http_instance, buf, sizeof(buf)) < 0)
@@ -985,6 +1077,23 @@ static HTTPAPI_RESULT ReceiveContentInfoFromXIO(HTTP_HANDLE_DATA* http_instance,
                     (*chunked) = true;
                 }
             }
+            else if ((http_instance->decompress_response != 0) &&
+                (InternStrnicmp(buf, ContentEncoding, ContentEncodingSize) == 0))
+            {
+                /*Codes_SRS_HTTPAPI_COMPACT_21_099: [ If response decompression is enabled, a response with `Content-Encoding` gzip, x-gzip or deflate shall be decoded; any other content coding shall be returned as received. ]*/
+                substr = buf + ContentEncodingSize;
+
+                while (isspace(*substr)) substr++;
+
+                if ((InternStrnicmp(substr, "gzip", 4) == 0) || (InternStrnicmp(substr, "x-gzip", 6) == 0))
+                {
+                    http_instance->content_encoding = HTTP_CONTENT_ENCODING_GZIP;
+                }
+                else if (InternStrnicmp(substr, "deflate", 7) == 0)
+                {
+                    http_instance->content_encoding = HTTP_CONTENT_ENCODING_DEFLATE;
+                }
+            }
 
             if (result == HTTPAPI_OK)
             {
@@ -1148,6 +1257,252 @@ static HTTPAPI_RESULT ReadHTTPResponseBodyFromXIO(HTTP_HANDLE_DATA* http_instanc
     return result;
 }
 
+/*Codes_SRS_HTTPAPI_COMPACT_21_093: [ The HTTPAPI_ExecuteStreamingRequest shall hand the response body to the response body callback in pieces of at most TEMP_BUFFER_SIZE bytes. ]*/
+static HTTPAPI_RESULT StreamN(HTTP_HANDLE_DATA* http_instance, size_t n, HTTPAPI_RESPONSE_BODY_WRITE_CALLBACK responseBodyCallback, void* responseBodyContext)
+{
+    HTTPAPI_RESULT result = HTTPAPI_OK;
+    unsigned char buf[TEMP_BUFFER_SIZE];
+
+    while ((n > 0) && (result == HTTPAPI_OK))
+    {
+        size_t pieceSize = (n < sizeof(buf)) ? n : sizeof(buf);
+        if (readChunk(http_instance, (char*)buf, pieceSize) < 0)
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_032: [ If the HTTPAPI_ExecuteRequest cannot read the message with the request result, it shall return HTTPAPI_READ_DATA_FAILED. ]*/
+            result = HTTPAPI_READ_DATA_FAILED;
+        }
+        else if (responseBodyCallback(responseBodyContext, buf, pieceSize) != 0)
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_094: [ If the response body callback fails, the HTTPAPI_ExecuteStreamingRequest shall return HTTPAPI_READ_DATA_FAILED. ]*/
+            LogError("response body callback failed");
+            result = HTTPAPI_READ_DATA_FAILED;
+        }
+        else
+        {
+            n -= pieceSize;
+        }
+    }
+
+    return result;
+}
+
+static HTTPAPI_RESULT StreamHTTPResponseBodyFromXIO(HTTP_HANDLE_DATA* http_instance, size_t bodyLength, bool chunked, HTTPAPI_RESPONSE_BODY_WRITE_CALLBACK responseBodyCallback, void* responseBodyContext)
+{
+    HTTPAPI_RESULT result;
+
+    if (responseBodyCallback == NULL)
+    {
+        /*Codes_SRS_HTTPAPI_COMPACT_21_051: [ If the responseContent is NULL, the HTTPAPI_ExecuteRequest shall ignore any content in the response. ]*/
+        result = ReadHTTPResponseBodyFromXIO(http_instance, bodyLength, chunked, NULL);
+    }
+    else if (!chunked)
+    {
+        http_instance->is_io_error = 0;
+        result = StreamN(http_instance, bodyLength, responseBodyCallback, responseBodyContext);
+    }
+    else
+    {
+        char buf[TEMP_BUFFER_SIZE];
+
+        http_instance->is_io_error = 0;
+        result = HTTPAPI_OK;
+        while (result == HTTPAPI_OK)
+        {
+            size_t chunkSize;
+            if (readLine(http_instance, buf, sizeof(buf)) < 0)    // read [length in hex]/r/n
+            {
+                /*Codes_SRS_HTTPAPI_COMPACT_21_032: [ If the HTTPAPI_ExecuteRequest cannot read the message with the request result, it shall return HTTPAPI_READ_DATA_FAILED. ]*/
+                result = HTTPAPI_READ_DATA_FAILED;
+            }
+            else if (ParseStringToHexadecimal(buf, &chunkSize) != 1)
+            {
+                /*Codes_SRS_HTTPAPI_COMPACT_21_055: [ If the HTTPAPI_ExecuteRequest cannot parser the received message, it shall return HTTPAPI_RECEIVE_RESPONSE_FAILED. ]*/
+                result = HTTPAPI_RECEIVE_RESPONSE_FAILED;
+            }
+            else
+            {
+                if (chunkSize > 0)
+                {
+                    result = StreamN(http_instance, chunkSize, responseBodyCallback, responseBodyContext);
+                }
+
+                if ((result == HTTPAPI_OK) &&
+                    ((readChunk(http_instance, buf, (size_t)2) < 0) || (buf[0] != '\r') || (buf[1] != '\n'))) // skip /r/n
+                {
+                    result = HTTPAPI_READ_DATA_FAILED;
+                }
+
+                if (chunkSize == 0)
+                {
+                    // 0 length means end of chunks
+                    break;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+#ifdef USE_ZLIB
+typedef struct RESPONSE_BODY_DECODER_TAG
+{
+    z_stream stream;
+    HTTP_CONTENT_ENCODING encoding;
+    bool raw_deflate;
+    bool finished;
+    HTTPAPI_RESPONSE_BODY_WRITE_CALLBACK output;
+    void* outputContext;
+} RESPONSE_BODY_DECODER;
+
+static int InflateResponseBody(void* context, const unsigned char* buffer, size_t size)
+{
+    int result = 0;
+    RESPONSE_BODY_DECODER* decoder = (RESPONSE_BODY_DECODER*)context;
+    unsigned char out[TEMP_BUFFER_SIZE];
+    bool first_input = (decoder->stream.total_in == 0);
+
+    decoder->stream.next_in = (Bytef*)buffer;
+    decoder->stream.avail_in = (uInt)size;
+
+    while ((result == 0) && (decoder->stream.avail_in > 0) && !decoder->finished)
+    {
+        int ret;
+
+        decoder->stream.next_out = out;
+        decoder->stream.avail_out = (uInt)sizeof(out);
+
+        ret = inflate(&decoder->stream, Z_NO_FLUSH);
+        if ((ret == Z_DATA_ERROR) &&
+            (decoder->encoding == HTTP_CONTENT_ENCODING_DEFLATE) &&
+            first_input &&
+            !decoder->raw_deflate &&
+            (decoder->stream.total_out == 0) &&
+            (inflateReset2(&decoder->stream, -MAX_WBITS) == Z_OK))
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_100: [ A `deflate` body without the zlib wrapper shall be decoded as a raw deflate stream. ]*/
+            decoder->raw_deflate = true;
+            decoder->stream.next_in = (Bytef*)buffer;
+            decoder->stream.avail_in = (uInt)size;
+        }
+        else if ((ret != Z_OK) && (ret != Z_STREAM_END) && (ret != Z_BUF_ERROR))
+        {
+            LogError("inflate failed (%d)", ret);
+            result = __FAILURE__;
+        }
+        else
+        {
+            size_t produced = sizeof(out) - decoder->stream.avail_out;
+
+            if ((produced > 0) && (decoder->output(decoder->outputContext, out, produced) != 0))
+            {
+                result = __FAILURE__;
+            }
+            else if (ret == Z_STREAM_END)
+            {
+                decoder->finished = true;
+            }
+            else if ((ret == Z_BUF_ERROR) && (produced == 0))
+            {
+                /*no progress is possible with this input*/
+                LogError("inflate did not progress");
+                result = __FAILURE__;
+            }
+        }
+    }
+
+    return result;
+}
+
+static int AppendToResponseContent(void* context, const unsigned char* buffer, size_t size)
+{
+    int result;
+
+    if (BUFFER_append_build((BUFFER_HANDLE)context, buffer, size) != 0)
+    {
+        LogError("cannot append the decoded response body");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+static HTTPAPI_RESULT DecodeHTTPResponseBodyFromXIO(HTTP_HANDLE_DATA* http_instance, size_t bodyLength, bool chunked, HTTPAPI_RESPONSE_BODY_WRITE_CALLBACK responseBodyCallback, void* responseBodyContext)
+{
+    HTTPAPI_RESULT result;
+    RESPONSE_BODY_DECODER decoder;
+
+    (void)memset(&decoder, 0, sizeof(decoder));
+    decoder.encoding = http_instance->content_encoding;
+    decoder.output = responseBodyCallback;
+    decoder.outputContext = responseBodyContext;
+
+    /*gzip needs the gzip wrapper (16 + window bits), deflate is the zlib format*/
+    if (inflateInit2(&decoder.stream, (decoder.encoding == HTTP_CONTENT_ENCODING_GZIP) ? (MAX_WBITS + 16) : MAX_WBITS) != Z_OK)
+    {
+        /*Codes_SRS_HTTPAPI_COMPACT_21_052: [ If any memory allocation get fail, the HTTPAPI_ExecuteRequest shall return HTTPAPI_ALLOC_FAILED. ]*/
+        LogError("inflateInit2 failed");
+        result = HTTPAPI_ALLOC_FAILED;
+    }
+    else
+    {
+        result = StreamHTTPResponseBodyFromXIO(http_instance, bodyLength, chunked, InflateResponseBody, &decoder);
+        if ((result == HTTPAPI_OK) && (decoder.stream.total_in > 0) && !decoder.finished)
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_101: [ If the encoded response body is corrupted or truncated, the request shall fail with HTTPAPI_READ_DATA_FAILED. ]*/
+            LogError("compressed response body is truncated");
+            result = HTTPAPI_READ_DATA_FAILED;
+        }
+
+        (void)inflateEnd(&decoder.stream);
+    }
+
+    return result;
+}
+#endif
+
+static HTTPAPI_RESULT ReadResponseBody(HTTP_HANDLE_DATA* http_instance, size_t bodyLength, bool chunked, BUFFER_HANDLE responseContent)
+{
+    HTTPAPI_RESULT result;
+
+#ifdef USE_ZLIB
+    /*Codes_SRS_HTTPAPI_COMPACT_21_099: [ If response decompression is enabled, a response with `Content-Encoding` gzip, x-gzip or deflate shall be decoded; any other content coding shall be returned as received. ]*/
+    if ((http_instance->content_encoding != HTTP_CONTENT_ENCODING_IDENTITY) && (responseContent != NULL))
+    {
+        /*the decoded size is unknown, so the body is appended piece by piece to an empty buffer*/
+        (void)BUFFER_unbuild(responseContent);
+        result = DecodeHTTPResponseBodyFromXIO(http_instance, bodyLength, chunked, AppendToResponseContent, responseContent);
+    }
+    else
+#endif
+    {
+        result = ReadHTTPResponseBodyFromXIO(http_instance, bodyLength, chunked, responseContent);
+    }
+
+    return result;
+}
+
+static HTTPAPI_RESULT StreamResponseBody(HTTP_HANDLE_DATA* http_instance, size_t bodyLength, bool chunked, HTTPAPI_RESPONSE_BODY_WRITE_CALLBACK responseBodyCallback, void* responseBodyContext)
+{
+    HTTPAPI_RESULT result;
+
+#ifdef USE_ZLIB
+    if ((http_instance->content_encoding != HTTP_CONTENT_ENCODING_IDENTITY) && (responseBodyCallback != NULL))
+    {
+        result = DecodeHTTPResponseBodyFromXIO(http_instance, bodyLength, chunked, responseBodyCallback, responseBodyContext);
+    }
+    else
+#endif
+    {
+        result = StreamHTTPResponseBodyFromXIO(http_instance, bodyLength, chunked, responseBodyCallback, responseBodyContext);
+    }
+
+    return result;
+}
 
 /*Codes_SRS_HTTPAPI_COMPACT_21_037: [ If the request type is unknown, the HTTPAPI_ExecuteRequest shall return HTTPAPI_INVALID_ARG. ]*/
 static bool validRequestType(HTTPAPI_REQUEST_TYPE requestType)
@@ -1207,7 +1562,7 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
         LogError("Open HTTP connection failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
     }
     /*Codes_SRS_HTTPAPI_COMPACT_21_026: [ If the open process succeed, the HTTPAPI_ExecuteRequest shall send the request message to the host. ]*/
-    else if ((result = SendHeadsToXIO(http_instance, requestType, relativePath, httpHeadersHandle, headersCount)) != HTTPAPI_OK)
+    else if ((result = SendHeadsToXIO(http_instance, requestType, relativePath, httpHeadersHandle, headersCount, false)) != HTTPAPI_OK)
     {
         LogError("Send heads to HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
     }
@@ -1228,7 +1583,7 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
         LogError("Receive content information from HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
     }
     /*Codes_SRS_HTTPAPI_COMPACT_21_075: [ The message received by the HTTPAPI_ExecuteRequest can contain a body with the message content. ]*/
-    else if ((result = ReadHTTPResponseBodyFromXIO(http_instance, bodyLength, chunked, responseContent)) != HTTPAPI_OK)
+    else if ((result = ReadResponseBody(http_instance, bodyLength, chunked, responseContent)) != HTTPAPI_OK)
     {
         LogError("Read HTTP response body from HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
     }
@@ -1239,6 +1594,59 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
     return result;
 }
 
+/*Codes_SRS_HTTPAPI_COMPACT_21_095: [ The HTTPAPI_ExecuteStreamingRequest shall execute the http request in the same way as HTTPAPI_ExecuteRequest, pulling the request body from requestBodyCallback and pushing the response body to responseBodyCallback. ]*/
+HTTPAPI_RESULT HTTPAPI_ExecuteStreamingRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
+    HTTP_HEADERS_HANDLE httpHeadersHandle, HTTPAPI_REQUEST_BODY_READ_CALLBACK requestBodyCallback, void* requestBodyContext,
+    unsigned int* statusCode, HTTP_HEADERS_HANDLE responseHeadersHandle,
+    HTTPAPI_RESPONSE_BODY_WRITE_CALLBACK responseBodyCallback, void* responseBodyContext)
+{
+    HTTPAPI_RESULT result = HTTPAPI_ERROR;
+    size_t  headersCount;
+    size_t  bodyLength = 0;
+    bool    chunked = false;
+    HTTP_HANDLE_DATA* http_instance = (HTTP_HANDLE_DATA*)handle;
+
+    /*Codes_SRS_HTTPAPI_COMPACT_21_096: [ If handle, relativePath or httpHeadersHandle is NULL, or requestType is invalid, the HTTPAPI_ExecuteStreamingRequest shall return HTTPAPI_INVALID_ARG. ]*/
+    if (http_instance == NULL ||
+        relativePath == NULL ||
+        httpHeadersHandle == NULL ||
+        !validRequestType(requestType) ||
+        HTTPHeaders_GetHeaderCount(httpHeadersHandle, &headersCount) != HTTP_HEADERS_OK)
+    {
+        result = HTTPAPI_INVALID_ARG;
+        LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+    }
+    else if ((result = OpenXIOConnection(http_instance)) != HTTPAPI_OK)
+    {
+        LogError("Open HTTP connection failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+    }
+    else if ((result = SendHeadsToXIO(http_instance, requestType, relativePath, httpHeadersHandle, headersCount, (requestBodyCallback != NULL))) != HTTPAPI_OK)
+    {
+        LogError("Send heads to HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+    }
+    else if ((requestBodyCallback != NULL) &&
+        ((result = SendStreamedContentToXIO(http_instance, requestBodyCallback, requestBodyContext)) != HTTPAPI_OK))
+    {
+        LogError("Send streamed content to HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+    }
+    else if ((result = ReceiveHeaderFromXIO(http_instance, statusCode)) != HTTPAPI_OK)
+    {
+        LogError("Receive header from HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+    }
+    else if ((result = ReceiveContentInfoFromXIO(http_instance, responseHeadersHandle, &bodyLength, &chunked)) != HTTPAPI_OK)
+    {
+        LogError("Receive content information from HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+    }
+    else if ((result = StreamResponseBody(http_instance, bodyLength, chunked, responseBodyCallback, responseBodyContext)) != HTTPAPI_OK)
+    {
+        LogError("Stream HTTP response body from HTTP failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+    }
+
+    conn_receive_discard_buffer(http_instance);
+
+    return result;
+}
+
 /*Codes_SRS_HTTPAPI_COMPACT_21_056: [ The HTTPAPI_SetOption shall change the HTTP options. ]*/
 /*Codes_SRS_HTTPAPI_COMPACT_21_057: [ The HTTPAPI_SetOption shall receive a handle that identiry the HTTP connection. ]*/
 /*Codes_SRS_HTTPAPI_COMPACT_21_058: [ The HTTPAPI_SetOption shall receive the option as a pair optionName/value. ]*/
@@ -1328,6 +1736,26 @@ HTTPAPI_RESULT HTTPAPI_SetOption(HTTP_HANDLE handle, const char* optionName, con
             result = HTTPAPI_OK;
         }
     }
+    else if (strcmp(OPTION_HTTP_DECOMPRESS_RESPONSE, optionName) == 0)
+    {
+        /*Codes_SRS_HTTPAPI_COMPACT_21_097: [ If the optionName is `decompress_response`, the HTTPAPI_SetOption shall enable or disable the decoding of gzip and deflate response bodies as given by the bool pointed by value. ]*/
+        if (*(const bool*)value)
+        {
+#ifdef USE_ZLIB
+            http_instance->decompress_response = 1;
+            result = HTTPAPI_OK;
+#else
+            /*Codes_SRS_HTTPAPI_COMPACT_21_102: [ If the HTTPAPI is built without zlib, enabling `decompress_response` shall return HTTPAPI_INVALID_ARG. ]*/
+            result = HTTPAPI_INVALID_ARG;
+            LogError("response decompression requires building with use_zlib");
+#endif
+        }
+        else
+        {
+            http_instance->decompress_response = 0;
+            result = HTTPAPI_OK;
+        }
+    }
     else
     {
         /*Codes_SRS_HTTPAPI_COMPACT_21_063: [ If the HTTP do not support the optionName, the HTTPAPI_SetOption shall return HTTPAPI_INVALID_ARG. ]*/
@@ -1407,6 +1835,22 @@ HTTPAPI_RESULT HTTPAPI_CloneOption(const char* optionName, const void* value, co
             result = HTTPAPI_OK;
         }
     }
+    else if (strcmp(OPTION_HTTP_DECOMPRESS_RESPONSE, optionName) == 0)
+    {
+        bool* tempBool = (bool*)malloc(sizeof(bool));
+        if (tempBool == NULL)
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_070: [ If any memory allocation get fail, the HTTPAPI_CloneOption shall return HTTPAPI_ALLOC_FAILED. ]*/
+            result = HTTPAPI_ALLOC_FAILED;
+        }
+        else
+        {
+            /*Codes_SRS_HTTPAPI_COMPACT_21_072: [ If the HTTPAPI_CloneOption get success setting the option, it shall return HTTPAPI_OK. ]*/
+            *tempBool = *(const bool*)value;
+            *savedValue = tempBool;
+            result = HTTPAPI_OK;
+        }
+    }
     else
     {
         /*Codes_SRS_HTTPAPI_COMPACT_21_071: [ If the HTTP do not support the optionName, the HTTPAPI_CloneOption shall return HTTPAPI_INVALID_ARG. ]*/
@@ -37,6 +37,7 @@ typedef struct HTTP_HANDLE_DATA_TAG
     long forbidReuse;
     long freshConnect;
     long verbose;
+    bool decompressResponse;
     const char* x509privatekey;
     const char* x509certificate;
     const char* certificates; /*a list of CA certificates*/
@@ -49,6 +50,15 @@ typedef struct HTTP_RESPONSE_CONTENT_BUFFER_TAG
     unsigned char error;
 } HTTP_RESPONSE_CONTENT_BUFFER;
 
+typedef struct HTTP_STREAMING_CONTEXT_TAG
+{
+    HTTPAPI_REQUEST_BODY_READ_CALLBACK requestBodyCallback;
+    void* requestBodyContext;
+    HTTPAPI_RESPONSE_BODY_WRITE_CALLBACK responseBodyCallback;
+    void* responseBodyContext;
+    unsigned char error;
+} HTTP_STREAMING_CONTEXT;
+
 static size_t nUsersOfHTTPAPI = 0; /*used for reference counting (a weak one)*/
 
 HTTPAPI_RESULT HTTPAPI_Init(void)
@@ -132,6 +142,7 @@ HTTP_HANDLE HTTPAPI_CreateConnection(const char* hostName)
                         httpHandleData->forbidReuse = 0;
                         httpHandleData->freshConnect = 0;
                         httpHandleData->verbose = 0;
+                        httpHandleData->decompressResponse = false;
                         httpHandleData->x509certificate = NULL;
                         httpHandleData->x509privatekey = NULL;
                         httpHandleData->certificates = NULL;
@@ -218,6 +229,59 @@ static size_t ContentWriteFunction(void *ptr, size_t size, size_t nmemb, void *u
     return size * nmemb;
 }
 
+static size_t StreamingContentWriteFunction(void *ptr, size_t size, size_t nmemb, void *userdata)
+{
+    size_t result;
+    HTTP_STREAMING_CONTEXT* streamingContext = (HTTP_STREAMING_CONTEXT*)userdata;
+    if ((userdata == NULL) ||
+        (ptr == NULL) ||
+        (size * nmemb == 0) ||
+        (streamingContext->responseBodyCallback == NULL))
+    {
+        /*without a response body callback the body is dropped as it arrives, so that it is never held in memory*/
+        result = size * nmemb;
+    }
+    else if (streamingContext->responseBodyCallback(streamingContext->responseBodyContext, (const unsigned char*)ptr, size * nmemb) != 0)
+    {
+        LogError("response body callback failed, aborting transfer");
+        streamingContext->error = 1;
+        /*returning anything other than size * nmemb makes curl abort with CURLE_WRITE_ERROR*/
+        result = 0;
+    }
+    else
+    {
+        result = size * nmemb;
+    }
+
+    return result;
+}
+
+static size_t StreamingContentReadFunction(char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+    size_t result;
+    HTTP_STREAMING_CONTEXT* streamingContext = (HTTP_STREAMING_CONTEXT*)userdata;
+    size_t bytesRead = 0;
+    if (streamingContext->requestBodyCallback(streamingContext->requestBodyContext, (unsigned char*)ptr, size * nmemb, &bytesRead) != 0)
+    {
+        LogError("request body callback failed, aborting transfer");
+        streamingContext->error = 1;
+        result = CURL_READFUNC_ABORT;
+    }
+    else if (bytesRead > size * nmemb)
+    {
+        LogError("request body callback returned more bytes (%zu) than requested (%zu)", bytesRead, size * nmemb);
+        streamingContext->error = 1;
+        result = CURL_READFUNC_ABORT;
+    }
+    else
+    {
+        /*0 tells curl the body is complete; curl then terminates the chunked encoding*/
+        result = bytesRead;
+    }
+
+    return result;
+}
+
 static CURLcode ssl_ctx_callback(CURL *curl, void *ssl_ctx, void *userptr)
 {
     CURLcode result;
@@ -290,26 +354,17 @@ static CURLcode ssl_ctx_callback(CURL *curl, void *ssl_ctx, void *userptr)
     return result;
 }
 
-HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
+static HTTPAPI_RESULT ExecuteRequestInternal(HTTP_HANDLE_DATA* httpHandleData, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
                                       HTTP_HEADERS_HANDLE httpHeadersHandle, const unsigned char* content,
                                       size_t contentLength, unsigned int* statusCode,
-                                      HTTP_HEADERS_HANDLE responseHeadersHandle, BUFFER_HANDLE responseContent)
+                                      HTTP_HEADERS_HANDLE responseHeadersHandle, BUFFER_HANDLE responseContent,
+                                      HTTP_STREAMING_CONTEXT* streamingContext)
 {
     HTTPAPI_RESULT result;
-    HTTP_HANDLE_DATA* httpHandleData = (HTTP_HANDLE_DATA*)handle;
     size_t headersCount;
     HTTP_RESPONSE_CONTENT_BUFFER responseContentBuffer;
 
-    if ((httpHandleData == NULL) ||
-        (relativePath == NULL) ||
-        (httpHeadersHandle == NULL) ||
-        ((content == NULL) && (contentLength > 0))
-    )
-    {
-        result = HTTPAPI_INVALID_ARG;
-        LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
-    }
-    else if (HTTPHeaders_GetHeaderCount(httpHeadersHandle, &headersCount) != HTTP_HEADERS_OK)
+    if (HTTPHeaders_GetHeaderCount(httpHeadersHandle, &headersCount) != HTTP_HEADERS_OK)
     {
         result = HTTPAPI_INVALID_ARG;
         LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
@@ -331,6 +386,12 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
                 result = HTTPAPI_SET_OPTION_FAILED;
                 LogError("failed to set CURLOPT_VERBOSE (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
             }
+            /* an empty string lets libcurl advertise and decode every encoding it was built with */
+            else if (curl_easy_setopt(httpHandleData->curl, CURLOPT_ACCEPT_ENCODING, httpHandleData->decompressResponse ? "" : NULL) != CURLE_OK)
+            {
+                result = HTTPAPI_SET_OPTION_FAILED;
+                LogError("failed to set CURLOPT_ACCEPT_ENCODING (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+            }
             else if ((strcpy_s(tempHostURL, tempHostURL_size, httpHandleData->hostURL) != 0) ||
                 (strcat_s(tempHostURL, tempHostURL_size, relativePath) != 0))
             {
@@ -491,12 +552,16 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
                 {
                     /* add headers */
                     struct curl_slist* headers = NULL;
+                    /*curl_slist_append copies the line, so a single buffer is reused for all the headers*/
+                    char* line = NULL;
+                    size_t lineSize = 0;
                     size_t i;
 
                     for (i = 0; i < headersCount; i++)
                     {
-                        char *tempBuffer;
-                        if (HTTPHeaders_GetHeader(httpHeadersHandle, i, &tempBuffer) != HTTP_HEADERS_OK)
+                        const char* name;
+                        const char* value;
+                        if (HTTPHeaders_GetHeaderNameValue(httpHeadersHandle, i, &name, &value) != HTTP_HEADERS_OK)
                         {
                             /* error */
                             result = HTTPAPI_HTTP_HEADERS_FAILED;
@@ -505,21 +570,62 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
                         }
                         else
                         {
-                            struct curl_slist* newHeaders = curl_slist_append(headers, tempBuffer);
+                            size_t nameLength = strlen(name);
+                            size_t valueLength = strlen(value);
+                            size_t neededSize = nameLength + /*COLON_AND_SPACE_LENGTH*/ 2 + valueLength + /*EOL*/ 1;
+                            struct curl_slist* newHeaders;
+
+                            if (neededSize > lineSize)
+                            {
+                                char* newLine = (char*)realloc(line, neededSize);
+                                if (newLine == NULL)
+                                {
+                                    result = HTTPAPI_ALLOC_FAILED;
+                                    LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+                                    break;
+                                }
+                                line = newLine;
+                                lineSize = neededSize;
+                            }
+
+                            (void)memcpy(line, name, nameLength);
+                            line[nameLength] = ':';
+                            line[nameLength + 1] = ' ';
+                            (void)memcpy(line + nameLength + 2, value, valueLength + /*EOL*/ 1);
+
+                            newHeaders = curl_slist_append(headers, line);
                             if (newHeaders == NULL)
                             {
                                 result = HTTPAPI_ALLOC_FAILED;
                                 LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
-                                free(tempBuffer);
                                 break;
                             }
                             else
                             {
-                                free(tempBuffer);
                                 headers = newHeaders;
                             }
                         }
                     }
+                    free(line);
+
+                    if ((result == HTTPAPI_OK) &&
+                        (streamingContext != NULL) &&
+                        (streamingContext->requestBodyCallback != NULL) &&
+                        (requestType != HTTPAPI_REQUEST_GET) &&
+                        (requestType != HTTPAPI_REQUEST_HEAD))
+                    {
+                        /*the length of a streamed body is unknown upfront, so it goes out chunked*/
+                        struct curl_slist* newHeaders = curl_slist_append(headers, "Transfer-Encoding: chunked");
+                        if (newHeaders == NULL)
+                        {
+                            result = HTTPAPI_ALLOC_FAILED;
+                            LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+                        }
+                        else
+                        {
+                            headers = newHeaders;
+                        }
+                    }
 
                     if (result == HTTPAPI_OK)
                     {
@@ -531,7 +637,21 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
                         else
                         {
                             /* add content */
-                            if ((content != NULL) &&
+                            if ((streamingContext != NULL) &&
+                                (streamingContext->requestBodyCallback != NULL) &&
+                                (requestType != HTTPAPI_REQUEST_GET) &&
+                                (requestType != HTTPAPI_REQUEST_HEAD))
+                            {
+                                if ((curl_easy_setopt(httpHandleData->curl, CURLOPT_POSTFIELDS, (void*)NULL) != CURLE_OK) ||
+                                    (curl_easy_setopt(httpHandleData->curl, CURLOPT_POSTFIELDSIZE, -1L) != CURLE_OK) ||
+                                    (curl_easy_setopt(httpHandleData->curl, CURLOPT_READFUNCTION, StreamingContentReadFunction) != CURLE_OK) ||
+                                    (curl_easy_setopt(httpHandleData->curl, CURLOPT_READDATA, streamingContext) != CURLE_OK))
+                                {
+                                    result = HTTPAPI_SET_OPTION_FAILED;
+                                    LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+                                }
+                            }
+                            else if ((content != NULL) &&
                                 (contentLength > 0))
                             {
                                 if ((curl_easy_setopt(httpHandleData->curl, CURLOPT_POSTFIELDS, (void*)content) != CURLE_OK) ||
@@ -562,7 +682,7 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
                             {
                                 if ((curl_easy_setopt(httpHandleData->curl, CURLOPT_WRITEHEADER, NULL) != CURLE_OK) ||
                                     (curl_easy_setopt(httpHandleData->curl, CURLOPT_HEADERFUNCTION, NULL) != CURLE_OK) ||
-                                    (curl_easy_setopt(httpHandleData->curl, CURLOPT_WRITEFUNCTION, ContentWriteFunction) != CURLE_OK))
+                                    (curl_easy_setopt(httpHandleData->curl, CURLOPT_WRITEFUNCTION, (streamingContext != NULL) ? StreamingContentWriteFunction : ContentWriteFunction) != CURLE_OK))
                                 {
                                     result = HTTPAPI_SET_OPTION_FAILED;
                                     LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
@@ -586,7 +706,7 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
                                         responseContentBuffer.bufferSize = 0;
                                         responseContentBuffer.error = 0;
 
-                                        if (curl_easy_setopt(httpHandleData->curl, CURLOPT_WRITEDATA, &responseContentBuffer) != CURLE_OK)
+                                        if (curl_easy_setopt(httpHandleData->curl, CURLOPT_WRITEDATA, (streamingContext != NULL) ? (void*)streamingContext : (void*)&responseContentBuffer) != CURLE_OK)
                                         {
                                             result = HTTPAPI_SET_OPTION_FAILED;
                                             LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
@@ -612,7 +732,8 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
                                                     result = HTTPAPI_QUERY_HEADERS_FAILED;
                                                     LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
                                                 }
-                                                else if (responseContentBuffer.error)
+                                                else if ((responseContentBuffer.error) ||
+                                                    ((streamingContext != NULL) && (streamingContext->error)))
                                                 {
                                                     result = HTTPAPI_READ_DATA_FAILED;
                                                     LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
@@ -671,6 +792,71 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
     return result;
 }
 
+HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
+                                      HTTP_HEADERS_HANDLE httpHeadersHandle, const unsigned char* content,
+                                      size_t contentLength, unsigned int* statusCode,
+                                      HTTP_HEADERS_HANDLE responseHeadersHandle, BUFFER_HANDLE responseContent)
+{
+    HTTPAPI_RESULT result;
+    HTTP_HANDLE_DATA* httpHandleData = (HTTP_HANDLE_DATA*)handle;
+
+    if ((httpHandleData == NULL) ||
+        (relativePath == NULL) ||
+        (httpHeadersHandle == NULL) ||
+        ((content == NULL) && (contentLength > 0))
+    )
+    {
+        result = HTTPAPI_INVALID_ARG;
+        LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+    }
+    else
+    {
+        result = ExecuteRequestInternal(httpHandleData, requestType, relativePath, httpHeadersHandle, content, contentLength,
+            statusCode, responseHeadersHandle, responseContent, NULL);
+    }
+
+    return result;
+}
+
+HTTPAPI_RESULT HTTPAPI_ExecuteStreamingRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
+                                      HTTP_HEADERS_HANDLE httpHeadersHandle, HTTPAPI_REQUEST_BODY_READ_CALLBACK requestBodyCallback, void* requestBodyContext,
+                                      unsigned int* statusCode, HTTP_HEADERS_HANDLE responseHeadersHandle,
+                                      HTTPAPI_RESPONSE_BODY_WRITE_CALLBACK responseBodyCallback, void* responseBodyContext)
+{
+    HTTPAPI_RESULT result;
+    HTTP_HANDLE_DATA* httpHandleData = (HTTP_HANDLE_DATA*)handle;
+
+    if ((httpHandleData == NULL) ||
+        (relativePath == NULL) ||
+        (httpHeadersHandle == NULL)
+    )
+    {
+        result = HTTPAPI_INVALID_ARG;
+        LogError("(result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+    }
+    else
+    {
+        HTTP_STREAMING_CONTEXT streamingContext;
+        streamingContext.requestBodyCallback = requestBodyCallback;
+        streamingContext.requestBodyContext = requestBodyContext;
+        streamingContext.responseBodyCallback = responseBodyCallback;
+        streamingContext.responseBodyContext = responseBodyContext;
+        streamingContext.error = 0;
+
+        result = ExecuteRequestInternal(httpHandleData, requestType, relativePath, httpHeadersHandle, NULL, 0,
+            statusCode, responseHeadersHandle, NULL, &streamingContext);
+
+        if (requestBodyCallback != NULL)
+        {
+            /*do not leave a dangling read callback on the curl handle for the next non streaming request*/
+            (void)curl_easy_setopt(httpHandleData->curl, CURLOPT_READFUNCTION, NULL);
+            (void)curl_easy_setopt(httpHandleData->curl, CURLOPT_READDATA, NULL);
+        }
+    }
+
+    return result;
+}
+
 HTTPAPI_RESULT HTTPAPI_SetOption(HTTP_HANDLE handle, const char* optionName, const void* value)
 {
     HTTPAPI_RESULT result;
@@ -717,6 +903,11 @@ HTTPAPI_RESULT HTTPAPI_SetOption(HTTP_HANDLE handle, const char* optionName, con
             httpHandleData->verbose = *(const long*)value;
             result = HTTPAPI_OK;
         }
+        else if (strcmp(OPTION_HTTP_DECOMPRESS_RESPONSE, optionName) == 0)
+        {
+            httpHandleData->decompressResponse = *(const bool*)value;
+            result = HTTPAPI_OK;
+        }
         else if (strcmp(SU_OPTION_X509_PRIVATE_KEY, optionName) == 0 || strcmp(OPTION_X509_ECC_KEY, optionName) == 0)
         {
             httpHandleData->x509privatekey = value;
@@ -981,6 +1172,22 @@ HTTPAPI_RESULT HTTPAPI_CloneOption(const char* optionName, const void* value, co
                 result = HTTPAPI_OK;
             }
         }
+        else if (strcmp(OPTION_HTTP_DECOMPRESS_RESPONSE, optionName) == 0)
+        {
+            /*by convention value is pointing to a bool */
+            bool* temp = malloc(sizeof(bool)); /*shall be freed by HTTPAPIEX*/
+            if (temp == NULL)
+            {
+                result = HTTPAPI_ERROR;
+                LogError("malloc failed (result = %s)", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+            }
+            else
+            {
+                *temp = *(const bool*)value;
+                *savedValue = temp;
+                result = HTTPAPI_OK;
+            }
+        }
         else
         {
             result = HTTPAPI_INVALID_ARG;
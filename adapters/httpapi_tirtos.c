@@ -285,6 +285,85 @@ headersDone:
     return (HTTPAPI_OK);
 }
 
+/*this platform has no streaming transport, so both bodies are staged in memory around HTTPAPI_ExecuteRequest*/
+HTTPAPI_RESULT HTTPAPI_ExecuteStreamingRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
+    HTTP_HEADERS_HANDLE httpHeadersHandle, HTTPAPI_REQUEST_BODY_READ_CALLBACK requestBodyCallback, void* requestBodyContext,
+    unsigned int* statusCode, HTTP_HEADERS_HANDLE responseHeadersHandle,
+    HTTPAPI_RESPONSE_BODY_WRITE_CALLBACK responseBodyCallback, void* responseBodyContext)
+{
+    HTTPAPI_RESULT result;
+    if ((handle == NULL) ||
+        (relativePath == NULL) ||
+        (httpHeadersHandle == NULL))
+    {
+        result = HTTPAPI_INVALID_ARG;
+        LogError("invalid arg HTTP_HANDLE handle=%p, const char* relativePath=%p, HTTP_HEADERS_HANDLE httpHeadersHandle=%p", handle, relativePath, httpHeadersHandle);
+    }
+    else
+    {
+        BUFFER_HANDLE requestContent = BUFFER_new();
+        BUFFER_HANDLE responseContent = BUFFER_new();
+        if ((requestContent == NULL) || (responseContent == NULL))
+        {
+            result = HTTPAPI_ALLOC_FAILED;
+            LogError("unable to allocate the staging buffers");
+        }
+        else
+        {
+            unsigned char piece[1024];
+            size_t bytesRead = 0;
+
+            result = HTTPAPI_OK;
+            if (requestBodyCallback != NULL)
+            {
+                do
+                {
+                    bytesRead = 0;
+                    if ((requestBodyCallback(requestBodyContext, piece, sizeof(piece), &bytesRead) != 0) ||
+                        (bytesRead > sizeof(piece)))
+                    {
+                        result = HTTPAPI_SEND_REQUEST_FAILED;
+                        LogError("request body callback failed");
+                    }
+                    else if ((bytesRead > 0) &&
+                        (BUFFER_append_build(requestContent, piece, bytesRead) != 0))
+                    {
+                        result = HTTPAPI_ALLOC_FAILED;
+                        LogError("unable to stage the request body");
+                    }
+                } while ((result == HTTPAPI_OK) && (bytesRead > 0));
+            }
+
+            if (result == HTTPAPI_OK)
+            {
+                size_t requestLength = BUFFER_length(requestContent);
+                result = HTTPAPI_ExecuteRequest(handle, requestType, relativePath, httpHeadersHandle,
+                    (requestLength > 0) ? BUFFER_u_char(requestContent) : NULL, requestLength,
+                    statusCode, responseHeadersHandle, responseContent);
+                if ((result == HTTPAPI_OK) &&
+                    (responseBodyCallback != NULL) &&
+                    (BUFFER_length(responseContent) > 0) &&
+                    (responseBodyCallback(responseBodyContext, BUFFER_u_char(responseContent), BUFFER_length(responseContent)) != 0))
+                {
+                    result = HTTPAPI_READ_DATA_FAILED;
+                    LogError("response body callback failed");
+                }
+            }
+        }
+
+        if (requestContent != NULL)
+        {
+            BUFFER_delete(requestContent);
+        }
+        if (responseContent != NULL)
+        {
+            BUFFER_delete(responseContent);
+        }
+    }
+
+    return result;
+}
+
 HTTPAPI_RESULT HTTPAPI_SetOption(HTTP_HANDLE handle, const char* optionName,
         const void* value)
 {
@@ -1,28 +1,149 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
+#define _DEFAULT_SOURCE
+
 #include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
 #include <pthread.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#define ADAPTIVE_LOCK_USE_FUTEX
+#endif
 #include "azure_c_shared_utility/lock.h"
 #include "azure_c_shared_utility/xlogging.h"
 
+#define MILLISECONDS_IN_1_SECOND        1000
+#define NANOSECONDS_IN_1_MILLISECOND    1000000L
+#define NANOSECONDS_IN_1_SECOND         1000000000L
+
+/*upper bound of the spins of an adaptive lock before it waits in the kernel, the same as glibc's adaptive mutexes*/
+#define ADAPTIVE_LOCK_MAX_SPIN          100
+
+#ifdef LOCK_COLLECT_CONTENTION
+#define COUNT_ACQUIRED(counters)        (void)__atomic_fetch_add(&(counters).acquired, 1, __ATOMIC_RELAXED)
+#define COUNT_CONTENDED(counters)       (void)__atomic_fetch_add(&(counters).contended, 1, __ATOMIC_RELAXED)
+#else
+#define COUNT_ACQUIRED(counters)
+#define COUNT_CONTENDED(counters)
+#endif
+
+/*the mutex comes first: condition_pthreads hands a LOCK_HANDLE straight to pthread_cond_wait*/
+typedef struct LOCK_INSTANCE_TAG
+{
+    pthread_mutex_t mutex;
+#ifdef LOCK_COLLECT_CONTENTION
+    LOCK_CONTENTION_COUNTERS counters;
+#endif
+} LOCK_INSTANCE;
+
+typedef struct ADAPTIVE_LOCK_TAG
+{
+#ifdef ADAPTIVE_LOCK_USE_FUTEX
+    /*0: free, 1: held, 2: held and a thread may be waiting in the kernel*/
+    int state;
+#else
+    pthread_mutex_t mutex;
+#endif
+    /*running average of the spins that recent contended acquisitions needed*/
+    int spin_estimate;
+    int max_spin;
+#ifdef LOCK_COLLECT_CONTENTION
+    LOCK_CONTENTION_COUNTERS counters;
+#endif
+} ADAPTIVE_LOCK;
+
+typedef struct RWLOCK_TAG
+{
+    pthread_rwlock_t rwlock;
+#ifdef LOCK_COLLECT_CONTENTION
+    LOCK_CONTENTION_COUNTERS read_counters;
+    LOCK_CONTENTION_COUNTERS write_counters;
+#endif
+} RWLOCK;
+
+static void get_deadline(clockid_t clock, unsigned int timeout_milliseconds, struct timespec* deadline)
+{
+    (void)clock_gettime(clock, deadline);
+    deadline->tv_sec += timeout_milliseconds / MILLISECONDS_IN_1_SECOND;
+    deadline->tv_nsec += (timeout_milliseconds % MILLISECONDS_IN_1_SECOND) * NANOSECONDS_IN_1_MILLISECOND;
+    if (deadline->tv_nsec >= NANOSECONDS_IN_1_SECOND)
+    {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= NANOSECONDS_IN_1_SECOND;
+    }
+}
+
+/*false once the deadline has passed*/
+static bool get_remaining_time(const struct timespec* deadline, struct timespec* remaining)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    remaining->tv_sec = deadline->tv_sec - now.tv_sec;
+    remaining->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+    if (remaining->tv_nsec < 0)
+    {
+        remaining->tv_sec--;
+        remaining->tv_nsec += NANOSECONDS_IN_1_SECOND;
+    }
+
+    return (remaining->tv_sec > 0) || ((remaining->tv_sec == 0) && (remaining->tv_nsec > 0));
+}
+
+/*returns 0, ETIMEDOUT or the error of the mutex*/
+static int timed_lock_mutex(pthread_mutex_t* mutex, unsigned int timeout_milliseconds)
+{
+    int result;
+#ifdef __APPLE__
+    /*no pthread_mutex_timedlock: poll*/
+    struct timespec deadline;
+    struct timespec remaining;
+    get_deadline(CLOCK_MONOTONIC, timeout_milliseconds, &deadline);
+    while (((result = pthread_mutex_trylock(mutex)) == EBUSY) && get_remaining_time(&deadline, &remaining))
+    {
+        struct timespec poll_interval = { 0, NANOSECONDS_IN_1_MILLISECOND };
+        (void)nanosleep(&poll_interval, NULL);
+    }
+    if (result == EBUSY)
+    {
+        result = ETIMEDOUT;
+    }
+#else
+    struct timespec deadline;
+    get_deadline(CLOCK_REALTIME, timeout_milliseconds, &deadline);
+    result = pthread_mutex_timedlock(mutex, &deadline);
+#endif
+    return result;
+}
+
 LOCK_HANDLE Lock_Init(void)
 {
     /* Codes_SRS_LOCK_10_002: [Lock_Init on success shall return a valid lock handle which should be a non NULL value] */
-    pthread_mutex_t* result = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
+    LOCK_INSTANCE* result = (LOCK_INSTANCE*)malloc(sizeof(LOCK_INSTANCE));
     if (result == NULL)
     {
         LogError("malloc failed.");
     }
     else
     {
-        if (pthread_mutex_init(result, NULL) != 0)
+        if (pthread_mutex_init(&result->mutex, NULL) != 0)
         {
             /* Codes_SRS_LOCK_10_003: [Lock_Init on error shall return NULL ] */
             LogError("pthread_mutex_init failed.");
             free(result);
             result = NULL;
         }
+#ifdef LOCK_COLLECT_CONTENTION
+        else
+        {
+            result->counters.acquired = 0;
+            result->counters.contended = 0;
+        }
+#endif
     }
 
     return (LOCK_HANDLE)result;
@@ -39,9 +160,21 @@ LOCK_RESULT Lock(LOCK_HANDLE handle)
     }
     else
     {
-        if (pthread_mutex_lock((pthread_mutex_t*)handle) == 0)
+        LOCK_INSTANCE* lock = (LOCK_INSTANCE*)handle;
+#ifdef LOCK_COLLECT_CONTENTION
+        int lock_result = pthread_mutex_trylock(&lock->mutex);
+        if (lock_result == EBUSY)
+        {
+            COUNT_CONTENDED(lock->counters);
+            lock_result = pthread_mutex_lock(&lock->mutex);
+        }
+#else
+        int lock_result = pthread_mutex_lock(&lock->mutex);
+#endif
+        if (lock_result == 0)
         {
             /* Codes_SRS_LOCK_10_005: [Lock on success shall return LOCK_OK] */
+            COUNT_ACQUIRED(lock->counters);
             result = LOCK_OK;
         }
         else
@@ -66,7 +199,7 @@ LOCK_RESULT Unlock(LOCK_HANDLE handle)
     }
     else
     {
-        if (pthread_mutex_unlock((pthread_mutex_t*)handle) == 0)
+        if (pthread_mutex_unlock(&((LOCK_INSTANCE*)handle)->mutex) == 0)
         {
             /* Codes_SRS_LOCK_10_009: [Unlock on success shall return LOCK_OK] */
             result = LOCK_OK;
@@ -94,7 +227,7 @@ LOCK_RESULT Lock_Deinit(LOCK_HANDLE handle)
     else
     {
         /* Codes_SRS_LOCK_10_012: [Lock_Deinit frees the memory pointed by handle] */
-        if(pthread_mutex_destroy((pthread_mutex_t*)handle) == 0)
+        if(pthread_mutex_destroy(&((LOCK_INSTANCE*)handle)->mutex) == 0)
         {
             free(handle);
             handle = NULL;
@@ -109,3 +242,703 @@ LOCK_RESULT Lock_Deinit(LOCK_HANDLE handle)
 
     return result;
 }
+
+LOCK_RESULT Lock_Try(LOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_001: [ Lock_Try on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        LOCK_INSTANCE* lock = (LOCK_INSTANCE*)handle;
+        int lock_result = pthread_mutex_trylock(&lock->mutex);
+        if (lock_result == 0)
+        {
+            /* Codes_SRS_LOCK_01_002: [ Lock_Try shall acquire the lock and return LOCK_OK if no thread holds it ]*/
+            COUNT_ACQUIRED(lock->counters);
+            result = LOCK_OK;
+        }
+        else if (lock_result == EBUSY)
+        {
+            /* Codes_SRS_LOCK_01_003: [ Lock_Try shall return LOCK_BUSY without waiting if the lock is held ]*/
+            COUNT_CONTENDED(lock->counters);
+            result = LOCK_BUSY;
+        }
+        else
+        {
+            /* Codes_SRS_LOCK_01_004: [ Lock_Try on error shall return LOCK_ERROR ]*/
+            LogError("pthread_mutex_trylock failed.");
+            result = LOCK_ERROR;
+        }
+    }
+
+    return result;
+}
+
+LOCK_RESULT Lock_Timed(LOCK_HANDLE handle, unsigned int timeout_milliseconds)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_005: [ Lock_Timed on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        LOCK_INSTANCE* lock = (LOCK_INSTANCE*)handle;
+        int lock_result = pthread_mutex_trylock(&lock->mutex);
+        if (lock_result == EBUSY)
+        {
+            COUNT_CONTENDED(lock->counters);
+            lock_result = timed_lock_mutex(&lock->mutex, timeout_milliseconds);
+        }
+
+        if (lock_result == 0)
+        {
+            /* Codes_SRS_LOCK_01_006: [ Lock_Timed shall acquire the lock and return LOCK_OK if it is released within timeout_milliseconds ]*/
+            COUNT_ACQUIRED(lock->counters);
+            result = LOCK_OK;
+        }
+        else if (lock_result == ETIMEDOUT)
+        {
+            /* Codes_SRS_LOCK_01_007: [ Lock_Timed shall return LOCK_TIMEOUT if the lock is still held after timeout_milliseconds ]*/
+            result = LOCK_TIMEOUT;
+        }
+        else
+        {
+            /* Codes_SRS_LOCK_01_008: [ Lock_Timed on error shall return LOCK_ERROR ]*/
+            LogError("pthread_mutex_timedlock failed.");
+            result = LOCK_ERROR;
+        }
+    }
+
+    return result;
+}
+
+static void cpu_relax(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__ARM_ARCH) && (__ARM_ARCH >= 7))
+    __asm__ __volatile__("yield" ::: "memory");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+#ifdef ADAPTIVE_LOCK_USE_FUTEX
+static bool adaptive_lock_try_acquire(ADAPTIVE_LOCK* lock)
+{
+    int expected = 0;
+    return __atomic_compare_exchange_n(&lock->state, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static bool adaptive_lock_is_free(ADAPTIVE_LOCK* lock)
+{
+    return __atomic_load_n(&lock->state, __ATOMIC_RELAXED) == 0;
+}
+
+/*returns 0 once the lock is held or ETIMEDOUT*/
+static int adaptive_lock_wait(ADAPTIVE_LOCK* lock, bool is_timed, unsigned int timeout_milliseconds)
+{
+    int result = 0;
+    struct timespec deadline;
+
+    if (is_timed)
+    {
+        get_deadline(CLOCK_MONOTONIC, timeout_milliseconds, &deadline);
+    }
+
+    /*marking the lock as waited for makes the owner wake a waiter when it releases it*/
+    while (__atomic_exchange_n(&lock->state, 2, __ATOMIC_ACQUIRE) != 0)
+    {
+        struct timespec remaining;
+        if (!is_timed)
+        {
+            (void)syscall(SYS_futex, &lock->state, FUTEX_WAIT_PRIVATE, 2, NULL, NULL, 0);
+        }
+        else if (get_remaining_time(&deadline, &remaining))
+        {
+            (void)syscall(SYS_futex, &lock->state, FUTEX_WAIT_PRIVATE, 2, &remaining, NULL, 0);
+        }
+        else
+        {
+            result = ETIMEDOUT;
+            break;
+        }
+    }
+
+    return result;
+}
+#else
+static bool adaptive_lock_try_acquire(ADAPTIVE_LOCK* lock)
+{
+    return pthread_mutex_trylock(&lock->mutex) == 0;
+}
+
+static bool adaptive_lock_is_free(ADAPTIVE_LOCK* lock)
+{
+    (void)lock;
+    return true;
+}
+
+static int adaptive_lock_wait(ADAPTIVE_LOCK* lock, bool is_timed, unsigned int timeout_milliseconds)
+{
+    return is_timed ? timed_lock_mutex(&lock->mutex, timeout_milliseconds) : pthread_mutex_lock(&lock->mutex);
+}
+#endif
+
+/*spins for about as long as recent acquisitions needed to, returns true if the lock was acquired meanwhile*/
+static bool adaptive_lock_spin(ADAPTIVE_LOCK* lock)
+{
+    int estimate = __atomic_load_n(&lock->spin_estimate, __ATOMIC_RELAXED);
+    int limit = (estimate * 2) + 10;
+    int spins;
+    bool result = false;
+
+    if (limit > lock->max_spin)
+    {
+        limit = lock->max_spin;
+    }
+
+    for (spins = 0; spins < limit; spins++)
+    {
+        cpu_relax();
+        if (adaptive_lock_is_free(lock) && adaptive_lock_try_acquire(lock))
+        {
+            result = true;
+            break;
+        }
+    }
+
+    if (limit > 0)
+    {
+        __atomic_store_n(&lock->spin_estimate, estimate + ((spins - estimate) / 8), __ATOMIC_RELAXED);
+    }
+
+    return result;
+}
+
+static LOCK_RESULT adaptive_lock_acquire(ADAPTIVE_LOCK* lock, bool is_timed, unsigned int timeout_milliseconds)
+{
+    LOCK_RESULT result;
+
+    if (adaptive_lock_try_acquire(lock))
+    {
+        result = LOCK_OK;
+    }
+    else
+    {
+        int wait_result;
+
+        COUNT_CONTENDED(lock->counters);
+        if (adaptive_lock_spin(lock))
+        {
+            wait_result = 0;
+        }
+        else
+        {
+            wait_result = adaptive_lock_wait(lock, is_timed, timeout_milliseconds);
+        }
+
+        if (wait_result == 0)
+        {
+            result = LOCK_OK;
+        }
+        else if (wait_result == ETIMEDOUT)
+        {
+            result = LOCK_TIMEOUT;
+        }
+        else
+        {
+            LogError("waiting for the lock failed.");
+            result = LOCK_ERROR;
+        }
+    }
+
+    if (result == LOCK_OK)
+    {
+        COUNT_ACQUIRED(lock->counters);
+    }
+
+    return result;
+}
+
+ADAPTIVE_LOCK_HANDLE AdaptiveLock_Init(void)
+{
+    ADAPTIVE_LOCK* result = (ADAPTIVE_LOCK*)malloc(sizeof(ADAPTIVE_LOCK));
+    if (result == NULL)
+    {
+        /* Codes_SRS_LOCK_01_010: [ AdaptiveLock_Init on error shall return NULL ]*/
+        LogError("malloc failed.");
+    }
+#ifndef ADAPTIVE_LOCK_USE_FUTEX
+    else if (pthread_mutex_init(&result->mutex, NULL) != 0)
+    {
+        /* Codes_SRS_LOCK_01_010: [ AdaptiveLock_Init on error shall return NULL ]*/
+        LogError("pthread_mutex_init failed.");
+        free(result);
+        result = NULL;
+    }
+#endif
+    else
+    {
+        /* Codes_SRS_LOCK_01_009: [ AdaptiveLock_Init shall create an exclusive lock that is not held and return it ]*/
+#ifdef ADAPTIVE_LOCK_USE_FUTEX
+        result->state = 0;
+#endif
+        result->spin_estimate = 0;
+        /*spinning only helps if the owner runs on another processor meanwhile*/
+        result->max_spin = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? ADAPTIVE_LOCK_MAX_SPIN : 0;
+#ifdef LOCK_COLLECT_CONTENTION
+        result->counters.acquired = 0;
+        result->counters.contended = 0;
+#endif
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_Deinit(ADAPTIVE_LOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_011: [ AdaptiveLock_Deinit on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_012: [ AdaptiveLock_Deinit shall free the lock and return LOCK_OK ]*/
+#ifndef ADAPTIVE_LOCK_USE_FUTEX
+        (void)pthread_mutex_destroy(&handle->mutex);
+#endif
+        free(handle);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_Lock(ADAPTIVE_LOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_013: [ AdaptiveLock_Lock on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_014: [ If the lock is held, AdaptiveLock_Lock shall spin for a bounded time and then wait until the lock is released ]*/
+        /* Codes_SRS_LOCK_01_015: [ AdaptiveLock_Lock shall return LOCK_OK once it holds the lock ]*/
+        result = adaptive_lock_acquire(handle, false, 0);
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_Unlock(ADAPTIVE_LOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_016: [ AdaptiveLock_Unlock on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+#ifdef ADAPTIVE_LOCK_USE_FUTEX
+        int previous_state = __atomic_exchange_n(&handle->state, 0, __ATOMIC_RELEASE);
+        if (previous_state == 0)
+        {
+            /* Codes_SRS_LOCK_01_018: [ AdaptiveLock_Unlock on error shall return LOCK_ERROR ]*/
+            LogError("The lock is not held.");
+            result = LOCK_ERROR;
+        }
+        else
+        {
+            /* Codes_SRS_LOCK_01_017: [ AdaptiveLock_Unlock shall release the lock, wake one thread waiting for it, and return LOCK_OK ]*/
+            if (previous_state == 2)
+            {
+                (void)syscall(SYS_futex, &handle->state, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+            }
+            result = LOCK_OK;
+        }
+#else
+        if (pthread_mutex_unlock(&handle->mutex) != 0)
+        {
+            /* Codes_SRS_LOCK_01_018: [ AdaptiveLock_Unlock on error shall return LOCK_ERROR ]*/
+            LogError("pthread_mutex_unlock failed.");
+            result = LOCK_ERROR;
+        }
+        else
+        {
+            /* Codes_SRS_LOCK_01_017: [ AdaptiveLock_Unlock shall release the lock, wake one thread waiting for it, and return LOCK_OK ]*/
+            result = LOCK_OK;
+        }
+#endif
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_Try(ADAPTIVE_LOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_019: [ AdaptiveLock_Try on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else if (adaptive_lock_try_acquire(handle))
+    {
+        /* Codes_SRS_LOCK_01_020: [ AdaptiveLock_Try shall acquire the lock and return LOCK_OK if no thread holds it ]*/
+        COUNT_ACQUIRED(handle->counters);
+        result = LOCK_OK;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_021: [ AdaptiveLock_Try shall return LOCK_BUSY without spinning or waiting if the lock is held ]*/
+        COUNT_CONTENDED(handle->counters);
+        result = LOCK_BUSY;
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_Timed(ADAPTIVE_LOCK_HANDLE handle, unsigned int timeout_milliseconds)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_022: [ AdaptiveLock_Timed on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_023: [ AdaptiveLock_Timed shall spin like AdaptiveLock_Lock and then wait at most until timeout_milliseconds have passed, returning LOCK_OK if it acquired the lock and LOCK_TIMEOUT otherwise ]*/
+        result = adaptive_lock_acquire(handle, true, timeout_milliseconds);
+    }
+
+    return result;
+}
+
+RWLOCK_HANDLE RWLock_Init(void)
+{
+    RWLOCK* result = (RWLOCK*)malloc(sizeof(RWLOCK));
+    if (result == NULL)
+    {
+        /* Codes_SRS_LOCK_01_025: [ RWLock_Init on error shall return NULL ]*/
+        LogError("malloc failed.");
+    }
+    else
+    {
+        pthread_rwlockattr_t attributes;
+        int init_result;
+
+        (void)pthread_rwlockattr_init(&attributes);
+#ifdef __GLIBC__
+        /*glibc lets readers in while a writer waits unless asked not to*/
+        (void)pthread_rwlockattr_setkind_np(&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+        init_result = pthread_rwlock_init(&result->rwlock, &attributes);
+        (void)pthread_rwlockattr_destroy(&attributes);
+
+        if (init_result != 0)
+        {
+            /* Codes_SRS_LOCK_01_025: [ RWLock_Init on error shall return NULL ]*/
+            LogError("pthread_rwlock_init failed.");
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_LOCK_01_024: [ RWLock_Init shall create a reader-writer lock that is not held and return it ]*/
+#ifdef LOCK_COLLECT_CONTENTION
+            result->read_counters.acquired = 0;
+            result->read_counters.contended = 0;
+            result->write_counters.acquired = 0;
+            result->write_counters.contended = 0;
+#endif
+        }
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_Deinit(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_026: [ RWLock_Deinit on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else if (pthread_rwlock_destroy(&handle->rwlock) != 0)
+    {
+        LogError("pthread_rwlock_destroy failed.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_027: [ RWLock_Deinit shall free the lock and return LOCK_OK ]*/
+        free(handle);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_ReadLock(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+#ifdef LOCK_COLLECT_CONTENTION
+        int lock_result = pthread_rwlock_tryrdlock(&handle->rwlock);
+        if (lock_result == EBUSY)
+        {
+            COUNT_CONTENDED(handle->read_counters);
+            lock_result = pthread_rwlock_rdlock(&handle->rwlock);
+        }
+#else
+        int lock_result = pthread_rwlock_rdlock(&handle->rwlock);
+#endif
+        if (lock_result != 0)
+        {
+            /* Codes_SRS_LOCK_01_034: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on error shall return LOCK_ERROR ]*/
+            LogError("pthread_rwlock_rdlock failed.");
+            result = LOCK_ERROR;
+        }
+        else
+        {
+            /* Codes_SRS_LOCK_01_029: [ RWLock_ReadLock shall wait while a writer holds the lock, then acquire it for reading alongside other readers and return LOCK_OK ]*/
+            COUNT_ACQUIRED(handle->read_counters);
+            result = LOCK_OK;
+        }
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_ReadUnlock(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else if (pthread_rwlock_unlock(&handle->rwlock) != 0)
+    {
+        /* Codes_SRS_LOCK_01_034: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on error shall return LOCK_ERROR ]*/
+        LogError("pthread_rwlock_unlock failed.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_030: [ RWLock_ReadUnlock and RWLock_WriteUnlock shall release the lock and return LOCK_OK ]*/
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_WriteLock(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+#ifdef LOCK_COLLECT_CONTENTION
+        int lock_result = pthread_rwlock_trywrlock(&handle->rwlock);
+        if (lock_result == EBUSY)
+        {
+            COUNT_CONTENDED(handle->write_counters);
+            lock_result = pthread_rwlock_wrlock(&handle->rwlock);
+        }
+#else
+        int lock_result = pthread_rwlock_wrlock(&handle->rwlock);
+#endif
+        if (lock_result != 0)
+        {
+            /* Codes_SRS_LOCK_01_034: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on error shall return LOCK_ERROR ]*/
+            LogError("pthread_rwlock_wrlock failed.");
+            result = LOCK_ERROR;
+        }
+        else
+        {
+            /* Codes_SRS_LOCK_01_031: [ RWLock_WriteLock shall wait while anyone holds the lock, then acquire it alone and return LOCK_OK ]*/
+            COUNT_ACQUIRED(handle->write_counters);
+            result = LOCK_OK;
+        }
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_WriteUnlock(RWLOCK_HANDLE handle)
+{
+    /* Codes_SRS_LOCK_01_030: [ RWLock_ReadUnlock and RWLock_WriteUnlock shall release the lock and return LOCK_OK ]*/
+    return RWLock_ReadUnlock(handle);
+}
+
+LOCK_RESULT RWLock_TryReadLock(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        int lock_result = pthread_rwlock_tryrdlock(&handle->rwlock);
+        if (lock_result == 0)
+        {
+            /* Codes_SRS_LOCK_01_032: [ RWLock_TryReadLock and RWLock_TryWriteLock shall acquire the lock and return LOCK_OK if they would not have to wait ]*/
+            COUNT_ACQUIRED(handle->read_counters);
+            result = LOCK_OK;
+        }
+        else if (lock_result == EBUSY)
+        {
+            /* Codes_SRS_LOCK_01_033: [ RWLock_TryReadLock and RWLock_TryWriteLock shall return LOCK_BUSY without waiting if they would have to wait ]*/
+            COUNT_CONTENDED(handle->read_counters);
+            result = LOCK_BUSY;
+        }
+        else
+        {
+            /* Codes_SRS_LOCK_01_034: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on error shall return LOCK_ERROR ]*/
+            LogError("pthread_rwlock_tryrdlock failed.");
+            result = LOCK_ERROR;
+        }
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_TryWriteLock(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        int lock_result = pthread_rwlock_trywrlock(&handle->rwlock);
+        if (lock_result == 0)
+        {
+            /* Codes_SRS_LOCK_01_032: [ RWLock_TryReadLock and RWLock_TryWriteLock shall acquire the lock and return LOCK_OK if they would not have to wait ]*/
+            COUNT_ACQUIRED(handle->write_counters);
+            result = LOCK_OK;
+        }
+        else if (lock_result == EBUSY)
+        {
+            /* Codes_SRS_LOCK_01_033: [ RWLock_TryReadLock and RWLock_TryWriteLock shall return LOCK_BUSY without waiting if they would have to wait ]*/
+            COUNT_CONTENDED(handle->write_counters);
+            result = LOCK_BUSY;
+        }
+        else
+        {
+            /* Codes_SRS_LOCK_01_034: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on error shall return LOCK_ERROR ]*/
+            LogError("pthread_rwlock_trywrlock failed.");
+            result = LOCK_ERROR;
+        }
+    }
+
+    return result;
+}
+
+#ifdef LOCK_COLLECT_CONTENTION
+static void copy_counters(const LOCK_CONTENTION_COUNTERS* source, LOCK_CONTENTION_COUNTERS* destination)
+{
+    destination->acquired = __atomic_load_n(&source->acquired, __ATOMIC_RELAXED);
+    destination->contended = __atomic_load_n(&source->contended, __ATOMIC_RELAXED);
+}
+
+LOCK_RESULT Lock_GetContentionCounters(LOCK_HANDLE handle, LOCK_CONTENTION_COUNTERS* counters)
+{
+    LOCK_RESULT result;
+    if ((handle == NULL) || (counters == NULL))
+    {
+        /* Codes_SRS_LOCK_01_035: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall return LOCK_ERROR if any argument is NULL ]*/
+        LogError("Invalid arguments: handle=%p, counters=%p", handle, counters);
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_036: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall fill in how many times the lock was acquired and how many attempts found it held, and return LOCK_OK ]*/
+        copy_counters(&((LOCK_INSTANCE*)handle)->counters, counters);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_GetContentionCounters(ADAPTIVE_LOCK_HANDLE handle, LOCK_CONTENTION_COUNTERS* counters)
+{
+    LOCK_RESULT result;
+    if ((handle == NULL) || (counters == NULL))
+    {
+        /* Codes_SRS_LOCK_01_035: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall return LOCK_ERROR if any argument is NULL ]*/
+        LogError("Invalid arguments: handle=%p, counters=%p", handle, counters);
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_036: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall fill in how many times the lock was acquired and how many attempts found it held, and return LOCK_OK ]*/
+        copy_counters(&handle->counters, counters);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_GetContentionCounters(RWLOCK_HANDLE handle, LOCK_CONTENTION_COUNTERS* read_counters, LOCK_CONTENTION_COUNTERS* write_counters)
+{
+    LOCK_RESULT result;
+    if ((handle == NULL) || (read_counters == NULL) || (write_counters == NULL))
+    {
+        /* Codes_SRS_LOCK_01_035: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall return LOCK_ERROR if any argument is NULL ]*/
+        LogError("Invalid arguments: handle=%p, read_counters=%p, write_counters=%p", handle, read_counters, write_counters);
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_036: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall fill in how many times the lock was acquired and how many attempts found it held, and return LOCK_OK ]*/
+        copy_counters(&handle->read_counters, read_counters);
+        copy_counters(&handle->write_counters, write_counters);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+#endif
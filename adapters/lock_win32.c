@@ -8,14 +8,67 @@
 
 #include "azure_c_shared_utility/macro_utils.h"
 
+/*spins of a critical section before it waits on its event, the value the heap manager uses*/
+#define ADAPTIVE_LOCK_SPIN_COUNT    4000
+
+#ifdef LOCK_COLLECT_CONTENTION
+#define COUNT_ACQUIRED(counters)    (void)InterlockedIncrement64((volatile LONG64*)&(counters).acquired)
+#define COUNT_CONTENDED(counters)   (void)InterlockedIncrement64((volatile LONG64*)&(counters).contended)
+#else
+#define COUNT_ACQUIRED(counters)
+#define COUNT_CONTENDED(counters)
+#endif
+
+typedef struct LOCK_INSTANCE_TAG
+{
+    HANDLE semaphore;
+#ifdef LOCK_COLLECT_CONTENTION
+    LOCK_CONTENTION_COUNTERS counters;
+#endif
+} LOCK_INSTANCE;
+
+typedef struct ADAPTIVE_LOCK_TAG
+{
+    CRITICAL_SECTION critical_section;
+#ifdef LOCK_COLLECT_CONTENTION
+    LOCK_CONTENTION_COUNTERS counters;
+#endif
+} ADAPTIVE_LOCK;
+
+typedef struct RWLOCK_TAG
+{
+    SRWLOCK srw_lock;
+#ifdef LOCK_COLLECT_CONTENTION
+    LOCK_CONTENTION_COUNTERS read_counters;
+    LOCK_CONTENTION_COUNTERS write_counters;
+#endif
+} RWLOCK;
+
 LOCK_HANDLE Lock_Init(void)
 {
     /* Codes_SRS_LOCK_10_002: [Lock_Init on success shall return a valid lock handle which should be a non NULL value] */
     /* Codes_SRS_LOCK_10_003: [Lock_Init on error shall return NULL ] */
-    HANDLE result = CreateSemaphoreW(NULL, 1, 1, NULL);
+    LOCK_INSTANCE* result = (LOCK_INSTANCE*)malloc(sizeof(LOCK_INSTANCE));
     if (result == NULL)
     {
-        LogError("CreateSemaphore failed.");
+        LogError("malloc failed.");
+    }
+    else
+    {
+        result->semaphore = CreateSemaphoreW(NULL, 1, 1, NULL);
+        if (result->semaphore == NULL)
+        {
+            LogError("CreateSemaphore failed.");
+            free(result);
+            result = NULL;
+        }
+#ifdef LOCK_COLLECT_CONTENTION
+        else
+        {
+            result->counters.acquired = 0;
+            result->counters.contended = 0;
+        }
+#endif
     }
 
     return (LOCK_HANDLE)result;
@@ -33,7 +86,8 @@ LOCK_RESULT Lock_Deinit(LOCK_HANDLE handle)
     else
     {
         /* Codes_SRS_LOCK_10_012: [Lock_Deinit frees the memory pointed by handle] */
-        CloseHandle((HANDLE)handle);
+        CloseHandle(((LOCK_INSTANCE*)handle)->semaphore);
+        free(handle);
         result = LOCK_OK;
     }
 
@@ -51,11 +105,22 @@ LOCK_RESULT Lock(LOCK_HANDLE handle)
     }
     else
     {
-        DWORD rv = WaitForSingleObject((HANDLE)handle, INFINITE);
+        LOCK_INSTANCE* lock = (LOCK_INSTANCE*)handle;
+#ifdef LOCK_COLLECT_CONTENTION
+        DWORD rv = WaitForSingleObject(lock->semaphore, 0);
+        if (rv == WAIT_TIMEOUT)
+        {
+            COUNT_CONTENDED(lock->counters);
+            rv = WaitForSingleObject(lock->semaphore, INFINITE);
+        }
+#else
+        DWORD rv = WaitForSingleObject(lock->semaphore, INFINITE);
+#endif
         switch (rv)
         {
             case WAIT_OBJECT_0:
                 /* Codes_SRS_LOCK_10_005: [Lock on success shall return LOCK_OK] */
+                COUNT_ACQUIRED(lock->counters);
                 result = LOCK_OK;
                 break;
             case WAIT_ABANDONED:
@@ -95,7 +160,7 @@ LOCK_RESULT Unlock(LOCK_HANDLE handle)
     }
     else
     {
-        if (ReleaseSemaphore((HANDLE)handle, 1, NULL))
+        if (ReleaseSemaphore(((LOCK_INSTANCE*)handle)->semaphore, 1, NULL))
         {
             /* Codes_SRS_LOCK_10_009: [Unlock on success shall return LOCK_OK] */
             result = LOCK_OK;
@@ -110,3 +175,494 @@ LOCK_RESULT Unlock(LOCK_HANDLE handle)
 
     return result;
 }
+
+LOCK_RESULT Lock_Try(LOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_001: [ Lock_Try on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        LOCK_INSTANCE* lock = (LOCK_INSTANCE*)handle;
+        DWORD rv = WaitForSingleObject(lock->semaphore, 0);
+        if (rv == WAIT_OBJECT_0)
+        {
+            /* Codes_SRS_LOCK_01_002: [ Lock_Try shall acquire the lock and return LOCK_OK if no thread holds it ]*/
+            COUNT_ACQUIRED(lock->counters);
+            result = LOCK_OK;
+        }
+        else if (rv == WAIT_TIMEOUT)
+        {
+            /* Codes_SRS_LOCK_01_003: [ Lock_Try shall return LOCK_BUSY without waiting if the lock is held ]*/
+            COUNT_CONTENDED(lock->counters);
+            result = LOCK_BUSY;
+        }
+        else
+        {
+            /* Codes_SRS_LOCK_01_004: [ Lock_Try on error shall return LOCK_ERROR ]*/
+            LogError("WaitForSingleObject failed: %d", GetLastError());
+            result = LOCK_ERROR;
+        }
+    }
+
+    return result;
+}
+
+LOCK_RESULT Lock_Timed(LOCK_HANDLE handle, unsigned int timeout_milliseconds)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_005: [ Lock_Timed on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        LOCK_INSTANCE* lock = (LOCK_INSTANCE*)handle;
+        DWORD rv = WaitForSingleObject(lock->semaphore, 0);
+        if (rv == WAIT_TIMEOUT)
+        {
+            COUNT_CONTENDED(lock->counters);
+            /*a timeout of UINT_MAX must not become INFINITE*/
+            rv = WaitForSingleObject(lock->semaphore, (timeout_milliseconds == INFINITE) ? (INFINITE - 1) : timeout_milliseconds);
+        }
+
+        if (rv == WAIT_OBJECT_0)
+        {
+            /* Codes_SRS_LOCK_01_006: [ Lock_Timed shall acquire the lock and return LOCK_OK if it is released within timeout_milliseconds ]*/
+            COUNT_ACQUIRED(lock->counters);
+            result = LOCK_OK;
+        }
+        else if (rv == WAIT_TIMEOUT)
+        {
+            /* Codes_SRS_LOCK_01_007: [ Lock_Timed shall return LOCK_TIMEOUT if the lock is still held after timeout_milliseconds ]*/
+            result = LOCK_TIMEOUT;
+        }
+        else
+        {
+            /* Codes_SRS_LOCK_01_008: [ Lock_Timed on error shall return LOCK_ERROR ]*/
+            LogError("WaitForSingleObject failed: %d", GetLastError());
+            result = LOCK_ERROR;
+        }
+    }
+
+    return result;
+}
+
+ADAPTIVE_LOCK_HANDLE AdaptiveLock_Init(void)
+{
+    ADAPTIVE_LOCK* result = (ADAPTIVE_LOCK*)malloc(sizeof(ADAPTIVE_LOCK));
+    if (result == NULL)
+    {
+        /* Codes_SRS_LOCK_01_010: [ AdaptiveLock_Init on error shall return NULL ]*/
+        LogError("malloc failed.");
+    }
+    else if (!InitializeCriticalSectionAndSpinCount(&result->critical_section, ADAPTIVE_LOCK_SPIN_COUNT))
+    {
+        /* Codes_SRS_LOCK_01_010: [ AdaptiveLock_Init on error shall return NULL ]*/
+        LogError("InitializeCriticalSectionAndSpinCount failed: %d", GetLastError());
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_009: [ AdaptiveLock_Init shall create an exclusive lock that is not held and return it ]*/
+#ifdef LOCK_COLLECT_CONTENTION
+        result->counters.acquired = 0;
+        result->counters.contended = 0;
+#endif
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_Deinit(ADAPTIVE_LOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_011: [ AdaptiveLock_Deinit on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_012: [ AdaptiveLock_Deinit shall free the lock and return LOCK_OK ]*/
+        DeleteCriticalSection(&handle->critical_section);
+        free(handle);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_Lock(ADAPTIVE_LOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_013: [ AdaptiveLock_Lock on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_014: [ If the lock is held, AdaptiveLock_Lock shall spin for a bounded time and then wait until the lock is released ]*/
+#ifdef LOCK_COLLECT_CONTENTION
+        if (!TryEnterCriticalSection(&handle->critical_section))
+        {
+            COUNT_CONTENDED(handle->counters);
+            EnterCriticalSection(&handle->critical_section);
+        }
+#else
+        EnterCriticalSection(&handle->critical_section);
+#endif
+        /* Codes_SRS_LOCK_01_015: [ AdaptiveLock_Lock shall return LOCK_OK once it holds the lock ]*/
+        COUNT_ACQUIRED(handle->counters);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_Unlock(ADAPTIVE_LOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_016: [ AdaptiveLock_Unlock on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_017: [ AdaptiveLock_Unlock shall release the lock, wake one thread waiting for it, and return LOCK_OK ]*/
+        LeaveCriticalSection(&handle->critical_section);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_Try(ADAPTIVE_LOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_019: [ AdaptiveLock_Try on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else if (TryEnterCriticalSection(&handle->critical_section))
+    {
+        /* Codes_SRS_LOCK_01_020: [ AdaptiveLock_Try shall acquire the lock and return LOCK_OK if no thread holds it ]*/
+        COUNT_ACQUIRED(handle->counters);
+        result = LOCK_OK;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_021: [ AdaptiveLock_Try shall return LOCK_BUSY without spinning or waiting if the lock is held ]*/
+        COUNT_CONTENDED(handle->counters);
+        result = LOCK_BUSY;
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_Timed(ADAPTIVE_LOCK_HANDLE handle, unsigned int timeout_milliseconds)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_022: [ AdaptiveLock_Timed on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else if (TryEnterCriticalSection(&handle->critical_section))
+    {
+        COUNT_ACQUIRED(handle->counters);
+        result = LOCK_OK;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_023: [ AdaptiveLock_Timed shall spin like AdaptiveLock_Lock and then wait at most until timeout_milliseconds have passed, returning LOCK_OK if it acquired the lock and LOCK_TIMEOUT otherwise ]*/
+        /*critical sections cannot be waited for with a timeout: poll them*/
+        ULONGLONG deadline = GetTickCount64() + timeout_milliseconds;
+        BOOL acquired;
+
+        COUNT_CONTENDED(handle->counters);
+        while (!(acquired = TryEnterCriticalSection(&handle->critical_section)) && (GetTickCount64() < deadline))
+        {
+            Sleep(1);
+        }
+
+        if (acquired)
+        {
+            COUNT_ACQUIRED(handle->counters);
+            result = LOCK_OK;
+        }
+        else
+        {
+            result = LOCK_TIMEOUT;
+        }
+    }
+
+    return result;
+}
+
+RWLOCK_HANDLE RWLock_Init(void)
+{
+    RWLOCK* result = (RWLOCK*)malloc(sizeof(RWLOCK));
+    if (result == NULL)
+    {
+        /* Codes_SRS_LOCK_01_025: [ RWLock_Init on error shall return NULL ]*/
+        LogError("malloc failed.");
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_024: [ RWLock_Init shall create a reader-writer lock that is not held and return it ]*/
+        InitializeSRWLock(&result->srw_lock);
+#ifdef LOCK_COLLECT_CONTENTION
+        result->read_counters.acquired = 0;
+        result->read_counters.contended = 0;
+        result->write_counters.acquired = 0;
+        result->write_counters.contended = 0;
+#endif
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_Deinit(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_026: [ RWLock_Deinit on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_027: [ RWLock_Deinit shall free the lock and return LOCK_OK ]*/
+        free(handle);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_ReadLock(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_029: [ RWLock_ReadLock shall wait while a writer holds the lock, then acquire it for reading alongside other readers and return LOCK_OK ]*/
+#ifdef LOCK_COLLECT_CONTENTION
+        if (!TryAcquireSRWLockShared(&handle->srw_lock))
+        {
+            COUNT_CONTENDED(handle->read_counters);
+            AcquireSRWLockShared(&handle->srw_lock);
+        }
+#else
+        AcquireSRWLockShared(&handle->srw_lock);
+#endif
+        COUNT_ACQUIRED(handle->read_counters);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_ReadUnlock(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_030: [ RWLock_ReadUnlock and RWLock_WriteUnlock shall release the lock and return LOCK_OK ]*/
+        ReleaseSRWLockShared(&handle->srw_lock);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_WriteLock(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_031: [ RWLock_WriteLock shall wait while anyone holds the lock, then acquire it alone and return LOCK_OK ]*/
+#ifdef LOCK_COLLECT_CONTENTION
+        if (!TryAcquireSRWLockExclusive(&handle->srw_lock))
+        {
+            COUNT_CONTENDED(handle->write_counters);
+            AcquireSRWLockExclusive(&handle->srw_lock);
+        }
+#else
+        AcquireSRWLockExclusive(&handle->srw_lock);
+#endif
+        COUNT_ACQUIRED(handle->write_counters);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_WriteUnlock(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_030: [ RWLock_ReadUnlock and RWLock_WriteUnlock shall release the lock and return LOCK_OK ]*/
+        ReleaseSRWLockExclusive(&handle->srw_lock);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_TryReadLock(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else if (TryAcquireSRWLockShared(&handle->srw_lock))
+    {
+        /* Codes_SRS_LOCK_01_032: [ RWLock_TryReadLock and RWLock_TryWriteLock shall acquire the lock and return LOCK_OK if they would not have to wait ]*/
+        COUNT_ACQUIRED(handle->read_counters);
+        result = LOCK_OK;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_033: [ RWLock_TryReadLock and RWLock_TryWriteLock shall return LOCK_BUSY without waiting if they would have to wait ]*/
+        COUNT_CONTENDED(handle->read_counters);
+        result = LOCK_BUSY;
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_TryWriteLock(RWLOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else if (TryAcquireSRWLockExclusive(&handle->srw_lock))
+    {
+        /* Codes_SRS_LOCK_01_032: [ RWLock_TryReadLock and RWLock_TryWriteLock shall acquire the lock and return LOCK_OK if they would not have to wait ]*/
+        COUNT_ACQUIRED(handle->write_counters);
+        result = LOCK_OK;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_033: [ RWLock_TryReadLock and RWLock_TryWriteLock shall return LOCK_BUSY without waiting if they would have to wait ]*/
+        COUNT_CONTENDED(handle->write_counters);
+        result = LOCK_BUSY;
+    }
+
+    return result;
+}
+
+#ifdef LOCK_COLLECT_CONTENTION
+static void copy_counters(LOCK_CONTENTION_COUNTERS* source, LOCK_CONTENTION_COUNTERS* destination)
+{
+    destination->acquired = (uint64_t)InterlockedCompareExchange64((volatile LONG64*)&source->acquired, 0, 0);
+    destination->contended = (uint64_t)InterlockedCompareExchange64((volatile LONG64*)&source->contended, 0, 0);
+}
+
+LOCK_RESULT Lock_GetContentionCounters(LOCK_HANDLE handle, LOCK_CONTENTION_COUNTERS* counters)
+{
+    LOCK_RESULT result;
+    if ((handle == NULL) || (counters == NULL))
+    {
+        /* Codes_SRS_LOCK_01_035: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall return LOCK_ERROR if any argument is NULL ]*/
+        LogError("Invalid arguments: handle=%p, counters=%p", handle, counters);
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_036: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall fill in how many times the lock was acquired and how many attempts found it held, and return LOCK_OK ]*/
+        copy_counters(&((LOCK_INSTANCE*)handle)->counters, counters);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT AdaptiveLock_GetContentionCounters(ADAPTIVE_LOCK_HANDLE handle, LOCK_CONTENTION_COUNTERS* counters)
+{
+    LOCK_RESULT result;
+    if ((handle == NULL) || (counters == NULL))
+    {
+        /* Codes_SRS_LOCK_01_035: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall return LOCK_ERROR if any argument is NULL ]*/
+        LogError("Invalid arguments: handle=%p, counters=%p", handle, counters);
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_036: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall fill in how many times the lock was acquired and how many attempts found it held, and return LOCK_OK ]*/
+        copy_counters(&handle->counters, counters);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+
+LOCK_RESULT RWLock_GetContentionCounters(RWLOCK_HANDLE handle, LOCK_CONTENTION_COUNTERS* read_counters, LOCK_CONTENTION_COUNTERS* write_counters)
+{
+    LOCK_RESULT result;
+    if ((handle == NULL) || (read_counters == NULL) || (write_counters == NULL))
+    {
+        /* Codes_SRS_LOCK_01_035: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall return LOCK_ERROR if any argument is NULL ]*/
+        LogError("Invalid arguments: handle=%p, read_counters=%p, write_counters=%p", handle, read_counters, write_counters);
+        result = LOCK_ERROR;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_036: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall fill in how many times the lock was acquired and how many attempts found it held, and return LOCK_OK ]*/
+        copy_counters(&handle->read_counters, read_counters);
+        copy_counters(&handle->write_counters, write_counters);
+        result = LOCK_OK;
+    }
+
+    return result;
+}
+#endif
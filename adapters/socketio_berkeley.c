@@ -95,6 +95,8 @@ typedef struct SOCKET_IO_INSTANCE_TAG
     char* target_mac_address;
     IO_STATE io_state;
     SINGLYLINKEDLIST_HANDLE pending_io_list;
+    XIO_EVENT_BINDING event_binding;
+    unsigned int event_interest;
     unsigned char recv_bytes[RECEIVE_BYTES_VALUE];
 } SOCKET_IO_INSTANCE;
 
@@ -201,8 +203,45 @@ static const IO_INTERFACE_DESCRIPTION socket_io_interface_description =
     socketio_setoption
 };
 
+/*tells the event binding, if any, which events the socket needs to make progress*/
+static void set_event_interest(SOCKET_IO_INSTANCE* socket_io_instance, unsigned int events)
+{
+    if ((socket_io_instance->event_binding.set_interest != NULL) &&
+        (socket_io_instance->socket != INVALID_SOCKET) &&
+        (socket_io_instance->event_interest != events))
+    {
+        if (socket_io_instance->event_binding.set_interest(socket_io_instance->event_binding.context, socket_io_instance->socket, events) != 0)
+        {
+            LogError("Failure: event binding could not watch the socket.");
+        }
+        else
+        {
+            socket_io_instance->event_interest = events;
+        }
+    }
+}
+
+/*readable is kept as is, writable is needed only while sends are pending*/
+static void update_writable_interest(SOCKET_IO_INSTANCE* socket_io_instance)
+{
+    if (socket_io_instance->event_binding.set_interest != NULL)
+    {
+        unsigned int events = socket_io_instance->event_interest & XIO_EVENT_READABLE;
+
+        if (singlylinkedlist_get_head_item(socket_io_instance->pending_io_list) != NULL)
+        {
+            events |= XIO_EVENT_WRITABLE;
+        }
+
+        set_event_interest(socket_io_instance, events);
+    }
+}
+
 static void indicate_error(SOCKET_IO_INSTANCE* socket_io_instance)
 {
+    /*a failed socket stays readable, watching it would only call dowork in a loop*/
+    set_event_interest(socket_io_instance, 0);
+
     if (socket_io_instance->on_io_error != NULL)
     {
         socket_io_instance->on_io_error(socket_io_instance->on_io_error_context);
@@ -669,6 +708,9 @@ CONCRETE_IO_HANDLE socketio_create(void* io_create_parameters)
                     result->on_io_error = NULL;
                     result->on_bytes_received_context = NULL;
                     result->on_io_error_context = NULL;
+                    result->event_binding.set_interest = NULL;
+                    result->event_binding.context = NULL;
+                    result->event_interest = 0;
                     result->io_state = IO_STATE_CLOSED;
                 }
             }
@@ -690,6 +732,7 @@ void socketio_destroy(CONCRETE_IO_HANDLE socket_io)
         /* we cannot do much if the close fails, so just ignore the result */
         if (socket_io_instance->socket != INVALID_SOCKET)
         {
+            set_event_interest(socket_io_instance, 0);
             close(socket_io_instance->socket);
         }
 
@@ -741,6 +784,7 @@ int socketio_open(CONCRETE_IO_HANDLE socket_io, ON_IO_OPEN_COMPLETE on_io_open_c
             socket_io_instance->on_io_error_context = on_io_error_context;
 
             socket_io_instance->io_state = IO_STATE_OPEN;
+            set_event_interest(socket_io_instance, XIO_EVENT_READABLE);
 
             result = 0;
         }
@@ -778,6 +822,7 @@ int socketio_open(CONCRETE_IO_HANDLE socket_io, ON_IO_OPEN_COMPLETE on_io_open_c
                 socket_io_instance->on_io_error_context = on_io_error_context;
 
                 socket_io_instance->io_state = IO_STATE_OPEN;
+                set_event_interest(socket_io_instance, XIO_EVENT_READABLE);
             }
             else
             {
@@ -812,6 +857,7 @@ int socketio_close(CONCRETE_IO_HANDLE socket_io, ON_IO_CLOSE_COMPLETE on_io_clos
         if ((socket_io_instance->io_state != IO_STATE_CLOSED) && (socket_io_instance->io_state != IO_STATE_CLOSING))
         {
             // Only close if the socket isn't already in the closed or closing state
+            set_event_interest(socket_io_instance, 0);
             (void)shutdown(socket_io_instance->socket, SHUT_RDWR);
             close(socket_io_instance->socket);
             socket_io_instance->socket = INVALID_SOCKET;
@@ -908,6 +954,8 @@ int socketio_send(CONCRETE_IO_HANDLE socket_io, const void* buffer, size_t size,
                     result = 0;
                 }
             }
+
+            update_writable_interest(socket_io_instance);
         }
     }
 
@@ -982,6 +1030,11 @@ void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
             first_pending_io = singlylinkedlist_get_head_item(socket_io_instance->pending_io_list);
         }
 
+        if (socket_io_instance->io_state == IO_STATE_OPEN)
+        {
+            update_writable_interest(socket_io_instance);
+        }
+
         if (socket_io_instance->io_state == IO_STATE_OPEN)
         {
             ssize_t received = 0;
@@ -1129,6 +1182,19 @@ int socketio_setoption(CONCRETE_IO_HANDLE socket_io, const char* optionName, con
         {
             result = socketio_setaddresstype_option(socket_io_instance, (const char*)value);
         }
+        else if (strcmp(optionName, OPTION_XIO_EVENT_BINDING) == 0)
+        {
+            /* the socket leaves the previous binding and, if open, is watched by the new one */
+            set_event_interest(socket_io_instance, 0);
+            socket_io_instance->event_binding = *(const XIO_EVENT_BINDING*)value;
+            socket_io_instance->event_interest = 0;
+            if (socket_io_instance->io_state == IO_STATE_OPEN)
+            {
+                set_event_interest(socket_io_instance, XIO_EVENT_READABLE);
+                update_writable_interest(socket_io_instance);
+            }
+            result = 0;
+        }
         else
         {
             result = __FAILURE__;
@@ -12,7 +12,7 @@
 
 typedef struct TICK_COUNTER_INSTANCE_TAG
 {
-    time_t init_time_value;
+    struct timespec init_time_value;
     tickcounter_ms_t current_ms;
 } TICK_COUNTER_INSTANCE;
 
@@ -23,8 +23,7 @@ TICK_COUNTER_HANDLE tickcounter_create(void)
     {
         set_time_basis();
 
-        result->init_time_value = get_time_s();
-        if (result->init_time_value == INVALID_TIME_VALUE)
+        if (get_time_ns(&result->init_time_value) != 0)
         {
             LogError("tickcounter failed: time return INVALID_TIME.");
             free(result);
@@ -57,15 +56,20 @@ int tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, tickcounter_ms_
     }
     else
     {
-        time_t time_value = get_time_s();
-        if (time_value == INVALID_TIME_VALUE)
+        struct timespec time_value;
+        if (get_time_ns(&time_value) != 0)
         {
+            LogError("tickcounter failed: unable to get the current time.");
             result = __FAILURE__;
         }
         else
         {
+            /* the clock is read with nanosecond precision so that timers shorter than a second work */
             TICK_COUNTER_INSTANCE* tick_counter_instance = (TICK_COUNTER_INSTANCE*)tick_counter;
-            tick_counter_instance->current_ms = (tickcounter_ms_t)(difftime(time_value, tick_counter_instance->init_time_value) * 1000);
+            int64_t elapsed_ns =
+                (int64_t)(time_value.tv_sec - tick_counter_instance->init_time_value.tv_sec) * NANOSECONDS_IN_1_SECOND +
+                (int64_t)(time_value.tv_nsec - tick_counter_instance->init_time_value.tv_nsec);
+            tick_counter_instance->current_ms = (tickcounter_ms_t)(elapsed_ns / NANOSECONDS_IN_1_MILLISECOND);
             *current_ms = tick_counter_instance->current_ms;
             result = 0;
         }
@@ -585,6 +585,7 @@ function(set_platform_files c_shared_dir)
     if(WIN32)
         if(${use_condition})
             set(CONDITION_C_FILE ${c_shared_dir}/adapters/condition_win32.c PARENT_SCOPE)
+            set(EVENTCOUNT_C_FILE ${c_shared_dir}/adapters/eventcount_win32.c PARENT_SCOPE)
         endif()
         if(NOT ${use_etw})
             set(XLOGGING_C_FILE ${c_shared_dir}/src/xlogging.c PARENT_SCOPE)
@@ -624,6 +625,7 @@ function(set_platform_files c_shared_dir)
         
         if(${use_condition})
             set(CONDITION_C_FILE ${c_shared_dir}/adapters/condition_pthreads.c PARENT_SCOPE)
+            set(EVENTCOUNT_C_FILE ${c_shared_dir}/adapters/eventcount_pthreads.c PARENT_SCOPE)
         endif()
 
         if (${use_builtin_httpapi})
@@ -642,6 +644,9 @@ function(set_platform_files c_shared_dir)
         endif()
         set(THREAD_C_FILE ${c_shared_dir}/adapters/threadapi_pthreads.c PARENT_SCOPE)
         set(TICKCOUTER_C_FILE ${c_shared_dir}/adapters/tickcounter_linux.c PARENT_SCOPE)
+        if(LINUX)
+            set(EVENT_LOOP_C_FILE ${c_shared_dir}/adapters/event_loop_epoll.c PARENT_SCOPE)
+        endif()
         if (${use_default_uuid})
             set(UNIQUEID_C_FILE ${c_shared_dir}/adapters/uniqueid_stub.c PARENT_SCOPE)
         else()
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file async_logger.h
+*    @brief xlogging backend that captures log records on the logging thread and formats and
+*           writes them on a background thread.
+*
+*    ::async_logger_start installs ::async_logger_log with ::xlogging_set_log_function. A call
+*    to ::async_logger_log claims a slot of a bounded lock-free ring, copies the format pointer
+*    and the raw arguments into the slot and wakes the writer thread, which formats the message;
+*    it never locks, never allocates and never waits for the output. The format must outlive
+*    the record, as the string literals passed to the xlogging macros do. When the ring is full the record is dropped and counted, and the writer
+*    reports the drops in the output. ::async_logger_stop writes what is left and puts the
+*    previous log function back.
+*/
+
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include "azure_c_shared_utility/xlogging.h"
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdio>
+extern "C" {
+#else
+#include <stddef.h>
+#include <stdio.h>
+#endif
+
+/*size of the message the writer thread formats, including the terminating '\0'; longer messages are cut*/
+#ifndef ASYNC_LOGGER_MESSAGE_SIZE
+#define ASYNC_LOGGER_MESSAGE_SIZE 256
+#endif
+
+/*bytes of arguments kept per record, 9 per number and 3 plus the characters per string; the arguments that do not fit are dropped*/
+#ifndef ASYNC_LOGGER_ARGUMENTS_SIZE
+#define ASYNC_LOGGER_ARGUMENTS_SIZE 256
+#endif
+
+typedef struct ASYNC_LOGGER_STATISTICS_TAG
+{
+    /*records written to the output*/
+    size_t written;
+    /*records dropped because the ring was full*/
+    size_t dropped;
+    /*records whose arguments did not fit in ASYNC_LOGGER_ARGUMENTS_SIZE or whose message did not fit in ASYNC_LOGGER_MESSAGE_SIZE*/
+    size_t truncated;
+} ASYNC_LOGGER_STATISTICS;
+
+/**
+ * @brief   Starts the writer thread and installs ::async_logger_log as the xlogging log function.
+ *
+ *          Must not be called concurrently with ::async_logger_stop or while the logger is
+ *          already started.
+ *
+ * @param   output      Where the records are written, in the format of consolelogger_log.
+ * @param   capacity    How many records the ring holds, rounded up to a power of 2.
+ *
+ * @return  0 on success, any other value on failure.
+ */
+MOCKABLE_FUNCTION(, int, async_logger_start, FILE*, output, size_t, capacity);
+
+/**
+ * @brief   Puts the previous log function back, writes the records left in the ring, stops
+ *          the writer thread, reports the records dropped since the last report and flushes
+ *          the output.
+ *
+ *          Calls to ::async_logger_log that are in progress are waited for and their records
+ *          written; calls made once it has started, through a saved copy of the log function,
+ *          are ignored.
+ */
+MOCKABLE_FUNCTION(, void, async_logger_stop);
+
+/**
+ * @brief   Gets how many records were written, dropped and truncated since the last
+ *          ::async_logger_start. The counts are kept after ::async_logger_stop.
+ *
+ * @return  0 on success, any other value if @p statistics is @c NULL.
+ */
+MOCKABLE_FUNCTION(, int, async_logger_get_statistics, ASYNC_LOGGER_STATISTICS*, statistics);
+
+/**
+ * @brief   The xlogging log function installed by ::async_logger_start. Safe to call from any
+ *          number of threads at once.
+ */
+extern void async_logger_log(LOG_CATEGORY log_category, const char* file, const char* func, int line, unsigned int options, const char* format, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ASYNC_LOGGER_H */
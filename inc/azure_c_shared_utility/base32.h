@@ -16,6 +16,21 @@ extern "C" {
 
 #include "azure_c_shared_utility/umock_c_prod.h"
 
+/** @brief  State of an incremental base32 encoder, owned by the caller. */
+typedef struct BASE32_ENCODE_STREAM_TAG
+{
+    unsigned char pending[4];
+    unsigned char pendingCount;
+} BASE32_ENCODE_STREAM;
+
+/** @brief  State of an incremental base32 decoder, owned by the caller. */
+typedef struct BASE32_DECODE_STREAM_TAG
+{
+    unsigned char pending[7];
+    unsigned char pendingCount;
+    unsigned char finished;
+} BASE32_DECODE_STREAM;
+
 /**
 * @brief Encodes the BUFFER_HANDLE to a base 32 STRING_HANDLE
 *
@@ -53,6 +68,69 @@ MOCKABLE_FUNCTION(, BUFFER_HANDLE, Base32_Decode, STRING_HANDLE, handle);
 */
 MOCKABLE_FUNCTION(, BUFFER_HANDLE, Base32_Decode_String, const char*, source);
 
+/**
+* @brief    Prepares @p stream for encoding a new sequence of bytes.
+*/
+MOCKABLE_FUNCTION(, void, Base32_Encode_Stream_Init, BASE32_ENCODE_STREAM*, stream);
+
+/**
+* @brief    Encodes the next @p size bytes of a sequence, keeping up to 4 bytes in @p stream
+*           until the next call. No memory is allocated.
+*
+* @param    stream              The encoder state
+* @param    source              The next bytes, may be NULL when @p size is 0
+* @param    size                The length in bytes of @p source
+* @param    destination         Receives 8 characters for every complete block of 5 bytes, no \0 is written
+* @param    destinationSize     The size of @p destination, ((@p size + 4) / 5) * 8 is always enough
+* @param    written             Receives the number of characters written in @p destination
+*
+* @return   0 on success, a non-zero value if the arguments are invalid or @p destination is too small
+*/
+MOCKABLE_FUNCTION(, int, Base32_Encode_Stream_Update, BASE32_ENCODE_STREAM*, stream, const unsigned char*, source, size_t, size, char*, destination, size_t, destinationSize, size_t*, written);
+
+/**
+* @brief    Encodes the bytes left in @p stream padded with =, and resets @p stream.
+*
+* @param    stream              The encoder state
+* @param    destination         Receives at most 8 characters, no \0 is written
+* @param    destinationSize     The size of @p destination
+* @param    written             Receives the number of characters written in @p destination
+*
+* @return   0 on success, a non-zero value if the arguments are invalid or @p destination is too small
+*/
+MOCKABLE_FUNCTION(, int, Base32_Encode_Stream_Final, BASE32_ENCODE_STREAM*, stream, char*, destination, size_t, destinationSize, size_t*, written);
+
+/**
+* @brief    Prepares @p stream for decoding a new base32 string.
+*/
+MOCKABLE_FUNCTION(, void, Base32_Decode_Stream_Init, BASE32_DECODE_STREAM*, stream);
+
+/**
+* @brief    Decodes the next @p sourceLength characters of a base32 string, keeping up to 7
+*           characters in @p stream until the next call. Characters outside of the base32
+*           alphabet, invalid padding and characters after the padding are rejected. No memory
+*           is allocated.
+*
+* @param    stream              The decoder state
+* @param    source              The next characters, may be NULL when @p sourceLength is 0
+* @param    sourceLength        The number of characters in @p source
+* @param    destination         Receives the bytes of every complete block of 8 characters
+* @param    destinationSize     The size of @p destination, ((@p sourceLength + 7) / 8) * 5 is always enough
+* @param    written             Receives the number of bytes written in @p destination
+*
+* @return   0 on success, a non-zero value otherwise
+*/
+MOCKABLE_FUNCTION(, int, Base32_Decode_Stream_Update, BASE32_DECODE_STREAM*, stream, const char*, source, size_t, sourceLength, unsigned char*, destination, size_t, destinationSize, size_t*, written);
+
+/**
+* @brief    Checks that the string fed to @p stream ended on a complete block and resets @p stream.
+*
+* @param    stream              The decoder state
+*
+* @return   0 if the string was complete, a non-zero value otherwise
+*/
+MOCKABLE_FUNCTION(, int, Base32_Decode_Stream_Final, BASE32_DECODE_STREAM*, stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,20 @@ extern "C" {
 
 #include "azure_c_shared_utility/umock_c_prod.h"
 
+/** @brief  State of an incremental base64 encoder, owned by the caller. */
+typedef struct BASE64_ENCODE_STREAM_TAG
+{
+    unsigned char pending[2];
+    unsigned char pendingCount;
+} BASE64_ENCODE_STREAM;
+
+/** @brief  State of an incremental base64 decoder, owned by the caller. */
+typedef struct BASE64_DECODE_STREAM_TAG
+{
+    unsigned char pending[3];
+    unsigned char pendingCount;
+    unsigned char finished;
+} BASE64_DECODE_STREAM;
 
 /**
  * @brief    Base64 encodes a buffer and returns the resulting string.
@@ -76,6 +90,131 @@ MOCKABLE_FUNCTION(, STRING_HANDLE, Base64_Encode_Bytes, const unsigned char*, so
  */
 MOCKABLE_FUNCTION(, BUFFER_HANDLE, Base64_Decoder, const char*, source);
 
+/**
+ * @brief    Computes the length of the base64 encoding of @p size bytes.
+ *
+ * @param    size    The number of bytes to be encoded.
+ *
+ * @return    The number of characters produced by ::Base64_Encode_Into, not counting the
+ *             terminating @c \0, or 0 if the length does not fit in a @c size_t.
+ */
+MOCKABLE_FUNCTION(, size_t, Base64_Encode_Length, size_t, size);
+
+/**
+ * @brief    Base64 encodes @p size bytes from @p source into a caller supplied buffer.
+ *
+ * @param    source             The bytes to encode. May be @c NULL when @p size is zero.
+ * @param    size               The number of bytes to encode.
+ * @param    destination        Receives the padded encoding followed by a @c \0.
+ * @param    destinationSize    The size of @p destination, at least
+ *                              ::Base64_Encode_Length(@p size) + 1.
+ *
+ *             No memory is allocated.
+ *
+ * @return    0 on success, any other value if the arguments are invalid or @p destination
+ *             is too small.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Encode_Into, const unsigned char*, source, size_t, size, char*, destination, size_t, destinationSize);
+
+/**
+ * @brief    Computes the number of bytes encoded by a base64 string.
+ *
+ * @param    source          The base64 encoded characters.
+ * @param    sourceLength    The number of characters in @p source.
+ *
+ *             The content of @p source is not validated, only the padding is inspected.
+ *
+ * @return    The decoded size, or 0 if @p source is @c NULL or @p sourceLength is not a
+ *             multiple of 4.
+ */
+MOCKABLE_FUNCTION(, size_t, Base64_Decode_Length, const char*, source, size_t, sourceLength);
+
+/**
+ * @brief    Base64 decodes @p sourceLength characters from @p source into a caller supplied buffer.
+ *
+ * @param    source             The base64 encoded characters; they need not be @c \0 terminated.
+ * @param    sourceLength       The number of characters in @p source, a multiple of 4.
+ * @param    destination        Receives the decoded bytes.
+ * @param    destinationSize    The size of @p destination, at least
+ *                              ::Base64_Decode_Length(@p source, @p sourceLength).
+ * @param    decodedSize        Receives the number of bytes written in @p destination.
+ *
+ *             No memory is allocated. Characters outside of the base64 alphabet and
+ *             misplaced padding are rejected.
+ *
+ * @return    0 on success, any other value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Decode_Into, const char*, source, size_t, sourceLength, unsigned char*, destination, size_t, destinationSize, size_t*, decodedSize);
+
+/**
+ * @brief    Prepares @p stream for encoding a new sequence of bytes.
+ */
+MOCKABLE_FUNCTION(, void, Base64_Encode_Stream_Init, BASE64_ENCODE_STREAM*, stream);
+
+/**
+ * @brief    Encodes the next @p size bytes of a sequence.
+ *
+ * @param    stream             The encoder state.
+ * @param    source             The next bytes. May be @c NULL when @p size is zero.
+ * @param    size               The number of bytes in @p source.
+ * @param    destination        Receives the characters for every complete group of 3 bytes;
+ *                              no @c \0 is written.
+ * @param    destinationSize    The size of @p destination; ::Base64_Encode_Length(@p size) is
+ *                              always enough.
+ * @param    written            Receives the number of characters written in @p destination.
+ *
+ *             Up to 2 bytes are kept in @p stream until the next call, so the whole input never
+ *             needs to be in memory. No memory is allocated.
+ *
+ * @return    0 on success, any other value if the arguments are invalid or @p destination
+ *             is too small.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Encode_Stream_Update, BASE64_ENCODE_STREAM*, stream, const unsigned char*, source, size_t, size, char*, destination, size_t, destinationSize, size_t*, written);
+
+/**
+ * @brief    Encodes the bytes left in @p stream, padded with @c =, and resets it.
+ *
+ * @param    destination        Receives at most 4 characters; no @c \0 is written.
+ * @param    destinationSize    The size of @p destination.
+ * @param    written            Receives the number of characters written in @p destination.
+ *
+ * @return    0 on success, any other value if the arguments are invalid or @p destination
+ *             is too small.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Encode_Stream_Final, BASE64_ENCODE_STREAM*, stream, char*, destination, size_t, destinationSize, size_t*, written);
+
+/**
+ * @brief    Prepares @p stream for decoding a new base64 string.
+ */
+MOCKABLE_FUNCTION(, void, Base64_Decode_Stream_Init, BASE64_DECODE_STREAM*, stream);
+
+/**
+ * @brief    Decodes the next @p sourceLength characters of a base64 string.
+ *
+ * @param    stream             The decoder state.
+ * @param    source             The next characters, of any length. May be @c NULL when
+ *                              @p sourceLength is zero.
+ * @param    sourceLength       The number of characters in @p source.
+ * @param    destination        Receives the bytes of every complete group of 4 characters.
+ * @param    destinationSize    The size of @p destination; ((@p sourceLength + 3) / 4) * 3 is
+ *                              always enough.
+ * @param    written            Receives the number of bytes written in @p destination.
+ *
+ *             Up to 3 characters are kept in @p stream until the next call. Characters outside
+ *             of the base64 alphabet, padding anywhere but at the end of a group and any
+ *             character after the padding are rejected. No memory is allocated.
+ *
+ * @return    0 on success, any other value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Decode_Stream_Update, BASE64_DECODE_STREAM*, stream, const char*, source, size_t, sourceLength, unsigned char*, destination, size_t, destinationSize, size_t*, written);
+
+/**
+ * @brief    Checks that the string fed to @p stream ended on a complete group and resets it.
+ *
+ * @return    0 if the string was complete, any other value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, Base64_Decode_Stream_Final, BASE64_DECODE_STREAM*, stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -43,6 +43,16 @@ MOCKABLE_FUNCTION(, COND_HANDLE, Condition_Init);
 */
 MOCKABLE_FUNCTION(, COND_RESULT, Condition_Post, COND_HANDLE, handle);
 
+/**
+* @brief    unblock every thread waiting on the condition with a single call.
+*
+* @param    handle    A valid handle to the condition.
+*
+* @return    Returns @c COND_OK when the waiting threads have been
+*             unblocked and @c COND_ERROR when an error occurs.
+*/
+MOCKABLE_FUNCTION(, COND_RESULT, Condition_PostAll, COND_HANDLE, handle);
+
 /**
 * @brief    block on the condition handle unti the thread is signalled
 *           or until the timeout_milliseconds is reached.
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file event_loop.h
+*    @brief Single threaded loop that waits for descriptors and timers and drives xio
+*           instances only when their socket is ready.
+*/
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+#include "azure_c_shared_utility/xio.h"
+#include "azure_c_shared_utility/shared_util_options.h"
+
+#ifdef __cplusplus
+#include <cstdint>
+extern "C" {
+#else
+#include <stdint.h>
+#endif
+
+/** @brief  Wait passed to ::event_loop_run_once to wait until a descriptor or a timer is ready. */
+#define EVENT_LOOP_WAIT_INFINITE UINT32_MAX
+
+/** @brief  Events of a descriptor, the same values as the ones of ::XIO_EVENT_BINDING. */
+#define EVENT_LOOP_READABLE XIO_EVENT_READABLE
+#define EVENT_LOOP_WRITABLE XIO_EVENT_WRITABLE
+
+typedef struct EVENT_LOOP_TAG* EVENT_LOOP_HANDLE;
+typedef struct EVENT_LOOP_WATCH_TAG* EVENT_LOOP_WATCH_HANDLE;
+typedef struct EVENT_LOOP_TIMER_TAG* EVENT_LOOP_TIMER_HANDLE;
+typedef struct EVENT_LOOP_XIO_TAG* EVENT_LOOP_XIO_HANDLE;
+
+typedef void(*ON_EVENT_LOOP_FD_READY)(void* context, unsigned int events);
+typedef void(*ON_EVENT_LOOP_TIMER)(void* context);
+
+/**
+ * @brief   Creates an event loop.
+ *
+ *          Every function of the loop but ::event_loop_stop must be called from the
+ *          thread that runs it, callbacks included.
+ *
+ * @return  A handle to the loop or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, EVENT_LOOP_HANDLE, event_loop_create);
+
+/**
+ * @brief   Frees the loop with the watches and timers that were not released.
+ *
+ *          xio instances added with ::event_loop_add_xio must be removed first.
+ */
+MOCKABLE_FUNCTION(, void, event_loop_destroy, EVENT_LOOP_HANDLE, event_loop);
+
+/**
+ * @brief   Waits up to @p max_wait_ms for a descriptor or a timer to be ready and runs
+ *          their callbacks.
+ *
+ * @return  0 on success, any other value if waiting failed.
+ */
+MOCKABLE_FUNCTION(, int, event_loop_run_once, EVENT_LOOP_HANDLE, event_loop, uint32_t, max_wait_ms);
+
+/**
+ * @brief   Runs the loop until ::event_loop_stop is called.
+ *
+ * @return  0 when stopped, any other value if waiting failed.
+ */
+MOCKABLE_FUNCTION(, int, event_loop_run, EVENT_LOOP_HANDLE, event_loop);
+
+/**
+ * @brief   Makes ::event_loop_run return. Can be called from any thread.
+ */
+MOCKABLE_FUNCTION(, void, event_loop_stop, EVENT_LOOP_HANDLE, event_loop);
+
+/**
+ * @brief   Calls @p on_fd_ready whenever @p fd is ready for one of @p events.
+ *
+ *          Readiness is level triggered: the callback runs on every iteration of the
+ *          loop for as long as the descriptor stays ready.
+ *
+ * @return  A handle to the watch, to be released with ::event_loop_unwatch_fd, or
+ *          @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, EVENT_LOOP_WATCH_HANDLE, event_loop_watch_fd, EVENT_LOOP_HANDLE, event_loop, int, fd, unsigned int, events, ON_EVENT_LOOP_FD_READY, on_fd_ready, void*, context);
+
+/**
+ * @brief   Changes the events a watch waits for, 0 pauses the watch.
+ *
+ * @return  0 on success, any other value on failure.
+ */
+MOCKABLE_FUNCTION(, int, event_loop_watch_set_events, EVENT_LOOP_WATCH_HANDLE, watch, unsigned int, events);
+
+/**
+ * @brief   Stops watching the descriptor and frees the watch. Can be called from any
+ *          callback of the loop; the descriptor must still be open.
+ */
+MOCKABLE_FUNCTION(, void, event_loop_unwatch_fd, EVENT_LOOP_WATCH_HANDLE, watch);
+
+/**
+ * @brief   Calls @p on_timer after @p delay_ms and then, if @p period_ms is not 0,
+ *          every @p period_ms after each call.
+ *
+ * @return  A handle to the timer, to be released with ::event_loop_timer_cancel, or
+ *          @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, EVENT_LOOP_TIMER_HANDLE, event_loop_timer_start, EVENT_LOOP_HANDLE, event_loop, uint32_t, delay_ms, uint32_t, period_ms, ON_EVENT_LOOP_TIMER, on_timer, void*, context);
+
+/**
+ * @brief   Stops the timer and frees it. Can be called from the timer's own callback.
+ */
+MOCKABLE_FUNCTION(, void, event_loop_timer_cancel, EVENT_LOOP_TIMER_HANDLE, timer);
+
+/**
+ * @brief   Drives @p xio from the loop instead of from periodic calls to xio_dowork.
+ *
+ *          The loop hands the xio an ::XIO_EVENT_BINDING through the
+ *          ::OPTION_XIO_EVENT_BINDING option, which layered IOs pass down to the IO that
+ *          owns the socket. xio_dowork is then called when the socket is readable, or
+ *          writable while sends are pending, and every @p housekeeping_ms so the layers
+ *          can run their timeouts; 0 turns the housekeeping calls off.
+ *
+ * @return  A handle to remove the xio with ::event_loop_remove_xio, or @c NULL on failure,
+ *          including when no layer of @p xio supports the option.
+ */
+MOCKABLE_FUNCTION(, EVENT_LOOP_XIO_HANDLE, event_loop_add_xio, EVENT_LOOP_HANDLE, event_loop, XIO_HANDLE, xio, uint32_t, housekeeping_ms);
+
+/**
+ * @brief   Detaches the xio from the loop. Must be called before the xio is destroyed;
+ *          can be called from the xio's callbacks.
+ */
+MOCKABLE_FUNCTION(, void, event_loop_remove_xio, EVENT_LOOP_XIO_HANDLE, event_loop_xio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EVENT_LOOP_H */
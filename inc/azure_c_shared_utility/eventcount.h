@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file eventcount.h
+*    @brief Eventcount: lets threads sleep until some lock-free state changes, without a lock
+*           on the notifying side.
+*
+*    A waiter checks its condition, calls ::eventcount_prepare_wait, checks the condition again and
+*    then either calls ::eventcount_cancel_wait (the condition became true) or ::eventcount_wait
+*    with the key it got. A notifier makes the condition true and then calls ::eventcount_notify_one
+*    or ::eventcount_notify_all; a notification that happens after ::eventcount_prepare_wait is never
+*    lost. When nobody is waiting a notification costs a memory fence and a load.
+*
+*    @code
+*    while ((item = mpsc_queue_pop(queue)) == NULL)
+*    {
+*        uint32_t key = eventcount_prepare_wait(eventcount);
+*        if ((item = mpsc_queue_pop(queue)) != NULL)
+*        {
+*            eventcount_cancel_wait(eventcount);
+*            break;
+*        }
+*        (void)eventcount_wait(eventcount, key, 0);
+*    }
+*    @endcode
+*/
+
+#ifndef EVENTCOUNT_H
+#define EVENTCOUNT_H
+
+#include "azure_c_shared_utility/macro_utils.h"
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstdint>
+extern "C" {
+#else
+#include <stdint.h>
+#endif
+
+typedef struct EVENTCOUNT_TAG* EVENTCOUNT_HANDLE;
+
+#define EVENTCOUNT_RESULT_VALUES \
+    EVENTCOUNT_OK, \
+    EVENTCOUNT_INVALID_ARG, \
+    EVENTCOUNT_ERROR, \
+    EVENTCOUNT_TIMEOUT \
+
+DEFINE_ENUM(EVENTCOUNT_RESULT, EVENTCOUNT_RESULT_VALUES);
+
+/**
+ * @brief   Creates an eventcount nobody is waiting on.
+ *
+ * @return  A handle to the eventcount or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, EVENTCOUNT_HANDLE, eventcount_create);
+
+/**
+ * @brief   Frees the eventcount. No thread may be waiting on it.
+ */
+MOCKABLE_FUNCTION(, void, eventcount_destroy, EVENTCOUNT_HANDLE, eventcount);
+
+/**
+ * @brief   Registers the calling thread as a waiter. Must be followed by exactly one call to
+ *          ::eventcount_wait or ::eventcount_cancel_wait.
+ *
+ * @return  The key to pass to ::eventcount_wait. 0 if @p eventcount is @c NULL.
+ */
+MOCKABLE_FUNCTION(, uint32_t, eventcount_prepare_wait, EVENTCOUNT_HANDLE, eventcount);
+
+/**
+ * @brief   Withdraws the registration made by ::eventcount_prepare_wait without waiting.
+ */
+MOCKABLE_FUNCTION(, void, eventcount_cancel_wait, EVENTCOUNT_HANDLE, eventcount);
+
+/**
+ * @brief   Blocks until a notification made after the ::eventcount_prepare_wait that returned
+ *          @p key, or until @p timeout_milliseconds have passed, and withdraws the registration.
+ *
+ *          Returns at once if such a notification already happened. The timeout is measured
+ *          from the call, once, however many times the thread is woken in between. Like
+ *          ::Condition_Wait it may return ::EVENTCOUNT_OK without a matching notification, so
+ *          callers check their condition again.
+ *
+ * @param   timeout_milliseconds    Maximum time to wait, 0 to wait without a timeout.
+ *
+ * @return  ::EVENTCOUNT_OK when notified, ::EVENTCOUNT_TIMEOUT when the timeout passed,
+ *          ::EVENTCOUNT_INVALID_ARG or ::EVENTCOUNT_ERROR on failure.
+ */
+MOCKABLE_FUNCTION(, EVENTCOUNT_RESULT, eventcount_wait, EVENTCOUNT_HANDLE, eventcount, uint32_t, key, int, timeout_milliseconds);
+
+/**
+ * @brief   Wakes one thread blocked in ::eventcount_wait, if any; threads between
+ *          ::eventcount_prepare_wait and ::eventcount_wait do not block.
+ */
+MOCKABLE_FUNCTION(, void, eventcount_notify_one, EVENTCOUNT_HANDLE, eventcount);
+
+/**
+ * @brief   Wakes every thread registered by ::eventcount_prepare_wait with a single call.
+ */
+MOCKABLE_FUNCTION(, void, eventcount_notify_all, EVENTCOUNT_HANDLE, eventcount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EVENTCOUNT_H */
@@ -7,11 +7,18 @@
 #include "azure_c_shared_utility/umock_c_prod.h"
 
 #ifdef __cplusplus
+#include <cstddef>
 extern "C" {
+#else
+#include <stddef.h>
 #endif
 
+/* Returns a pseudo random number between 0 and 2^31 - 1 from a generator private to the calling thread. */
 MOCKABLE_FUNCTION(, int, gb_rand);
 
+/* Fills buffer with length pseudo random bytes from the same generator as gb_rand. */
+MOCKABLE_FUNCTION(, void, gb_rand_bytes, unsigned char*, buffer, size_t, length);
+
 #ifdef __cplusplus
 }
 #endif
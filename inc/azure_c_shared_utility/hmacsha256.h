@@ -19,8 +19,40 @@ extern "C" {
 
 DEFINE_ENUM(HMACSHA256_RESULT, HMACSHA256_RESULT_VALUES)
 
+#define HMACSHA256_HASH_SIZE 32
+
+typedef struct HMACSHA256_KEY_TAG* HMACSHA256_KEY_HANDLE;
+
 MOCKABLE_FUNCTION(, HMACSHA256_RESULT, HMACSHA256_ComputeHash, const unsigned char*, key, size_t, keyLen, const unsigned char*, payload, size_t, payloadLen, BUFFER_HANDLE, hash);
 
+/**
+ * @brief   Prepares @p key for repeated signing: the key is hashed if it is
+ *          longer than a block and the inner and outer padded blocks are
+ *          absorbed once, so every following signature only hashes the
+ *          payload.
+ *
+ *          The returned handle is not modified by ::HMACSHA256_ComputeHashWithKey
+ *          and can be shared between threads until ::HMACSHA256_DestroyKey.
+ *
+ * @return  A handle to the prepared key or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, HMACSHA256_KEY_HANDLE, HMACSHA256_CreateKey, const unsigned char*, key, size_t, keyLen);
+
+/** @brief  Frees a key created by ::HMACSHA256_CreateKey. */
+MOCKABLE_FUNCTION(, void, HMACSHA256_DestroyKey, HMACSHA256_KEY_HANDLE, key);
+
+/**
+ * @brief   Computes the HMAC-SHA256 of @p payload with a key prepared by
+ *          ::HMACSHA256_CreateKey and stores it in @p hash.
+ */
+MOCKABLE_FUNCTION(, HMACSHA256_RESULT, HMACSHA256_ComputeHashWithKey, HMACSHA256_KEY_HANDLE, key, const unsigned char*, payload, size_t, payloadLen, BUFFER_HANDLE, hash);
+
+/**
+ * @brief   Same as ::HMACSHA256_ComputeHashWithKey, but writes the
+ *          ::HMACSHA256_HASH_SIZE bytes of the hash to @p hash.
+ */
+MOCKABLE_FUNCTION(, HMACSHA256_RESULT, HMACSHA256_ComputeHashWithKeyInto, HMACSHA256_KEY_HANDLE, key, const unsigned char*, payload, size_t, payloadLen, unsigned char*, hash);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,6 +5,7 @@
 #define HTTP_PROXY_IO_H
 
 #include "azure_c_shared_utility/xio.h"
+#include "azure_c_shared_utility/tickcounter.h"
 #include "azure_c_shared_utility/umock_c_prod.h"
 
 #ifdef __cplusplus
@@ -21,8 +22,62 @@ typedef struct HTTP_PROXY_IO_CONFIG_TAG
     const char* password;
 } HTTP_PROXY_IO_CONFIG;
 
+/** @brief Option used to attach an ::HTTP_PROXY_IO_POOL_HANDLE to an HTTP proxy IO.
+ *
+ *         The value is the pool handle itself (NULL detaches the pool). When a pool is attached,
+ *         opening the IO hands out a tunnel that was already established by the pool for the
+ *         same target host and proxy, instead of connecting to the proxy and sending CONNECT.
+ *         The pool must outlive every IO it is attached to.
+ */
+#define OPTION_HTTP_PROXY_IO_POOL "http_proxy_io_pool"
+
+typedef struct HTTP_PROXY_IO_POOL_TAG* HTTP_PROXY_IO_POOL_HANDLE;
+
+typedef struct HTTP_PROXY_IO_POOL_CONFIG_TAG
+{
+    const char* proxy_hostname;
+    int proxy_port;
+    const char* username;
+    const char* password;
+    /* Number of established tunnels the pool keeps ready for each target host */
+    size_t tunnels_per_host;
+    /* Idle tunnels older than this are closed and replaced by fresh ones, keep it below the proxy idle timeout (0 disables) */
+    tickcounter_ms_t idle_timeout_ms;
+    /* Delay before re-establishing a tunnel after a failed CONNECT */
+    tickcounter_ms_t retry_interval_ms;
+} HTTP_PROXY_IO_POOL_CONFIG;
+
 MOCKABLE_FUNCTION(, const IO_INTERFACE_DESCRIPTION*, http_proxy_io_get_interface_description);
 
+/**
+ * @brief   Creates a pool of pre-established CONNECT tunnels through one proxy.
+ *
+ *          Tunnels are only opened from ::http_proxy_io_pool_dowork, for the hosts
+ *          registered with ::http_proxy_io_pool_add_host. A tunnel is handed out at most
+ *          once: after the IO that took it is closed, the connection is not returned to
+ *          the pool, since the bytes exchanged over it leave it unusable for another user.
+ *          The pool is not thread safe; it must be driven from the same thread as the IOs using it.
+ *
+ * @return  A handle to the pool or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, HTTP_PROXY_IO_POOL_HANDLE, http_proxy_io_pool_create, const HTTP_PROXY_IO_POOL_CONFIG*, config);
+
+/** @brief  Closes all the tunnels held by the pool and frees it. */
+MOCKABLE_FUNCTION(, void, http_proxy_io_pool_destroy, HTTP_PROXY_IO_POOL_HANDLE, pool);
+
+/**
+ * @brief   Registers a target host for which the pool keeps tunnels ready.
+ *
+ * @return  0 on success (also when the host was already registered), non-zero otherwise.
+ */
+MOCKABLE_FUNCTION(, int, http_proxy_io_pool_add_host, HTTP_PROXY_IO_POOL_HANDLE, pool, const char*, hostname, int, port);
+
+/**
+ * @brief   Opens missing tunnels, drives the ones being established, and recycles
+ *          idle tunnels that failed or exceeded the idle timeout.
+ */
+MOCKABLE_FUNCTION(, void, http_proxy_io_pool_dowork, HTTP_PROXY_IO_POOL_HANDLE, pool);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -73,6 +73,26 @@ DEFINE_ENUM(HTTPAPI_REQUEST_TYPE, HTTPAPI_REQUEST_TYPE_VALUES);
 #define MAX_USERNAME_LEN        65
 #define MAX_PASSWORD_LEN        65
 
+/**
+ * @brief    Callback used by ::HTTPAPI_ExecuteStreamingRequest to pull the
+ *             next piece of the request body.
+ *
+ *            The callback shall copy at most @p bufferSize bytes in @p buffer
+ *            and set @p bytesRead to the number of bytes copied. Setting
+ *            @p bytesRead to 0 signals the end of the request body.
+ *
+ * @return    0 on success, any other value aborts the request.
+ */
+typedef int(*HTTPAPI_REQUEST_BODY_READ_CALLBACK)(void* context, unsigned char* buffer, size_t bufferSize, size_t* bytesRead);
+
+/**
+ * @brief    Callback used by ::HTTPAPI_ExecuteStreamingRequest to hand over
+ *             the next piece of the response body as it is received.
+ *
+ * @return    0 on success, any other value aborts the request.
+ */
+typedef int(*HTTPAPI_RESPONSE_BODY_WRITE_CALLBACK)(void* context, const unsigned char* buffer, size_t size);
+
 /**
  * @brief    Global initialization for the HTTP API component.
  *
@@ -165,6 +185,42 @@ MOCKABLE_FUNCTION(, HTTPAPI_RESULT, HTTPAPI_ExecuteRequest, HTTP_HANDLE, handle,
                                              size_t, contentLength, unsigned int*, statusCode,
                                              HTTP_HEADERS_HANDLE, responseHeadersHandle, BUFFER_HANDLE, responseContent);
 
+/**
+ * @brief    Sends the HTTP request to the host and handles the response for
+ *             the HTTP call without holding either body in memory.
+ *
+ * @param    handle                   The handle to the HTTP connection created
+ *                                   via ::HTTPAPI_CreateConnection.
+ * @param    requestType              Specifies which HTTP method is used.
+ * @param    relativePath             Specifies the relative path of the URL
+ *                                   excluding the host name.
+ * @param    httpHeadersHandle        Specifies a set of HTTP headers to be added
+ *                                   to the HTTP request. The headers shall not
+ *                                   contain Content-Length when a request body
+ *                                   is streamed.
+ * @param    requestBodyCallback      Called repeatedly to obtain the request
+ *                                   body, which is sent using chunked transfer
+ *                                   encoding. This value is optional and can be
+ *                                   @c NULL, in which case no body is sent.
+ * @param    requestBodyContext       Context passed to @p requestBodyCallback.
+ * @param    statusCode               Out parameter receiving the status code
+ *                                   from the HTTP response.
+ * @param    responseHeadersHandle    HTTP headers handle to which the HTTP
+ *                                   response headers are added. Optional.
+ * @param    responseBodyCallback     Called for every piece of the response body
+ *                                   as it arrives. This value is optional and
+ *                                   can be @c NULL, in which case the response
+ *                                   body is discarded.
+ * @param    responseBodyContext      Context passed to @p responseBodyCallback.
+ *
+ * @return    @c HTTPAPI_OK if the API call is successful or an error
+ *             code in case it fails.
+ */
+MOCKABLE_FUNCTION(, HTTPAPI_RESULT, HTTPAPI_ExecuteStreamingRequest, HTTP_HANDLE, handle, HTTPAPI_REQUEST_TYPE, requestType, const char*, relativePath,
+                                             HTTP_HEADERS_HANDLE, httpHeadersHandle, HTTPAPI_REQUEST_BODY_READ_CALLBACK, requestBodyCallback, void*, requestBodyContext,
+                                             unsigned int*, statusCode, HTTP_HEADERS_HANDLE, responseHeadersHandle,
+                                             HTTPAPI_RESPONSE_BODY_WRITE_CALLBACK, responseBodyCallback, void*, responseBodyContext);
+
 /**
  * @brief    Sets the option named @p optionName bearing the value
  *             @p value for the HTTP_HANDLE @p handle.
@@ -22,9 +22,11 @@
 
 #ifdef __cplusplus
 #include <cstddef>
+#include <cstdint>
 extern "C" {
 #else
 #include <stddef.h>
+#include <stdint.h>
 #endif
 
 typedef struct HTTPAPIEX_HANDLE_DATA_TAG* HTTPAPIEX_HANDLE;
@@ -40,6 +42,52 @@ typedef struct HTTPAPIEX_HANDLE_DATA_TAG* HTTPAPIEX_HANDLE;
 */
 DEFINE_ENUM(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT_VALUES);
 
+/** @brief Name of the option that installs a retry policy on an @c HTTPAPIEX_HANDLE.
+*           The value is a pointer to a @c HTTPAPIEX_RETRY_POLICY, which is copied.
+*/
+#define OPTION_HTTPAPIEX_RETRY_POLICY "HTTPAPIEX_RetryPolicy"
+
+/**
+ * @brief    Decides whether an attempt shall be retried.
+ *
+ * @param    context       The @c shouldRetryContext from the policy.
+ * @param    result        The result of the attempt.
+ * @param    statusCode    The HTTP status code of the attempt, 0 when @p result is not @c HTTPAPIEX_OK.
+ *
+ * @return    @c true if the request shall be retried.
+ */
+typedef bool(*HTTPAPIEX_SHOULD_RETRY)(void* context, HTTPAPIEX_RESULT result, unsigned int statusCode);
+
+/** @brief Retry policy applied by ::HTTPAPIEX_ExecuteRequest on top of the connection recovery.
+*
+*           Attempts are retried with exponential backoff and full jitter: before retry n the request
+*           sleeps a random time between 0 and min(maxBackoffInMs, initialBackoffInMs * 2^n). A
+*           Retry-After header (in seconds) of a throttled response takes precedence when
+*           @c honorRetryAfter is set, still capped at @c maxBackoffInMs. A retry whose backoff would end past @c deadlineInMs is not made.
+*/
+typedef struct HTTPAPIEX_RETRY_POLICY_TAG
+{
+    size_t maxRetries;                          /*0 disables retrying*/
+    unsigned int initialBackoffInMs;
+    unsigned int maxBackoffInMs;
+    unsigned int deadlineInMs;                  /*measured from the start of HTTPAPIEX_ExecuteRequest, 0 means no deadline*/
+    bool honorRetryAfter;
+    HTTPAPIEX_SHOULD_RETRY shouldRetry;         /*NULL retries transport failures and 408, 429, 500, 502, 503, 504*/
+    void* shouldRetryContext;
+} HTTPAPIEX_RETRY_POLICY;
+
+/** @brief Counters maintained by an @c HTTPAPIEX_HANDLE, see ::HTTPAPIEX_GetStatistics. */
+typedef struct HTTPAPIEX_STATISTICS_TAG
+{
+    size_t requestCount;                        /*calls to HTTPAPIEX_ExecuteRequest*/
+    size_t attemptCount;                        /*attempts, including retries*/
+    size_t retryCount;
+    size_t throttledCount;                      /*attempts answered with 429 or 503*/
+    size_t failedCount;                         /*calls that did not return HTTPAPIEX_OK*/
+    uint64_t totalLatencyInMs;                  /*only measured while a retry policy is set*/
+    uint64_t maxLatencyInMs;                    /*only measured while a retry policy is set*/
+} HTTPAPIEX_STATISTICS;
+
 /**
  * @brief    Creates an @c HTTPAPIEX_HANDLE that can be used in further calls.
  *
@@ -99,6 +147,16 @@ MOCKABLE_FUNCTION(, void, HTTPAPIEX_Destroy, HTTPAPIEX_HANDLE, handle);
  */
 MOCKABLE_FUNCTION(, HTTPAPIEX_RESULT, HTTPAPIEX_SetOption, HTTPAPIEX_HANDLE, handle, const char*, optionName, const void*, value);
 
+/**
+ * @brief    Retrieves the request, retry and latency counters of @p handle.
+ *
+ * @param    handle        The @c HTTPAPIEX_HANDLE representing this session.
+ * @param    statistics    Receives a copy of the counters.
+ *
+ * @return    An @c HTTPAPIEX_RESULT indicating the status of the call.
+ */
+MOCKABLE_FUNCTION(, HTTPAPIEX_RESULT, HTTPAPIEX_GetStatistics, HTTPAPIEX_HANDLE, handle, HTTPAPIEX_STATISTICS*, statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,12 @@
 *                  of all the headers
 *                - ::HTTPHeaders_GetHeader - when the application needs to retrieve the
 *                  <code>name + ": " + value</code> string based on an index.
+*                - ::HTTPHeaders_GetHeaderNameValue - when the application needs the name and
+*                  the value of a header based on an index, without allocating.
+*                - ::HTTPHeaders_Serialize - when the application needs all the headers
+*                  written in a buffer, as they appear in an HTTP message.
+*
+*             Header names are compared without regard to case.
 */
 
 #ifndef HTTPHEADERS_H
@@ -138,6 +144,43 @@ MOCKABLE_FUNCTION(, HTTP_HEADERS_RESULT, HTTPHeaders_GetHeaderCount, HTTP_HEADER
  */
 MOCKABLE_FUNCTION(, HTTP_HEADERS_RESULT, HTTPHeaders_GetHeader, HTTP_HEADERS_HANDLE, handle, size_t, index, char**, destination);
 
+/**
+ * @brief    This API retrieves the name and the value of the header element
+ *             at the given @p index without allocating.
+ *
+ * @param    handle            A valid @c HTTP_HEADERS_HANDLE value.
+ * @param    index            Zero-based index of the item in the
+ *                             headers collection.
+ * @param    name            Receives a pointer to the stored name.
+ * @param    value            Receives a pointer to the stored value.
+ *
+ *            The pointers are owned by @p handle and remain valid until the
+ *            handle is freed. A later change to the same header may
+ *            overwrite the string @p value points to.
+ *
+ * @return    Returns @c HTTP_HEADERS_OK when execution is successful or
+ *             @c HTTP_HEADERS_INVALID_ARG when an argument is not valid.
+ */
+MOCKABLE_FUNCTION(, HTTP_HEADERS_RESULT, HTTPHeaders_GetHeaderNameValue, HTTP_HEADERS_HANDLE, handle, size_t, index, const char**, name, const char**, value);
+
+/**
+ * @brief    This API writes every header as <code>name + ": " + value + "\r\n"</code>
+ *             in @p destination, in the order the headers were added.
+ *
+ * @param    handle            A valid @c HTTP_HEADERS_HANDLE value.
+ * @param    destination        The buffer to write to, or @c NULL to only
+ *                             compute the needed size. No terminating '\0' is written.
+ * @param    destinationSize    The size of @p destination in bytes.
+ * @param    serializedSize    Receives the number of bytes needed for the
+ *                             serialized headers.
+ *
+ * @return    Returns @c HTTP_HEADERS_OK when execution is successful,
+ *             @c HTTP_HEADERS_INSUFFICIENT_BUFFER when @p destinationSize is
+ *             smaller than @p serializedSize or @c HTTP_HEADERS_INVALID_ARG
+ *             when an argument is not valid.
+ */
+MOCKABLE_FUNCTION(, HTTP_HEADERS_RESULT, HTTPHeaders_Serialize, HTTP_HEADERS_HANDLE, handle, char*, destination, size_t, destinationSize, size_t*, serializedSize);
+
 /**
  * @brief    This API produces a clone of the @p handle parameter.
  *
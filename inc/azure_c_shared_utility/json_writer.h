@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file json_writer.h
+*    @brief Streaming writer that serializes JSON into a single growable buffer.
+*/
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+extern "C" {
+#else
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#endif
+
+/** @brief  Maximum nesting of objects and arrays. */
+#define JSON_WRITER_MAX_DEPTH 32
+
+typedef struct JSON_WRITER_TAG* JSON_WRITER_HANDLE;
+
+/**
+ * @brief   Creates a writer with an empty buffer.
+ *
+ * @param   initialCapacity     Number of bytes to reserve up front, 0 for a small default.
+ *                              The buffer doubles whenever it runs out of space.
+ *
+ * @return  A handle to the writer or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, JSON_WRITER_HANDLE, json_writer_create, size_t, initialCapacity);
+
+/** @brief  Frees the writer and its buffer. */
+MOCKABLE_FUNCTION(, void, json_writer_destroy, JSON_WRITER_HANDLE, writer);
+
+/** @brief  Empties the writer so that a new document can be written, keeping the buffer. */
+MOCKABLE_FUNCTION(, void, json_writer_reset, JSON_WRITER_HANDLE, writer);
+
+/**
+ * @brief   Open and close objects and arrays.
+ *
+ *          Commas are inserted automatically. Inside an object every value must be
+ *          preceded by ::json_writer_write_key.
+ *
+ * @return  0 on success, any other value if the call does not fit the document
+ *          structure or the buffer cannot grow.
+ */
+MOCKABLE_FUNCTION(, int, json_writer_begin_object, JSON_WRITER_HANDLE, writer);
+MOCKABLE_FUNCTION(, int, json_writer_end_object, JSON_WRITER_HANDLE, writer);
+MOCKABLE_FUNCTION(, int, json_writer_begin_array, JSON_WRITER_HANDLE, writer);
+MOCKABLE_FUNCTION(, int, json_writer_end_array, JSON_WRITER_HANDLE, writer);
+
+/**
+ * @brief   Writes the name of the next member of the current object, quoted and escaped.
+ *
+ * @return  0 on success, any other value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, json_writer_write_key, JSON_WRITER_HANDLE, writer, const char*, key);
+
+/**
+ * @brief   Writes a string value, quoted and escaped.
+ *
+ *          @c " @c \\ and @c / are escaped with a backslash and control characters are
+ *          written as 6 character unicode escapes, like ::STRING_new_JSON does. Other bytes,
+ *          including UTF-8 sequences, are copied as they are.
+ *
+ * @return  0 on success, any other value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, json_writer_write_string, JSON_WRITER_HANDLE, writer, const char*, value);
+
+/** @brief  Writes an integer value. */
+MOCKABLE_FUNCTION(, int, json_writer_write_int64, JSON_WRITER_HANDLE, writer, int64_t, value);
+
+/** @brief  Writes a number value; NaN and infinities are rejected since JSON cannot represent them. */
+MOCKABLE_FUNCTION(, int, json_writer_write_double, JSON_WRITER_HANDLE, writer, double, value);
+
+/** @brief  Writes @c true or @c false. */
+MOCKABLE_FUNCTION(, int, json_writer_write_bool, JSON_WRITER_HANDLE, writer, bool, value);
+
+/** @brief  Writes @c null. */
+MOCKABLE_FUNCTION(, int, json_writer_write_null, JSON_WRITER_HANDLE, writer);
+
+/**
+ * @brief   Writes @p json, which must already be a serialized JSON value, as it is.
+ *
+ * @return  0 on success, any other value otherwise.
+ */
+MOCKABLE_FUNCTION(, int, json_writer_write_raw, JSON_WRITER_HANDLE, writer, const char*, json);
+
+/**
+ * @brief   Returns the text written so far, @c \0 terminated and owned by the writer.
+ *
+ * @return  The text, or @c NULL if @p writer is @c NULL.
+ */
+MOCKABLE_FUNCTION(, const char*, json_writer_get_string, JSON_WRITER_HANDLE, writer);
+
+/** @brief  Returns the number of characters written so far. */
+MOCKABLE_FUNCTION(, size_t, json_writer_get_length, JSON_WRITER_HANDLE, writer);
+
+/**
+ * @brief   Hands the buffer over to a new STRING without copying it and resets the writer.
+ *
+ *          The document must be complete: every object and array must be closed.
+ *
+ * @return  A STRING owning the text, or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, STRING_HANDLE, json_writer_detach_STRING, JSON_WRITER_HANDLE, writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSON_WRITER_H */
@@ -18,14 +18,21 @@
 #include "azure_c_shared_utility/umock_c_prod.h"
 
 #ifdef __cplusplus
+#include <cstdint>
 extern "C" {
+#else
+#include <stdint.h>
 #endif
 
 typedef void* LOCK_HANDLE;
+typedef struct ADAPTIVE_LOCK_TAG* ADAPTIVE_LOCK_HANDLE;
+typedef struct RWLOCK_TAG* RWLOCK_HANDLE;
 
 #define LOCK_RESULT_VALUES \
     LOCK_OK, \
-    LOCK_ERROR \
+    LOCK_ERROR, \
+    LOCK_BUSY, \
+    LOCK_TIMEOUT \
 
 /** @brief Enumeration specifying the lock status.
 */
@@ -70,6 +77,185 @@ MOCKABLE_FUNCTION(, LOCK_RESULT, Unlock, LOCK_HANDLE, handle);
  */
 MOCKABLE_FUNCTION(, LOCK_RESULT, Lock_Deinit, LOCK_HANDLE, handle);
 
+/**
+ * @brief    Acquires the lock only if no other thread holds it.
+ *
+ * @param    handle    A valid handle to the lock.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been acquired, @c LOCK_BUSY
+ *             when it is held and @c LOCK_ERROR when an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, Lock_Try, LOCK_HANDLE, handle);
+
+/**
+ * @brief    Acquires the lock, waiting at most @p timeout_milliseconds for
+ *             the thread that holds it to release it.
+ *
+ * @param    handle                  A valid handle to the lock.
+ * @param    timeout_milliseconds    The longest time to wait.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been acquired, @c LOCK_TIMEOUT
+ *             when it was still held after the timeout and @c LOCK_ERROR when
+ *             an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, Lock_Timed, LOCK_HANDLE, handle, unsigned int, timeout_milliseconds);
+
+/**
+ * @brief    Creates an exclusive lock that spins for a while before putting
+ *             the calling thread to sleep.
+ *
+ *             Meant for short critical sections under contention: a waiter
+ *             that finds the lock held spins for about as long as recent
+ *             acquisitions needed to, and only then waits in the kernel. An
+ *             adaptive lock cannot be passed to Condition_Wait.
+ *
+ * @return    A valid @c ADAPTIVE_LOCK_HANDLE when successful or @c NULL otherwise.
+ */
+MOCKABLE_FUNCTION(, ADAPTIVE_LOCK_HANDLE, AdaptiveLock_Init);
+
+/**
+ * @brief    Destroys an adaptive lock that no thread holds.
+ *
+ * @return    Returns @c LOCK_OK on success and @c LOCK_ERROR when @p handle is @c NULL.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, AdaptiveLock_Deinit, ADAPTIVE_LOCK_HANDLE, handle);
+
+/**
+ * @brief    Acquires an adaptive lock, spinning and then waiting until it is free.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been acquired and
+ *             @c LOCK_ERROR when an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, AdaptiveLock_Lock, ADAPTIVE_LOCK_HANDLE, handle);
+
+/**
+ * @brief    Releases an adaptive lock and wakes a thread waiting for it.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been released and
+ *             @c LOCK_ERROR when an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, AdaptiveLock_Unlock, ADAPTIVE_LOCK_HANDLE, handle);
+
+/**
+ * @brief    Acquires an adaptive lock only if no other thread holds it.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been acquired, @c LOCK_BUSY
+ *             when it is held and @c LOCK_ERROR when an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, AdaptiveLock_Try, ADAPTIVE_LOCK_HANDLE, handle);
+
+/**
+ * @brief    Acquires an adaptive lock, waiting at most @p timeout_milliseconds.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been acquired, @c LOCK_TIMEOUT
+ *             when it was still held after the timeout and @c LOCK_ERROR when
+ *             an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, AdaptiveLock_Timed, ADAPTIVE_LOCK_HANDLE, handle, unsigned int, timeout_milliseconds);
+
+/**
+ * @brief    Creates a lock that any number of readers can hold at the same
+ *             time, or a single writer.
+ *
+ *             A writer waiting for the lock keeps new readers out where the
+ *             platform allows it, so a steady flow of readers does not starve
+ *             writers. The lock is not recursive: a thread that holds it for
+ *             reading must not acquire it again.
+ *
+ * @return    A valid @c RWLOCK_HANDLE when successful or @c NULL otherwise.
+ */
+MOCKABLE_FUNCTION(, RWLOCK_HANDLE, RWLock_Init);
+
+/**
+ * @brief    Destroys a reader-writer lock that no thread holds.
+ *
+ * @return    Returns @c LOCK_OK on success and @c LOCK_ERROR when @p handle is @c NULL.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, RWLock_Deinit, RWLOCK_HANDLE, handle);
+
+/**
+ * @brief    Acquires the lock for reading, waiting while a writer holds it.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been acquired and
+ *             @c LOCK_ERROR when an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, RWLock_ReadLock, RWLOCK_HANDLE, handle);
+
+/**
+ * @brief    Releases the lock acquired for reading.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been released and
+ *             @c LOCK_ERROR when an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, RWLock_ReadUnlock, RWLOCK_HANDLE, handle);
+
+/**
+ * @brief    Acquires the lock for writing, waiting while anyone holds it.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been acquired and
+ *             @c LOCK_ERROR when an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, RWLock_WriteLock, RWLOCK_HANDLE, handle);
+
+/**
+ * @brief    Releases the lock acquired for writing.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been released and
+ *             @c LOCK_ERROR when an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, RWLock_WriteUnlock, RWLOCK_HANDLE, handle);
+
+/**
+ * @brief    Acquires the lock for reading only if no writer holds it.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been acquired, @c LOCK_BUSY
+ *             when a writer holds it and @c LOCK_ERROR when an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, RWLock_TryReadLock, RWLOCK_HANDLE, handle);
+
+/**
+ * @brief    Acquires the lock for writing only if nobody holds it.
+ *
+ * @return    Returns @c LOCK_OK when the lock has been acquired, @c LOCK_BUSY
+ *             when it is held and @c LOCK_ERROR when an error occurs.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, RWLock_TryWriteLock, RWLOCK_HANDLE, handle);
+
+#ifdef LOCK_COLLECT_CONTENTION
+/** @brief Counters kept by a lock when the library is built with @c LOCK_COLLECT_CONTENTION.
+*/
+typedef struct LOCK_CONTENTION_COUNTERS_TAG
+{
+    /** @brief Number of times the lock was acquired. */
+    uint64_t acquired;
+    /** @brief Number of attempts that found the lock held, whether they then
+     *         waited for it, timed out or gave up. */
+    uint64_t contended;
+} LOCK_CONTENTION_COUNTERS;
+
+/**
+ * @brief    Gets the contention counters of a lock.
+ *
+ * @return    Returns @c LOCK_OK on success and @c LOCK_ERROR when an argument is @c NULL.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, Lock_GetContentionCounters, LOCK_HANDLE, handle, LOCK_CONTENTION_COUNTERS*, counters);
+
+/**
+ * @brief    Gets the contention counters of an adaptive lock.
+ *
+ * @return    Returns @c LOCK_OK on success and @c LOCK_ERROR when an argument is @c NULL.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, AdaptiveLock_GetContentionCounters, ADAPTIVE_LOCK_HANDLE, handle, LOCK_CONTENTION_COUNTERS*, counters);
+
+/**
+ * @brief    Gets the contention counters of a reader-writer lock, kept
+ *             separately for readers and for writers.
+ *
+ * @return    Returns @c LOCK_OK on success and @c LOCK_ERROR when an argument is @c NULL.
+ */
+MOCKABLE_FUNCTION(, LOCK_RESULT, RWLock_GetContentionCounters, RWLOCK_HANDLE, handle, LOCK_CONTENTION_COUNTERS*, read_counters, LOCK_CONTENTION_COUNTERS*, write_counters);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file log_arguments.h
+*    @brief Stores the arguments of a printf format without formatting them, and formats the
+*           message from them later.
+*
+*    The loggers use it to keep formatting off the logging thread: ::log_arguments_capture copies
+*    the values the conversions of the format consume into a buffer, and
+*    ::log_arguments_format renders the message from the format and that buffer, on another
+*    thread or in another process. The format itself is not copied and must outlive the buffer,
+*    as the string literals passed to the xlogging macros do.
+*
+*    Each argument is stored as a tag byte and a value: 8 byte integers, doubles and pointers,
+*    and strings as a 2 byte length and their characters, in the byte order of the process
+*    that captured them.
+*/
+
+#ifndef LOG_ARGUMENTS_H
+#define LOG_ARGUMENTS_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdarg>
+extern "C" {
+#else
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#endif
+
+/*tags of the stored arguments*/
+#define LOG_ARGUMENT_SIGNED           'i'
+#define LOG_ARGUMENT_UNSIGNED         'u'
+#define LOG_ARGUMENT_DOUBLE           'f'
+#define LOG_ARGUMENT_POINTER          'p'
+#define LOG_ARGUMENT_STRING           's'
+
+typedef struct LOG_ARGUMENTS_TAG
+{
+    unsigned char* buffer;
+    size_t size;
+    size_t used;
+    /*set when an argument did not fit; the arguments after it are not stored*/
+    bool truncated;
+} LOG_ARGUMENTS;
+
+typedef struct LOG_ARGUMENTS_READER_TAG
+{
+    const unsigned char* buffer;
+    size_t size;
+    size_t used;
+} LOG_ARGUMENTS_READER;
+
+/**
+ * @brief   Stores the arguments the conversions of @p format consume, as they are, after the
+ *          @p used bytes of @p arguments. Strings are cut and arguments dropped when they do not
+ *          fit, and so are the arguments after a conversion that is not understood.
+ */
+extern void log_arguments_capture(LOG_ARGUMENTS* arguments, const char* format, va_list args);
+
+/**
+ * @brief   Renders @p format with the arguments stored by ::log_arguments_capture into
+ *          @p message, which is always terminated. "..." stands for the arguments that were
+ *          not stored or do not match the format.
+ *
+ * @param   message         Where the message is written.
+ * @param   size            Size of @p message, at least 1.
+ * @param   format          The format the arguments were captured for.
+ * @param   arguments       The stored arguments.
+ * @param   arguments_size  How many bytes of @p arguments are used.
+ * @param   truncated       Whether the capture dropped arguments.
+ *
+ * @return  @c true if the whole message fit in @p message, @c false if it was cut or
+ *          arguments are missing.
+ */
+extern bool log_arguments_format(char* message, size_t size, const char* format, const unsigned char* arguments, size_t arguments_size, bool truncated);
+
+/** @brief  Returns the tag of the next stored argument, or 0 when there is none. */
+extern unsigned char log_arguments_next_tag(const LOG_ARGUMENTS_READER* reader);
+
+/** @brief  Reads the next argument into the 8 bytes at @p value if its tag is @p tag. */
+extern bool log_arguments_get_value(LOG_ARGUMENTS_READER* reader, unsigned char tag, void* value);
+
+/** @brief  Reads the next argument if it is a string; @p value is not terminated. */
+extern bool log_arguments_get_string(LOG_ARGUMENTS_READER* reader, const char** value, size_t* length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOG_ARGUMENTS_H */
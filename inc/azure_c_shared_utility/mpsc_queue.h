@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file mpsc_queue.h
+*    @brief Unbounded lock-free intrusive queue for any number of producer threads and one
+*           consumer thread.
+*/
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+// Include the platform-specific file that defines atomic functionality
+#include "queue_atomic_os.h"
+
+/**
+ * @brief   Link embedded in the items of the queue.
+ *
+ *          The queue allocates nothing per item: an item embeds an ::MPSC_QUEUE_NODE and
+ *          is found back from the node with containingRecord. An item can be in a single
+ *          queue at a time and must stay valid until it is popped.
+ */
+typedef struct MPSC_QUEUE_NODE_TAG
+{
+    QUEUE_ATOMIC_TYPE(struct MPSC_QUEUE_NODE_TAG*) next;
+} MPSC_QUEUE_NODE;
+
+typedef struct MPSC_QUEUE_TAG* MPSC_QUEUE_HANDLE;
+
+/**
+ * @brief   Creates an empty queue.
+ *
+ * @return  A handle to the queue or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, MPSC_QUEUE_HANDLE, mpsc_queue_create);
+
+/**
+ * @brief   Frees the queue. Items still queued are not touched.
+ */
+MOCKABLE_FUNCTION(, void, mpsc_queue_destroy, MPSC_QUEUE_HANDLE, queue);
+
+/**
+ * @brief   Adds the item owning @p node at the back of the queue. Can be called from any
+ *          thread and takes a single atomic exchange, whatever the number of producers.
+ *
+ * @return  0 on success, any other value on invalid arguments.
+ */
+MOCKABLE_FUNCTION(, int, mpsc_queue_push, MPSC_QUEUE_HANDLE, queue, MPSC_QUEUE_NODE*, node);
+
+/**
+ * @brief   Takes the node at the front of the queue. Must only be called by the consumer
+ *          thread.
+ *
+ * @return  The node, or @c NULL if the queue is empty. @c NULL is also returned for the
+ *          short time a producer has started but not finished pushing the only other node,
+ *          so a consumer that was told about a push must retry rather than conclude the
+ *          item is lost.
+ */
+MOCKABLE_FUNCTION(, MPSC_QUEUE_NODE*, mpsc_queue_pop, MPSC_QUEUE_HANDLE, queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MPSC_QUEUE_H */
@@ -60,6 +60,31 @@ static type* REFCOUNT_TYPE_DECLARE_CREATE(type) (void)
     return (type*)result;                                                                            \
 }                                                                                                    \
 
+/*this introduces a refcount'd type like DEFINE_REFCOUNT_TYPE does, with a weak count next to the ref count.*/
+/*A weak reference keeps the memory of the object, not the object: a cache can hold one to an object it does not keep alive*/
+/*and turn it into a reference with TRY_INC_REF, which fails once the last reference is gone. All the references together*/
+/*hold one weak reference, so _Create sets both counts to 1. Whoever releases the last reference (DEC_REF) disposes of*/
+/*what the object owns and then releases that weak reference; whoever releases the last weak reference (DEC_WEAK_REF)*/
+/*frees the memory with free().*/
+
+#define DEFINE_REFCOUNT_TYPE_WITH_WEAK_REF(type)                                                     \
+REFCOUNT_TYPE(type)                                                                                  \
+{                                                                                                    \
+    type counted;                                                                                    \
+    COUNT_TYPE count;                                                                                \
+    COUNT_TYPE weak_count;                                                                           \
+};                                                                                                   \
+static type* REFCOUNT_TYPE_DECLARE_CREATE(type) (void)                                               \
+{                                                                                                    \
+    REFCOUNT_TYPE(type)* result = (REFCOUNT_TYPE(type)*)malloc(sizeof(REFCOUNT_TYPE(type)));         \
+    if (result != NULL)                                                                              \
+    {                                                                                                \
+        INIT_REF(type, result);                                                                      \
+        INIT_WEAK_REF(type, result);                                                                 \
+    }                                                                                                \
+    return (type*)result;                                                                            \
+}                                                                                                    \
+
 #ifndef DEC_RETURN_ZERO
 #error refcount_os.h does not define DEC_RETURN_ZERO
 #endif // !DEC_RETURN_ZERO
@@ -72,6 +97,18 @@ static type* REFCOUNT_TYPE_DECLARE_CREATE(type) (void)
 #ifndef INIT_REF
 #error refcount_os.h does not define INIT_REF
 #endif // !INIT_REF
+#ifndef INC_WEAK_REF
+#error refcount_os.h does not define INC_WEAK_REF
+#endif // !INC_WEAK_REF
+#ifndef DEC_WEAK_REF
+#error refcount_os.h does not define DEC_WEAK_REF
+#endif // !DEC_WEAK_REF
+#ifndef INIT_WEAK_REF
+#error refcount_os.h does not define INIT_WEAK_REF
+#endif // !INIT_WEAK_REF
+#ifndef TRY_INC_REF
+#error refcount_os.h does not define TRY_INC_REF
+#endif // !TRY_INC_REF
 
 #ifdef __cplusplus
 }
@@ -5,6 +5,7 @@
 #define SASTOKEN_H
 
 #include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/hmacsha256.h"
 #include <stdbool.h>
 #include "azure_c_shared_utility/umock_c_prod.h"
 
@@ -16,6 +17,16 @@ extern "C" {
     MOCKABLE_FUNCTION(, STRING_HANDLE, SASToken_Create, STRING_HANDLE, key, STRING_HANDLE, scope, STRING_HANDLE, keyName, size_t, expiry);
     MOCKABLE_FUNCTION(, STRING_HANDLE, SASToken_CreateString, const char*, key, const char*, scope, const char*, keyName, size_t, expiry);
 
+    /**
+     * @brief   Builds a SAS token signed with a key prepared by ::HMACSHA256_CreateKey.
+     *
+     *          The token is assembled in place in a single allocation; the caller
+     *          owns the returned string and releases it with free.
+     *
+     * @return  The token, or @c NULL on failure.
+     */
+    MOCKABLE_FUNCTION(, char*, SASToken_Build, HMACSHA256_KEY_HANDLE, key, const char*, scope, const char*, keyName, size_t, expiry);
+
 #ifdef __cplusplus
 }
 #endif
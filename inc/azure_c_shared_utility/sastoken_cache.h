@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef SASTOKEN_CACHE_H
+#define SASTOKEN_CACHE_H
+
+#include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+typedef struct SASTOKEN_CACHE_TAG* SASTOKEN_CACHE_HANDLE;
+
+/**
+ * @brief   Creates a cache of SAS tokens keyed by (key, scope, keyName).
+ *
+ * @param   tokenLifetime       Lifetime in seconds of the tokens the cache generates.
+ * @param   renewalPercentage   Percentage (1 to 100) of @p tokenLifetime after which
+ *                              a cached token is regenerated on its next request.
+ * @param   maxEntries          Maximum number of (key, scope, keyName) triples kept, at
+ *                              least 1. When a new triple does not fit, the entries whose
+ *                              token expired are dropped, or else the least recently
+ *                              requested one.
+ *
+ * @return  A handle to the cache or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, SASTOKEN_CACHE_HANDLE, SASTokenCache_Create, size_t, tokenLifetime, unsigned int, renewalPercentage, size_t, maxEntries);
+
+/** @brief  Frees the cache along with every cached token and key. */
+MOCKABLE_FUNCTION(, void, SASTokenCache_Destroy, SASTOKEN_CACHE_HANDLE, cache);
+
+/**
+ * @brief   Returns a SAS token for @p scope signed with the base64 encoded @p key.
+ *
+ *          The first request for a (key, scope, keyName) triple prepares the key
+ *          and builds a token; following requests return the same token until
+ *          the renewal point of its lifetime, when it is rebuilt. The cache can
+ *          be used from several threads at once.
+ *
+ * @return  A copy of the token owned by the caller, or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, STRING_HANDLE, SASTokenCache_GetToken, SASTOKEN_CACHE_HANDLE, cache, const char*, key, const char*, scope, const char*, keyName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SASTOKEN_CACHE_H */
@@ -21,6 +21,8 @@ extern "C"
 
     static STATIC_VAR_UNUSED const char* const OPTION_HTTP_PROXY = "proxy_data";
     static STATIC_VAR_UNUSED const char* const OPTION_HTTP_TIMEOUT = "timeout";
+    // value is a const bool*; when true the HTTPAPI asks for and decodes gzip/deflate response bodies
+    static STATIC_VAR_UNUSED const char* const OPTION_HTTP_DECOMPRESS_RESPONSE = "decompress_response";
 
     static STATIC_VAR_UNUSED const char* const OPTION_TRUSTED_CERT = "TrustedCerts";
 
@@ -48,6 +50,21 @@ extern "C"
     static STATIC_VAR_UNUSED const char* const OPTION_ADDRESS_TYPE_DOMAIN_SOCKET = "DOMAIN_SOCKET";
     static STATIC_VAR_UNUSED const char* const OPTION_ADDRESS_TYPE_IP_SOCKET = "IP_SOCKET";
 
+#define XIO_EVENT_READABLE  0x1
+#define XIO_EVENT_WRITABLE  0x2
+
+    // set_interest is called by the IO that owns fd whenever the events it needs to make progress change;
+    // events is a combination of XIO_EVENT_READABLE and XIO_EVENT_WRITABLE, 0 means fd is no longer watched
+    typedef struct XIO_EVENT_BINDING_TAG
+    {
+        int(*set_interest)(void* context, int fd, unsigned int events);
+        void* context;
+    } XIO_EVENT_BINDING;
+
+    // value is a const XIO_EVENT_BINDING*; IOs that do not own a descriptor pass it to the IO below them,
+    // a binding with a NULL set_interest detaches the IO from the previous binding
+    static STATIC_VAR_UNUSED const char* const OPTION_XIO_EVENT_BINDING = "xio_event_binding";
+
 #ifdef __cplusplus
 }
 #endif
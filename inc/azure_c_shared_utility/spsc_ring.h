@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file spsc_ring.h
+*    @brief Bounded lock-free ring of pointers for one producer thread and one consumer thread.
+*/
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+typedef struct SPSC_RING_TAG* SPSC_RING_HANDLE;
+
+/**
+ * @brief   Creates a ring that holds up to @p capacity items.
+ *
+ *          The capacity is rounded up to a power of 2. Pushing and popping never lock and
+ *          never allocate; the producer and the consumer only share the two indices of the
+ *          ring, each on its own cache line.
+ *
+ * @return  A handle to the ring or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, SPSC_RING_HANDLE, spsc_ring_create, size_t, capacity);
+
+/**
+ * @brief   Frees the ring. Items still in the ring are not freed.
+ */
+MOCKABLE_FUNCTION(, void, spsc_ring_destroy, SPSC_RING_HANDLE, ring);
+
+/**
+ * @brief   Adds @p item at the back of the ring. Must only be called by the producer thread.
+ *
+ * @return  0 on success, any other value if the ring is full.
+ */
+MOCKABLE_FUNCTION(, int, spsc_ring_push, SPSC_RING_HANDLE, ring, void*, item);
+
+/**
+ * @brief   Takes the item at the front of the ring. Must only be called by the consumer thread.
+ *
+ * @return  0 on success, any other value if the ring is empty.
+ */
+MOCKABLE_FUNCTION(, int, spsc_ring_pop, SPSC_RING_HANDLE, ring, void**, item);
+
+/**
+ * @brief   Gets how many items the ring holds; exact only when called by the producer or
+ *          the consumer while the other is not running.
+ */
+MOCKABLE_FUNCTION(, size_t, spsc_ring_get_count, SPSC_RING_HANDLE, ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPSC_RING_H */
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file threadpool.h
+*    @brief Pool of worker threads that run scheduled and timed work items.
+*/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+extern "C" {
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+/** @brief  Granularity in milliseconds of the delays and periods of timers. */
+#define THREADPOOL_TIMER_RESOLUTION_MS 10
+
+/** @brief  Time in milliseconds after which an idle worker above the minimum count exits. */
+#define THREADPOOL_IDLE_TIMEOUT_MS 10000
+
+typedef struct THREADPOOL_TAG* THREADPOOL_HANDLE;
+typedef struct THREADPOOL_TIMER_TAG* THREADPOOL_TIMER_HANDLE;
+
+typedef void(*THREADPOOL_WORK_FUNCTION)(void* context);
+
+/**
+ * @brief   Creates a pool and starts @p min_threads workers.
+ *
+ *          Each worker owns a queue of work items: work scheduled from a worker goes
+ *          to its own queue and idle workers steal from the others, so workers rarely
+ *          contend with each other. Work scheduled from other threads goes through a
+ *          shared queue. While every worker is busy the pool starts more workers, up to
+ *          @p max_threads; workers above @p min_threads exit after being idle for
+ *          ::THREADPOOL_IDLE_TIMEOUT_MS.
+ *
+ * @param   min_threads     Number of workers that are always running, at least 1.
+ * @param   max_threads     Maximum number of workers, at least @p min_threads.
+ *
+ * @return  A handle to the pool or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, THREADPOOL_HANDLE, threadpool_create, size_t, min_threads, size_t, max_threads);
+
+/**
+ * @brief   Shuts the pool down gracefully and frees it.
+ *
+ *          New work is refused, every work item already scheduled runs to completion,
+ *          timers stop firing and are freed, and all workers are joined. Must not be
+ *          called from a work item.
+ */
+MOCKABLE_FUNCTION(, void, threadpool_destroy, THREADPOOL_HANDLE, threadpool);
+
+/**
+ * @brief   Schedules @p work_function to run once on a worker with @p context.
+ *
+ * @return  0 on success, any other value on failure, including once
+ *          ::threadpool_destroy has started.
+ */
+MOCKABLE_FUNCTION(, int, threadpool_schedule, THREADPOOL_HANDLE, threadpool, THREADPOOL_WORK_FUNCTION, work_function, void*, context);
+
+/**
+ * @brief   Schedules @p work_function to run after @p delay_ms and then, if @p period_ms
+ *          is not 0, every @p period_ms after each run completes.
+ *
+ *          Delays and periods are rounded up to ::THREADPOOL_TIMER_RESOLUTION_MS.
+ *          The timer is kept in a timer_wheel, so starting and cancelling it take
+ *          constant time however many timers are running.
+ *
+ * @return  A handle to the timer, to be released with ::threadpool_timer_cancel, or
+ *          @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, THREADPOOL_TIMER_HANDLE, threadpool_timer_start, THREADPOOL_HANDLE, threadpool, uint32_t, delay_ms, uint32_t, period_ms, THREADPOOL_WORK_FUNCTION, work_function, void*, context);
+
+/**
+ * @brief   Stops the timer and frees it.
+ *
+ *          The work function is not called again after this returns, except for a run
+ *          that had already started, which completes normally. It can be called from the
+ *          timer's own work function. Timers still running when the pool is destroyed are
+ *          freed by ::threadpool_destroy and must not be cancelled afterwards.
+ */
+MOCKABLE_FUNCTION(, void, threadpool_timer_cancel, THREADPOOL_TIMER_HANDLE, timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* THREADPOOL_H */
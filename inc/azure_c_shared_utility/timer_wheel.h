@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file timer_wheel.h
+*    @brief Hierarchical timer wheel that runs deadlines from a dowork function.
+*
+*    Modules that poll tickcounter_get_current_ms on every dowork to find out whether a
+*    timeout expired can schedule a timer instead: scheduling, restarting and cancelling a
+*    timer take constant time however many timers are running, and ::timer_wheel_dowork
+*    only looks at the timers that are due.
+*
+*    A timer wheel is not thread safe: it is driven by calling ::timer_wheel_dowork from the
+*    thread that uses it, either from a dowork loop or from the thread of an event loop, for
+*    instance from an event loop timer or after event_loop_run_once waited for
+*    ::timer_wheel_get_wait_ms. Driving it from threadpool work requires the caller to
+*    serialize every call with a lock.
+*/
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstdint>
+extern "C" {
+#else
+#include <stdint.h>
+#endif
+
+/** @brief  Value of the wait returned by ::timer_wheel_get_wait_ms when no timer is scheduled. */
+#define TIMER_WHEEL_WAIT_INFINITE UINT32_MAX
+
+typedef struct TIMER_WHEEL_TAG* TIMER_WHEEL_HANDLE;
+typedef struct TIMER_WHEEL_TIMER_TAG* TIMER_WHEEL_TIMER_HANDLE;
+
+typedef void(*ON_TIMER_WHEEL_TIMER)(void* context);
+
+/**
+ * @brief   Creates a timer wheel that measures time with its own tick counter.
+ *
+ * @param   tick_ms     Granularity in milliseconds of the delays, at least 1. Delays are
+ *                      rounded up to a whole number of ticks.
+ *
+ * @return  A handle to the timer wheel or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, TIMER_WHEEL_HANDLE, timer_wheel_create, uint32_t, tick_ms);
+
+/**
+ * @brief   Frees the timer wheel and every timer that was not cancelled, without running them.
+ *
+ *          Must not be called from a timer callback.
+ */
+MOCKABLE_FUNCTION(, void, timer_wheel_destroy, TIMER_WHEEL_HANDLE, timer_wheel);
+
+/**
+ * @brief   Schedules @p on_timer to be called with @p context by ::timer_wheel_dowork once
+ *          @p delay_ms went by, rounded up to the next tick.
+ *
+ *          May be called from a timer callback; the timer then runs in a later
+ *          ::timer_wheel_dowork.
+ *
+ * @return  A handle to the timer, to be released with ::timer_wheel_cancel whether it ran or
+ *          not, or @c NULL on failure.
+ */
+MOCKABLE_FUNCTION(, TIMER_WHEEL_TIMER_HANDLE, timer_wheel_schedule, TIMER_WHEEL_HANDLE, timer_wheel, uint32_t, delay_ms, ON_TIMER_WHEEL_TIMER, on_timer, void*, context);
+
+/**
+ * @brief   Moves the deadline of @p timer to @p delay_ms from now, whether it is waiting or
+ *          already ran, for instance to push an inactivity timeout back.
+ *
+ *          May be called from a timer callback, including the callback of @p timer.
+ *
+ * @return  0 on success, any other value on failure.
+ */
+MOCKABLE_FUNCTION(, int, timer_wheel_restart, TIMER_WHEEL_TIMER_HANDLE, timer, uint32_t, delay_ms);
+
+/**
+ * @brief   Cancels @p timer if it did not run yet and frees it.
+ *
+ *          May be called from a timer callback, including the callback of @p timer.
+ */
+MOCKABLE_FUNCTION(, void, timer_wheel_cancel, TIMER_WHEEL_TIMER_HANDLE, timer);
+
+/**
+ * @brief   Reads the tick counter and calls the callbacks of the timers that are due, in the
+ *          order of their deadlines.
+ */
+MOCKABLE_FUNCTION(, void, timer_wheel_dowork, TIMER_WHEEL_HANDLE, timer_wheel);
+
+/**
+ * @brief   Gets how long the caller can wait before calling ::timer_wheel_dowork without
+ *          delaying a timer.
+ *
+ *          The wait may end before the next timer is due, never after it.
+ *
+ * @param   wait_ms     Receives the wait, 0 if a timer is due, or ::TIMER_WHEEL_WAIT_INFINITE
+ *                      if no timer is scheduled.
+ *
+ * @return  0 on success, any other value on failure.
+ */
+MOCKABLE_FUNCTION(, int, timer_wheel_get_wait_ms, TIMER_WHEEL_HANDLE, timer_wheel, uint32_t*, wait_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMER_WHEEL_H */
@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/** @file trace_logger.h
+*    @brief xlogging backend that stores log records in binary form in a memory mapped file,
+*           and the decoder that renders such a file as text or JSON.
+*
+*    ::trace_logger_log does not format anything: it copies the raw arguments of the log call,
+*    as the conversions of the format string describe them, into a fixed size record of a ring
+*    in the file, together with a high resolution timestamp, the id of the calling thread and
+*    the addresses of the format string, the file name and the function name. Each of those
+*    strings is copied once into a string table in the same file, so the file can be decoded
+*    offline, by ::trace_logger_decode or the trace_decoder tool, even after a crash. When the
+*    ring is full the oldest records are overwritten.
+*/
+
+#ifndef TRACE_LOGGER_H
+#define TRACE_LOGGER_H
+
+#include "azure_c_shared_utility/macro_utils.h"
+#include "azure_c_shared_utility/xlogging.h"
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdio>
+extern "C" {
+#else
+#include <stddef.h>
+#include <stdio.h>
+#endif
+
+/*size of a record in the file; the arguments of a log call get what is left after the fixed
+fields, and strings among them are cut to fit*/
+#ifndef TRACE_LOGGER_RECORD_SIZE
+#define TRACE_LOGGER_RECORD_SIZE 256
+#endif
+
+#define TRACE_LOGGER_DECODE_FORMAT_VALUES \
+    TRACE_LOGGER_DECODE_TEXT, \
+    TRACE_LOGGER_DECODE_JSON
+
+DEFINE_ENUM(TRACE_LOGGER_DECODE_FORMAT, TRACE_LOGGER_DECODE_FORMAT_VALUES);
+
+/**
+ * @brief   Creates (or truncates) the file at @p path, maps it and installs ::trace_logger_log
+ *          as the xlogging log function.
+ *
+ *          Must not be called concurrently with ::trace_logger_stop or while the logger is
+ *          already started.
+ *
+ * @param   record_count        How many records the ring holds, rounded up to a power of 2.
+ * @param   string_table_size   Bytes reserved for the strings the records refer to. Strings
+ *                              that do not fit are decoded as their address.
+ *
+ * @return  0 on success, any other value on failure.
+ */
+MOCKABLE_FUNCTION(, int, trace_logger_start, const char*, path, size_t, record_count, size_t, string_table_size);
+
+/**
+ * @brief   Puts the previous log function back, waits for the calls to ::trace_logger_log in
+ *          progress and unmaps and closes the file.
+ */
+MOCKABLE_FUNCTION(, void, trace_logger_stop);
+
+/**
+ * @brief   Writes the records of the trace file at @p path to @p output, oldest first, one per
+ *          line, either as text or as one JSON object per line.
+ *
+ * @return  0 on success, any other value if the file cannot be read or is not a trace file
+ *          written by a process with the same pointer size.
+ */
+MOCKABLE_FUNCTION(, int, trace_logger_decode, const char*, path, FILE*, output, TRACE_LOGGER_DECODE_FORMAT, format);
+
+/**
+ * @brief   The xlogging log function installed by ::trace_logger_start. Safe to call from any
+ *          number of threads at once.
+ */
+extern void trace_logger_log(LOG_CATEGORY log_category, const char* file, const char* func, int line, unsigned int options, const char* format, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_LOGGER_H */
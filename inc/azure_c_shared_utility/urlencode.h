@@ -37,6 +37,33 @@ extern "C" {
     MOCKABLE_FUNCTION(, STRING_HANDLE, URL_Decode, STRING_HANDLE, input);
     MOCKABLE_FUNCTION(, STRING_HANDLE, URL_DecodeString, const char*, textDecode);
 
+    /* @brief   Computes the length of the URL encoding of the first textLength characters of text.
+    *
+    * @return   The number of characters produced by URL_EncodeInto, not counting the terminating
+    * \0, or 0 if text is NULL or the length does not fit in a size_t.
+    */
+    MOCKABLE_FUNCTION(, size_t, URL_EncodeLength, const char*, text, size_t, textLength);
+
+    /* @brief   URL Encode the first textLength characters of text into a caller supplied buffer.
+    * The encoding is the same as URL_Encode and no memory is allocated. destinationSize has to be
+    * at least URL_EncodeLength(text, textLength) + 1.
+    *
+    * @param    encodedLength receives the number of characters written, not counting the terminating \0.
+    *
+    * @return   0 on success, any other value otherwise.
+    */
+    MOCKABLE_FUNCTION(, int, URL_EncodeInto, const char*, text, size_t, textLength, char*, destination, size_t, destinationSize, size_t*, encodedLength);
+
+    /* @brief   URL Decode the first textLength characters of text into a caller supplied buffer.
+    * The decoding is the same as URL_Decode and no memory is allocated. A destinationSize of
+    * textLength + 1 is always enough.
+    *
+    * @param    decodedLength receives the number of characters written, not counting the terminating \0.
+    *
+    * @return   0 on success, any other value otherwise.
+    */
+    MOCKABLE_FUNCTION(, int, URL_DecodeInto, const char*, text, size_t, textLength, char*, destination, size_t, destinationSize, size_t*, decodedLength);
+
 #ifdef __cplusplus
 }
 #endif
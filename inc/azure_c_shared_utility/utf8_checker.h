@@ -14,8 +14,20 @@ extern "C" {
 
 #include "azure_c_shared_utility/umock_c_prod.h"
 
+/* Validation state carried across the fragments of one message */
+typedef struct UTF8_CHECKER_STATE_TAG
+{
+    unsigned char dfa_state;
+} UTF8_CHECKER_STATE;
+
 MOCKABLE_FUNCTION(, bool, utf8_checker_is_valid_utf8, const unsigned char*, utf8_str, size_t, length);
 
+/* Incremental validation: call utf8_checker_state_init once per message, utf8_checker_validate_fragment
+   for each fragment as it arrives and utf8_checker_is_complete after the last one. */
+MOCKABLE_FUNCTION(, void, utf8_checker_state_init, UTF8_CHECKER_STATE*, state);
+MOCKABLE_FUNCTION(, bool, utf8_checker_validate_fragment, UTF8_CHECKER_STATE*, state, const unsigned char*, utf8_str, size_t, length);
+MOCKABLE_FUNCTION(, bool, utf8_checker_is_complete, const UTF8_CHECKER_STATE*, state);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -18,6 +18,9 @@ extern "C" {
 
 typedef unsigned char UUID_T[16];
 
+/* Size of a buffer holding the string form of an UUID and its terminating null character */
+#define UUID_STRING_BUFFER_SIZE     37
+
 /* These 2 strings can be conveniently used directly in printf statements
   Notice that PRI_UUID has to be used like any other print format specifier, meaning it
   has to be preceded with % */
@@ -32,6 +35,13 @@ typedef unsigned char UUID_T[16];
 */
 MOCKABLE_FUNCTION(, int, UUID_generate, UUID_T*, uuid);
 
+/* @brief               Generates random (version 4) UUIDs without allocating memory.
+*  @param uuids         A pre-allocated array of @p count UUIDs to fill.
+*  @param count         The number of UUIDs to generate.
+*  @returns             Zero if no failures occur, non-zero otherwise.
+*/
+MOCKABLE_FUNCTION(, int, UUID_generate_n, UUID_T*, uuids, size_t, count);
+
 /* @brief               Gets the UUID value (byte sequence) of an well-formed UUID string.
 *  @param uuid_string   A null-terminated well-formed UUID string (e.g., "7f907d75-5e13-44cf-a1a3-19a01a2b4528").
 *  @param uuid          Sequence of bytes representing an UUID.
@@ -45,6 +55,14 @@ MOCKABLE_FUNCTION(, int, UUID_from_string, const char*, uuid_string, UUID_T*, uu
 */
 MOCKABLE_FUNCTION(, char*, UUID_to_string, UUID_T*, uuid);
 
+/* @brief                   Writes the string representation of the UUID value into a caller supplied buffer.
+*  @param uuid              Sequence of bytes representing an UUID.
+*  @param destination       Receives the null-terminated string (e.g., "7f907d75-5e13-44cf-a1a3-19a01a2b4528").
+*  @param destinationSize   The size of @p destination, at least UUID_STRING_BUFFER_SIZE.
+*  @returns                 Zero if no failures occur, non-zero otherwise.
+*/
+MOCKABLE_FUNCTION(, int, UUID_to_string_into, UUID_T*, uuid, char*, destination, size_t, destinationSize);
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,6 +48,13 @@ typedef void(*LOGGER_LOG_GETLASTERROR)(const char* file, const char* func, int l
 #define LOG_NONE 0x00
 #define LOG_LINE 0x01
 
+/*categories are ordered from the least to the most verbose; those more verbose than
+XLOGGING_MAX_CATEGORY are compiled out: the compiler drops the call and never evaluates
+its arguments. Define it to AZ_LOG_ERROR or AZ_LOG_INFO to strip traces from a build.*/
+#ifndef XLOGGING_MAX_CATEGORY
+#define XLOGGING_MAX_CATEGORY AZ_LOG_TRACE
+#endif
+
 /*no logging is useful when time and fprintf are mocked*/
 #ifdef NO_LOGGING
 #define LOG(...)
@@ -56,6 +63,8 @@ typedef void(*LOGGER_LOG_GETLASTERROR)(const char* file, const char* func, int l
 #define LogError(...)
 #define xlogging_get_log_function() NULL
 #define xlogging_set_log_function(...)
+#define xlogging_get_max_category() AZ_LOG_ERROR
+#define xlogging_set_max_category(...)
 #define LogErrorWinHTTPWithGetLastErrorAsString(...)
 #define UNUSED(x) (void)(x)
 #elif (defined MINIMAL_LOGERROR)
@@ -65,6 +74,8 @@ typedef void(*LOGGER_LOG_GETLASTERROR)(const char* file, const char* func, int l
 #define LogError(...) printf("error %s: line %d\n",__FILE__,__LINE__);
 #define xlogging_get_log_function() NULL
 #define xlogging_set_log_function(...)
+#define xlogging_get_max_category() AZ_LOG_ERROR
+#define xlogging_set_max_category(...)
 #define LogErrorWinHTTPWithGetLastErrorAsString(...)
 #define UNUSED(x) (void)(x)
 
@@ -84,10 +95,17 @@ typedef void(*LOGGER_LOG_GETLASTERROR)(const char* file, const char* func, int l
 
 #else /* NOT ESP8266_RTOS */
 
+/*the most verbose category logged at runtime, set with xlogging_set_max_category; it is an
+aligned int that is only ever stored whole, so reading it without a lock is safe and costs a load*/
+extern volatile int xlogging_max_category;
+
+/*tested before the log function is fetched and before any argument of the log call is evaluated*/
+#define xlogging_is_enabled(log_category) (((int)(log_category) <= (int)(XLOGGING_MAX_CATEGORY)) && ((int)(log_category) <= xlogging_max_category))
+
 #if defined _MSC_VER
-#define LOG(log_category, log_options, format, ...) { LOGGER_LOG l = xlogging_get_log_function(); if (l != NULL) l(log_category, __FILE__, FUNC_NAME, __LINE__, log_options, format, __VA_ARGS__); }
+#define LOG(log_category, log_options, format, ...) { if (xlogging_is_enabled(log_category)) { LOGGER_LOG l = xlogging_get_log_function(); if (l != NULL) l(log_category, __FILE__, FUNC_NAME, __LINE__, log_options, format, __VA_ARGS__); } }
 #else
-#define LOG(log_category, log_options, format, ...) { LOGGER_LOG l = xlogging_get_log_function(); if (l != NULL) l(log_category, __FILE__, FUNC_NAME, __LINE__, log_options, format, ##__VA_ARGS__); }
+#define LOG(log_category, log_options, format, ...) { if (xlogging_is_enabled(log_category)) { LOGGER_LOG l = xlogging_get_log_function(); if (l != NULL) l(log_category, __FILE__, FUNC_NAME, __LINE__, log_options, format, ##__VA_ARGS__); } }
 #endif
 
 #if defined _MSC_VER
@@ -130,9 +148,17 @@ extern LOGGER_LOG_GETLASTERROR xlogging_get_log_function_GetLastError(void);
 
 extern void LogBinary(const char* comment, const void* data, size_t size);
 
+/*LogBinary logs at AZ_LOG_TRACE: when traces are off the buffer is not even looked at*/
+#define LogBinary(comment, data, size) do { if (xlogging_is_enabled(AZ_LOG_TRACE)) { (LogBinary)(comment, data, size); } } while((void)0,0)
+
 extern void xlogging_set_log_function(LOGGER_LOG log_function);
 extern LOGGER_LOG xlogging_get_log_function(void);
 
+/*sets the most verbose category logged: AZ_LOG_ERROR logs errors only, AZ_LOG_TRACE (the default) logs
+everything XLOGGING_MAX_CATEGORY leaves in. Errors are always logged.*/
+extern void xlogging_set_max_category(LOG_CATEGORY max_category);
+extern LOG_CATEGORY xlogging_get_max_category(void);
+
 #endif /* NOT ESP8266_RTOS */
 
 #ifdef __cplusplus
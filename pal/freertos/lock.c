@@ -109,3 +109,124 @@ LOCK_RESULT Unlock(LOCK_HANDLE handle)
 
     return result;
 }
+
+LOCK_RESULT Lock_Try(LOCK_HANDLE handle)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_001: [ Lock_Try on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else if (xSemaphoreTake((SemaphoreHandle_t)handle, 0) == pdTRUE)
+    {
+        /* Codes_SRS_LOCK_01_002: [ Lock_Try shall acquire the lock and return LOCK_OK if no thread holds it ]*/
+        result = LOCK_OK;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_003: [ Lock_Try shall return LOCK_BUSY without waiting if the lock is held ]*/
+        result = LOCK_BUSY;
+    }
+
+    return result;
+}
+
+LOCK_RESULT Lock_Timed(LOCK_HANDLE handle, unsigned int timeout_milliseconds)
+{
+    LOCK_RESULT result;
+    if (handle == NULL)
+    {
+        /* Codes_SRS_LOCK_01_005: [ Lock_Timed on NULL handle passed returns LOCK_ERROR ]*/
+        LogError("Invalid argument; handle is NULL.");
+        result = LOCK_ERROR;
+    }
+    else if (xSemaphoreTake((SemaphoreHandle_t)handle, (TickType_t)(timeout_milliseconds / portTICK_PERIOD_MS)) == pdTRUE)
+    {
+        /* Codes_SRS_LOCK_01_006: [ Lock_Timed shall acquire the lock and return LOCK_OK if it is released within timeout_milliseconds ]*/
+        result = LOCK_OK;
+    }
+    else
+    {
+        /* Codes_SRS_LOCK_01_007: [ Lock_Timed shall return LOCK_TIMEOUT if the lock is still held after timeout_milliseconds ]*/
+        result = LOCK_TIMEOUT;
+    }
+
+    return result;
+}
+
+/*no reader-writer or adaptive primitive here: both are the exclusive lock above*/
+ADAPTIVE_LOCK_HANDLE AdaptiveLock_Init(void)
+{
+    /* Codes_SRS_LOCK_01_009: [ AdaptiveLock_Init shall create an exclusive lock that is not held and return it ]*/
+    /* Codes_SRS_LOCK_01_010: [ AdaptiveLock_Init on error shall return NULL ]*/
+    return (ADAPTIVE_LOCK_HANDLE)Lock_Init();
+}
+
+LOCK_RESULT AdaptiveLock_Deinit(ADAPTIVE_LOCK_HANDLE handle)
+{
+    return Lock_Deinit((LOCK_HANDLE)handle);
+}
+
+LOCK_RESULT AdaptiveLock_Lock(ADAPTIVE_LOCK_HANDLE handle)
+{
+    return Lock((LOCK_HANDLE)handle);
+}
+
+LOCK_RESULT AdaptiveLock_Unlock(ADAPTIVE_LOCK_HANDLE handle)
+{
+    return Unlock((LOCK_HANDLE)handle);
+}
+
+LOCK_RESULT AdaptiveLock_Try(ADAPTIVE_LOCK_HANDLE handle)
+{
+    return Lock_Try((LOCK_HANDLE)handle);
+}
+
+LOCK_RESULT AdaptiveLock_Timed(ADAPTIVE_LOCK_HANDLE handle, unsigned int timeout_milliseconds)
+{
+    return Lock_Timed((LOCK_HANDLE)handle, timeout_milliseconds);
+}
+
+RWLOCK_HANDLE RWLock_Init(void)
+{
+    /* Codes_SRS_LOCK_01_024: [ RWLock_Init shall create a reader-writer lock that is not held and return it ]*/
+    /* Codes_SRS_LOCK_01_025: [ RWLock_Init on error shall return NULL ]*/
+    return (RWLOCK_HANDLE)Lock_Init();
+}
+
+LOCK_RESULT RWLock_Deinit(RWLOCK_HANDLE handle)
+{
+    return Lock_Deinit((LOCK_HANDLE)handle);
+}
+
+LOCK_RESULT RWLock_ReadLock(RWLOCK_HANDLE handle)
+{
+    return Lock((LOCK_HANDLE)handle);
+}
+
+LOCK_RESULT RWLock_ReadUnlock(RWLOCK_HANDLE handle)
+{
+    return Unlock((LOCK_HANDLE)handle);
+}
+
+LOCK_RESULT RWLock_WriteLock(RWLOCK_HANDLE handle)
+{
+    return Lock((LOCK_HANDLE)handle);
+}
+
+LOCK_RESULT RWLock_WriteUnlock(RWLOCK_HANDLE handle)
+{
+    return Unlock((LOCK_HANDLE)handle);
+}
+
+LOCK_RESULT RWLock_TryReadLock(RWLOCK_HANDLE handle)
+{
+    return Lock_Try((LOCK_HANDLE)handle);
+}
+
+LOCK_RESULT RWLock_TryWriteLock(RWLOCK_HANDLE handle)
+{
+    return Lock_Try((LOCK_HANDLE)handle);
+}
@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// This file gets included into spsc_ring.h and mpsc_queue.h as a means of extending the
+// behavior of the atomic loads, stores, exchanges and compare exchanges the lock-free queues are built on.
+//
+// Plain volatile accesses are only correct when producers and consumers cannot run at
+// the same time, which is the case on single core devices without preemptive threads.
+
+#ifndef QUEUE_ATOMIC_OS_H__GENERIC
+#define QUEUE_ATOMIC_OS_H__GENERIC
+
+#define QUEUE_ATOMIC_TYPE(type) type volatile
+#define QUEUE_ATOMIC_INIT(type, var, value) do { (var) = (value); } while((void)0,0)
+#define QUEUE_ATOMIC_LOAD(type, var) ((type)(var))
+#define QUEUE_ATOMIC_STORE(type, var, value) do { (var) = (value); } while((void)0,0)
+#define QUEUE_ATOMIC_EXCHANGE(type, var, value, previous) do { (previous) = (type)(var); (var) = (value); } while((void)0,0)
+#define QUEUE_ATOMIC_COMPARE_EXCHANGE(type, var, expected, desired, succeeded) do { if ((var) == (expected)) { (var) = (desired); (succeeded) = 1; } else { (succeeded) = 0; } } while((void)0,0)
+
+#endif // QUEUE_ATOMIC_OS_H__GENERIC
@@ -16,5 +16,9 @@
 #define INC_REF(type, var) ++((((REFCOUNT_TYPE(type)*)var)->count))
 #define DEC_REF(type, var) --((((REFCOUNT_TYPE(type)*)var)->count))
 #define INIT_REF(type, var) do { ((REFCOUNT_TYPE(type)*)var)->count = 1; } while((void)0,0)
+#define INC_WEAK_REF(type, var) ++((((REFCOUNT_TYPE(type)*)var)->weak_count))
+#define DEC_WEAK_REF(type, var) --((((REFCOUNT_TYPE(type)*)var)->weak_count))
+#define INIT_WEAK_REF(type, var) do { ((REFCOUNT_TYPE(type)*)var)->weak_count = 1; } while((void)0,0)
+#define TRY_INC_REF(type, var, succeeded) do { if (((REFCOUNT_TYPE(type)*)var)->count != 0) { ++(((REFCOUNT_TYPE(type)*)var)->count); (succeeded) = 1; } else { (succeeded) = 0; } } while((void)0,0)
 
 #endif // REFCOUNT_OS_H__GENERIC
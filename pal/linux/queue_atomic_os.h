@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// This file gets included into spsc_ring.h and mpsc_queue.h as a means of extending the
+// behavior of the atomic loads, stores, exchanges and compare exchanges the lock-free queues are built on.
+#ifndef QUEUE_ATOMIC_OS_H__LINUX
+#define QUEUE_ATOMIC_OS_H__LINUX
+
+
+// This Linux-specific header offers 3 strategies, in the same order as refcount_os.h:
+//   QUEUE_ATOMIC_DONTCARE        -- no atomicity guarantee
+//   QUEUE_ATOMIC_USE_STD_ATOMIC  -- C11 atomicity
+//   QUEUE_ATOMIC_USE_GNU_C_ATOMIC -- GNU-specific atomicity
+
+#if defined(__GNUC__)
+#define QUEUE_ATOMIC_USE_GNU_C_ATOMIC 1
+#endif
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ == 201112) && !defined(__STDC_NO_ATOMICS__)
+#define QUEUE_ATOMIC_USE_STD_ATOMIC 1
+#undef QUEUE_ATOMIC_USE_GNU_C_ATOMIC
+#endif
+
+#if defined(FREERTOS_ARCH_ESP8266)
+#define QUEUE_ATOMIC_DONTCARE 1
+#undef QUEUE_ATOMIC_USE_STD_ATOMIC
+#undef QUEUE_ATOMIC_USE_GNU_C_ATOMIC
+#endif
+
+/*the following macros declare and access a shared variable of a pointer sized type;
+QUEUE_ATOMIC_EXCHANGE stores value in var and sets previous to the value var had before;
+QUEUE_ATOMIC_COMPARE_EXCHANGE stores desired in var only if var equals expected and sets succeeded accordingly*/
+/*The following mechanisms are considered in this order
+QUEUE_ATOMIC_DONTCARE does not use atomic operations
+- will result in plain volatile reads and writes, good for single core devices only.
+C11
+- will result in #include <stdatomic.h>
+- loads are memory_order_acquire, stores memory_order_release and exchanges memory_order_acq_rel
+- a compare exchange is memory_order_acq_rel when it succeeds and memory_order_acquire when it fails
+gcc
+- will result in no include (for gcc these are intrinsics build in)
+- will use the __atomic builtins with the same orders (https://gcc.gnu.org/onlinedocs/gcc/_005f_005fatomic-Builtins.html)
+*/
+
+#if defined(QUEUE_ATOMIC_DONTCARE)
+#define QUEUE_ATOMIC_TYPE(type) type volatile
+#define QUEUE_ATOMIC_INIT(type, var, value) do { (var) = (value); } while((void)0,0)
+#define QUEUE_ATOMIC_LOAD(type, var) ((type)(var))
+#define QUEUE_ATOMIC_STORE(type, var, value) do { (var) = (value); } while((void)0,0)
+#define QUEUE_ATOMIC_EXCHANGE(type, var, value, previous) do { (previous) = (type)(var); (var) = (value); } while((void)0,0)
+#define QUEUE_ATOMIC_COMPARE_EXCHANGE(type, var, expected, desired, succeeded) do { if ((var) == (expected)) { (var) = (desired); (succeeded) = 1; } else { (succeeded) = 0; } } while((void)0,0)
+
+#elif defined(QUEUE_ATOMIC_USE_STD_ATOMIC)
+#include <stdatomic.h>
+#define QUEUE_ATOMIC_TYPE(type) _Atomic(type)
+#define QUEUE_ATOMIC_INIT(type, var, value) atomic_init(&(var), (value))
+#define QUEUE_ATOMIC_LOAD(type, var) ((type)atomic_load_explicit(&(var), memory_order_acquire))
+#define QUEUE_ATOMIC_STORE(type, var, value) atomic_store_explicit(&(var), (value), memory_order_release)
+#define QUEUE_ATOMIC_EXCHANGE(type, var, value, previous) do { (previous) = (type)atomic_exchange_explicit(&(var), (value), memory_order_acq_rel); } while((void)0,0)
+#define QUEUE_ATOMIC_COMPARE_EXCHANGE(type, var, expected, desired, succeeded) do { type queue_atomic_expected = (expected); (succeeded) = atomic_compare_exchange_strong_explicit(&(var), &queue_atomic_expected, (desired), memory_order_acq_rel, memory_order_acquire); } while((void)0,0)
+
+#elif defined(QUEUE_ATOMIC_USE_GNU_C_ATOMIC)
+#define QUEUE_ATOMIC_TYPE(type) type
+#define QUEUE_ATOMIC_INIT(type, var, value) do { (var) = (value); } while((void)0,0)
+#define QUEUE_ATOMIC_LOAD(type, var) ((type)__atomic_load_n(&(var), __ATOMIC_ACQUIRE))
+#define QUEUE_ATOMIC_STORE(type, var, value) __atomic_store_n(&(var), (value), __ATOMIC_RELEASE)
+#define QUEUE_ATOMIC_EXCHANGE(type, var, value, previous) do { (previous) = (type)__atomic_exchange_n(&(var), (value), __ATOMIC_ACQ_REL); } while((void)0,0)
+#define QUEUE_ATOMIC_COMPARE_EXCHANGE(type, var, expected, desired, succeeded) do { type queue_atomic_expected = (expected); (succeeded) = __atomic_compare_exchange_n(&(var), &queue_atomic_expected, (desired), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); } while((void)0,0)
+
+#endif /*defined(QUEUE_ATOMIC_USE_GNU_C_ATOMIC)*/
+
+#endif // QUEUE_ATOMIC_OS_H__LINUX
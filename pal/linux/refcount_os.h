@@ -45,12 +45,21 @@ REFCOUNT_ATOMIC_DONTCARE does not use atomic operations
 - will result in ++/-- used for increment/decrement.
 C11
 - will result in #include <stdatomic.h>
-- will use atomic_fetch_add/sub;
+- will use atomic_fetch_add_explicit/atomic_fetch_sub_explicit;
 - about the return value: "Atomically, the value pointed to by object immediately before the effects"
 gcc
 - will result in no include (for gcc these are intrinsics build in)
-- will use __sync_fetch_and_add/sub
-- about the return value: "... returns the value that had previously been in memory." (https://gcc.gnu.org/onlinedocs/gcc-4.4.3/gcc/Atomic-Builtins.html#Atomic-Builtins)
+- will use __atomic_add_fetch/__atomic_sub_fetch, or __sync_add_and_fetch/__sync_sub_and_fetch before gcc 4.7
+- about the return value: "... return the result of the operation" (https://gcc.gnu.org/onlinedocs/gcc/_005f_005fatomic-Builtins.html)
+
+Taking a reference only needs to be atomic: whoever takes it already holds one, so there is nothing to
+order against and the increment is relaxed. Releasing a reference is acquire/release, so that the writes made
+through every reference happen before the object is freed by whoever releases the last one. The __sync
+builtins of older gcc are always full barriers.
+
+INC_WEAK_REF/DEC_WEAK_REF/INIT_WEAK_REF do the same on the weak count of a type defined with
+DEFINE_REFCOUNT_TYPE_WITH_WEAK_REF. TRY_INC_REF takes a reference only if the count has not reached zero yet and
+sets succeeded accordingly.
 */
 
 
@@ -60,19 +69,41 @@ gcc
 #define INC_REF(type, var) ++((((REFCOUNT_TYPE(type)*)var)->count))
 #define DEC_REF(type, var) --((((REFCOUNT_TYPE(type)*)var)->count))
 #define INIT_REF(type, var) do { ((REFCOUNT_TYPE(type)*)var)->count = 1; } while((void)0,0)
+#define INC_WEAK_REF(type, var) ++((((REFCOUNT_TYPE(type)*)var)->weak_count))
+#define DEC_WEAK_REF(type, var) --((((REFCOUNT_TYPE(type)*)var)->weak_count))
+#define INIT_WEAK_REF(type, var) do { ((REFCOUNT_TYPE(type)*)var)->weak_count = 1; } while((void)0,0)
+#define TRY_INC_REF(type, var, succeeded) do { if (((REFCOUNT_TYPE(type)*)var)->count != 0) { ++(((REFCOUNT_TYPE(type)*)var)->count); (succeeded) = 1; } else { (succeeded) = 0; } } while((void)0,0)
 
 #elif defined(REFCOUNT_USE_STD_ATOMIC)
 #include <stdatomic.h>
 #define DEC_RETURN_ZERO (1)
-#define INC_REF(type, var) atomic_fetch_add((&((REFCOUNT_TYPE(type)*)var)->count), 1)
-#define DEC_REF(type, var) atomic_fetch_sub((&((REFCOUNT_TYPE(type)*)var)->count), 1)
+#define INC_REF(type, var) atomic_fetch_add_explicit((&((REFCOUNT_TYPE(type)*)var)->count), 1, memory_order_relaxed)
+#define DEC_REF(type, var) atomic_fetch_sub_explicit((&((REFCOUNT_TYPE(type)*)var)->count), 1, memory_order_acq_rel)
 #define INIT_REF(type, var) atomic_store(&((REFCOUNT_TYPE(type)*)var)->count, 1)
+#define INC_WEAK_REF(type, var) atomic_fetch_add_explicit((&((REFCOUNT_TYPE(type)*)var)->weak_count), 1, memory_order_relaxed)
+#define DEC_WEAK_REF(type, var) atomic_fetch_sub_explicit((&((REFCOUNT_TYPE(type)*)var)->weak_count), 1, memory_order_acq_rel)
+#define INIT_WEAK_REF(type, var) atomic_store(&((REFCOUNT_TYPE(type)*)var)->weak_count, 1)
+#define TRY_INC_REF(type, var, succeeded) do { uint32_t refcount_expected = atomic_load_explicit(&((REFCOUNT_TYPE(type)*)var)->count, memory_order_relaxed); (succeeded) = 0; while ((refcount_expected != 0) && !(succeeded)) { (succeeded) = atomic_compare_exchange_weak_explicit(&((REFCOUNT_TYPE(type)*)var)->count, &refcount_expected, refcount_expected + 1, memory_order_acquire, memory_order_relaxed); } } while((void)0,0)
+
+#elif defined(REFCOUNT_USE_GNU_C_ATOMIC) && defined(__ATOMIC_RELAXED)
+#define DEC_RETURN_ZERO (0)
+#define INC_REF(type, var) __atomic_add_fetch((&((REFCOUNT_TYPE(type)*)var)->count), 1, __ATOMIC_RELAXED)
+#define DEC_REF(type, var) __atomic_sub_fetch((&((REFCOUNT_TYPE(type)*)var)->count), 1, __ATOMIC_ACQ_REL)
+#define INIT_REF(type, var) do { ((REFCOUNT_TYPE(type)*)var)->count = 1; __sync_synchronize(); } while((void)0,0)
+#define INC_WEAK_REF(type, var) __atomic_add_fetch((&((REFCOUNT_TYPE(type)*)var)->weak_count), 1, __ATOMIC_RELAXED)
+#define DEC_WEAK_REF(type, var) __atomic_sub_fetch((&((REFCOUNT_TYPE(type)*)var)->weak_count), 1, __ATOMIC_ACQ_REL)
+#define INIT_WEAK_REF(type, var) do { ((REFCOUNT_TYPE(type)*)var)->weak_count = 1; __sync_synchronize(); } while((void)0,0)
+#define TRY_INC_REF(type, var, succeeded) do { uint32_t refcount_expected = __atomic_load_n(&((REFCOUNT_TYPE(type)*)var)->count, __ATOMIC_RELAXED); (succeeded) = 0; while ((refcount_expected != 0) && !(succeeded)) { (succeeded) = __atomic_compare_exchange_n(&((REFCOUNT_TYPE(type)*)var)->count, &refcount_expected, refcount_expected + 1, 1, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED); } } while((void)0,0)
 
 #elif defined(REFCOUNT_USE_GNU_C_ATOMIC)
 #define DEC_RETURN_ZERO (0)
 #define INC_REF(type, var) __sync_add_and_fetch((&((REFCOUNT_TYPE(type)*)var)->count), 1)
 #define DEC_REF(type, var) __sync_sub_and_fetch((&((REFCOUNT_TYPE(type)*)var)->count), 1)
 #define INIT_REF(type, var) do { ((REFCOUNT_TYPE(type)*)var)->count = 1; __sync_synchronize(); } while((void)0,0)
+#define INC_WEAK_REF(type, var) __sync_add_and_fetch((&((REFCOUNT_TYPE(type)*)var)->weak_count), 1)
+#define DEC_WEAK_REF(type, var) __sync_sub_and_fetch((&((REFCOUNT_TYPE(type)*)var)->weak_count), 1)
+#define INIT_WEAK_REF(type, var) do { ((REFCOUNT_TYPE(type)*)var)->weak_count = 1; __sync_synchronize(); } while((void)0,0)
+#define TRY_INC_REF(type, var, succeeded) do { uint32_t refcount_expected = *(volatile uint32_t*)&((REFCOUNT_TYPE(type)*)var)->count; uint32_t refcount_previous; (succeeded) = 0; while ((refcount_expected != 0) && !(succeeded)) { refcount_previous = __sync_val_compare_and_swap(&((REFCOUNT_TYPE(type)*)var)->count, refcount_expected, refcount_expected + 1); (succeeded) = (refcount_previous == refcount_expected); refcount_expected = refcount_previous; } } while((void)0,0)
 
 #endif /*defined(REFCOUNT_USE_GNU_C_ATOMIC)*/
 
@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// This file gets included into spsc_ring.h and mpsc_queue.h as a means of extending the
+// behavior of the atomic loads, stores, exchanges and compare exchanges the lock-free queues are built on.
+#ifndef QUEUE_ATOMIC_OS_H__WINDOWS
+#define QUEUE_ATOMIC_OS_H__WINDOWS
+
+#include "windows.h"
+
+// The Interlocked pointer functions work on any pointer sized type and are full barriers,
+// which is at least as strong as the acquire loads and release stores the queues need
+#define QUEUE_ATOMIC_TYPE(type) type volatile
+#define QUEUE_ATOMIC_INIT(type, var, value) do { (var) = (value); } while((void)0,0)
+#define QUEUE_ATOMIC_LOAD(type, var) ((type)InterlockedCompareExchangePointer((PVOID volatile*)&(var), NULL, NULL))
+#define QUEUE_ATOMIC_STORE(type, var, value) (void)InterlockedExchangePointer((PVOID volatile*)&(var), (PVOID)(value))
+#define QUEUE_ATOMIC_EXCHANGE(type, var, value, previous) do { (previous) = (type)InterlockedExchangePointer((PVOID volatile*)&(var), (PVOID)(value)); } while((void)0,0)
+#define QUEUE_ATOMIC_COMPARE_EXCHANGE(type, var, expected, desired, succeeded) do { PVOID queue_atomic_expected = (PVOID)(expected); (succeeded) = (InterlockedCompareExchangePointer((PVOID volatile*)&(var), (PVOID)(desired), queue_atomic_expected) == queue_atomic_expected); } while((void)0,0)
+
+#endif // QUEUE_ATOMIC_OS_H__WINDOWS
@@ -12,10 +12,22 @@
 // The Windows atomic operations work on LONG
 #define COUNT_TYPE LONG
 
+// Taking a reference only needs to be atomic, so it does not fence where the SDK offers that;
+// releasing one keeps the full barrier of InterlockedDecrement, which the last release relies on.
+#if defined(InterlockedIncrementNoFence)
+#define REFCOUNT_INCREMENT InterlockedIncrementNoFence
+#else
+#define REFCOUNT_INCREMENT InterlockedIncrement
+#endif
+
 /*if macro DEC_REF returns DEC_RETURN_ZERO that means the ref count has reached zero.*/
 #define DEC_RETURN_ZERO (0)
-#define INC_REF(type, var) InterlockedIncrement(&(((REFCOUNT_TYPE(type)*)var)->count))
+#define INC_REF(type, var) REFCOUNT_INCREMENT(&(((REFCOUNT_TYPE(type)*)var)->count))
 #define DEC_REF(type, var) InterlockedDecrement(&(((REFCOUNT_TYPE(type)*)var)->count))
 #define INIT_REF(type, var) InterlockedExchange(&(((REFCOUNT_TYPE(type)*)var)->count), 1)
+#define INC_WEAK_REF(type, var) REFCOUNT_INCREMENT(&(((REFCOUNT_TYPE(type)*)var)->weak_count))
+#define DEC_WEAK_REF(type, var) InterlockedDecrement(&(((REFCOUNT_TYPE(type)*)var)->weak_count))
+#define INIT_WEAK_REF(type, var) InterlockedExchange(&(((REFCOUNT_TYPE(type)*)var)->weak_count), 1)
+#define TRY_INC_REF(type, var, succeeded) do { LONG refcount_expected = *(volatile LONG*)&(((REFCOUNT_TYPE(type)*)var)->count); LONG refcount_previous; (succeeded) = 0; while ((refcount_expected != 0) && !(succeeded)) { refcount_previous = InterlockedCompareExchange(&(((REFCOUNT_TYPE(type)*)var)->count), refcount_expected + 1, refcount_expected); (succeeded) = (refcount_previous == refcount_expected); refcount_expected = refcount_previous; } } while((void)0,0)
 
 #endif // REFCOUNT_OS_H__WINDOWS
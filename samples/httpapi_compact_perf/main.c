@@ -0,0 +1,396 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*
+ * Measures how fast httpapi_compact sends a GET and parses the response: the status line, a dozen
+ * headers and a JSON body, read with Content-Length or chunked, as received or gzip encoded and
+ * decoded with the decompress_response option. The transport is an in-memory IO that hands the
+ * whole response over in 16 KiB records on the first dowork after the request, so the numbers are
+ * the parsing cost only, without network or TLS. The "wire bytes" column is the size of the response
+ * the server sends, which is what decompression saves on a real link.
+ * httpapi_compact.c is included so the sample can give it the in-memory IO instead of the TLS IO of
+ * the platform. The gzip rows need a build with use_zlib.
+ *
+ * usage: httpapi_compact_perf [request_count]
+ */
+
+#define platform_get_default_tlsio perf_platform_get_default_tlsio
+#define HTTPAPI_Init perf_HTTPAPI_Init
+#define HTTPAPI_Deinit perf_HTTPAPI_Deinit
+#define HTTPAPI_CreateConnection perf_HTTPAPI_CreateConnection
+#define HTTPAPI_CloseConnection perf_HTTPAPI_CloseConnection
+#define HTTPAPI_ExecuteRequest perf_HTTPAPI_ExecuteRequest
+#define HTTPAPI_ExecuteStreamingRequest perf_HTTPAPI_ExecuteStreamingRequest
+#define HTTPAPI_SetOption perf_HTTPAPI_SetOption
+#define HTTPAPI_CloneOption perf_HTTPAPI_CloneOption
+#define HTTPAPI_RESULTStringStorage perf_HTTPAPI_RESULTStringStorage
+#define HTTPAPI_RESULTStrings perf_HTTPAPI_RESULTStrings
+#define HTTPAPI_RESULT_FromString perf_HTTPAPI_RESULT_FromString
+#define get_request_type perf_get_request_type
+
+#include "httpapi_compact.c"
+
+#include <stdint.h>
+#include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/tickcounter.h"
+
+#define RECORD_SIZE         (16 * 1024)
+#define BODY_ITEM_COUNT     200
+
+typedef struct MEMORY_IO_TAG
+{
+    const unsigned char* response;
+    size_t response_size;
+    int response_pending;
+    uint32_t request_tail;
+    ON_BYTES_RECEIVED on_bytes_received;
+    void* on_bytes_received_context;
+} MEMORY_IO;
+
+static MEMORY_IO memory_io;
+
+static CONCRETE_IO_HANDLE memory_io_create(void* io_create_parameters)
+{
+    (void)io_create_parameters;
+    (void)memset(&memory_io, 0, sizeof(memory_io));
+    return &memory_io;
+}
+
+static void memory_io_destroy(CONCRETE_IO_HANDLE concrete_io)
+{
+    (void)concrete_io;
+}
+
+static int memory_io_open(CONCRETE_IO_HANDLE concrete_io, ON_IO_OPEN_COMPLETE on_io_open_complete, void* on_io_open_complete_context, ON_BYTES_RECEIVED on_bytes_received, void* on_bytes_received_context, ON_IO_ERROR on_io_error, void* on_io_error_context)
+{
+    MEMORY_IO* io = (MEMORY_IO*)concrete_io;
+    (void)on_io_error;
+    (void)on_io_error_context;
+    io->on_bytes_received = on_bytes_received;
+    io->on_bytes_received_context = on_bytes_received_context;
+    on_io_open_complete(on_io_open_complete_context, IO_OPEN_OK);
+    return 0;
+}
+
+static int memory_io_close(CONCRETE_IO_HANDLE concrete_io, ON_IO_CLOSE_COMPLETE on_io_close_complete, void* callback_context)
+{
+    (void)concrete_io;
+    on_io_close_complete(callback_context);
+    return 0;
+}
+
+static int memory_io_send(CONCRETE_IO_HANDLE concrete_io, const void* buffer, size_t size, ON_SEND_COMPLETE on_send_complete, void* callback_context)
+{
+    MEMORY_IO* io = (MEMORY_IO*)concrete_io;
+    size_t i;
+
+    /*a GET has no body: the request is complete at the blank line ending its headers, which can come in a send of its own*/
+    for (i = 0; i < size; i++)
+    {
+        io->request_tail = (io->request_tail << 8) | ((const unsigned char*)buffer)[i];
+    }
+    if (io->request_tail == 0x0D0A0D0A)
+    {
+        io->request_tail = 0;
+        io->response_pending = 1;
+    }
+    on_send_complete(callback_context, IO_SEND_OK);
+    return 0;
+}
+
+static void memory_io_dowork(CONCRETE_IO_HANDLE concrete_io)
+{
+    MEMORY_IO* io = (MEMORY_IO*)concrete_io;
+
+    if (io->response_pending)
+    {
+        size_t pos;
+        io->response_pending = 0;
+        for (pos = 0; pos < io->response_size; pos += RECORD_SIZE)
+        {
+            size_t size = ((io->response_size - pos) < RECORD_SIZE) ? (io->response_size - pos) : RECORD_SIZE;
+            io->on_bytes_received(io->on_bytes_received_context, io->response + pos, size);
+        }
+    }
+}
+
+static int memory_io_setoption(CONCRETE_IO_HANDLE concrete_io, const char* optionName, const void* value)
+{
+    (void)concrete_io;
+    (void)optionName;
+    (void)value;
+    return 0;
+}
+
+static OPTIONHANDLER_HANDLE memory_io_retrieveoptions(CONCRETE_IO_HANDLE concrete_io)
+{
+    (void)concrete_io;
+    return NULL;
+}
+
+static const IO_INTERFACE_DESCRIPTION memory_io_interface_description =
+{
+    memory_io_retrieveoptions,
+    memory_io_create,
+    memory_io_destroy,
+    memory_io_open,
+    memory_io_close,
+    memory_io_send,
+    memory_io_dowork,
+    memory_io_setoption
+};
+
+const IO_INTERFACE_DESCRIPTION* platform_get_default_tlsio(void)
+{
+    return &memory_io_interface_description;
+}
+
+/*a list of devices, as a job or twin query would return it*/
+static char* make_json_body(size_t* body_size)
+{
+    static const char item_format[] = "%s{\"deviceId\":\"device-%04lu\",\"etag\":\"AAAAAAAAAA%lu=\",\"status\":\"enabled\",\"connectionState\":\"Disconnected\",\"lastActivityTime\":\"2026-10-19T08:%02lu:30.125Z\",\"properties\":{\"desired\":{\"telemetryInterval\":%lu,\"$version\":%lu},\"reported\":{\"firmware\":\"1.2.%lu\",\"$version\":%lu}}}";
+    size_t capacity = BODY_ITEM_COUNT * 320 + 3;
+    char* body = (char*)malloc(capacity);
+
+    if (body != NULL)
+    {
+        size_t used = 0;
+        unsigned long i;
+
+        body[used++] = '[';
+        for (i = 0; i < BODY_ITEM_COUNT; i++)
+        {
+            used += (size_t)snprintf(body + used, capacity - used, item_format, (i == 0) ? "" : ",", i, i * 7919, i % 60, 10 + (i % 50), i % 9, i % 17, i % 13);
+        }
+        body[used++] = ']';
+        body[used] = '\0';
+        *body_size = used;
+    }
+
+    return body;
+}
+
+#ifdef USE_ZLIB
+static unsigned char* gzip(const char* body, size_t body_size, size_t* gzip_size)
+{
+    z_stream stream;
+    uLong capacity = compressBound((uLong)body_size) + 32;
+    unsigned char* result = (unsigned char*)malloc(capacity);
+
+    if (result != NULL)
+    {
+        (void)memset(&stream, 0, sizeof(stream));
+        /*windowBits 15 + 16 writes a gzip header and trailer*/
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            stream.next_in = (Bytef*)body;
+            stream.avail_in = (uInt)body_size;
+            stream.next_out = result;
+            stream.avail_out = (uInt)capacity;
+            if (deflate(&stream, Z_FINISH) != Z_STREAM_END)
+            {
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                *gzip_size = (size_t)stream.total_out;
+            }
+            (void)deflateEnd(&stream);
+        }
+    }
+
+    return result;
+}
+#endif
+
+/*builds the response: status line, headers, then the body as it is or in chunks of chunk_size bytes*/
+static unsigned char* make_response(const unsigned char* body, size_t body_size, const char* content_encoding, size_t chunk_size, size_t* response_size)
+{
+    static const char headers[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Date: Mon, 19 Oct 2026 08:15:30 GMT\r\n"
+        "Content-Type: application/json; charset=utf-8\r\n"
+        "Server: Microsoft-HTTPAPI/2.0\r\n"
+        "Vary: Origin\r\n"
+        "ETag: \"AAAAAAAAAAE=\"\r\n"
+        "iothub-errorcode: ServerError\r\n"
+        "x-ms-request-id: 3b1c9f0e-7d4a-4d8e-9a51-2f0b6c7e8d91\r\n"
+        "x-ms-continuation: eyJvIjoxMDAsInMiOjEwMH0=\r\n"
+        "x-ms-item-type: DeviceInfo\r\n"
+        "Strict-Transport-Security: max-age=31536000; includeSubDomains\r\n"
+        "Cache-Control: no-cache\r\n";
+    size_t capacity = sizeof(headers) + 128 + body_size + ((chunk_size == 0) ? 0 : ((body_size / chunk_size) + 1) * 16);
+    unsigned char* result = (unsigned char*)malloc(capacity);
+
+    if (result != NULL)
+    {
+        size_t used = (size_t)snprintf((char*)result, capacity, "%s%s%s%s", headers,
+            (content_encoding == NULL) ? "" : "Content-Encoding: ", (content_encoding == NULL) ? "" : content_encoding, (content_encoding == NULL) ? "" : "\r\n");
+        if (chunk_size == 0)
+        {
+            used += (size_t)snprintf((char*)result + used, capacity - used, "Content-Length: %lu\r\n\r\n", (unsigned long)body_size);
+            (void)memcpy(result + used, body, body_size);
+            used += body_size;
+        }
+        else
+        {
+            size_t pos;
+            used += (size_t)snprintf((char*)result + used, capacity - used, "Transfer-Encoding: chunked\r\n\r\n");
+            for (pos = 0; pos < body_size; pos += chunk_size)
+            {
+                size_t size = ((body_size - pos) < chunk_size) ? (body_size - pos) : chunk_size;
+                used += (size_t)snprintf((char*)result + used, capacity - used, "%lx\r\n", (unsigned long)size);
+                (void)memcpy(result + used, body + pos, size);
+                used += size;
+                result[used++] = '\r';
+                result[used++] = '\n';
+            }
+            used += (size_t)snprintf((char*)result + used, capacity - used, "0\r\n\r\n");
+        }
+        *response_size = used;
+    }
+
+    return result;
+}
+
+static double measure(TICK_COUNTER_HANDLE tick_counter, HTTP_HANDLE http_handle, const unsigned char* response, size_t response_size, size_t body_size, size_t request_count)
+{
+    HTTP_HEADERS_HANDLE request_headers = HTTPHeaders_Alloc();
+    tickcounter_ms_t start_ms;
+    tickcounter_ms_t end_ms;
+    size_t i;
+    double result;
+
+    if ((request_headers == NULL) ||
+        (HTTPHeaders_AddHeaderNameValuePair(request_headers, "Authorization", "SharedAccessSignature sr=contoso.azure-devices.net&sig=abcdefghijklmnopqrstuvwxyz0123456789%2b%2f%3d&se=1792396800&skn=registryRead") != HTTP_HEADERS_OK) ||
+        (HTTPHeaders_AddHeaderNameValuePair(request_headers, "Accept", "application/json") != HTTP_HEADERS_OK))
+    {
+        (void)printf("cannot build the request\r\n");
+        exit(1);
+    }
+
+    memory_io.response = response;
+    memory_io.response_size = response_size;
+
+    (void)tickcounter_get_current_ms(tick_counter, &start_ms);
+    for (i = 0; i < request_count; i++)
+    {
+        unsigned int status_code;
+        /*httpapi_compact reads the body into an empty BUFFER, so each request gets a new BUFFER and new headers*/
+        BUFFER_HANDLE response_content = BUFFER_new();
+        HTTP_HEADERS_HANDLE response_headers = HTTPHeaders_Alloc();
+        if ((response_content == NULL) || (response_headers == NULL) ||
+            (HTTPAPI_ExecuteRequest(http_handle, HTTPAPI_REQUEST_GET, "/devices?api-version=2020-09-30", request_headers, NULL, 0, &status_code, response_headers, response_content) != HTTPAPI_OK) ||
+            (status_code != 200) ||
+            (BUFFER_length(response_content) != body_size))
+        {
+            (void)printf("request %lu failed\r\n", (unsigned long)i);
+            exit(1);
+        }
+        BUFFER_delete(response_content);
+        HTTPHeaders_Free(response_headers);
+    }
+    (void)tickcounter_get_current_ms(tick_counter, &end_ms);
+
+    result = (double)request_count / ((double)(end_ms - start_ms + 1) / 1000.0);
+
+    HTTPHeaders_Free(request_headers);
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    size_t request_count = (argc > 1) ? (size_t)atoi(argv[1]) : 20000;
+    TICK_COUNTER_HANDLE tick_counter = tickcounter_create();
+    HTTP_HANDLE http_handle = HTTPAPI_CreateConnection("contoso.azure-devices.net");
+    size_t body_size = 0;
+    char* body = make_json_body(&body_size);
+    int result;
+
+    if (request_count == 0)
+    {
+        request_count = 20000;
+    }
+
+    if ((tick_counter == NULL) || (http_handle == NULL) || (body == NULL))
+    {
+        (void)printf("initialization failed\r\n");
+        result = 1;
+    }
+    else
+    {
+        size_t response_size;
+        unsigned char* response;
+
+        (void)printf("JSON body: %lu bytes\r\n", (unsigned long)body_size);
+        (void)printf("response                  wire bytes   requests/s   body MiB/s\r\n");
+
+        response = make_response((const unsigned char*)body, body_size, NULL, 0, &response_size);
+        if (response != NULL)
+        {
+            double requests = measure(tick_counter, http_handle, response, response_size, body_size, request_count);
+            (void)printf("identity, Content-Length  %10lu %12.0f %12.1f\r\n", (unsigned long)response_size, requests, requests * (double)body_size / (1024.0 * 1024.0));
+            free(response);
+        }
+
+        response = make_response((const unsigned char*)body, body_size, NULL, 4096, &response_size);
+        if (response != NULL)
+        {
+            double requests = measure(tick_counter, http_handle, response, response_size, body_size, request_count);
+            (void)printf("identity, chunked         %10lu %12.0f %12.1f\r\n", (unsigned long)response_size, requests, requests * (double)body_size / (1024.0 * 1024.0));
+            free(response);
+        }
+
+#ifdef USE_ZLIB
+        {
+            bool decompress = true;
+            size_t gzip_size;
+            unsigned char* gzip_body = gzip(body, body_size, &gzip_size);
+
+            if ((gzip_body == NULL) ||
+                (HTTPAPI_SetOption(http_handle, OPTION_HTTP_DECOMPRESS_RESPONSE, &decompress) != HTTPAPI_OK))
+            {
+                (void)printf("cannot set up the gzip responses\r\n");
+            }
+            else
+            {
+                response = make_response(gzip_body, gzip_size, "gzip", 0, &response_size);
+                if (response != NULL)
+                {
+                    double requests = measure(tick_counter, http_handle, response, response_size, body_size, request_count);
+                    (void)printf("gzip, Content-Length      %10lu %12.0f %12.1f\r\n", (unsigned long)response_size, requests, requests * (double)body_size / (1024.0 * 1024.0));
+                    free(response);
+                }
+
+                response = make_response(gzip_body, gzip_size, "gzip", 4096, &response_size);
+                if (response != NULL)
+                {
+                    double requests = measure(tick_counter, http_handle, response, response_size, body_size, request_count);
+                    (void)printf("gzip, chunked             %10lu %12.0f %12.1f\r\n", (unsigned long)response_size, requests, requests * (double)body_size / (1024.0 * 1024.0));
+                    free(response);
+                }
+            }
+            free(gzip_body);
+        }
+#else
+        (void)printf("built without use_zlib: no gzip rows\r\n");
+#endif
+        result = 0;
+    }
+
+    if (http_handle != NULL)
+    {
+        HTTPAPI_CloseConnection(http_handle);
+    }
+    free(body);
+    tickcounter_destroy(tick_counter);
+
+    return result;
+}
@@ -0,0 +1,261 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*
+ * Measures how many items per second producer threads can hand to a consumer thread:
+ *  - lock+list: a singlylinkedlist guarded by a Lock, the consumer waits on a Condition
+ *               that every push posts; every item costs a list node allocation
+ *  - spsc ring: a single producer pushes pointers in a spsc_ring
+ *  - mpsc queue: the producers push items embedding an MPSC_QUEUE_NODE
+ * The lock-free consumers spin with ThreadAPI_Sleep(0) when they find nothing, so on a
+ * machine with fewer cores than threads the numbers mostly measure the scheduler.
+ *
+ * usage: queue_perf [max_producers]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/spsc_ring.h"
+#include "azure_c_shared_utility/mpsc_queue.h"
+#include "azure_c_shared_utility/doublylinkedlist.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/tickcounter.h"
+
+#define ITEM_COUNT          4000000
+#define SPSC_RING_CAPACITY  4096
+#define MAX_PRODUCERS       16
+
+typedef struct ITEM_TAG
+{
+    MPSC_QUEUE_NODE node;
+    size_t value;
+} ITEM;
+
+typedef struct PRODUCER_TAG
+{
+    size_t first_item;
+    size_t item_count;
+} PRODUCER;
+
+typedef struct RUN_TAG
+{
+    ITEM* items;
+    SINGLYLINKEDLIST_HANDLE list;
+    LOCK_HANDLE list_lock;
+    COND_HANDLE list_not_empty;
+    SPSC_RING_HANDLE ring;
+    MPSC_QUEUE_HANDLE queue;
+} RUN;
+
+static RUN run;
+
+/*keeps the compiler from dropping the consumed items*/
+static volatile size_t consumed_sink;
+
+static int lock_list_producer(void* context)
+{
+    PRODUCER* producer = (PRODUCER*)context;
+    size_t i;
+
+    for (i = producer->first_item; i < producer->first_item + producer->item_count; i++)
+    {
+        (void)Lock(run.list_lock);
+        if (singlylinkedlist_add(run.list, &run.items[i]) == NULL)
+        {
+            (void)printf("singlylinkedlist_add failed\r\n");
+            exit(1);
+        }
+        (void)Condition_Post(run.list_not_empty);
+        (void)Unlock(run.list_lock);
+    }
+
+    return 0;
+}
+
+static void lock_list_consume(size_t item_count)
+{
+    size_t sum = 0;
+    size_t i;
+
+    for (i = 0; i < item_count; i++)
+    {
+        LIST_ITEM_HANDLE head;
+
+        (void)Lock(run.list_lock);
+        while ((head = singlylinkedlist_get_head_item(run.list)) == NULL)
+        {
+            (void)Condition_Wait(run.list_not_empty, run.list_lock, 0);
+        }
+        sum += ((const ITEM*)singlylinkedlist_item_get_value(head))->value;
+        (void)singlylinkedlist_remove(run.list, head);
+        (void)Unlock(run.list_lock);
+    }
+
+    consumed_sink = sum;
+}
+
+static int spsc_ring_producer(void* context)
+{
+    PRODUCER* producer = (PRODUCER*)context;
+    size_t i;
+
+    for (i = producer->first_item; i < producer->first_item + producer->item_count; i++)
+    {
+        while (spsc_ring_push(run.ring, &run.items[i]) != 0)
+        {
+            ThreadAPI_Sleep(0);
+        }
+    }
+
+    return 0;
+}
+
+static void spsc_ring_consume(size_t item_count)
+{
+    size_t sum = 0;
+    size_t i = 0;
+
+    while (i < item_count)
+    {
+        void* item;
+        if (spsc_ring_pop(run.ring, &item) != 0)
+        {
+            ThreadAPI_Sleep(0);
+        }
+        else
+        {
+            sum += ((ITEM*)item)->value;
+            i++;
+        }
+    }
+
+    consumed_sink = sum;
+}
+
+static int mpsc_queue_producer(void* context)
+{
+    PRODUCER* producer = (PRODUCER*)context;
+    size_t i;
+
+    for (i = producer->first_item; i < producer->first_item + producer->item_count; i++)
+    {
+        (void)mpsc_queue_push(run.queue, &run.items[i].node);
+    }
+
+    return 0;
+}
+
+static void mpsc_queue_consume(size_t item_count)
+{
+    size_t sum = 0;
+    size_t i = 0;
+
+    while (i < item_count)
+    {
+        MPSC_QUEUE_NODE* node = mpsc_queue_pop(run.queue);
+        if (node == NULL)
+        {
+            ThreadAPI_Sleep(0);
+        }
+        else
+        {
+            sum += containingRecord(node, ITEM, node)->value;
+            i++;
+        }
+    }
+
+    consumed_sink = sum;
+}
+
+static double measure(TICK_COUNTER_HANDLE tick_counter, size_t producer_count, THREAD_START_FUNC producer_func, void(*consume)(size_t item_count))
+{
+    PRODUCER producers[MAX_PRODUCERS];
+    THREAD_HANDLE threads[MAX_PRODUCERS];
+    tickcounter_ms_t start_ms;
+    tickcounter_ms_t end_ms;
+    size_t i;
+
+    (void)tickcounter_get_current_ms(tick_counter, &start_ms);
+    for (i = 0; i < producer_count; i++)
+    {
+        producers[i].first_item = i * (ITEM_COUNT / producer_count);
+        producers[i].item_count = ITEM_COUNT / producer_count;
+        if (ThreadAPI_Create(&threads[i], producer_func, &producers[i]) != THREADAPI_OK)
+        {
+            (void)printf("ThreadAPI_Create failed\r\n");
+            exit(1);
+        }
+    }
+
+    consume((ITEM_COUNT / producer_count) * producer_count);
+
+    for (i = 0; i < producer_count; i++)
+    {
+        int thread_result;
+        (void)ThreadAPI_Join(threads[i], &thread_result);
+    }
+    (void)tickcounter_get_current_ms(tick_counter, &end_ms);
+
+    return (double)ITEM_COUNT / ((double)(end_ms - start_ms + 1) / 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+    size_t max_producers = (argc > 1) ? (size_t)atoi(argv[1]) : 4;
+    TICK_COUNTER_HANDLE tick_counter = tickcounter_create();
+    size_t producer_count;
+    size_t i;
+
+    if (max_producers > MAX_PRODUCERS)
+    {
+        max_producers = MAX_PRODUCERS;
+    }
+
+    run.items = (ITEM*)malloc(ITEM_COUNT * sizeof(ITEM));
+    run.list = singlylinkedlist_create();
+    run.list_lock = Lock_Init();
+    run.list_not_empty = Condition_Init();
+    run.ring = spsc_ring_create(SPSC_RING_CAPACITY);
+    run.queue = mpsc_queue_create();
+    if ((tick_counter == NULL) || (run.items == NULL) || (run.list == NULL) || (run.list_lock == NULL) ||
+        (run.list_not_empty == NULL) || (run.ring == NULL) || (run.queue == NULL))
+    {
+        (void)printf("initialization failed\r\n");
+        return 1;
+    }
+
+    for (i = 0; i < ITEM_COUNT; i++)
+    {
+        run.items[i].value = i;
+    }
+
+    (void)printf("producers    lock+list items/s    spsc ring items/s    mpsc queue items/s\r\n");
+    for (producer_count = 1; producer_count <= max_producers; producer_count *= 2)
+    {
+        double lock_list = measure(tick_counter, producer_count, lock_list_producer, lock_list_consume);
+        double mpsc_queue = measure(tick_counter, producer_count, mpsc_queue_producer, mpsc_queue_consume);
+        if (producer_count == 1)
+        {
+            double spsc = measure(tick_counter, 1, spsc_ring_producer, spsc_ring_consume);
+            (void)printf("%9lu %20.0f %20.0f %21.0f\r\n", (unsigned long)producer_count, lock_list, spsc, mpsc_queue);
+        }
+        else
+        {
+            (void)printf("%9lu %20.0f %20s %21.0f\r\n", (unsigned long)producer_count, lock_list, "-", mpsc_queue);
+        }
+    }
+
+    mpsc_queue_destroy(run.queue);
+    spsc_ring_destroy(run.ring);
+    Condition_Deinit(run.list_not_empty);
+    (void)Lock_Deinit(run.list_lock);
+    singlylinkedlist_destroy(run.list);
+    free(run.items);
+    tickcounter_destroy(tick_counter);
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*
+ * Measures how many clone/destroy pairs per second threads get through on ref counted handles:
+ *  - full fence:   a refcount'd type whose clone and destroy use the full barrier interlocked
+ *                  operations refcount_os.h used before (__sync builtins, Interlocked*)
+ *  - INC/DEC_REF:  the same type with INC_REF/DEC_REF, a relaxed increment and an acquire/release
+ *                  decrement
+ *  - CONSTBUFFER:  CONSTBUFFER_Clone/CONSTBUFFER_Destroy
+ * In the shared columns all the threads clone and destroy the same handle, so they contend on the
+ * count; in the last one each thread has a handle of its own. On x86 every interlocked operation
+ * is a locked instruction whatever its ordering, so the first two columns only differ on weakly
+ * ordered processors such as ARM.
+ *
+ * usage: refcount_perf [max_threads]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "azure_c_shared_utility/refcount.h"
+#include "azure_c_shared_utility/constbuffer.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/tickcounter.h"
+
+#define PAIR_COUNT          8000000
+#define MAX_THREADS         16
+
+#ifdef _MSC_VER
+#define FULL_FENCE_INC_REF(type, var) InterlockedIncrement(&(((REFCOUNT_TYPE(type)*)var)->count))
+#define FULL_FENCE_DEC_REF(type, var) InterlockedDecrement(&(((REFCOUNT_TYPE(type)*)var)->count))
+#else
+#define FULL_FENCE_INC_REF(type, var) __sync_add_and_fetch(&(((REFCOUNT_TYPE(type)*)var)->count), 1)
+#define FULL_FENCE_DEC_REF(type, var) __sync_sub_and_fetch(&(((REFCOUNT_TYPE(type)*)var)->count), 1)
+#endif
+
+typedef struct COUNTED_TAG
+{
+    size_t value;
+} COUNTED;
+
+DEFINE_REFCOUNT_TYPE(COUNTED);
+
+typedef struct WORKER_TAG
+{
+    COUNTED* counted;
+    CONSTBUFFER_HANDLE buffer;
+    size_t pair_count;
+} WORKER;
+
+static int full_fence_worker(void* context)
+{
+    WORKER* worker = (WORKER*)context;
+    size_t i;
+
+    for (i = 0; i < worker->pair_count; i++)
+    {
+        (void)FULL_FENCE_INC_REF(COUNTED, worker->counted);
+        if (FULL_FENCE_DEC_REF(COUNTED, worker->counted) == 0)
+        {
+            (void)printf("the count reached 0 while the handle was held\r\n");
+            exit(1);
+        }
+    }
+
+    return 0;
+}
+
+static int inc_dec_ref_worker(void* context)
+{
+    WORKER* worker = (WORKER*)context;
+    size_t i;
+
+    for (i = 0; i < worker->pair_count; i++)
+    {
+        (void)INC_REF(COUNTED, worker->counted);
+        if (DEC_REF(COUNTED, worker->counted) == DEC_RETURN_ZERO)
+        {
+            (void)printf("the count reached 0 while the handle was held\r\n");
+            exit(1);
+        }
+    }
+
+    return 0;
+}
+
+static int constbuffer_worker(void* context)
+{
+    WORKER* worker = (WORKER*)context;
+    size_t i;
+
+    for (i = 0; i < worker->pair_count; i++)
+    {
+        CONSTBUFFER_Destroy(CONSTBUFFER_Clone(worker->buffer));
+    }
+
+    return 0;
+}
+
+static double measure(TICK_COUNTER_HANDLE tick_counter, size_t thread_count, THREAD_START_FUNC worker_func, COUNTED* counted, CONSTBUFFER_HANDLE* buffers)
+{
+    WORKER workers[MAX_THREADS];
+    THREAD_HANDLE threads[MAX_THREADS];
+    tickcounter_ms_t start_ms;
+    tickcounter_ms_t end_ms;
+    size_t i;
+
+    (void)tickcounter_get_current_ms(tick_counter, &start_ms);
+    for (i = 0; i < thread_count; i++)
+    {
+        workers[i].counted = counted;
+        workers[i].buffer = buffers[i];
+        workers[i].pair_count = PAIR_COUNT / thread_count;
+        if (ThreadAPI_Create(&threads[i], worker_func, &workers[i]) != THREADAPI_OK)
+        {
+            (void)printf("ThreadAPI_Create failed\r\n");
+            exit(1);
+        }
+    }
+
+    for (i = 0; i < thread_count; i++)
+    {
+        int thread_result;
+        (void)ThreadAPI_Join(threads[i], &thread_result);
+    }
+    (void)tickcounter_get_current_ms(tick_counter, &end_ms);
+
+    return (double)((PAIR_COUNT / thread_count) * thread_count) / ((double)(end_ms - start_ms + 1) / 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+    size_t max_threads = (argc > 1) ? (size_t)atoi(argv[1]) : 4;
+    TICK_COUNTER_HANDLE tick_counter = tickcounter_create();
+    COUNTED* counted = REFCOUNT_TYPE_CREATE(COUNTED);
+    CONSTBUFFER_HANDLE shared_buffers[MAX_THREADS];
+    CONSTBUFFER_HANDLE own_buffers[MAX_THREADS];
+    unsigned char content[16] = { 0 };
+    size_t thread_count;
+    size_t i;
+    int result = 0;
+
+    if ((max_threads == 0) || (max_threads > MAX_THREADS))
+    {
+        max_threads = MAX_THREADS;
+    }
+
+    for (i = 0; i < MAX_THREADS; i++)
+    {
+        shared_buffers[i] = NULL;
+        own_buffers[i] = CONSTBUFFER_Create(content, sizeof(content));
+        if (own_buffers[i] == NULL)
+        {
+            result = 1;
+        }
+    }
+    shared_buffers[0] = own_buffers[0];
+    for (i = 1; i < MAX_THREADS; i++)
+    {
+        shared_buffers[i] = shared_buffers[0];
+    }
+
+    if ((tick_counter == NULL) || (counted == NULL) || (result != 0))
+    {
+        (void)printf("initialization failed\r\n");
+        result = 1;
+    }
+    else
+    {
+        (void)printf("threads    full fence pairs/s   INC/DEC_REF pairs/s   CONSTBUFFER pairs/s   CONSTBUFFER per thread pairs/s\r\n");
+        for (thread_count = 1; thread_count <= max_threads; thread_count *= 2)
+        {
+            double full_fence = measure(tick_counter, thread_count, full_fence_worker, counted, shared_buffers);
+            double inc_dec_ref = measure(tick_counter, thread_count, inc_dec_ref_worker, counted, shared_buffers);
+            double constbuffer_shared = measure(tick_counter, thread_count, constbuffer_worker, counted, shared_buffers);
+            double constbuffer_own = measure(tick_counter, thread_count, constbuffer_worker, counted, own_buffers);
+            (void)printf("%7lu %21.0f %21.0f %21.0f %32.0f\r\n", (unsigned long)thread_count, full_fence, inc_dec_ref, constbuffer_shared, constbuffer_own);
+        }
+    }
+
+    for (i = 0; i < MAX_THREADS; i++)
+    {
+        CONSTBUFFER_Destroy(own_buffers[i]);
+    }
+    free(counted);
+    tickcounter_destroy(tick_counter);
+
+    return result;
+}
@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*
+ * Measures SHA-256 throughput (Reset, Input, Result per message) for a range of message sizes.
+ * The same source builds two programs:
+ *  - sha_perf:          links the library, so it uses the block function sha224.c picks: the x86
+ *                       SHA extensions when CPUID reports them, the ARMv8 SHA2 instructions when
+ *                       the library was built with use_sha_armv8_acceleration for an aarch64
+ *                       target that has them, the portable code otherwise
+ *  - sha_perf_portable: builds sha224.c with NO_SHA_HW_ACCELERATION, so it always uses the
+ *                       portable code
+ * Running both on the same machine gives the gain of the hardware path. Each program first checks
+ * the digest of a 2 block message, so a broken block function does not get timed.
+ *
+ * usage: sha_perf [megabytes_per_size]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "azure_c_shared_utility/sha.h"
+#include "azure_c_shared_utility/tickcounter.h"
+
+#if !defined(NO_SHA_HW_ACCELERATION) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#elif !defined(NO_SHA_HW_ACCELERATION) && defined(USE_SHA_ARMV8_ACCELERATION) && defined(__aarch64__) && defined(__linux__) && \
+    (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+#define MAX_MESSAGE_SIZE    (1024 * 1024)
+
+static const size_t message_sizes[] = { 64, 1024, 16 * 1024, MAX_MESSAGE_SIZE };
+
+/*the block function sha224.c is expected to pick, mirroring its checks*/
+static const char* block_function_name(void)
+{
+    const char* result = "portable";
+
+#if !defined(NO_SHA_HW_ACCELERATION) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    unsigned int eax, ebx, ecx, edx;
+    if ((__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) &&
+        ((ecx & (1u << 9)) != 0) && ((ecx & (1u << 19)) != 0) &&
+        (__get_cpuid_max(0, NULL) >= 7))
+    {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        if ((ebx & (1u << 29)) != 0)
+        {
+            result = "SHA-NI";
+        }
+    }
+#elif !defined(NO_SHA_HW_ACCELERATION) && defined(USE_SHA_ARMV8_ACCELERATION) && defined(__aarch64__) && defined(__linux__) && \
+    (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+    if ((getauxval(AT_HWCAP) & HWCAP_SHA2) != 0)
+    {
+        result = "ARMv8 SHA2";
+    }
+#endif
+
+    return result;
+}
+
+static int check_digest(void)
+{
+    /*FIPS 180-2 appendix B.2*/
+    static const char message[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    static const uint8_t expected[SHA256HashSize] =
+    {
+        0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+        0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+    };
+    SHA256Context context;
+    uint8_t digest[SHA256HashSize];
+    int result;
+
+    if ((SHA256Reset(&context) != shaSuccess) ||
+        (SHA256Input(&context, (const uint8_t*)message, (unsigned int)(sizeof(message) - 1)) != shaSuccess) ||
+        (SHA256Result(&context, digest) != shaSuccess) ||
+        (memcmp(digest, expected, sizeof(expected)) != 0))
+    {
+        result = 1;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+static double measure(TICK_COUNTER_HANDLE tick_counter, const uint8_t* message, size_t message_size, size_t total_bytes)
+{
+    size_t message_count = (total_bytes + message_size - 1) / message_size;
+    SHA256Context context;
+    uint8_t digest[SHA256HashSize];
+    tickcounter_ms_t start_ms;
+    tickcounter_ms_t end_ms;
+    size_t i;
+
+    (void)tickcounter_get_current_ms(tick_counter, &start_ms);
+    for (i = 0; i < message_count; i++)
+    {
+        (void)SHA256Reset(&context);
+        (void)SHA256Input(&context, message, (unsigned int)message_size);
+        (void)SHA256Result(&context, digest);
+    }
+    (void)tickcounter_get_current_ms(tick_counter, &end_ms);
+
+    return ((double)(message_count * message_size) / (1024.0 * 1024.0)) / ((double)(end_ms - start_ms + 1) / 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+    size_t megabytes = (argc > 1) ? (size_t)atoi(argv[1]) : 64;
+    TICK_COUNTER_HANDLE tick_counter = tickcounter_create();
+    uint8_t* message = (uint8_t*)malloc(MAX_MESSAGE_SIZE);
+    size_t i;
+    int result;
+
+    if (megabytes == 0)
+    {
+        megabytes = 64;
+    }
+
+    if ((tick_counter == NULL) || (message == NULL))
+    {
+        (void)printf("initialization failed\r\n");
+        result = 1;
+    }
+    else if (check_digest() != 0)
+    {
+        (void)printf("the %s block function computed a wrong digest\r\n", block_function_name());
+        result = 1;
+    }
+    else
+    {
+        for (i = 0; i < MAX_MESSAGE_SIZE; i++)
+        {
+            message[i] = (uint8_t)(i * 131);
+        }
+
+        (void)printf("block function: %s\r\n", block_function_name());
+        (void)printf("message bytes          MiB/s\r\n");
+        for (i = 0; i < sizeof(message_sizes) / sizeof(message_sizes[0]); i++)
+        {
+            double throughput = measure(tick_counter, message, message_sizes[i], megabytes * 1024 * 1024);
+            (void)printf("%13lu %14.1f\r\n", (unsigned long)message_sizes[i], throughput);
+        }
+        result = 0;
+    }
+
+    free(message);
+    tickcounter_destroy(tick_counter);
+
+    return result;
+}
@@ -0,0 +1,205 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*
+ * Measures how many work items per second a threadpool schedules and completes, for a
+ * growing number of workers:
+ *  - external: the main thread schedules every item, they all go through the shared queue
+ *  - fan out:  every item schedules two more from its worker until the tree is complete,
+ *              so items go to the workers' own queues and are spread by stealing
+ * Each item does a little arithmetic and counts itself in a few locked counters, so the
+ * numbers include some contention on completion that a real workload would have as well.
+ *
+ * usage: threadpool_perf [max_threads]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "azure_c_shared_utility/threadpool.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/tickcounter.h"
+
+#define EXTERNAL_ITEM_COUNT     1000000
+#define FAN_OUT_DEPTH           20
+#define ITEM_WORK_ITERATIONS    200
+#define COUNTER_STRIPES         16
+
+typedef struct COUNTER_STRIPE_TAG
+{
+    LOCK_HANDLE lock;
+    size_t count;
+    size_t target;
+} COUNTER_STRIPE;
+
+typedef struct RUN_TAG
+{
+    THREADPOOL_HANDLE threadpool;
+    COUNTER_STRIPE stripes[COUNTER_STRIPES];
+    LOCK_HANDLE done_lock;
+    COND_HANDLE done;
+    size_t completed_stripes;
+} RUN;
+
+static RUN run;
+
+/*keeps the compiler from dropping the work*/
+static volatile uint32_t work_sink;
+
+static void do_work(uintptr_t seed)
+{
+    uint32_t x = (uint32_t)seed | 1;
+    int i;
+
+    for (i = 0; i < ITEM_WORK_ITERATIONS; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    work_sink = x;
+}
+
+static void count_item(uintptr_t seed)
+{
+    COUNTER_STRIPE* stripe = &run.stripes[seed % COUNTER_STRIPES];
+    bool stripe_done;
+
+    (void)Lock(stripe->lock);
+    stripe_done = (++stripe->count == stripe->target);
+    (void)Unlock(stripe->lock);
+
+    if (stripe_done)
+    {
+        (void)Lock(run.done_lock);
+        run.completed_stripes++;
+        (void)Condition_Post(run.done);
+        (void)Unlock(run.done_lock);
+    }
+}
+
+static void external_item(void* context)
+{
+    do_work((uintptr_t)context);
+    count_item((uintptr_t)context);
+}
+
+/*context is the index of the node in a complete binary tree of FAN_OUT_DEPTH levels, the root is 1*/
+static void fan_out_item(void* context)
+{
+    uintptr_t node = (uintptr_t)context;
+
+    if (node < ((uintptr_t)1 << (FAN_OUT_DEPTH - 1)))
+    {
+        if ((threadpool_schedule(run.threadpool, fan_out_item, (void*)(node * 2)) != 0) ||
+            (threadpool_schedule(run.threadpool, fan_out_item, (void*)(node * 2 + 1)) != 0))
+        {
+            (void)printf("threadpool_schedule failed\r\n");
+            exit(1);
+        }
+    }
+
+    do_work(node);
+    count_item(node);
+}
+
+static void wait_for_completion(void)
+{
+    (void)Lock(run.done_lock);
+    while (run.completed_stripes < COUNTER_STRIPES)
+    {
+        (void)Condition_Wait(run.done, run.done_lock, 0);
+    }
+    (void)Unlock(run.done_lock);
+}
+
+/*items first_item to first_item + item_count - 1 are counted in the stripe of their number*/
+static void reset_run(size_t first_item, size_t item_count)
+{
+    size_t i;
+
+    for (i = 0; i < COUNTER_STRIPES; i++)
+    {
+        run.stripes[i].count = 0;
+        run.stripes[i].target = 0;
+    }
+    for (i = first_item; i < first_item + item_count; i++)
+    {
+        run.stripes[i % COUNTER_STRIPES].target++;
+    }
+    run.completed_stripes = 0;
+}
+
+static double measure(TICK_COUNTER_HANDLE tick_counter, size_t threads, bool fan_out)
+{
+    tickcounter_ms_t start_ms;
+    tickcounter_ms_t end_ms;
+    size_t item_count = fan_out ? (((size_t)1 << FAN_OUT_DEPTH) - 1) : EXTERNAL_ITEM_COUNT;
+
+    reset_run(fan_out ? 1 : 0, item_count);
+    run.threadpool = threadpool_create(threads, threads);
+    if (run.threadpool == NULL)
+    {
+        (void)printf("threadpool_create failed\r\n");
+        exit(1);
+    }
+
+    (void)tickcounter_get_current_ms(tick_counter, &start_ms);
+    if (fan_out)
+    {
+        (void)threadpool_schedule(run.threadpool, fan_out_item, (void*)(uintptr_t)1);
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < item_count; i++)
+        {
+            if (threadpool_schedule(run.threadpool, external_item, (void*)(uintptr_t)i) != 0)
+            {
+                (void)printf("threadpool_schedule failed\r\n");
+                exit(1);
+            }
+        }
+    }
+    wait_for_completion();
+    (void)tickcounter_get_current_ms(tick_counter, &end_ms);
+
+    threadpool_destroy(run.threadpool);
+
+    return (double)item_count / ((double)(end_ms - start_ms + 1) / 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+    size_t max_threads = (argc > 1) ? (size_t)atoi(argv[1]) : 8;
+    TICK_COUNTER_HANDLE tick_counter = tickcounter_create();
+    size_t threads;
+    size_t i;
+
+    for (i = 0; i < COUNTER_STRIPES; i++)
+    {
+        run.stripes[i].lock = Lock_Init();
+    }
+    run.done_lock = Lock_Init();
+    run.done = Condition_Init();
+
+    (void)printf("threads    external items/s    fan out items/s\r\n");
+    for (threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double external = measure(tick_counter, threads, false);
+        double fan_out = measure(tick_counter, threads, true);
+        (void)printf("%7lu %19.0f %18.0f\r\n", (unsigned long)threads, external, fan_out);
+    }
+
+    Condition_Deinit(run.done);
+    (void)Lock_Deinit(run.done_lock);
+    for (i = 0; i < COUNTER_STRIPES; i++)
+    {
+        (void)Lock_Deinit(run.stripes[i].lock);
+    }
+    tickcounter_destroy(tick_counter);
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*
+ * Measures utf8_checker_is_valid_utf8 throughput on JSON payloads with each of the functions that
+ * skip ASCII runs:
+ *  - scalar: 8 bytes at a time in a 64-bit word (also what NO_UTF8_CHECKER_SIMD builds use)
+ *  - SSE2:   16 bytes at a time (x86)
+ *  - AVX2:   64, then 32 bytes at a time (x86, when CPUID reports AVX2)
+ *  - NEON:   16 bytes at a time (aarch64)
+ * The payloads are JSON telemetry documents: all ASCII, ASCII with a few accented letters in the
+ * string values, and mostly CJK text in the string values. Multi-byte code points go through the
+ * same DFA whatever the function, so the last payload mostly measures the DFA.
+ * utf8_checker.c is included so the sample can switch the function the checker uses.
+ *
+ * usage: utf8_checker_perf [megabytes_per_payload]
+ */
+
+#define utf8_checker_is_valid_utf8 perf_utf8_checker_is_valid_utf8
+#define utf8_checker_state_init perf_utf8_checker_state_init
+#define utf8_checker_validate_fragment perf_utf8_checker_validate_fragment
+#define utf8_checker_is_complete perf_utf8_checker_is_complete
+
+#include "utf8_checker.c"
+
+#include <stdio.h>
+#include "azure_c_shared_utility/tickcounter.h"
+
+#define MAX_PAYLOAD_SIZE    (64 * 1024)
+
+typedef struct PAYLOAD_TAG
+{
+    const char* name;
+    const char* record;
+} PAYLOAD;
+
+typedef struct ASCII_PREFIX_FUNCTION_TAG
+{
+    const char* name;
+    UTF8_CHECKER_ASCII_PREFIX_FUNCTION function;
+} ASCII_PREFIX_FUNCTION;
+
+/*each payload repeats its record, as an array of telemetry points would*/
+static const PAYLOAD payloads[] =
+{
+    { "ASCII", "{\"deviceId\":\"thermostat-0042\",\"timestamp\":\"2026-10-19T08:15:30.125Z\",\"temperature\":21.5,\"humidity\":48,\"status\":\"ok\",\"location\":\"building 7, floor 3\"}," },
+    { "accented", "{\"deviceId\":\"thermostat-0042\",\"timestamp\":\"2026-10-19T08:15:30.125Z\",\"temp\\u00e9rature\":21.5,\"unit\":\"\xC2\xB0" "C\",\"status\":\"ok\",\"location\":\"b\xC3\xA2timent 7, \xC3\xA9tage 3\"}," },
+    { "CJK", "{\"deviceId\":\"thermostat-0042\",\"name\":\"\xE6\xB8\xA9\xE5\xBA\xA6\xE8\xA8\x88\",\"location\":\"\xE6\x9D\xB1\xE4\xBA\xAC\xE9\x83\xBD\xE6\xB8\xAF\xE5\x8C\xBA\xE8\x8A\x9D\xE6\xB5\xA6\",\"status\":\"\xE6\xAD\xA3\xE5\xB8\xB8\xE3\x81\xAB\xE5\x8B\x95\xE4\xBD\x9C\xE4\xB8\xAD\"}," }
+};
+
+/*every record fits in the smallest size*/
+static const size_t payload_sizes[] = { 256, 4 * 1024, MAX_PAYLOAD_SIZE };
+
+static size_t fill_payload(unsigned char* buffer, const char* record, size_t size)
+{
+    size_t record_length = strlen(record);
+    size_t used = 0;
+
+    /*whole records only, so no code point is cut; the trailing comma is left in, it is still UTF-8*/
+    buffer[used++] = '[';
+    while (used + record_length + 1 <= size)
+    {
+        (void)memcpy(buffer + used, record, record_length);
+        used += record_length;
+    }
+    buffer[used++] = ']';
+
+    return used;
+}
+
+static double measure(TICK_COUNTER_HANDLE tick_counter, const unsigned char* payload, size_t payload_size, size_t total_bytes)
+{
+    size_t check_count = (total_bytes + payload_size - 1) / payload_size;
+    tickcounter_ms_t start_ms;
+    tickcounter_ms_t end_ms;
+    size_t i;
+
+    (void)tickcounter_get_current_ms(tick_counter, &start_ms);
+    for (i = 0; i < check_count; i++)
+    {
+        if (!perf_utf8_checker_is_valid_utf8(payload, payload_size))
+        {
+            (void)printf("a valid payload was rejected\r\n");
+            exit(1);
+        }
+    }
+    (void)tickcounter_get_current_ms(tick_counter, &end_ms);
+
+    return ((double)(check_count * payload_size) / (1024.0 * 1024.0)) / ((double)(end_ms - start_ms + 1) / 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+    size_t megabytes = (argc > 1) ? (size_t)atoi(argv[1]) : 256;
+    TICK_COUNTER_HANDLE tick_counter = tickcounter_create();
+    unsigned char* payload = (unsigned char*)malloc(MAX_PAYLOAD_SIZE);
+    ASCII_PREFIX_FUNCTION functions[3];
+    size_t function_count = 0;
+    int result;
+
+    functions[function_count].name = "scalar";
+    functions[function_count++].function = ascii_prefix_words;
+#if defined(UTF8_CHECKER_USE_X86_SIMD)
+    functions[function_count].name = "SSE2";
+    functions[function_count++].function = ascii_prefix_sse2;
+    if (has_avx2())
+    {
+        functions[function_count].name = "AVX2";
+        functions[function_count++].function = ascii_prefix_avx2;
+    }
+#elif defined(UTF8_CHECKER_USE_NEON)
+    functions[function_count].name = "NEON";
+    functions[function_count++].function = ascii_prefix_neon;
+#endif
+
+    if (megabytes == 0)
+    {
+        megabytes = 256;
+    }
+
+    if ((tick_counter == NULL) || (payload == NULL))
+    {
+        (void)printf("initialization failed\r\n");
+        result = 1;
+    }
+    else
+    {
+        size_t i;
+        size_t j;
+        size_t k;
+
+        (void)printf("payload   bytes ");
+        for (k = 0; k < function_count; k++)
+        {
+            (void)printf(" %8s MiB/s", functions[k].name);
+        }
+        (void)printf("\r\n");
+
+        for (i = 0; i < sizeof(payloads) / sizeof(payloads[0]); i++)
+        {
+            for (j = 0; j < sizeof(payload_sizes) / sizeof(payload_sizes[0]); j++)
+            {
+                size_t payload_size = fill_payload(payload, payloads[i].record, payload_sizes[j]);
+
+                (void)printf("%-8s %6lu ", payloads[i].name, (unsigned long)payload_size);
+                for (k = 0; k < function_count; k++)
+                {
+                    ascii_prefix = functions[k].function;
+                    (void)printf(" %14.0f", measure(tick_counter, payload, payload_size, megabytes * 1024 * 1024));
+                }
+                (void)printf("\r\n");
+            }
+        }
+        result = 0;
+    }
+
+    free(payload);
+    tickcounter_destroy(tick_counter);
+
+    return result;
+}
@@ -0,0 +1,474 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/async_logger.h"
+#include "azure_c_shared_utility/eventcount.h"
+#include "azure_c_shared_utility/log_arguments.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+// Include the platform-specific file that defines atomic functionality
+#include "queue_atomic_os.h"
+
+/*
+ * The records live in a bounded ring shared by all the logging threads, with one sequence
+ * number per record (a multi-producer variant of spsc_ring). A logging thread claims the
+ * record at enqueue_position with a compare exchange once the sequence of that record says
+ * it is free, fills it and publishes it by moving the sequence on; the writer thread takes
+ * the records in order as their sequences say they are published and gives them back.
+ *
+ * A logging thread does not format the message: it stores the format pointer and the arguments
+ * its conversions consume with log_arguments_capture, and the writer thread renders the message
+ * with log_arguments_format before writing it.
+ *
+ * producers counts the threads inside async_logger_log, plus ASYNC_LOGGER_RUNNING while the
+ * logger runs. A thread only enters while the bit is set, so once async_logger_stop clears it
+ * and the count drops to 0 every claimed record has been published and none will be claimed.
+ */
+#define ASYNC_LOGGER_CACHE_LINE_SIZE    64
+#define ASYNC_LOGGER_RUNNING            (((size_t)-1 >> 1) + 1)
+
+typedef struct LOG_RECORD_TAG
+{
+    QUEUE_ATOMIC_TYPE(size_t) sequence;
+    time_t time;
+    LOG_CATEGORY log_category;
+    /*__FILE__, FUNC_NAME and the format string literal, which outlive the record*/
+    const char* file;
+    const char* func;
+    const char* format;
+    int line;
+    unsigned int options;
+    bool arguments_truncated;
+    size_t arguments_size;
+    unsigned char arguments[ASYNC_LOGGER_ARGUMENTS_SIZE];
+} LOG_RECORD;
+
+typedef struct ASYNC_LOGGER_TAG
+{
+    /*set by async_logger_start before the writer thread and the log function exist*/
+    LOG_RECORD* records;
+    size_t mask;
+    FILE* output;
+    LOGGER_LOG previous_log_function;
+    EVENTCOUNT_HANDLE records_available;
+    THREAD_HANDLE writer;
+    unsigned char shared_pad[ASYNC_LOGGER_CACHE_LINE_SIZE];
+
+    /*written by the writer thread*/
+    size_t dequeue_position;
+    size_t reported_dropped;
+    char message[ASYNC_LOGGER_MESSAGE_SIZE];
+    QUEUE_ATOMIC_TYPE(size_t) written;
+    unsigned char writer_pad[ASYNC_LOGGER_CACHE_LINE_SIZE];
+
+    /*written by the logging threads*/
+    QUEUE_ATOMIC_TYPE(size_t) enqueue_position;
+    QUEUE_ATOMIC_TYPE(size_t) producers;
+    QUEUE_ATOMIC_TYPE(size_t) dropped;
+    QUEUE_ATOMIC_TYPE(size_t) truncated;
+    unsigned char producer_pad[ASYNC_LOGGER_CACHE_LINE_SIZE];
+} ASYNC_LOGGER;
+
+static ASYNC_LOGGER async_logger;
+
+static void add(QUEUE_ATOMIC_TYPE(size_t)* counter, size_t value)
+{
+    size_t current = QUEUE_ATOMIC_LOAD(size_t, *counter);
+    int added = 0;
+    while (!added)
+    {
+        QUEUE_ATOMIC_COMPARE_EXCHANGE(size_t, *counter, current, current + value, added);
+        if (!added)
+        {
+            current = QUEUE_ATOMIC_LOAD(size_t, *counter);
+        }
+    }
+}
+
+static bool enter_producer(void)
+{
+    size_t current = QUEUE_ATOMIC_LOAD(size_t, async_logger.producers);
+    int entered = 0;
+    while (((current & ASYNC_LOGGER_RUNNING) != 0) && !entered)
+    {
+        QUEUE_ATOMIC_COMPARE_EXCHANGE(size_t, async_logger.producers, current, current + 1, entered);
+        if (!entered)
+        {
+            current = QUEUE_ATOMIC_LOAD(size_t, async_logger.producers);
+        }
+    }
+
+    return entered != 0;
+}
+
+/*returns the claimed record, or NULL if the ring is full*/
+static LOG_RECORD* claim_record(size_t* position)
+{
+    LOG_RECORD* result = NULL;
+    bool full = false;
+    size_t current = QUEUE_ATOMIC_LOAD(size_t, async_logger.enqueue_position);
+
+    while ((result == NULL) && !full)
+    {
+        LOG_RECORD* record = &async_logger.records[current & async_logger.mask];
+        size_t sequence = QUEUE_ATOMIC_LOAD(size_t, record->sequence);
+        if (sequence == current)
+        {
+            int claimed;
+            QUEUE_ATOMIC_COMPARE_EXCHANGE(size_t, async_logger.enqueue_position, current, current + 1, claimed);
+            if (claimed)
+            {
+                result = record;
+                *position = current;
+            }
+            else
+            {
+                current = QUEUE_ATOMIC_LOAD(size_t, async_logger.enqueue_position);
+            }
+        }
+        else if ((intptr_t)(sequence - current) < 0)
+        {
+            /*the record still holds the one logged a lap ago*/
+            full = true;
+        }
+        else
+        {
+            /*another thread claimed it first*/
+            current = QUEUE_ATOMIC_LOAD(size_t, async_logger.enqueue_position);
+        }
+    }
+
+    return result;
+}
+
+/*writes what consolelogger_log prints before the message*/
+static void write_prefix(time_t record_time, LOG_CATEGORY log_category, const char* file, const char* func, int line)
+{
+    switch (log_category)
+    {
+    case AZ_LOG_INFO:
+        (void)fprintf(async_logger.output, "Info: ");
+        break;
+    case AZ_LOG_ERROR:
+        (void)fprintf(async_logger.output, "Error: Time:%.24s File:%s Func:%s Line:%d ", ctime(&record_time), file, func, line);
+        break;
+    default:
+        break;
+    }
+}
+
+/*writes the published records in order and returns how many it wrote*/
+static size_t write_published_records(void)
+{
+    size_t result = 0;
+    LOG_RECORD* record = &async_logger.records[async_logger.dequeue_position & async_logger.mask];
+
+    while (QUEUE_ATOMIC_LOAD(size_t, record->sequence) == async_logger.dequeue_position + 1)
+    {
+        /* Codes_SRS_ASYNC_LOGGER_01_017: [ The writer thread shall format the message from the format and the stored arguments by calling log_arguments_format, keeping as much of it as fits in ASYNC_LOGGER_MESSAGE_SIZE. ]*/
+        if (record->format == NULL)
+        {
+            async_logger.message[0] = '\0';
+        }
+        else if (!log_arguments_format(async_logger.message, sizeof(async_logger.message), record->format, record->arguments, record->arguments_size, record->arguments_truncated))
+        {
+            /* Codes_SRS_ASYNC_LOGGER_01_019: [ If the arguments did not fit in ASYNC_LOGGER_ARGUMENTS_SIZE or the message does not fit in ASYNC_LOGGER_MESSAGE_SIZE, the record shall be counted as truncated. ]*/
+            add(&async_logger.truncated, 1);
+        }
+
+        write_prefix(record->time, record->log_category, record->file, record->func, record->line);
+        (void)fputs(async_logger.message, async_logger.output);
+        if (record->options & LOG_LINE)
+        {
+            (void)fputs("\r\n", async_logger.output);
+        }
+
+        /*frees the record for the lap after this one*/
+        QUEUE_ATOMIC_STORE(size_t, record->sequence, async_logger.dequeue_position + async_logger.mask + 1);
+        async_logger.dequeue_position++;
+        result++;
+        record = &async_logger.records[async_logger.dequeue_position & async_logger.mask];
+    }
+
+    if (result > 0)
+    {
+        QUEUE_ATOMIC_STORE(size_t, async_logger.written, QUEUE_ATOMIC_LOAD(size_t, async_logger.written) + result);
+    }
+
+    return result;
+}
+
+/*writes how many records were dropped since the last such line, and returns whether it wrote one*/
+static bool report_dropped_records(void)
+{
+    bool result;
+    size_t dropped = QUEUE_ATOMIC_LOAD(size_t, async_logger.dropped);
+
+    if (dropped == async_logger.reported_dropped)
+    {
+        result = false;
+    }
+    else
+    {
+        write_prefix(time(NULL), AZ_LOG_ERROR, __FILE__, FUNC_NAME, __LINE__);
+        (void)fprintf(async_logger.output, "async_logger dropped %lu log records\r\n", (unsigned long)(dropped - async_logger.reported_dropped));
+        async_logger.reported_dropped = dropped;
+        result = true;
+    }
+
+    return result;
+}
+
+static int writer_thread(void* context)
+{
+    bool stopped = false;
+    (void)context;
+
+    while (!stopped)
+    {
+        size_t written = write_published_records();
+
+        if (report_dropped_records() || (written > 0))
+        {
+            (void)fflush(async_logger.output);
+        }
+
+        if (written == 0)
+        {
+            uint32_t key = eventcount_prepare_wait(async_logger.records_available);
+            LOG_RECORD* next = &async_logger.records[async_logger.dequeue_position & async_logger.mask];
+
+            /*checked again after registering, so a record published in between is not missed*/
+            stopped = (QUEUE_ATOMIC_LOAD(size_t, async_logger.producers) == 0);
+            if (stopped ||
+                (QUEUE_ATOMIC_LOAD(size_t, next->sequence) == async_logger.dequeue_position + 1))
+            {
+                eventcount_cancel_wait(async_logger.records_available);
+            }
+            else
+            {
+                (void)eventcount_wait(async_logger.records_available, key, 0);
+            }
+        }
+    }
+
+    /*no thread can publish anymore, write whatever was published since the last pass; async_logger_stop reports the drops and flushes*/
+    (void)write_published_records();
+    return 0;
+}
+
+int async_logger_start(FILE* output, size_t capacity)
+{
+    int result;
+
+    if ((output == NULL) || (capacity == 0) || (capacity > (SIZE_MAX / 2) / sizeof(LOG_RECORD)))
+    {
+        /* Codes_SRS_ASYNC_LOGGER_01_001: [ If output is NULL or capacity is 0 or too large for the records to be allocated, async_logger_start shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: output=%p, capacity=%lu", output, (unsigned long)capacity);
+        result = __FAILURE__;
+    }
+    else if (async_logger.records != NULL)
+    {
+        /* Codes_SRS_ASYNC_LOGGER_01_002: [ If the logger is already started, async_logger_start shall fail and return a non-zero value. ]*/
+        LogError("async_logger is already started");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_ASYNC_LOGGER_01_003: [ async_logger_start shall allocate a ring of capacity records rounded up to a power of 2. ]*/
+        size_t rounded_capacity = 1;
+        while (rounded_capacity < capacity)
+        {
+            rounded_capacity *= 2;
+        }
+
+        if ((async_logger.records = (LOG_RECORD*)malloc(rounded_capacity * sizeof(LOG_RECORD))) == NULL)
+        {
+            /* Codes_SRS_ASYNC_LOGGER_01_006: [ If any error occurs, async_logger_start shall free what it allocated and return a non-zero value. ]*/
+            LogError("Cannot allocate %lu log records", (unsigned long)rounded_capacity);
+            result = __FAILURE__;
+        }
+        else if ((async_logger.records_available = eventcount_create()) == NULL)
+        {
+            LogError("eventcount_create failed");
+            free(async_logger.records);
+            async_logger.records = NULL;
+            result = __FAILURE__;
+        }
+        else
+        {
+            size_t i;
+            for (i = 0; i < rounded_capacity; i++)
+            {
+                QUEUE_ATOMIC_INIT(size_t, async_logger.records[i].sequence, i);
+            }
+
+            async_logger.mask = rounded_capacity - 1;
+            async_logger.output = output;
+            async_logger.dequeue_position = 0;
+            async_logger.reported_dropped = 0;
+            QUEUE_ATOMIC_STORE(size_t, async_logger.written, 0);
+            QUEUE_ATOMIC_STORE(size_t, async_logger.enqueue_position, 0);
+            QUEUE_ATOMIC_STORE(size_t, async_logger.dropped, 0);
+            QUEUE_ATOMIC_STORE(size_t, async_logger.truncated, 0);
+            QUEUE_ATOMIC_STORE(size_t, async_logger.producers, ASYNC_LOGGER_RUNNING);
+
+            /* Codes_SRS_ASYNC_LOGGER_01_004: [ async_logger_start shall start a writer thread that writes the records to output. ]*/
+            if (ThreadAPI_Create(&async_logger.writer, writer_thread, NULL) != THREADAPI_OK)
+            {
+                LogError("ThreadAPI_Create failed");
+                QUEUE_ATOMIC_STORE(size_t, async_logger.producers, 0);
+                eventcount_destroy(async_logger.records_available);
+                free(async_logger.records);
+                async_logger.records = NULL;
+                result = __FAILURE__;
+            }
+            else
+            {
+                /* Codes_SRS_ASYNC_LOGGER_01_005: [ async_logger_start shall install async_logger_log with xlogging_set_log_function and return 0. ]*/
+                async_logger.previous_log_function = xlogging_get_log_function();
+                xlogging_set_log_function(async_logger_log);
+                result = 0;
+            }
+        }
+    }
+
+    return result;
+}
+
+void async_logger_stop(void)
+{
+    if (async_logger.records == NULL)
+    {
+        /* Codes_SRS_ASYNC_LOGGER_01_007: [ If the logger is not started, async_logger_stop shall return. ]*/
+        LogError("async_logger is not started");
+    }
+    else
+    {
+        size_t current = QUEUE_ATOMIC_LOAD(size_t, async_logger.producers);
+        int stopped = 0;
+        int thread_result;
+
+        /* Codes_SRS_ASYNC_LOGGER_01_008: [ async_logger_stop shall put back the log function that was installed before async_logger_start. ]*/
+        xlogging_set_log_function(async_logger.previous_log_function);
+
+        /* Codes_SRS_ASYNC_LOGGER_01_009: [ async_logger_stop shall make async_logger_log ignore calls that start after this point and wait for the calls in progress to return. ]*/
+        while (!stopped)
+        {
+            QUEUE_ATOMIC_COMPARE_EXCHANGE(size_t, async_logger.producers, current, current & ~ASYNC_LOGGER_RUNNING, stopped);
+            if (!stopped)
+            {
+                current = QUEUE_ATOMIC_LOAD(size_t, async_logger.producers);
+            }
+        }
+
+        while (QUEUE_ATOMIC_LOAD(size_t, async_logger.producers) != 0)
+        {
+            ThreadAPI_Sleep(1);
+        }
+
+        /* Codes_SRS_ASYNC_LOGGER_01_010: [ async_logger_stop shall wait for the writer thread to write every record left in the ring and flush output. ]*/
+        eventcount_notify_all(async_logger.records_available);
+        if (ThreadAPI_Join(async_logger.writer, &thread_result) != THREADAPI_OK)
+        {
+            LogError("ThreadAPI_Join failed");
+        }
+        else
+        {
+            /* Codes_SRS_ASYNC_LOGGER_01_020: [ Once the writer thread has stopped, async_logger_stop shall write how many records were dropped since the writer thread last reported drops, then flush output. ]*/
+            (void)report_dropped_records();
+            (void)fflush(async_logger.output);
+        }
+
+        /* Codes_SRS_ASYNC_LOGGER_01_011: [ async_logger_stop shall free the ring. ]*/
+        eventcount_destroy(async_logger.records_available);
+        free(async_logger.records);
+        async_logger.records = NULL;
+    }
+}
+
+int async_logger_get_statistics(ASYNC_LOGGER_STATISTICS* statistics)
+{
+    int result;
+
+    if (statistics == NULL)
+    {
+        /* Codes_SRS_ASYNC_LOGGER_01_012: [ If statistics is NULL, async_logger_get_statistics shall fail and return a non-zero value. ]*/
+        LogError("NULL statistics");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_ASYNC_LOGGER_01_013: [ async_logger_get_statistics shall fill statistics with the number of records written, dropped and truncated since the last async_logger_start and return 0. ]*/
+        statistics->written = QUEUE_ATOMIC_LOAD(size_t, async_logger.written);
+        statistics->dropped = QUEUE_ATOMIC_LOAD(size_t, async_logger.dropped);
+        statistics->truncated = QUEUE_ATOMIC_LOAD(size_t, async_logger.truncated);
+        result = 0;
+    }
+
+    return result;
+}
+
+#if defined(__GNUC__)
+__attribute__ ((format (printf, 6, 7)))
+#endif
+void async_logger_log(LOG_CATEGORY log_category, const char* file, const char* func, int line, unsigned int options, const char* format, ...)
+{
+    if (!enter_producer())
+    {
+        /* Codes_SRS_ASYNC_LOGGER_01_014: [ If the logger is not running, async_logger_log shall return. ]*/
+    }
+    else
+    {
+        size_t position = 0;
+        LOG_RECORD* record = claim_record(&position);
+        if (record == NULL)
+        {
+            /* Codes_SRS_ASYNC_LOGGER_01_015: [ If the ring is full, async_logger_log shall count the record as dropped, wake the writer thread so that it reports the drop, and return. ]*/
+            add(&async_logger.dropped, 1);
+            eventcount_notify_one(async_logger.records_available);
+        }
+        else
+        {
+            LOG_ARGUMENTS arguments;
+            va_list args;
+
+            /* Codes_SRS_ASYNC_LOGGER_01_016: [ async_logger_log shall capture the time, log_category, file, func, line, options and format, and store the arguments the conversions of format consume without formatting them by calling log_arguments_capture. ]*/
+            record->time = time(NULL);
+            record->log_category = log_category;
+            record->file = file;
+            record->func = func;
+            record->format = format;
+            record->line = line;
+            record->options = options;
+
+            arguments.buffer = record->arguments;
+            arguments.size = sizeof(record->arguments);
+            arguments.used = 0;
+            arguments.truncated = false;
+            if (format != NULL)
+            {
+                va_start(args, format);
+                log_arguments_capture(&arguments, format, args);
+                va_end(args);
+            }
+            record->arguments_size = arguments.used;
+            record->arguments_truncated = arguments.truncated;
+
+            /* Codes_SRS_ASYNC_LOGGER_01_018: [ async_logger_log shall publish the record and wake the writer thread. ]*/
+            QUEUE_ATOMIC_STORE(size_t, record->sequence, position + 1);
+            eventcount_notify_one(async_logger.records_available);
+        }
+
+        add(&async_logger.producers, (size_t)-1);
+    }
+}
@@ -4,8 +4,10 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include <ctype.h>
 #include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/strings.h"
@@ -56,17 +58,78 @@ static unsigned char convert_value_to_base32_char(unsigned char value)
     {
         result = 0xFF;
     }
-    else if (value >= 97 && value <= 123)
+    else if (value >= 97 && value <= 122)
     {
         result = 0x00 + (value - 97);
     }
-    else // value > 123
+    else // value > 122
     {
         result = 0xFF;
     }
     return result;
 }
 
+/* Encodes a block of 1 to 5 bytes into 8 characters, padded with = */
+static void base32_encode_block(const unsigned char* iterator, size_t block_len, char* out)
+{
+    unsigned char pos1 = 0;
+    unsigned char pos2 = 0;
+    unsigned char pos3 = 0;
+    unsigned char pos4 = 0;
+    unsigned char pos5 = 0;
+    unsigned char pos6 = 0;
+    unsigned char pos7 = 0;
+    unsigned char pos8 = 0;
+
+    // Fall through switch block to process the 5 (or smaller) block
+    switch (block_len)
+    {
+    case 5:
+        pos8 = (iterator[4] & 0x1f);
+        pos7 = ((iterator[4] & 0xe0) >> 5);
+        // fall through
+    case 4:
+        pos7 |= ((iterator[3] & 0x03) << 3);
+        pos6 = ((iterator[3] & 0x7c) >> 2);
+        pos5 = ((iterator[3] & 0x80) >> 7);
+        // fall through
+    case 3:
+        pos5 |= ((iterator[2] & 0x0f) << 1);
+        pos4 = ((iterator[2] & 0xf0) >> 4);
+        // fall through
+    case 2:
+        pos4 |= ((iterator[1] & 0x01) << 4);
+        pos3 = ((iterator[1] & 0x3e) >> 1);
+        pos2 = ((iterator[1] & 0xc0) >> 6);
+        // fall through
+    case 1:
+        pos2 |= ((iterator[0] & 0x07) << 2);
+        pos1 = ((iterator[0] & 0xf8) >> 3);
+        break;
+    }
+
+    /* Codes_SRS_BASE32_07_012: [ If the src_size is not divisible by 8, base32_encode_impl shall pad the remaining places with =. ] */
+    switch (block_len)
+    {
+        case 1: pos3 = pos4 = 32; // fall through
+        case 2: pos5 = 32; // fall through
+        case 3: pos6 = pos7 = 32; // fall through
+        case 4: pos8 = 32; // fall through
+        case 5:
+            break;
+    }
+
+    /* Codes_SRS_BASE32_07_011: [ base32_encode_impl shall then map the 5 bit chunks into one of the BASE32 values (a-z,2,3,4,5,6,7) values. ] */
+    out[0] = BASE32_VALUES[pos1];
+    out[1] = BASE32_VALUES[pos2];
+    out[2] = BASE32_VALUES[pos3];
+    out[3] = BASE32_VALUES[pos4];
+    out[4] = BASE32_VALUES[pos5];
+    out[5] = BASE32_VALUES[pos6];
+    out[6] = BASE32_VALUES[pos7];
+    out[7] = BASE32_VALUES[pos8];
+}
+
 static char* base32_encode_impl(const unsigned char* source, size_t src_size)
 {
     char* result;
@@ -83,14 +146,6 @@ static char* base32_encode_impl(const unsigned char* source, size_t src_size)
         const unsigned char* iterator = source;
         size_t block_len = 0;
         size_t result_len = 0;
-        unsigned char pos1 = 0;
-        unsigned char pos2 = 0;
-        unsigned char pos3 = 0;
-        unsigned char pos4 = 0;
-        unsigned char pos5 = 0;
-        unsigned char pos6 = 0;
-        unsigned char pos7 = 0;
-        unsigned char pos8 = 0;
 
         memset(result, 0, output_len + 1);
 
@@ -98,59 +153,45 @@ static char* base32_encode_impl(const unsigned char* source, size_t src_size)
         /* Codes_SRS_BASE32_07_010: [ base32_encode_impl shall look through source and separate each block into 5 bit chunks ] */
         while (src_size >= 1 && result != NULL)
         {
-            pos1 = pos2 = pos3 = pos4 = pos5 = pos6 = pos7 = pos8 = 0;
             block_len = src_size > TARGET_BLOCK_SIZE ? TARGET_BLOCK_SIZE : src_size;
-            // Fall through switch block to process the 5 (or smaller) block
-            switch (block_len)
-            {
-            case 5:
-                pos8 = (iterator[4] & 0x1f);
-                pos7 = ((iterator[4] & 0xe0) >> 5);
-                // fall through
-            case 4:
-                pos7 |= ((iterator[3] & 0x03) << 3);
-                pos6 = ((iterator[3] & 0x7c) >> 2);
-                pos5 = ((iterator[3] & 0x80) >> 7);
-                // fall through
-            case 3:
-                pos5 |= ((iterator[2] & 0x0f) << 1);
-                pos4 = ((iterator[2] & 0xf0) >> 4);
-                // fall through
-            case 2:
-                pos4 |= ((iterator[1] & 0x01) << 4);
-                pos3 = ((iterator[1] & 0x3e) >> 1);
-                pos2 = ((iterator[1] & 0xc0) >> 6);
-                // fall through
-            case 1:
-                pos2 |= ((iterator[0] & 0x07) << 2);
-                pos1 = ((iterator[0] & 0xf8) >> 3);
-                break;
-            }
+            base32_encode_block(iterator, block_len, result + result_len);
+            result_len += 8;
             // Move the iterator the block size
             iterator += block_len;
             // and decrement the src_size;
             src_size -= block_len;
+        }
+    }
+    return result;
+}
+
+/* Packs 8 base32 values into 5 bytes and returns how many of them remain once the padding is removed */
+static size_t base32_decode_block(const unsigned char* input, unsigned char* dest_buff)
+{
+    size_t result = TARGET_BLOCK_SIZE;
 
-            /* Codes_SRS_BASE32_07_012: [ If the src_size is not divisible by 8, base32_encode_impl shall pad the remaining places with =. ] */
-            switch (block_len)
+    *dest_buff++ = ((input[0] & 0x1f) << 3) | ((input[1] & 0x1c) >> 2);
+    *dest_buff++ = ((input[1] & 0x03) << 6) | ((input[2] & 0x1f) << 1) | ((input[3] & 0x10) >> 4);
+    *dest_buff++ = ((input[3] & 0x0f) << 4) | ((input[4] & 0x1e) >> 1);
+    *dest_buff++ = ((input[4] & 0x01) << 7) | ((input[5] & 0x1f) << 2) | ((input[6] & 0x18) >> 3);
+    *dest_buff++ = ((input[6] & 0x07) << 5) | (input[7] & 0x1f);
+    // If there is padding remove it
+    // Because we are packing 5 bytes into an 8 byte variable we need to check every other
+    // variable for padding
+    if (input[7] == BASE32_EQUAL_SIGN)
+    {
+        --result;
+        if (input[5] == BASE32_EQUAL_SIGN)
+        {
+            --result;
+            if (input[4] == BASE32_EQUAL_SIGN)
             {
-                case 1: pos3 = pos4 = 32; // fall through
-                case 2: pos5 = 32; // fall through
-                case 3: pos6 = pos7 = 32; // fall through
-                case 4: pos8 = 32; // fall through
-                case 5:
-                    break;
+                --result;
+                if (input[2] == BASE32_EQUAL_SIGN)
+                {
+                    --result;
+                }
             }
-
-            /* Codes_SRS_BASE32_07_011: [ base32_encode_impl shall then map the 5 bit chunks into one of the BASE32 values (a-z,2,3,4,5,6,7) values. ] */
-            result[result_len++] = BASE32_VALUES[pos1];
-            result[result_len++] = BASE32_VALUES[pos2];
-            result[result_len++] = BASE32_VALUES[pos3];
-            result[result_len++] = BASE32_VALUES[pos4];
-            result[result_len++] = BASE32_VALUES[pos5];
-            result[result_len++] = BASE32_VALUES[pos6];
-            result[result_len++] = BASE32_VALUES[pos7];
-            result[result_len++] = BASE32_VALUES[pos8];
         }
     }
     return result;
@@ -220,31 +261,8 @@ static BUFFER_HANDLE base32_decode_impl(const char* source)
                 else
                 {
                     // Codes_SRS_BASE32_07_025: [ base32_decode_impl shall group 5 bytes at a time into the temp buffer. ]
-                    *dest_buff++ = ((input[0] & 0x1f) << 3) | ((input[1] & 0x1c) >> 2);
-                    *dest_buff++ = ((input[1] & 0x03) << 6) | ((input[2] & 0x1f) << 1) | ((input[3] & 0x10) >> 4);
-                    *dest_buff++ = ((input[3] & 0x0f) << 4) | ((input[4] & 0x1e) >> 1);
-                    *dest_buff++ = ((input[4] & 0x01) << 7) | ((input[5] & 0x1f) << 2) | ((input[6] & 0x18) >> 3);
-                    *dest_buff++ = ((input[6] & 0x07) << 5) | (input[7] & 0x1f);
-                    dest_size += TARGET_BLOCK_SIZE;
-                    // If there is padding remove it
-                    // Because we are packing 5 bytes into an 8 byte variable we need to check every other
-                    // variable for padding
-                    if (input[7] == BASE32_EQUAL_SIGN)
-                    {
-                        --dest_size;
-                        if (input[5] == BASE32_EQUAL_SIGN)
-                        {
-                            --dest_size;
-                            if (input[4] == BASE32_EQUAL_SIGN)
-                            {
-                                --dest_size;
-                                if (input[2] == BASE32_EQUAL_SIGN)
-                                {
-                                    --dest_size;
-                                }
-                            }
-                        }
-                    }
+                    dest_size += base32_decode_block(input, dest_buff);
+                    dest_buff += TARGET_BLOCK_SIZE;
                 }
             }
 
@@ -390,3 +408,250 @@ STRING_HANDLE Base32_Encode(BUFFER_HANDLE source)
     /* Codes_SRS_BASE32_07_002: [ If successful Base32_Encode shall return the base32 value of source. ] */
     return result;
 }
+
+void Base32_Encode_Stream_Init(BASE32_ENCODE_STREAM* stream)
+{
+    if (stream == NULL)
+    {
+        /* Codes_SRS_BASE32_01_001: [ If stream is NULL Base32_Encode_Stream_Init shall return. ] */
+        LogError("Failure: Invalid input parameter stream");
+    }
+    else
+    {
+        /* Codes_SRS_BASE32_01_002: [ Base32_Encode_Stream_Init shall set stream to hold no bytes. ] */
+        stream->pendingCount = 0;
+    }
+}
+
+int Base32_Encode_Stream_Update(BASE32_ENCODE_STREAM* stream, const unsigned char* source, size_t size, char* destination, size_t destinationSize, size_t* written)
+{
+    int result;
+    size_t block_count;
+
+    if ((stream == NULL) || (written == NULL) || ((source == NULL) && (size > 0)) || ((destination == NULL) && (destinationSize > 0)))
+    {
+        /* Codes_SRS_BASE32_01_003: [ If stream or written is NULL, or source is NULL while size is not 0, or destination is NULL while destinationSize is not 0, Base32_Encode_Stream_Update shall fail and return a non-zero value. ] */
+        LogError("Failure: Invalid input parameter stream=%p, source=%p, destination=%p, written=%p", stream, source, destination, written);
+        result = __FAILURE__;
+    }
+    else if (((block_count = (size / TARGET_BLOCK_SIZE) + (((size % TARGET_BLOCK_SIZE) + stream->pendingCount) / TARGET_BLOCK_SIZE)) > (SIZE_MAX / BASE32_INPUT_SIZE)) ||
+        (destinationSize < (block_count * BASE32_INPUT_SIZE)))
+    {
+        /* Codes_SRS_BASE32_01_004: [ If destinationSize is smaller than 8 characters for every complete block of 5 bytes formed by the bytes held in stream followed by source, Base32_Encode_Stream_Update shall fail and return a non-zero value. ] */
+        LogError("Failure: destination buffer too small");
+        result = __FAILURE__;
+    }
+    else
+    {
+        char* out = destination;
+
+        /* Codes_SRS_BASE32_01_005: [ Base32_Encode_Stream_Update shall write the encoding of every complete block of 5 bytes formed by the bytes held in stream followed by source, keep the remaining bytes in stream, set written to the number of characters written and return 0. ] */
+        if ((stream->pendingCount > 0) && ((stream->pendingCount + size) >= TARGET_BLOCK_SIZE))
+        {
+            unsigned char block[TARGET_BLOCK_SIZE];
+            size_t taken = TARGET_BLOCK_SIZE - (size_t)stream->pendingCount;
+
+            (void)memcpy(block, stream->pending, stream->pendingCount);
+            (void)memcpy(block + stream->pendingCount, source, taken);
+            base32_encode_block(block, TARGET_BLOCK_SIZE, out);
+            out += BASE32_INPUT_SIZE;
+            source += taken;
+            size -= taken;
+            stream->pendingCount = 0;
+        }
+
+        if (size > 0)
+        {
+            while (size >= TARGET_BLOCK_SIZE)
+            {
+                base32_encode_block(source, TARGET_BLOCK_SIZE, out);
+                out += BASE32_INPUT_SIZE;
+                source += TARGET_BLOCK_SIZE;
+                size -= TARGET_BLOCK_SIZE;
+            }
+
+            (void)memcpy(stream->pending + stream->pendingCount, source, size);
+            stream->pendingCount = (unsigned char)(stream->pendingCount + size);
+        }
+
+        *written = (size_t)(out - destination);
+        result = 0;
+    }
+    return result;
+}
+
+int Base32_Encode_Stream_Final(BASE32_ENCODE_STREAM* stream, char* destination, size_t destinationSize, size_t* written)
+{
+    int result;
+    if ((stream == NULL) || (written == NULL) || ((destination == NULL) && (destinationSize > 0)))
+    {
+        /* Codes_SRS_BASE32_01_006: [ If stream or written is NULL, or destination is NULL while destinationSize is not 0, Base32_Encode_Stream_Final shall fail and return a non-zero value. ] */
+        LogError("Failure: Invalid input parameter stream=%p, destination=%p, written=%p", stream, destination, written);
+        result = __FAILURE__;
+    }
+    else if ((stream->pendingCount > 0) && (destinationSize < BASE32_INPUT_SIZE))
+    {
+        /* Codes_SRS_BASE32_01_007: [ If stream holds bytes and destinationSize is smaller than 8, Base32_Encode_Stream_Final shall fail and return a non-zero value. ] */
+        LogError("Failure: destination buffer too small");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_BASE32_01_008: [ Base32_Encode_Stream_Final shall write the encoding of the bytes held in stream padded with =, set written to the number of characters written, set stream to hold no bytes and return 0. ] */
+        if (stream->pendingCount > 0)
+        {
+            base32_encode_block(stream->pending, stream->pendingCount, destination);
+            *written = BASE32_INPUT_SIZE;
+        }
+        else
+        {
+            *written = 0;
+        }
+        stream->pendingCount = 0;
+        result = 0;
+    }
+    return result;
+}
+
+void Base32_Decode_Stream_Init(BASE32_DECODE_STREAM* stream)
+{
+    if (stream == NULL)
+    {
+        /* Codes_SRS_BASE32_01_009: [ If stream is NULL Base32_Decode_Stream_Init shall return. ] */
+        LogError("Failure: Invalid input parameter stream");
+    }
+    else
+    {
+        /* Codes_SRS_BASE32_01_010: [ Base32_Decode_Stream_Init shall set stream to hold no characters and to accept more characters. ] */
+        stream->pendingCount = 0;
+        stream->finished = 0;
+    }
+}
+
+/* Decodes a block of 8 characters, after a block with padding the stream accepts no more characters */
+static int base32_decode_stream_block(BASE32_DECODE_STREAM* stream, const unsigned char* source, unsigned char** out)
+{
+    int result = 0;
+    unsigned char input[BASE32_INPUT_SIZE];
+    size_t padding = 0;
+    size_t index;
+
+    for (index = 0; (result == 0) && (index < BASE32_INPUT_SIZE); index++)
+    {
+        input[index] = (source[index] >= ASCII_VALUE_MAX) ? 0xFF : convert_value_to_base32_char(source[index]);
+        if ((input[index] == 0xFF) ||
+            ((padding > 0) && (input[index] != BASE32_EQUAL_SIGN)))
+        {
+            result = __FAILURE__;
+        }
+        else if (input[index] == BASE32_EQUAL_SIGN)
+        {
+            padding++;
+        }
+    }
+
+    // Only 1, 3, 4 or 6 padding characters can end a block
+    if ((result != 0) ||
+        (padding == 2) || (padding == 5) || (padding > 6))
+    {
+        /* Codes_SRS_BASE32_01_013: [ If the characters contain a character outside of the base32 alphabet, padding that does not end a block of 8 with 1, 3, 4 or 6 =, or any character after the block holding =, Base32_Decode_Stream_Update shall fail and return a non-zero value. ] */
+        LogError("Failure source encoding");
+        result = __FAILURE__;
+    }
+    else
+    {
+        *out += base32_decode_block(input, *out);
+        stream->finished = (padding > 0) ? 1 : 0;
+    }
+    return result;
+}
+
+int Base32_Decode_Stream_Update(BASE32_DECODE_STREAM* stream, const char* source, size_t sourceLength, unsigned char* destination, size_t destinationSize, size_t* written)
+{
+    int result;
+    if ((stream == NULL) || (written == NULL) || ((source == NULL) && (sourceLength > 0)) || ((destination == NULL) && (destinationSize > 0)))
+    {
+        /* Codes_SRS_BASE32_01_011: [ If stream or written is NULL, or source is NULL while sourceLength is not 0, or destination is NULL while destinationSize is not 0, Base32_Decode_Stream_Update shall fail and return a non-zero value. ] */
+        LogError("Failure: Invalid input parameter stream=%p, source=%p, destination=%p, written=%p", stream, source, destination, written);
+        result = __FAILURE__;
+    }
+    else if (destinationSize < (((sourceLength / BASE32_INPUT_SIZE) + (((sourceLength % BASE32_INPUT_SIZE) + stream->pendingCount) / BASE32_INPUT_SIZE)) * TARGET_BLOCK_SIZE))
+    {
+        /* Codes_SRS_BASE32_01_012: [ If destinationSize is smaller than 5 bytes for every complete block of 8 characters formed by the characters held in stream followed by source, Base32_Decode_Stream_Update shall fail and return a non-zero value. ] */
+        LogError("Failure: destination buffer too small");
+        result = __FAILURE__;
+    }
+    else
+    {
+        const unsigned char* iterator = (const unsigned char*)source;
+        unsigned char* out = destination;
+        size_t remaining = sourceLength;
+
+        result = 0;
+        while ((result == 0) && (remaining > 0))
+        {
+            if (stream->finished)
+            {
+                /* Codes_SRS_BASE32_01_013: [ If the characters contain a character outside of the base32 alphabet, padding that does not end a block of 8 with 1, 3, 4 or 6 =, or any character after the block holding =, Base32_Decode_Stream_Update shall fail and return a non-zero value. ] */
+                LogError("Failure: base32 string continues after its padding");
+                result = __FAILURE__;
+            }
+            else if ((stream->pendingCount + remaining) < BASE32_INPUT_SIZE)
+            {
+                (void)memcpy(stream->pending + stream->pendingCount, iterator, remaining);
+                stream->pendingCount = (unsigned char)(stream->pendingCount + remaining);
+                remaining = 0;
+            }
+            else if (stream->pendingCount > 0)
+            {
+                // A block split between calls
+                unsigned char block[BASE32_INPUT_SIZE];
+                size_t taken = BASE32_INPUT_SIZE - (size_t)stream->pendingCount;
+
+                (void)memcpy(block, stream->pending, stream->pendingCount);
+                (void)memcpy(block + stream->pendingCount, iterator, taken);
+                stream->pendingCount = 0;
+                iterator += taken;
+                remaining -= taken;
+                result = base32_decode_stream_block(stream, block, &out);
+            }
+            else
+            {
+                result = base32_decode_stream_block(stream, iterator, &out);
+                iterator += BASE32_INPUT_SIZE;
+                remaining -= BASE32_INPUT_SIZE;
+            }
+        }
+
+        if (result == 0)
+        {
+            /* Codes_SRS_BASE32_01_014: [ Otherwise Base32_Decode_Stream_Update shall write the bytes of every complete block of 8 characters, keep the remaining characters in stream, set written to the number of bytes written and return 0. ] */
+            *written = (size_t)(out - destination);
+        }
+    }
+    return result;
+}
+
+int Base32_Decode_Stream_Final(BASE32_DECODE_STREAM* stream)
+{
+    int result;
+    if (stream == NULL)
+    {
+        /* Codes_SRS_BASE32_01_015: [ If stream is NULL Base32_Decode_Stream_Final shall fail and return a non-zero value. ] */
+        LogError("Failure: Invalid input parameter stream");
+        result = __FAILURE__;
+    }
+    else if (stream->pendingCount > 0)
+    {
+        /* Codes_SRS_BASE32_01_016: [ If stream holds characters that do not form a complete block of 8, Base32_Decode_Stream_Final shall fail and return a non-zero value. ] */
+        LogError("Failure: base32 string ends with an incomplete block of %u characters", (unsigned int)stream->pendingCount);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_BASE32_01_017: [ Otherwise Base32_Decode_Stream_Final shall set stream to hold no characters and to accept more characters and return 0. ] */
+        stream->finished = 0;
+        result = 0;
+    }
+    return result;
+}
@@ -5,183 +5,667 @@
 #include "azure_c_shared_utility/gballoc.h"
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include "azure_c_shared_utility/base64.h"
+#include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 
+/*
+ * Whole blocks of 12 input bytes (encoding) or 16 characters (decoding) go through SSSE3
+ * kernels when CPUID reports SSSE3, the rest through the 64 and 256 entry tables below.
+ * Define NO_BASE64_SIMD to always use the tables.
+ */
+#if !defined(NO_BASE64_SIMD) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))) && \
+    (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+#define BASE64_USE_SSSE3
+#include <cpuid.h>
+#include <tmmintrin.h>
+#endif
 
-#define splitInt(intVal, bytePos)   (char)((intVal >> (bytePos << 3)) & 0xFF)
-#define joinChars(a, b, c, d) (uint32_t)((uint32_t)a + ((uint32_t)b << 8) + ((uint32_t)c << 16) + ((uint32_t)d << 24))
+static const char base64_alphabet[64] =
+{
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+};
+
+/*0xFF marks every character that is not part of the base64 alphabet, so one test on the OR of 4 values validates a whole quantum*/
+#define XX 0xFF
+static const unsigned char base64_values[256] =
+{
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, 62, XX, XX, XX, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, XX, XX, XX, XX, XX, XX,
+    XX,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, XX, XX, XX, XX, XX,
+    XX, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX
+};
+#undef XX
+
+/*largest input whose encoding (plus the terminating \0) still fits in a size_t*/
+#define BASE64_MAX_ENCODE_SIZE (((SIZE_MAX - 1) / 4) * 3)
+
+/*encode and decode a prefix of whole blocks with vector instructions and return how many groups or quanta they did*/
+typedef size_t(*BASE64_ENCODE_BLOCKS_FUNCTION)(const unsigned char* source, size_t groupCount, char* out);
+typedef size_t(*BASE64_DECODE_BLOCKS_FUNCTION)(const unsigned char* in, size_t quantumCount, unsigned char* out);
+
+static size_t encode_blocks_none(const unsigned char* source, size_t groupCount, char* out)
+{
+    (void)source;
+    (void)groupCount;
+    (void)out;
+    return 0;
+}
+
+static size_t decode_blocks_none(const unsigned char* in, size_t quantumCount, unsigned char* out)
+{
+    (void)in;
+    (void)quantumCount;
+    (void)out;
+    return 0;
+}
+
+#if defined(BASE64_USE_SSSE3)
+/*4 groups per iteration; every load reads 16 bytes, so the loop stops while at least 6 groups (18 bytes) are left*/
+__attribute__((target("ssse3")))
+static size_t encode_blocks_ssse3(const unsigned char* source, size_t groupCount, char* out)
+{
+    /*a.b.c bytes to b.a.c.b in each 32-bit lane, so every sextet is in a 16-bit half*/
+    const __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    /*added to a sextet to get its character, picked by the range it falls in: A-Z, a-z, 0-9, + and /*/
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t result = 0;
+
+    while (groupCount - result >= 6)
+    {
+        __m128i in = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(source + (result * 3))), spread);
+        /*c1 and c3 with a multiply high, c2 and c4 with a multiply low, each landing in the low 6 bits of its byte*/
+        __m128i c1c3 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        __m128i c2c4 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        __m128i sextets = _mm_or_si128(c1c3, c2c4);
+        /*0 for A-Z, 1 to 12 for the rest from the sextets above 51, 13 for a-z*/
+        __m128i range = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+        range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), sextets), _mm_set1_epi8(13)));
+        _mm_storeu_si128((__m128i*)(out + (result * 4)), _mm_add_epi8(sextets, _mm_shuffle_epi8(offsets, range)));
+        result += 4;
+    }
+
+    return result;
+}
+
+/*4 quanta per iteration, stopping before the first block holding a character outside of the alphabet (= included)*/
+__attribute__((target("ssse3")))
+static size_t decode_blocks_ssse3(const unsigned char* in, size_t quantumCount, unsigned char* out)
+{
+    /*a character is invalid when the bits picked by its low nibble and by its high nibble overlap*/
+    const __m128i low_nibble_bits = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i high_nibble_bits = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    /*added to a character to get its sextet, picked by its high nibble; / shares its nibble with + and is moved one slot down*/
+    const __m128i offsets = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    size_t result = 0;
+
+    while (quantumCount - result >= 4)
+    {
+        __m128i chars = _mm_loadu_si128((const __m128i*)(in + (result * 4)));
+        __m128i high_nibbles = _mm_and_si128(_mm_srli_epi32(chars, 4), _mm_set1_epi8(0x0F));
+        __m128i low_nibbles = _mm_and_si128(chars, _mm_set1_epi8(0x0F));
+        __m128i invalid = _mm_and_si128(_mm_shuffle_epi8(low_nibble_bits, low_nibbles), _mm_shuffle_epi8(high_nibble_bits, high_nibbles));
+        __m128i sextets;
+        __m128i bytes;
+        uint32_t last;
+
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(invalid, _mm_setzero_si128())) != 0)
+        {
+            break;
+        }
+
+        sextets = _mm_add_epi8(chars, _mm_shuffle_epi8(offsets, _mm_add_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8('/')), high_nibbles)));
+        /*c1.c2.c3.c4 to 24 bits in each 32-bit lane, then the 3 bytes of every lane packed in the low 12 bytes*/
+        bytes = _mm_madd_epi16(_mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+        bytes = _mm_shuffle_epi8(bytes, pack);
+        /*12 bytes, so nothing past the decoded data is written*/
+        _mm_storel_epi64((__m128i*)(out + (result * 3)), bytes);
+        last = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+        (void)memcpy(out + (result * 3) + 8, &last, sizeof(last));
+        result += 4;
+    }
+
+    return result;
+}
+
+static int has_ssse3(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    return (__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) && ((ecx & (1u << 9)) != 0);
+}
+#endif /* BASE64_USE_SSSE3 */
+
+static size_t encode_blocks_select(const unsigned char* source, size_t groupCount, char* out);
+static size_t decode_blocks_select(const unsigned char* in, size_t quantumCount, unsigned char* out);
 
-static char base64char(unsigned char val)
+/*The selection is idempotent, so threads racing on the first call all store the same functions.*/
+static BASE64_ENCODE_BLOCKS_FUNCTION encode_blocks = encode_blocks_select;
+static BASE64_DECODE_BLOCKS_FUNCTION decode_blocks = decode_blocks_select;
+
+static void select_blocks_functions(void)
 {
-    char result;
+    BASE64_ENCODE_BLOCKS_FUNCTION selected_encode = encode_blocks_none;
+    BASE64_DECODE_BLOCKS_FUNCTION selected_decode = decode_blocks_none;
 
-    if (val < 26)
+#if defined(BASE64_USE_SSSE3)
+    if (has_ssse3())
     {
-        result = 'A' + (char)val;
+        selected_encode = encode_blocks_ssse3;
+        selected_decode = decode_blocks_ssse3;
     }
-    else if (val < 52)
+#endif
+
+    encode_blocks = selected_encode;
+    decode_blocks = selected_decode;
+}
+
+static size_t encode_blocks_select(const unsigned char* source, size_t groupCount, char* out)
+{
+    select_blocks_functions();
+    return encode_blocks(source, groupCount, out);
+}
+
+static size_t decode_blocks_select(const unsigned char* in, size_t quantumCount, unsigned char* out)
+{
+    select_blocks_functions();
+    return decode_blocks(in, quantumCount, out);
+}
+
+/*encodes groupCount groups of 3 bytes and returns the position after the last character written*/
+static char* encode_groups(const unsigned char* source, size_t groupCount, char* out)
+{
+    /*b0            b1(+1)          b2(+2)
+    7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0
+    |----c1---| |----c2---| |----c3---| |----c4---|
+    */
+    const unsigned char* end = source + (groupCount * 3);
+    size_t vectorGroupCount = encode_blocks(source, groupCount, out);
+
+    source += vectorGroupCount * 3;
+    out += vectorGroupCount * 4;
+
+    while (source < end)
+    {
+        uint32_t triple = ((uint32_t)source[0] << 16) | ((uint32_t)source[1] << 8) | (uint32_t)source[2];
+        out[0] = base64_alphabet[(triple >> 18) & 0x3F];
+        out[1] = base64_alphabet[(triple >> 12) & 0x3F];
+        out[2] = base64_alphabet[(triple >> 6) & 0x3F];
+        out[3] = base64_alphabet[triple & 0x3F];
+        source += 3;
+        out += 4;
+    }
+
+    return out;
+}
+
+/*encodes the last 1 or 2 bytes of the input padded with =, does nothing for 0 bytes*/
+static char* encode_tail(const unsigned char* source, size_t size, char* out)
+{
+    switch (size)
     {
-        result = 'a' + ((char)val - 26);
+    case 2:
+        out[0] = base64_alphabet[source[0] >> 2];
+        out[1] = base64_alphabet[((source[0] & 0x03) << 4) | (source[1] >> 4)];
+        out[2] = base64_alphabet[(source[1] & 0x0F) << 2];
+        out[3] = '=';
+        out += 4;
+        break;
+    case 1:
+        out[0] = base64_alphabet[source[0] >> 2];
+        out[1] = base64_alphabet[(source[0] & 0x03) << 4];
+        out[2] = '=';
+        out[3] = '=';
+        out += 4;
+        break;
+    default:
+        break;
     }
-    else if (val < 62)
+
+    return out;
+}
+
+/*decodes quanta without padding, stopping at the first one that holds a character outside of the alphabet (= included); returns the number of quanta decoded*/
+static size_t decode_quanta(const unsigned char* in, size_t quantumCount, unsigned char* out)
+{
+    size_t result = decode_blocks(in, quantumCount, out);
+
+    in += result * 4;
+    out += result * 3;
+    for (; result < quantumCount; result++)
     {
-        result = '0' + ((char)val - 52);
+        unsigned char c1 = base64_values[in[0]];
+        unsigned char c2 = base64_values[in[1]];
+        unsigned char c3 = base64_values[in[2]];
+        unsigned char c4 = base64_values[in[3]];
+        if (((c1 | c2 | c3 | c4) & 0x80) != 0)
+        {
+            break;
+        }
+        out[0] = (unsigned char)((c1 << 2) | (c2 >> 4));
+        out[1] = (unsigned char)((c2 << 4) | (c3 >> 2));
+        out[2] = (unsigned char)((c3 << 6) | c4);
+        in += 4;
+        out += 3;
     }
-    else if (val == 62)
+
+    return result;
+}
+
+/*decodes a quantum that may end with = or ==; returns the number of bytes written, 0 if the quantum is invalid*/
+static size_t decode_last_quantum(const unsigned char* in, unsigned char* out)
+{
+    size_t result;
+    unsigned char c1 = base64_values[in[0]];
+    unsigned char c2 = base64_values[in[1]];
+    unsigned char c3 = (in[2] == '=') ? 0 : base64_values[in[2]];
+    unsigned char c4 = (in[3] == '=') ? 0 : base64_values[in[3]];
+
+    if ((((c1 | c2 | c3 | c4) & 0x80) != 0) ||
+        ((in[2] == '=') && (in[3] != '=')))
     {
-        result = '+';
+        result = 0;
     }
     else
     {
-        result = '/';
+        out[0] = (unsigned char)((c1 << 2) | (c2 >> 4));
+        result = 1;
+        if (in[2] != '=')
+        {
+            out[1] = (unsigned char)((c2 << 4) | (c3 >> 2));
+            result++;
+            if (in[3] != '=')
+            {
+                out[2] = (unsigned char)((c3 << 6) | c4);
+                result++;
+            }
+        }
     }
 
     return result;
 }
 
-static char base64b16(unsigned char val)
+size_t Base64_Encode_Length(size_t size)
 {
-    const uint32_t base64b16values[4] = {
-        joinChars('A', 'E', 'I', 'M'),
-        joinChars('Q', 'U', 'Y', 'c'),
-        joinChars('g', 'k', 'o', 's'),
-        joinChars('w', '0', '4', '8')
-    };
-    return splitInt(base64b16values[val >> 2], (val & 0x03));
+    size_t result;
+
+    if (size > BASE64_MAX_ENCODE_SIZE)
+    {
+        /*Codes_SRS_BASE64_01_002: [ If the encoded length does not fit in a size_t, Base64_Encode_Length shall return 0. ]*/
+        LogError("Base64_Encode_Length:: size %lu is too large", (unsigned long)size);
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_BASE64_01_001: [ Base64_Encode_Length shall return the number of characters in the base64 encoding of size bytes, not counting the terminating \0. ]*/
+        result = ((size + 2) / 3) * 4;
+    }
+
+    return result;
 }
 
-static char base64b8(unsigned char val)
+int Base64_Encode_Into(const unsigned char* source, size_t size, char* destination, size_t destinationSize)
 {
-    const uint32_t base64b8values = joinChars('A', 'Q', 'g', 'w');
-    return splitInt(base64b8values, val);
+    int result;
+
+    if (((source == NULL) && (size > 0)) || (destination == NULL))
+    {
+        /*Codes_SRS_BASE64_01_003: [ If destination is NULL, or source is NULL while size is not 0, Base64_Encode_Into shall fail and return a non-zero value. ]*/
+        LogError("invalid argument const unsigned char* source=%p, char* destination=%p", source, destination);
+        result = __FAILURE__;
+    }
+    else if ((size > BASE64_MAX_ENCODE_SIZE) ||
+        (destinationSize <= Base64_Encode_Length(size)))
+    {
+        /*Codes_SRS_BASE64_01_004: [ If destinationSize is smaller than Base64_Encode_Length(size) + 1, Base64_Encode_Into shall fail and return a non-zero value. ]*/
+        LogError("Base64_Encode_Into:: destination buffer too small");
+        result = __FAILURE__;
+    }
+    else
+    {
+        char* out = destination;
+
+        /*Codes_SRS_BASE64_01_005: [ Base64_Encode_Into shall write the base64 encoding of source, padded with =, followed by a terminating \0 in destination and return 0. ]*/
+        out = encode_groups(source, size / 3, out);
+        out = encode_tail(source + (size - (size % 3)), size % 3, out);
+
+        /*null terminating the string*/
+        *out = '\0';
+        result = 0;
+    }
+
+    return result;
 }
 
-static int base64toValue(char base64character, unsigned char* value)
+size_t Base64_Decode_Length(const char* source, size_t sourceLength)
 {
-    int result = 0;
-    if (('A' <= base64character) && (base64character <= 'Z'))
+    size_t result;
+
+    if ((source == NULL) || (sourceLength == 0) || ((sourceLength % 4) != 0))
     {
-        *value = base64character - 'A';
+        /*Codes_SRS_BASE64_01_007: [ If source is NULL or sourceLength is not a multiple of 4, Base64_Decode_Length shall return 0. ]*/
+        result = 0;
     }
-    else if (('a' <= base64character) && (base64character <= 'z'))
+    else
     {
-        *value = ('Z' - 'A') + 1 + (base64character - 'a');
+        /*Codes_SRS_BASE64_01_006: [ Base64_Decode_Length shall return the number of bytes encoded by the first sourceLength characters of source, taking the = padding into account. ]*/
+        result = (sourceLength / 4) * 3;
+        if (source[sourceLength - 1] == '=')
+        {
+            if (source[sourceLength - 2] == '=')
+            {
+                result--;
+            }
+            result--;
+        }
+    }
+
+    return result;
+}
+
+int Base64_Decode_Into(const char* source, size_t sourceLength, unsigned char* destination, size_t destinationSize, size_t* decodedSize)
+{
+    int result;
+
+    if ((source == NULL) || (decodedSize == NULL) || ((destination == NULL) && (destinationSize > 0)))
+    {
+        /*Codes_SRS_BASE64_01_008: [ If source or decodedSize is NULL, or destination is NULL while destinationSize is not 0, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+        LogError("invalid argument const char* source=%p, unsigned char* destination=%p, size_t* decodedSize=%p", source, destination, decodedSize);
+        result = __FAILURE__;
     }
-    else if (('0' <= base64character) && (base64character <= '9'))
+    else if ((sourceLength % 4) != 0)
     {
-        *value = ('Z' - 'A') + 1 + ('z' - 'a') + 1 + (base64character - '0');
+        /*Codes_SRS_BASE64_01_009: [ If sourceLength is not a multiple of 4, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+        LogError("Invalid length Base64 string!");
+        result = __FAILURE__;
     }
-    else if ('+' == base64character)
+    else if (destinationSize < Base64_Decode_Length(source, sourceLength))
     {
-        *value = 62;
+        /*Codes_SRS_BASE64_01_010: [ If destinationSize is smaller than Base64_Decode_Length(source, sourceLength), Base64_Decode_Into shall fail and return a non-zero value. ]*/
+        LogError("Base64_Decode_Into:: destination buffer too small");
+        result = __FAILURE__;
     }
-    else if ('/' == base64character)
+    else if (sourceLength == 0)
     {
-        *value = 63;
+        *decodedSize = 0;
+        result = 0;
     }
     else
     {
-        *value = 0;
-        result = -1;
+        const unsigned char* in = (const unsigned char*)source;
+        size_t quantumCount = sourceLength / 4;
+        size_t lastSize;
+
+        /*all quanta but the last one cannot carry padding*/
+        if ((decode_quanta(in, quantumCount - 1, destination) != quantumCount - 1) ||
+            ((lastSize = decode_last_quantum(in + (sourceLength - 4), destination + ((quantumCount - 1) * 3))) == 0))
+        {
+            /*Codes_SRS_BASE64_01_011: [ If source contains a character outside of the base64 alphabet, or = anywhere but in the last 2 positions, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+            LogError("Invalid character in Base64 string");
+            result = __FAILURE__;
+        }
+        else
+        {
+            /*Codes_SRS_BASE64_01_012: [ Otherwise Base64_Decode_Into shall write the decoded bytes in destination, set decodedSize to their number and return 0. ]*/
+            *decodedSize = ((quantumCount - 1) * 3) + lastSize;
+            result = 0;
+        }
     }
+
     return result;
 }
 
-static size_t numberOfBase64Characters(const char* encodedString)
+void Base64_Encode_Stream_Init(BASE64_ENCODE_STREAM* stream)
 {
-    size_t length = 0;
-    unsigned char junkChar;
-    while (base64toValue(encodedString[length],&junkChar) != -1)
+    if (stream == NULL)
     {
-        length++;
+        /*Codes_SRS_BASE64_01_014: [ If stream is NULL, Base64_Encode_Stream_Init shall return. ]*/
+        LogError("NULL stream");
+    }
+    else
+    {
+        /*Codes_SRS_BASE64_01_015: [ Base64_Encode_Stream_Init shall set stream to hold no bytes. ]*/
+        stream->pendingCount = 0;
     }
-    return length;
 }
 
-/*returns the count of original bytes before being base64 encoded*/
-/*notice NO validation of the content of encodedString. Its length is validated to be a multiple of 4.*/
-static size_t Base64decode_len(const char *encodedString)
+int Base64_Encode_Stream_Update(BASE64_ENCODE_STREAM* stream, const unsigned char* source, size_t size, char* destination, size_t destinationSize, size_t* written)
 {
-    size_t result;
-    size_t sourceLength = strlen(encodedString);
+    int result;
+
+    if ((stream == NULL) || (written == NULL) || ((source == NULL) && (size > 0)) || ((destination == NULL) && (destinationSize > 0)))
+    {
+        /*Codes_SRS_BASE64_01_016: [ If stream or written is NULL, or source is NULL while size is not 0, or destination is NULL while destinationSize is not 0, Base64_Encode_Stream_Update shall fail and return a non-zero value. ]*/
+        LogError("invalid argument BASE64_ENCODE_STREAM* stream=%p, const unsigned char* source=%p, char* destination=%p, size_t* written=%p", stream, source, destination, written);
+        result = __FAILURE__;
+    }
+    else if ((size > BASE64_MAX_ENCODE_SIZE) ||
+        (destinationSize < (((stream->pendingCount + size) / 3) * 4)))
+    {
+        /*Codes_SRS_BASE64_01_017: [ If destinationSize is smaller than the number of characters encoding the complete groups of 3 bytes formed by the bytes held in stream followed by source, Base64_Encode_Stream_Update shall fail and return a non-zero value. ]*/
+        LogError("Base64_Encode_Stream_Update:: destination buffer too small");
+        result = __FAILURE__;
+    }
+    else
+    {
+        char* out = destination;
+
+        /*Codes_SRS_BASE64_01_018: [ Base64_Encode_Stream_Update shall write the encoding of every complete group of 3 bytes formed by the bytes held in stream followed by source, keep the remaining bytes in stream, set written to the number of characters written and return 0. ]*/
+        if ((stream->pendingCount > 0) && ((stream->pendingCount + size) >= 3))
+        {
+            unsigned char group[3];
+            size_t taken = 3 - (size_t)stream->pendingCount;
+
+            (void)memcpy(group, stream->pending, stream->pendingCount);
+            (void)memcpy(group + stream->pendingCount, source, taken);
+            out = encode_groups(group, 1, out);
+            source += taken;
+            size -= taken;
+            stream->pendingCount = 0;
+        }
+
+        if (size > 0)
+        {
+            out = encode_groups(source, size / 3, out);
+            (void)memcpy(stream->pending + stream->pendingCount, source + (size - (size % 3)), size % 3);
+            stream->pendingCount = (unsigned char)(stream->pendingCount + (size % 3));
+        }
+
+        *written = (size_t)(out - destination);
+        result = 0;
+    }
+
+    return result;
+}
+
+int Base64_Encode_Stream_Final(BASE64_ENCODE_STREAM* stream, char* destination, size_t destinationSize, size_t* written)
+{
+    int result;
 
-    if (sourceLength == 0)
+    if ((stream == NULL) || (written == NULL) || ((destination == NULL) && (destinationSize > 0)))
+    {
+        /*Codes_SRS_BASE64_01_019: [ If stream or written is NULL, or destination is NULL while destinationSize is not 0, Base64_Encode_Stream_Final shall fail and return a non-zero value. ]*/
+        LogError("invalid argument BASE64_ENCODE_STREAM* stream=%p, char* destination=%p, size_t* written=%p", stream, destination, written);
+        result = __FAILURE__;
+    }
+    else if ((stream->pendingCount > 0) && (destinationSize < 4))
+    {
+        /*Codes_SRS_BASE64_01_020: [ If stream holds bytes and destinationSize is smaller than 4, Base64_Encode_Stream_Final shall fail and return a non-zero value. ]*/
+        LogError("Base64_Encode_Stream_Final:: destination buffer too small");
+        result = __FAILURE__;
+    }
+    else
     {
+        /*Codes_SRS_BASE64_01_021: [ Base64_Encode_Stream_Final shall write the encoding of the bytes held in stream padded with =, set written to the number of characters written, set stream to hold no bytes and return 0. ]*/
+        *written = (size_t)(encode_tail(stream->pending, stream->pendingCount, destination) - destination);
+        stream->pendingCount = 0;
         result = 0;
     }
+
+    return result;
+}
+
+void Base64_Decode_Stream_Init(BASE64_DECODE_STREAM* stream)
+{
+    if (stream == NULL)
+    {
+        /*Codes_SRS_BASE64_01_022: [ If stream is NULL, Base64_Decode_Stream_Init shall return. ]*/
+        LogError("NULL stream");
+    }
     else
     {
-        result = sourceLength / 4 * 3;
-        if (encodedString[sourceLength - 1] == '=')
+        /*Codes_SRS_BASE64_01_023: [ Base64_Decode_Stream_Init shall set stream to hold no characters and to accept more characters. ]*/
+        stream->pendingCount = 0;
+        stream->finished = 0;
+    }
+}
+
+/*decodes a quantum that may carry padding, after which the stream accepts no more characters*/
+static int decode_stream_last_quantum(BASE64_DECODE_STREAM* stream, const unsigned char* in, unsigned char** out)
+{
+    int result;
+    size_t decodedSize = decode_last_quantum(in, *out);
+
+    if (decodedSize == 0)
+    {
+        /*Codes_SRS_BASE64_01_026: [ If the characters contain a character outside of the base64 alphabet, = anywhere but at the end of a group of 4, or any character after the group holding =, Base64_Decode_Stream_Update shall fail and return a non-zero value. ]*/
+        LogError("Invalid character in Base64 string");
+        result = __FAILURE__;
+    }
+    else
+    {
+        *out += decodedSize;
+        stream->finished = (decodedSize < 3) ? 1 : 0;
+        result = 0;
+    }
+
+    return result;
+}
+
+int Base64_Decode_Stream_Update(BASE64_DECODE_STREAM* stream, const char* source, size_t sourceLength, unsigned char* destination, size_t destinationSize, size_t* written)
+{
+    int result;
+
+    if ((stream == NULL) || (written == NULL) || ((source == NULL) && (sourceLength > 0)) || ((destination == NULL) && (destinationSize > 0)))
+    {
+        /*Codes_SRS_BASE64_01_024: [ If stream or written is NULL, or source is NULL while sourceLength is not 0, or destination is NULL while destinationSize is not 0, Base64_Decode_Stream_Update shall fail and return a non-zero value. ]*/
+        LogError("invalid argument BASE64_DECODE_STREAM* stream=%p, const char* source=%p, unsigned char* destination=%p, size_t* written=%p", stream, source, destination, written);
+        result = __FAILURE__;
+    }
+    else if (destinationSize < (((sourceLength / 4) * 3) + ((((sourceLength % 4) + stream->pendingCount) / 4) * 3)))
+    {
+        /*Codes_SRS_BASE64_01_025: [ If destinationSize is smaller than 3 bytes for every complete group of 4 characters formed by the characters held in stream followed by source, Base64_Decode_Stream_Update shall fail and return a non-zero value. ]*/
+        LogError("Base64_Decode_Stream_Update:: destination buffer too small");
+        result = __FAILURE__;
+    }
+    else
+    {
+        const unsigned char* in = (const unsigned char*)source;
+        unsigned char* out = destination;
+        size_t remaining = sourceLength;
+
+        result = 0;
+        while ((result == 0) && (remaining > 0))
         {
-            if (encodedString[sourceLength - 2] == '=')
+            if (stream->finished)
             {
-                result --;
+                /*Codes_SRS_BASE64_01_026: [ If the characters contain a character outside of the base64 alphabet, = anywhere but at the end of a group of 4, or any character after the group holding =, Base64_Decode_Stream_Update shall fail and return a non-zero value. ]*/
+                LogError("Base64 string continues after its padding");
+                result = __FAILURE__;
+            }
+            else if ((stream->pendingCount > 0) || (remaining < 4))
+            {
+                /*a group split between calls*/
+                size_t taken = 4 - (size_t)stream->pendingCount;
+                if (taken > remaining)
+                {
+                    taken = remaining;
+                }
+
+                if ((stream->pendingCount + taken) < 4)
+                {
+                    (void)memcpy(stream->pending + stream->pendingCount, in, taken);
+                    stream->pendingCount = (unsigned char)(stream->pendingCount + taken);
+                }
+                else
+                {
+                    unsigned char quantum[4];
+                    (void)memcpy(quantum, stream->pending, stream->pendingCount);
+                    (void)memcpy(quantum + stream->pendingCount, in, taken);
+                    stream->pendingCount = 0;
+                    result = decode_stream_last_quantum(stream, quantum, &out);
+                }
+
+                in += taken;
+                remaining -= taken;
+            }
+            else
+            {
+                size_t decodedCount = decode_quanta(in, remaining / 4, out);
+                in += decodedCount * 4;
+                out += decodedCount * 3;
+                remaining -= decodedCount * 4;
+
+                /*the quantum that stopped the fast loop is either the padded end of the string or invalid*/
+                if (remaining >= 4)
+                {
+                    result = decode_stream_last_quantum(stream, in, &out);
+                    in += 4;
+                    remaining -= 4;
+                }
             }
-            result--;
+        }
+
+        if (result == 0)
+        {
+            /*Codes_SRS_BASE64_01_027: [ Otherwise Base64_Decode_Stream_Update shall write the bytes of every complete group of 4 characters, keep the remaining characters in stream, set written to the number of bytes written and return 0. ]*/
+            *written = (size_t)(out - destination);
         }
     }
+
     return result;
 }
 
-static void Base64decode(unsigned char *decodedString, const char *base64String)
+int Base64_Decode_Stream_Final(BASE64_DECODE_STREAM* stream)
 {
+    int result;
 
-    size_t numberOfEncodedChars;
-    size_t indexOfFirstEncodedChar;
-    size_t decodedIndex;
-
-    //
-    // We can only operate on individual bytes.  If we attempt to work
-    // on anything larger we could get an alignment fault on some
-    // architectures
-    //
-
-    numberOfEncodedChars = numberOfBase64Characters(base64String);
-    indexOfFirstEncodedChar = 0;
-    decodedIndex = 0;
-    while (numberOfEncodedChars >= 4)
-    {
-        unsigned char c1;
-        unsigned char c2;
-        unsigned char c3;
-        unsigned char c4;
-        (void)base64toValue(base64String[indexOfFirstEncodedChar], &c1);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 1], &c2);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 2], &c3);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 3], &c4);
-        decodedString[decodedIndex] = (c1 << 2) | (c2 >> 4);
-        decodedIndex++;
-        decodedString[decodedIndex] = ((c2 & 0x0f) << 4) | (c3 >> 2);
-        decodedIndex++;
-        decodedString[decodedIndex] = ((c3 & 0x03) << 6) | c4;
-        decodedIndex++;
-        numberOfEncodedChars -= 4;
-        indexOfFirstEncodedChar += 4;
-
-    }
-
-    if (numberOfEncodedChars == 2)
-    {
-        unsigned char c1;
-        unsigned char c2;
-        (void)base64toValue(base64String[indexOfFirstEncodedChar], &c1);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 1], &c2);
-        decodedString[decodedIndex] = (c1 << 2) | (c2 >> 4);
-    }
-    else if (numberOfEncodedChars == 3)
-    {
-        unsigned char c1;
-        unsigned char c2;
-        unsigned char c3;
-        (void)base64toValue(base64String[indexOfFirstEncodedChar], &c1);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 1], &c2);
-        (void)base64toValue(base64String[indexOfFirstEncodedChar + 2], &c3);
-        decodedString[decodedIndex] = (c1 << 2) | (c2 >> 4);
-        decodedIndex++;
-        decodedString[decodedIndex] = ((c2 & 0x0f) << 4) | (c3 >> 2);
+    if (stream == NULL)
+    {
+        /*Codes_SRS_BASE64_01_028: [ If stream is NULL, Base64_Decode_Stream_Final shall fail and return a non-zero value. ]*/
+        LogError("NULL stream");
+        result = __FAILURE__;
+    }
+    else if (stream->pendingCount > 0)
+    {
+        /*Codes_SRS_BASE64_01_029: [ If stream holds characters that do not form a complete group of 4, Base64_Decode_Stream_Final shall fail and return a non-zero value. ]*/
+        LogError("Base64 string ends with an incomplete group of %u characters", (unsigned int)stream->pendingCount);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_BASE64_01_030: [ Otherwise Base64_Decode_Stream_Final shall set stream to hold no characters and to accept more characters and return 0. ]*/
+        stream->finished = 0;
+        result = 0;
     }
+
+    return result;
 }
 
 BUFFER_HANDLE Base64_Decoder(const char* source)
@@ -195,7 +679,8 @@ BUFFER_HANDLE Base64_Decoder(const char* source)
     }
     else
     {
-        if ((strlen(source) % 4) != 0)
+        size_t sourceLength = strlen(source);
+        if ((sourceLength % 4) != 0)
         {
             /*Codes_SRS_BASE64_06_011: [If the source string has an invalid length for a base 64 encoded string then Base64_Decode shall return NULL.]*/
             LogError("Invalid length Base64 string!");
@@ -210,10 +695,11 @@ BUFFER_HANDLE Base64_Decoder(const char* source)
             }
             else
             {
-                size_t sizeOfOutputBuffer = Base64decode_len(source);
+                size_t sizeOfOutputBuffer = Base64_Decode_Length(source, sourceLength);
                 /*Codes_SRS_BASE64_06_009: [If the string pointed to by source is zero length then the handle returned shall refer to a zero length buffer.]*/
                 if (sizeOfOutputBuffer > 0)
                 {
+                    size_t decodedSize;
                     if (BUFFER_pre_build(result, sizeOfOutputBuffer) != 0)
                     {
                         /*Codes_SRS_BASE64_06_010: [If there is any memory allocation failure during the decode then Base64_Decode shall return NULL.]*/
@@ -221,9 +707,11 @@ BUFFER_HANDLE Base64_Decoder(const char* source)
                         BUFFER_delete(result);
                         result = NULL;
                     }
-                    else
+                    else if (Base64_Decode_Into(source, sourceLength, BUFFER_u_char(result), sizeOfOutputBuffer, &decodedSize) != 0)
                     {
-                        Base64decode(BUFFER_u_char(result), source);
+                        /*Codes_SRS_BASE64_01_013: [ If the source string contains characters that are not valid base64 then Base64_Decoder shall return NULL. ]*/
+                        BUFFER_delete(result);
+                        result = NULL;
                     }
                 }
             }
@@ -236,72 +724,23 @@ BUFFER_HANDLE Base64_Decoder(const char* source)
 static STRING_HANDLE Base64_Encode_Internal(const unsigned char* source, size_t size)
 {
     STRING_HANDLE result;
-    size_t neededSize = 0;
+    size_t neededSize = Base64_Encode_Length(size) + 1; /*+1 because \0 at the end of the string*/
     char* encoded;
-    size_t currentPosition = 0;
-    neededSize += (size == 0) ? (0) : ((((size - 1) / 3) + 1) * 4);
-    neededSize += 1; /*+1 because \0 at the end of the string*/
+
     /*Codes_SRS_BASE64_06_006: [If when allocating memory to produce the encoding a failure occurs then Base64_Encoder shall return NULL.]*/
-    encoded = (char*)malloc(neededSize);
-    if (encoded == NULL)
+    if ((encoded = (char*)malloc(neededSize)) == NULL)
     {
         result = NULL;
         LogError("Base64_Encoder:: Allocation failed.");
     }
+    else if (Base64_Encode_Into(source, size, encoded, neededSize) != 0)
+    {
+        free(encoded);
+        result = NULL;
+        LogError("Base64_Encoder:: encoding failed.");
+    }
     else
     {
-        /*b0            b1(+1)          b2(+2)
-        7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0 7 6 5 4 3 2 1 0
-        |----c1---| |----c2---| |----c3---| |----c4---|
-        */
-
-        size_t destinationPosition = 0;
-        while (size - currentPosition >= 3)
-        {
-            char c1 = base64char(source[currentPosition] >> 2);
-            char c2 = base64char(
-                ((source[currentPosition] & 3) << 4) |
-                    (source[currentPosition + 1] >> 4)
-            );
-            char c3 = base64char(
-                ((source[currentPosition + 1] & 0x0F) << 2) |
-                    ((source[currentPosition + 2] >> 6) & 3)
-            );
-            char c4 = base64char(
-                source[currentPosition + 2] & 0x3F
-            );
-            currentPosition += 3;
-            encoded[destinationPosition++] = c1;
-            encoded[destinationPosition++] = c2;
-            encoded[destinationPosition++] = c3;
-            encoded[destinationPosition++] = c4;
-
-        }
-        if (size - currentPosition == 2)
-        {
-            char c1 = base64char(source[currentPosition] >> 2);
-            char c2 = base64char(
-                ((source[currentPosition] & 0x03) << 4) |
-                    (source[currentPosition + 1] >> 4)
-            );
-            char c3 = base64b16(source[currentPosition + 1] & 0x0F);
-            encoded[destinationPosition++] = c1;
-            encoded[destinationPosition++] = c2;
-            encoded[destinationPosition++] = c3;
-            encoded[destinationPosition++] = '=';
-        }
-        else if (size - currentPosition == 1)
-        {
-            char c1 = base64char(source[currentPosition] >> 2);
-            char c2 = base64b8(source[currentPosition] & 0x03);
-            encoded[destinationPosition++] = c1;
-            encoded[destinationPosition++] = c2;
-            encoded[destinationPosition++] = '=';
-            encoded[destinationPosition++] = '=';
-        }
-
-        /*null terminating the string*/
-        encoded[destinationPosition] = '\0';
         /*Codes_SRS_BASE64_06_007: [Otherwise Base64_Encoder shall return a pointer to STRING, that string contains the base 64 encoding of input.]*/
         result = STRING_new_with_memory(encoded);
         if (result == NULL)
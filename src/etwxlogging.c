@@ -28,6 +28,18 @@ LOGGER_LOG xlogging_get_log_function(void)
     return global_log_function;
 }
 
+volatile int xlogging_max_category = AZ_LOG_TRACE;
+
+void xlogging_set_max_category(LOG_CATEGORY max_category)
+{
+    xlogging_max_category = (int)max_category;
+}
+
+LOG_CATEGORY xlogging_get_max_category(void)
+{
+    return (LOG_CATEGORY)xlogging_max_category;
+}
+
 LOGGER_LOG_GETLASTERROR global_log_function_GetLastError = etwlogger_log_with_GetLastError;
 
 void xlogging_set_log_function_GetLastError(LOGGER_LOG_GETLASTERROR log_function_GetLastError)
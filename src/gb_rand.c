@@ -1,16 +1,197 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+/* syscall is not declared in strict C99/POSIX mode */
+#define _DEFAULT_SOURCE
+#endif
+
+#if defined(_WIN32)
+/* rand_s is only declared when _CRT_RAND_S is defined before stdlib.h */
+#define _CRT_RAND_S
+#endif
+
 #ifdef __cplusplus
 #include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
 #else
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#endif
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+#include <stdio.h>
 #endif
 
 #include "azure_c_shared_utility/gb_rand.h"
 
-/*this is rand*/
+/*
+ * Every thread has its own xoshiro256** generator, seeded on first use from the OS
+ * (getrandom, /dev/urandom or rand_s), so callers never contend on a shared lock like
+ * the one inside rand(). Targets without thread local storage share a single generator;
+ * define NO_GB_RAND_THREAD_LOCAL to force that.
+ */
+#if !defined(NO_GB_RAND_THREAD_LOCAL) && defined(_MSC_VER)
+#define GB_RAND_THREAD_LOCAL __declspec(thread)
+#elif !defined(NO_GB_RAND_THREAD_LOCAL) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__linux__) || defined(__APPLE__) || defined(_WIN32))
+#define GB_RAND_THREAD_LOCAL __thread
+#else
+#define GB_RAND_THREAD_LOCAL
+#endif
+
+typedef struct GB_RAND_STATE_TAG
+{
+    uint64_t s[4];
+    int seeded;
+} GB_RAND_STATE;
+
+static GB_RAND_THREAD_LOCAL GB_RAND_STATE gb_rand_state;
+
+static uint64_t splitmix64(uint64_t* x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t next(GB_RAND_STATE* state)
+{
+    uint64_t* s = state->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+/* Fills the buffer from the OS entropy source; returns 0 when all bytes could be read */
+static int read_os_entropy(unsigned char* buffer, size_t length)
+{
+    int result = -1;
+
+#if defined(__linux__) && defined(SYS_getrandom)
+    size_t pos = 0;
+    while (pos < length)
+    {
+        long read_bytes = syscall(SYS_getrandom, buffer + pos, length - pos, 0);
+        if (read_bytes <= 0)
+        {
+            break;
+        }
+        pos += (size_t)read_bytes;
+    }
+    result = (pos == length) ? 0 : -1;
+#endif
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+    if (result != 0)
+    {
+        FILE* urandom = fopen("/dev/urandom", "rb");
+        if (urandom != NULL)
+        {
+            result = (fread(buffer, 1, length, urandom) == length) ? 0 : -1;
+            (void)fclose(urandom);
+        }
+    }
+#elif defined(_WIN32)
+    {
+        size_t pos;
+        result = 0;
+        for (pos = 0; (result == 0) && (pos < length); pos += sizeof(unsigned int))
+        {
+            unsigned int value;
+            if (rand_s(&value) != 0)
+            {
+                result = -1;
+            }
+            else
+            {
+                (void)memcpy(buffer + pos, &value, ((length - pos) < sizeof(value)) ? (length - pos) : sizeof(value));
+            }
+        }
+    }
+#else
+    (void)buffer;
+    (void)length;
+#endif
+
+    return result;
+}
+
+static GB_RAND_STATE* get_state(void)
+{
+    GB_RAND_STATE* state = &gb_rand_state;
+
+    if (!state->seeded)
+    {
+        uint64_t seed[4];
+        uint64_t mix;
+        size_t i;
+
+        if (read_os_entropy((unsigned char*)seed, sizeof(seed)) != 0)
+        {
+            (void)memset(seed, 0, sizeof(seed));
+        }
+
+        /* the time and the address of the per-thread state keep threads apart even without OS entropy */
+        mix = (uint64_t)time(NULL) ^ ((uint64_t)clock() << 32) ^ (uint64_t)(uintptr_t)state;
+        for (i = 0; i < 4; i++)
+        {
+            state->s[i] = seed[i] ^ splitmix64(&mix);
+        }
+        state->seeded = 1;
+    }
+
+    return state;
+}
+
 int gb_rand(void)
 {
-    return rand();
+    /* 31 bits, so that the result is never negative */
+    return (int)(next(get_state()) >> 33);
+}
+
+void gb_rand_bytes(unsigned char* buffer, size_t length)
+{
+    if (buffer != NULL)
+    {
+        GB_RAND_STATE* state = get_state();
+
+        while (length >= sizeof(uint64_t))
+        {
+            uint64_t value = next(state);
+            (void)memcpy(buffer, &value, sizeof(value));
+            buffer += sizeof(value);
+            length -= sizeof(value);
+        }
+
+        if (length > 0)
+        {
+            uint64_t value = next(state);
+            (void)memcpy(buffer, &value, length);
+        }
+    }
 }
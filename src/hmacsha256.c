@@ -1,10 +1,14 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
+#include <stdlib.h>
 #include <stddef.h>
+#include <limits.h>
+#include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/hmacsha256.h"
 #include "azure_c_shared_utility/hmac.h"
 #include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/xlogging.h"
 
 HMACSHA256_RESULT HMACSHA256_ComputeHash(const unsigned char* key, size_t keyLen, const unsigned char* payload, size_t payloadLen, BUFFER_HANDLE hash)
 {
@@ -33,3 +37,117 @@ HMACSHA256_RESULT HMACSHA256_ComputeHash(const unsigned char* key, size_t keyLen
 
     return result;
 }
+
+typedef struct HMACSHA256_KEY_TAG
+{
+    /* SHA-256 state after absorbing (K XOR ipad) and (K XOR opad) */
+    USHAContext inner;
+    USHAContext outer;
+} HMACSHA256_KEY;
+
+HMACSHA256_KEY_HANDLE HMACSHA256_CreateKey(const unsigned char* key, size_t keyLen)
+{
+    HMACSHA256_KEY* result;
+
+    if (key == NULL ||
+        keyLen == 0 ||
+        keyLen > INT_MAX)
+    {
+        LogError("Invalid arguments: key = %p, keyLen = %lu", key, (unsigned long)keyLen);
+        result = NULL;
+    }
+    else if ((result = (HMACSHA256_KEY*)malloc(sizeof(HMACSHA256_KEY))) == NULL)
+    {
+        LogError("Cannot allocate memory for the HMAC key");
+    }
+    else
+    {
+        HMACContext ctx;
+
+        /* hmacReset leaves the inner hash primed with the ipad block and keeps the opad block */
+        if ((hmacReset(&ctx, SHA256, key, (int)keyLen) != shaSuccess) ||
+            (USHAReset(&result->outer, SHA256) != shaSuccess) ||
+            (USHAInput(&result->outer, ctx.k_opad, (unsigned int)ctx.blockSize) != shaSuccess))
+        {
+            LogError("Cannot compute the HMAC key pads");
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            result->inner = ctx.shaContext;
+        }
+    }
+
+    return result;
+}
+
+void HMACSHA256_DestroyKey(HMACSHA256_KEY_HANDLE key)
+{
+    if (key == NULL)
+    {
+        LogError("NULL key");
+    }
+    else
+    {
+        free(key);
+    }
+}
+
+HMACSHA256_RESULT HMACSHA256_ComputeHashWithKeyInto(HMACSHA256_KEY_HANDLE key, const unsigned char* payload, size_t payloadLen, unsigned char* hash)
+{
+    HMACSHA256_RESULT result;
+
+    if (key == NULL ||
+        payload == NULL ||
+        payloadLen == 0 ||
+        payloadLen > UINT_MAX ||
+        hash == NULL)
+    {
+        result = HMACSHA256_INVALID_ARG;
+    }
+    else
+    {
+        /* the key is only read, each signature works on copies of the pad states */
+        USHAContext inner = key->inner;
+        USHAContext outer = key->outer;
+        uint8_t innerHash[USHAMaxHashSize];
+
+        if ((USHAInput(&inner, payload, (unsigned int)payloadLen) != shaSuccess) ||
+            (USHAResult(&inner, innerHash) != shaSuccess) ||
+            (USHAInput(&outer, innerHash, HMACSHA256_HASH_SIZE) != shaSuccess) ||
+            (USHAResult(&outer, hash) != shaSuccess))
+        {
+            result = HMACSHA256_ERROR;
+        }
+        else
+        {
+            result = HMACSHA256_OK;
+        }
+    }
+
+    return result;
+}
+
+HMACSHA256_RESULT HMACSHA256_ComputeHashWithKey(HMACSHA256_KEY_HANDLE key, const unsigned char* payload, size_t payloadLen, BUFFER_HANDLE hash)
+{
+    HMACSHA256_RESULT result;
+
+    if (key == NULL ||
+        payload == NULL ||
+        payloadLen == 0 ||
+        hash == NULL)
+    {
+        result = HMACSHA256_INVALID_ARG;
+    }
+    else if (BUFFER_enlarge(hash, HMACSHA256_HASH_SIZE) != 0)
+    {
+        result = HMACSHA256_ERROR;
+    }
+    else
+    {
+        result = HMACSHA256_ComputeHashWithKeyInto(key, payload, payloadLen, BUFFER_u_char(hash));
+    }
+
+    return result;
+}
@@ -13,6 +13,7 @@
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/http_proxy_io.h"
 #include "azure_c_shared_utility/base64.h"
+#include "azure_c_shared_utility/tickcounter.h"
 
 typedef enum HTTP_PROXY_IO_STATE_TAG
 {
@@ -44,8 +45,53 @@ typedef struct HTTP_PROXY_IO_INSTANCE_TAG
     XIO_HANDLE underlying_io;
     unsigned char* receive_buffer;
     size_t receive_buffer_size;
+    HTTP_PROXY_IO_POOL_HANDLE pool;
+    /* Tunnel taken from the pool on the last open, all IO calls are forwarded to it while set */
+    struct HTTP_PROXY_IO_INSTANCE_TAG* pooled_tunnel;
 } HTTP_PROXY_IO_INSTANCE;
 
+typedef enum HTTP_PROXY_IO_POOL_TUNNEL_STATE_TAG
+{
+    HTTP_PROXY_IO_POOL_TUNNEL_STATE_EMPTY,
+    HTTP_PROXY_IO_POOL_TUNNEL_STATE_OPENING,
+    HTTP_PROXY_IO_POOL_TUNNEL_STATE_IDLE,
+    HTTP_PROXY_IO_POOL_TUNNEL_STATE_FAILED,
+    HTTP_PROXY_IO_POOL_TUNNEL_STATE_WAITING_TO_RETRY
+} HTTP_PROXY_IO_POOL_TUNNEL_STATE;
+
+typedef struct HTTP_PROXY_IO_POOL_TUNNEL_TAG
+{
+    HTTP_PROXY_IO_POOL_TUNNEL_STATE state;
+    HTTP_PROXY_IO_INSTANCE* instance;
+    /* Time at which the tunnel entered its current state */
+    tickcounter_ms_t state_start_ms;
+    struct HTTP_PROXY_IO_POOL_TAG* pool;
+} HTTP_PROXY_IO_POOL_TUNNEL;
+
+typedef struct HTTP_PROXY_IO_POOL_HOST_TAG
+{
+    struct HTTP_PROXY_IO_POOL_HOST_TAG* next;
+    char* hostname;
+    int port;
+    /* tunnels_per_host slots follow the host in the same allocation */
+    HTTP_PROXY_IO_POOL_TUNNEL* tunnels;
+} HTTP_PROXY_IO_POOL_HOST;
+
+typedef struct HTTP_PROXY_IO_POOL_TAG
+{
+    char* proxy_hostname;
+    int proxy_port;
+    char* username;
+    char* password;
+    size_t tunnels_per_host;
+    tickcounter_ms_t idle_timeout_ms;
+    tickcounter_ms_t retry_interval_ms;
+    TICK_COUNTER_HANDLE tick_counter;
+    HTTP_PROXY_IO_POOL_HOST* hosts;
+} HTTP_PROXY_IO_POOL;
+
+static HTTP_PROXY_IO_INSTANCE* take_pooled_tunnel(HTTP_PROXY_IO_POOL* pool, const HTTP_PROXY_IO_INSTANCE* http_proxy_io_instance);
+
 static CONCRETE_IO_HANDLE http_proxy_io_create(void* io_create_parameters)
 {
     HTTP_PROXY_IO_INSTANCE* result;
@@ -186,6 +232,8 @@ static CONCRETE_IO_HANDLE http_proxy_io_create(void* io_create_parameters)
                                         result->proxy_port = http_proxy_io_config->proxy_port;
                                         result->receive_buffer = NULL;
                                         result->receive_buffer_size = 0;
+                                        result->pool = NULL;
+                                        result->pooled_tunnel = NULL;
                                         result->http_proxy_io_state = HTTP_PROXY_IO_STATE_CLOSED;
                                     }
                                 }
@@ -217,6 +265,12 @@ static void http_proxy_io_destroy(CONCRETE_IO_HANDLE http_proxy_io)
             free(http_proxy_io_instance->receive_buffer);
         }
 
+        if (http_proxy_io_instance->pooled_tunnel != NULL)
+        {
+            /* Codes_SRS_HTTP_PROXY_IO_01_103: [ `http_proxy_io_destroy` shall destroy the tunnel taken from the pool, if any. ]*/
+            http_proxy_io_destroy(http_proxy_io_instance->pooled_tunnel);
+        }
+
         /* Codes_SRS_HTTP_PROXY_IO_01_016: [ `http_proxy_io_destroy` shall destroy the underlying IO created in `http_proxy_io_create` by calling `xio_destroy`. ]*/
         xio_destroy(http_proxy_io_instance->underlying_io);
         free(http_proxy_io_instance->hostname);
@@ -722,13 +776,24 @@ static int http_proxy_io_open(CONCRETE_IO_HANDLE http_proxy_io, ON_IO_OPEN_COMPL
     {
         HTTP_PROXY_IO_INSTANCE* http_proxy_io_instance = (HTTP_PROXY_IO_INSTANCE*)http_proxy_io;
 
-        if (http_proxy_io_instance->http_proxy_io_state != HTTP_PROXY_IO_STATE_CLOSED)
+        if ((http_proxy_io_instance->http_proxy_io_state != HTTP_PROXY_IO_STATE_CLOSED) ||
+            /* Codes_SRS_HTTP_PROXY_IO_01_101: [ If a tunnel taken from the pool by a previous open is not yet closed, `http_proxy_io_open` shall fail and return a non-zero value. ]*/
+            ((http_proxy_io_instance->pooled_tunnel != NULL) && (http_proxy_io_instance->pooled_tunnel->http_proxy_io_state != HTTP_PROXY_IO_STATE_CLOSED)))
         {
             LogError("Invalid tlsio_state. Expected state is HTTP_PROXY_IO_STATE_CLOSED.");
             result = __LINE__;
         }
         else
         {
+            HTTP_PROXY_IO_INSTANCE* pooled_tunnel;
+
+            if (http_proxy_io_instance->pooled_tunnel != NULL)
+            {
+                /* Codes_SRS_HTTP_PROXY_IO_01_102: [ A closed tunnel taken from the pool by a previous open shall be destroyed. ]*/
+                http_proxy_io_destroy(http_proxy_io_instance->pooled_tunnel);
+                http_proxy_io_instance->pooled_tunnel = NULL;
+            }
+
             http_proxy_io_instance->on_bytes_received = on_bytes_received;
             http_proxy_io_instance->on_bytes_received_context = on_bytes_received_context;
 
@@ -738,20 +803,41 @@ static int http_proxy_io_open(CONCRETE_IO_HANDLE http_proxy_io, ON_IO_OPEN_COMPL
             http_proxy_io_instance->on_io_open_complete = on_io_open_complete;
             http_proxy_io_instance->on_io_open_complete_context = on_io_open_complete_context;
 
-            http_proxy_io_instance->http_proxy_io_state = HTTP_PROXY_IO_STATE_OPENING_UNDERLYING_IO;
-
-            /* Codes_SRS_HTTP_PROXY_IO_01_019: [ `http_proxy_io_open` shall open the underlying IO by calling `xio_open` on the underlying IO handle created in `http_proxy_io_create`, while passing to it the callbacks `on_underlying_io_open_complete`, `on_underlying_io_bytes_received` and `on_underlying_io_error`. ]*/
-            if (xio_open(http_proxy_io_instance->underlying_io, on_underlying_io_open_complete, http_proxy_io_instance, on_underlying_io_bytes_received, http_proxy_io_instance, on_underlying_io_error, http_proxy_io_instance) != 0)
+            /* Codes_SRS_HTTP_PROXY_IO_01_097: [ If a pool was attached with the option `http_proxy_io_pool`, `http_proxy_io_open` shall take an established tunnel from the pool for the same target host, port, proxy and credentials. ]*/
+            pooled_tunnel = (http_proxy_io_instance->pool == NULL) ? NULL : take_pooled_tunnel(http_proxy_io_instance->pool, http_proxy_io_instance);
+            if (pooled_tunnel != NULL)
             {
-                /* Codes_SRS_HTTP_PROXY_IO_01_020: [ If `xio_open` fails, then `http_proxy_io_open` shall return a non-zero value. ]*/
-                http_proxy_io_instance->http_proxy_io_state = HTTP_PROXY_IO_STATE_CLOSED;
-                LogError("Cannot open the underlying IO.");
-                result = __LINE__;
+                /* Codes_SRS_HTTP_PROXY_IO_01_098: [ When a tunnel is taken from the pool, the `on_bytes_received` and `on_io_error` callbacks shall be indicated by the tunnel and all subsequent send, close and dowork calls shall be forwarded to it. ]*/
+                pooled_tunnel->on_bytes_received = on_bytes_received;
+                pooled_tunnel->on_bytes_received_context = on_bytes_received_context;
+                pooled_tunnel->on_io_error = on_io_error;
+                pooled_tunnel->on_io_error_context = on_io_error_context;
+                pooled_tunnel->on_io_open_complete = on_io_open_complete;
+                pooled_tunnel->on_io_open_complete_context = on_io_open_complete_context;
+                http_proxy_io_instance->pooled_tunnel = pooled_tunnel;
+
+                /* Codes_SRS_HTTP_PROXY_IO_01_099: [ When a tunnel is taken from the pool, `on_io_open_complete` shall be called with `IO_OPEN_OK` and `http_proxy_io_open` shall return 0. ]*/
+                on_io_open_complete(on_io_open_complete_context, IO_OPEN_OK);
+                result = 0;
             }
             else
             {
-                /* Codes_SRS_HTTP_PROXY_IO_01_017: [ `http_proxy_io_open` shall open the HTTP proxy IO and on success it shall return 0. ]*/
-                result = 0;
+                http_proxy_io_instance->http_proxy_io_state = HTTP_PROXY_IO_STATE_OPENING_UNDERLYING_IO;
+
+                /* Codes_SRS_HTTP_PROXY_IO_01_100: [ If no pool is attached or the pool has no established tunnel for the target, `http_proxy_io_open` shall open its own underlying IO and perform the CONNECT handshake. ]*/
+                /* Codes_SRS_HTTP_PROXY_IO_01_019: [ `http_proxy_io_open` shall open the underlying IO by calling `xio_open` on the underlying IO handle created in `http_proxy_io_create`, while passing to it the callbacks `on_underlying_io_open_complete`, `on_underlying_io_bytes_received` and `on_underlying_io_error`. ]*/
+                if (xio_open(http_proxy_io_instance->underlying_io, on_underlying_io_open_complete, http_proxy_io_instance, on_underlying_io_bytes_received, http_proxy_io_instance, on_underlying_io_error, http_proxy_io_instance) != 0)
+                {
+                    /* Codes_SRS_HTTP_PROXY_IO_01_020: [ If `xio_open` fails, then `http_proxy_io_open` shall return a non-zero value. ]*/
+                    http_proxy_io_instance->http_proxy_io_state = HTTP_PROXY_IO_STATE_CLOSED;
+                    LogError("Cannot open the underlying IO.");
+                    result = __LINE__;
+                }
+                else
+                {
+                    /* Codes_SRS_HTTP_PROXY_IO_01_017: [ `http_proxy_io_open` shall open the HTTP proxy IO and on success it shall return 0. ]*/
+                    result = 0;
+                }
             }
         }
     }
@@ -775,8 +861,14 @@ static int http_proxy_io_close(CONCRETE_IO_HANDLE http_proxy_io, ON_IO_CLOSE_COM
     {
         HTTP_PROXY_IO_INSTANCE* http_proxy_io_instance = (HTTP_PROXY_IO_INSTANCE*)http_proxy_io;
 
+        if (http_proxy_io_instance->pooled_tunnel != NULL)
+        {
+            /* Codes_SRS_HTTP_PROXY_IO_01_098: [ When a tunnel is taken from the pool, the `on_bytes_received` and `on_io_error` callbacks shall be indicated by the tunnel and all subsequent send, close and dowork calls shall be forwarded to it. ]*/
+            /* Codes_SRS_HTTP_PROXY_IO_01_125: [ Closing a tunnel taken from the pool shall close its connection to the proxy; the tunnel shall not be returned to the pool. ]*/
+            result = http_proxy_io_close(http_proxy_io_instance->pooled_tunnel, on_io_close_complete, on_io_close_complete_context);
+        }
         /* Codes_SRS_HTTP_PROXY_IO_01_027: [ If `http_proxy_io_close` is called when not open, `http_proxy_io_close` shall fail and return a non-zero value. ]*/
-        if ((http_proxy_io_instance->http_proxy_io_state == HTTP_PROXY_IO_STATE_CLOSED) ||
+        else if ((http_proxy_io_instance->http_proxy_io_state == HTTP_PROXY_IO_STATE_CLOSED) ||
             /* Codes_SRS_HTTP_PROXY_IO_01_054: [ `http_proxy_io_close` while OPENING shall fail and return a non-zero value. ]*/
             (http_proxy_io_instance->http_proxy_io_state == HTTP_PROXY_IO_STATE_CLOSING))
         {
@@ -842,6 +934,12 @@ static int http_proxy_io_send(CONCRETE_IO_HANDLE http_proxy_io, const void* buff
     {
         HTTP_PROXY_IO_INSTANCE* http_proxy_io_instance = (HTTP_PROXY_IO_INSTANCE*)http_proxy_io;
 
+        /* Codes_SRS_HTTP_PROXY_IO_01_098: [ When a tunnel is taken from the pool, the `on_bytes_received` and `on_io_error` callbacks shall be indicated by the tunnel and all subsequent send, close and dowork calls shall be forwarded to it. ]*/
+        if (http_proxy_io_instance->pooled_tunnel != NULL)
+        {
+            http_proxy_io_instance = http_proxy_io_instance->pooled_tunnel;
+        }
+
         /* Codes_SRS_HTTP_PROXY_IO_01_034: [ If `http_proxy_io_send` is called when the IO is not open, `http_proxy_io_send` shall fail and return a non-zero value. ]*/
         /* Codes_SRS_HTTP_PROXY_IO_01_035: [ If the IO is in an error state (an error was reported through the `on_io_error` callback), `http_proxy_io_send` shall fail and return a non-zero value. ]*/
         if (http_proxy_io_instance->http_proxy_io_state != HTTP_PROXY_IO_STATE_OPEN)
@@ -880,6 +978,12 @@ static void http_proxy_io_dowork(CONCRETE_IO_HANDLE http_proxy_io)
     {
         HTTP_PROXY_IO_INSTANCE* http_proxy_io_instance = (HTTP_PROXY_IO_INSTANCE*)http_proxy_io;
 
+        /* Codes_SRS_HTTP_PROXY_IO_01_098: [ When a tunnel is taken from the pool, the `on_bytes_received` and `on_io_error` callbacks shall be indicated by the tunnel and all subsequent send, close and dowork calls shall be forwarded to it. ]*/
+        if (http_proxy_io_instance->pooled_tunnel != NULL)
+        {
+            http_proxy_io_instance = http_proxy_io_instance->pooled_tunnel;
+        }
+
         if (http_proxy_io_instance->http_proxy_io_state != HTTP_PROXY_IO_STATE_CLOSED)
         {
             /* Codes_SRS_HTTP_PROXY_IO_01_037: [ `http_proxy_io_dowork` shall call `xio_dowork` on the underlying IO created in `http_proxy_io_create`. ]*/
@@ -903,16 +1007,28 @@ static int http_proxy_io_set_option(CONCRETE_IO_HANDLE http_proxy_io, const char
     {
         HTTP_PROXY_IO_INSTANCE* http_proxy_io_instance = (HTTP_PROXY_IO_INSTANCE*)http_proxy_io;
 
-        /* Codes_SRS_HTTP_PROXY_IO_01_045: [ None. ]*/
-
+        /* Codes_SRS_HTTP_PROXY_IO_01_045: [ `http_proxy_io_pool` - the value is the `HTTP_PROXY_IO_POOL_HANDLE` used by subsequent opens, NULL detaches the pool. ]*/
+        if (strcmp(option_name, OPTION_HTTP_PROXY_IO_POOL) == 0)
+        {
+            http_proxy_io_instance->pool = (HTTP_PROXY_IO_POOL_HANDLE)value;
+            result = 0;
+        }
         /* Codes_SRS_HTTP_PROXY_IO_01_043: [ If the `option_name` argument indicates an option that is not handled by `http_proxy_io_set_option`, then `xio_setoption` shall be called on the underlying IO created in `http_proxy_io_create`, passing the option name and value to it. ]*/
         /* Codes_SRS_HTTP_PROXY_IO_01_056: [ The `value` argument shall be allowed to be NULL. ]*/
-        if (xio_setoption(http_proxy_io_instance->underlying_io, option_name, value) != 0)
+        else if (xio_setoption(http_proxy_io_instance->underlying_io, option_name, value) != 0)
         {
             /* Codes_SRS_HTTP_PROXY_IO_01_044: [ if `xio_setoption` fails, `http_proxy_io_set_option` shall return a non-zero value. ]*/
             LogError("Unrecognized option");
             result = __LINE__;
         }
+        /* Codes_SRS_HTTP_PROXY_IO_01_123: [ If a tunnel was taken from the pool by the last open, `xio_setoption` shall also be called on the underlying IO of the tunnel, so that the option applies to the live connection. ]*/
+        else if ((http_proxy_io_instance->pooled_tunnel != NULL) &&
+            (xio_setoption(http_proxy_io_instance->pooled_tunnel->underlying_io, option_name, value) != 0))
+        {
+            /* Codes_SRS_HTTP_PROXY_IO_01_044: [ if `xio_setoption` fails, `http_proxy_io_set_option` shall return a non-zero value. ]*/
+            LogError("Cannot set the option on the pooled tunnel");
+            result = __LINE__;
+        }
         else
         {
             /* Codes_SRS_HTTP_PROXY_IO_01_042: [ If the option was handled by `http_proxy_io_set_option` or the underlying IO, then `http_proxy_io_set_option` shall return 0. ]*/
@@ -937,6 +1053,12 @@ static OPTIONHANDLER_HANDLE http_proxy_io_retrieve_options(CONCRETE_IO_HANDLE ht
     {
         HTTP_PROXY_IO_INSTANCE* http_proxy_io_instance = (HTTP_PROXY_IO_INSTANCE*)http_proxy_io;
 
+        /* Codes_SRS_HTTP_PROXY_IO_01_124: [ If a tunnel was taken from the pool by the last open, `http_proxy_io_retrieve_options` shall call `xio_retrieveoptions` on the underlying IO of the tunnel instead. ]*/
+        if (http_proxy_io_instance->pooled_tunnel != NULL)
+        {
+            http_proxy_io_instance = http_proxy_io_instance->pooled_tunnel;
+        }
+
         /* Codes_SRS_HTTP_PROXY_IO_01_046: [ `http_proxy_io_retrieve_options` shall return an `OPTIONHANDLER_HANDLE` obtained by calling `xio_retrieveoptions` on the underlying IO created in `http_proxy_io_create`. ]*/
         result = xio_retrieveoptions(http_proxy_io_instance->underlying_io);
         if (result == NULL)
@@ -965,3 +1087,381 @@ const IO_INTERFACE_DESCRIPTION* http_proxy_io_get_interface_description(void)
     /* Codes_SRS_HTTP_PROXY_IO_01_049: [ `http_proxy_io_get_interface_description` shall return a pointer to an `IO_INTERFACE_DESCRIPTION` structure that contains pointers to the functions: `http_proxy_io_retrieve_options`, `http_proxy_io_retrieve_create`, `http_proxy_io_destroy`, `http_proxy_io_open`, `http_proxy_io_close`, `http_proxy_io_send` and `http_proxy_io_dowork`. ]*/
     return &http_proxy_io_interface_description;
 }
+
+static bool are_optional_strings_equal(const char* left, const char* right)
+{
+    bool result;
+
+    if ((left == NULL) || (right == NULL))
+    {
+        result = (left == right);
+    }
+    else
+    {
+        result = (strcmp(left, right) == 0);
+    }
+
+    return result;
+}
+
+static HTTP_PROXY_IO_INSTANCE* take_pooled_tunnel(HTTP_PROXY_IO_POOL* pool, const HTTP_PROXY_IO_INSTANCE* http_proxy_io_instance)
+{
+    HTTP_PROXY_IO_INSTANCE* result = NULL;
+
+    /* Codes_SRS_HTTP_PROXY_IO_01_097: [ If a pool was attached with the option `http_proxy_io_pool`, `http_proxy_io_open` shall take an established tunnel from the pool for the same target host, port, proxy and credentials. ]*/
+    if ((pool->proxy_port == http_proxy_io_instance->proxy_port) &&
+        (strcmp(pool->proxy_hostname, http_proxy_io_instance->proxy_hostname) == 0) &&
+        are_optional_strings_equal(pool->username, http_proxy_io_instance->username) &&
+        are_optional_strings_equal(pool->password, http_proxy_io_instance->password))
+    {
+        HTTP_PROXY_IO_POOL_HOST* host = pool->hosts;
+
+        while ((host != NULL) &&
+            ((host->port != http_proxy_io_instance->port) || (strcmp(host->hostname, http_proxy_io_instance->hostname) != 0)))
+        {
+            host = host->next;
+        }
+
+        if (host != NULL)
+        {
+            size_t i;
+
+            for (i = 0; i < pool->tunnels_per_host; i++)
+            {
+                HTTP_PROXY_IO_POOL_TUNNEL* tunnel = &host->tunnels[i];
+                if ((tunnel->state == HTTP_PROXY_IO_POOL_TUNNEL_STATE_IDLE) &&
+                    (tunnel->instance->http_proxy_io_state == HTTP_PROXY_IO_STATE_OPEN))
+                {
+                    /* Codes_SRS_HTTP_PROXY_IO_01_104: [ A tunnel taken from the pool shall be removed from it and its slot shall be refilled by the next `http_proxy_io_pool_dowork`. ]*/
+                    result = tunnel->instance;
+                    tunnel->instance = NULL;
+                    tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_EMPTY;
+                    break;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+static void on_pool_tunnel_open_complete(void* context, IO_OPEN_RESULT open_result)
+{
+    HTTP_PROXY_IO_POOL_TUNNEL* tunnel = (HTTP_PROXY_IO_POOL_TUNNEL*)context;
+
+    if (open_result != IO_OPEN_OK)
+    {
+        /* Codes_SRS_HTTP_PROXY_IO_01_119: [ If establishing a pooled tunnel fails, the tunnel shall be destroyed by the next `http_proxy_io_pool_dowork` and re-established only after `retry_interval_ms`. ]*/
+        LogError("Establishing pooled tunnel failed");
+        tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_FAILED;
+    }
+    else if (tickcounter_get_current_ms(tunnel->pool->tick_counter, &tunnel->state_start_ms) != 0)
+    {
+        LogError("Cannot get current time for pooled tunnel");
+        tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_FAILED;
+    }
+    else
+    {
+        /* Codes_SRS_HTTP_PROXY_IO_01_118: [ Once the CONNECT response for a pooled tunnel is received, the tunnel shall be available to `http_proxy_io_open`. ]*/
+        tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_IDLE;
+    }
+}
+
+static void on_pool_tunnel_bytes_received(void* context, const unsigned char* buffer, size_t size)
+{
+    HTTP_PROXY_IO_POOL_TUNNEL* tunnel = (HTTP_PROXY_IO_POOL_TUNNEL*)context;
+    (void)buffer;
+
+    /* Codes_SRS_HTTP_PROXY_IO_01_120: [ If bytes are received on a pooled tunnel before it is handed out, or the tunnel reports an error, the tunnel shall be discarded by the next `http_proxy_io_pool_dowork`. ]*/
+    LogError("Unexpected %lu bytes received on idle pooled tunnel", (unsigned long)size);
+    tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_FAILED;
+}
+
+static void on_pool_tunnel_error(void* context)
+{
+    HTTP_PROXY_IO_POOL_TUNNEL* tunnel = (HTTP_PROXY_IO_POOL_TUNNEL*)context;
+
+    /* Codes_SRS_HTTP_PROXY_IO_01_120: [ If bytes are received on a pooled tunnel before it is handed out, or the tunnel reports an error, the tunnel shall be discarded by the next `http_proxy_io_pool_dowork`. ]*/
+    LogError("Error on pooled tunnel");
+    tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_FAILED;
+}
+
+static void open_pool_tunnel(HTTP_PROXY_IO_POOL* pool, HTTP_PROXY_IO_POOL_HOST* host, HTTP_PROXY_IO_POOL_TUNNEL* tunnel, tickcounter_ms_t current_ms)
+{
+    HTTP_PROXY_IO_CONFIG tunnel_config;
+
+    tunnel_config.hostname = host->hostname;
+    tunnel_config.port = host->port;
+    tunnel_config.proxy_hostname = pool->proxy_hostname;
+    tunnel_config.proxy_port = pool->proxy_port;
+    tunnel_config.username = pool->username;
+    tunnel_config.password = pool->password;
+
+    tunnel->state_start_ms = current_ms;
+
+    /* Codes_SRS_HTTP_PROXY_IO_01_115: [ For each empty tunnel slot of each registered host, `http_proxy_io_pool_dowork` shall create an HTTP proxy IO for the host and open it, which connects to the proxy and sends the CONNECT request. ]*/
+    tunnel->instance = (HTTP_PROXY_IO_INSTANCE*)http_proxy_io_create(&tunnel_config);
+    if (tunnel->instance == NULL)
+    {
+        /* Codes_SRS_HTTP_PROXY_IO_01_117: [ If creating or opening the tunnel fails, the slot shall be retried after `retry_interval_ms`. ]*/
+        LogError("Cannot create pooled tunnel for %s:%d", host->hostname, host->port);
+        tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_WAITING_TO_RETRY;
+    }
+    else
+    {
+        int keep_alive = 1;
+
+        /* Codes_SRS_HTTP_PROXY_IO_01_116: [ TCP keep-alive shall be enabled on the tunnel by setting the `tcp_keepalive` option on its socket IO. Failure to set the option shall be ignored. ]*/
+        if (xio_setoption(tunnel->instance->underlying_io, "tcp_keepalive", &keep_alive) != 0)
+        {
+            LogInfo("TCP keep-alive not available for pooled tunnel");
+        }
+
+        tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_OPENING;
+        if (http_proxy_io_open(tunnel->instance, on_pool_tunnel_open_complete, tunnel, on_pool_tunnel_bytes_received, tunnel, on_pool_tunnel_error, tunnel) != 0)
+        {
+            /* Codes_SRS_HTTP_PROXY_IO_01_117: [ If creating or opening the tunnel fails, the slot shall be retried after `retry_interval_ms`. ]*/
+            LogError("Cannot open pooled tunnel for %s:%d", host->hostname, host->port);
+            http_proxy_io_destroy(tunnel->instance);
+            tunnel->instance = NULL;
+            tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_WAITING_TO_RETRY;
+        }
+    }
+}
+
+static void destroy_pool_host(HTTP_PROXY_IO_POOL* pool, HTTP_PROXY_IO_POOL_HOST* host)
+{
+    size_t i;
+
+    for (i = 0; i < pool->tunnels_per_host; i++)
+    {
+        if (host->tunnels[i].instance != NULL)
+        {
+            http_proxy_io_destroy(host->tunnels[i].instance);
+        }
+    }
+
+    free(host->hostname);
+    free(host);
+}
+
+HTTP_PROXY_IO_POOL_HANDLE http_proxy_io_pool_create(const HTTP_PROXY_IO_POOL_CONFIG* config)
+{
+    HTTP_PROXY_IO_POOL* result;
+
+    if ((config == NULL) ||
+        (config->proxy_hostname == NULL) ||
+        (config->tunnels_per_host == 0) ||
+        ((config->username == NULL) != (config->password == NULL)))
+    {
+        /* Codes_SRS_HTTP_PROXY_IO_01_106: [ If `config` or its `proxy_hostname` member is NULL, `tunnels_per_host` is 0, or only one of `username` and `password` is non-NULL, `http_proxy_io_pool_create` shall fail and return NULL. ]*/
+        LogError("Bad arguments: config = %p", config);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_HTTP_PROXY_IO_01_105: [ `http_proxy_io_pool_create` shall create a pool of tunnels through the proxy given in `config`, copying the proxy host name and credentials. ]*/
+        result = (HTTP_PROXY_IO_POOL*)malloc(sizeof(HTTP_PROXY_IO_POOL));
+        if (result == NULL)
+        {
+            /* Codes_SRS_HTTP_PROXY_IO_01_107: [ If any failure occurs, `http_proxy_io_pool_create` shall free all resources allocated so far and return NULL. ]*/
+            LogError("Cannot allocate HTTP proxy IO pool");
+        }
+        else
+        {
+            result->proxy_hostname = NULL;
+            result->username = NULL;
+            result->password = NULL;
+            result->hosts = NULL;
+
+            if ((mallocAndStrcpy_s(&result->proxy_hostname, config->proxy_hostname) != 0) ||
+                ((config->username != NULL) && (mallocAndStrcpy_s(&result->username, config->username) != 0)) ||
+                ((config->password != NULL) && (mallocAndStrcpy_s(&result->password, config->password) != 0)))
+            {
+                /* Codes_SRS_HTTP_PROXY_IO_01_107: [ If any failure occurs, `http_proxy_io_pool_create` shall free all resources allocated so far and return NULL. ]*/
+                LogError("Cannot copy HTTP proxy IO pool configuration");
+                free(result->password);
+                free(result->username);
+                free(result->proxy_hostname);
+                free(result);
+                result = NULL;
+            }
+            else if ((result->tick_counter = tickcounter_create()) == NULL)
+            {
+                /* Codes_SRS_HTTP_PROXY_IO_01_107: [ If any failure occurs, `http_proxy_io_pool_create` shall free all resources allocated so far and return NULL. ]*/
+                LogError("Cannot create tick counter for HTTP proxy IO pool");
+                free(result->password);
+                free(result->username);
+                free(result->proxy_hostname);
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                result->proxy_port = config->proxy_port;
+                result->tunnels_per_host = config->tunnels_per_host;
+                result->idle_timeout_ms = config->idle_timeout_ms;
+                result->retry_interval_ms = config->retry_interval_ms;
+            }
+        }
+    }
+
+    return result;
+}
+
+void http_proxy_io_pool_destroy(HTTP_PROXY_IO_POOL_HANDLE pool)
+{
+    if (pool == NULL)
+    {
+        /* Codes_SRS_HTTP_PROXY_IO_01_109: [ If `pool` is NULL, `http_proxy_io_pool_destroy` shall do nothing. ]*/
+        LogError("NULL pool.");
+    }
+    else
+    {
+        /* Codes_SRS_HTTP_PROXY_IO_01_108: [ `http_proxy_io_pool_destroy` shall destroy all tunnels still held by the pool and free the pool. ]*/
+        while (pool->hosts != NULL)
+        {
+            HTTP_PROXY_IO_POOL_HOST* next_host = pool->hosts->next;
+            destroy_pool_host(pool, pool->hosts);
+            pool->hosts = next_host;
+        }
+
+        tickcounter_destroy(pool->tick_counter);
+        free(pool->password);
+        free(pool->username);
+        free(pool->proxy_hostname);
+        free(pool);
+    }
+}
+
+int http_proxy_io_pool_add_host(HTTP_PROXY_IO_POOL_HANDLE pool, const char* hostname, int port)
+{
+    int result;
+
+    if ((pool == NULL) || (hostname == NULL))
+    {
+        /* Codes_SRS_HTTP_PROXY_IO_01_111: [ If `pool` or `hostname` is NULL, `http_proxy_io_pool_add_host` shall fail and return a non-zero value. ]*/
+        LogError("Bad arguments: pool = %p, hostname = %p", pool, hostname);
+        result = __LINE__;
+    }
+    else
+    {
+        HTTP_PROXY_IO_POOL_HOST* host = pool->hosts;
+
+        while ((host != NULL) &&
+            ((host->port != port) || (strcmp(host->hostname, hostname) != 0)))
+        {
+            host = host->next;
+        }
+
+        if (host != NULL)
+        {
+            /* Codes_SRS_HTTP_PROXY_IO_01_112: [ If the host and port were already added, `http_proxy_io_pool_add_host` shall succeed without adding them again. ]*/
+            result = 0;
+        }
+        else
+        {
+            /* Codes_SRS_HTTP_PROXY_IO_01_110: [ `http_proxy_io_pool_add_host` shall register `hostname` and `port` as a target for which `tunnels_per_host` tunnels are kept established. ]*/
+            host = (HTTP_PROXY_IO_POOL_HOST*)malloc(sizeof(HTTP_PROXY_IO_POOL_HOST) + (pool->tunnels_per_host * sizeof(HTTP_PROXY_IO_POOL_TUNNEL)));
+            if (host == NULL)
+            {
+                /* Codes_SRS_HTTP_PROXY_IO_01_113: [ If any failure occurs, `http_proxy_io_pool_add_host` shall fail and return a non-zero value. ]*/
+                LogError("Cannot allocate pool host");
+                result = __LINE__;
+            }
+            else if (mallocAndStrcpy_s(&host->hostname, hostname) != 0)
+            {
+                /* Codes_SRS_HTTP_PROXY_IO_01_113: [ If any failure occurs, `http_proxy_io_pool_add_host` shall fail and return a non-zero value. ]*/
+                LogError("Cannot copy pool host name");
+                free(host);
+                result = __LINE__;
+            }
+            else
+            {
+                size_t i;
+
+                host->port = port;
+                host->tunnels = (HTTP_PROXY_IO_POOL_TUNNEL*)(host + 1);
+                for (i = 0; i < pool->tunnels_per_host; i++)
+                {
+                    host->tunnels[i].state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_EMPTY;
+                    host->tunnels[i].instance = NULL;
+                    host->tunnels[i].state_start_ms = 0;
+                    host->tunnels[i].pool = pool;
+                }
+
+                host->next = pool->hosts;
+                pool->hosts = host;
+                result = 0;
+            }
+        }
+    }
+
+    return result;
+}
+
+void http_proxy_io_pool_dowork(HTTP_PROXY_IO_POOL_HANDLE pool)
+{
+    tickcounter_ms_t current_ms;
+
+    if (pool == NULL)
+    {
+        /* Codes_SRS_HTTP_PROXY_IO_01_114: [ If `pool` is NULL, `http_proxy_io_pool_dowork` shall do nothing. ]*/
+        LogError("NULL pool.");
+    }
+    else if (tickcounter_get_current_ms(pool->tick_counter, &current_ms) != 0)
+    {
+        LogError("Cannot get current time for HTTP proxy IO pool");
+    }
+    else
+    {
+        HTTP_PROXY_IO_POOL_HOST* host;
+
+        for (host = pool->hosts; host != NULL; host = host->next)
+        {
+            size_t i;
+
+            for (i = 0; i < pool->tunnels_per_host; i++)
+            {
+                HTTP_PROXY_IO_POOL_TUNNEL* tunnel = &host->tunnels[i];
+
+                if ((tunnel->state == HTTP_PROXY_IO_POOL_TUNNEL_STATE_OPENING) ||
+                    (tunnel->state == HTTP_PROXY_IO_POOL_TUNNEL_STATE_IDLE))
+                {
+                    /* Codes_SRS_HTTP_PROXY_IO_01_121: [ `http_proxy_io_pool_dowork` shall call `xio_dowork` for every tunnel that is being established or idle. ]*/
+                    http_proxy_io_dowork(tunnel->instance);
+
+                    /* Codes_SRS_HTTP_PROXY_IO_01_122: [ A tunnel that stays idle, or being established, for longer than a non-zero `idle_timeout_ms` shall be destroyed and re-established, so the proxy never sees an idle connection long enough to drop it. ]*/
+                    if ((tunnel->state != HTTP_PROXY_IO_POOL_TUNNEL_STATE_FAILED) &&
+                        (pool->idle_timeout_ms > 0) &&
+                        (current_ms - tunnel->state_start_ms >= pool->idle_timeout_ms))
+                    {
+                        http_proxy_io_destroy(tunnel->instance);
+                        tunnel->instance = NULL;
+                        tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_EMPTY;
+                    }
+                }
+
+                if (tunnel->state == HTTP_PROXY_IO_POOL_TUNNEL_STATE_FAILED)
+                {
+                    /* Codes_SRS_HTTP_PROXY_IO_01_119: [ If establishing a pooled tunnel fails, the tunnel shall be destroyed by the next `http_proxy_io_pool_dowork` and re-established only after `retry_interval_ms`. ]*/
+                    http_proxy_io_destroy(tunnel->instance);
+                    tunnel->instance = NULL;
+                    tunnel->state_start_ms = current_ms;
+                    tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_WAITING_TO_RETRY;
+                }
+
+                if ((tunnel->state == HTTP_PROXY_IO_POOL_TUNNEL_STATE_WAITING_TO_RETRY) &&
+                    (current_ms - tunnel->state_start_ms >= pool->retry_interval_ms))
+                {
+                    tunnel->state = HTTP_PROXY_IO_POOL_TUNNEL_STATE_EMPTY;
+                }
+
+                if (tunnel->state == HTTP_PROXY_IO_POOL_TUNNEL_STATE_EMPTY)
+                {
+                    open_pool_tunnel(pool, host, tunnel, current_ms);
+                }
+            }
+        }
+    }
+}
@@ -2,6 +2,8 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/httpapiex.h"
 #include "azure_c_shared_utility/optimize_size.h"
@@ -9,6 +11,9 @@
 #include "azure_c_shared_utility/strings.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/vector.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/gb_rand.h"
 
 typedef struct HTTPAPIEX_SAVED_OPTION_TAG
 {
@@ -22,6 +27,9 @@ typedef struct HTTPAPIEX_HANDLE_DATA_TAG
     int k;
     HTTP_HANDLE httpHandle;
     VECTOR_HANDLE savedOptions;
+    HTTPAPIEX_RETRY_POLICY* retryPolicy;
+    TICK_COUNTER_HANDLE tickCounter;
+    HTTPAPIEX_STATISTICS statistics;
 }HTTPAPIEX_HANDLE_DATA;
 
 DEFINE_ENUM_STRINGS(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT_VALUES);
@@ -70,6 +78,9 @@ HTTPAPIEX_HANDLE HTTPAPIEX_Create(const char* hostName)
                 {
                     handleData->k = -1;
                     handleData->httpHandle = NULL;
+                    handleData->retryPolicy = NULL;
+                    handleData->tickCounter = NULL;
+                    (void)memset(&handleData->statistics, 0, sizeof(handleData->statistics));
                     result = handleData;
                 }
             }
@@ -294,6 +305,399 @@ static int buildAllRequests(HTTPAPIEX_HANDLE_DATA* handle, HTTPAPI_REQUEST_TYPE
     return result;
 }
 
+/*runs one pass of the Init/CreateConnection/ExecuteRequest sequence, recovering the earlier steps as needed*/
+static HTTPAPIEX_RESULT executeAttempt(HTTPAPIEX_HANDLE_DATA* handleData, HTTPAPI_REQUEST_TYPE requestType, const char* toBeUsedRelativePath,
+    HTTP_HEADERS_HANDLE toBeUsedRequestHttpHeadersHandle, BUFFER_HANDLE toBeUsedRequestContent, unsigned int* toBeUsedStatusCode,
+    HTTP_HEADERS_HANDLE toBeUsedResponseHttpHeadersHandle, BUFFER_HANDLE toBeUsedResponseContent)
+{
+    HTTPAPIEX_RESULT result;
+    /*Codes_SRS_HTTPAPIEX_02_023: [HTTPAPIEX_ExecuteRequest shall try to execute the HTTP call by ensuring the following API call sequence is respected:]*/
+    /*Codes_SRS_HTTPAPIEX_02_024: [If any point in the sequence fails, HTTPAPIEX_ExecuteRequest shall attempt to recover by going back to the previous step and retrying that step.]*/
+    /*Codes_SRS_HTTPAPIEX_02_025: [If the first step fails, then the sequence fails.]*/
+    /*Codes_SRS_HTTPAPIEX_02_026: [A step shall be retried at most once.]*/
+    /*Codes_SRS_HTTPAPIEX_02_027: [If a step has been retried then all subsequent steps shall be retried too.]*/
+    bool st[3] = { false, false, false }; /*the three levels of possible failure in resilient send: HTTAPI_Init, HTTPAPI_CreateConnection, HTTPAPI_ExecuteRequest*/
+    if (handleData->k == -1)
+    {
+        handleData->k = 0;
+    }
+
+    do
+    {
+        bool goOn;
+
+        if (handleData->k > 2)
+        {
+            /* error */
+            break;
+        }
+
+        if (st[handleData->k] == true) /*already been tried*/
+        {
+            goOn = false;
+        }
+        else
+        {
+            switch (handleData->k)
+            {
+            case 0:
+            {
+                if (HTTPAPI_Init() != HTTPAPI_OK)
+                {
+                    goOn = false;
+                }
+                else
+                {
+                    goOn = true;
+                }
+                break;
+            }
+            case 1:
+            {
+                if ((handleData->httpHandle = HTTPAPI_CreateConnection(STRING_c_str(handleData->hostName))) == NULL)
+                {
+                    goOn = false;
+                }
+                else
+                {
+                    size_t i;
+                    size_t vectorSize = VECTOR_size(handleData->savedOptions);
+                    for (i = 0; i < vectorSize; i++)
+                    {
+                        /*Codes_SRS_HTTPAPIEX_02_035: [HTTPAPIEX_ExecuteRequest shall pass all the saved options (see HTTPAPIEX_SetOption) to the newly create HTTPAPI_HANDLE in step 2 by calling HTTPAPI_SetOption.]*/
+                        /*Codes_SRS_HTTPAPIEX_02_036: [If setting the option fails, then the failure shall be ignored.] */
+                        HTTPAPIEX_SAVED_OPTION* option = (HTTPAPIEX_SAVED_OPTION*)VECTOR_element(handleData->savedOptions, i);
+                        if (HTTPAPI_SetOption(handleData->httpHandle, option->optionName, option->value) != HTTPAPI_OK)
+                        {
+                            LogError("HTTPAPI_SetOption failed when called for option %s", option->optionName);
+                        }
+                    }
+                    goOn = true;
+                }
+                break;
+            }
+            case 2:
+            {
+                size_t length = BUFFER_length(toBeUsedRequestContent);
+                unsigned char* buffer = BUFFER_u_char(toBeUsedRequestContent);
+                if (HTTPAPI_ExecuteRequest(handleData->httpHandle, requestType, toBeUsedRelativePath, toBeUsedRequestHttpHeadersHandle, buffer, length, toBeUsedStatusCode, toBeUsedResponseHttpHeadersHandle, toBeUsedResponseContent) != HTTPAPI_OK)
+                {
+                    goOn = false;
+                }
+                else
+                {
+                    goOn = true;
+                }
+                break;
+            }
+            default:
+            {
+                /*serious error*/
+                goOn = false;
+                break;
+            }
+            }
+        }
+
+        if (goOn)
+        {
+            if (handleData->k == 2)
+            {
+                /*Codes_SRS_HTTPAPIEX_02_028: [HTTPAPIEX_ExecuteRequest shall return HTTPAPIEX_OK when a call to HTTPAPI_ExecuteRequest has been completed successfully.]*/
+                result = HTTPAPIEX_OK;
+                goto out;
+            }
+            else
+            {
+                st[handleData->k] = true;
+                handleData->k++;
+                st[handleData->k] = false;
+            }
+        }
+        else
+        {
+            st[handleData->k] = false;
+            handleData->k--;
+            switch (handleData->k)
+            {
+            case 0:
+            {
+                HTTPAPI_Deinit();
+                break;
+            }
+            case 1:
+            {
+                HTTPAPI_CloseConnection(handleData->httpHandle);
+                handleData->httpHandle = NULL;
+                break;
+            }
+            case 2:
+            {
+                break;
+            }
+            default:
+            {
+                break;
+            }
+            }
+        }
+    } while (handleData->k >= 0);
+    /*Codes_SRS_HTTPAPIEX_02_029: [Otherwise, HTTAPIEX_ExecuteRequest shall return HTTPAPIEX_RECOVERYFAILED.] */
+    result = HTTPAPIEX_RECOVERYFAILED;
+    LogError("unable to recover sending to a working state");
+out:;
+    return result;
+}
+
+static bool isThrottled(unsigned int statusCode)
+{
+    return ((statusCode == 429) || (statusCode == 503)) ? true : false;
+}
+
+static bool defaultShouldRetry(void* context, HTTPAPIEX_RESULT result, unsigned int statusCode)
+{
+    bool retry;
+    (void)context;
+    /*Codes_SRS_HTTPAPIEX_07_010: [ If the policy does not provide shouldRetry then an attempt shall be retried when it returned HTTPAPIEX_RECOVERYFAILED or when it completed with status code 408, 429, 500, 502, 503 or 504. ]*/
+    if (result == HTTPAPIEX_RECOVERYFAILED)
+    {
+        retry = true;
+    }
+    else if (result == HTTPAPIEX_OK)
+    {
+        retry = ((statusCode == 408) || (statusCode == 429) || (statusCode == 500) || (statusCode == 502) || (statusCode == 503) || (statusCode == 504)) ? true : false;
+    }
+    else
+    {
+        retry = false;
+    }
+    return retry;
+}
+
+/*full jitter: a delay uniformly distributed between 0 and min(maxBackoffInMs, initialBackoffInMs * 2^retry)*/
+static unsigned int computeBackoffInMs(const HTTPAPIEX_RETRY_POLICY* policy, size_t retry)
+{
+    unsigned int result;
+    unsigned int ceiling = policy->initialBackoffInMs;
+    size_t i;
+
+    for (i = 0; (i < retry) && (ceiling < policy->maxBackoffInMs); i++)
+    {
+        ceiling = (ceiling > policy->maxBackoffInMs / 2) ? policy->maxBackoffInMs : ceiling * 2;
+    }
+    if (ceiling > policy->maxBackoffInMs)
+    {
+        ceiling = policy->maxBackoffInMs;
+    }
+
+    if (ceiling == 0)
+    {
+        result = 0;
+    }
+    else
+    {
+        /*gb_rand might only provide 15 random bits*/
+        unsigned int random = ((unsigned int)gb_rand() << 15) ^ (unsigned int)gb_rand();
+        result = random % ceiling;
+    }
+    return result;
+}
+
+/*returns true when the response carries a Retry-After header expressed in seconds*/
+static bool getRetryAfterInMs(HTTP_HEADERS_HANDLE responseHttpHeadersHandle, unsigned int* retryAfterInMs)
+{
+    bool result;
+    const char* value = HTTPHeaders_FindHeaderValue(responseHttpHeadersHandle, "Retry-After");
+    if (value == NULL)
+    {
+        result = false;
+    }
+    else
+    {
+        unsigned int seconds = 0;
+        while (*value == ' ')
+        {
+            value++;
+        }
+
+        if ((*value < '0') || (*value > '9'))
+        {
+            /*HTTP-date form is not supported, the computed backoff is used instead*/
+            result = false;
+        }
+        else
+        {
+            while ((*value >= '0') && (*value <= '9'))
+            {
+                if (seconds < (UINT_MAX / 1000 - 9) / 10)
+                {
+                    seconds = seconds * 10 + (unsigned int)(*value - '0');
+                }
+                else
+                {
+                    seconds = UINT_MAX / 1000;
+                }
+                value++;
+            }
+            *retryAfterInMs = seconds * 1000;
+            result = true;
+        }
+    }
+    return result;
+}
+
+/*copies the headers of source into destination, returns 0 on success*/
+static int copyResponseHeaders(HTTP_HEADERS_HANDLE source, HTTP_HEADERS_HANDLE destination)
+{
+    int result;
+    size_t headersCount;
+    if (HTTPHeaders_GetHeaderCount(source, &headersCount) != HTTP_HEADERS_OK)
+    {
+        LogError("unable to HTTPHeaders_GetHeaderCount");
+        result = __FAILURE__;
+    }
+    else
+    {
+        size_t i;
+        result = 0;
+        for (i = 0; i < headersCount; i++)
+        {
+            const char* name;
+            const char* value;
+            if (HTTPHeaders_GetHeaderNameValue(source, i, &name, &value) != HTTP_HEADERS_OK)
+            {
+                LogError("unable to HTTPHeaders_GetHeaderNameValue");
+                result = __FAILURE__;
+                break;
+            }
+            else if (HTTPHeaders_AddHeaderNameValuePair(destination, name, value) != HTTP_HEADERS_OK)
+            {
+                LogError("unable to HTTPHeaders_AddHeaderNameValuePair");
+                result = __FAILURE__;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+static HTTPAPIEX_RESULT executeWithRetries(HTTPAPIEX_HANDLE_DATA* handleData, HTTPAPI_REQUEST_TYPE requestType, const char* toBeUsedRelativePath,
+    HTTP_HEADERS_HANDLE toBeUsedRequestHttpHeadersHandle, BUFFER_HANDLE toBeUsedRequestContent, unsigned int* toBeUsedStatusCode,
+    HTTP_HEADERS_HANDLE toBeUsedResponseHttpHeadersHandle, bool isOriginalResponseHttpHeadersHandle, BUFFER_HANDLE toBeUsedResponseContent)
+{
+    HTTPAPIEX_RESULT result;
+    const HTTPAPIEX_RETRY_POLICY* policy = handleData->retryPolicy;
+    tickcounter_ms_t startTime;
+
+    if (tickcounter_get_current_ms(handleData->tickCounter, &startTime) != 0)
+    {
+        result = HTTPAPIEX_ERROR;
+        LOG_HTTAPIEX_ERROR();
+    }
+    else
+    {
+        tickcounter_ms_t currentTime = startTime;
+        size_t retry = 0;
+        bool done = false;
+
+        do
+        {
+            /*Codes_SRS_HTTPAPIEX_07_007: [ When a retry policy is set, every attempt shall receive the response headers in a fresh temporary HTTPHEADERS instance so that the headers of discarded attempts are not accumulated. ]*/
+            HTTP_HEADERS_HANDLE attemptResponseHttpHeadersHandle = HTTPHeaders_Alloc();
+            if (attemptResponseHttpHeadersHandle == NULL)
+            {
+                result = HTTPAPIEX_ERROR;
+                LOG_HTTAPIEX_ERROR();
+                done = true;
+            }
+            else
+            {
+                bool shouldRetry;
+                if ((retry > 0) && (BUFFER_length(toBeUsedResponseContent) > 0) && (BUFFER_unbuild(toBeUsedResponseContent) != 0))
+                {
+                    LogError("unable to BUFFER_unbuild the response of the previous attempt");
+                }
+
+                /*Codes_SRS_HTTPAPIEX_07_017: [ When a retry policy is set, HTTPAPIEX_ExecuteRequest shall set the status code to 0 before each attempt, so that shouldRetry sees 0 for an attempt that did not complete. ]*/
+                *toBeUsedStatusCode = 0;
+                result = executeAttempt(handleData, requestType, toBeUsedRelativePath, toBeUsedRequestHttpHeadersHandle, toBeUsedRequestContent, toBeUsedStatusCode, attemptResponseHttpHeadersHandle, toBeUsedResponseContent);
+                handleData->statistics.attemptCount++;
+                if ((result == HTTPAPIEX_OK) && isThrottled(*toBeUsedStatusCode))
+                {
+                    handleData->statistics.throttledCount++;
+                }
+
+                shouldRetry = (policy->shouldRetry != NULL) ?
+                    policy->shouldRetry(policy->shouldRetryContext, result, *toBeUsedStatusCode) :
+                    defaultShouldRetry(NULL, result, *toBeUsedStatusCode);
+
+                /*Codes_SRS_HTTPAPIEX_07_008: [ An attempt shall not be retried when shouldRetry returns false or when maxRetries retries have already been made. ]*/
+                if (!shouldRetry || (retry >= policy->maxRetries))
+                {
+                    done = true;
+                }
+                else
+                {
+                    /*Codes_SRS_HTTPAPIEX_07_009: [ Before retrying, HTTPAPIEX_ExecuteRequest shall sleep a random time between 0 and min(maxBackoffInMs, initialBackoffInMs * 2^retry) milliseconds. ]*/
+                    unsigned int delayInMs = computeBackoffInMs(policy, retry);
+                    unsigned int retryAfterInMs;
+
+                    /*Codes_SRS_HTTPAPIEX_07_011: [ If honorRetryAfter is true and a 429 or 503 response carries a Retry-After header in seconds, that delay shall be used instead. ]*/
+                    if (policy->honorRetryAfter &&
+                        (result == HTTPAPIEX_OK) &&
+                        isThrottled(*toBeUsedStatusCode) &&
+                        getRetryAfterInMs(attemptResponseHttpHeadersHandle, &retryAfterInMs))
+                    {
+                        /*Codes_SRS_HTTPAPIEX_07_018: [ The Retry-After delay shall be capped at maxBackoffInMs. ]*/
+                        delayInMs = (retryAfterInMs > policy->maxBackoffInMs) ? policy->maxBackoffInMs : retryAfterInMs;
+                    }
+
+                    if (tickcounter_get_current_ms(handleData->tickCounter, &currentTime) != 0)
+                    {
+                        LogError("unable to get the current time, not retrying");
+                        done = true;
+                    }
+                    /*Codes_SRS_HTTPAPIEX_07_012: [ If deadlineInMs is not 0 and the backoff would end past deadlineInMs milliseconds after the start of HTTPAPIEX_ExecuteRequest, the attempt shall not be retried. ]*/
+                    else if ((policy->deadlineInMs != 0) && ((currentTime - startTime) + delayInMs >= policy->deadlineInMs))
+                    {
+                        LogInfo("retry deadline of %u ms reached after %lu retries", policy->deadlineInMs, (unsigned long)retry);
+                        done = true;
+                    }
+                    else
+                    {
+                        ThreadAPI_Sleep(delayInMs);
+                        retry++;
+                        handleData->statistics.retryCount++;
+                    }
+                }
+
+                /*Codes_SRS_HTTPAPIEX_07_013: [ The response headers of the last attempt shall be copied into the responseHttpHeadersHandle passed by the caller, if any. ]*/
+                if (done && (result == HTTPAPIEX_OK) && isOriginalResponseHttpHeadersHandle)
+                {
+                    if (copyResponseHeaders(attemptResponseHttpHeadersHandle, toBeUsedResponseHttpHeadersHandle) != 0)
+                    {
+                        result = HTTPAPIEX_ERROR;
+                        LOG_HTTAPIEX_ERROR();
+                    }
+                }
+                HTTPHeaders_Free(attemptResponseHttpHeadersHandle);
+            }
+        } while (!done);
+
+        /*Codes_SRS_HTTPAPIEX_07_014: [ When a retry policy is set, the time spent in HTTPAPIEX_ExecuteRequest shall be added to totalLatencyInMs and shall update maxLatencyInMs. ]*/
+        if (tickcounter_get_current_ms(handleData->tickCounter, &currentTime) == 0)
+        {
+            uint64_t latency = (uint64_t)(currentTime - startTime);
+            handleData->statistics.totalLatencyInMs += latency;
+            if (latency > handleData->statistics.maxLatencyInMs)
+            {
+                handleData->statistics.maxLatencyInMs = latency;
+            }
+        }
+    }
+    return result;
+}
+
 HTTPAPIEX_RESULT HTTPAPIEX_ExecuteRequest(HTTPAPIEX_HANDLE handle, HTTPAPI_REQUEST_TYPE requestType, const char* relativePath,
     HTTP_HEADERS_HANDLE requestHttpHeadersHandle, BUFFER_HANDLE requestContent, unsigned int* statusCode,
     HTTP_HEADERS_HANDLE responseHttpHeadersHandle, BUFFER_HANDLE responseContent)
@@ -339,141 +743,28 @@ HTTPAPIEX_RESULT HTTPAPIEX_ExecuteRequest(HTTPAPIEX_HANDLE handle, HTTPAPI_REQUE
             else
             {
 
-                /*Codes_SRS_HTTPAPIEX_02_023: [HTTPAPIEX_ExecuteRequest shall try to execute the HTTP call by ensuring the following API call sequence is respected:]*/
-                /*Codes_SRS_HTTPAPIEX_02_024: [If any point in the sequence fails, HTTPAPIEX_ExecuteRequest shall attempt to recover by going back to the previous step and retrying that step.]*/
-                /*Codes_SRS_HTTPAPIEX_02_025: [If the first step fails, then the sequence fails.]*/
-                /*Codes_SRS_HTTPAPIEX_02_026: [A step shall be retried at most once.]*/
-                /*Codes_SRS_HTTPAPIEX_02_027: [If a step has been retried then all subsequent steps shall be retried too.]*/
-                bool st[3] = { false, false, false }; /*the three levels of possible failure in resilient send: HTTAPI_Init, HTTPAPI_CreateConnection, HTTPAPI_ExecuteRequest*/
-                if (handleData->k == -1)
+                /*Codes_SRS_HTTPAPIEX_07_005: [ If no retry policy is set then HTTPAPIEX_ExecuteRequest shall run the sequence in SRS_HTTPAPIEX_02_023 exactly once. ]*/
+                if (handleData->retryPolicy == NULL)
                 {
-                    handleData->k = 0;
-                }
-
-                do
-                {
-                    bool goOn;
-
-                    if (handleData->k > 2)
+                    result = executeAttempt(handleData, requestType, toBeUsedRelativePath, toBeUsedRequestHttpHeadersHandle, toBeUsedRequestContent, toBeUsedStatusCode, toBeUsedResponseHttpHeadersHandle, toBeUsedResponseContent);
+                    handleData->statistics.attemptCount++;
+                    if ((result == HTTPAPIEX_OK) && isThrottled(*toBeUsedStatusCode))
                     {
-                        /* error */
-                        break;
+                        handleData->statistics.throttledCount++;
                     }
+                }
+                else
+                {
+                    result = executeWithRetries(handleData, requestType, toBeUsedRelativePath, toBeUsedRequestHttpHeadersHandle, toBeUsedRequestContent, toBeUsedStatusCode, toBeUsedResponseHttpHeadersHandle, isOriginalResponseHttpHeadersHandle, toBeUsedResponseContent);
+                }
 
-                    if (st[handleData->k] == true) /*already been tried*/
-                    {
-                        goOn = false;
-                    }
-                    else
-                    {
-                        switch (handleData->k)
-                        {
-                        case 0:
-                        {
-                            if (HTTPAPI_Init() != HTTPAPI_OK)
-                            {
-                                goOn = false;
-                            }
-                            else
-                            {
-                                goOn = true;
-                            }
-                            break;
-                        }
-                        case 1:
-                        {
-                            if ((handleData->httpHandle = HTTPAPI_CreateConnection(STRING_c_str(handleData->hostName))) == NULL)
-                            {
-                                goOn = false;
-                            }
-                            else
-                            {
-                                size_t i;
-                                size_t vectorSize = VECTOR_size(handleData->savedOptions);
-                                for (i = 0; i < vectorSize; i++)
-                                {
-                                    /*Codes_SRS_HTTPAPIEX_02_035: [HTTPAPIEX_ExecuteRequest shall pass all the saved options (see HTTPAPIEX_SetOption) to the newly create HTTPAPI_HANDLE in step 2 by calling HTTPAPI_SetOption.]*/
-                                    /*Codes_SRS_HTTPAPIEX_02_036: [If setting the option fails, then the failure shall be ignored.] */
-                                    HTTPAPIEX_SAVED_OPTION* option = (HTTPAPIEX_SAVED_OPTION*)VECTOR_element(handleData->savedOptions, i);
-                                    if (HTTPAPI_SetOption(handleData->httpHandle, option->optionName, option->value) != HTTPAPI_OK)
-                                    {
-                                        LogError("HTTPAPI_SetOption failed when called for option %s", option->optionName);
-                                    }
-                                }
-                                goOn = true;
-                            }
-                            break;
-                        }
-                        case 2:
-                        {
-                            size_t length = BUFFER_length(toBeUsedRequestContent);
-                            unsigned char* buffer = BUFFER_u_char(toBeUsedRequestContent);
-                            if (HTTPAPI_ExecuteRequest(handleData->httpHandle, requestType, toBeUsedRelativePath, toBeUsedRequestHttpHeadersHandle, buffer, length, toBeUsedStatusCode, toBeUsedResponseHttpHeadersHandle, toBeUsedResponseContent) != HTTPAPI_OK)
-                            {
-                                goOn = false;
-                            }
-                            else
-                            {
-                                goOn = true;
-                            }
-                            break;
-                        }
-                        default:
-                        {
-                            /*serious error*/
-                            goOn = false;
-                            break;
-                        }
-                        }
-                    }
+                /*Codes_SRS_HTTPAPIEX_07_006: [ Every call to HTTPAPIEX_ExecuteRequest that gets past argument validation shall be counted in requestCount, and in failedCount when it does not return HTTPAPIEX_OK. ]*/
+                handleData->statistics.requestCount++;
+                if (result != HTTPAPIEX_OK)
+                {
+                    handleData->statistics.failedCount++;
+                }
 
-                    if (goOn)
-                    {
-                        if (handleData->k == 2)
-                        {
-                            /*Codes_SRS_HTTPAPIEX_02_028: [HTTPAPIEX_ExecuteRequest shall return HTTPAPIEX_OK when a call to HTTPAPI_ExecuteRequest has been completed successfully.]*/
-                            result = HTTPAPIEX_OK;
-                            goto out;
-                        }
-                        else
-                        {
-                            st[handleData->k] = true;
-                            handleData->k++;
-                            st[handleData->k] = false;
-                        }
-                    }
-                    else
-                    {
-                        st[handleData->k] = false;
-                        handleData->k--;
-                        switch (handleData->k)
-                        {
-                        case 0:
-                        {
-                            HTTPAPI_Deinit();
-                            break;
-                        }
-                        case 1:
-                        {
-                            HTTPAPI_CloseConnection(handleData->httpHandle);
-                            handleData->httpHandle = NULL;
-                            break;
-                        }
-                        case 2:
-                        {
-                            break;
-                        }
-                        default:
-                        {
-                            break;
-                        }
-                        }
-                    }
-                } while (handleData->k >= 0);
-                /*Codes_SRS_HTTPAPIEX_02_029: [Otherwise, HTTAPIEX_ExecuteRequest shall return HTTPAPIEX_RECOVERYFAILED.] */
-                result = HTTPAPIEX_RECOVERYFAILED;
-                LogError("unable to recover sending to a working state");
-            out:;
                 /*in all cases, unbuild the temporaries*/
                 if (isOriginalRequestContent == false)
                 {
@@ -523,6 +814,15 @@ void HTTPAPIEX_Destroy(HTTPAPIEX_HANDLE handle)
         }
         VECTOR_destroy(handleData->savedOptions);
 
+        if (handleData->retryPolicy != NULL)
+        {
+            free(handleData->retryPolicy);
+        }
+        if (handleData->tickCounter != NULL)
+        {
+            tickcounter_destroy(handleData->tickCounter);
+        }
+
         free(handle);
     }
     else
@@ -579,6 +879,36 @@ static int createOrUpdateOption(HTTPAPIEX_HANDLE_DATA* handleData, const char* o
     return result;
 }
 
+/*installs or replaces the retry policy of handleData, the policy is copied*/
+static HTTPAPIEX_RESULT setRetryPolicy(HTTPAPIEX_HANDLE_DATA* handleData, const HTTPAPIEX_RETRY_POLICY* retryPolicy)
+{
+    HTTPAPIEX_RESULT result;
+    /*Codes_SRS_HTTPAPIEX_07_002: [ If the tick counter used to measure backoff, deadline and latency cannot be created then HTTPAPIEX_SetOption shall return HTTPAPIEX_ERROR. ]*/
+    if ((handleData->tickCounter == NULL) &&
+        ((handleData->tickCounter = tickcounter_create()) == NULL))
+    {
+        result = HTTPAPIEX_ERROR;
+        LOG_HTTAPIEX_ERROR();
+    }
+    else
+    {
+        /*Codes_SRS_HTTPAPIEX_07_003: [ If allocating the copy of the retry policy fails then HTTPAPIEX_SetOption shall return HTTPAPIEX_ERROR. ]*/
+        if ((handleData->retryPolicy == NULL) &&
+            ((handleData->retryPolicy = (HTTPAPIEX_RETRY_POLICY*)malloc(sizeof(HTTPAPIEX_RETRY_POLICY))) == NULL))
+        {
+            result = HTTPAPIEX_ERROR;
+            LOG_HTTAPIEX_ERROR();
+        }
+        else
+        {
+            /*Codes_SRS_HTTPAPIEX_07_004: [ Otherwise HTTPAPIEX_SetOption shall copy the retry policy, use it for all subsequent calls to HTTPAPIEX_ExecuteRequest and return HTTPAPIEX_OK. ]*/
+            *handleData->retryPolicy = *retryPolicy;
+            result = HTTPAPIEX_OK;
+        }
+    }
+    return result;
+}
+
 HTTPAPIEX_RESULT HTTPAPIEX_SetOption(HTTPAPIEX_HANDLE handle, const char* optionName, const void* value)
 {
     HTTPAPIEX_RESULT result;
@@ -594,6 +924,11 @@ HTTPAPIEX_RESULT HTTPAPIEX_SetOption(HTTPAPIEX_HANDLE handle, const char* option
         result = HTTPAPIEX_INVALID_ARG;
         LOG_HTTAPIEX_ERROR();
     }
+    else if (strcmp(optionName, OPTION_HTTPAPIEX_RETRY_POLICY) == 0)
+    {
+        /*Codes_SRS_HTTPAPIEX_07_001: [ If optionName is OPTION_HTTPAPIEX_RETRY_POLICY then HTTPAPIEX_SetOption shall not pass the option to HTTPAPI and shall treat value as a const HTTPAPIEX_RETRY_POLICY*. ]*/
+        result = setRetryPolicy((HTTPAPIEX_HANDLE_DATA*)handle, (const HTTPAPIEX_RETRY_POLICY*)value);
+    }
     else
     {
         const void* savedOption;
@@ -655,3 +990,24 @@ HTTPAPIEX_RESULT HTTPAPIEX_SetOption(HTTPAPIEX_HANDLE handle, const char* option
     }
     return result;
 }
+
+HTTPAPIEX_RESULT HTTPAPIEX_GetStatistics(HTTPAPIEX_HANDLE handle, HTTPAPIEX_STATISTICS* statistics)
+{
+    HTTPAPIEX_RESULT result;
+    /*Codes_SRS_HTTPAPIEX_07_015: [ If handle or statistics is NULL then HTTPAPIEX_GetStatistics shall return HTTPAPIEX_INVALID_ARG. ]*/
+    if (
+        (handle == NULL) ||
+        (statistics == NULL)
+        )
+    {
+        result = HTTPAPIEX_INVALID_ARG;
+        LOG_HTTAPIEX_ERROR();
+    }
+    else
+    {
+        /*Codes_SRS_HTTPAPIEX_07_016: [ Otherwise HTTPAPIEX_GetStatistics shall copy the counters of handle into statistics and return HTTPAPIEX_OK. ]*/
+        *statistics = ((HTTPAPIEX_HANDLE_DATA*)handle)->statistics;
+        result = HTTPAPIEX_OK;
+    }
+    return result;
+}
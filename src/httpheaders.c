@@ -2,8 +2,8 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <stdint.h>
 #include "azure_c_shared_utility/gballoc.h"
-#include "azure_c_shared_utility/map.h"
 #include "azure_c_shared_utility/httpheaders.h"
 #include <string.h>
 #include "azure_c_shared_utility/crt_abstractions.h"
@@ -11,36 +11,223 @@
 
 DEFINE_ENUM_STRINGS(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 
+/*number of headers that fit in the allocation made by HTTPHeaders_Alloc, must be a power of 2*/
+#define HTTP_HEADERS_INITIAL_CAPACITY 8
+/*size of the string arena that comes with the allocation made by HTTPHeaders_Alloc*/
+#define HTTP_HEADERS_INITIAL_ARENA_SIZE 256
+
+/*names and values are bump-allocated from a chain of blocks that are only released by HTTPHeaders_Free*/
+typedef struct HTTP_HEADERS_ARENA_BLOCK_TAG
+{
+    struct HTTP_HEADERS_ARENA_BLOCK_TAG* next;
+    size_t size;
+    size_t used;
+} HTTP_HEADERS_ARENA_BLOCK;
+
+typedef struct HTTP_HEADER_ENTRY_TAG
+{
+    char* name;
+    char* value;
+    size_t nameLength;
+    size_t valueLength;
+    size_t valueCapacity; /*number of characters that can be stored at value, not counting the '\0'*/
+    uint32_t hash;
+} HTTP_HEADER_ENTRY;
+
 typedef struct HTTP_HEADERS_HANDLE_DATA_TAG
 {
-    MAP_HANDLE headers;
+    HTTP_HEADER_ENTRY* entries; /*in insertion order, this is what the indexes of HTTPHeaders_GetHeader refer to*/
+    size_t count;
+    size_t capacity;
+    size_t* buckets; /*open addressing table of 2*capacity slots, each holding an index in entries + 1, 0 means empty*/
+    HTTP_HEADERS_ARENA_BLOCK* arena; /*most recent block first*/
+    size_t inlineCapacity;
+    /*followed in the same allocation by inlineCapacity entries, 2*inlineCapacity buckets and the first arena block*/
 } HTTP_HEADERS_HANDLE_DATA;
 
-HTTP_HEADERS_HANDLE HTTPHeaders_Alloc(void)
+static HTTP_HEADER_ENTRY* inlineEntries(HTTP_HEADERS_HANDLE_DATA* handleData)
 {
-    /*Codes_SRS_HTTP_HEADERS_99_002:[ This API shall produce a HTTP_HANDLE that can later be used in subsequent calls to the module.]*/
-    HTTP_HEADERS_HANDLE_DATA* result;
-    result = (HTTP_HEADERS_HANDLE_DATA*)malloc(sizeof(HTTP_HEADERS_HANDLE_DATA));
+    return (HTTP_HEADER_ENTRY*)(handleData + 1);
+}
 
-    if (result == NULL)
+static size_t* inlineBuckets(HTTP_HEADERS_HANDLE_DATA* handleData)
+{
+    return (size_t*)(inlineEntries(handleData) + handleData->inlineCapacity);
+}
+
+static HTTP_HEADERS_ARENA_BLOCK* inlineArena(HTTP_HEADERS_HANDLE_DATA* handleData)
+{
+    return (HTTP_HEADERS_ARENA_BLOCK*)(inlineBuckets(handleData) + 2 * handleData->inlineCapacity);
+}
+
+static char toLowerAscii(char c)
+{
+    return ((c >= 'A') && (c <= 'Z')) ? (char)(c - 'A' + 'a') : c;
+}
+
+/*FNV-1a over the lower case name, header names are case-insensitive (RFC 7230, section 3.2)*/
+static uint32_t hashName(const char* name, size_t nameLength)
+{
+    uint32_t result = 2166136261u;
+    size_t i;
+    for (i = 0; i < nameLength; i++)
     {
-        LogError("malloc failed");
+        result ^= (uint32_t)(unsigned char)toLowerAscii(name[i]);
+        result *= 16777619u;
+    }
+    return result;
+}
+
+static bool sameName(const HTTP_HEADER_ENTRY* entry, const char* name, size_t nameLength, uint32_t hash)
+{
+    bool result;
+    if ((entry->hash != hash) || (entry->nameLength != nameLength))
+    {
+        result = false;
     }
     else
     {
-        /*Codes_SRS_HTTP_HEADERS_99_004:[ After a successful init, HTTPHeaders_GetHeaderCount shall report 0 existing headers.]*/
-        result->headers = Map_Create(NULL);
-        if (result->headers == NULL)
+        size_t i;
+        for (i = 0; i < nameLength; i++)
         {
-            LogError("Map_Create failed");
-            free(result);
+            if (toLowerAscii(entry->name[i]) != toLowerAscii(name[i]))
+            {
+                break;
+            }
+        }
+        result = (i == nameLength);
+    }
+    return result;
+}
+
+/*returns the slot in buckets where name is, or the empty slot where it would be inserted*/
+static size_t findSlot(const HTTP_HEADERS_HANDLE_DATA* handleData, const char* name, size_t nameLength, uint32_t hash)
+{
+    size_t mask = 2 * handleData->capacity - 1;
+    size_t slot = hash & mask;
+    while ((handleData->buckets[slot] != 0) &&
+        !sameName(&handleData->entries[handleData->buckets[slot] - 1], name, nameLength, hash))
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static void rebuildBuckets(HTTP_HEADERS_HANDLE_DATA* handleData)
+{
+    size_t i;
+    (void)memset(handleData->buckets, 0, 2 * handleData->capacity * sizeof(size_t));
+    for (i = 0; i < handleData->count; i++)
+    {
+        HTTP_HEADER_ENTRY* entry = &handleData->entries[i];
+        handleData->buckets[findSlot(handleData, entry->name, entry->nameLength, entry->hash)] = i + 1;
+    }
+}
+
+static char* arenaAllocate(HTTP_HEADERS_HANDLE_DATA* handleData, size_t size)
+{
+    char* result;
+    HTTP_HEADERS_ARENA_BLOCK* block = handleData->arena;
+    if (block->size - block->used >= size)
+    {
+        result = (char*)(block + 1) + block->used;
+        block->used += size;
+    }
+    else
+    {
+        /*blocks double in size so that a long lived handle only does a logarithmic number of allocations*/
+        size_t blockSize = 2 * block->size;
+        if (blockSize < size)
+        {
+            blockSize = size;
+        }
+
+        if ((blockSize > SIZE_MAX - sizeof(HTTP_HEADERS_ARENA_BLOCK)) ||
+            ((block = (HTTP_HEADERS_ARENA_BLOCK*)malloc(sizeof(HTTP_HEADERS_ARENA_BLOCK) + blockSize)) == NULL))
+        {
+            LogError("unable to allocate %lu bytes for header strings", (unsigned long)blockSize);
             result = NULL;
         }
         else
         {
-            /*all is fine*/
+            block->next = handleData->arena;
+            block->size = blockSize;
+            block->used = size;
+            handleData->arena = block;
+            result = (char*)(block + 1);
         }
     }
+    return result;
+}
+
+/*creates a handle whose first capacity entries and first arenaSize bytes of strings come in a single allocation*/
+static HTTP_HEADERS_HANDLE_DATA* createHandle(size_t capacity, size_t arenaSize)
+{
+    HTTP_HEADERS_HANDLE_DATA* result;
+    size_t inlineCapacity = HTTP_HEADERS_INITIAL_CAPACITY;
+    while (inlineCapacity < capacity)
+    {
+        inlineCapacity *= 2;
+    }
+
+    result = (HTTP_HEADERS_HANDLE_DATA*)malloc(sizeof(HTTP_HEADERS_HANDLE_DATA) +
+        inlineCapacity * sizeof(HTTP_HEADER_ENTRY) +
+        2 * inlineCapacity * sizeof(size_t) +
+        sizeof(HTTP_HEADERS_ARENA_BLOCK) + arenaSize);
+    if (result == NULL)
+    {
+        LogError("malloc failed");
+    }
+    else
+    {
+        result->inlineCapacity = inlineCapacity;
+        result->capacity = inlineCapacity;
+        result->count = 0;
+        result->entries = inlineEntries(result);
+        result->buckets = inlineBuckets(result);
+        (void)memset(result->buckets, 0, 2 * inlineCapacity * sizeof(size_t));
+        result->arena = inlineArena(result);
+        result->arena->next = NULL;
+        result->arena->size = arenaSize;
+        result->arena->used = 0;
+    }
+    return result;
+}
+
+/*doubles the number of entries (and buckets) the handle can hold*/
+static int growEntries(HTTP_HEADERS_HANDLE_DATA* handleData)
+{
+    int result;
+    size_t newCapacity = 2 * handleData->capacity;
+    HTTP_HEADER_ENTRY* newEntries;
+    if ((newCapacity > SIZE_MAX / (sizeof(HTTP_HEADER_ENTRY) + 2 * sizeof(size_t))) ||
+        ((newEntries = (HTTP_HEADER_ENTRY*)malloc(newCapacity * (sizeof(HTTP_HEADER_ENTRY) + 2 * sizeof(size_t)))) == NULL))
+    {
+        LogError("unable to grow the headers to %lu entries", (unsigned long)newCapacity);
+        result = __FAILURE__;
+    }
+    else
+    {
+        (void)memcpy(newEntries, handleData->entries, handleData->count * sizeof(HTTP_HEADER_ENTRY));
+        if (handleData->entries != inlineEntries(handleData))
+        {
+            free(handleData->entries);
+        }
+        handleData->entries = newEntries;
+        handleData->buckets = (size_t*)(newEntries + newCapacity);
+        handleData->capacity = newCapacity;
+        rebuildBuckets(handleData);
+        result = 0;
+    }
+    return result;
+}
+
+HTTP_HEADERS_HANDLE HTTPHeaders_Alloc(void)
+{
+    /*Codes_SRS_HTTP_HEADERS_99_002:[ This API shall produce a HTTP_HANDLE that can later be used in subsequent calls to the module.]*/
+    /*Codes_SRS_HTTP_HEADERS_99_004:[ After a successful init, HTTPHeaders_GetHeaderCount shall report 0 existing headers.]*/
+    /*Codes_SRS_HTTP_HEADERS_99_038: [ HTTPHeaders_Alloc shall allocate the handle, room for the first headers and the first bytes of header storage in a single allocation. ]*/
+    HTTP_HEADERS_HANDLE_DATA* result = createHandle(HTTP_HEADERS_INITIAL_CAPACITY, HTTP_HEADERS_INITIAL_ARENA_SIZE);
 
     /*Codes_SRS_HTTP_HEADERS_99_003:[ The function shall return NULL when the function cannot execute properly]*/
     return (HTTP_HEADERS_HANDLE)result;
@@ -58,8 +245,18 @@ void HTTPHeaders_Free(HTTP_HEADERS_HANDLE handle)
     {
         /*Codes_SRS_HTTP_HEADERS_99_005:[ Calling this API shall de-allocate the data structures allocated by previous API calls to the same handle.]*/
         HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)handle;
+        HTTP_HEADERS_ARENA_BLOCK* block = handleData->arena;
 
-        Map_Destroy(handleData->headers);
+        while (block != inlineArena(handleData))
+        {
+            HTTP_HEADERS_ARENA_BLOCK* next = block->next;
+            free(block);
+            block = next;
+        }
+        if (handleData->entries != inlineEntries(handleData))
+        {
+            free(handleData->entries);
+        }
         free(handleData);
     }
 }
@@ -100,61 +297,94 @@ static HTTP_HEADERS_RESULT headers_ReplaceHeaderNameValuePair(HTTP_HEADERS_HANDL
         else
         {
             HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)handle;
-            const char* existingValue = Map_GetValueFromKey(handleData->headers, name);
+            uint32_t hash = hashName(name, nameLen);
+            size_t slot = findSlot(handleData, name, nameLen, hash);
+            size_t valueLen;
+
             /*eat up the whitespaces from value, as per RFC 2616, chapter 4.2 "The field value MAY be preceded by any amount of LWS, though a single SP is preferred."*/
             /*Codes_SRS_HTTP_HEADERS_02_002: [The LWS from the beginning of the value shall not be stored.] */
             while ((value[0] == ' ') || (value[0] == '\t') || (value[0] == '\r') || (value[0] == '\n'))
             {
                 value++;
             }
+            valueLen = strlen(value);
 
-            if (!replace && (existingValue != NULL))
+            if (handleData->buckets[slot] != 0)
             {
-                size_t existingValueLen = strlen(existingValue);
-                size_t valueLen = strlen(value);
-                char* newValue = (char*)malloc(sizeof(char) * (existingValueLen + /*COMMA_AND_SPACE_LENGTH*/ 2 + valueLen + /*EOL*/ 1));
-                if (newValue == NULL)
+                HTTP_HEADER_ENTRY* entry = &handleData->entries[handleData->buckets[slot] - 1];
+                /*Codes_SRS_HTTP_HEADERS_99_017:[ If the name already exists in the collection of headers, the function shall concatenate the new value after the existing value, separated by a comma and a space as in: old-value+", "+new-value.]*/
+                size_t offset = replace ? 0 : entry->valueLength + /*COMMA_AND_SPACE_LENGTH*/ 2;
+                size_t newValueLen = offset + valueLen;
+
+                /*Codes_SRS_HTTP_HEADERS_99_039: [ If the new value fits in the storage of the existing value, it shall be stored in place without allocating. ]*/
+                if (newValueLen <= entry->valueCapacity)
                 {
-                    /*Codes_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
-                    result = HTTP_HEADERS_ALLOC_FAILED;
-                    LogError("failed to malloc , result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+                    /*value may point into the existing value (for example, it was obtained from HTTPHeaders_FindHeaderValue)*/
+                    (void)memmove(entry->value + offset, value, valueLen + /*EOL*/ 1);
+                    if (!replace)
+                    {
+                        entry->value[offset - 2] = ',';
+                        entry->value[offset - 1] = ' ';
+                    }
+                    entry->valueLength = newValueLen;
+                    result = HTTP_HEADERS_OK;
                 }
                 else
                 {
-                    char* runNewValue;
-                    /*Codes_SRS_HTTP_HEADERS_99_017:[ If the name already exists in the collection of headers, the function shall concatenate the new value after the existing value, separated by a comma and a space as in: old-value+", "+new-value.]*/
-                    (void)memcpy(newValue, existingValue, existingValueLen);
-                    runNewValue = newValue + existingValueLen;
-                    (*runNewValue++) = ',';
-                    (*runNewValue++) = ' ';
-                    (void)memcpy(runNewValue, value, valueLen + /*EOL*/ 1);
-
-                    /*Codes_SRS_HTTP_HEADERS_99_016:[ The function shall store the name:value pair in such a way that when later retrieved by a call to GetHeader it will return a string that shall strcmp equal to the name+": "+value.]*/
-                    if (Map_AddOrUpdate(handleData->headers, name, newValue) != MAP_OK)
+                    char* newValue = arenaAllocate(handleData, newValueLen + /*EOL*/ 1);
+                    if (newValue == NULL)
                     {
                         /*Codes_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
-                        result = HTTP_HEADERS_ERROR;
-                        LogError("failed to Map_AddOrUpdate, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+                        result = HTTP_HEADERS_ALLOC_FAILED;
+                        LogError("failed to allocate the value, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
                     }
                     else
                     {
+                        if (!replace)
+                        {
+                            (void)memcpy(newValue, entry->value, entry->valueLength);
+                            newValue[offset - 2] = ',';
+                            newValue[offset - 1] = ' ';
+                        }
+                        (void)memcpy(newValue + offset, value, valueLen + /*EOL*/ 1);
+                        entry->value = newValue;
+                        entry->valueLength = newValueLen;
+                        entry->valueCapacity = newValueLen;
                         /*Codes_SRS_HTTP_HEADERS_99_013:[ The function shall return HTTP_HEADERS_OK when execution is successful.]*/
                         result = HTTP_HEADERS_OK;
                     }
-                    free(newValue);
                 }
             }
+            else if ((handleData->count == handleData->capacity) && (growEntries(handleData) != 0))
+            {
+                /*Codes_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
+                result = HTTP_HEADERS_ALLOC_FAILED;
+                LogError("failed to grow the headers, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+            }
             else
             {
                 /*Codes_SRS_HTTP_HEADERS_99_016:[ The function shall store the name:value pair in such a way that when later retrieved by a call to GetHeader it will return a string that shall strcmp equal to the name+": "+value.]*/
-                if (Map_AddOrUpdate(handleData->headers, name, value) != MAP_OK)
+                char* storage = arenaAllocate(handleData, nameLen + /*EOL*/ 1 + valueLen + /*EOL*/ 1);
+                if (storage == NULL)
                 {
                     /*Codes_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
                     result = HTTP_HEADERS_ALLOC_FAILED;
-                    LogError("failed to Map_AddOrUpdate, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+                    LogError("failed to allocate the header, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
                 }
                 else
                 {
+                    HTTP_HEADER_ENTRY* entry = &handleData->entries[handleData->count];
+                    entry->name = storage;
+                    entry->nameLength = nameLen;
+                    entry->value = storage + nameLen + 1;
+                    entry->valueLength = valueLen;
+                    entry->valueCapacity = valueLen;
+                    entry->hash = hash;
+                    (void)memcpy(entry->name, name, nameLen + /*EOL*/ 1);
+                    (void)memcpy(entry->value, value, valueLen + /*EOL*/ 1);
+
+                    /*growing the entries rebuilds the buckets, so the slot is searched again*/
+                    handleData->buckets[findSlot(handleData, name, nameLen, hash)] = ++handleData->count;
                     result = HTTP_HEADERS_OK;
                 }
             }
@@ -192,8 +422,11 @@ const char* HTTPHeaders_FindHeaderValue(HTTP_HEADERS_HANDLE httpHeadersHandle, c
         /*Codes_SRS_HTTP_HEADERS_99_018:[ Calling this API shall retrieve the value for a previously stored name.]*/
         /*Codes_SRS_HTTP_HEADERS_99_020:[ The return value shall be different than NULL when the name matches the name of a previously stored name:value pair.] */
         /*Codes_SRS_HTTP_HEADERS_99_021:[ In this case the return value shall point to a string that shall strcmp equal to the original stored string.]*/
+        /*Codes_SRS_HTTP_HEADERS_99_040: [ Header names shall be compared without regard to case. ]*/
         HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)httpHeadersHandle;
-        result = Map_GetValueFromKey(handleData->headers, name);
+        size_t nameLength = strlen(name);
+        size_t slot = findSlot(handleData, name, nameLength, hashName(name, nameLength));
+        result = (handleData->buckets[slot] == 0) ? NULL : handleData->entries[handleData->buckets[slot] - 1].value;
     }
     return result;
 
@@ -212,21 +445,10 @@ HTTP_HEADERS_RESULT HTTPHeaders_GetHeaderCount(HTTP_HEADERS_HANDLE handle, size_
     }
     else
     {
-        HTTP_HEADERS_HANDLE_DATA *handleData = (HTTP_HEADERS_HANDLE_DATA *)handle;
-        const char*const* keys;
-        const char*const* values;
         /*Codes_SRS_HTTP_HEADERS_99_023:[ Calling this API shall provide the number of stored headers.]*/
-        if (Map_GetInternals(handleData->headers, &keys, &values, headerCount) != MAP_OK)
-        {
-            /*Codes_SRS_HTTP_HEADERS_99_037:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs.]*/
-            result = HTTP_HEADERS_ERROR;
-            LogError("Map_GetInternals failed, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
-        }
-        else
-        {
-            /*Codes_SRS_HTTP_HEADERS_99_026:[ The function shall write in *headersCount the number of currently stored headers and shall return HTTP_HEADERS_OK]*/
-            result = HTTP_HEADERS_OK;
-        }
+        /*Codes_SRS_HTTP_HEADERS_99_026:[ The function shall write in *headersCount the number of currently stored headers and shall return HTTP_HEADERS_OK]*/
+        *headerCount = ((HTTP_HEADERS_HANDLE_DATA*)handle)->count;
+        result = HTTP_HEADERS_OK;
     }
 
     return result;
@@ -248,54 +470,123 @@ HTTP_HEADERS_RESULT HTTPHeaders_GetHeader(HTTP_HEADERS_HANDLE handle, size_t ind
         LogError("invalid arg (NULL), result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
     }
     /*Codes_SRS_HTTP_HEADERS_99_029:[ The function shall return HTTP_HEADERS_INVALID_ARG if index is not valid (for example, out of range) for the currently stored headers.]*/
+    else if (index >= ((HTTP_HEADERS_HANDLE_DATA*)handle)->count)
+    {
+        result = HTTP_HEADERS_INVALID_ARG;
+        LogError("index out of bounds, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+    }
     else
     {
-        HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)handle;
-        const char*const* keys;
-        const char*const* values;
-        size_t headerCount;
-        if (Map_GetInternals(handleData->headers, &keys, &values, &headerCount) != MAP_OK)
+        const HTTP_HEADER_ENTRY* entry = &((HTTP_HEADERS_HANDLE_DATA*)handle)->entries[index];
+        *destination = (char*)malloc(sizeof(char) * (entry->nameLength + /*COLON_AND_SPACE_LENGTH*/ 2 + entry->valueLength + /*EOL*/ 1));
+        if (*destination == NULL)
         {
             /*Codes_SRS_HTTP_HEADERS_99_034:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs]*/
             result = HTTP_HEADERS_ERROR;
-            LogError("Map_GetInternals failed, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+            LogError("unable to malloc, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
         }
         else
         {
-            /*Codes_SRS_HTTP_HEADERS_99_029:[ The function shall return HTTP_HEADERS_INVALID_ARG if index is not valid (for example, out of range) for the currently stored headers.]*/
-            if (index >= headerCount)
-            {
-                result = HTTP_HEADERS_INVALID_ARG;
-                LogError("index out of bounds, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
-            }
-            else
+            /*Codes_SRS_HTTP_HEADERS_99_016:[ The function shall store the name:value pair in such a way that when later retrieved by a call to GetHeader it will return a string that shall strcmp equal to the name+": "+value.]*/
+            /*Codes_SRS_HTTP_HEADERS_99_027:[ Calling this API shall produce the string value+": "+pair) for the index header in the *destination parameter.]*/
+            char* runDestination = (*destination);
+            (void)memcpy(runDestination, entry->name, entry->nameLength);
+            runDestination += entry->nameLength;
+            (*runDestination++) = ':';
+            (*runDestination++) = ' ';
+            (void)memcpy(runDestination, entry->value, entry->valueLength + /*EOL*/ 1);
+            /*Codes_SRS_HTTP_HEADERS_99_035:[ The function shall return HTTP_HEADERS_OK when the function executed without error.]*/
+            result = HTTP_HEADERS_OK;
+        }
+    }
+
+    return result;
+}
+
+HTTP_HEADERS_RESULT HTTPHeaders_GetHeaderNameValue(HTTP_HEADERS_HANDLE handle, size_t index, const char** name, const char** value)
+{
+    HTTP_HEADERS_RESULT result;
+    /*Codes_SRS_HTTP_HEADERS_99_041: [ If handle, name or value is NULL then HTTPHeaders_GetHeaderNameValue shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    if (
+        (handle == NULL) ||
+        (name == NULL) ||
+        (value == NULL)
+        )
+    {
+        result = HTTP_HEADERS_INVALID_ARG;
+        LogError("invalid arg (NULL), result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+    }
+    /*Codes_SRS_HTTP_HEADERS_99_042: [ If index is not smaller than the number of stored headers then HTTPHeaders_GetHeaderNameValue shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    else if (index >= ((HTTP_HEADERS_HANDLE_DATA*)handle)->count)
+    {
+        result = HTTP_HEADERS_INVALID_ARG;
+        LogError("index out of bounds, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+    }
+    else
+    {
+        /*Codes_SRS_HTTP_HEADERS_99_043: [ Otherwise HTTPHeaders_GetHeaderNameValue shall set *name and *value to the stored strings of the header at index, without allocating, and return HTTP_HEADERS_OK. ]*/
+        const HTTP_HEADER_ENTRY* entry = &((HTTP_HEADERS_HANDLE_DATA*)handle)->entries[index];
+        *name = entry->name;
+        *value = entry->value;
+        result = HTTP_HEADERS_OK;
+    }
+    return result;
+}
+
+HTTP_HEADERS_RESULT HTTPHeaders_Serialize(HTTP_HEADERS_HANDLE handle, char* destination, size_t destinationSize, size_t* serializedSize)
+{
+    HTTP_HEADERS_RESULT result;
+    /*Codes_SRS_HTTP_HEADERS_99_044: [ If handle or serializedSize is NULL then HTTPHeaders_Serialize shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    if (
+        (handle == NULL) ||
+        (serializedSize == NULL)
+        )
+    {
+        result = HTTP_HEADERS_INVALID_ARG;
+        LogError("invalid arg (NULL), result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+    }
+    else
+    {
+        const HTTP_HEADERS_HANDLE_DATA* handleData = (const HTTP_HEADERS_HANDLE_DATA*)handle;
+        size_t required = 0;
+        size_t i;
+
+        /*Codes_SRS_HTTP_HEADERS_99_045: [ HTTPHeaders_Serialize shall set *serializedSize to the number of bytes needed to write every header as name+": "+value+"\r\n", in insertion order, without a terminating '\0'. ]*/
+        for (i = 0; i < handleData->count; i++)
+        {
+            required += handleData->entries[i].nameLength + /*COLON_AND_SPACE_LENGTH*/ 2 + handleData->entries[i].valueLength + /*CRLF*/ 2;
+        }
+        *serializedSize = required;
+
+        if (destination == NULL)
+        {
+            /*Codes_SRS_HTTP_HEADERS_99_046: [ If destination is NULL then HTTPHeaders_Serialize shall only compute *serializedSize and return HTTP_HEADERS_OK. ]*/
+            result = HTTP_HEADERS_OK;
+        }
+        else if (destinationSize < required)
+        {
+            /*Codes_SRS_HTTP_HEADERS_99_047: [ If destinationSize is smaller than *serializedSize then HTTPHeaders_Serialize shall not write to destination and shall return HTTP_HEADERS_INSUFFICIENT_BUFFER. ]*/
+            result = HTTP_HEADERS_INSUFFICIENT_BUFFER;
+        }
+        else
+        {
+            /*Codes_SRS_HTTP_HEADERS_99_048: [ Otherwise HTTPHeaders_Serialize shall write the headers to destination and return HTTP_HEADERS_OK. ]*/
+            char* runDestination = destination;
+            for (i = 0; i < handleData->count; i++)
             {
-                size_t keyLen = strlen(keys[index]);
-                size_t valueLen = strlen(values[index]);
-                *destination = (char*)malloc(sizeof(char) * (keyLen + /*COLON_AND_SPACE_LENGTH*/ 2 + valueLen + /*EOL*/ 1));
-                if (*destination == NULL)
-                {
-                    /*Codes_SRS_HTTP_HEADERS_99_034:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs]*/
-                    result = HTTP_HEADERS_ERROR;
-                    LogError("unable to malloc, result= %s", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
-                }
-                else
-                {
-                    /*Codes_SRS_HTTP_HEADERS_99_016:[ The function shall store the name:value pair in such a way that when later retrieved by a call to GetHeader it will return a string that shall strcmp equal to the name+": "+value.]*/
-                    /*Codes_SRS_HTTP_HEADERS_99_027:[ Calling this API shall produce the string value+": "+pair) for the index header in the *destination parameter.]*/
-                    char* runDestination = (*destination);
-                    (void)memcpy(runDestination, keys[index], keyLen);
-                    runDestination += keyLen;
-                    (*runDestination++) = ':';
-                    (*runDestination++) = ' ';
-                    (void)memcpy(runDestination, values[index], valueLen + /*EOL*/ 1);
-                    /*Codes_SRS_HTTP_HEADERS_99_035:[ The function shall return HTTP_HEADERS_OK when the function executed without error.]*/
-                    result = HTTP_HEADERS_OK;
-                }
+                const HTTP_HEADER_ENTRY* entry = &handleData->entries[i];
+                (void)memcpy(runDestination, entry->name, entry->nameLength);
+                runDestination += entry->nameLength;
+                (*runDestination++) = ':';
+                (*runDestination++) = ' ';
+                (void)memcpy(runDestination, entry->value, entry->valueLength);
+                runDestination += entry->valueLength;
+                (*runDestination++) = '\r';
+                (*runDestination++) = '\n';
             }
+            result = HTTP_HEADERS_OK;
         }
     }
-
     return result;
 }
 
@@ -309,26 +600,38 @@ HTTP_HEADERS_HANDLE HTTPHeaders_Clone(HTTP_HEADERS_HANDLE handle)
     }
     else
     {
+        HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)handle;
+        size_t stringsSize = 0;
+        size_t i;
+        for (i = 0; i < handleData->count; i++)
+        {
+            stringsSize += handleData->entries[i].nameLength + /*EOL*/ 1 + handleData->entries[i].valueLength + /*EOL*/ 1;
+        }
+
         /*Codes_SRS_HTTP_HEADERS_02_004: [Otherwise HTTPHeaders_Clone shall clone the content of handle to a new handle.] */
-        result = (HTTP_HEADERS_HANDLE_DATA*)malloc(sizeof(HTTP_HEADERS_HANDLE_DATA));
+        /*Codes_SRS_HTTP_HEADERS_99_049: [ HTTPHeaders_Clone shall allocate the clone, its headers and their strings in a single allocation. ]*/
+        result = createHandle(handleData->count, (stringsSize < HTTP_HEADERS_INITIAL_ARENA_SIZE) ? HTTP_HEADERS_INITIAL_ARENA_SIZE : stringsSize);
         if (result == NULL)
         {
             /*Codes_SRS_HTTP_HEADERS_02_005: [If cloning fails for any reason, then HTTPHeaders_Clone shall return NULL.] */
         }
         else
         {
-            HTTP_HEADERS_HANDLE_DATA* handleData = handle;
-            result->headers = Map_Clone(handleData->headers);
-            if (result->headers == NULL)
-            {
-                /*Codes_SRS_HTTP_HEADERS_02_005: [If cloning fails for any reason, then HTTPHeaders_Clone shall return NULL.] */
-                free(result);
-                result = NULL;
-            }
-            else
+            for (i = 0; i < handleData->count; i++)
             {
-                /*all is fine*/
+                const HTTP_HEADER_ENTRY* source = &handleData->entries[i];
+                HTTP_HEADER_ENTRY* entry = &result->entries[i];
+                /*cannot fail, the inline arena was sized for all the strings*/
+                char* storage = arenaAllocate(result, source->nameLength + /*EOL*/ 1 + source->valueLength + /*EOL*/ 1);
+                *entry = *source;
+                entry->name = storage;
+                entry->value = storage + source->nameLength + 1;
+                entry->valueCapacity = source->valueLength;
+                (void)memcpy(entry->name, source->name, source->nameLength + /*EOL*/ 1);
+                (void)memcpy(entry->value, source->value, source->valueLength + /*EOL*/ 1);
             }
+            result->count = handleData->count;
+            rebuildBuckets(result);
         }
     }
     return result;
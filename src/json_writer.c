@@ -0,0 +1,894 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/json_writer.h"
+#include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+/*
+ * Strings are copied a run at a time: the run of characters that need no escaping is
+ * found 16 bytes at a time with SSE2 or NEON, 8 bytes at a time with plain 64-bit words
+ * otherwise, then copied with memcpy. Define NO_JSON_WRITER_SIMD to always use the
+ * 64-bit word loop.
+ */
+#if !defined(NO_JSON_WRITER_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__))
+#define JSON_WRITER_USE_SSE2
+#include <emmintrin.h>
+#elif !defined(NO_JSON_WRITER_SIMD) && defined(__aarch64__) && (defined(__clang__) || defined(__GNUC__))
+#define JSON_WRITER_USE_NEON
+#include <arm_neon.h>
+#endif
+
+#define JSON_WRITER_DEFAULT_CAPACITY    64
+
+/*longest output of one escaped character: \u00XX*/
+#define JSON_WRITER_MAX_ESCAPE_LENGTH   6
+
+/*0 for characters copied as they are, 'u' for control characters written as \u00XX, otherwise the character that follows the backslash*/
+#define U 'u'
+static const unsigned char json_escapes[256] =
+{
+    U, U, U, U, U, U, U, U, U, U, U, U, U, U, U, U,
+    U, U, U, U, U, U, U, U, U, U, U, U, U, U, U, U,
+    0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '/',
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+#undef U
+
+static const char hexToASCII[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+
+typedef struct JSON_WRITER_TAG
+{
+    char* buffer;
+    size_t length;
+    size_t capacity;
+    size_t depth;
+    /*bit n describes the container opened at depth n + 1*/
+    uint32_t objectMask;
+    uint32_t notEmptyMask;
+    bool keyPending;
+    bool rootWritten;
+} JSON_WRITER;
+
+/*Returns how many of the leading bytes need no escaping; may stop short on the last few bytes, the caller checks those one by one*/
+#if defined(JSON_WRITER_USE_SSE2)
+static size_t plain_prefix_block(const unsigned char* value, size_t length)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i slash = _mm_set1_epi8('/');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    size_t pos = 0;
+
+    while (length - pos >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(value + pos));
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, slash), _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk)));
+        int mask = _mm_movemask_epi8(special);
+        if (mask != 0)
+        {
+            while (json_escapes[value[pos]] == 0)
+            {
+                pos++;
+            }
+            break;
+        }
+        pos += 16;
+    }
+
+    return pos;
+}
+#elif defined(JSON_WRITER_USE_NEON)
+static size_t plain_prefix_block(const unsigned char* value, size_t length)
+{
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t slash = vdupq_n_u8('/');
+    const uint8x16_t control = vdupq_n_u8(0x1F);
+    size_t pos = 0;
+
+    while (length - pos >= 16)
+    {
+        uint8x16_t chunk = vld1q_u8(value + pos);
+        uint8x16_t special = vorrq_u8(
+            vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+            vorrq_u8(vceqq_u8(chunk, slash), vcleq_u8(chunk, control)));
+        if (vmaxvq_u8(special) != 0)
+        {
+            while (json_escapes[value[pos]] == 0)
+            {
+                pos++;
+            }
+            break;
+        }
+        pos += 16;
+    }
+
+    return pos;
+}
+#else
+static size_t plain_prefix_block(const unsigned char* value, size_t length)
+{
+    size_t pos = 0;
+
+    while (length - pos >= sizeof(uint64_t))
+    {
+        uint64_t word;
+        uint64_t quote;
+        uint64_t backslash;
+        uint64_t slash;
+
+        (void)memcpy(&word, value + pos, sizeof(word));
+        quote = word ^ 0x2222222222222222ULL;
+        backslash = word ^ 0x5C5C5C5C5C5C5C5CULL;
+        slash = word ^ 0x2F2F2F2F2F2F2F2FULL;
+
+        /*a byte below 0x20 or a zero byte in any of the xored words flags a character to escape*/
+        if ((((word - 0x2020202020202020ULL) & ~word) |
+             ((quote - 0x0101010101010101ULL) & ~quote) |
+             ((backslash - 0x0101010101010101ULL) & ~backslash) |
+             ((slash - 0x0101010101010101ULL) & ~slash)) & 0x8080808080808080ULL)
+        {
+            while (json_escapes[value[pos]] == 0)
+            {
+                pos++;
+            }
+            break;
+        }
+        pos += sizeof(uint64_t);
+    }
+
+    return pos;
+}
+#endif
+
+static size_t plain_prefix(const unsigned char* value, size_t length)
+{
+    size_t pos = plain_prefix_block(value, length);
+
+    while ((pos < length) && (json_escapes[value[pos]] == 0))
+    {
+        pos++;
+    }
+
+    return pos;
+}
+
+/*makes room for extra more characters and the terminating \0*/
+static int reserve(JSON_WRITER* writer, size_t extra)
+{
+    int result;
+
+    if (extra >= SIZE_MAX - writer->length)
+    {
+        LogError("JSON text too large");
+        result = __FAILURE__;
+    }
+    else if (writer->length + extra < writer->capacity)
+    {
+        result = 0;
+    }
+    else
+    {
+        size_t newCapacity = (writer->capacity < JSON_WRITER_DEFAULT_CAPACITY) ? JSON_WRITER_DEFAULT_CAPACITY : writer->capacity;
+        char* newBuffer;
+
+        while ((newCapacity <= writer->length + extra) && (newCapacity <= SIZE_MAX / 2))
+        {
+            newCapacity *= 2;
+        }
+        if (newCapacity <= writer->length + extra)
+        {
+            newCapacity = writer->length + extra + 1;
+        }
+
+        /*Codes_SRS_JSON_WRITER_01_013: [ When the buffer is too small for a write, it shall be grown by calling realloc to at least twice its size. ]*/
+        if ((newBuffer = (char*)realloc(writer->buffer, newCapacity)) == NULL)
+        {
+            /*Codes_SRS_JSON_WRITER_01_026: [ If the buffer cannot grow, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail, return a non-zero value and leave the text as it was. ]*/
+            LogError("Unable to grow the JSON buffer to %lu bytes", (unsigned long)newCapacity);
+            result = __FAILURE__;
+        }
+        else
+        {
+            writer->buffer = newBuffer;
+            writer->capacity = newCapacity;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static void append(JSON_WRITER* writer, const char* text, size_t length)
+{
+    (void)memcpy(writer->buffer + writer->length, text, length);
+    writer->length += length;
+}
+
+static int write_raw_char(JSON_WRITER* writer, char c)
+{
+    int result;
+
+    if (reserve(writer, 1) != 0)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        writer->buffer[writer->length++] = c;
+        writer->buffer[writer->length] = '\0';
+        result = 0;
+    }
+
+    return result;
+}
+
+/*drops whatever was written after length, used to undo a write that failed half way*/
+static void rewind_to(JSON_WRITER* writer, size_t length)
+{
+    writer->length = length;
+    if (writer->buffer != NULL)
+    {
+        writer->buffer[length] = '\0';
+    }
+}
+
+/*appends value between quotes; returns 0 on success and leaves the text unchanged otherwise*/
+static int append_quoted(JSON_WRITER* writer, const char* value)
+{
+    int result;
+    const unsigned char* in = (const unsigned char*)value;
+    size_t remaining = strlen(value);
+    size_t start = writer->length;
+
+    /*room for the common case of nothing to escape; escapes reserve more as they come*/
+    if (reserve(writer, remaining + 2) != 0)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        writer->buffer[writer->length++] = '"';
+        result = 0;
+
+        while ((result == 0) && (remaining > 0))
+        {
+            size_t run = plain_prefix(in, remaining);
+
+            if (reserve(writer, run + JSON_WRITER_MAX_ESCAPE_LENGTH + 1) != 0)
+            {
+                result = __FAILURE__;
+            }
+            else
+            {
+                append(writer, (const char*)in, run);
+                in += run;
+                remaining -= run;
+
+                if (remaining > 0)
+                {
+                    unsigned char escape = json_escapes[*in];
+                    writer->buffer[writer->length++] = '\\';
+                    if (escape == 'u')
+                    {
+                        writer->buffer[writer->length++] = 'u';
+                        writer->buffer[writer->length++] = '0';
+                        writer->buffer[writer->length++] = '0';
+                        writer->buffer[writer->length++] = hexToASCII[(*in & 0xF0) >> 4];
+                        writer->buffer[writer->length++] = hexToASCII[*in & 0x0F];
+                    }
+                    else
+                    {
+                        writer->buffer[writer->length++] = (char)escape;
+                    }
+                    in++;
+                    remaining--;
+                }
+            }
+        }
+
+        if (result == 0)
+        {
+            writer->buffer[writer->length++] = '"';
+        }
+    }
+
+    if (result != 0)
+    {
+        rewind_to(writer, start);
+    }
+    else
+    {
+        writer->buffer[writer->length] = '\0';
+    }
+
+    return result;
+}
+
+static bool in_object(const JSON_WRITER* writer)
+{
+    return (writer->depth > 0) && ((writer->objectMask & ((uint32_t)1 << (writer->depth - 1))) != 0);
+}
+
+/*checks that a value can be written at this point of the document*/
+static int check_value(const JSON_WRITER* writer)
+{
+    int result;
+
+    if ((writer->depth == 0) ? writer->rootWritten : (in_object(writer) && !writer->keyPending))
+    {
+        /*Codes_SRS_JSON_WRITER_01_009: [ If a value cannot be written at this point of the document, because the writer is in an object and no key was written for it, or the document already holds a complete value, the json_writer_begin_* and json_writer_write_* value functions shall fail and return a non-zero value. ]*/
+        LogError("A JSON value cannot be written at this point");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+/*writes text as the next value, preceded by a comma when it follows another element of an array*/
+static int write_value(JSON_WRITER* writer, const char* text, size_t length)
+{
+    int result;
+    bool needsComma = (writer->depth > 0) && !in_object(writer) && ((writer->notEmptyMask & ((uint32_t)1 << (writer->depth - 1))) != 0);
+
+    if (reserve(writer, length + 1) != 0)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_010: [ A value that is not the first element of an array shall be preceded by a comma. ]*/
+        if (needsComma)
+        {
+            writer->buffer[writer->length++] = ',';
+        }
+        append(writer, text, length);
+        writer->buffer[writer->length] = '\0';
+        result = 0;
+    }
+
+    return result;
+}
+
+/*records that a complete value was written in the current container*/
+static void value_written(JSON_WRITER* writer)
+{
+    if (writer->depth == 0)
+    {
+        writer->rootWritten = true;
+    }
+    else
+    {
+        writer->notEmptyMask |= ((uint32_t)1 << (writer->depth - 1));
+        writer->keyPending = false;
+    }
+}
+
+static int write_scalar(JSON_WRITER* writer, const char* text, size_t length)
+{
+    int result;
+
+    if (check_value(writer) != 0)
+    {
+        result = __FAILURE__;
+    }
+    else if (write_value(writer, text, length) != 0)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        value_written(writer);
+        result = 0;
+    }
+
+    return result;
+}
+
+static int begin_container(JSON_WRITER* writer, bool isObject)
+{
+    int result;
+
+    if (check_value(writer) != 0)
+    {
+        result = __FAILURE__;
+    }
+    else if (writer->depth >= JSON_WRITER_MAX_DEPTH)
+    {
+        /*Codes_SRS_JSON_WRITER_01_011: [ If JSON_WRITER_MAX_DEPTH objects and arrays are already open, json_writer_begin_object and json_writer_begin_array shall fail and return a non-zero value. ]*/
+        LogError("JSON nesting deeper than %d", JSON_WRITER_MAX_DEPTH);
+        result = __FAILURE__;
+    }
+    /*Codes_SRS_JSON_WRITER_01_012: [ json_writer_begin_object and json_writer_begin_array shall write { or [ and return 0. ]*/
+    else if (write_value(writer, isObject ? "{" : "[", 1) != 0)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        uint32_t bit = (uint32_t)1 << writer->depth;
+
+        value_written(writer);
+        writer->depth++;
+        writer->notEmptyMask &= ~bit;
+        if (isObject)
+        {
+            writer->objectMask |= bit;
+        }
+        else
+        {
+            writer->objectMask &= ~bit;
+        }
+        result = 0;
+    }
+
+    return result;
+}
+
+static int end_container(JSON_WRITER* writer, bool isObject)
+{
+    int result;
+
+    if ((writer->depth == 0) || (in_object(writer) != isObject) || writer->keyPending)
+    {
+        /*Codes_SRS_JSON_WRITER_01_014: [ If the innermost open container is not an object (for json_writer_end_object) or not an array (for json_writer_end_array), or a key was written without its value, the function shall fail and return a non-zero value. ]*/
+        LogError("No open JSON %s to close", isObject ? "object" : "array");
+        result = __FAILURE__;
+    }
+    else if (reserve(writer, 1) != 0)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_015: [ json_writer_end_object and json_writer_end_array shall write } or ] and return 0. ]*/
+        writer->buffer[writer->length++] = isObject ? '}' : ']';
+        writer->buffer[writer->length] = '\0';
+        writer->depth--;
+        result = 0;
+    }
+
+    return result;
+}
+
+JSON_WRITER_HANDLE json_writer_create(size_t initialCapacity)
+{
+    JSON_WRITER* result;
+
+    /*Codes_SRS_JSON_WRITER_01_001: [ json_writer_create shall allocate a writer and a buffer of initialCapacity bytes, or of a small default size if initialCapacity is 0. ]*/
+    if ((result = (JSON_WRITER*)malloc(sizeof(JSON_WRITER))) == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_002: [ If any allocation fails, json_writer_create shall fail and return NULL. ]*/
+        LogError("Unable to allocate the JSON writer");
+    }
+    else
+    {
+        (void)memset(result, 0, sizeof(JSON_WRITER));
+        result->capacity = (initialCapacity == 0) ? JSON_WRITER_DEFAULT_CAPACITY : initialCapacity;
+        if ((result->buffer = (char*)malloc(result->capacity)) == NULL)
+        {
+            /*Codes_SRS_JSON_WRITER_01_002: [ If any allocation fails, json_writer_create shall fail and return NULL. ]*/
+            LogError("Unable to allocate %lu bytes for the JSON buffer", (unsigned long)result->capacity);
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            result->buffer[0] = '\0';
+        }
+    }
+
+    return result;
+}
+
+void json_writer_destroy(JSON_WRITER_HANDLE writer)
+{
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_003: [ If writer is NULL, json_writer_destroy shall return. ]*/
+        LogError("NULL writer");
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_004: [ json_writer_destroy shall free the buffer and the writer. ]*/
+        free(writer->buffer);
+        free(writer);
+    }
+}
+
+void json_writer_reset(JSON_WRITER_HANDLE writer)
+{
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_005: [ If writer is NULL, json_writer_reset shall return. ]*/
+        LogError("NULL writer");
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_006: [ json_writer_reset shall empty the text and close every container, keeping the buffer. ]*/
+        writer->length = 0;
+        if (writer->buffer != NULL)
+        {
+            writer->buffer[0] = '\0';
+        }
+        writer->depth = 0;
+        writer->objectMask = 0;
+        writer->notEmptyMask = 0;
+        writer->keyPending = false;
+        writer->rootWritten = false;
+    }
+}
+
+int json_writer_begin_object(JSON_WRITER_HANDLE writer)
+{
+    int result;
+
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+        LogError("NULL writer");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = begin_container(writer, true);
+    }
+
+    return result;
+}
+
+int json_writer_end_object(JSON_WRITER_HANDLE writer)
+{
+    int result;
+
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+        LogError("NULL writer");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = end_container(writer, true);
+    }
+
+    return result;
+}
+
+int json_writer_begin_array(JSON_WRITER_HANDLE writer)
+{
+    int result;
+
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+        LogError("NULL writer");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = begin_container(writer, false);
+    }
+
+    return result;
+}
+
+int json_writer_end_array(JSON_WRITER_HANDLE writer)
+{
+    int result;
+
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+        LogError("NULL writer");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = end_container(writer, false);
+    }
+
+    return result;
+}
+
+int json_writer_write_key(JSON_WRITER_HANDLE writer, const char* key)
+{
+    int result;
+
+    if ((writer == NULL) || (key == NULL))
+    {
+        /*Codes_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+        /*Codes_SRS_JSON_WRITER_01_008: [ If the string argument of json_writer_write_key, json_writer_write_string or json_writer_write_raw is NULL, the function shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: writer = %p, key = %p", writer, key);
+        result = __FAILURE__;
+    }
+    else if (!in_object(writer) || writer->keyPending)
+    {
+        /*Codes_SRS_JSON_WRITER_01_016: [ If the innermost open container is not an object, or the previous key has no value yet, json_writer_write_key shall fail and return a non-zero value. ]*/
+        LogError("A JSON key cannot be written at this point");
+        result = __FAILURE__;
+    }
+    else
+    {
+        size_t start = writer->length;
+        bool needsComma = (writer->notEmptyMask & ((uint32_t)1 << (writer->depth - 1))) != 0;
+
+        /*Codes_SRS_JSON_WRITER_01_017: [ json_writer_write_key shall write a comma if the object already has a member, then the key quoted and escaped like json_writer_write_string does, then a colon, and return 0. ]*/
+        if ((reserve(writer, 2) != 0) ||
+            ((needsComma) && (write_raw_char(writer, ',') != 0)) ||
+            (append_quoted(writer, key) != 0) ||
+            (write_raw_char(writer, ':') != 0))
+        {
+            rewind_to(writer, start);
+            result = __FAILURE__;
+        }
+        else
+        {
+            writer->keyPending = true;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+int json_writer_write_string(JSON_WRITER_HANDLE writer, const char* value)
+{
+    int result;
+
+    if ((writer == NULL) || (value == NULL))
+    {
+        /*Codes_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+        /*Codes_SRS_JSON_WRITER_01_008: [ If the string argument of json_writer_write_key, json_writer_write_string or json_writer_write_raw is NULL, the function shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: writer = %p, value = %p", writer, value);
+        result = __FAILURE__;
+    }
+    else if (check_value(writer) != 0)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        size_t start = writer->length;
+
+        /*Codes_SRS_JSON_WRITER_01_018: [ json_writer_write_string shall write value between quotes, with " \ and / preceded by a backslash, characters below 0x20 written as \u00XX with XX their upper case hex code, and every other byte copied as it is, and return 0. ]*/
+        if ((write_value(writer, "", 0) != 0) ||
+            (append_quoted(writer, value) != 0))
+        {
+            rewind_to(writer, start);
+            result = __FAILURE__;
+        }
+        else
+        {
+            value_written(writer);
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+int json_writer_write_int64(JSON_WRITER_HANDLE writer, int64_t value)
+{
+    int result;
+
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+        LogError("NULL writer");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_019: [ json_writer_write_int64 shall write value in decimal and return 0. ]*/
+        char digits[21];
+        size_t pos = sizeof(digits);
+        uint64_t magnitude = (value < 0) ? ((uint64_t)0 - (uint64_t)value) : (uint64_t)value;
+
+        do
+        {
+            digits[--pos] = (char)('0' + (magnitude % 10));
+            magnitude /= 10;
+        } while (magnitude != 0);
+
+        if (value < 0)
+        {
+            digits[--pos] = '-';
+        }
+
+        result = write_scalar(writer, digits + pos, sizeof(digits) - pos);
+    }
+
+    return result;
+}
+
+int json_writer_write_double(JSON_WRITER_HANDLE writer, double value)
+{
+    int result;
+
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+        LogError("NULL writer");
+        result = __FAILURE__;
+    }
+    else if (!((value - value) == 0.0))
+    {
+        /*Codes_SRS_JSON_WRITER_01_020: [ If value is NaN or infinite, json_writer_write_double shall fail and return a non-zero value. ]*/
+        LogError("NaN and infinities cannot be written as JSON");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_021: [ json_writer_write_double shall write the shortest of the 15 and 17 significant digit representations of value that reads back as value, and return 0. ]*/
+        char text[32];
+        int length = snprintf(text, sizeof(text), "%.15g", value);
+
+        if ((length > 0) && (strtod(text, NULL) != value))
+        {
+            length = snprintf(text, sizeof(text), "%.17g", value);
+        }
+
+        if ((length <= 0) || ((size_t)length >= sizeof(text)))
+        {
+            LogError("Unable to format the number");
+            result = __FAILURE__;
+        }
+        else
+        {
+            result = write_scalar(writer, text, (size_t)length);
+        }
+    }
+
+    return result;
+}
+
+int json_writer_write_bool(JSON_WRITER_HANDLE writer, bool value)
+{
+    int result;
+
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+        LogError("NULL writer");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_022: [ json_writer_write_bool shall write true or false, json_writer_write_null shall write null, and both shall return 0. ]*/
+        result = value ? write_scalar(writer, "true", 4) : write_scalar(writer, "false", 5);
+    }
+
+    return result;
+}
+
+int json_writer_write_null(JSON_WRITER_HANDLE writer)
+{
+    int result;
+
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+        LogError("NULL writer");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_022: [ json_writer_write_bool shall write true or false, json_writer_write_null shall write null, and both shall return 0. ]*/
+        result = write_scalar(writer, "null", 4);
+    }
+
+    return result;
+}
+
+int json_writer_write_raw(JSON_WRITER_HANDLE writer, const char* json)
+{
+    int result;
+
+    if ((writer == NULL) || (json == NULL))
+    {
+        /*Codes_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+        /*Codes_SRS_JSON_WRITER_01_008: [ If the string argument of json_writer_write_key, json_writer_write_string or json_writer_write_raw is NULL, the function shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: writer = %p, json = %p", writer, json);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_023: [ json_writer_write_raw shall write json as it is, as one value, and return 0. ]*/
+        result = write_scalar(writer, json, strlen(json));
+    }
+
+    return result;
+}
+
+const char* json_writer_get_string(JSON_WRITER_HANDLE writer)
+{
+    const char* result;
+
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_024: [ If writer is NULL, json_writer_get_string shall return NULL. ]*/
+        LogError("NULL writer");
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_025: [ json_writer_get_string shall return the \0 terminated text written so far. ]*/
+        result = (writer->buffer == NULL) ? "" : writer->buffer;
+    }
+
+    return result;
+}
+
+size_t json_writer_get_length(JSON_WRITER_HANDLE writer)
+{
+    size_t result;
+
+    if (writer == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_027: [ If writer is NULL, json_writer_get_length shall return 0. ]*/
+        LogError("NULL writer");
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_028: [ json_writer_get_length shall return the number of characters written so far. ]*/
+        result = writer->length;
+    }
+
+    return result;
+}
+
+STRING_HANDLE json_writer_detach_STRING(JSON_WRITER_HANDLE writer)
+{
+    STRING_HANDLE result;
+
+    if ((writer == NULL) || (writer->depth > 0) || !writer->rootWritten)
+    {
+        /*Codes_SRS_JSON_WRITER_01_029: [ If writer is NULL, or no value was written, or an object or array is still open, json_writer_detach_STRING shall fail and return NULL. ]*/
+        LogError("No complete JSON document to detach");
+        result = NULL;
+    }
+    /*Codes_SRS_JSON_WRITER_01_030: [ json_writer_detach_STRING shall create the STRING by calling STRING_new_with_memory with the buffer, without copying the text. ]*/
+    else if ((result = STRING_new_with_memory(writer->buffer)) == NULL)
+    {
+        /*Codes_SRS_JSON_WRITER_01_031: [ If STRING_new_with_memory fails, json_writer_detach_STRING shall fail, return NULL and keep the text. ]*/
+        LogError("Unable to create the STRING");
+    }
+    else
+    {
+        /*Codes_SRS_JSON_WRITER_01_032: [ On success the writer shall be reset and shall allocate a new buffer on its next write. ]*/
+        writer->buffer = NULL;
+        writer->capacity = 0;
+        json_writer_reset(writer);
+    }
+
+    return result;
+}
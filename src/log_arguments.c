@@ -0,0 +1,620 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "azure_c_shared_utility/log_arguments.h"
+
+/*
+ * A conversion is parsed the same way when its arguments are captured and when the message is
+ * rendered, so the stored values are consumed in the order they were stored. Rendering rebuilds
+ * each conversion with the length modifier of the stored value (64 bit integers, double) and
+ * formats it with snprintf.
+ */
+#define LOG_ARGUMENTS_CONVERSION_SIZE   32
+
+typedef enum CONVERSION_LENGTH_TAG
+{
+    CONVERSION_LENGTH_NONE,
+    CONVERSION_LENGTH_HH,
+    CONVERSION_LENGTH_H,
+    CONVERSION_LENGTH_L,
+    CONVERSION_LENGTH_LL,
+    CONVERSION_LENGTH_J,
+    CONVERSION_LENGTH_Z,
+    CONVERSION_LENGTH_T,
+    CONVERSION_LENGTH_LONG_DOUBLE
+} CONVERSION_LENGTH;
+
+/*a printf conversion, without its '%'*/
+typedef struct CONVERSION_TAG
+{
+    const char* flags;
+    size_t flags_length;
+    bool width_is_argument;
+    const char* width;
+    size_t width_length;
+    bool has_precision;
+    bool precision_is_argument;
+    const char* precision;
+    size_t precision_length;
+    CONVERSION_LENGTH length;
+    /*'\0' if the format ends inside the conversion*/
+    char specifier;
+} CONVERSION;
+
+/* format strings */
+
+static const char* parse_digits(const char* position, const char** digits, size_t* length)
+{
+    *digits = position;
+    while ((*position >= '0') && (*position <= '9'))
+    {
+        position++;
+    }
+    *length = (size_t)(position - *digits);
+    return position;
+}
+
+/*parses the conversion that starts right after a '%' and returns where it ends*/
+static const char* parse_conversion(const char* position, CONVERSION* conversion)
+{
+    conversion->flags = position;
+    while ((*position == '-') || (*position == '+') || (*position == ' ') || (*position == '#') || (*position == '0'))
+    {
+        position++;
+    }
+    conversion->flags_length = (size_t)(position - conversion->flags);
+
+    conversion->width_is_argument = (*position == '*');
+    if (conversion->width_is_argument)
+    {
+        conversion->width = NULL;
+        conversion->width_length = 0;
+        position++;
+    }
+    else
+    {
+        position = parse_digits(position, &conversion->width, &conversion->width_length);
+    }
+
+    conversion->has_precision = (*position == '.');
+    conversion->precision_is_argument = false;
+    conversion->precision = NULL;
+    conversion->precision_length = 0;
+    if (conversion->has_precision)
+    {
+        position++;
+        conversion->precision_is_argument = (*position == '*');
+        if (conversion->precision_is_argument)
+        {
+            position++;
+        }
+        else
+        {
+            position = parse_digits(position, &conversion->precision, &conversion->precision_length);
+        }
+    }
+
+    conversion->length = CONVERSION_LENGTH_NONE;
+    switch (*position)
+    {
+    case 'h':
+        position++;
+        conversion->length = CONVERSION_LENGTH_H;
+        if (*position == 'h')
+        {
+            position++;
+            conversion->length = CONVERSION_LENGTH_HH;
+        }
+        break;
+    case 'l':
+        position++;
+        conversion->length = CONVERSION_LENGTH_L;
+        if (*position == 'l')
+        {
+            position++;
+            conversion->length = CONVERSION_LENGTH_LL;
+        }
+        break;
+    case 'j':
+        position++;
+        conversion->length = CONVERSION_LENGTH_J;
+        break;
+    case 'z':
+        position++;
+        conversion->length = CONVERSION_LENGTH_Z;
+        break;
+    case 't':
+        position++;
+        conversion->length = CONVERSION_LENGTH_T;
+        break;
+    case 'L':
+        position++;
+        conversion->length = CONVERSION_LENGTH_LONG_DOUBLE;
+        break;
+    default:
+        break;
+    }
+
+    conversion->specifier = *position;
+    if (*position != '\0')
+    {
+        position++;
+    }
+
+    return position;
+}
+
+/* capturing */
+
+static void put_value(LOG_ARGUMENTS* arguments, unsigned char tag, const void* value)
+{
+    if (arguments->size - arguments->used < 1 + sizeof(uint64_t))
+    {
+        arguments->truncated = true;
+    }
+    else
+    {
+        arguments->buffer[arguments->used] = tag;
+        (void)memcpy(arguments->buffer + arguments->used + 1, value, sizeof(uint64_t));
+        arguments->used += 1 + sizeof(uint64_t);
+    }
+}
+
+static void put_signed(LOG_ARGUMENTS* arguments, int64_t value)
+{
+    put_value(arguments, LOG_ARGUMENT_SIGNED, &value);
+}
+
+static void put_unsigned(LOG_ARGUMENTS* arguments, uint64_t value)
+{
+    put_value(arguments, LOG_ARGUMENT_UNSIGNED, &value);
+}
+
+static void put_string(LOG_ARGUMENTS* arguments, const char* value)
+{
+    if (arguments->size - arguments->used < 1 + sizeof(uint16_t))
+    {
+        arguments->truncated = true;
+    }
+    else
+    {
+        size_t room = arguments->size - arguments->used - 1 - sizeof(uint16_t);
+        size_t length = strlen((value == NULL) ? "(null)" : value);
+        uint16_t stored_length;
+        if (length > room)
+        {
+            /*keeps what fits; no argument can follow it*/
+            length = room;
+            arguments->truncated = true;
+        }
+
+        stored_length = (uint16_t)length;
+        arguments->buffer[arguments->used] = LOG_ARGUMENT_STRING;
+        (void)memcpy(arguments->buffer + arguments->used + 1, &stored_length, sizeof(uint16_t));
+        (void)memcpy(arguments->buffer + arguments->used + 1 + sizeof(uint16_t), (value == NULL) ? "(null)" : value, length);
+        arguments->used += 1 + sizeof(uint16_t) + length;
+    }
+}
+
+/*stores the arguments the conversions of format consume, as they are*/
+void log_arguments_capture(LOG_ARGUMENTS* arguments, const char* format, va_list args)
+{
+    const char* position = format;
+
+    while (!arguments->truncated && (*position != '\0'))
+    {
+        if (*position != '%')
+        {
+            position++;
+        }
+        else
+        {
+            CONVERSION conversion;
+            position = parse_conversion(position + 1, &conversion);
+
+            if (conversion.width_is_argument)
+            {
+                put_signed(arguments, va_arg(args, int));
+            }
+            if (conversion.precision_is_argument)
+            {
+                put_signed(arguments, va_arg(args, int));
+            }
+
+            switch (conversion.specifier)
+            {
+            case '%':
+                break;
+            case 'd':
+            case 'i':
+                switch (conversion.length)
+                {
+                case CONVERSION_LENGTH_L:
+                    put_signed(arguments, va_arg(args, long));
+                    break;
+                case CONVERSION_LENGTH_LL:
+                    put_signed(arguments, va_arg(args, long long));
+                    break;
+                case CONVERSION_LENGTH_J:
+                    put_signed(arguments, va_arg(args, intmax_t));
+                    break;
+                case CONVERSION_LENGTH_Z:
+                    put_signed(arguments, (int64_t)va_arg(args, size_t));
+                    break;
+                case CONVERSION_LENGTH_T:
+                    put_signed(arguments, va_arg(args, ptrdiff_t));
+                    break;
+                default:
+                    put_signed(arguments, va_arg(args, int));
+                    break;
+                }
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                switch (conversion.length)
+                {
+                case CONVERSION_LENGTH_L:
+                    put_unsigned(arguments, va_arg(args, unsigned long));
+                    break;
+                case CONVERSION_LENGTH_LL:
+                    put_unsigned(arguments, va_arg(args, unsigned long long));
+                    break;
+                case CONVERSION_LENGTH_J:
+                    put_unsigned(arguments, va_arg(args, uintmax_t));
+                    break;
+                case CONVERSION_LENGTH_Z:
+                    put_unsigned(arguments, va_arg(args, size_t));
+                    break;
+                case CONVERSION_LENGTH_T:
+                    put_unsigned(arguments, (uint64_t)va_arg(args, ptrdiff_t));
+                    break;
+                default:
+                    put_unsigned(arguments, va_arg(args, unsigned int));
+                    break;
+                }
+                break;
+            case 'c':
+                put_signed(arguments, va_arg(args, int));
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+            {
+                double value = (conversion.length == CONVERSION_LENGTH_LONG_DOUBLE) ? (double)va_arg(args, long double) : va_arg(args, double);
+                put_value(arguments, LOG_ARGUMENT_DOUBLE, &value);
+                break;
+            }
+            case 's':
+                if (conversion.length == CONVERSION_LENGTH_L)
+                {
+                    (void)va_arg(args, const void*);
+                    put_string(arguments, "(wide string)");
+                }
+                else
+                {
+                    put_string(arguments, va_arg(args, const char*));
+                }
+                break;
+            case 'p':
+            {
+                uint64_t value = (uint64_t)(uintptr_t)va_arg(args, void*);
+                put_value(arguments, LOG_ARGUMENT_POINTER, &value);
+                break;
+            }
+            case 'n':
+                (void)va_arg(args, void*);
+                break;
+            default:
+                /*the types of the arguments that follow are unknown*/
+                arguments->truncated = true;
+                break;
+            }
+        }
+    }
+}
+
+/* rendering */
+
+unsigned char log_arguments_next_tag(const LOG_ARGUMENTS_READER* reader)
+{
+    return (reader->used < reader->size) ? reader->buffer[reader->used] : 0;
+}
+
+bool log_arguments_get_value(LOG_ARGUMENTS_READER* reader, unsigned char tag, void* value)
+{
+    bool result;
+    if ((log_arguments_next_tag(reader) != tag) || (reader->size - reader->used < 1 + sizeof(uint64_t)))
+    {
+        result = false;
+    }
+    else
+    {
+        (void)memcpy(value, reader->buffer + reader->used + 1, sizeof(uint64_t));
+        reader->used += 1 + sizeof(uint64_t);
+        result = true;
+    }
+    return result;
+}
+
+bool log_arguments_get_string(LOG_ARGUMENTS_READER* reader, const char** value, size_t* length)
+{
+    bool result;
+    uint16_t stored_length;
+    if ((log_arguments_next_tag(reader) != LOG_ARGUMENT_STRING) || (reader->size - reader->used < 1 + sizeof(uint16_t)))
+    {
+        result = false;
+    }
+    else
+    {
+        (void)memcpy(&stored_length, reader->buffer + reader->used + 1, sizeof(uint16_t));
+        if (stored_length > reader->size - reader->used - 1 - sizeof(uint16_t))
+        {
+            result = false;
+        }
+        else
+        {
+            *value = (const char*)reader->buffer + reader->used + 1 + sizeof(uint16_t);
+            *length = stored_length;
+            reader->used += 1 + sizeof(uint16_t) + stored_length;
+            result = true;
+        }
+    }
+    return result;
+}
+
+typedef struct MESSAGE_TAG
+{
+    char* text;
+    size_t size;
+    size_t length;
+    /*set when text was cut*/
+    bool cut;
+} MESSAGE;
+
+static void append_text(MESSAGE* message, const char* text, size_t length)
+{
+    size_t room = message->size - 1 - message->length;
+    if (length > room)
+    {
+        length = room;
+        message->cut = true;
+    }
+    (void)memcpy(message->text + message->length, text, length);
+    message->length += length;
+    message->text[message->length] = '\0';
+}
+
+static void append_formatted(MESSAGE* message, int written)
+{
+    /*snprintf wrote into the rest of the text and returned how much it wanted to*/
+    size_t room = message->size - 1 - message->length;
+    if (written > 0)
+    {
+        if ((size_t)written > room)
+        {
+            written = (int)room;
+            message->cut = true;
+        }
+        message->length += (size_t)written;
+    }
+    message->text[message->length] = '\0';
+}
+
+/*builds "%<flags><width><.precision><length><specifier>" with the '*'s replaced by their values*/
+static bool build_conversion(char* spec, const CONVERSION* conversion, LOG_ARGUMENTS_READER* reader, const char* length, char specifier)
+{
+    bool result = true;
+    size_t used = 0;
+    int64_t width = 0;
+    int64_t precision = 0;
+
+    if ((conversion->flags_length > 5) || (conversion->width_length > 3) || (conversion->precision_length > 3) ||
+        (conversion->width_is_argument && !log_arguments_get_value(reader, LOG_ARGUMENT_SIGNED, &width)) ||
+        (conversion->precision_is_argument && !log_arguments_get_value(reader, LOG_ARGUMENT_SIGNED, &precision)))
+    {
+        result = false;
+    }
+    else
+    {
+        spec[used++] = '%';
+        (void)memcpy(spec + used, conversion->flags, conversion->flags_length);
+        used += conversion->flags_length;
+        if (conversion->width_is_argument)
+        {
+            /*bounded, as the value may come from a file*/
+            used += (size_t)sprintf(spec + used, "%d", (int)((width < -999) ? -999 : ((width > 999) ? 999 : width)));
+        }
+        else
+        {
+            (void)memcpy(spec + used, conversion->width, conversion->width_length);
+            used += conversion->width_length;
+        }
+        if (conversion->precision_is_argument)
+        {
+            /*a negative '*' precision is taken as if the precision were omitted*/
+            if (precision >= 0)
+            {
+                used += (size_t)sprintf(spec + used, ".%d", (int)((precision > 999) ? 999 : precision));
+            }
+        }
+        else if (conversion->has_precision)
+        {
+            spec[used++] = '.';
+            (void)memcpy(spec + used, conversion->precision, conversion->precision_length);
+            used += conversion->precision_length;
+        }
+        (void)strcpy(spec + used, length);
+        used += strlen(length);
+        spec[used++] = specifier;
+        spec[used] = '\0';
+    }
+
+    return result;
+}
+
+/*formats one conversion with the value stored for it; false if the arguments do not match the format*/
+static bool render_conversion(MESSAGE* message, const CONVERSION* conversion, LOG_ARGUMENTS_READER* reader)
+{
+    bool result;
+    char spec[LOG_ARGUMENTS_CONVERSION_SIZE];
+    char* destination = message->text + message->length;
+    size_t room = message->size - message->length;
+
+    switch (conversion->specifier)
+    {
+    case '%':
+        append_text(message, "%", 1);
+        result = true;
+        break;
+    case 'd':
+    case 'i':
+    {
+        int64_t value;
+        result = build_conversion(spec, conversion, reader, "ll", conversion->specifier) && log_arguments_get_value(reader, LOG_ARGUMENT_SIGNED, &value);
+        if (result)
+        {
+            append_formatted(message, snprintf(destination, room, spec, (long long)value));
+        }
+        break;
+    }
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+    {
+        uint64_t value;
+        result = build_conversion(spec, conversion, reader, "ll", conversion->specifier) && log_arguments_get_value(reader, LOG_ARGUMENT_UNSIGNED, &value);
+        if (result)
+        {
+            append_formatted(message, snprintf(destination, room, spec, (unsigned long long)value));
+        }
+        break;
+    }
+    case 'c':
+    {
+        int64_t value;
+        result = build_conversion(spec, conversion, reader, "", 'c') && log_arguments_get_value(reader, LOG_ARGUMENT_SIGNED, &value);
+        if (result)
+        {
+            append_formatted(message, snprintf(destination, room, spec, (int)value));
+        }
+        break;
+    }
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+    {
+        double value;
+        result = build_conversion(spec, conversion, reader, "", conversion->specifier) && log_arguments_get_value(reader, LOG_ARGUMENT_DOUBLE, &value);
+        if (result)
+        {
+            append_formatted(message, snprintf(destination, room, spec, value));
+        }
+        break;
+    }
+    case 's':
+    {
+        const char* value = NULL;
+        size_t length = 0;
+        result = build_conversion(spec, conversion, reader, "", 's') && log_arguments_get_string(reader, &value, &length);
+        if (result)
+        {
+            /*the stored string is not terminated: print it through a precision*/
+            char bounded[LOG_ARGUMENTS_CONVERSION_SIZE + 8];
+            const char* dot = strchr(spec, '.');
+            if (dot == NULL)
+            {
+                (void)snprintf(bounded, sizeof(bounded), "%.*s.*s", (int)(strlen(spec) - 1), spec);
+                append_formatted(message, snprintf(destination, room, bounded, (int)length, value));
+            }
+            else
+            {
+                /*the smaller of the precision and the stored length*/
+                int precision = atoi(dot + 1);
+                (void)snprintf(bounded, sizeof(bounded), "%.*s.*s", (int)(dot - spec), spec);
+                append_formatted(message, snprintf(destination, room, bounded, ((size_t)precision < length) ? precision : (int)length, value));
+            }
+        }
+        break;
+    }
+    case 'p':
+    {
+        uint64_t value;
+        result = log_arguments_get_value(reader, LOG_ARGUMENT_POINTER, &value);
+        if (result)
+        {
+            append_formatted(message, snprintf(destination, room, "0x%llx", (unsigned long long)value));
+        }
+        break;
+    }
+    case 'n':
+        result = true;
+        break;
+    default:
+        result = false;
+        break;
+    }
+
+    return result;
+}
+
+bool log_arguments_format(char* message, size_t size, const char* format, const unsigned char* arguments, size_t arguments_size, bool truncated)
+{
+    MESSAGE rendered;
+    LOG_ARGUMENTS_READER reader;
+    const char* position = format;
+    bool matches = true;
+
+    rendered.text = message;
+    rendered.size = size;
+    rendered.length = 0;
+    rendered.cut = false;
+    rendered.text[0] = '\0';
+    reader.buffer = arguments;
+    reader.size = arguments_size;
+    reader.used = 0;
+
+    while (matches && (*position != '\0'))
+    {
+        const char* percent = strchr(position, '%');
+        if (percent == NULL)
+        {
+            append_text(&rendered, position, strlen(position));
+            position += strlen(position);
+        }
+        else
+        {
+            CONVERSION conversion;
+            append_text(&rendered, position, (size_t)(percent - position));
+            position = parse_conversion(percent + 1, &conversion);
+            matches = render_conversion(&rendered, &conversion, &reader);
+        }
+    }
+
+    if (!matches || truncated)
+    {
+        /*the arguments that were not stored, or do not match the format*/
+        append_text(&rendered, "...", 3);
+    }
+
+    return matches && !truncated && !rendered.cut;
+}
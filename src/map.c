@@ -2,11 +2,13 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <string.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/map.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/json_writer.h"
 
 DEFINE_ENUM_STRINGS(MAP_RESULT, MAP_RESULT_VALUES);
 
@@ -595,81 +597,62 @@ STRING_HANDLE Map_ToJSON(MAP_HANDLE handle)
     }
     else
     {
+        size_t i;
+        MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA *)handle;
+        /*"{}" and, for every entry, the key and value with their quotes, a colon and a comma; escapes grow the buffer as needed*/
+        size_t capacity = 3;
+        JSON_WRITER_HANDLE writer;
+
+        for (i = 0; i < handleData->count; i++)
+        {
+            capacity += strlen(handleData->keys[i]) + strlen(handleData->values[i]) + 6;
+        }
+
         /*Codes_SRS_MAP_02_048: [Map_ToJSON shall produce a STRING_HANDLE representing the content of the MAP.] */
-        result = STRING_construct("{");
-        if (result == NULL)
+        /*Codes_SRS_MAP_01_001: [ Map_ToJSON shall write the JSON with a single JSON writer created by json_writer_create, sized for the whole map, and hand its buffer over with json_writer_detach_STRING. ]*/
+        writer = json_writer_create(capacity);
+        if (writer == NULL)
         {
-            LogError("STRING_construct failed");
+            LogError("json_writer_create failed");
+            result = NULL;
         }
         else
         {
-            size_t i;
-            MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA *)handle;
             /*Codes_SRS_MAP_02_049: [If the MAP is empty, then Map_ToJSON shall produce the string "{}".*/
-            bool breakFor = false; /*used to break out of for*/
+            bool breakFor = (json_writer_begin_object(writer) != 0); /*used to break out of for*/
             for (i = 0; (i < handleData->count) && (!breakFor); i++)
             {
                 /*add one entry to the JSON*/
                 /*Codes_SRS_MAP_02_050: [If the map has properties then Map_ToJSON shall produce the following string:{"name1":"value1", "name2":"value2" ...}]*/
-                STRING_HANDLE key = STRING_new_JSON(handleData->keys[i]);
-                if (key == NULL)
+                /*Codes_SRS_MAP_01_002: [ Bytes from 0x80 up in keys and values shall be written as they are, so UTF-8 keys and values are kept in the JSON. ]*/
+                if ((json_writer_write_key(writer, handleData->keys[i]) != 0) ||
+                    (json_writer_write_string(writer, handleData->values[i]) != 0))
                 {
-                    LogError("STRING_new_JSON failed");
-                    STRING_delete(result);
-                    result = NULL;
                     breakFor = true;
                 }
-                else
-                {
-                    STRING_HANDLE value = STRING_new_JSON(handleData->values[i]);
-                    if (value == NULL)
-                    {
-                        LogError("STRING_new_JSON failed");
-                        STRING_delete(result);
-                        result = NULL;
-                        breakFor = true;
-                    }
-                    else
-                    {
-                        if (!(
-                            ((i>0) ? (STRING_concat(result, ",") == 0) : 1) &&
-                            (STRING_concat_with_STRING(result, key) == 0) &&
-                            (STRING_concat(result, ":") == 0) &&
-                            (STRING_concat_with_STRING(result, value) == 0)
-                            ))
-                        {
-                            LogError("failed to build the JSON");
-                            STRING_delete(result);
-                            result = NULL;
-                            breakFor = true;
-                        }
-                        else
-                        {
-                            /*all nice, go to the next element in the map*/
-                        }
-                        STRING_delete(value);
-                    }
-                    STRING_delete(key);
-                }
             }
 
+            /*Codes_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.]*/
             if (breakFor)
             {
                 LogError("error happened during JSON string builder");
+                result = NULL;
+            }
+            else if (json_writer_end_object(writer) != 0)
+            {
+                LogError("failed to build the JSON");
+                result = NULL;
+            }
+            else if ((result = json_writer_detach_STRING(writer)) == NULL)
+            {
+                LogError("json_writer_detach_STRING failed");
             }
             else
             {
-                if (STRING_concat(result, "}") != 0)
-                {
-                    LogError("failed to build the JSON");
-                    STRING_delete(result);
-                    result = NULL;
-                }
-                else
-                {
-                    /*return as is, JSON has been build*/
-                }
+                /*return as is, JSON has been build*/
             }
+
+            json_writer_destroy(writer);
         }
     }
     return result;
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/mpsc_queue.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+/*
+ * The nodes form a singly linked list from the front (oldest) to the back (newest). A
+ * producer swaps itself in as the new back with one atomic exchange and then links the
+ * previous back to itself; between the two steps the list is briefly cut, which the
+ * consumer sees as an empty queue. A stub node that lives in the queue keeps the list from
+ * ever being empty, so the consumer never has to touch the back unless it pops the last
+ * node.
+ */
+#define MPSC_QUEUE_CACHE_LINE_SIZE  64
+
+typedef struct MPSC_QUEUE_TAG
+{
+    /*written by the producers*/
+    QUEUE_ATOMIC_TYPE(MPSC_QUEUE_NODE*) back;
+    unsigned char producer_pad[MPSC_QUEUE_CACHE_LINE_SIZE];
+
+    /*written by the consumer*/
+    MPSC_QUEUE_NODE* front;
+    MPSC_QUEUE_NODE stub;
+} MPSC_QUEUE;
+
+static void push_node(MPSC_QUEUE* queue, MPSC_QUEUE_NODE* node)
+{
+    MPSC_QUEUE_NODE* previous;
+
+    QUEUE_ATOMIC_STORE(MPSC_QUEUE_NODE*, node->next, NULL);
+    QUEUE_ATOMIC_EXCHANGE(MPSC_QUEUE_NODE*, queue->back, node, previous);
+    QUEUE_ATOMIC_STORE(MPSC_QUEUE_NODE*, previous->next, node);
+}
+
+MPSC_QUEUE_HANDLE mpsc_queue_create(void)
+{
+    MPSC_QUEUE* result;
+
+    /* Codes_SRS_MPSC_QUEUE_01_001: [ mpsc_queue_create shall allocate an empty queue and return it. ]*/
+    result = (MPSC_QUEUE*)malloc(sizeof(MPSC_QUEUE));
+    if (result == NULL)
+    {
+        /* Codes_SRS_MPSC_QUEUE_01_002: [ If allocating fails, mpsc_queue_create shall return NULL. ]*/
+        LogError("Cannot allocate the queue");
+    }
+    else
+    {
+        QUEUE_ATOMIC_INIT(MPSC_QUEUE_NODE*, result->stub.next, NULL);
+        QUEUE_ATOMIC_INIT(MPSC_QUEUE_NODE*, result->back, &result->stub);
+        result->front = &result->stub;
+    }
+
+    return result;
+}
+
+void mpsc_queue_destroy(MPSC_QUEUE_HANDLE queue)
+{
+    if (queue == NULL)
+    {
+        /* Codes_SRS_MPSC_QUEUE_01_003: [ If queue is NULL, mpsc_queue_destroy shall return. ]*/
+        LogError("Invalid argument: queue is NULL");
+    }
+    else
+    {
+        /* Codes_SRS_MPSC_QUEUE_01_004: [ mpsc_queue_destroy shall free the queue without touching the nodes left in it. ]*/
+        free(queue);
+    }
+}
+
+int mpsc_queue_push(MPSC_QUEUE_HANDLE queue, MPSC_QUEUE_NODE* node)
+{
+    int result;
+
+    if ((queue == NULL) || (node == NULL))
+    {
+        /* Codes_SRS_MPSC_QUEUE_01_005: [ If queue or node is NULL, mpsc_queue_push shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: queue=%p, node=%p", queue, node);
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_MPSC_QUEUE_01_006: [ mpsc_queue_push shall make node the back of the queue with an atomic exchange, link the previous back to it, and return 0. ]*/
+        push_node(queue, node);
+        result = 0;
+    }
+
+    return result;
+}
+
+MPSC_QUEUE_NODE* mpsc_queue_pop(MPSC_QUEUE_HANDLE queue)
+{
+    MPSC_QUEUE_NODE* result;
+
+    if (queue == NULL)
+    {
+        /* Codes_SRS_MPSC_QUEUE_01_007: [ If queue is NULL, mpsc_queue_pop shall return NULL. ]*/
+        LogError("Invalid argument: queue is NULL");
+        result = NULL;
+    }
+    else
+    {
+        MPSC_QUEUE_NODE* front = queue->front;
+        MPSC_QUEUE_NODE* next = QUEUE_ATOMIC_LOAD(MPSC_QUEUE_NODE*, front->next);
+
+        /*the stub is skipped: it is never returned*/
+        if (front == &queue->stub)
+        {
+            if (next != NULL)
+            {
+                queue->front = next;
+                front = next;
+                next = QUEUE_ATOMIC_LOAD(MPSC_QUEUE_NODE*, front->next);
+            }
+        }
+
+        if (front == &queue->stub)
+        {
+            /* Codes_SRS_MPSC_QUEUE_01_008: [ If the queue is empty, mpsc_queue_pop shall return NULL. ]*/
+            result = NULL;
+        }
+        else if (next != NULL)
+        {
+            /* Codes_SRS_MPSC_QUEUE_01_009: [ mpsc_queue_pop shall take the oldest node out of the queue and return it. ]*/
+            queue->front = next;
+            result = front;
+        }
+        else if (front != QUEUE_ATOMIC_LOAD(MPSC_QUEUE_NODE*, queue->back))
+        {
+            /* Codes_SRS_MPSC_QUEUE_01_010: [ If a producer has swapped in a new back but not linked it yet, mpsc_queue_pop shall return NULL. ]*/
+            result = NULL;
+        }
+        else
+        {
+            /*front is the last node: put the stub behind it so that it can be unlinked*/
+            push_node(queue, &queue->stub);
+            next = QUEUE_ATOMIC_LOAD(MPSC_QUEUE_NODE*, front->next);
+            if (next != NULL)
+            {
+                queue->front = next;
+                result = front;
+            }
+            else
+            {
+                result = NULL;
+            }
+        }
+    }
+
+    return result;
+}
@@ -15,6 +15,16 @@
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 
+#define SAS_TOKEN_PREFIX "SharedAccessSignature sr="
+#define SAS_TOKEN_SIGNATURE_FIELD "&sig="
+#define SAS_TOKEN_EXPIRY_FIELD "&se="
+#define SAS_TOKEN_KEY_NAME_FIELD "&skn="
+#define SAS_TOKEN_LITERAL_LENGTH(literal) (sizeof(literal) - 1)
+
+/* base64 of the 32 byte hash is 44 characters, each of which URL encodes to at most 3 */
+#define SAS_TOKEN_BASE64_SIGNATURE_LENGTH 44
+#define SAS_TOKEN_MAX_SIGNATURE_LENGTH (3 * SAS_TOKEN_BASE64_SIGNATURE_LENGTH)
+
 static double getExpiryValue(const char* expiryASCII)
 {
     double value = 0;
@@ -344,3 +354,88 @@ STRING_HANDLE SASToken_CreateString(const char* key, const char* scope, const ch
     }
     return result;
 }
+
+char* SASToken_Build(HMACSHA256_KEY_HANDLE key, const char* scope, const char* keyName, size_t expiry)
+{
+    char* result;
+    char tokenExpirationTime[32] = { 0 };
+
+    /*Codes_SRS_SASTOKEN_01_001: [ If key or scope is NULL, SASToken_Build shall fail and return NULL. ]*/
+    if ((key == NULL) ||
+        (scope == NULL))
+    {
+        LogError("Invalid Parameter to SASToken_Build. key: %p, scope: %p", key, scope);
+        result = NULL;
+    }
+    /*Codes_SRS_SASTOKEN_01_002: [ SASToken_Build shall convert expiry to a string by calling size_tToString. ]*/
+    else if (size_tToString(tokenExpirationTime, sizeof(tokenExpirationTime), expiry) != 0)
+    {
+        /*Codes_SRS_SASTOKEN_01_003: [ If size_tToString fails, SASToken_Build shall fail and return NULL. ]*/
+        LogError("Converting the expiry to a string failed.  No SAS can be generated.");
+        result = NULL;
+    }
+    else
+    {
+        size_t scopeLength = strlen(scope);
+        size_t expiryLength = strlen(tokenExpirationTime);
+        size_t keyNameLength = (keyName == NULL) ? 0 : strlen(keyName);
+        size_t maxTokenLength = SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_PREFIX) + scopeLength +
+            SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_SIGNATURE_FIELD) + SAS_TOKEN_MAX_SIGNATURE_LENGTH +
+            SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_EXPIRY_FIELD) + expiryLength +
+            ((keyName == NULL) ? 0 : (SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_KEY_NAME_FIELD) + keyNameLength));
+
+        /*Codes_SRS_SASTOKEN_01_004: [ SASToken_Build shall allocate a single buffer large enough for the token with the longest possible signature. ]*/
+        if ((result = (char*)malloc(maxTokenLength + 1)) == NULL)
+        {
+            /*Codes_SRS_SASTOKEN_01_005: [ If allocating the buffer fails, SASToken_Build shall fail and return NULL. ]*/
+            LogError("Unable to allocate memory for the SAS token.");
+        }
+        else
+        {
+            unsigned char hash[HMACSHA256_HASH_SIZE];
+            char base64Signature[SAS_TOKEN_BASE64_SIGNATURE_LENGTH + 1] = { 0 };
+            size_t signatureLength;
+            size_t position = SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_PREFIX);
+
+            (void)memcpy(result, SAS_TOKEN_PREFIX, position);
+            (void)memcpy(result + position, scope, scopeLength);
+            position += scopeLength;
+
+            /* "<scope>\n<expiry>" is laid out right after the prefix, in the space the signature fields overwrite afterwards */
+            result[position] = '\n';
+            (void)memcpy(result + position + 1, tokenExpirationTime, expiryLength);
+
+            /*Codes_SRS_SASTOKEN_01_006: [ SASToken_Build shall compute the HMAC-SHA256 of scope, "\n" and the expiry string by calling HMACSHA256_ComputeHashWithKeyInto. ]*/
+            /*Codes_SRS_SASTOKEN_01_007: [ The hash shall be base64 encoded by calling Base64_Encode_Into and the result URL encoded in place in the token by calling URL_EncodeInto. ]*/
+            if ((HMACSHA256_ComputeHashWithKeyInto(key, (const unsigned char*)(result + SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_PREFIX)), scopeLength + 1 + expiryLength, hash) != HMACSHA256_OK) ||
+                (Base64_Encode_Into(hash, sizeof(hash), base64Signature, sizeof(base64Signature)) != 0) ||
+                (URL_EncodeInto(base64Signature, SAS_TOKEN_BASE64_SIGNATURE_LENGTH, result + position + SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_SIGNATURE_FIELD), SAS_TOKEN_MAX_SIGNATURE_LENGTH + 1, &signatureLength) != 0))
+            {
+                /*Codes_SRS_SASTOKEN_01_008: [ If computing, encoding or URL encoding the signature fails, SASToken_Build shall free the buffer and return NULL. ]*/
+                LogError("Unable to compute the SAS token signature.");
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_SASTOKEN_01_009: [ The token shall be "SharedAccessSignature sr=<scope>&sig=<signature>&se=<expiry>", followed by "&skn=<keyName>" when keyName is not NULL. ]*/
+                (void)memcpy(result + position, SAS_TOKEN_SIGNATURE_FIELD, SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_SIGNATURE_FIELD));
+                position += SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_SIGNATURE_FIELD) + signatureLength;
+                (void)memcpy(result + position, SAS_TOKEN_EXPIRY_FIELD, SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_EXPIRY_FIELD));
+                position += SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_EXPIRY_FIELD);
+                (void)memcpy(result + position, tokenExpirationTime, expiryLength);
+                position += expiryLength;
+                if (keyName != NULL)
+                {
+                    (void)memcpy(result + position, SAS_TOKEN_KEY_NAME_FIELD, SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_KEY_NAME_FIELD));
+                    position += SAS_TOKEN_LITERAL_LENGTH(SAS_TOKEN_KEY_NAME_FIELD);
+                    (void)memcpy(result + position, keyName, keyNameLength);
+                    position += keyNameLength;
+                }
+                result[position] = '\0';
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,355 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <string.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/sastoken_cache.h"
+#include "azure_c_shared_utility/sastoken.h"
+#include "azure_c_shared_utility/hmacsha256.h"
+#include "azure_c_shared_utility/base64.h"
+#include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/agenttime.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/crt_abstractions.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+typedef struct SASTOKEN_CACHE_ENTRY_TAG
+{
+    char* key;
+    char* scope;
+    char* keyName;
+    HMACSHA256_KEY_HANDLE hmacKey;
+    char* token;
+    /* seconds since the epoch */
+    double renewalTime;
+    double expiryTime;
+    /* value of the cache's use counter when the entry was last requested */
+    unsigned long long lastUse;
+} SASTOKEN_CACHE_ENTRY;
+
+typedef struct SASTOKEN_CACHE_TAG
+{
+    size_t tokenLifetime;
+    double renewalDelay;
+    size_t maxEntries;
+    size_t entryCount;
+    unsigned long long useCount;
+    LOCK_HANDLE lock;
+    SINGLYLINKEDLIST_HANDLE entries;
+} SASTOKEN_CACHE;
+
+typedef struct SASTOKEN_CACHE_LOOKUP_TAG
+{
+    const char* key;
+    const char* scope;
+    const char* keyName;
+} SASTOKEN_CACHE_LOOKUP;
+
+static bool findEntry(LIST_ITEM_HANDLE list_item, const void* match_context)
+{
+    const SASTOKEN_CACHE_ENTRY* entry = (const SASTOKEN_CACHE_ENTRY*)singlylinkedlist_item_get_value(list_item);
+    const SASTOKEN_CACHE_LOOKUP* lookup = (const SASTOKEN_CACHE_LOOKUP*)match_context;
+
+    return (strcmp(entry->key, lookup->key) == 0) &&
+        (strcmp(entry->scope, lookup->scope) == 0) &&
+        (((entry->keyName == NULL) && (lookup->keyName == NULL)) ||
+         ((entry->keyName != NULL) && (lookup->keyName != NULL) && (strcmp(entry->keyName, lookup->keyName) == 0)));
+}
+
+static void destroyEntry(SASTOKEN_CACHE_ENTRY* entry)
+{
+    if (entry->hmacKey != NULL)
+    {
+        HMACSHA256_DestroyKey(entry->hmacKey);
+    }
+    free(entry->key);
+    free(entry->scope);
+    free(entry->keyName);
+    free(entry->token);
+    free(entry);
+}
+
+static SASTOKEN_CACHE_ENTRY* createEntry(const char* key, const char* scope, const char* keyName)
+{
+    SASTOKEN_CACHE_ENTRY* result;
+
+    if ((result = (SASTOKEN_CACHE_ENTRY*)malloc(sizeof(SASTOKEN_CACHE_ENTRY))) == NULL)
+    {
+        LogError("Unable to allocate a SAS token cache entry.");
+    }
+    else
+    {
+        BUFFER_HANDLE decodedKey;
+
+        (void)memset(result, 0, sizeof(SASTOKEN_CACHE_ENTRY));
+
+        if ((mallocAndStrcpy_s(&result->key, key) != 0) ||
+            (mallocAndStrcpy_s(&result->scope, scope) != 0) ||
+            ((keyName != NULL) && (mallocAndStrcpy_s(&result->keyName, keyName) != 0)))
+        {
+            LogError("Unable to copy the SAS token parameters.");
+            destroyEntry(result);
+            result = NULL;
+        }
+        /*Codes_SRS_SASTOKEN_CACHE_01_012: [ The key shall be decoded from base64 by calling Base64_Decoder and prepared once for signing by calling HMACSHA256_CreateKey. ]*/
+        else if ((decodedKey = Base64_Decoder(key)) == NULL)
+        {
+            LogError("Unable to decode the key for generating the SAS.");
+            destroyEntry(result);
+            result = NULL;
+        }
+        else
+        {
+            const unsigned char* decodedKeyBytes = BUFFER_u_char(decodedKey);
+            size_t decodedKeyLength = BUFFER_length(decodedKey);
+
+            if ((result->hmacKey = HMACSHA256_CreateKey(decodedKeyBytes, decodedKeyLength)) == NULL)
+            {
+                LogError("Unable to prepare the key for generating the SAS.");
+                destroyEntry(result);
+                result = NULL;
+            }
+
+            BUFFER_delete(decodedKey);
+        }
+    }
+
+    return result;
+}
+
+/* makes room for one more entry by dropping the expired entries, or the least recently used one if none has expired */
+static void evictEntries(SASTOKEN_CACHE* cache, double now)
+{
+    LIST_ITEM_HANDLE item = singlylinkedlist_get_head_item(cache->entries);
+    LIST_ITEM_HANDLE leastRecentlyUsedItem = NULL;
+    unsigned long long leastRecentUse = 0;
+
+    while (item != NULL)
+    {
+        LIST_ITEM_HANDLE nextItem = singlylinkedlist_get_next_item(item);
+        SASTOKEN_CACHE_ENTRY* entry = (SASTOKEN_CACHE_ENTRY*)singlylinkedlist_item_get_value(item);
+
+        /*Codes_SRS_SASTOKEN_CACHE_01_019: [ If there is no entry and the cache already holds maxEntries entries, SASTokenCache_GetToken shall remove and free every entry that has no unexpired token. ]*/
+        if (now >= entry->expiryTime)
+        {
+            if (singlylinkedlist_remove(cache->entries, item) != 0)
+            {
+                LogError("Unable to remove an expired SAS token cache entry.");
+            }
+            else
+            {
+                destroyEntry(entry);
+                cache->entryCount--;
+            }
+        }
+        else if ((leastRecentlyUsedItem == NULL) || (entry->lastUse < leastRecentUse))
+        {
+            leastRecentlyUsedItem = item;
+            leastRecentUse = entry->lastUse;
+        }
+
+        item = nextItem;
+    }
+
+    /*Codes_SRS_SASTOKEN_CACHE_01_020: [ If the cache is still full, SASTokenCache_GetToken shall remove and free the least recently requested entry. ]*/
+    if ((cache->entryCount >= cache->maxEntries) && (leastRecentlyUsedItem != NULL))
+    {
+        SASTOKEN_CACHE_ENTRY* entry = (SASTOKEN_CACHE_ENTRY*)singlylinkedlist_item_get_value(leastRecentlyUsedItem);
+        if (singlylinkedlist_remove(cache->entries, leastRecentlyUsedItem) != 0)
+        {
+            LogError("Unable to remove the least recently used SAS token cache entry.");
+        }
+        else
+        {
+            destroyEntry(entry);
+            cache->entryCount--;
+        }
+    }
+}
+
+SASTOKEN_CACHE_HANDLE SASTokenCache_Create(size_t tokenLifetime, unsigned int renewalPercentage, size_t maxEntries)
+{
+    SASTOKEN_CACHE* result;
+
+    /*Codes_SRS_SASTOKEN_CACHE_01_001: [ If tokenLifetime is 0, renewalPercentage is 0 or greater than 100, or maxEntries is 0, SASTokenCache_Create shall fail and return NULL. ]*/
+    if ((tokenLifetime == 0) ||
+        (renewalPercentage == 0) ||
+        (renewalPercentage > 100) ||
+        (maxEntries == 0))
+    {
+        LogError("Invalid arguments: tokenLifetime = %lu, renewalPercentage = %u, maxEntries = %lu", (unsigned long)tokenLifetime, renewalPercentage, (unsigned long)maxEntries);
+        result = NULL;
+    }
+    /*Codes_SRS_SASTOKEN_CACHE_01_002: [ SASTokenCache_Create shall allocate the cache, a lock by calling Lock_Init and an empty list of entries by calling singlylinkedlist_create. ]*/
+    else if ((result = (SASTOKEN_CACHE*)malloc(sizeof(SASTOKEN_CACHE))) == NULL)
+    {
+        /*Codes_SRS_SASTOKEN_CACHE_01_003: [ If any of these fail, SASTokenCache_Create shall free what it allocated and return NULL. ]*/
+        LogError("Unable to allocate the SAS token cache.");
+    }
+    else if ((result->lock = Lock_Init()) == NULL)
+    {
+        /*Codes_SRS_SASTOKEN_CACHE_01_003: [ If any of these fail, SASTokenCache_Create shall free what it allocated and return NULL. ]*/
+        LogError("Unable to create the SAS token cache lock.");
+        free(result);
+        result = NULL;
+    }
+    else if ((result->entries = singlylinkedlist_create()) == NULL)
+    {
+        /*Codes_SRS_SASTOKEN_CACHE_01_003: [ If any of these fail, SASTokenCache_Create shall free what it allocated and return NULL. ]*/
+        LogError("Unable to create the SAS token cache list.");
+        (void)Lock_Deinit(result->lock);
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        result->tokenLifetime = tokenLifetime;
+        result->renewalDelay = (double)tokenLifetime * renewalPercentage / 100;
+        result->maxEntries = maxEntries;
+        result->entryCount = 0;
+        result->useCount = 0;
+    }
+
+    return result;
+}
+
+void SASTokenCache_Destroy(SASTOKEN_CACHE_HANDLE cache)
+{
+    /*Codes_SRS_SASTOKEN_CACHE_01_004: [ If cache is NULL, SASTokenCache_Destroy shall return. ]*/
+    if (cache == NULL)
+    {
+        LogError("NULL cache");
+    }
+    else
+    {
+        LIST_ITEM_HANDLE item;
+
+        /*Codes_SRS_SASTOKEN_CACHE_01_005: [ SASTokenCache_Destroy shall free every entry with its prepared key and token, the list, the lock and the cache. ]*/
+        while ((item = singlylinkedlist_get_head_item(cache->entries)) != NULL)
+        {
+            SASTOKEN_CACHE_ENTRY* entry = (SASTOKEN_CACHE_ENTRY*)singlylinkedlist_item_get_value(item);
+            (void)singlylinkedlist_remove(cache->entries, item);
+            destroyEntry(entry);
+        }
+
+        singlylinkedlist_destroy(cache->entries);
+        (void)Lock_Deinit(cache->lock);
+        free(cache);
+    }
+}
+
+STRING_HANDLE SASTokenCache_GetToken(SASTOKEN_CACHE_HANDLE cache, const char* key, const char* scope, const char* keyName)
+{
+    STRING_HANDLE result;
+    time_t currentTime;
+
+    /*Codes_SRS_SASTOKEN_CACHE_01_006: [ If cache, key or scope is NULL, SASTokenCache_GetToken shall fail and return NULL. keyName is optional. ]*/
+    if ((cache == NULL) ||
+        (key == NULL) ||
+        (scope == NULL))
+    {
+        LogError("Invalid arguments: cache = %p, key = %p, scope = %p", cache, key, scope);
+        result = NULL;
+    }
+    /*Codes_SRS_SASTOKEN_CACHE_01_007: [ SASTokenCache_GetToken shall obtain the current time by calling get_time. ]*/
+    else if ((currentTime = get_time(NULL)) == (time_t)-1)
+    {
+        /*Codes_SRS_SASTOKEN_CACHE_01_008: [ If get_time fails, SASTokenCache_GetToken shall fail and return NULL. ]*/
+        LogError("Time does not appear to be working.");
+        result = NULL;
+    }
+    /*Codes_SRS_SASTOKEN_CACHE_01_009: [ The lookup, any renewal and the copy of the token shall be done while holding the cache lock. ]*/
+    else if (Lock(cache->lock) != LOCK_OK)
+    {
+        LogError("Unable to lock the SAS token cache.");
+        result = NULL;
+    }
+    else
+    {
+        SASTOKEN_CACHE_LOOKUP lookup;
+        LIST_ITEM_HANDLE item;
+        SASTOKEN_CACHE_ENTRY* entry;
+        double now = get_difftime(currentTime, (time_t)0);
+
+        lookup.key = key;
+        lookup.scope = scope;
+        lookup.keyName = keyName;
+
+        /*Codes_SRS_SASTOKEN_CACHE_01_010: [ SASTokenCache_GetToken shall look up the entry for (key, scope, keyName) by calling singlylinkedlist_find. ]*/
+        if ((item = singlylinkedlist_find(cache->entries, findEntry, &lookup)) != NULL)
+        {
+            entry = (SASTOKEN_CACHE_ENTRY*)singlylinkedlist_item_get_value(item);
+        }
+        else
+        {
+            if (cache->entryCount >= cache->maxEntries)
+            {
+                evictEntries(cache, now);
+            }
+
+            /*Codes_SRS_SASTOKEN_CACHE_01_011: [ If there is no entry, SASTokenCache_GetToken shall create one and add it to the list by calling singlylinkedlist_add. ]*/
+            if ((entry = createEntry(key, scope, keyName)) == NULL)
+            {
+                /*Codes_SRS_SASTOKEN_CACHE_01_013: [ If creating or adding the entry fails, SASTokenCache_GetToken shall fail and return NULL. ]*/
+                LogError("Unable to create a SAS token cache entry.");
+            }
+            else if (singlylinkedlist_add(cache->entries, entry) == NULL)
+            {
+                /*Codes_SRS_SASTOKEN_CACHE_01_013: [ If creating or adding the entry fails, SASTokenCache_GetToken shall fail and return NULL. ]*/
+                LogError("Unable to add a SAS token cache entry.");
+                destroyEntry(entry);
+                entry = NULL;
+            }
+            else
+            {
+                cache->entryCount++;
+            }
+        }
+
+        if (entry == NULL)
+        {
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_SASTOKEN_CACHE_01_018: [ SASTokenCache_GetToken shall record that the entry was requested, for choosing which entry to evict when the cache is full. ]*/
+            entry->lastUse = ++cache->useCount;
+
+            /*Codes_SRS_SASTOKEN_CACHE_01_014: [ If the entry has no token or the renewal point of its token has passed, SASTokenCache_GetToken shall build a new token expiring tokenLifetime seconds from now by calling SASToken_Build. ]*/
+            if ((entry->token == NULL) || (now >= entry->renewalTime))
+            {
+                char* newToken = SASToken_Build(entry->hmacKey, entry->scope, entry->keyName, (size_t)(now + cache->tokenLifetime));
+                if (newToken == NULL)
+                {
+                    /*Codes_SRS_SASTOKEN_CACHE_01_015: [ If SASToken_Build fails, SASTokenCache_GetToken shall keep returning the previous token until it expires. ]*/
+                    LogError("Unable to renew the SAS token.");
+                }
+                else
+                {
+                    free(entry->token);
+                    entry->token = newToken;
+                    entry->renewalTime = now + cache->renewalDelay;
+                    entry->expiryTime = now + cache->tokenLifetime;
+                }
+            }
+
+            if ((entry->token == NULL) || (now >= entry->expiryTime))
+            {
+                /*Codes_SRS_SASTOKEN_CACHE_01_016: [ If there is no unexpired token, SASTokenCache_GetToken shall fail and return NULL. ]*/
+                result = NULL;
+            }
+            /*Codes_SRS_SASTOKEN_CACHE_01_017: [ SASTokenCache_GetToken shall return a copy of the token created by calling STRING_construct. ]*/
+            else if ((result = STRING_construct(entry->token)) == NULL)
+            {
+                LogError("Unable to copy the SAS token.");
+            }
+        }
+
+        (void)Unlock(cache->lock);
+    }
+
+    return result;
+}
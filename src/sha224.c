@@ -40,10 +40,36 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 #include "azure_c_shared_utility/gballoc.h"
 
 #include "azure_c_shared_utility/sha.h"
 #include "azure_c_shared_utility/sha-private.h"
+
+/*
+* Hardware backends. The block function is picked the first time a
+* block is processed: the SHA extensions on x86 when CPUID reports
+* them, the ARMv8 SHA2 instructions when USE_SHA_ARMV8_ACCELERATION
+* is defined and the compiler targets them, the reference C code
+* otherwise. Define NO_SHA_HW_ACCELERATION to always use the
+* reference code. The ARMv8 code is opt-in until it has been built
+* and checked on an aarch64 target.
+*/
+#if !defined(NO_SHA_HW_ACCELERATION) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+#define SHA256_USE_X86_SHA_NI
+#include <cpuid.h>
+#include <immintrin.h>
+#elif !defined(NO_SHA_HW_ACCELERATION) && defined(USE_SHA_ARMV8_ACCELERATION) && defined(__aarch64__) && \
+    (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define SHA256_USE_ARMV8_SHA2
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
 /* Define the SHA shift, rotate left and rotate right macro */
 #define SHA256_SHR(bits,word)      ((word) >> (bits))
 #define SHA256_ROTL(bits,word)                         \
@@ -69,6 +95,16 @@
     (((context)->Length_Low += (length)) < addTemp) &&     \
     (++(context)->Length_High == 0) ? 1 : 0)
 
+/*
+* Largest run of whole blocks hashed at once from the caller's
+* buffer, small enough for its length in bits to fit in 32 bits
+*/
+#define SHA256_MAX_BLOCKS_PER_CALL (1u << 20)
+
+/* Updates the intermediate hash with consecutive 512 bit blocks */
+typedef void(*SHA224_256_BLOCKS_FUNCTION)(uint32_t *Intermediate_Hash,
+    const uint8_t *block, unsigned int blocks);
+
 /* Local Function Prototypes */
 static void SHA224_256Finalize(SHA256Context *context,
     uint8_t Pad_Byte);
@@ -80,6 +116,242 @@ static int SHA224_256ResultN(SHA256Context *context,
     uint8_t Message_Digest[], int HashSize);
 
 /* Initial Hash Values: FIPS-180-2 Change Notice 1 */
+/* Constants defined in FIPS-180-2, section 4.2.2 */
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b,
+    0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01,
+    0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7,
+    0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152,
+    0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819,
+    0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08,
+    0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f,
+    0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/*
+* SHA224_256ReferenceBlocks
+*
+* Description:
+*   Portable implementation of the block function: updates the
+*   intermediate hash with "blocks" consecutive 512 bit blocks.
+*
+* Comments:
+*   Many of the variable names in this code, especially the
+*   single character names, were used because those were the
+*   names used in the publication.
+*/
+static void SHA224_256ReferenceBlocks(uint32_t *Intermediate_Hash,
+    const uint8_t *block, unsigned int blocks)
+{
+    int        t, t4;                   /* Loop counter */
+    uint32_t   temp1, temp2;            /* Temporary word value */
+    uint32_t   W[64];                   /* Word sequence */
+    uint32_t   A, B, C, D, E, F, G, H;  /* Word buffers */
+
+    for (; blocks > 0; blocks--, block += SHA256_Message_Block_Size) {
+        for (t = t4 = 0; t < 16; t++, t4 += 4)
+            W[t] = (((uint32_t)block[t4]) << 24) |
+            (((uint32_t)block[t4 + 1]) << 16) |
+            (((uint32_t)block[t4 + 2]) << 8) |
+            (((uint32_t)block[t4 + 3]));
+
+        for (t = 16; t < 64; t++)
+            W[t] = SHA256_sigma1(W[t - 2]) + W[t - 7] +
+            SHA256_sigma0(W[t - 15]) + W[t - 16];
+
+        A = Intermediate_Hash[0];
+        B = Intermediate_Hash[1];
+        C = Intermediate_Hash[2];
+        D = Intermediate_Hash[3];
+        E = Intermediate_Hash[4];
+        F = Intermediate_Hash[5];
+        G = Intermediate_Hash[6];
+        H = Intermediate_Hash[7];
+
+        for (t = 0; t < 64; t++) {
+            temp1 = H + SHA256_SIGMA1(E) + SHA_Ch(E, F, G) + SHA256_K[t] + W[t];
+            temp2 = SHA256_SIGMA0(A) + SHA_Maj(A, B, C);
+            H = G;
+            G = F;
+            F = E;
+            E = D + temp1;
+            D = C;
+            C = B;
+            B = A;
+            A = temp1 + temp2;
+        }
+
+        Intermediate_Hash[0] += A;
+        Intermediate_Hash[1] += B;
+        Intermediate_Hash[2] += C;
+        Intermediate_Hash[3] += D;
+        Intermediate_Hash[4] += E;
+        Intermediate_Hash[5] += F;
+        Intermediate_Hash[6] += G;
+        Intermediate_Hash[7] += H;
+    }
+}
+
+#if defined(SHA256_USE_X86_SHA_NI)
+/*
+* SHA224_256ShaNiBlocks
+*
+* Description:
+*   Block function using the x86 SHA extensions. The state is kept
+*   as the ABEF/CDGH register pairs sha256rnds2 works on, and every
+*   iteration of the round loop does 4 rounds and extends the
+*   message schedule by 4 words.
+*/
+__attribute__((target("sha,sse4.1")))
+static void SHA224_256ShaNiBlocks(uint32_t *Intermediate_Hash,
+    const uint8_t *block, unsigned int blocks)
+{
+    const __m128i BYTE_SWAP = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i state0, state1, tmp, abef_save, cdgh_save;
+    __m128i msg[4];
+    int i;
+
+    tmp = _mm_loadu_si128((const __m128i*)&Intermediate_Hash[0]);
+    state1 = _mm_loadu_si128((const __m128i*)&Intermediate_Hash[4]);
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);             /* CDAB */
+    state1 = _mm_shuffle_epi32(state1, 0x1B);       /* EFGH */
+    state0 = _mm_alignr_epi8(tmp, state1, 8);       /* ABEF */
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);    /* CDGH */
+
+    for (; blocks > 0; blocks--, block += SHA256_Message_Block_Size) {
+        abef_save = state0;
+        cdgh_save = state1;
+
+        for (i = 0; i < 16; i++) {
+            __m128i wk;
+            if (i < 4) {
+                msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(block + (i * 16))), BYTE_SWAP);
+            } else {
+                /* W[t-16] + sigma0(W[t-15]) + W[t-7], then + sigma1(W[t-2]) */
+                tmp = _mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]);
+                tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4));
+                msg[i & 3] = _mm_sha256msg2_epu32(tmp, msg[(i + 3) & 3]);
+            }
+
+            wk = _mm_add_epi32(msg[i & 3], _mm_loadu_si128((const __m128i*)&SHA256_K[i * 4]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+            wk = _mm_shuffle_epi32(wk, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);          /* FEBA */
+    state1 = _mm_shuffle_epi32(state1, 0xB1);       /* DCHG */
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);    /* DCBA */
+    state1 = _mm_alignr_epi8(state1, tmp, 8);       /* HGFE */
+
+    _mm_storeu_si128((__m128i*)&Intermediate_Hash[0], state0);
+    _mm_storeu_si128((__m128i*)&Intermediate_Hash[4], state1);
+}
+
+static int SHA224_256HasShaNi(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    int result = 0;
+
+    /* SSSE3 and SSE4.1 in leaf 1, SHA in leaf 7 */
+    if ((__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) &&
+        ((ecx & (1u << 9)) != 0) && ((ecx & (1u << 19)) != 0) &&
+        (__get_cpuid_max(0, NULL) >= 7)) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        result = ((ebx & (1u << 29)) != 0);
+    }
+
+    return result;
+}
+#endif /* SHA256_USE_X86_SHA_NI */
+
+#if defined(SHA256_USE_ARMV8_SHA2)
+/*
+* SHA224_256Armv8Blocks
+*
+* Description:
+*   Block function using the ARMv8 SHA2 instructions; every
+*   iteration of the round loop does 4 rounds and extends the
+*   message schedule by 4 words.
+*/
+static void SHA224_256Armv8Blocks(uint32_t *Intermediate_Hash,
+    const uint8_t *block, unsigned int blocks)
+{
+    uint32x4_t abcd = vld1q_u32(&Intermediate_Hash[0]);
+    uint32x4_t efgh = vld1q_u32(&Intermediate_Hash[4]);
+    uint32x4_t msg[4];
+    int i;
+
+    for (; blocks > 0; blocks--, block += SHA256_Message_Block_Size) {
+        uint32x4_t abcd_save = abcd;
+        uint32x4_t efgh_save = efgh;
+
+        for (i = 0; i < 4; i++)
+            msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(block + (i * 16))));
+
+        for (i = 0; i < 16; i++) {
+            uint32x4_t wk = vaddq_u32(msg[i & 3], vld1q_u32(&SHA256_K[i * 4]));
+            uint32x4_t abcd_prev = abcd;
+            abcd = vsha256hq_u32(abcd, efgh, wk);
+            efgh = vsha256h2q_u32(efgh, abcd_prev, wk);
+            if (i < 12)
+                msg[i & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[i & 3], msg[(i + 1) & 3]), msg[(i + 2) & 3], msg[(i + 3) & 3]);
+        }
+
+        abcd = vaddq_u32(abcd, abcd_save);
+        efgh = vaddq_u32(efgh, efgh_save);
+    }
+
+    vst1q_u32(&Intermediate_Hash[0], abcd);
+    vst1q_u32(&Intermediate_Hash[4], efgh);
+}
+
+static int SHA224_256HasArmv8Sha2(void)
+{
+#if defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#else
+    /* the compiler was told the target has the SHA2 instructions */
+    return 1;
+#endif
+}
+#endif /* SHA256_USE_ARMV8_SHA2 */
+
+static void SHA224_256SelectBlocks(uint32_t *Intermediate_Hash,
+    const uint8_t *block, unsigned int blocks);
+
+/*
+* The selection is idempotent, so threads racing on the first call
+* all store the same function.
+*/
+static SHA224_256_BLOCKS_FUNCTION SHA224_256ProcessBlocks = SHA224_256SelectBlocks;
+
+static void SHA224_256SelectBlocks(uint32_t *Intermediate_Hash,
+    const uint8_t *block, unsigned int blocks)
+{
+    SHA224_256_BLOCKS_FUNCTION selected = SHA224_256ReferenceBlocks;
+
+#if defined(SHA256_USE_X86_SHA_NI)
+    if (SHA224_256HasShaNi())
+        selected = SHA224_256ShaNiBlocks;
+#elif defined(SHA256_USE_ARMV8_SHA2)
+    if (SHA224_256HasArmv8Sha2())
+        selected = SHA224_256Armv8Blocks;
+#endif
+
+    SHA224_256ProcessBlocks = selected;
+    selected(Intermediate_Hash, block, blocks);
+}
+
 static uint32_t SHA224_H0[SHA256HashSize / 4] = {
     0xC1059ED8, 0x367CD507, 0x3070DD17, 0xF70E5939,
     0xFFC00B31, 0x68581511, 0x64F98FA7, 0xBEFA4FA4
@@ -241,15 +513,33 @@ int SHA256Input(SHA256Context *context, const uint8_t *message_array,
     if (context->Corrupted)
         return context->Corrupted;
 
-    while (length-- && !context->Corrupted) {
-        context->Message_Block[context->Message_Block_Index++] =
-            (*message_array & 0xFF);
-
-        if (!SHA224_256AddLength(context, 8) &&
-            (context->Message_Block_Index == SHA256_Message_Block_Size))
-            SHA224_256ProcessMessageBlock(context);
-
-        message_array++;
+    while (length && !context->Corrupted) {
+        if ((context->Message_Block_Index == 0) &&
+            (length >= SHA256_Message_Block_Size)) {
+            /* whole blocks are hashed straight from message_array */
+            unsigned int blocks = length / SHA256_Message_Block_Size;
+            if (blocks > SHA256_MAX_BLOCKS_PER_CALL)
+                blocks = SHA256_MAX_BLOCKS_PER_CALL;
+
+            if (!SHA224_256AddLength(context, blocks * SHA256_Message_Block_Size * 8)) {
+                SHA224_256ProcessBlocks(context->Intermediate_Hash, message_array, blocks);
+                message_array += blocks * SHA256_Message_Block_Size;
+                length -= blocks * SHA256_Message_Block_Size;
+            }
+        } else {
+            unsigned int count = SHA256_Message_Block_Size - context->Message_Block_Index;
+            if (count > length)
+                count = length;
+
+            (void)memcpy(&context->Message_Block[context->Message_Block_Index], message_array, count);
+            context->Message_Block_Index += (int_least16_t)count;
+            message_array += count;
+            length -= count;
+
+            if (!SHA224_256AddLength(context, count * 8) &&
+                (context->Message_Block_Index == SHA256_Message_Block_Size))
+                SHA224_256ProcessMessageBlock(context);
+        }
     }
 
     return shaSuccess;
@@ -449,71 +739,7 @@ static void SHA224_256PadMessage(SHA256Context *context,
 */
 static void SHA224_256ProcessMessageBlock(SHA256Context *context)
 {
-    /* Constants defined in FIPS-180-2, section 4.2.2 */
-    static const uint32_t K[64] = {
-        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b,
-        0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01,
-        0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7,
-        0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-        0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152,
-        0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
-        0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
-        0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819,
-        0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08,
-        0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f,
-        0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-        0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-    };
-    int        t, t4;                   /* Loop counter */
-    uint32_t   temp1, temp2;            /* Temporary word value */
-    uint32_t   W[64];                   /* Word sequence */
-    uint32_t   A, B, C, D, E, F, G, H;  /* Word buffers */
-
-    /*
-    * Initialize the first 16 words in the array W
-    */
-    for (t = t4 = 0; t < 16; t++, t4 += 4)
-        W[t] = (((uint32_t)context->Message_Block[t4]) << 24) |
-        (((uint32_t)context->Message_Block[t4 + 1]) << 16) |
-        (((uint32_t)context->Message_Block[t4 + 2]) << 8) |
-        (((uint32_t)context->Message_Block[t4 + 3]));
-
-    for (t = 16; t < 64; t++)
-        W[t] = SHA256_sigma1(W[t - 2]) + W[t - 7] +
-        SHA256_sigma0(W[t - 15]) + W[t - 16];
-
-    A = context->Intermediate_Hash[0];
-    B = context->Intermediate_Hash[1];
-    C = context->Intermediate_Hash[2];
-    D = context->Intermediate_Hash[3];
-    E = context->Intermediate_Hash[4];
-    F = context->Intermediate_Hash[5];
-    G = context->Intermediate_Hash[6];
-    H = context->Intermediate_Hash[7];
-
-    for (t = 0; t < 64; t++) {
-        temp1 = H + SHA256_SIGMA1(E) + SHA_Ch(E, F, G) + K[t] + W[t];
-        temp2 = SHA256_SIGMA0(A) + SHA_Maj(A, B, C);
-        H = G;
-        G = F;
-        F = E;
-        E = D + temp1;
-        D = C;
-        C = B;
-        B = A;
-        A = temp1 + temp2;
-    }
-
-    context->Intermediate_Hash[0] += A;
-    context->Intermediate_Hash[1] += B;
-    context->Intermediate_Hash[2] += C;
-    context->Intermediate_Hash[3] += D;
-    context->Intermediate_Hash[4] += E;
-    context->Intermediate_Hash[5] += F;
-    context->Intermediate_Hash[6] += G;
-    context->Intermediate_Hash[7] += H;
-
+    SHA224_256ProcessBlocks(context->Intermediate_Hash, context->Message_Block, 1);
     context->Message_Block_Index = 0;
 }
 
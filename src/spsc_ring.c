@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/spsc_ring.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+// Include the platform-specific file that defines atomic functionality
+#include "queue_atomic_os.h"
+
+/*
+ * head and tail are free running indices: the consumer owns head, the producer owns tail,
+ * and slot (index & mask) holds the item of that index. Each side keeps a copy of the
+ * index of the other side and only reloads it when the ring looks full or empty, so in
+ * the steady state the two threads do not read each other's cache line on every item.
+ */
+#define SPSC_RING_CACHE_LINE_SIZE   64
+
+typedef struct SPSC_RING_TAG
+{
+    void** items;
+    size_t mask;
+    unsigned char shared_pad[SPSC_RING_CACHE_LINE_SIZE];
+
+    /*written by the consumer*/
+    QUEUE_ATOMIC_TYPE(size_t) head;
+    size_t cached_tail;
+    unsigned char consumer_pad[SPSC_RING_CACHE_LINE_SIZE];
+
+    /*written by the producer*/
+    QUEUE_ATOMIC_TYPE(size_t) tail;
+    size_t cached_head;
+    unsigned char producer_pad[SPSC_RING_CACHE_LINE_SIZE];
+} SPSC_RING;
+
+SPSC_RING_HANDLE spsc_ring_create(size_t capacity)
+{
+    SPSC_RING* result;
+
+    if ((capacity == 0) || (capacity > (SIZE_MAX / 2) / sizeof(void*)))
+    {
+        /* Codes_SRS_SPSC_RING_01_001: [ If capacity is 0 or too large for the items to be allocated, spsc_ring_create shall fail and return NULL. ]*/
+        LogError("Invalid argument: capacity=%lu", (unsigned long)capacity);
+        result = NULL;
+    }
+    else if ((result = (SPSC_RING*)malloc(sizeof(SPSC_RING))) == NULL)
+    {
+        /* Codes_SRS_SPSC_RING_01_003: [ If any allocation fails, spsc_ring_create shall free what it allocated and return NULL. ]*/
+        LogError("Cannot allocate the ring");
+    }
+    else
+    {
+        /* Codes_SRS_SPSC_RING_01_002: [ spsc_ring_create shall allocate a ring with room for capacity items rounded up to a power of 2. ]*/
+        size_t rounded_capacity = 1;
+        while (rounded_capacity < capacity)
+        {
+            rounded_capacity *= 2;
+        }
+
+        result->items = (void**)malloc(rounded_capacity * sizeof(void*));
+        if (result->items == NULL)
+        {
+            LogError("Cannot allocate %lu items", (unsigned long)rounded_capacity);
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            result->mask = rounded_capacity - 1;
+            QUEUE_ATOMIC_INIT(size_t, result->head, 0);
+            QUEUE_ATOMIC_INIT(size_t, result->tail, 0);
+            result->cached_tail = 0;
+            result->cached_head = 0;
+        }
+    }
+
+    return result;
+}
+
+void spsc_ring_destroy(SPSC_RING_HANDLE ring)
+{
+    if (ring == NULL)
+    {
+        /* Codes_SRS_SPSC_RING_01_004: [ If ring is NULL, spsc_ring_destroy shall return. ]*/
+        LogError("Invalid argument: ring is NULL");
+    }
+    else
+    {
+        /* Codes_SRS_SPSC_RING_01_005: [ spsc_ring_destroy shall free the ring without touching the items left in it. ]*/
+        free(ring->items);
+        free(ring);
+    }
+}
+
+int spsc_ring_push(SPSC_RING_HANDLE ring, void* item)
+{
+    int result;
+
+    if (ring == NULL)
+    {
+        /* Codes_SRS_SPSC_RING_01_006: [ If ring is NULL, spsc_ring_push shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: ring is NULL");
+        result = __FAILURE__;
+    }
+    else
+    {
+        size_t tail = QUEUE_ATOMIC_LOAD(size_t, ring->tail);
+
+        if ((tail - ring->cached_head) > ring->mask)
+        {
+            ring->cached_head = QUEUE_ATOMIC_LOAD(size_t, ring->head);
+        }
+
+        if ((tail - ring->cached_head) > ring->mask)
+        {
+            /* Codes_SRS_SPSC_RING_01_007: [ If the ring is full, spsc_ring_push shall fail and return a non-zero value. ]*/
+            result = __FAILURE__;
+        }
+        else
+        {
+            /* Codes_SRS_SPSC_RING_01_008: [ spsc_ring_push shall store item in the slot after the last item and then publish it with a release store of the tail index, and return 0. ]*/
+            ring->items[tail & ring->mask] = item;
+            QUEUE_ATOMIC_STORE(size_t, ring->tail, tail + 1);
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+int spsc_ring_pop(SPSC_RING_HANDLE ring, void** item)
+{
+    int result;
+
+    if ((ring == NULL) || (item == NULL))
+    {
+        /* Codes_SRS_SPSC_RING_01_009: [ If ring or item is NULL, spsc_ring_pop shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: ring=%p, item=%p", ring, item);
+        result = __FAILURE__;
+    }
+    else
+    {
+        size_t head = QUEUE_ATOMIC_LOAD(size_t, ring->head);
+
+        if (head == ring->cached_tail)
+        {
+            ring->cached_tail = QUEUE_ATOMIC_LOAD(size_t, ring->tail);
+        }
+
+        if (head == ring->cached_tail)
+        {
+            /* Codes_SRS_SPSC_RING_01_010: [ If the ring is empty, spsc_ring_pop shall fail and return a non-zero value. ]*/
+            result = __FAILURE__;
+        }
+        else
+        {
+            /* Codes_SRS_SPSC_RING_01_011: [ spsc_ring_pop shall take the oldest item, release its slot with a release store of the head index, and return 0. ]*/
+            *item = ring->items[head & ring->mask];
+            QUEUE_ATOMIC_STORE(size_t, ring->head, head + 1);
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+size_t spsc_ring_get_count(SPSC_RING_HANDLE ring)
+{
+    size_t result;
+
+    if (ring == NULL)
+    {
+        /* Codes_SRS_SPSC_RING_01_012: [ If ring is NULL, spsc_ring_get_count shall return 0. ]*/
+        LogError("Invalid argument: ring is NULL");
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_SPSC_RING_01_013: [ spsc_ring_get_count shall return the number of items pushed and not yet popped. ]*/
+        size_t head = QUEUE_ATOMIC_LOAD(size_t, ring->head);
+        result = QUEUE_ATOMIC_LOAD(size_t, ring->tail) - head;
+    }
+
+    return result;
+}
@@ -0,0 +1,844 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/threadpool.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/timer_wheel.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+/*
+ * Every worker owns a double ended queue with its own lock. A worker pushes and pops
+ * work it schedules itself at the back of its queue and, when that is empty, takes
+ * from the front of the shared queue and then steals from the front of the other
+ * workers' queues. Finding out which worker is calling threadpool_schedule needs
+ * thread local storage; without it (or with NO_THREADPOOL_THREAD_LOCAL defined) all
+ * work goes through the shared queue.
+ */
+#if !defined(NO_THREADPOOL_THREAD_LOCAL) && defined(_MSC_VER)
+#define THREADPOOL_THREAD_LOCAL __declspec(thread)
+#elif !defined(NO_THREADPOOL_THREAD_LOCAL) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__linux__) || defined(__APPLE__) || defined(_WIN32))
+#define THREADPOOL_THREAD_LOCAL __thread
+#endif
+
+#define WORK_QUEUE_INITIAL_CAPACITY     64
+
+typedef struct WORK_ITEM_TAG
+{
+    THREADPOOL_WORK_FUNCTION function;
+    void* context;
+} WORK_ITEM;
+
+/*ring buffer of work items; capacity is 0 or a power of 2*/
+typedef struct WORK_QUEUE_TAG
+{
+    LOCK_HANDLE lock;
+    WORK_ITEM* items;
+    size_t capacity;
+    size_t head;
+    size_t count;
+} WORK_QUEUE;
+
+typedef enum WORKER_STATE_TAG
+{
+    WORKER_STATE_NOT_STARTED,
+    WORKER_STATE_RUNNING,
+    WORKER_STATE_EXITED
+} WORKER_STATE;
+
+typedef struct WORKER_TAG
+{
+    struct THREADPOOL_TAG* threadpool;
+    size_t index;
+    WORK_QUEUE queue;
+    /*state, thread and joinable are guarded by the pool lock*/
+    WORKER_STATE state;
+    THREAD_HANDLE thread;
+    /*the thread was started and not joined yet; unlike state it is never written by the worker itself*/
+    bool joinable;
+} WORKER;
+
+typedef struct THREADPOOL_TIMER_TAG
+{
+    struct THREADPOOL_TAG* threadpool;
+    THREADPOOL_WORK_FUNCTION function;
+    void* context;
+    uint32_t period_ms;
+    /*the timer of the wheel, kept from threadpool_timer_start to the free so that a periodic timer is restarted without allocating*/
+    TIMER_WHEEL_TIMER_HANDLE wheel_timer;
+    /*handed to the workers, its work function may be running*/
+    bool scheduled;
+    bool cancelled;
+    /*links in the list of all the timers of the pool*/
+    struct THREADPOOL_TIMER_TAG* all_previous;
+    struct THREADPOOL_TIMER_TAG* all_next;
+} THREADPOOL_TIMER;
+
+typedef struct THREADPOOL_TAG
+{
+    size_t min_threads;
+    size_t max_threads;
+    WORKER* workers;
+    WORK_QUEUE shared_queue;
+
+    /*guards the worker states and the counters below*/
+    LOCK_HANDLE lock;
+    COND_HANDLE work_available;
+    size_t running_count;
+    size_t idle_count;
+    size_t wakeups_pending;
+    bool shutting_down;
+
+    /*guards every timer and the wheel, which the timer thread drives*/
+    LOCK_HANDLE timer_lock;
+    COND_HANDLE timer_changed;
+    TIMER_WHEEL_HANDLE timer_wheel;
+    THREAD_HANDLE timer_thread;
+    bool timer_thread_started;
+    bool timers_stopped;
+    THREADPOOL_TIMER* all_timers;
+} THREADPOOL;
+
+#if defined(THREADPOOL_THREAD_LOCAL)
+static THREADPOOL_THREAD_LOCAL WORKER* current_worker;
+#endif
+
+static WORKER* get_current_worker(THREADPOOL* threadpool)
+{
+#if defined(THREADPOOL_THREAD_LOCAL)
+    return ((current_worker != NULL) && (current_worker->threadpool == threadpool)) ? current_worker : NULL;
+#else
+    (void)threadpool;
+    return NULL;
+#endif
+}
+
+static void set_current_worker(WORKER* worker)
+{
+#if defined(THREADPOOL_THREAD_LOCAL)
+    current_worker = worker;
+#else
+    (void)worker;
+#endif
+}
+
+/* work queues */
+
+static int work_queue_init(WORK_QUEUE* queue)
+{
+    int result;
+
+    (void)memset(queue, 0, sizeof(WORK_QUEUE));
+    if ((queue->lock = Lock_Init()) == NULL)
+    {
+        LogError("Lock_Init failed");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+static void work_queue_deinit(WORK_QUEUE* queue)
+{
+    if (queue->lock != NULL)
+    {
+        (void)Lock_Deinit(queue->lock);
+        queue->lock = NULL;
+    }
+    free(queue->items);
+    queue->items = NULL;
+}
+
+/*the caller holds the queue lock*/
+static int work_queue_push_back(WORK_QUEUE* queue, THREADPOOL_WORK_FUNCTION function, void* context)
+{
+    int result;
+
+    if (queue->count == queue->capacity)
+    {
+        size_t new_capacity = (queue->capacity == 0) ? WORK_QUEUE_INITIAL_CAPACITY : queue->capacity * 2;
+        WORK_ITEM* new_items;
+
+        if ((new_capacity > SIZE_MAX / sizeof(WORK_ITEM)) ||
+            ((new_items = (WORK_ITEM*)malloc(new_capacity * sizeof(WORK_ITEM))) == NULL))
+        {
+            LogError("Unable to grow the work queue to %lu items", (unsigned long)new_capacity);
+            result = __FAILURE__;
+        }
+        else
+        {
+            size_t i;
+
+            /*unwrap the items to the start of the new array*/
+            for (i = 0; i < queue->count; i++)
+            {
+                new_items[i] = queue->items[(queue->head + i) & (queue->capacity - 1)];
+            }
+            free(queue->items);
+            queue->items = new_items;
+            queue->capacity = new_capacity;
+            queue->head = 0;
+            result = 0;
+        }
+    }
+    else
+    {
+        result = 0;
+    }
+
+    if (result == 0)
+    {
+        WORK_ITEM* item = &queue->items[(queue->head + queue->count) & (queue->capacity - 1)];
+        item->function = function;
+        item->context = context;
+        queue->count++;
+    }
+
+    return result;
+}
+
+static bool work_queue_pop_back(WORK_QUEUE* queue, WORK_ITEM* item)
+{
+    bool result;
+
+    (void)Lock(queue->lock);
+    if (queue->count == 0)
+    {
+        result = false;
+    }
+    else
+    {
+        queue->count--;
+        *item = queue->items[(queue->head + queue->count) & (queue->capacity - 1)];
+        result = true;
+    }
+    (void)Unlock(queue->lock);
+
+    return result;
+}
+
+static bool work_queue_pop_front(WORK_QUEUE* queue, WORK_ITEM* item)
+{
+    bool result;
+
+    (void)Lock(queue->lock);
+    if (queue->count == 0)
+    {
+        result = false;
+    }
+    else
+    {
+        *item = queue->items[queue->head];
+        queue->head = (queue->head + 1) & (queue->capacity - 1);
+        queue->count--;
+        result = true;
+    }
+    (void)Unlock(queue->lock);
+
+    return result;
+}
+
+/* workers */
+
+static bool find_work(THREADPOOL* threadpool, WORKER* worker, WORK_ITEM* item)
+{
+    bool result;
+
+    /*Codes_SRS_THREADPOOL_01_013: [ A worker shall run the most recently queued item of its own queue first, then the oldest item of the shared queue, then the oldest item of another worker's queue. ]*/
+    if (work_queue_pop_back(&worker->queue, item) ||
+        work_queue_pop_front(&threadpool->shared_queue, item))
+    {
+        result = true;
+    }
+    else
+    {
+        size_t i;
+
+        result = false;
+        for (i = 1; (i < threadpool->max_threads) && !result; i++)
+        {
+            result = work_queue_pop_front(&threadpool->workers[(worker->index + i) % threadpool->max_threads].queue, item);
+        }
+    }
+
+    return result;
+}
+
+static int worker_thread(void* arg)
+{
+    WORKER* worker = (WORKER*)arg;
+    THREADPOOL* threadpool = worker->threadpool;
+    bool exit_worker = false;
+    bool idle_timed_out = false;
+
+    set_current_worker(worker);
+
+    while (!exit_worker)
+    {
+        WORK_ITEM item;
+
+        if (find_work(threadpool, worker, &item))
+        {
+            idle_timed_out = false;
+            item.function(item.context);
+        }
+        else
+        {
+            (void)Lock(threadpool->lock);
+
+            /*look again while holding the pool lock: work is always queued before the lock is taken to wake an idle worker, so nothing can slip in between this check and the wait*/
+            if (find_work(threadpool, worker, &item))
+            {
+                (void)Unlock(threadpool->lock);
+                idle_timed_out = false;
+                item.function(item.context);
+            }
+            else if (threadpool->shutting_down ||
+                (idle_timed_out && (threadpool->running_count > threadpool->min_threads)))
+            {
+                /*Codes_SRS_THREADPOOL_01_015: [ A worker above min_threads that has been idle for THREADPOOL_IDLE_TIMEOUT_MS shall exit. ]*/
+                /*Codes_SRS_THREADPOOL_01_020: [ Once threadpool_destroy has started, a worker that finds no work anywhere shall exit. ]*/
+                worker->state = WORKER_STATE_EXITED;
+                threadpool->running_count--;
+                exit_worker = true;
+                (void)Unlock(threadpool->lock);
+            }
+            else
+            {
+                threadpool->idle_count++;
+                idle_timed_out = (Condition_Wait(threadpool->work_available, threadpool->lock, THREADPOOL_IDLE_TIMEOUT_MS) == COND_TIMEOUT);
+                threadpool->idle_count--;
+                if (threadpool->wakeups_pending > 0)
+                {
+                    threadpool->wakeups_pending--;
+                }
+                (void)Unlock(threadpool->lock);
+            }
+        }
+    }
+
+    set_current_worker(NULL);
+    return 0;
+}
+
+/*the caller holds the pool lock*/
+static int start_worker(THREADPOOL* threadpool)
+{
+    int result;
+    size_t i;
+    WORKER* worker = NULL;
+
+    for (i = 0; (i < threadpool->max_threads) && (worker == NULL); i++)
+    {
+        if (threadpool->workers[i].state != WORKER_STATE_RUNNING)
+        {
+            worker = &threadpool->workers[i];
+        }
+    }
+
+    if (worker == NULL)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        if (worker->state == WORKER_STATE_EXITED)
+        {
+            /*the thread has returned from worker_thread already, joining does not block*/
+            (void)ThreadAPI_Join(worker->thread, NULL);
+            worker->state = WORKER_STATE_NOT_STARTED;
+            worker->joinable = false;
+        }
+
+        if (ThreadAPI_Create(&worker->thread, worker_thread, worker) != THREADAPI_OK)
+        {
+            LogError("ThreadAPI_Create failed");
+            result = __FAILURE__;
+        }
+        else
+        {
+            worker->state = WORKER_STATE_RUNNING;
+            worker->joinable = true;
+            threadpool->running_count++;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+/*the caller holds the pool lock*/
+static void wake_worker(THREADPOOL* threadpool)
+{
+    if (threadpool->idle_count > threadpool->wakeups_pending)
+    {
+        threadpool->wakeups_pending++;
+        (void)Condition_Post(threadpool->work_available);
+    }
+    else if (threadpool->running_count < threadpool->max_threads)
+    {
+        /*Codes_SRS_THREADPOOL_01_014: [ If no worker is idle and fewer than max_threads workers are running, threadpool_schedule shall start a new worker by calling ThreadAPI_Create. ]*/
+        if (start_worker(threadpool) != 0)
+        {
+            /*the running workers will get to the work eventually*/
+            LogError("Unable to start another worker");
+        }
+    }
+}
+
+static void stop_workers(THREADPOOL* threadpool)
+{
+    size_t i;
+
+    (void)Lock(threadpool->lock);
+    threadpool->shutting_down = true;
+    (void)Condition_PostAll(threadpool->work_available);
+    (void)Unlock(threadpool->lock);
+
+    /*no worker is started once shutting_down is set, so joinable can be read without the lock*/
+    for (i = 0; i < threadpool->max_threads; i++)
+    {
+        if (threadpool->workers[i].joinable)
+        {
+            (void)ThreadAPI_Join(threadpool->workers[i].thread, NULL);
+            threadpool->workers[i].joinable = false;
+        }
+    }
+}
+
+/* timers */
+
+/*the caller holds the timer lock*/
+static void free_timer(THREADPOOL* threadpool, THREADPOOL_TIMER* timer)
+{
+    timer_wheel_cancel(timer->wheel_timer);
+    if (timer->all_previous != NULL)
+    {
+        timer->all_previous->all_next = timer->all_next;
+    }
+    else
+    {
+        threadpool->all_timers = timer->all_next;
+    }
+    if (timer->all_next != NULL)
+    {
+        timer->all_next->all_previous = timer->all_previous;
+    }
+    free(timer);
+}
+
+/*the caller holds the timer lock*/
+static void restart_timer(THREADPOOL* threadpool, THREADPOOL_TIMER* timer, uint32_t delay_ms)
+{
+    if (timer_wheel_restart(timer->wheel_timer, delay_ms) != 0)
+    {
+        LogError("timer_wheel_restart failed");
+    }
+    else
+    {
+        /*the timer thread may be waiting for a later deadline*/
+        (void)Condition_Post(threadpool->timer_changed);
+    }
+}
+
+static void run_timer(void* context)
+{
+    THREADPOOL_TIMER* timer = (THREADPOOL_TIMER*)context;
+    THREADPOOL* threadpool = timer->threadpool;
+    bool cancelled;
+
+    (void)Lock(threadpool->timer_lock);
+    cancelled = timer->cancelled;
+    (void)Unlock(threadpool->timer_lock);
+
+    if (!cancelled)
+    {
+        timer->function(timer->context);
+    }
+
+    (void)Lock(threadpool->timer_lock);
+    timer->scheduled = false;
+    if (timer->cancelled)
+    {
+        /*Codes_SRS_THREADPOOL_01_027: [ A timer cancelled while its work function is queued or running shall be freed once the run is over. ]*/
+        free_timer(threadpool, timer);
+    }
+    else if ((timer->period_ms != 0) && !threadpool->timers_stopped)
+    {
+        /*Codes_SRS_THREADPOOL_01_023: [ A periodic timer shall be put back in the wheel, period_ms after its run completes. ]*/
+        restart_timer(threadpool, timer, timer->period_ms);
+    }
+    (void)Unlock(threadpool->timer_lock);
+}
+
+/*called by timer_wheel_dowork on the timer thread, which holds the timer lock*/
+static void on_timer_due(void* context)
+{
+    THREADPOOL_TIMER* timer = (THREADPOOL_TIMER*)context;
+
+    timer->scheduled = true;
+
+    /*Codes_SRS_THREADPOOL_01_022: [ When a timer is due, its work function shall be scheduled on the workers. ]*/
+    if (threadpool_schedule(timer->threadpool, run_timer, timer) != 0)
+    {
+        LogError("Unable to schedule a due timer");
+        timer->scheduled = false;
+        if (timer->period_ms != 0)
+        {
+            /*try again on the next period*/
+            (void)timer_wheel_restart(timer->wheel_timer, timer->period_ms);
+        }
+    }
+}
+
+static int timer_thread(void* arg)
+{
+    THREADPOOL* threadpool = (THREADPOOL*)arg;
+
+    (void)Lock(threadpool->timer_lock);
+    while (!threadpool->timers_stopped)
+    {
+        uint32_t wait_ms;
+
+        timer_wheel_dowork(threadpool->timer_wheel);
+
+        if (timer_wheel_get_wait_ms(threadpool->timer_wheel, &wait_ms) != 0)
+        {
+            LogError("timer_wheel_get_wait_ms failed");
+            wait_ms = THREADPOOL_TIMER_RESOLUTION_MS;
+        }
+
+        if (wait_ms == TIMER_WHEEL_WAIT_INFINITE)
+        {
+            /*no timer is waiting, sleep until one is started or the pool is destroyed*/
+            (void)Condition_Wait(threadpool->timer_changed, threadpool->timer_lock, 0);
+        }
+        else if (wait_ms > 0)
+        {
+            (void)Condition_Wait(threadpool->timer_changed, threadpool->timer_lock, (wait_ms > INT_MAX) ? INT_MAX : (int)wait_ms);
+        }
+    }
+    (void)Unlock(threadpool->timer_lock);
+
+    return 0;
+}
+
+static void stop_timers(THREADPOOL* threadpool)
+{
+    bool join;
+
+    (void)Lock(threadpool->timer_lock);
+    threadpool->timers_stopped = true;
+    join = threadpool->timer_thread_started;
+    (void)Condition_Post(threadpool->timer_changed);
+    (void)Unlock(threadpool->timer_lock);
+
+    if (join)
+    {
+        (void)ThreadAPI_Join(threadpool->timer_thread, NULL);
+    }
+}
+
+static void free_threadpool(THREADPOOL* threadpool)
+{
+    size_t i;
+
+    while (threadpool->all_timers != NULL)
+    {
+        free_timer(threadpool, threadpool->all_timers);
+    }
+    if (threadpool->workers != NULL)
+    {
+        for (i = 0; i < threadpool->max_threads; i++)
+        {
+            work_queue_deinit(&threadpool->workers[i].queue);
+        }
+        free(threadpool->workers);
+    }
+    work_queue_deinit(&threadpool->shared_queue);
+    if (threadpool->timer_wheel != NULL)
+    {
+        timer_wheel_destroy(threadpool->timer_wheel);
+    }
+    if (threadpool->timer_changed != NULL)
+    {
+        Condition_Deinit(threadpool->timer_changed);
+    }
+    if (threadpool->timer_lock != NULL)
+    {
+        (void)Lock_Deinit(threadpool->timer_lock);
+    }
+    if (threadpool->work_available != NULL)
+    {
+        Condition_Deinit(threadpool->work_available);
+    }
+    if (threadpool->lock != NULL)
+    {
+        (void)Lock_Deinit(threadpool->lock);
+    }
+    free(threadpool);
+}
+
+THREADPOOL_HANDLE threadpool_create(size_t min_threads, size_t max_threads)
+{
+    THREADPOOL* result;
+
+    if ((min_threads == 0) || (max_threads < min_threads) || (max_threads > SIZE_MAX / sizeof(WORKER)))
+    {
+        /*Codes_SRS_THREADPOOL_01_001: [ If min_threads is 0 or max_threads is smaller than min_threads, threadpool_create shall fail and return NULL. ]*/
+        LogError("Invalid arguments: min_threads = %lu, max_threads = %lu", (unsigned long)min_threads, (unsigned long)max_threads);
+        result = NULL;
+    }
+    /*Codes_SRS_THREADPOOL_01_002: [ threadpool_create shall allocate the pool and max_threads worker slots, each with a queue guarded by a lock created with Lock_Init. ]*/
+    else if ((result = (THREADPOOL*)malloc(sizeof(THREADPOOL))) == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_01_004: [ If any of the above fails, threadpool_create shall free everything it created, stop the workers it started and return NULL. ]*/
+        LogError("Unable to allocate the threadpool");
+    }
+    else
+    {
+        size_t i;
+        bool failed;
+
+        (void)memset(result, 0, sizeof(THREADPOOL));
+        result->min_threads = min_threads;
+        result->max_threads = max_threads;
+
+        /*Codes_SRS_THREADPOOL_01_003: [ threadpool_create shall create the pool lock, the timer lock and two conditions with Lock_Init and Condition_Init, a timer wheel of THREADPOOL_TIMER_RESOLUTION_MS ticks with timer_wheel_create, and start min_threads workers with ThreadAPI_Create. ]*/
+        if ((result->workers = (WORKER*)malloc(max_threads * sizeof(WORKER))) == NULL)
+        {
+            failed = true;
+        }
+        else
+        {
+            (void)memset(result->workers, 0, max_threads * sizeof(WORKER));
+            failed =
+                (work_queue_init(&result->shared_queue) != 0) ||
+                ((result->lock = Lock_Init()) == NULL) ||
+                ((result->work_available = Condition_Init()) == NULL) ||
+                ((result->timer_lock = Lock_Init()) == NULL) ||
+                ((result->timer_changed = Condition_Init()) == NULL) ||
+                ((result->timer_wheel = timer_wheel_create(THREADPOOL_TIMER_RESOLUTION_MS)) == NULL);
+        }
+
+        for (i = 0; (i < max_threads) && !failed; i++)
+        {
+            result->workers[i].threadpool = result;
+            result->workers[i].index = i;
+            result->workers[i].state = WORKER_STATE_NOT_STARTED;
+            failed = (work_queue_init(&result->workers[i].queue) != 0);
+        }
+
+        if (!failed)
+        {
+            (void)Lock(result->lock);
+            for (i = 0; (i < min_threads) && !failed; i++)
+            {
+                failed = (start_worker(result) != 0);
+            }
+            (void)Unlock(result->lock);
+
+            if (failed)
+            {
+                stop_workers(result);
+            }
+        }
+
+        if (failed)
+        {
+            /*Codes_SRS_THREADPOOL_01_004: [ If any of the above fails, threadpool_create shall free everything it created, stop the workers it started and return NULL. ]*/
+            LogError("Unable to create the threadpool");
+            free_threadpool(result);
+            result = NULL;
+        }
+    }
+
+    return result;
+}
+
+void threadpool_destroy(THREADPOOL_HANDLE threadpool)
+{
+    if (threadpool == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_01_005: [ If threadpool is NULL, threadpool_destroy shall return. ]*/
+        LogError("NULL threadpool");
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_01_006: [ threadpool_destroy shall stop the timer thread and join it, so that no timer fires afterwards. ]*/
+        stop_timers(threadpool);
+
+        /*Codes_SRS_THREADPOOL_01_007: [ threadpool_destroy shall refuse new work, wake every idle worker, and join every worker once all the queued work has run. ]*/
+        stop_workers(threadpool);
+
+        /*Codes_SRS_THREADPOOL_01_008: [ threadpool_destroy shall free the timers that were not cancelled and every resource of the pool. ]*/
+        free_threadpool(threadpool);
+    }
+}
+
+int threadpool_schedule(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_FUNCTION work_function, void* context)
+{
+    int result;
+
+    if ((threadpool == NULL) || (work_function == NULL))
+    {
+        /*Codes_SRS_THREADPOOL_01_009: [ If threadpool or work_function is NULL, threadpool_schedule shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: threadpool = %p, work_function = %p", threadpool, work_function);
+        result = __FAILURE__;
+    }
+    else if (Lock(threadpool->lock) != LOCK_OK)
+    {
+        LogError("Lock failed");
+        result = __FAILURE__;
+    }
+    else
+    {
+        if (threadpool->shutting_down)
+        {
+            /*Codes_SRS_THREADPOOL_01_010: [ Once threadpool_destroy has started, threadpool_schedule shall fail and return a non-zero value. ]*/
+            LogError("The threadpool is shutting down");
+            result = __FAILURE__;
+        }
+        else
+        {
+            /*Codes_SRS_THREADPOOL_01_011: [ When called from one of the pool's workers, threadpool_schedule shall queue the work at the back of that worker's queue; otherwise it shall queue it at the back of the shared queue. ]*/
+            WORKER* worker = get_current_worker(threadpool);
+            WORK_QUEUE* queue = (worker != NULL) ? &worker->queue : &threadpool->shared_queue;
+
+            (void)Lock(queue->lock);
+            result = work_queue_push_back(queue, work_function, context);
+            (void)Unlock(queue->lock);
+
+            if (result != 0)
+            {
+                /*Codes_SRS_THREADPOOL_01_012: [ If the queue cannot grow, threadpool_schedule shall fail and return a non-zero value. ]*/
+                LogError("Unable to queue the work");
+            }
+            else
+            {
+                /*Codes_SRS_THREADPOOL_01_016: [ threadpool_schedule shall wake an idle worker by calling Condition_Post, if there is one that is not already being woken, and return 0. ]*/
+                wake_worker(threadpool);
+            }
+        }
+        (void)Unlock(threadpool->lock);
+    }
+
+    return result;
+}
+
+THREADPOOL_TIMER_HANDLE threadpool_timer_start(THREADPOOL_HANDLE threadpool, uint32_t delay_ms, uint32_t period_ms, THREADPOOL_WORK_FUNCTION work_function, void* context)
+{
+    THREADPOOL_TIMER* result;
+
+    if ((threadpool == NULL) || (work_function == NULL))
+    {
+        /*Codes_SRS_THREADPOOL_01_017: [ If threadpool or work_function is NULL, threadpool_timer_start shall fail and return NULL. ]*/
+        LogError("Invalid arguments: threadpool = %p, work_function = %p", threadpool, work_function);
+        result = NULL;
+    }
+    /*Codes_SRS_THREADPOOL_01_018: [ threadpool_timer_start shall allocate a timer. ]*/
+    else if ((result = (THREADPOOL_TIMER*)malloc(sizeof(THREADPOOL_TIMER))) == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_01_021: [ If any of the above fails, threadpool_timer_start shall fail and return NULL. ]*/
+        LogError("Unable to allocate the timer");
+    }
+    else if (Lock(threadpool->timer_lock) != LOCK_OK)
+    {
+        /*Codes_SRS_THREADPOOL_01_021: [ If any of the above fails, threadpool_timer_start shall fail and return NULL. ]*/
+        LogError("Lock failed");
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        (void)memset(result, 0, sizeof(THREADPOOL_TIMER));
+        result->threadpool = threadpool;
+        result->function = work_function;
+        result->context = context;
+        result->period_ms = period_ms;
+
+        if (threadpool->timers_stopped)
+        {
+            /*Codes_SRS_THREADPOOL_01_021: [ If any of the above fails, threadpool_timer_start shall fail and return NULL. ]*/
+            LogError("The threadpool is shutting down");
+            free(result);
+            result = NULL;
+        }
+        /*Codes_SRS_THREADPOOL_01_024: [ threadpool_timer_start shall schedule the timer with timer_wheel_schedule, delay_ms from now, and return it. ]*/
+        else if ((result->wheel_timer = timer_wheel_schedule(threadpool->timer_wheel, delay_ms, on_timer_due, result)) == NULL)
+        {
+            /*Codes_SRS_THREADPOOL_01_021: [ If any of the above fails, threadpool_timer_start shall fail and return NULL. ]*/
+            LogError("timer_wheel_schedule failed");
+            free(result);
+            result = NULL;
+        }
+        else if (!threadpool->timer_thread_started &&
+            (ThreadAPI_Create(&threadpool->timer_thread, timer_thread, threadpool) != THREADAPI_OK))
+        {
+            /*Codes_SRS_THREADPOOL_01_019: [ The first call to threadpool_timer_start shall start the timer thread by calling ThreadAPI_Create. ]*/
+            /*Codes_SRS_THREADPOOL_01_021: [ If any of the above fails, threadpool_timer_start shall fail and return NULL. ]*/
+            LogError("Unable to start the timer thread");
+            timer_wheel_cancel(result->wheel_timer);
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            threadpool->timer_thread_started = true;
+
+            result->all_next = threadpool->all_timers;
+            if (threadpool->all_timers != NULL)
+            {
+                threadpool->all_timers->all_previous = result;
+            }
+            threadpool->all_timers = result;
+
+            /*the timer thread may be waiting for a later deadline*/
+            (void)Condition_Post(threadpool->timer_changed);
+        }
+
+        (void)Unlock(threadpool->timer_lock);
+    }
+
+    return result;
+}
+
+void threadpool_timer_cancel(THREADPOOL_TIMER_HANDLE timer)
+{
+    if (timer == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_01_025: [ If timer is NULL, threadpool_timer_cancel shall return. ]*/
+        LogError("NULL timer");
+    }
+    else
+    {
+        THREADPOOL* threadpool = timer->threadpool;
+
+        (void)Lock(threadpool->timer_lock);
+        if (timer->scheduled)
+        {
+            /*Codes_SRS_THREADPOOL_01_027: [ A timer cancelled while its work function is queued or running shall be freed once the run is over. ]*/
+            timer->cancelled = true;
+        }
+        else
+        {
+            /*Codes_SRS_THREADPOOL_01_026: [ threadpool_timer_cancel shall cancel the timer with timer_wheel_cancel and free it. ]*/
+            free_timer(threadpool, timer);
+        }
+        (void)Unlock(threadpool->timer_lock);
+    }
+}
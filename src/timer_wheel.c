@@ -0,0 +1,412 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/timer_wheel.h"
+#include "azure_c_shared_utility/doublylinkedlist.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+/*
+ * The wheel has TIMER_WHEEL_LEVEL_COUNT levels of TIMER_WHEEL_SLOT_COUNT slots. A timer due less
+ * than TIMER_WHEEL_SLOT_COUNT ticks away is in the level 0 slot of its tick; a timer due further
+ * away is in a slot of the level whose slots cover TIMER_WHEEL_SLOT_COUNT ^ level ticks each.
+ * Whenever the ticks of level 0 come round, the next slot of level 1 is emptied and its timers go
+ * down to level 0 (and so on up the levels), so each timer moves at most once per level and the
+ * timers of a level 0 slot are exactly the ones due at its tick. 6 levels of 64 slots cover 2^36
+ * ticks, more than any uint32_t delay.
+ */
+#define TIMER_WHEEL_LEVEL_COUNT     6
+#define TIMER_WHEEL_SLOT_BITS       6
+#define TIMER_WHEEL_SLOT_COUNT      (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK       (TIMER_WHEEL_SLOT_COUNT - 1)
+
+typedef enum TIMER_STATE_TAG
+{
+    /*in a slot, or about to run in the current dowork*/
+    TIMER_STATE_WAITING,
+    /*ran, or is running*/
+    TIMER_STATE_EXPIRED
+} TIMER_STATE;
+
+typedef struct TIMER_WHEEL_TAG TIMER_WHEEL;
+
+typedef struct TIMER_WHEEL_TIMER_TAG
+{
+    TIMER_WHEEL* timer_wheel;
+    ON_TIMER_WHEEL_TIMER on_timer;
+    void* context;
+    uint64_t due_tick;
+    TIMER_STATE state;
+    /*links in the slot, while waiting*/
+    DLIST_ENTRY slot_entry;
+    /*links in the list of all the timers of the wheel*/
+    DLIST_ENTRY all_entry;
+} TIMER_WHEEL_TIMER;
+
+typedef struct TIMER_WHEEL_TAG
+{
+    TICK_COUNTER_HANDLE tick_counter;
+    uint32_t tick_ms;
+    /*what the tick counter said last, and the milliseconds counted since timer_wheel_create, which do not wrap*/
+    tickcounter_ms_t last_ms;
+    uint64_t elapsed_ms;
+    /*the next tick to run: every timer due before it ran*/
+    uint64_t current_tick;
+    size_t waiting_timer_count;
+    DLIST_ENTRY slots[TIMER_WHEEL_LEVEL_COUNT][TIMER_WHEEL_SLOT_COUNT];
+    DLIST_ENTRY all_timers;
+} TIMER_WHEEL;
+
+static uint64_t get_current_tick(TIMER_WHEEL* timer_wheel)
+{
+    tickcounter_ms_t now_ms;
+
+    if (tickcounter_get_current_ms(timer_wheel->tick_counter, &now_ms) != 0)
+    {
+        LogError("tickcounter_get_current_ms failed");
+    }
+    else
+    {
+        /*unsigned arithmetic, so that a tick counter that wraps still adds up*/
+        timer_wheel->elapsed_ms += (tickcounter_ms_t)(now_ms - timer_wheel->last_ms);
+        timer_wheel->last_ms = now_ms;
+    }
+
+    return timer_wheel->elapsed_ms / timer_wheel->tick_ms;
+}
+
+static void insert_timer(TIMER_WHEEL* timer_wheel, TIMER_WHEEL_TIMER* timer)
+{
+    uint64_t delta;
+    size_t level = 0;
+
+    if (timer->due_tick < timer_wheel->current_tick)
+    {
+        timer->due_tick = timer_wheel->current_tick;
+    }
+
+    delta = timer->due_tick - timer_wheel->current_tick;
+    while ((level < TIMER_WHEEL_LEVEL_COUNT - 1) && (delta >= ((uint64_t)1 << (TIMER_WHEEL_SLOT_BITS * (level + 1)))))
+    {
+        level++;
+    }
+
+    DList_InsertTailList(&timer_wheel->slots[level][(timer->due_tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK], &timer->slot_entry);
+}
+
+static void schedule_timer(TIMER_WHEEL* timer_wheel, TIMER_WHEEL_TIMER* timer, uint32_t delay_ms)
+{
+    (void)get_current_tick(timer_wheel);
+
+    /*rounded up, so that the timer does not run before it is due*/
+    timer->due_tick = (timer_wheel->elapsed_ms + delay_ms + timer_wheel->tick_ms - 1) / timer_wheel->tick_ms;
+    timer->state = TIMER_STATE_WAITING;
+    insert_timer(timer_wheel, timer);
+    timer_wheel->waiting_timer_count++;
+}
+
+static void move_list(PDLIST_ENTRY destination, PDLIST_ENTRY source)
+{
+    while (!DList_IsListEmpty(source))
+    {
+        DList_InsertTailList(destination, DList_RemoveHeadList(source));
+    }
+}
+
+/*empties the slot of level the current tick has reached and puts its timers back one level down; returns the index of that slot*/
+static size_t cascade(TIMER_WHEEL* timer_wheel, size_t level)
+{
+    size_t index = (size_t)(timer_wheel->current_tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+    DLIST_ENTRY timers;
+
+    DList_InitializeListHead(&timers);
+    move_list(&timers, &timer_wheel->slots[level][index]);
+    while (!DList_IsListEmpty(&timers))
+    {
+        insert_timer(timer_wheel, containingRecord(DList_RemoveHeadList(&timers), TIMER_WHEEL_TIMER, slot_entry));
+    }
+
+    return index;
+}
+
+static void run_current_tick(TIMER_WHEEL* timer_wheel)
+{
+    size_t index = (size_t)timer_wheel->current_tick & TIMER_WHEEL_SLOT_MASK;
+    DLIST_ENTRY due_timers;
+
+    if (index == 0)
+    {
+        size_t level = 1;
+        size_t level_index;
+        do
+        {
+            level_index = cascade(timer_wheel, level);
+            level++;
+        } while ((level_index == 0) && (level < TIMER_WHEEL_LEVEL_COUNT));
+    }
+
+    /*the timers due now leave the wheel before the callbacks run, so that what the callbacks
+    schedule goes to a later tick, and a callback may cancel or restart any of them*/
+    DList_InitializeListHead(&due_timers);
+    move_list(&due_timers, &timer_wheel->slots[0][index]);
+    timer_wheel->current_tick++;
+
+    while (!DList_IsListEmpty(&due_timers))
+    {
+        TIMER_WHEEL_TIMER* timer = containingRecord(DList_RemoveHeadList(&due_timers), TIMER_WHEEL_TIMER, slot_entry);
+        timer->state = TIMER_STATE_EXPIRED;
+        timer_wheel->waiting_timer_count--;
+
+        /*Codes_SRS_TIMER_WHEEL_01_020: [ timer_wheel_dowork shall call the callback of every timer that is due, in the order of their deadlines, with its context. ]*/
+        timer->on_timer(timer->context);
+    }
+}
+
+/*the first tick from the current one that has timers to run or to cascade, UINT64_MAX if there is none*/
+static uint64_t get_next_tick(TIMER_WHEEL* timer_wheel)
+{
+    uint64_t result = UINT64_MAX;
+    size_t level;
+
+    for (level = 0; level < TIMER_WHEEL_LEVEL_COUNT; level++)
+    {
+        /*the slots of a level are emptied one after the other, each on the first tick of its span*/
+        uint64_t span = (uint64_t)1 << (TIMER_WHEEL_SLOT_BITS * level);
+        uint64_t tick = ((timer_wheel->current_tick + span - 1) / span) * span;
+        size_t i = 0;
+
+        while ((i < TIMER_WHEEL_SLOT_COUNT) && (tick < result) && DList_IsListEmpty(&timer_wheel->slots[level][(tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK]))
+        {
+            tick += span;
+            i++;
+        }
+
+        if ((i < TIMER_WHEEL_SLOT_COUNT) && (tick < result))
+        {
+            result = tick;
+        }
+    }
+
+    return result;
+}
+
+TIMER_WHEEL_HANDLE timer_wheel_create(uint32_t tick_ms)
+{
+    TIMER_WHEEL* result;
+
+    if (tick_ms == 0)
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_001: [ If tick_ms is 0, timer_wheel_create shall fail and return NULL. ]*/
+        LogError("Invalid argument: tick_ms=0");
+        result = NULL;
+    }
+    /*Codes_SRS_TIMER_WHEEL_01_002: [ timer_wheel_create shall allocate a timer wheel and create a tick counter with tickcounter_create. ]*/
+    else if ((result = (TIMER_WHEEL*)malloc(sizeof(TIMER_WHEEL))) == NULL)
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_004: [ If any error occurs, timer_wheel_create shall free what it allocated and return NULL. ]*/
+        LogError("Cannot allocate the timer wheel");
+    }
+    else if ((result->tick_counter = tickcounter_create()) == NULL)
+    {
+        LogError("tickcounter_create failed");
+        free(result);
+        result = NULL;
+    }
+    else if (tickcounter_get_current_ms(result->tick_counter, &result->last_ms) != 0)
+    {
+        LogError("tickcounter_get_current_ms failed");
+        tickcounter_destroy(result->tick_counter);
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        size_t level;
+        size_t index;
+
+        /*Codes_SRS_TIMER_WHEEL_01_003: [ timer_wheel_create shall start counting time from the current value of the tick counter and return the timer wheel. ]*/
+        result->tick_ms = tick_ms;
+        result->elapsed_ms = 0;
+        result->current_tick = 0;
+        result->waiting_timer_count = 0;
+        for (level = 0; level < TIMER_WHEEL_LEVEL_COUNT; level++)
+        {
+            for (index = 0; index < TIMER_WHEEL_SLOT_COUNT; index++)
+            {
+                DList_InitializeListHead(&result->slots[level][index]);
+            }
+        }
+        DList_InitializeListHead(&result->all_timers);
+    }
+
+    return result;
+}
+
+void timer_wheel_destroy(TIMER_WHEEL_HANDLE timer_wheel)
+{
+    if (timer_wheel == NULL)
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_005: [ If timer_wheel is NULL, timer_wheel_destroy shall return. ]*/
+        LogError("Invalid argument: timer_wheel=NULL");
+    }
+    else
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_006: [ timer_wheel_destroy shall free every timer that was not cancelled, without calling its callback, the tick counter and the timer wheel. ]*/
+        while (!DList_IsListEmpty(&timer_wheel->all_timers))
+        {
+            free(containingRecord(DList_RemoveHeadList(&timer_wheel->all_timers), TIMER_WHEEL_TIMER, all_entry));
+        }
+        tickcounter_destroy(timer_wheel->tick_counter);
+        free(timer_wheel);
+    }
+}
+
+TIMER_WHEEL_TIMER_HANDLE timer_wheel_schedule(TIMER_WHEEL_HANDLE timer_wheel, uint32_t delay_ms, ON_TIMER_WHEEL_TIMER on_timer, void* context)
+{
+    TIMER_WHEEL_TIMER* result;
+
+    if ((timer_wheel == NULL) || (on_timer == NULL))
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_007: [ If timer_wheel or on_timer is NULL, timer_wheel_schedule shall fail and return NULL. ]*/
+        LogError("Invalid argument: timer_wheel=%p, on_timer=%p", timer_wheel, on_timer);
+        result = NULL;
+    }
+    else if ((result = (TIMER_WHEEL_TIMER*)malloc(sizeof(TIMER_WHEEL_TIMER))) == NULL)
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_008: [ If allocating the timer fails, timer_wheel_schedule shall fail and return NULL. ]*/
+        LogError("Cannot allocate the timer");
+    }
+    else
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_009: [ timer_wheel_schedule shall read the tick counter and put the timer in the slot of the tick delay_ms from now, rounded up to tick_ms. ]*/
+        result->timer_wheel = timer_wheel;
+        result->on_timer = on_timer;
+        result->context = context;
+        DList_InsertTailList(&timer_wheel->all_timers, &result->all_entry);
+        schedule_timer(timer_wheel, result, delay_ms);
+    }
+
+    return result;
+}
+
+int timer_wheel_restart(TIMER_WHEEL_TIMER_HANDLE timer, uint32_t delay_ms)
+{
+    int result;
+
+    if (timer == NULL)
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_010: [ If timer is NULL, timer_wheel_restart shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: timer=NULL");
+        result = __FAILURE__;
+    }
+    else
+    {
+        if (timer->state == TIMER_STATE_WAITING)
+        {
+            /*Codes_SRS_TIMER_WHEEL_01_011: [ If the timer is waiting, timer_wheel_restart shall take it out of its slot. ]*/
+            (void)DList_RemoveEntryList(&timer->slot_entry);
+            timer->timer_wheel->waiting_timer_count--;
+        }
+
+        /*Codes_SRS_TIMER_WHEEL_01_012: [ timer_wheel_restart shall put the timer in the slot of the tick delay_ms from now and return 0. ]*/
+        schedule_timer(timer->timer_wheel, timer, delay_ms);
+        result = 0;
+    }
+
+    return result;
+}
+
+void timer_wheel_cancel(TIMER_WHEEL_TIMER_HANDLE timer)
+{
+    if (timer == NULL)
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_013: [ If timer is NULL, timer_wheel_cancel shall return. ]*/
+        LogError("Invalid argument: timer=NULL");
+    }
+    else
+    {
+        if (timer->state == TIMER_STATE_WAITING)
+        {
+            /*Codes_SRS_TIMER_WHEEL_01_014: [ If the timer is waiting, timer_wheel_cancel shall take it out of its slot so that its callback is not called. ]*/
+            (void)DList_RemoveEntryList(&timer->slot_entry);
+            timer->timer_wheel->waiting_timer_count--;
+        }
+
+        /*Codes_SRS_TIMER_WHEEL_01_015: [ timer_wheel_cancel shall free the timer. ]*/
+        (void)DList_RemoveEntryList(&timer->all_entry);
+        free(timer);
+    }
+}
+
+void timer_wheel_dowork(TIMER_WHEEL_HANDLE timer_wheel)
+{
+    if (timer_wheel == NULL)
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_016: [ If timer_wheel is NULL, timer_wheel_dowork shall return. ]*/
+        LogError("Invalid argument: timer_wheel=NULL");
+    }
+    else
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_017: [ timer_wheel_dowork shall read the tick counter and run every tick up to the current one. ]*/
+        uint64_t now_tick = get_current_tick(timer_wheel);
+
+        while (timer_wheel->current_tick <= now_tick)
+        {
+            uint64_t next_tick = (timer_wheel->waiting_timer_count == 0) ? (now_tick + 1) : get_next_tick(timer_wheel);
+            if (next_tick > now_tick)
+            {
+                /*Codes_SRS_TIMER_WHEEL_01_018: [ timer_wheel_dowork shall skip the ticks that have no timer to run or to move between levels. ]*/
+                timer_wheel->current_tick = now_tick + 1;
+            }
+            else
+            {
+                /*Codes_SRS_TIMER_WHEEL_01_019: [ When the ticks of a level come round, timer_wheel_dowork shall move the timers of the next slot of the level above to the level below. ]*/
+                timer_wheel->current_tick = next_tick;
+                run_current_tick(timer_wheel);
+            }
+        }
+    }
+}
+
+int timer_wheel_get_wait_ms(TIMER_WHEEL_HANDLE timer_wheel, uint32_t* wait_ms)
+{
+    int result;
+
+    if ((timer_wheel == NULL) || (wait_ms == NULL))
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_021: [ If timer_wheel or wait_ms is NULL, timer_wheel_get_wait_ms shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: timer_wheel=%p, wait_ms=%p", timer_wheel, wait_ms);
+        result = __FAILURE__;
+    }
+    else if (timer_wheel->waiting_timer_count == 0)
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_022: [ If no timer is waiting, timer_wheel_get_wait_ms shall set wait_ms to TIMER_WHEEL_WAIT_INFINITE and return 0. ]*/
+        *wait_ms = TIMER_WHEEL_WAIT_INFINITE;
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_TIMER_WHEEL_01_023: [ Otherwise timer_wheel_get_wait_ms shall set wait_ms to the time until the first tick that has a timer to run or to move between levels, 0 if that tick has come, and return 0. ]*/
+        uint64_t now_tick = get_current_tick(timer_wheel);
+        uint64_t next_tick = get_next_tick(timer_wheel);
+        if (next_tick <= now_tick)
+        {
+            *wait_ms = 0;
+        }
+        else
+        {
+            /*the next tick is at most a uint32_t delay away, unless a callback asks while its timers are detached*/
+            uint64_t wait = (next_tick - now_tick > UINT32_MAX) ? UINT32_MAX : (next_tick * timer_wheel->tick_ms - timer_wheel->elapsed_ms);
+            *wait_ms = (wait >= TIMER_WHEEL_WAIT_INFINITE) ? (TIMER_WHEEL_WAIT_INFINITE - 1) : (uint32_t)wait;
+        }
+        result = 0;
+    }
+
+    return result;
+}
@@ -0,0 +1,955 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+/* syscall, ftruncate and mmap are not declared in strict C99 mode */
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include "windows.h"
+#else
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
+
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/trace_logger.h"
+#include "azure_c_shared_utility/json_writer.h"
+#include "azure_c_shared_utility/log_arguments.h"
+#include "azure_c_shared_utility/optimize_size.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+// Include the platform-specific file that defines atomic functionality
+#include "queue_atomic_os.h"
+
+DEFINE_ENUM_STRINGS(TRACE_LOGGER_DECODE_FORMAT, TRACE_LOGGER_DECODE_FORMAT_VALUES);
+
+/*
+ * The file is a TRACE_FILE_HEADER, a string table and a ring of TRACE_RECORDs, all written in
+ * place through the mapping. A logging thread takes the next sequence number, claims the record
+ * it maps to by swapping its sequence for TRACE_RECORD_BUSY, fills it and stores sequence + 1 in
+ * it; a record still busy from a thread a whole lap behind is not overwritten, the new one is
+ * dropped and counted instead. Strings are added to the table the first time their address is
+ * seen (a small lock-free set of addresses remembers which were), keyed by that address.
+ *
+ * The arguments are stored by log_arguments_capture, in the order the conversions of the format
+ * string consume them, and the decoder renders the message from them with log_arguments_format.
+ *
+ * Everything is in the byte order and with the size_t of the process that wrote the file, which
+ * the decoder checks.
+ */
+#define TRACE_FILE_MAGIC                "AZTRACE"
+#define TRACE_FILE_VERSION              1
+#define TRACE_RECORD_BUSY               ((size_t)-1)
+#define TRACE_RECORD_TRUNCATED          0x01
+#define TRACE_LOGGER_RUNNING            (((size_t)-1 >> 1) + 1)
+#define TRACE_STRING_CACHE_SIZE         1024
+#define TRACE_STRING_CACHE_PROBES       8
+#define TRACE_MESSAGE_SIZE              1024
+
+#if !defined(NO_TRACE_LOGGER_THREAD_LOCAL) && defined(_MSC_VER)
+#define TRACE_LOGGER_THREAD_LOCAL __declspec(thread)
+#elif !defined(NO_TRACE_LOGGER_THREAD_LOCAL) && (defined(__GNUC__) || defined(__clang__))
+#define TRACE_LOGGER_THREAD_LOCAL __thread
+#endif
+
+typedef struct TRACE_FILE_HEADER_TAG
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t pointer_size;
+    uint32_t record_size;
+    uint32_t record_count;
+    uint64_t string_table_offset;
+    uint64_t string_table_size;
+    uint64_t records_offset;
+    uint64_t ticks_per_second;
+    uint64_t start_ticks;
+    QUEUE_ATOMIC_TYPE(size_t) string_table_used;
+    QUEUE_ATOMIC_TYPE(size_t) next_sequence;
+    QUEUE_ATOMIC_TYPE(size_t) dropped;
+} TRACE_FILE_HEADER;
+
+typedef struct TRACE_STRING_TAG
+{
+    /*address of the string in the process that logged it, written last*/
+    uint64_t key;
+    uint32_t length;
+    uint32_t reserved;
+    /*length characters and a '\0'*/
+    char text[8];
+} TRACE_STRING;
+
+#define TRACE_STRING_FIXED_SIZE offsetof(TRACE_STRING, text)
+
+typedef struct TRACE_RECORD_TAG
+{
+    /*0 if never written, TRACE_RECORD_BUSY while written, the sequence number + 1 once written*/
+    QUEUE_ATOMIC_TYPE(size_t) sequence;
+    uint64_t timestamp;
+    uint64_t thread_id;
+    uint64_t format;
+    uint64_t file;
+    uint64_t func;
+    int32_t line;
+    uint8_t log_category;
+    uint8_t options;
+    uint8_t flags;
+    uint8_t reserved;
+    uint16_t arguments_size;
+    unsigned char arguments[TRACE_LOGGER_RECORD_SIZE - 64];
+} TRACE_RECORD;
+
+typedef struct MAPPED_FILE_TAG
+{
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+    void* base;
+    size_t size;
+} MAPPED_FILE;
+
+typedef struct TRACE_LOGGER_TAG
+{
+    MAPPED_FILE mapped_file;
+    TRACE_FILE_HEADER* header;
+    unsigned char* strings;
+    TRACE_RECORD* records;
+    size_t mask;
+    QUEUE_ATOMIC_TYPE(size_t)* string_cache;
+    LOGGER_LOG previous_log_function;
+    /*the threads inside trace_logger_log, plus TRACE_LOGGER_RUNNING while the logger runs*/
+    QUEUE_ATOMIC_TYPE(size_t) producers;
+} TRACE_LOGGER;
+
+static TRACE_LOGGER trace_logger;
+
+/* platform */
+
+#ifdef _WIN32
+static int map_file(MAPPED_FILE* mapped_file, const char* path, size_t size)
+{
+    int result;
+    if ((mapped_file->file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE)
+    {
+        LogError("CreateFileA failed for %s with error %lu", path, (unsigned long)GetLastError());
+        result = __FAILURE__;
+    }
+    else if ((mapped_file->mapping = CreateFileMappingA(mapped_file->file, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, NULL)) == NULL)
+    {
+        LogError("CreateFileMappingA failed with error %lu", (unsigned long)GetLastError());
+        (void)CloseHandle(mapped_file->file);
+        result = __FAILURE__;
+    }
+    else if ((mapped_file->base = MapViewOfFile(mapped_file->mapping, FILE_MAP_ALL_ACCESS, 0, 0, size)) == NULL)
+    {
+        LogError("MapViewOfFile failed with error %lu", (unsigned long)GetLastError());
+        (void)CloseHandle(mapped_file->mapping);
+        (void)CloseHandle(mapped_file->file);
+        result = __FAILURE__;
+    }
+    else
+    {
+        mapped_file->size = size;
+        result = 0;
+    }
+
+    return result;
+}
+
+static void unmap_file(MAPPED_FILE* mapped_file)
+{
+    (void)FlushViewOfFile(mapped_file->base, mapped_file->size);
+    (void)UnmapViewOfFile(mapped_file->base);
+    (void)CloseHandle(mapped_file->mapping);
+    (void)CloseHandle(mapped_file->file);
+}
+
+static uint64_t get_ticks_per_second(void)
+{
+    LARGE_INTEGER frequency;
+    return QueryPerformanceFrequency(&frequency) ? (uint64_t)frequency.QuadPart : 0;
+}
+
+static uint64_t get_ticks(void)
+{
+    LARGE_INTEGER counter;
+    return QueryPerformanceCounter(&counter) ? (uint64_t)counter.QuadPart : 0;
+}
+
+static uint64_t get_thread_id(void)
+{
+    return (uint64_t)GetCurrentThreadId();
+}
+#else
+static int map_file(MAPPED_FILE* mapped_file, const char* path, size_t size)
+{
+    int result;
+    if ((mapped_file->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+    {
+        LogError("open failed for %s", path);
+        result = __FAILURE__;
+    }
+    else if (ftruncate(mapped_file->fd, (off_t)size) != 0)
+    {
+        LogError("ftruncate failed for %lu bytes", (unsigned long)size);
+        (void)close(mapped_file->fd);
+        result = __FAILURE__;
+    }
+    else if ((mapped_file->base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, mapped_file->fd, 0)) == MAP_FAILED)
+    {
+        LogError("mmap failed for %lu bytes", (unsigned long)size);
+        (void)close(mapped_file->fd);
+        result = __FAILURE__;
+    }
+    else
+    {
+        mapped_file->size = size;
+        result = 0;
+    }
+
+    return result;
+}
+
+static void unmap_file(MAPPED_FILE* mapped_file)
+{
+    (void)munmap(mapped_file->base, mapped_file->size);
+    (void)close(mapped_file->fd);
+}
+
+static uint64_t get_ticks_per_second(void)
+{
+    return 1000000000;
+}
+
+static uint64_t get_ticks(void)
+{
+    struct timespec now;
+    return (clock_gettime(CLOCK_MONOTONIC, &now) == 0) ? ((uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec) : 0;
+}
+
+#if defined(__linux__) && defined(TRACE_LOGGER_THREAD_LOCAL)
+/*gettid is a system call, so each thread asks once*/
+static TRACE_LOGGER_THREAD_LOCAL uint64_t current_thread_id;
+
+static uint64_t get_thread_id(void)
+{
+    if (current_thread_id == 0)
+    {
+        current_thread_id = (uint64_t)syscall(SYS_gettid);
+    }
+    return current_thread_id;
+}
+#elif defined(__linux__)
+static uint64_t get_thread_id(void)
+{
+    return (uint64_t)syscall(SYS_gettid);
+}
+#else
+static uint64_t get_thread_id(void)
+{
+    return (uint64_t)(uintptr_t)pthread_self();
+}
+#endif
+#endif
+
+/* capturing */
+
+static size_t add(QUEUE_ATOMIC_TYPE(size_t)* counter, size_t value)
+{
+    size_t current = QUEUE_ATOMIC_LOAD(size_t, *counter);
+    int added = 0;
+    while (!added)
+    {
+        QUEUE_ATOMIC_COMPARE_EXCHANGE(size_t, *counter, current, current + value, added);
+        if (!added)
+        {
+            current = QUEUE_ATOMIC_LOAD(size_t, *counter);
+        }
+    }
+
+    return current;
+}
+
+static bool enter_producer(void)
+{
+    size_t current = QUEUE_ATOMIC_LOAD(size_t, trace_logger.producers);
+    int entered = 0;
+    while (((current & TRACE_LOGGER_RUNNING) != 0) && !entered)
+    {
+        QUEUE_ATOMIC_COMPARE_EXCHANGE(size_t, trace_logger.producers, current, current + 1, entered);
+        if (!entered)
+        {
+            current = QUEUE_ATOMIC_LOAD(size_t, trace_logger.producers);
+        }
+    }
+
+    return entered != 0;
+}
+
+static void add_string(uint64_t key, const char* text)
+{
+    size_t length = strlen(text);
+    size_t string_table_size = (size_t)trace_logger.header->string_table_size;
+    size_t entry_size = (TRACE_STRING_FIXED_SIZE + length + 1 + 7) & ~(size_t)7;
+    size_t used = QUEUE_ATOMIC_LOAD(size_t, trace_logger.header->string_table_used);
+    int reserved = 0;
+
+    /*strings that do not fit anymore are decoded as their address*/
+    while (!reserved && (length <= UINT32_MAX) && (entry_size <= string_table_size - used))
+    {
+        QUEUE_ATOMIC_COMPARE_EXCHANGE(size_t, trace_logger.header->string_table_used, used, used + entry_size, reserved);
+        if (!reserved)
+        {
+            used = QUEUE_ATOMIC_LOAD(size_t, trace_logger.header->string_table_used);
+        }
+    }
+
+    if (reserved)
+    {
+        TRACE_STRING* entry = (TRACE_STRING*)(trace_logger.strings + used);
+        entry->length = (uint32_t)length;
+        entry->reserved = 0;
+        (void)memcpy(entry->text, text, length + 1);
+        entry->key = key;
+    }
+}
+
+/*adds text to the string table unless its address was already seen*/
+static void intern_string(const char* text)
+{
+    if (text != NULL)
+    {
+        size_t key = (size_t)text;
+        size_t index = (key >> 3) ^ (key >> 13);
+        size_t probe = 0;
+        bool known = false;
+        bool owned = false;
+
+        while (!known && !owned && (probe < TRACE_STRING_CACHE_PROBES))
+        {
+            QUEUE_ATOMIC_TYPE(size_t)* slot = &trace_logger.string_cache[(index + probe) & (TRACE_STRING_CACHE_SIZE - 1)];
+            size_t current = QUEUE_ATOMIC_LOAD(size_t, *slot);
+            if (current == key)
+            {
+                known = true;
+            }
+            else if (current == 0)
+            {
+                /*when another thread takes the slot first, the slot is looked at again*/
+                int taken;
+                QUEUE_ATOMIC_COMPARE_EXCHANGE(size_t, *slot, 0, key, taken);
+                owned = (taken != 0);
+            }
+            else
+            {
+                probe++;
+            }
+        }
+
+        /*with the set full, a string may be added more than once, which the decoder does not mind*/
+        if (!known)
+        {
+            add_string((uint64_t)key, text);
+        }
+    }
+}
+
+#if defined(__GNUC__)
+__attribute__ ((format (printf, 6, 7)))
+#endif
+void trace_logger_log(LOG_CATEGORY log_category, const char* file, const char* func, int line, unsigned int options, const char* format, ...)
+{
+    if (!enter_producer())
+    {
+        /* Codes_SRS_TRACE_LOGGER_01_011: [ If the logger is not running, trace_logger_log shall return. ]*/
+    }
+    else
+    {
+        size_t sequence = add(&trace_logger.header->next_sequence, 1);
+        TRACE_RECORD* record = &trace_logger.records[sequence & trace_logger.mask];
+        size_t previous = QUEUE_ATOMIC_LOAD(size_t, record->sequence);
+        int claimed = 0;
+
+        if (previous != TRACE_RECORD_BUSY)
+        {
+            QUEUE_ATOMIC_COMPARE_EXCHANGE(size_t, record->sequence, previous, TRACE_RECORD_BUSY, claimed);
+        }
+
+        if (!claimed)
+        {
+            /* Codes_SRS_TRACE_LOGGER_01_012: [ If the record the sequence number maps to is still being written by a thread a whole lap behind, trace_logger_log shall count the record as dropped and return. ]*/
+            (void)add(&trace_logger.header->dropped, 1);
+        }
+        else
+        {
+            LOG_ARGUMENTS arguments;
+            va_list args;
+
+            /* Codes_SRS_TRACE_LOGGER_01_013: [ trace_logger_log shall store the timestamp, the id of the calling thread, log_category, options, line and the addresses of format, file and func in the record. ]*/
+            record->timestamp = get_ticks();
+            record->thread_id = get_thread_id();
+            record->format = (uint64_t)(uintptr_t)format;
+            record->file = (uint64_t)(uintptr_t)file;
+            record->func = (uint64_t)(uintptr_t)func;
+            record->line = (int32_t)line;
+            record->log_category = (uint8_t)log_category;
+            record->options = (uint8_t)options;
+
+            /* Codes_SRS_TRACE_LOGGER_01_014: [ trace_logger_log shall store the arguments the conversions of format consume without formatting them, cutting strings and dropping the arguments that do not fit. ]*/
+            arguments.buffer = record->arguments;
+            arguments.size = sizeof(record->arguments);
+            arguments.used = 0;
+            arguments.truncated = false;
+            if (format != NULL)
+            {
+                va_start(args, format);
+                log_arguments_capture(&arguments, format, args);
+                va_end(args);
+            }
+            record->arguments_size = (uint16_t)arguments.used;
+            record->flags = arguments.truncated ? TRACE_RECORD_TRUNCATED : 0;
+
+            /* Codes_SRS_TRACE_LOGGER_01_015: [ trace_logger_log shall add format, file and func to the string table the first time it sees each of their addresses. ]*/
+            intern_string(format);
+            intern_string(file);
+            intern_string(func);
+
+            /* Codes_SRS_TRACE_LOGGER_01_016: [ trace_logger_log shall then mark the record as written with its sequence number. ]*/
+            QUEUE_ATOMIC_STORE(size_t, record->sequence, sequence + 1);
+        }
+
+        (void)add(&trace_logger.producers, (size_t)-1);
+    }
+}
+
+int trace_logger_start(const char* path, size_t record_count, size_t string_table_size)
+{
+    int result;
+    size_t header_size = (sizeof(TRACE_FILE_HEADER) + 63) & ~(size_t)63;
+
+    if ((path == NULL) || (record_count == 0) || (record_count > UINT32_MAX / 2) ||
+        (string_table_size < TRACE_STRING_FIXED_SIZE) || (string_table_size > SIZE_MAX / 4) ||
+        (record_count > (SIZE_MAX / 4) / sizeof(TRACE_RECORD)))
+    {
+        /* Codes_SRS_TRACE_LOGGER_01_001: [ If path is NULL, record_count is 0 or string_table_size cannot hold a string, or the file would be too large, trace_logger_start shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: path=%s, record_count=%lu, string_table_size=%lu", (path == NULL) ? "NULL" : path, (unsigned long)record_count, (unsigned long)string_table_size);
+        result = __FAILURE__;
+    }
+    else if (trace_logger.header != NULL)
+    {
+        /* Codes_SRS_TRACE_LOGGER_01_002: [ If the logger is already started, trace_logger_start shall fail and return a non-zero value. ]*/
+        LogError("trace_logger is already started");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /* Codes_SRS_TRACE_LOGGER_01_003: [ trace_logger_start shall create or truncate the file at path and map a header, a string table of string_table_size bytes and a ring of record_count records rounded up to a power of 2. ]*/
+        size_t rounded_count = 1;
+        size_t strings_size = (string_table_size + 63) & ~(size_t)63;
+        while (rounded_count < record_count)
+        {
+            rounded_count *= 2;
+        }
+
+        if ((trace_logger.string_cache = (QUEUE_ATOMIC_TYPE(size_t)*)calloc(TRACE_STRING_CACHE_SIZE, sizeof(QUEUE_ATOMIC_TYPE(size_t)))) == NULL)
+        {
+            /* Codes_SRS_TRACE_LOGGER_01_006: [ If any error occurs, trace_logger_start shall free what it allocated and return a non-zero value. ]*/
+            LogError("Cannot allocate the string cache");
+            result = __FAILURE__;
+        }
+        else if (map_file(&trace_logger.mapped_file, path, header_size + strings_size + rounded_count * sizeof(TRACE_RECORD)) != 0)
+        {
+            LogError("Cannot map %s", path);
+            free((void*)trace_logger.string_cache);
+            trace_logger.string_cache = NULL;
+            result = __FAILURE__;
+        }
+        else
+        {
+            /* Codes_SRS_TRACE_LOGGER_01_004: [ trace_logger_start shall write in the header what the decoder needs to check and read the file. ]*/
+            TRACE_FILE_HEADER* header = (TRACE_FILE_HEADER*)trace_logger.mapped_file.base;
+            (void)memcpy(header->magic, TRACE_FILE_MAGIC, sizeof(header->magic));
+            header->version = TRACE_FILE_VERSION;
+            header->pointer_size = (uint32_t)sizeof(size_t);
+            header->record_size = (uint32_t)sizeof(TRACE_RECORD);
+            header->record_count = (uint32_t)rounded_count;
+            header->string_table_offset = header_size;
+            header->string_table_size = string_table_size;
+            header->records_offset = header_size + strings_size;
+            header->ticks_per_second = get_ticks_per_second();
+            header->start_ticks = get_ticks();
+            QUEUE_ATOMIC_INIT(size_t, header->string_table_used, 0);
+            QUEUE_ATOMIC_INIT(size_t, header->next_sequence, 0);
+            QUEUE_ATOMIC_INIT(size_t, header->dropped, 0);
+
+            trace_logger.header = header;
+            trace_logger.strings = (unsigned char*)header + header_size;
+            trace_logger.records = (TRACE_RECORD*)((unsigned char*)header + header_size + strings_size);
+            trace_logger.mask = rounded_count - 1;
+            QUEUE_ATOMIC_STORE(size_t, trace_logger.producers, TRACE_LOGGER_RUNNING);
+
+            /* Codes_SRS_TRACE_LOGGER_01_005: [ trace_logger_start shall install trace_logger_log with xlogging_set_log_function and return 0. ]*/
+            trace_logger.previous_log_function = xlogging_get_log_function();
+            xlogging_set_log_function(trace_logger_log);
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+void trace_logger_stop(void)
+{
+    if (trace_logger.header == NULL)
+    {
+        /* Codes_SRS_TRACE_LOGGER_01_007: [ If the logger is not started, trace_logger_stop shall return. ]*/
+        LogError("trace_logger is not started");
+    }
+    else
+    {
+        size_t current = QUEUE_ATOMIC_LOAD(size_t, trace_logger.producers);
+        int stopped = 0;
+
+        /* Codes_SRS_TRACE_LOGGER_01_008: [ trace_logger_stop shall put back the log function that was installed before trace_logger_start. ]*/
+        xlogging_set_log_function(trace_logger.previous_log_function);
+
+        /* Codes_SRS_TRACE_LOGGER_01_009: [ trace_logger_stop shall make trace_logger_log ignore calls that start after this point and wait for the calls in progress to return. ]*/
+        while (!stopped)
+        {
+            QUEUE_ATOMIC_COMPARE_EXCHANGE(size_t, trace_logger.producers, current, current & ~TRACE_LOGGER_RUNNING, stopped);
+            if (!stopped)
+            {
+                current = QUEUE_ATOMIC_LOAD(size_t, trace_logger.producers);
+            }
+        }
+
+        while (QUEUE_ATOMIC_LOAD(size_t, trace_logger.producers) != 0)
+        {
+            ThreadAPI_Sleep(1);
+        }
+
+        /* Codes_SRS_TRACE_LOGGER_01_010: [ trace_logger_stop shall unmap and close the file and free the string cache. ]*/
+        unmap_file(&trace_logger.mapped_file);
+        free((void*)trace_logger.string_cache);
+        trace_logger.string_cache = NULL;
+        trace_logger.header = NULL;
+    }
+}
+
+/* decoding */
+
+typedef struct DECODED_STRING_TAG
+{
+    uint64_t key;
+    const char* text;
+} DECODED_STRING;
+
+typedef struct TRACE_FILE_TAG
+{
+    unsigned char* content;
+    const TRACE_FILE_HEADER* header;
+    DECODED_STRING* strings;
+    size_t string_count;
+    const TRACE_RECORD** records;
+    size_t record_count;
+} TRACE_FILE;
+
+static int compare_strings(const void* left, const void* right)
+{
+    uint64_t left_key = ((const DECODED_STRING*)left)->key;
+    uint64_t right_key = ((const DECODED_STRING*)right)->key;
+    return (left_key < right_key) ? -1 : ((left_key > right_key) ? 1 : 0);
+}
+
+static int compare_records(const void* left, const void* right)
+{
+    size_t left_sequence = QUEUE_ATOMIC_LOAD(size_t, (*(TRACE_RECORD* const*)left)->sequence);
+    size_t right_sequence = QUEUE_ATOMIC_LOAD(size_t, (*(TRACE_RECORD* const*)right)->sequence);
+    return (left_sequence < right_sequence) ? -1 : ((left_sequence > right_sequence) ? 1 : 0);
+}
+
+static const char* find_string(const TRACE_FILE* trace_file, uint64_t key)
+{
+    DECODED_STRING wanted;
+    const DECODED_STRING* found;
+    wanted.key = key;
+    wanted.text = NULL;
+    found = (trace_file->string_count == 0) ? NULL : (const DECODED_STRING*)bsearch(&wanted, trace_file->strings, trace_file->string_count, sizeof(DECODED_STRING), compare_strings);
+    return (found == NULL) ? NULL : found->text;
+}
+
+static unsigned char* read_file(const char* path, size_t* size)
+{
+    unsigned char* result = NULL;
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        LogError("Cannot open %s", path);
+    }
+    else
+    {
+        long file_size;
+        if ((fseek(file, 0, SEEK_END) != 0) || ((file_size = ftell(file)) < 0) || (fseek(file, 0, SEEK_SET) != 0))
+        {
+            LogError("Cannot get the size of %s", path);
+        }
+        else if ((result = (unsigned char*)malloc((size_t)file_size + 1)) == NULL)
+        {
+            LogError("Cannot allocate %ld bytes", file_size);
+        }
+        else if (fread(result, 1, (size_t)file_size, file) != (size_t)file_size)
+        {
+            LogError("Cannot read %s", path);
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            *size = (size_t)file_size;
+        }
+        (void)fclose(file);
+    }
+
+    return result;
+}
+
+/*checks every offset and size in the header against the size of the file*/
+static bool is_valid_header(const TRACE_FILE_HEADER* header, size_t file_size)
+{
+    return (memcmp(header->magic, TRACE_FILE_MAGIC, sizeof(header->magic)) == 0) &&
+        (header->version == TRACE_FILE_VERSION) &&
+        (header->pointer_size == sizeof(size_t)) &&
+        (header->record_size == sizeof(TRACE_RECORD)) &&
+        (header->string_table_offset >= sizeof(TRACE_FILE_HEADER)) &&
+        (header->string_table_offset <= file_size) &&
+        (header->string_table_size <= file_size - header->string_table_offset) &&
+        (header->records_offset >= header->string_table_offset + header->string_table_size) &&
+        (header->records_offset <= file_size) &&
+        (header->record_count <= (file_size - header->records_offset) / sizeof(TRACE_RECORD)) &&
+        (QUEUE_ATOMIC_LOAD(size_t, ((TRACE_FILE_HEADER*)header)->string_table_used) <= header->string_table_size);
+}
+
+static int load_trace_file(TRACE_FILE* trace_file, const char* path)
+{
+    int result;
+    size_t file_size = 0;
+
+    trace_file->strings = NULL;
+    trace_file->records = NULL;
+    if ((trace_file->content = read_file(path, &file_size)) == NULL)
+    {
+        result = __FAILURE__;
+    }
+    else if ((file_size < sizeof(TRACE_FILE_HEADER)) || !is_valid_header((const TRACE_FILE_HEADER*)trace_file->content, file_size))
+    {
+        LogError("%s is not a trace file this build can read", path);
+        result = __FAILURE__;
+    }
+    else
+    {
+        const TRACE_FILE_HEADER* header = (const TRACE_FILE_HEADER*)trace_file->content;
+        const unsigned char* strings = trace_file->content + header->string_table_offset;
+        size_t used = QUEUE_ATOMIC_LOAD(size_t, ((TRACE_FILE_HEADER*)header)->string_table_used);
+        const TRACE_RECORD* records = (const TRACE_RECORD*)(trace_file->content + header->records_offset);
+
+        trace_file->header = header;
+        trace_file->string_count = 0;
+        trace_file->record_count = 0;
+
+        if (((trace_file->strings = (DECODED_STRING*)malloc((used / TRACE_STRING_FIXED_SIZE + 1) * sizeof(DECODED_STRING))) == NULL) ||
+            ((trace_file->records = (const TRACE_RECORD**)malloc(((size_t)header->record_count + 1) * sizeof(TRACE_RECORD*))) == NULL))
+        {
+            LogError("Cannot allocate the index of %s", path);
+            result = __FAILURE__;
+        }
+        else
+        {
+            size_t offset = 0;
+            size_t i;
+            bool complete = true;
+
+            /*a string the process did not finish writing ends the table*/
+            while (complete && (used - offset >= TRACE_STRING_FIXED_SIZE))
+            {
+                const TRACE_STRING* entry = (const TRACE_STRING*)(strings + offset);
+                size_t entry_size = (TRACE_STRING_FIXED_SIZE + (size_t)entry->length + 1 + 7) & ~(size_t)7;
+                if ((entry->length > used) || (entry_size > used - offset) || (entry->key == 0) || (entry->text[entry->length] != '\0'))
+                {
+                    complete = false;
+                }
+                else
+                {
+                    trace_file->strings[trace_file->string_count].key = entry->key;
+                    trace_file->strings[trace_file->string_count].text = entry->text;
+                    trace_file->string_count++;
+                    offset += entry_size;
+                }
+            }
+            qsort(trace_file->strings, trace_file->string_count, sizeof(DECODED_STRING), compare_strings);
+
+            for (i = 0; i < header->record_count; i++)
+            {
+                size_t sequence = QUEUE_ATOMIC_LOAD(size_t, ((TRACE_RECORD*)&records[i])->sequence);
+                if ((sequence != 0) && (sequence != TRACE_RECORD_BUSY))
+                {
+                    trace_file->records[trace_file->record_count] = &records[i];
+                    trace_file->record_count++;
+                }
+            }
+            qsort((void*)trace_file->records, trace_file->record_count, sizeof(TRACE_RECORD*), compare_records);
+
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static void unload_trace_file(TRACE_FILE* trace_file)
+{
+    free((void*)trace_file->records);
+    free(trace_file->strings);
+    free(trace_file->content);
+}
+
+static const char* category_to_string(uint8_t log_category)
+{
+    return (log_category == AZ_LOG_ERROR) ? "Error" : ((log_category == AZ_LOG_INFO) ? "Info" : "Trace");
+}
+
+static double get_record_time(const TRACE_FILE_HEADER* header, const TRACE_RECORD* record)
+{
+    return ((header->ticks_per_second == 0) || (record->timestamp < header->start_ticks)) ? 0.0 :
+        (double)(record->timestamp - header->start_ticks) / (double)header->ticks_per_second;
+}
+
+static void write_text_record(FILE* output, const TRACE_FILE* trace_file, const TRACE_RECORD* record, const char* message)
+{
+    const char* file = find_string(trace_file, record->file);
+    const char* func = find_string(trace_file, record->func);
+
+    (void)fprintf(output, "%.6f [%llu] %s: ", get_record_time(trace_file->header, record), (unsigned long long)record->thread_id, category_to_string(record->log_category));
+    if (record->log_category == AZ_LOG_ERROR)
+    {
+        (void)fprintf(output, "File:%s Func:%s Line:%d ", (file == NULL) ? "?" : file, (func == NULL) ? "?" : func, (int)record->line);
+    }
+    (void)fprintf(output, "%s\n", message);
+}
+
+static int write_json_arguments(JSON_WRITER_HANDLE writer, const TRACE_RECORD* record)
+{
+    int result = json_writer_begin_array(writer);
+    LOG_ARGUMENTS_READER reader;
+    reader.buffer = record->arguments;
+    reader.size = (record->arguments_size > sizeof(record->arguments)) ? 0 : record->arguments_size;
+    reader.used = 0;
+
+    while ((result == 0) && (reader.used < reader.size))
+    {
+        unsigned char tag = log_arguments_next_tag(&reader);
+        char text[32];
+        int64_t signed_value;
+        uint64_t unsigned_value;
+        double double_value;
+        const char* string_value;
+        size_t length;
+
+        if (log_arguments_get_value(&reader, LOG_ARGUMENT_SIGNED, &signed_value))
+        {
+            result = json_writer_write_int64(writer, signed_value);
+        }
+        else if (log_arguments_get_value(&reader, LOG_ARGUMENT_UNSIGNED, &unsigned_value))
+        {
+            (void)snprintf(text, sizeof(text), "%llu", (unsigned long long)unsigned_value);
+            result = json_writer_write_raw(writer, text);
+        }
+        else if (log_arguments_get_value(&reader, LOG_ARGUMENT_DOUBLE, &double_value))
+        {
+            result = json_writer_write_double(writer, double_value);
+        }
+        else if (log_arguments_get_value(&reader, LOG_ARGUMENT_POINTER, &unsigned_value))
+        {
+            (void)snprintf(text, sizeof(text), "0x%llx", (unsigned long long)unsigned_value);
+            result = json_writer_write_string(writer, text);
+        }
+        else if (log_arguments_get_string(&reader, &string_value, &length))
+        {
+            char* copy = (char*)malloc(length + 1);
+            if (copy == NULL)
+            {
+                result = __FAILURE__;
+            }
+            else
+            {
+                (void)memcpy(copy, string_value, length);
+                copy[length] = '\0';
+                result = json_writer_write_string(writer, copy);
+                free(copy);
+            }
+        }
+        else
+        {
+            LogError("Unknown argument tag %d", (int)tag);
+            result = __FAILURE__;
+        }
+    }
+
+    if (result == 0)
+    {
+        result = json_writer_end_array(writer);
+    }
+
+    return result;
+}
+
+static int write_json_record(FILE* output, JSON_WRITER_HANDLE writer, const TRACE_FILE* trace_file, const TRACE_RECORD* record, const char* message)
+{
+    int result;
+    const char* format = find_string(trace_file, record->format);
+    const char* file = find_string(trace_file, record->file);
+    const char* func = find_string(trace_file, record->func);
+
+    json_writer_reset(writer);
+    if ((json_writer_begin_object(writer) != 0) ||
+        (json_writer_write_key(writer, "sequence") != 0) ||
+        (json_writer_write_int64(writer, (int64_t)QUEUE_ATOMIC_LOAD(size_t, ((TRACE_RECORD*)record)->sequence) - 1) != 0) ||
+        (json_writer_write_key(writer, "time") != 0) ||
+        (json_writer_write_double(writer, get_record_time(trace_file->header, record)) != 0) ||
+        (json_writer_write_key(writer, "thread") != 0) ||
+        (json_writer_write_int64(writer, (int64_t)record->thread_id) != 0) ||
+        (json_writer_write_key(writer, "category") != 0) ||
+        (json_writer_write_string(writer, category_to_string(record->log_category)) != 0) ||
+        (json_writer_write_key(writer, "file") != 0) ||
+        ((file == NULL) ? json_writer_write_null(writer) : json_writer_write_string(writer, file)) != 0 ||
+        (json_writer_write_key(writer, "func") != 0) ||
+        ((func == NULL) ? json_writer_write_null(writer) : json_writer_write_string(writer, func)) != 0 ||
+        (json_writer_write_key(writer, "line") != 0) ||
+        (json_writer_write_int64(writer, record->line) != 0) ||
+        (json_writer_write_key(writer, "format") != 0) ||
+        ((format == NULL) ? json_writer_write_null(writer) : json_writer_write_string(writer, format)) != 0 ||
+        (json_writer_write_key(writer, "arguments") != 0) ||
+        (write_json_arguments(writer, record) != 0) ||
+        (json_writer_write_key(writer, "message") != 0) ||
+        (json_writer_write_string(writer, message) != 0) ||
+        (json_writer_end_object(writer) != 0))
+    {
+        LogError("Cannot write record as JSON");
+        result = __FAILURE__;
+    }
+    else
+    {
+        (void)fprintf(output, "%s\n", json_writer_get_string(writer));
+        result = 0;
+    }
+
+    return result;
+}
+
+int trace_logger_decode(const char* path, FILE* output, TRACE_LOGGER_DECODE_FORMAT format)
+{
+    int result;
+    TRACE_FILE trace_file;
+    JSON_WRITER_HANDLE writer = NULL;
+
+    if ((path == NULL) || (output == NULL) || ((format != TRACE_LOGGER_DECODE_TEXT) && (format != TRACE_LOGGER_DECODE_JSON)))
+    {
+        /* Codes_SRS_TRACE_LOGGER_01_017: [ If path or output is NULL or format is not a TRACE_LOGGER_DECODE_FORMAT, trace_logger_decode shall fail and return a non-zero value. ]*/
+        LogError("Invalid argument: path=%p, output=%p, format=%d", path, output, (int)format);
+        result = __FAILURE__;
+    }
+    else if ((format == TRACE_LOGGER_DECODE_JSON) && ((writer = json_writer_create(256)) == NULL))
+    {
+        /* Codes_SRS_TRACE_LOGGER_01_019: [ If any error occurs, trace_logger_decode shall fail and return a non-zero value. ]*/
+        LogError("json_writer_create failed");
+        result = __FAILURE__;
+    }
+    else if (load_trace_file(&trace_file, path) != 0)
+    {
+        /* Codes_SRS_TRACE_LOGGER_01_018: [ If the file cannot be read, is not a trace file or was written by a process with another pointer size or record size, trace_logger_decode shall fail and return a non-zero value. ]*/
+        unload_trace_file(&trace_file);
+        if (writer != NULL)
+        {
+            json_writer_destroy(writer);
+        }
+        result = __FAILURE__;
+    }
+    else
+    {
+        size_t i;
+        size_t dropped = QUEUE_ATOMIC_LOAD(size_t, ((TRACE_FILE_HEADER*)trace_file.header)->dropped);
+        char message[TRACE_MESSAGE_SIZE];
+
+        result = 0;
+
+        /* Codes_SRS_TRACE_LOGGER_01_020: [ trace_logger_decode shall write the records in the order they were logged, one per line, rendering the message from the stored format string and arguments. ]*/
+        for (i = 0; (i < trace_file.record_count) && (result == 0); i++)
+        {
+            const TRACE_RECORD* record = trace_file.records[i];
+            const char* record_format = find_string(&trace_file, record->format);
+            if (record_format == NULL)
+            {
+                /*the string table was full: all there is of the format is its address*/
+                (void)snprintf(message, sizeof(message), "<format 0x%llx>", (unsigned long long)record->format);
+            }
+            else
+            {
+                (void)log_arguments_format(message, sizeof(message), record_format, record->arguments,
+                    (record->arguments_size > sizeof(record->arguments)) ? 0 : record->arguments_size,
+                    (record->flags & TRACE_RECORD_TRUNCATED) != 0);
+            }
+
+            if (format == TRACE_LOGGER_DECODE_TEXT)
+            {
+                /* Codes_SRS_TRACE_LOGGER_01_021: [ As text, each record shall be written as its time in seconds since trace_logger_start, its thread id and the message in the format of consolelogger_log. ]*/
+                write_text_record(output, &trace_file, record, message);
+            }
+            else
+            {
+                /* Codes_SRS_TRACE_LOGGER_01_022: [ As JSON, each record shall be written as an object with its sequence, time, thread, category, file, func, line, format, arguments and message. ]*/
+                result = write_json_record(output, writer, &trace_file, record, message);
+            }
+        }
+
+        if ((result == 0) && (dropped > 0))
+        {
+            /* Codes_SRS_TRACE_LOGGER_01_023: [ If records were dropped, trace_logger_decode shall write how many after the records. ]*/
+            if (format == TRACE_LOGGER_DECODE_TEXT)
+            {
+                (void)fprintf(output, "trace_logger dropped %lu records\n", (unsigned long)dropped);
+            }
+            else
+            {
+                (void)fprintf(output, "{\"dropped\":%lu}\n", (unsigned long)dropped);
+            }
+        }
+
+        unload_trace_file(&trace_file);
+        if (writer != NULL)
+        {
+            json_writer_destroy(writer);
+        }
+    }
+
+    return result;
+}
@@ -3,219 +3,406 @@
 
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/urlencode.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/strings.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
+#include "azure_c_shared_utility/optimize_size.h"
 
-#define NIBBLE_TO_STRING(c) (char)((c) < 10 ? (c) + '0' : (c) - 10 + 'a')
-#define NIBBLE_FROM_STRING(c) (char)(ISDIGIT(c) ? (c) - '0' : TOUPPER(c) + 10 - 'A')
-#define IS_HEXDIGIT(c) (            \
-    ((c >= '0') && (c <= '9')) ||   \
-    ((c >= 'A') && (c <= 'F')) ||   \
-    ((c >= 'a') && (c <= 'f'))      \
-)
-#define IS_PRINTABLE(c) (                           \
-    (c == 0) ||                                     \
-    (c == '!') ||                                   \
-    (c == '(') || (c == ')') || (c == '*') ||       \
-    (c == '-') || (c == '.') ||                     \
-    ((c >= '0') && (c <= '9')) ||                   \
-    ((c >= 'A') && (c <= 'Z')) ||                   \
-    (c == '_') ||                                   \
-    ((c >= 'a') && (c <= 'z'))                      \
-)
-
-/*The below macros are to be called on the big nibble of a hex value*/
-#define IS_IN_ASCII_RANGE(c) (  \
-    (c >= '0') && (c <= '7')    \
-)
-#define IS_IN_EXTENDED_ASCII_RANGE(c) ( \
-    ((c >= '8') && (c <= '9')) ||       \
-    ((c >= 'A') && (c <= 'F')) ||       \
-    ((c >= 'a') && (c <= 'f'))          \
-)
-#define IS_IN_CONTINUATION_BYTE_RANGE(c) (  \
-    (c == '8') || (c == '9') ||             \
-    (c == 'A') || (c == 'B') ||             \
-    (c == 'a') || (c == 'b')                \
-)
-#define IS_IN_LEADING_BYTE_RANGE(c) (   \
-    ((c >= 'C') && (c <= 'F')) ||       \
-    ((c >= 'c') && (c <= 'f'))          \
-)
-#define IS_IN_UNSUPPORTED_LEADING_BYTE_RANGE(c) (   \
-    ((c >= 'D') && (c <= 'F')) ||                   \
-    ((c >= 'd') && (c <= 'f'))                      \
-)
-
-static size_t URL_PrintableChar(unsigned char charVal, char* buffer)
+/*characters are classified 16 at a time with SSE2 or NEON, which every x86-64 and AArch64 processor has, and one at a time
+with the tables below otherwise. Define NO_URLENCODE_SIMD to always use the tables.*/
+#if !defined(NO_URLENCODE_SIMD) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))) && (defined(__clang__) || defined(__GNUC__))
+#define URLENCODE_USE_SSE2
+#include <emmintrin.h>
+#elif !defined(NO_URLENCODE_SIMD) && defined(__aarch64__) && (defined(__clang__) || defined(__GNUC__))
+#define URLENCODE_USE_NEON
+#include <arm_neon.h>
+#endif
+
+/*number of characters each byte takes once encoded: unreserved characters are copied, 7-bit characters become %xx and
+the 8-bit ones are taken as Latin-1 and become the 2 byte UTF-8 sequence %c2%xx or %c3%xx*/
+static const unsigned char url_encoded_size[256] =
+{
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 1, 3, 3, 3, 3, 3, 3, 1, 1, 1, 3, 3, 1, 1, 3, /* ! ( ) * - . */
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3, 3, /* 0-9 */
+    3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* A-O */
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 1, /* P-Z _ */
+    3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* a-o */
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3, /* p-z */
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6
+};
+
+/*value of each hexadecimal digit, 0xFF for anything else*/
+#define XX 0xFF
+static const unsigned char url_hex_values[256] =
+{
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, XX, XX, XX, XX, XX, XX,
+    XX, 10, 11, 12, 13, 14, 15, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, 10, 11, 12, 13, 14, 15, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX
+};
+#undef XX
+
+static const char url_hex_digits[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+
+#if defined(URLENCODE_USE_SSE2)
+/*0xFF in the bytes that hold an unreserved character; the compares are signed, so the 8-bit characters are below every range*/
+static __m128i unreservedMask(__m128i c)
 {
-    size_t size;
-    if (IS_PRINTABLE(charVal))
+    __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    __m128i parenthesisOrStar = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('(' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('*' + 1)));
+    __m128i dashOrDot = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('-' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('.' + 1)));
+    __m128i other = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('!')), _mm_cmpeq_epi8(c, _mm_set1_epi8('_')));
+    return _mm_or_si128(_mm_or_si128(letter, digit), _mm_or_si128(_mm_or_si128(parenthesisOrStar, dashOrDot), other));
+}
+
+/*adds the encoded length of the whole blocks of 16 at the start of text to encodedLength and returns the number of bytes in them*/
+static size_t blocksEncodedLength(const unsigned char* text, size_t length, size_t* encodedLength)
+{
+    size_t pos = 0;
+
+    while (length - pos >= 16)
     {
-        buffer[0] = (char)charVal;
-        size = 1;
+        __m128i c = _mm_loadu_si128((const __m128i*)(text + pos));
+        /*1, 3 or 6 per byte, added up in each half of the block*/
+        __m128i sizes = _mm_add_epi8(_mm_add_epi8(_mm_set1_epi8(1), _mm_andnot_si128(unreservedMask(c), _mm_set1_epi8(2))),
+            _mm_and_si128(_mm_cmplt_epi8(c, _mm_setzero_si128()), _mm_set1_epi8(3)));
+        __m128i sums = _mm_sad_epu8(sizes, _mm_setzero_si128());
+        *encodedLength += (size_t)_mm_cvtsi128_si32(sums) + (size_t)_mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+        pos += 16;
     }
-    else
-    {
-        char bigNibbleStr;
-        char littleNibbleStr;
-        unsigned char bigNibbleVal = charVal >> 4;
-        unsigned char littleNibbleVal = charVal & 0x0F;
 
-        if (bigNibbleVal >= 0x0C)
+    return pos;
+}
+
+/*copies the run of unreserved characters at the start of in to out a block of 16 at a time, while in and out both have 16 bytes
+left, and returns its length. The whole block where the run stops is stored, so bytes of out after the run can change*/
+static size_t copyUnreservedBlocks(const unsigned char* in, size_t inLength, char* out, size_t outLength)
+{
+    size_t run = 0;
+
+    while ((inLength - run >= 16) && (outLength - run >= 16))
+    {
+        __m128i c = _mm_loadu_si128((const __m128i*)(in + run));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(unreservedMask(c));
+        _mm_storeu_si128((__m128i*)(out + run), c);
+        if (mask != 0xFFFF)
         {
-            bigNibbleVal -= 0x04;
+            run += (size_t)__builtin_ctz(~mask);
+            break;
         }
+        run += 16;
+    }
+
+    return run;
+}
+#elif defined(URLENCODE_USE_NEON)
+/*0xFF in the bytes that hold an unreserved character*/
+static uint8x16_t unreservedMask(uint8x16_t c)
+{
+    uint8x16_t lower = vorrq_u8(c, vdupq_n_u8(0x20));
+    uint8x16_t letter = vandq_u8(vcgeq_u8(lower, vdupq_n_u8('a')), vcleq_u8(lower, vdupq_n_u8('z')));
+    uint8x16_t digit = vandq_u8(vcgeq_u8(c, vdupq_n_u8('0')), vcleq_u8(c, vdupq_n_u8('9')));
+    uint8x16_t parenthesisOrStar = vandq_u8(vcgeq_u8(c, vdupq_n_u8('(')), vcleq_u8(c, vdupq_n_u8('*')));
+    uint8x16_t dashOrDot = vandq_u8(vcgeq_u8(c, vdupq_n_u8('-')), vcleq_u8(c, vdupq_n_u8('.')));
+    uint8x16_t other = vorrq_u8(vceqq_u8(c, vdupq_n_u8('!')), vceqq_u8(c, vdupq_n_u8('_')));
+    return vorrq_u8(vorrq_u8(letter, digit), vorrq_u8(vorrq_u8(parenthesisOrStar, dashOrDot), other));
+}
+
+/*adds the encoded length of the whole blocks of 16 at the start of text to encodedLength and returns the number of bytes in them*/
+static size_t blocksEncodedLength(const unsigned char* text, size_t length, size_t* encodedLength)
+{
+    size_t pos = 0;
 
-        bigNibbleStr = NIBBLE_TO_STRING(bigNibbleVal);
-        littleNibbleStr = NIBBLE_TO_STRING(littleNibbleVal);
+    while (length - pos >= 16)
+    {
+        uint8x16_t c = vld1q_u8(text + pos);
+        /*1, 3 or 6 per byte, so the sum of a block fits in a byte*/
+        uint8x16_t sizes = vaddq_u8(vaddq_u8(vdupq_n_u8(1), vbicq_u8(vdupq_n_u8(2), unreservedMask(c))),
+            vandq_u8(vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(c), 7)), vdupq_n_u8(3)));
+        *encodedLength += vaddvq_u8(sizes);
+        pos += 16;
+    }
 
-        buffer[0] = '%';
+    return pos;
+}
 
-        if (charVal < 0x80)
+/*copies the run of unreserved characters at the start of in to out a block of 16 at a time, while in and out both have 16 bytes
+left, and returns its length. The tables find where in its block the run stops*/
+static size_t copyUnreservedBlocks(const unsigned char* in, size_t inLength, char* out, size_t outLength)
+{
+    size_t run = 0;
+
+    while ((inLength - run >= 16) && (outLength - run >= 16))
+    {
+        uint8x16_t c = vld1q_u8(in + run);
+        if (vminvq_u8(unreservedMask(c)) == 0)
         {
-            buffer[1] = bigNibbleStr;
-            buffer[2] = littleNibbleStr;
-            size = 3;
+            break;
         }
-        else
+        vst1q_u8((uint8_t*)(out + run), c);
+        run += 16;
+    }
+
+    return run;
+}
+#else
+static size_t blocksEncodedLength(const unsigned char* text, size_t length, size_t* encodedLength)
+{
+    (void)text;
+    (void)length;
+    (void)encodedLength;
+    return 0;
+}
+
+static size_t copyUnreservedBlocks(const unsigned char* in, size_t inLength, char* out, size_t outLength)
+{
+    (void)in;
+    (void)inLength;
+    (void)out;
+    (void)outLength;
+    return 0;
+}
+#endif
+
+/*length of the run of characters starting at text that are copied as they are*/
+static size_t unreservedRunLength(const unsigned char* text, size_t length)
+{
+    size_t run = 0;
+
+    while ((run + 4 <= length) &&
+        ((url_encoded_size[text[run]] | url_encoded_size[text[run + 1]] | url_encoded_size[text[run + 2]] | url_encoded_size[text[run + 3]]) == 1))
+    {
+        run += 4;
+    }
+    while ((run < length) && (url_encoded_size[text[run]] == 1))
+    {
+        run++;
+    }
+
+    return run;
+}
+
+size_t URL_EncodeLength(const char* text, size_t textLength)
+{
+    size_t result;
+
+    if ((text == NULL) || (textLength > (SIZE_MAX - 1) / 6))
+    {
+        /*Codes_SRS_URL_ENCODE_01_002: [ If text is NULL or textLength is too large for the encoded length to fit in a size_t, URL_EncodeLength shall return 0. ]*/
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_URL_ENCODE_01_001: [ URL_EncodeLength shall return the number of characters in the encoding of the first textLength characters of text, not counting the terminating \0. ]*/
+        const unsigned char* in = (const unsigned char*)text;
+        size_t i;
+
+        result = 0;
+        for (i = blocksEncodedLength(in, textLength, &result); i < textLength; i++)
         {
-            buffer[1] = 'c';
-            buffer[3] = '%';
-            buffer[4] = bigNibbleStr;
-            buffer[5] = littleNibbleStr;
-            if (charVal < 0xC0)
-            {
-                buffer[2] = '2';
-            }
-            else
-            {
-                buffer[2] = '3';
-            }
-            size = 6;
+            result += url_encoded_size[in[i]];
         }
     }
 
-    return size;
+    return result;
 }
 
-static size_t calculateDecodedStringSize(const char* encodedString, size_t len)
+int URL_EncodeInto(const char* text, size_t textLength, char* destination, size_t destinationSize, size_t* encodedLength)
 {
-    size_t decodedSize = 0;
+    int result;
 
-    if (encodedString == NULL)
+    if ((text == NULL) || (destination == NULL) || (encodedLength == NULL))
     {
-        LogError("Null encoded string");
+        /*Codes_SRS_URL_ENCODE_01_003: [ If text, destination or encodedLength is NULL, URL_EncodeInto shall fail and return a non-zero value. ]*/
+        LogError("invalid argument const char* text=%p, char* destination=%p, size_t* encodedLength=%p", text, destination, encodedLength);
+        result = __FAILURE__;
     }
-    else if (len == 0)
+    else if (destinationSize == 0)
     {
-        decodedSize = 1; //for null terminator
+        /*Codes_SRS_URL_ENCODE_01_004: [ If destinationSize is smaller than URL_EncodeLength(text, textLength) + 1, URL_EncodeInto shall fail and return a non-zero value. ]*/
+        LogError("destination buffer too small");
+        result = __FAILURE__;
     }
     else
     {
-        size_t remaining_len = len;
-        size_t next_step = 0;
-        size_t i = 0;
-        while (i < len)
+        const unsigned char* in = (const unsigned char*)text;
+        const unsigned char* end = in + textLength;
+        char* out = destination;
+        char* outEnd = destination + destinationSize - 1; /*reserve room for the \0*/
+
+        result = 0;
+        while ((in < end) && (result == 0))
         {
-            //percent encoded character
-            if (encodedString[i] == '%')
+            size_t run = copyUnreservedBlocks(in, (size_t)(end - in), out, (size_t)(outEnd - out));
+            in += run;
+            out += run;
+            run = unreservedRunLength(in, (size_t)(end - in));
+            if (run > 0)
             {
-                if (remaining_len < 3 || !IS_HEXDIGIT(encodedString[i+1]) || !IS_HEXDIGIT(encodedString[i+2]))
+                if ((size_t)(outEnd - out) < run)
                 {
-                    LogError("Incomplete or invalid percent encoding");
-                    break;
-                }
-                else if (!IS_IN_ASCII_RANGE(encodedString[i+1]))
-                {
-                    LogError("Out of range of characters accepted by this decoder");
-                    break;
+                    result = __FAILURE__;
                 }
                 else
                 {
-                    decodedSize++;
-                    next_step = 3;
+                    (void)memcpy(out, in, run);
+                    out += run;
+                    in += run;
                 }
             }
-            else if (!IS_PRINTABLE(encodedString[i]))
-            {
-                LogError("Unprintable value in encoded string");
-                break;
-            }
-            //safe character
-            else
+            else if (in < end)
             {
-                decodedSize++;
-                next_step = 1;
+                unsigned char c = *in;
+                size_t size = url_encoded_size[c];
+                if ((size_t)(outEnd - out) < size)
+                {
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    if (size == 6)
+                    {
+                        out[0] = '%';
+                        out[1] = 'c';
+                        out[2] = (c < 0xC0) ? '2' : '3';
+                        out += 3;
+                        c = (c < 0xC0) ? c : (unsigned char)(c - 0x40);
+                    }
+                    out[0] = '%';
+                    out[1] = url_hex_digits[c >> 4];
+                    out[2] = url_hex_digits[c & 0x0F];
+                    out += 3;
+                    in++;
+                }
             }
-
-            i += next_step;
-            remaining_len -= next_step;
         }
 
-        if (encodedString[i] != '\0') //i.e. broke out of above loop due to error
+        if (result != 0)
         {
-            decodedSize = 0;
+            /*Codes_SRS_URL_ENCODE_01_004: [ If destinationSize is smaller than URL_EncodeLength(text, textLength) + 1, URL_EncodeInto shall fail and return a non-zero value. ]*/
+            LogError("URL_EncodeInto:: destination buffer too small");
         }
         else
         {
-            decodedSize++; //add space for the null terminator
+            /*Codes_SRS_URL_ENCODE_01_005: [ URL_EncodeInto shall write the encoding of the first textLength characters of text followed by a \0 in destination, set encodedLength to the number of characters before the \0 and return 0. ]*/
+            /*Codes_SRS_URL_ENCODE_01_006: [ Unreserved characters shall be copied, other 7-bit characters shall be encoded as %xx and 8-bit characters shall be taken as Latin-1 and encoded as their UTF-8 sequence %c2%xx or %c3%xx, using lower case hexadecimal digits. ]*/
+            *out = '\0';
+            *encodedLength = (size_t)(out - destination);
         }
     }
-    return decodedSize;
-}
 
-static unsigned char charFromNibbles(char bigNibbleStr, char littleNibbleStr)
-{
-    unsigned char bigNibbleVal = NIBBLE_FROM_STRING(bigNibbleStr);
-    unsigned char littleNibbleVal = NIBBLE_FROM_STRING(littleNibbleStr);
-
-    return bigNibbleVal << 4 | littleNibbleVal;
+    return result;
 }
 
-static void createDecodedString(const char* input, size_t input_size, char* output)
+int URL_DecodeInto(const char* text, size_t textLength, char* destination, size_t destinationSize, size_t* decodedLength)
 {
-    /* Note that there is no danger of reckless indexing here, as calculateDecodedStringSize()
-    has already checked lengths of strings to ensure the formatting is always correct*/
-    size_t i = 0;
-    while (i <= input_size) //the <= instead of < ensures the '\0' will be copied
+    int result;
+
+    if ((text == NULL) || (destination == NULL) || (decodedLength == NULL))
     {
-        if (input[i] != '%')
-        {
-            *output++ = input[i];
-            i++;
-        }
-        else
-        {
-            *output++ = charFromNibbles(input[i+1], input[i+2]);
-            i += 3;
-        }
+        /*Codes_SRS_URL_ENCODE_01_007: [ If text, destination or decodedLength is NULL, URL_DecodeInto shall fail and return a non-zero value. ]*/
+        LogError("invalid argument const char* text=%p, char* destination=%p, size_t* decodedLength=%p", text, destination, decodedLength);
+        result = __FAILURE__;
     }
-}
-
-static size_t URL_PrintableCharSize(unsigned char charVal)
-{
-    size_t size;
-    if (IS_PRINTABLE(charVal))
+    else if (destinationSize == 0)
     {
-        size = 1;
+        /*Codes_SRS_URL_ENCODE_01_011: [ If destinationSize is too small for the decoded text and its \0, URL_DecodeInto shall fail and return a non-zero value. ]*/
+        LogError("destination buffer too small");
+        result = __FAILURE__;
     }
     else
     {
-        if (charVal < 0x80)
+        const unsigned char* in = (const unsigned char*)text;
+        const unsigned char* end = in + textLength;
+        char* out = destination;
+        char* outEnd = destination + destinationSize - 1; /*reserve room for the \0*/
+
+        result = 0;
+        while ((in < end) && (result == 0))
         {
-            size = 3;
+            size_t run = copyUnreservedBlocks(in, (size_t)(end - in), out, (size_t)(outEnd - out));
+            in += run;
+            out += run;
+            run = unreservedRunLength(in, (size_t)(end - in));
+            if (run > 0)
+            {
+                if ((size_t)(outEnd - out) < run)
+                {
+                    LogError("URL_DecodeInto:: destination buffer too small");
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    (void)memcpy(out, in, run);
+                    out += run;
+                    in += run;
+                }
+            }
+            else if (in == end)
+            {
+                /*the blocks ran to the end of text*/
+            }
+            else if (*in != '%')
+            {
+                /*Codes_SRS_URL_ENCODE_01_009: [ If text contains a character that would have been encoded, URL_DecodeInto shall fail and return a non-zero value. ]*/
+                LogError("Unprintable value in encoded string");
+                result = __FAILURE__;
+            }
+            else if ((end - in < 3) || (url_hex_values[in[1]] > 7) || (url_hex_values[in[2]] > 15))
+            {
+                /*Codes_SRS_URL_ENCODE_01_010: [ If a % is not followed by 2 hexadecimal digits encoding a 7-bit character, URL_DecodeInto shall fail and return a non-zero value. ]*/
+                LogError("Incomplete, invalid or out of range percent encoding");
+                result = __FAILURE__;
+            }
+            else if (out == outEnd)
+            {
+                LogError("URL_DecodeInto:: destination buffer too small");
+                result = __FAILURE__;
+            }
+            else
+            {
+                *out++ = (char)((url_hex_values[in[1]] << 4) | url_hex_values[in[2]]);
+                in += 3;
+            }
         }
-        else
+
+        if (result == 0)
         {
-            size = 6;
+            /*Codes_SRS_URL_ENCODE_01_008: [ URL_DecodeInto shall write the decoding of the first textLength characters of text followed by a \0 in destination, set decodedLength to the number of characters before the \0 and return 0. ]*/
+            /*Codes_SRS_URL_ENCODE_01_011: [ If destinationSize is too small for the decoded text and its \0, URL_DecodeInto shall fail and return a non-zero value. ]*/
+            *out = '\0';
+            *decodedLength = (size_t)(out - destination);
         }
     }
-    return size;
+
+    return result;
 }
 
 STRING_HANDLE URL_EncodeString(const char* textEncode)
@@ -227,15 +414,39 @@ STRING_HANDLE URL_EncodeString(const char* textEncode)
     }
     else
     {
-        STRING_HANDLE tempString = STRING_construct(textEncode);
-        if (tempString == NULL)
+        size_t textLength = strlen(textEncode);
+        size_t encodedSize = URL_EncodeLength(textEncode, textLength) + 1;
+        char* encodedURL;
+
+        if ((encodedSize == 1) && (textLength > 0))
         {
+            LogError("URL_EncodeString:: input too large.");
             result = NULL;
         }
+        else if ((encodedURL = (char*)malloc(encodedSize)) == NULL)
+        {
+            /*Codes_SRS_URL_ENCODE_06_002: [If an error occurs during the encoding of input then URL_Encode will return NULL.]*/
+            result = NULL;
+            LogError("URL_Encode:: MALLOC failure on encode.");
+        }
         else
         {
-            result = URL_Encode(tempString);
-            STRING_delete(tempString);
+            size_t encodedLength;
+            if (URL_EncodeInto(textEncode, textLength, encodedURL, encodedSize, &encodedLength) != 0)
+            {
+                LogError("URL_Encode:: encoding failed.");
+                free(encodedURL);
+                result = NULL;
+            }
+            else
+            {
+                result = STRING_new_with_memory(encodedURL);
+                if (result == NULL)
+                {
+                    LogError("URL_Encode:: MALLOC failure on encode.");
+                    free(encodedURL);
+                }
+            }
         }
     }
     return result;
@@ -252,40 +463,8 @@ STRING_HANDLE URL_Encode(STRING_HANDLE input)
     }
     else
     {
-        size_t lengthOfResult = 0;
-        char* encodedURL;
-        const char* currentInput;
-        unsigned char currentUnsignedChar;
-        currentInput = STRING_c_str(input);
         /*Codes_SRS_URL_ENCODE_06_003: [If input is a zero length string then URL_Encode will return a zero length string.]*/
-        do
-        {
-            currentUnsignedChar = (unsigned char)(*currentInput++);
-            lengthOfResult += URL_PrintableCharSize(currentUnsignedChar);
-        } while (currentUnsignedChar != 0);
-        if ((encodedURL = (char*)malloc(lengthOfResult)) == NULL)
-        {
-            /*Codes_SRS_URL_ENCODE_06_002: [If an error occurs during the encoding of input then URL_Encode will return NULL.]*/
-            result = NULL;
-            LogError("URL_Encode:: MALLOC failure on encode.");
-        }
-        else
-        {
-            size_t currentEncodePosition = 0;
-            currentInput = STRING_c_str(input);
-            do
-            {
-                currentUnsignedChar = (unsigned char)(*currentInput++);
-                currentEncodePosition += URL_PrintableChar(currentUnsignedChar, &encodedURL[currentEncodePosition]);
-            } while (currentUnsignedChar != 0);
-
-            result = STRING_new_with_memory(encodedURL);
-            if (result == NULL)
-            {
-                LogError("URL_Encode:: MALLOC failure on encode.");
-                free(encodedURL);
-            }
-        }
+        result = URL_EncodeString(STRING_c_str(input));
     }
     return result;
 }
@@ -299,15 +478,33 @@ STRING_HANDLE URL_DecodeString(const char* textDecode)
     }
     else
     {
-        STRING_HANDLE tempString = STRING_construct(textDecode);
-        if (tempString == NULL)
+        /*the decoded text is never longer than the encoded one*/
+        size_t textLength = strlen(textDecode);
+        char* decodedString;
+
+        if ((decodedString = (char*)malloc(textLength + 1)) == NULL)
         {
+            LogError("URL_Decode:: MALLOC failure on decode.");
             result = NULL;
         }
         else
         {
-            result = URL_Decode(tempString);
-            STRING_delete(tempString);
+            size_t decodedLength;
+            if (URL_DecodeInto(textDecode, textLength, decodedString, textLength + 1, &decodedLength) != 0)
+            {
+                LogError("URL_Decode:: Invalid input string");
+                free(decodedString);
+                result = NULL;
+            }
+            else
+            {
+                result = STRING_new_with_memory(decodedString);
+                if (result == NULL)
+                {
+                    LogError("URL_Decode:: MALLOC failure on decode");
+                    free(decodedString);
+                }
+            }
         }
     }
     return result;
@@ -323,30 +520,7 @@ STRING_HANDLE URL_Decode(STRING_HANDLE input)
     }
     else
     {
-        size_t decodedStringSize;
-        char* decodedString;
-        const char* inputString = STRING_c_str(input);
-        size_t inputLen = strlen(inputString);
-        if ((decodedStringSize = calculateDecodedStringSize(inputString, inputLen)) == 0)
-        {
-            LogError("URL_Decode:: Invalid input string");
-            result = NULL;
-        }
-        else if ((decodedString = (char*)malloc(decodedStringSize)) == NULL)
-        {
-            LogError("URL_Decode:: MALLOC failure on decode.");
-            result = NULL;
-        }
-        else
-        {
-            createDecodedString(inputString, inputLen, decodedString);
-            result = STRING_new_with_memory(decodedString);
-            if (result == NULL)
-            {
-                LogError("URL_Decode:: MALLOC failure on decode");
-                free(decodedString);
-            }
-        }
+        result = URL_DecodeString(STRING_c_str(input));
     }
     return result;
 }
@@ -1,176 +1,334 @@
- // Copyright (c) Microsoft. All rights reserved.
+// Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #ifdef __cplusplus
 #include <cstdlib>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #else
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #endif
 
 #include "azure_c_shared_utility/utf8_checker.h"
 
-bool utf8_checker_is_valid_utf8(const unsigned char* utf8_str, size_t length)
+/*
+ * ASCII runs are skipped a vector at a time: 32 bytes with AVX2 when CPUID reports it,
+ * 16 bytes with SSE2 or NEON, 8 bytes with plain 64-bit words otherwise. Multi-byte
+ * code points go through the DFA below. Define NO_UTF8_CHECKER_SIMD to always use the
+ * 64-bit word loop.
+ */
+#if !defined(NO_UTF8_CHECKER_SIMD) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))) && \
+    (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+#define UTF8_CHECKER_USE_X86_SIMD
+#include <cpuid.h>
+#include <immintrin.h>
+#elif !defined(NO_UTF8_CHECKER_SIMD) && defined(__aarch64__) && (defined(__clang__) || defined(__GNUC__))
+#define UTF8_CHECKER_USE_NEON
+#include <arm_neon.h>
+#endif
+
+/* DFA states; the values index the rows of utf8_transitions */
+#define UTF8_STATE_ACCEPT           0
+#define UTF8_STATE_REJECT           1
+#define UTF8_STATE_NEED_1           2   /* 1 continuation byte left */
+#define UTF8_STATE_NEED_2           3   /* 2 continuation bytes left */
+#define UTF8_STATE_NEED_3           4   /* 3 continuation bytes left */
+#define UTF8_STATE_E0               5   /* after 0xE0, the next byte must be 0xA0..0xBF */
+#define UTF8_STATE_F0               6   /* after 0xF0, the next byte must be 0x90..0xBF */
+#define UTF8_STATE_COUNT            7
+
+/* byte classes; the values index the columns of utf8_transitions */
+#define UTF8_CLASS_ASCII            0   /* 0x00..0x7F */
+#define UTF8_CLASS_CONT_80          1   /* 0x80..0x8F */
+#define UTF8_CLASS_CONT_90          2   /* 0x90..0x9F */
+#define UTF8_CLASS_CONT_A0          3   /* 0xA0..0xBF */
+#define UTF8_CLASS_LEAD_2           4   /* 0xC2..0xDF */
+#define UTF8_CLASS_LEAD_E0          5   /* 0xE0 */
+#define UTF8_CLASS_LEAD_3           6   /* 0xE1..0xEF */
+#define UTF8_CLASS_LEAD_F0          7   /* 0xF0 */
+#define UTF8_CLASS_LEAD_4           8   /* 0xF1..0xF7 */
+#define UTF8_CLASS_INVALID          9   /* 0xC0, 0xC1, 0xF8..0xFF */
+#define UTF8_CLASS_COUNT            10
+
+static const unsigned char utf8_byte_class[256] =
 {
-    bool result;
+    /* 0x00 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x10 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x20 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x30 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x40 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x50 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x60 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x70 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x80 */ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    /* 0x90 */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    /* 0xA0 */ 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    /* 0xB0 */ 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    /* 0xC0 */ 9, 9, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    /* 0xD0 */ 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    /* 0xE0 */ 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    /* 0xF0 */ 7, 8, 8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9, 9, 9
+};
 
-    if (utf8_str == NULL)
+/*
+ * 0xC0 and 0xC1 can only start overlong 2 byte sequences; 0xE0 followed by 0x80..0x9F and
+ * 0xF0 followed by 0x80..0x8F are the overlong 3 and 4 byte sequences.
+ */
+static const unsigned char utf8_transitions[UTF8_STATE_COUNT][UTF8_CLASS_COUNT] =
+{
+    /*                        ASCII               CONT_80             CONT_90             CONT_A0             LEAD_2              LEAD_E0             LEAD_3              LEAD_F0             LEAD_4              INVALID */
+    /* ACCEPT */            { UTF8_STATE_ACCEPT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_NEED_1,  UTF8_STATE_E0,      UTF8_STATE_NEED_2,  UTF8_STATE_F0,      UTF8_STATE_NEED_3,  UTF8_STATE_REJECT },
+    /* REJECT */            { UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT },
+    /* NEED_1 */            { UTF8_STATE_REJECT,  UTF8_STATE_ACCEPT,  UTF8_STATE_ACCEPT,  UTF8_STATE_ACCEPT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT },
+    /* NEED_2 */            { UTF8_STATE_REJECT,  UTF8_STATE_NEED_1,  UTF8_STATE_NEED_1,  UTF8_STATE_NEED_1,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT },
+    /* NEED_3 */            { UTF8_STATE_REJECT,  UTF8_STATE_NEED_2,  UTF8_STATE_NEED_2,  UTF8_STATE_NEED_2,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT },
+    /* E0 */                { UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_NEED_1,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT },
+    /* F0 */                { UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_NEED_2,  UTF8_STATE_NEED_2,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT,  UTF8_STATE_REJECT }
+};
+
+typedef size_t(*UTF8_CHECKER_ASCII_PREFIX_FUNCTION)(const unsigned char* utf8_str, size_t length);
+
+/* Returns how many of the leading bytes are ASCII; may stop short on the last few bytes, the DFA takes those */
+static size_t ascii_prefix_words(const unsigned char* utf8_str, size_t length)
+{
+    size_t pos = 0;
+
+    while (length - pos >= sizeof(uint64_t))
     {
-        /* Codes_SRS_UTF8_CHECKER_01_002: [ If `utf8_checker_is_valid_utf8` is called with NULL `utf8_str` it shall return false. ]*/
-        result = false;
+        uint64_t word;
+        (void)memcpy(&word, utf8_str + pos, sizeof(word));
+        if ((word & 0x8080808080808080ULL) != 0)
+        {
+            while ((utf8_str[pos] & 0x80) == 0)
+            {
+                pos++;
+            }
+            break;
+        }
+        pos += sizeof(uint64_t);
     }
-    else
+
+    return pos;
+}
+
+#if defined(UTF8_CHECKER_USE_X86_SIMD)
+static size_t ascii_prefix_sse2(const unsigned char* utf8_str, size_t length)
+{
+    size_t pos = 0;
+
+    while (length - pos >= 16)
     {
-        size_t pos = 0;
+        int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(utf8_str + pos)));
+        if (mask != 0)
+        {
+            return pos + (size_t)__builtin_ctz((unsigned int)mask);
+        }
+        pos += 16;
+    }
 
-        /* Codes_SRS_UTF8_CHECKER_01_003: [ If `length` is 0, `utf8_checker_is_valid_utf8` shall consider `utf8_str` to be valid UTF-8 and return true. ]*/
-        result = true;
+    return pos;
+}
+
+__attribute__((target("avx2")))
+static size_t ascii_prefix_avx2(const unsigned char* utf8_str, size_t length)
+{
+    size_t pos = 0;
+
+    while (length - pos >= 64)
+    {
+        __m256i first = _mm256_loadu_si256((const __m256i*)(utf8_str + pos));
+        __m256i second = _mm256_loadu_si256((const __m256i*)(utf8_str + pos + 32));
+        if (_mm256_movemask_epi8(_mm256_or_si256(first, second)) != 0)
+        {
+            break;
+        }
+        pos += 64;
+    }
 
-        while ((result == true) &&
-               (pos < length))
+    while (length - pos >= 32)
+    {
+        int mask = _mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(utf8_str + pos)));
+        if (mask != 0)
         {
-            /* Codes_SRS_UTF8_CHECKER_01_001: [ `utf8_checker_is_valid_utf8` shall verify that the sequence of chars pointed to by `utf8_str` represent UTF-8 encoded codepoints. ]*/
-            if ((utf8_str[pos] >> 3) == 0x1E)
-            {
-                /* 4 bytes */
-                /* Codes_SRS_UTF8_CHECKER_01_009: [ 000uuuuu zzzzyyyy yyxxxxxx 11110uuu 10uuzzzz 10yyyyyy 10xxxxxx ]*/
-                uint32_t code_point = (utf8_str[pos] & 0x07);
+            return pos + (size_t)__builtin_ctz((unsigned int)mask);
+        }
+        pos += 32;
+    }
 
-                pos++;
-                if ((pos < length) &&
-                    ((utf8_str[pos] >> 6) == 0x02))
-                {
-                    code_point <<= 6;
-                    code_point += utf8_str[pos] & 0x3F;
-
-                    pos++;
-                    if ((pos < length) &&
-                        ((utf8_str[pos] >> 6) == 0x02))
-                    {
-                        code_point <<= 6;
-                        code_point += utf8_str[pos] & 0x3F;
-
-                        pos++;
-                        if ((pos < length) &&
-                            ((utf8_str[pos] >> 6) == 0x02))
-                        {
-                            code_point <<= 6;
-                            code_point += utf8_str[pos] & 0x3F;
-
-                            if (code_point <= 0xFFFF)
-                            {
-                                result = false;
-                            }
-                            else
-                            {
-                                /* Codes_SRS_UTF8_CHECKER_01_005: [ On success it shall return true. ]*/
-                                result = true;
-                                pos++;
-                            }
-                        }
-                        else
-                        {
-                            result = false;
-                        }
-                    }
-                    else
-                    {
-                        result = false;
-                    }
-                }
-                else
-                {
-                    result = false;
-                }
-            }
-            else if ((utf8_str[pos] >> 4) == 0x0E)
-            {
-                /* 3 bytes */
-                /* Codes_SRS_UTF8_CHECKER_01_008: [ zzzzyyyy yyxxxxxx 1110zzzz 10yyyyyy 10xxxxxx ]*/
-                uint32_t code_point = (utf8_str[pos] & 0x0F);
+    return pos + ascii_prefix_sse2(utf8_str + pos, length - pos);
+}
 
-                pos++;
-                if ((pos < length) &&
-                    ((utf8_str[pos] >> 6) == 0x02))
-                {
-                    code_point <<= 6;
-                    code_point += utf8_str[pos] & 0x3F;
-
-                    pos++;
-                    if ((pos < length) &&
-                        ((utf8_str[pos] >> 6) == 0x02))
-                    {
-                        code_point <<= 6;
-                        code_point += utf8_str[pos] & 0x3F;
-
-                        if (code_point <= 0x7FF)
-                        {
-                            result = false;
-                        }
-                        else
-                        {
-                            /* Codes_SRS_UTF8_CHECKER_01_005: [ On success it shall return true. ]*/
-                            result = true;
-                            pos++;
-                        }
-                    }
-                    else
-                    {
-                        result = false;
-                    }
-                }
-                else
-                {
-                    result = false;
-                }
-            }
-            else if ((utf8_str[pos] >> 5) == 0x06)
-            {
-                /* 2 bytes */
-                /* Codes_SRS_UTF8_CHECKER_01_007: [ 00000yyy yyxxxxxx 110yyyyy 10xxxxxx ]*/
-                uint32_t code_point = (utf8_str[pos] & 0x1F);
+static int has_avx2(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    int result = 0;
 
-                pos++;
-                if ((pos < length) &&
-                    ((utf8_str[pos] >> 6) == 0x02))
-                {
-                    code_point <<= 6;
-                    code_point += utf8_str[pos] & 0x3F;
-
-                    if (code_point <= 0x7F)
-                    {
-                        result = false;
-                    }
-                    else
-                    {
-                        /* Codes_SRS_UTF8_CHECKER_01_005: [ On success it shall return true. ]*/
-                        result = true;
-                        pos++;
-                    }
-                }
-                else
-                {
-                    result = false;
-                }
-            }
-            else if ((utf8_str[pos] >> 7) == 0x00)
+    /* AVX2 in leaf 7, and the OS has to save the YMM registers (OSXSAVE and XCR0 bits 1 and 2) */
+    if ((__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) &&
+        ((ecx & (1u << 27)) != 0) && ((ecx & (1u << 28)) != 0) &&
+        (__get_cpuid_max(0, NULL) >= 7))
+    {
+        unsigned int xcr0_low;
+        unsigned int xcr0_high;
+
+        __asm__ ("xgetbv" : "=a" (xcr0_low), "=d" (xcr0_high) : "c" (0));
+        if ((xcr0_low & 0x6) == 0x6)
+        {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            result = ((ebx & (1u << 5)) != 0);
+        }
+    }
+
+    return result;
+}
+#endif /* UTF8_CHECKER_USE_X86_SIMD */
+
+#if defined(UTF8_CHECKER_USE_NEON)
+static size_t ascii_prefix_neon(const unsigned char* utf8_str, size_t length)
+{
+    size_t pos = 0;
+
+    while (length - pos >= 16)
+    {
+        if (vmaxvq_u8(vld1q_u8(utf8_str + pos)) >= 0x80)
+        {
+            while ((utf8_str[pos] & 0x80) == 0)
             {
-                /* 1 byte */
-                /* Codes_SRS_UTF8_CHECKER_01_006: [ 00000000 0xxxxxxx 0xxxxxxx ]*/
-                /* Codes_SRS_UTF8_CHECKER_01_005: [ On success it shall return true. ]*/
-                result = true;
                 pos++;
             }
-            else
+            break;
+        }
+        pos += 16;
+    }
+
+    return pos;
+}
+#endif /* UTF8_CHECKER_USE_NEON */
+
+static size_t ascii_prefix_select(const unsigned char* utf8_str, size_t length);
+
+/* The selection is idempotent, so threads racing on the first call all store the same function. */
+static UTF8_CHECKER_ASCII_PREFIX_FUNCTION ascii_prefix = ascii_prefix_select;
+
+static size_t ascii_prefix_select(const unsigned char* utf8_str, size_t length)
+{
+    UTF8_CHECKER_ASCII_PREFIX_FUNCTION selected = ascii_prefix_words;
+
+#if defined(UTF8_CHECKER_USE_X86_SIMD)
+    selected = has_avx2() ? ascii_prefix_avx2 : ascii_prefix_sse2;
+#elif defined(UTF8_CHECKER_USE_NEON)
+    selected = ascii_prefix_neon;
+#endif
+
+    ascii_prefix = selected;
+    return selected(utf8_str, length);
+}
+
+/* Runs the DFA over the bytes, starting from state; returns the state after the last byte */
+static unsigned char validate(unsigned char state, const unsigned char* utf8_str, size_t length)
+{
+    size_t pos = 0;
+
+    while ((pos < length) &&
+           (state != UTF8_STATE_REJECT))
+    {
+        if (state == UTF8_STATE_ACCEPT)
+        {
+            /* Codes_SRS_UTF8_CHECKER_01_006: [ 00000000 0xxxxxxx 0xxxxxxx ]*/
+            pos += ascii_prefix(utf8_str + pos, length - pos);
+            if (pos == length)
             {
-                /* error */
-                result = false;
+                break;
             }
         }
+
+        /* Codes_SRS_UTF8_CHECKER_01_007: [ 00000yyy yyxxxxxx 110yyyyy 10xxxxxx ]*/
+        /* Codes_SRS_UTF8_CHECKER_01_008: [ zzzzyyyy yyxxxxxx 1110zzzz 10yyyyyy 10xxxxxx ]*/
+        /* Codes_SRS_UTF8_CHECKER_01_009: [ 000uuuuu zzzzyyyy yyxxxxxx 11110uuu 10uuzzzz 10yyyyyy 10xxxxxx ]*/
+        /* finish the current code point; short tails are not worth going back to the vector loop */
+        do
+        {
+            state = utf8_transitions[state][utf8_byte_class[utf8_str[pos]]];
+            pos++;
+        } while ((pos < length) &&
+                 (state != UTF8_STATE_REJECT) &&
+                 ((state != UTF8_STATE_ACCEPT) || (length - pos < 16)));
+    }
+
+    return state;
+}
+
+bool utf8_checker_is_valid_utf8(const unsigned char* utf8_str, size_t length)
+{
+    bool result;
+
+    if (utf8_str == NULL)
+    {
+        /* Codes_SRS_UTF8_CHECKER_01_002: [ If `utf8_checker_is_valid_utf8` is called with NULL `utf8_str` it shall return false. ]*/
+        result = false;
+    }
+    else
+    {
+        /* Codes_SRS_UTF8_CHECKER_01_001: [ `utf8_checker_is_valid_utf8` shall verify that the sequence of chars pointed to by `utf8_str` represent UTF-8 encoded codepoints. ]*/
+        /* Codes_SRS_UTF8_CHECKER_01_003: [ If `length` is 0, `utf8_checker_is_valid_utf8` shall consider `utf8_str` to be valid UTF-8 and return true. ]*/
+        /* Codes_SRS_UTF8_CHECKER_01_005: [ On success it shall return true. ]*/
+        result = (validate(UTF8_STATE_ACCEPT, utf8_str, length) == UTF8_STATE_ACCEPT);
+    }
+
+    return result;
+}
+
+void utf8_checker_state_init(UTF8_CHECKER_STATE* state)
+{
+    /* Codes_SRS_UTF8_CHECKER_01_010: [ If `state` is NULL, `utf8_checker_state_init` shall return. ]*/
+    if (state != NULL)
+    {
+        /* Codes_SRS_UTF8_CHECKER_01_011: [ `utf8_checker_state_init` shall set `state` to the start of a message with no bytes seen. ]*/
+        state->dfa_state = UTF8_STATE_ACCEPT;
+    }
+}
+
+bool utf8_checker_validate_fragment(UTF8_CHECKER_STATE* state, const unsigned char* utf8_str, size_t length)
+{
+    bool result;
+
+    if ((state == NULL) ||
+        (utf8_str == NULL))
+    {
+        /* Codes_SRS_UTF8_CHECKER_01_012: [ If `state` or `utf8_str` is NULL, `utf8_checker_validate_fragment` shall return false. ]*/
+        result = false;
+    }
+    else
+    {
+        /* Codes_SRS_UTF8_CHECKER_01_013: [ `utf8_checker_validate_fragment` shall validate the bytes of `utf8_str` as the continuation of the bytes previously passed with `state`, so that a code point may be split across fragments. ]*/
+        state->dfa_state = validate(state->dfa_state, utf8_str, length);
+
+        /* Codes_SRS_UTF8_CHECKER_01_014: [ `utf8_checker_validate_fragment` shall return false if the bytes seen so far cannot be the start of valid UTF-8, and true otherwise. ]*/
+        /* Codes_SRS_UTF8_CHECKER_01_015: [ Once `utf8_checker_validate_fragment` returned false, it shall return false for every following fragment until `state` is initialized again. ]*/
+        result = (state->dfa_state != UTF8_STATE_REJECT);
+    }
+
+    return result;
+}
+
+bool utf8_checker_is_complete(const UTF8_CHECKER_STATE* state)
+{
+    bool result;
+
+    if (state == NULL)
+    {
+        /* Codes_SRS_UTF8_CHECKER_01_016: [ If `state` is NULL, `utf8_checker_is_complete` shall return false. ]*/
+        result = false;
+    }
+    else
+    {
+        /* Codes_SRS_UTF8_CHECKER_01_017: [ `utf8_checker_is_complete` shall return true if the bytes seen so far are valid UTF-8 that does not end in the middle of a code point, and false otherwise. ]*/
+        result = (state->dfa_state == UTF8_STATE_ACCEPT);
     }
 
     return result;
@@ -6,6 +6,7 @@
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/uuid.h"
 #include "azure_c_shared_utility/uniqueid.h"
+#include "azure_c_shared_utility/gb_rand.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 
@@ -165,3 +166,82 @@ int UUID_generate(UUID_T* uuid)
 
     return result;
 }
+
+int UUID_generate_n(UUID_T* uuids, size_t count)
+{
+    int result;
+
+    // Codes_SRS_UUID_01_001: [ If `uuids` is NULL or `count` is 0, UUID_generate_n shall return a non-zero value ]
+    if (uuids == NULL || count == 0)
+    {
+        LogError("Invalid argument (uuids=%p, count=%lu)", uuids, (unsigned long)count);
+        result = __FAILURE__;
+    }
+    // Codes_SRS_UUID_01_002: [ If the size of `count` UUIDs does not fit in a size_t, UUID_generate_n shall return a non-zero value ]
+    else if (count > ((size_t)-1) / sizeof(UUID_T))
+    {
+        LogError("Too many UUIDs requested (%lu)", (unsigned long)count);
+        result = __FAILURE__;
+    }
+    else
+    {
+        size_t i;
+
+        // Codes_SRS_UUID_01_003: [ UUID_generate_n shall fill the `count` UUIDs with random bytes obtained from gb_rand_bytes in a single call ]
+        gb_rand_bytes((unsigned char*)uuids, count * sizeof(UUID_T));
+
+        for (i = 0; i < count; i++)
+        {
+            // Codes_SRS_UUID_01_004: [ UUID_generate_n shall set the version of each UUID to 4 (random) and its variant to the one of RFC 4122 ]
+            uuids[i][6] = (unsigned char)((uuids[i][6] & 0x0F) | 0x40);
+            uuids[i][8] = (unsigned char)((uuids[i][8] & 0x3F) | 0x80);
+        }
+
+        // Codes_SRS_UUID_01_005: [ If no failures occur, UUID_generate_n shall return zero ]
+        result = __SUCCESS__;
+    }
+
+    return result;
+}
+
+int UUID_to_string_into(UUID_T* uuid, char* destination, size_t destinationSize)
+{
+    int result;
+
+    // Codes_SRS_UUID_01_006: [ If `uuid` or `destination` is NULL, UUID_to_string_into shall return a non-zero value ]
+    if (uuid == NULL || destination == NULL)
+    {
+        LogError("Invalid argument (uuid=%p, destination=%p)", uuid, destination);
+        result = __FAILURE__;
+    }
+    // Codes_SRS_UUID_01_007: [ If `destinationSize` is less than UUID_STRING_BUFFER_SIZE, UUID_to_string_into shall return a non-zero value ]
+    else if (destinationSize < UUID_STRING_BUFFER_SIZE)
+    {
+        LogError("Destination too small (%lu)", (unsigned long)destinationSize);
+        result = __FAILURE__;
+    }
+    else
+    {
+        static const char hex_digits[] = "0123456789abcdef";
+        const unsigned char* uuid_bytes = (const unsigned char*)uuid;
+        size_t i;
+        size_t pos = 0;
+
+        // Codes_SRS_UUID_01_008: [ UUID_to_string_into shall write each byte of `uuid` as a 2-digit lowercase HEX value, with dashes as per RFC 4122, followed by a null character ]
+        for (i = 0; i < sizeof(UUID_T); i++)
+        {
+            if (i == 4 || i == 6 || i == 8 || i == 10)
+            {
+                destination[pos++] = '-';
+            }
+            destination[pos++] = hex_digits[uuid_bytes[i] >> 4];
+            destination[pos++] = hex_digits[uuid_bytes[i] & 0x0F];
+        }
+        destination[pos] = '\0';
+
+        // Codes_SRS_UUID_01_009: [ If no failures occur, UUID_to_string_into shall return zero ]
+        result = __SUCCESS__;
+    }
+
+    return result;
+}
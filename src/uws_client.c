@@ -689,16 +689,12 @@ static void on_underlying_io_open_complete(void* context, IO_OPEN_RESULT open_re
             {
                 int upgrade_request_length;
                 char* upgrade_request;
-                size_t i;
                 unsigned char nonce[16];
                 STRING_HANDLE base64_nonce;
 
                 /* Codes_SRS_UWS_CLIENT_01_089: [ The value of this header field MUST be a nonce consisting of a randomly selected 16-byte value that has been base64-encoded (see Section 4 of [RFC4648]). ]*/
                 /* Codes_SRS_UWS_CLIENT_01_090: [ The nonce MUST be selected randomly for each connection. ]*/
-                for (i = 0; i < sizeof(nonce); i++)
-                {
-                    nonce[i] = (unsigned char)gb_rand();
-                }
+                gb_rand_bytes(nonce, sizeof(nonce));
 
                 /* Codes_SRS_UWS_CLIENT_01_497: [ The nonce needed for the upgrade request shall be Base64 encoded with `Base64_Encode_Bytes`. ]*/
                 base64_nonce = Base64_Encode_Bytes(nonce, sizeof(nonce));
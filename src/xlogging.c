@@ -56,6 +56,18 @@ LOGGER_LOG xlogging_get_log_function(void)
     return global_log_function;
 }
 
+volatile int xlogging_max_category = AZ_LOG_TRACE;
+
+void xlogging_set_max_category(LOG_CATEGORY max_category)
+{
+    xlogging_max_category = (int)max_category;
+}
+
+LOG_CATEGORY xlogging_get_max_category(void)
+{
+    return (LOG_CATEGORY)xlogging_max_category;
+}
+
 #if (defined(_MSC_VER)) && (!(defined WINCE))
 
 LOGGER_LOG_GETLASTERROR global_log_function_GetLastError = consolelogger_log_with_GetLastError;
@@ -80,7 +92,8 @@ LOGGER_LOG_GETLASTERROR xlogging_get_log_function_GetLastError(void)
 /* Convert the lower nibble of the provided byte to a hexadecimal printable char. */
 #define HEX_STR(c)           (((c) & 0xF) < 0xA) ? (char)(((c) & 0xF) + '0') : (char)(((c) & 0xF) - 0xA + 'A')
 
-void LogBinary(const char* comment, const void* data, size_t size)
+/* The parentheses keep the LogBinary macro from expanding here. */
+void (LogBinary)(const char* comment, const void* data, size_t size)
 {
     char charBuf[LINE_SIZE + 1];
     char hexBuf[LINE_SIZE * 3 + 1];
@@ -89,52 +102,57 @@ void LogBinary(const char* comment, const void* data, size_t size)
     const unsigned char* bufAsChar = (const unsigned char*)data;
     const unsigned char* startPos = bufAsChar;
 
-    LOG(AZ_LOG_TRACE, LOG_LINE, "%s     %zu bytes", comment, size);
-
-    /* Print the whole buffer. */
-    for (i = 0; i < size; i++)
+    /* Callers through a pointer to this function skip the check of the macro, and nothing is
+    formatted when there is no log function to take it. */
+    if (xlogging_is_enabled(AZ_LOG_TRACE) && (xlogging_get_log_function() != NULL))
     {
-        /* Store the printable value of the char in the charBuf to print. */
-        charBuf[countbuf] = PRINTABLE(*bufAsChar);
+        LOG(AZ_LOG_TRACE, LOG_LINE, "%s     %zu bytes", comment, size);
+
+        /* Print the whole buffer. */
+        for (i = 0; i < size; i++)
+        {
+            /* Store the printable value of the char in the charBuf to print. */
+            charBuf[countbuf] = PRINTABLE(*bufAsChar);
 
-        /* Convert the high nibble to a printable hexadecimal value. */
-        hexBuf[countbuf * 3] = HEX_STR(*bufAsChar >> 4);
+            /* Convert the high nibble to a printable hexadecimal value. */
+            hexBuf[countbuf * 3] = HEX_STR(*bufAsChar >> 4);
 
-        /* Convert the low nibble to a printable hexadecimal value. */
-        hexBuf[countbuf * 3 + 1] = HEX_STR(*bufAsChar);
+            /* Convert the low nibble to a printable hexadecimal value. */
+            hexBuf[countbuf * 3 + 1] = HEX_STR(*bufAsChar);
 
-        hexBuf[countbuf * 3 + 2] = ' ';
+            hexBuf[countbuf * 3 + 2] = ' ';
 
-        countbuf++;
-        bufAsChar++;
-        /* If the line is full, print it to start another one. */
-        if (countbuf == LINE_SIZE)
+            countbuf++;
+            bufAsChar++;
+            /* If the line is full, print it to start another one. */
+            if (countbuf == LINE_SIZE)
+            {
+                charBuf[countbuf] = '\0';
+                hexBuf[countbuf * 3] = '\0';
+                LOG(AZ_LOG_TRACE, LOG_LINE, "%p: %s    %s", startPos, hexBuf, charBuf);
+                countbuf = 0;
+                startPos = bufAsChar;
+            }
+        }
+
+        /* If the last line does not fit the line size. */
+        if (countbuf > 0)
         {
+            /* Close the charBuf string. */
             charBuf[countbuf] = '\0';
-            hexBuf[countbuf * 3] = '\0';
-            LOG(AZ_LOG_TRACE, LOG_LINE, "%p: %s    %s", startPos, hexBuf, charBuf);
-            countbuf = 0;
-            startPos = bufAsChar;
-        }
-    }
 
-    /* If the last line does not fit the line size. */
-    if (countbuf > 0)
-    {
-        /* Close the charBuf string. */
-        charBuf[countbuf] = '\0';
+            /* Fill the hexBuf with spaces to keep the charBuf alignment. */
+            while ((countbuf++) < LINE_SIZE - 1)
+            {
+                hexBuf[countbuf * 3] = ' ';
+                hexBuf[countbuf * 3 + 1] = ' ';
+                hexBuf[countbuf * 3 + 2] = ' ';
+            }
+            hexBuf[countbuf * 3] = '\0';
 
-        /* Fill the hexBuf with spaces to keep the charBuf alignment. */
-        while ((countbuf++) < LINE_SIZE - 1)
-        {
-            hexBuf[countbuf * 3] = ' ';
-            hexBuf[countbuf * 3 + 1] = ' ';
-            hexBuf[countbuf * 3 + 2] = ' ';
+            /* Print the last line. */
+            LOG(AZ_LOG_TRACE, LOG_LINE, "%p: %s    %s", startPos, hexBuf, charBuf);
         }
-        hexBuf[countbuf * 3] = '\0';
-
-        /* Print the last line. */
-        LOG(AZ_LOG_TRACE, LOG_LINE, "%p: %s    %s", startPos, hexBuf, charBuf);
     }
 }
 
@@ -0,0 +1,510 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+
+static void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/gballoc.h"
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/async_logger.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#define TEST_THREAD_COUNT           4
+#define TEST_RECORDS_PER_THREAD     1000
+#define TEST_OUTPUT_SIZE            (256 * 1024)
+#define TEST_TEN_NUMBERS_FORMAT     "%d %d %d %d %d %d %d %d %d %d "
+
+#ifdef WIN32
+#define test_lock_output(output) _lock_file(output)
+#define test_unlock_output(output) _unlock_file(output)
+#else
+#define test_lock_output(output) flockfile(output)
+#define test_unlock_output(output) funlockfile(output)
+#endif
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static char test_output[TEST_OUTPUT_SIZE];
+
+/*reads back everything written to output*/
+static const char* read_output(FILE* output)
+{
+    size_t size;
+    rewind(output);
+    size = fread(test_output, 1, sizeof(test_output) - 1, output);
+    test_output[size] = '\0';
+    return test_output;
+}
+
+static size_t count_occurrences(const char* text, const char* what)
+{
+    size_t result = 0;
+    const char* found = strstr(text, what);
+    while (found != NULL)
+    {
+        result++;
+        found = strstr(found + strlen(what), what);
+    }
+    return result;
+}
+
+static void test_logger(LOG_CATEGORY log_category, const char* file, const char* func, int line, unsigned int options, const char* format, ...)
+{
+    (void)log_category;
+    (void)file;
+    (void)func;
+    (void)line;
+    (void)options;
+    (void)format;
+}
+
+static int logging_thread(void* context)
+{
+    size_t thread_index = (size_t)context;
+    size_t i;
+    for (i = 0; i < TEST_RECORDS_PER_THREAD; i++)
+    {
+        LogInfo("thread %lu record %lu", (unsigned long)thread_index, (unsigned long)i);
+    }
+    return 0;
+}
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(async_logger_unittests)
+
+TEST_SUITE_INITIALIZE(TestSuiteInitialize)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    umock_c_init(on_umock_c_error);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(f)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(cleans)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* async_logger_start */
+
+/*Tests_SRS_ASYNC_LOGGER_01_001: [ If output is NULL or capacity is 0 or too large for the records to be allocated, async_logger_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(async_logger_start_with_invalid_arguments_fails)
+{
+    //arrange
+    FILE* output = tmpfile();
+    int result_null_output;
+    int result_zero_capacity;
+    int result_huge_capacity;
+    ASSERT_IS_NOT_NULL(output);
+
+    //act
+    result_null_output = async_logger_start(NULL, 16);
+    result_zero_capacity = async_logger_start(output, 0);
+    result_huge_capacity = async_logger_start(output, (size_t)-1);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_null_output);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_zero_capacity);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_huge_capacity);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    (void)fclose(output);
+}
+
+/*Tests_SRS_ASYNC_LOGGER_01_006: [ If any error occurs, async_logger_start shall free what it allocated and return a non-zero value. ]*/
+TEST_FUNCTION(when_allocating_the_ring_fails_async_logger_start_fails)
+{
+    //arrange
+    FILE* output = tmpfile();
+    int result;
+    ASSERT_IS_NOT_NULL(output);
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    result = async_logger_start(output, 16);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_TRUE(xlogging_get_log_function() != async_logger_log);
+
+    //cleanup
+    (void)fclose(output);
+}
+
+/*Tests_SRS_ASYNC_LOGGER_01_005: [ async_logger_start shall install async_logger_log with xlogging_set_log_function and return 0. ]*/
+/*Tests_SRS_ASYNC_LOGGER_01_008: [ async_logger_stop shall put back the log function that was installed before async_logger_start. ]*/
+TEST_FUNCTION(async_logger_start_installs_async_logger_log_and_async_logger_stop_restores_the_previous_one)
+{
+    //arrange
+    LOGGER_LOG previous = xlogging_get_log_function();
+    FILE* output = tmpfile();
+    int result;
+    LOGGER_LOG installed;
+    ASSERT_IS_NOT_NULL(output);
+    xlogging_set_log_function(test_logger);
+
+    //act
+    result = async_logger_start(output, 16);
+    installed = xlogging_get_log_function();
+    async_logger_stop();
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(installed == async_logger_log);
+    ASSERT_IS_TRUE(xlogging_get_log_function() == test_logger);
+
+    //cleanup
+    xlogging_set_log_function(previous);
+    (void)fclose(output);
+}
+
+/*Tests_SRS_ASYNC_LOGGER_01_002: [ If the logger is already started, async_logger_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(async_logger_start_twice_fails)
+{
+    //arrange
+    LOGGER_LOG previous = xlogging_get_log_function();
+    FILE* output = tmpfile();
+    int result;
+    ASSERT_IS_NOT_NULL(output);
+    ASSERT_ARE_EQUAL(int, 0, async_logger_start(output, 16));
+
+    //act
+    result = async_logger_start(output, 16);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    //cleanup
+    async_logger_stop();
+    ASSERT_IS_TRUE(xlogging_get_log_function() == previous);
+    (void)fclose(output);
+}
+
+/* async_logger_stop */
+
+/*Tests_SRS_ASYNC_LOGGER_01_007: [ If the logger is not started, async_logger_stop shall return. ]*/
+TEST_FUNCTION(async_logger_stop_when_not_started_returns)
+{
+    //act
+    async_logger_stop();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* async_logger_get_statistics */
+
+/*Tests_SRS_ASYNC_LOGGER_01_012: [ If statistics is NULL, async_logger_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(async_logger_get_statistics_with_NULL_fails)
+{
+    //act
+    int result = async_logger_get_statistics(NULL);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* async_logger_log */
+
+/*Tests_SRS_ASYNC_LOGGER_01_004: [ async_logger_start shall start a writer thread that writes the records to output. ]*/
+/*Tests_SRS_ASYNC_LOGGER_01_010: [ async_logger_stop shall wait for the writer thread to write every record left in the ring and flush output. ]*/
+/*Tests_SRS_ASYNC_LOGGER_01_013: [ async_logger_get_statistics shall fill statistics with the number of records written, dropped and truncated since the last async_logger_start and return 0. ]*/
+/*Tests_SRS_ASYNC_LOGGER_01_016: [ async_logger_log shall capture the time, log_category, file, func, line, options and format, and store the arguments the conversions of format consume without formatting them by calling log_arguments_capture. ]*/
+/*Tests_SRS_ASYNC_LOGGER_01_017: [ The writer thread shall format the message from the format and the stored arguments by calling log_arguments_format, keeping as much of it as fits in ASYNC_LOGGER_MESSAGE_SIZE. ]*/
+/*Tests_SRS_ASYNC_LOGGER_01_018: [ async_logger_log shall publish the record and wake the writer thread. ]*/
+TEST_FUNCTION(records_are_written_in_order_in_the_consolelogger_format_without_allocating)
+{
+    //arrange
+    FILE* output = tmpfile();
+    ASYNC_LOGGER_STATISTICS statistics;
+    const char* text;
+    ASSERT_IS_NOT_NULL(output);
+    ASSERT_ARE_EQUAL(int, 0, async_logger_start(output, 16));
+    umock_c_reset_all_calls();
+
+    //act
+    LogInfo("first %d", 1);
+    LogError("second %s", "record");
+    LOG(AZ_LOG_TRACE, 0, "third");
+    LOG(AZ_LOG_TRACE, LOG_LINE, " record");
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    async_logger_stop();
+    text = read_output(output);
+    ASSERT_IS_TRUE(strncmp(text, "Info: first 1\r\nError: Time:", strlen("Info: first 1\r\nError: Time:")) == 0);
+    ASSERT_IS_NOT_NULL(strstr(text, " File:"));
+    ASSERT_IS_NOT_NULL(strstr(text, " Line:"));
+    ASSERT_IS_NOT_NULL(strstr(text, " second record\r\nthird record\r\n"));
+    ASSERT_ARE_EQUAL(int, 0, async_logger_get_statistics(&statistics));
+    ASSERT_ARE_EQUAL(size_t, 4, statistics.written);
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.dropped);
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.truncated);
+
+    //cleanup
+    (void)fclose(output);
+}
+
+/*Tests_SRS_ASYNC_LOGGER_01_017: [ The writer thread shall format the message from the format and the stored arguments by calling log_arguments_format, keeping as much of it as fits in ASYNC_LOGGER_MESSAGE_SIZE. ]*/
+/*Tests_SRS_ASYNC_LOGGER_01_019: [ If the arguments did not fit in ASYNC_LOGGER_ARGUMENTS_SIZE or the message does not fit in ASYNC_LOGGER_MESSAGE_SIZE, the record shall be counted as truncated. ]*/
+TEST_FUNCTION(a_message_that_does_not_fit_is_truncated_and_counted)
+{
+    //arrange
+    FILE* output = tmpfile();
+    char long_message[ASYNC_LOGGER_MESSAGE_SIZE + 10];
+    ASYNC_LOGGER_STATISTICS statistics;
+    ASSERT_IS_NOT_NULL(output);
+    (void)memset(long_message, 'x', sizeof(long_message) - 1);
+    long_message[sizeof(long_message) - 1] = '\0';
+    ASSERT_ARE_EQUAL(int, 0, async_logger_start(output, 16));
+
+    //act
+    LOG(AZ_LOG_TRACE, 0, "%s", long_message);
+    async_logger_stop();
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, ASYNC_LOGGER_MESSAGE_SIZE - 1, strlen(read_output(output)));
+    ASSERT_ARE_EQUAL(int, 0, async_logger_get_statistics(&statistics));
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.written);
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.truncated);
+
+    //cleanup
+    (void)fclose(output);
+}
+
+/*Tests_SRS_ASYNC_LOGGER_01_019: [ If the arguments did not fit in ASYNC_LOGGER_ARGUMENTS_SIZE or the message does not fit in ASYNC_LOGGER_MESSAGE_SIZE, the record shall be counted as truncated. ]*/
+TEST_FUNCTION(arguments_that_do_not_fit_are_dropped_and_the_record_is_counted_as_truncated)
+{
+    //arrange
+    FILE* output = tmpfile();
+    ASYNC_LOGGER_STATISTICS statistics;
+    ASSERT_IS_NOT_NULL(output);
+    ASSERT_ARE_EQUAL(int, 0, async_logger_start(output, 16));
+
+    //act
+    /*30 numbers take 270 bytes of arguments*/
+    LOG(AZ_LOG_TRACE, 0, TEST_TEN_NUMBERS_FORMAT TEST_TEN_NUMBERS_FORMAT TEST_TEN_NUMBERS_FORMAT,
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30);
+    async_logger_stop();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 ...", read_output(output));
+    ASSERT_ARE_EQUAL(int, 0, async_logger_get_statistics(&statistics));
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.written);
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.truncated);
+
+    //cleanup
+    (void)fclose(output);
+}
+
+/*Tests_SRS_ASYNC_LOGGER_01_016: [ async_logger_log shall capture the time, log_category, file, func, line, options and format, and store the arguments the conversions of format consume without formatting them by calling log_arguments_capture. ]*/
+TEST_FUNCTION(string_arguments_are_copied_when_logged)
+{
+    //arrange
+    FILE* output = tmpfile();
+    char argument[16];
+    ASSERT_IS_NOT_NULL(output);
+    ASSERT_ARE_EQUAL(int, 0, async_logger_start(output, 16));
+    (void)strcpy(argument, "before");
+
+    //act
+    /*holding the lock of the stream keeps the writer from writing the record before the argument changes*/
+    test_lock_output(output);
+    LOG(AZ_LOG_TRACE, 0, "%s %d", argument, 1);
+    (void)strcpy(argument, "after");
+    test_unlock_output(output);
+    async_logger_stop();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, "before 1", read_output(output));
+
+    //cleanup
+    (void)fclose(output);
+}
+
+/*Tests_SRS_ASYNC_LOGGER_01_017: [ The writer thread shall format the message from the format and the stored arguments by calling log_arguments_format, keeping as much of it as fits in ASYNC_LOGGER_MESSAGE_SIZE. ]*/
+TEST_FUNCTION(a_negative_star_precision_is_taken_as_no_precision)
+{
+    //arrange
+    FILE* output = tmpfile();
+    ASYNC_LOGGER_STATISTICS statistics;
+    ASSERT_IS_NOT_NULL(output);
+    ASSERT_ARE_EQUAL(int, 0, async_logger_start(output, 16));
+
+    //act
+    LOG(AZ_LOG_TRACE, 0, "%.*d|%.*s|%.*f|%.*d", -5, 42, -1, "abc", -3, 1.5, 3, 7);
+    async_logger_stop();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, "42|abc|1.500000|007", read_output(output));
+    ASSERT_ARE_EQUAL(int, 0, async_logger_get_statistics(&statistics));
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.truncated);
+
+    //cleanup
+    (void)fclose(output);
+}
+
+/*Tests_SRS_ASYNC_LOGGER_01_003: [ async_logger_start shall allocate a ring of capacity records rounded up to a power of 2. ]*/
+/*Tests_SRS_ASYNC_LOGGER_01_015: [ If the ring is full, async_logger_log shall count the record as dropped, wake the writer thread so that it reports the drop, and return. ]*/
+/*Tests_SRS_ASYNC_LOGGER_01_020: [ Once the writer thread has stopped, async_logger_stop shall write how many records were dropped since the writer thread last reported drops, then flush output. ]*/
+TEST_FUNCTION(when_the_ring_is_full_records_are_dropped_and_the_drops_are_reported)
+{
+    //arrange
+    FILE* output = tmpfile();
+    ASYNC_LOGGER_STATISTICS statistics;
+    const char* text;
+    size_t i;
+    ASSERT_IS_NOT_NULL(output);
+    ASSERT_ARE_EQUAL(int, 0, async_logger_start(output, 3));
+
+    //act
+    /*holding the lock of the stream stops the writer at its first record, which stays claimed until written*/
+    test_lock_output(output);
+    for (i = 0; i < 10; i++)
+    {
+        LOG(AZ_LOG_TRACE, LOG_LINE, "record %lu", (unsigned long)i);
+    }
+    ASSERT_ARE_EQUAL(int, 0, async_logger_get_statistics(&statistics));
+    test_unlock_output(output);
+    async_logger_stop();
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 6, statistics.dropped);
+    text = read_output(output);
+    ASSERT_IS_NOT_NULL(strstr(text, "record 0\r\nrecord 1\r\nrecord 2\r\nrecord 3\r\n"));
+    ASSERT_IS_NULL(strstr(text, "record 4"));
+    ASSERT_IS_NOT_NULL(strstr(text, "async_logger dropped 6 log records\r\n"));
+    ASSERT_ARE_EQUAL(int, 0, async_logger_get_statistics(&statistics));
+    ASSERT_ARE_EQUAL(size_t, 4, statistics.written);
+    ASSERT_ARE_EQUAL(size_t, 6, statistics.dropped);
+
+    //cleanup
+    (void)fclose(output);
+}
+
+/*Tests_SRS_ASYNC_LOGGER_01_009: [ async_logger_stop shall make async_logger_log ignore calls that start after this point and wait for the calls in progress to return. ]*/
+/*Tests_SRS_ASYNC_LOGGER_01_014: [ If the logger is not running, async_logger_log shall return. ]*/
+TEST_FUNCTION(async_logger_log_after_async_logger_stop_is_ignored)
+{
+    //arrange
+    FILE* output = tmpfile();
+    ASYNC_LOGGER_STATISTICS statistics;
+    ASSERT_IS_NOT_NULL(output);
+    ASSERT_ARE_EQUAL(int, 0, async_logger_start(output, 16));
+    async_logger_stop();
+
+    //act
+    async_logger_log(AZ_LOG_TRACE, __FILE__, "f", __LINE__, 0, "late");
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, "", read_output(output));
+    ASSERT_ARE_EQUAL(int, 0, async_logger_get_statistics(&statistics));
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.written);
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.dropped);
+
+    //cleanup
+    (void)fclose(output);
+}
+
+TEST_FUNCTION(records_logged_by_many_threads_are_all_written)
+{
+    //arrange
+    FILE* output = tmpfile();
+    THREAD_HANDLE threads[TEST_THREAD_COUNT];
+    ASYNC_LOGGER_STATISTICS statistics;
+    const char* text;
+    char last_record[64];
+    size_t i;
+    ASSERT_IS_NOT_NULL(output);
+    ASSERT_ARE_EQUAL(int, 0, async_logger_start(output, TEST_THREAD_COUNT * TEST_RECORDS_PER_THREAD));
+
+    //act
+    for (i = 0; i < TEST_THREAD_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Create(&threads[i], logging_thread, (void*)i));
+    }
+    for (i = 0; i < TEST_THREAD_COUNT; i++)
+    {
+        int thread_result;
+        ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Join(threads[i], &thread_result));
+    }
+    async_logger_stop();
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, async_logger_get_statistics(&statistics));
+    ASSERT_ARE_EQUAL(size_t, TEST_THREAD_COUNT * TEST_RECORDS_PER_THREAD, statistics.written);
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.dropped);
+    text = read_output(output);
+    ASSERT_ARE_EQUAL(size_t, TEST_THREAD_COUNT * TEST_RECORDS_PER_THREAD, count_occurrences(text, "Info: thread "));
+    for (i = 0; i < TEST_THREAD_COUNT; i++)
+    {
+        (void)snprintf(last_record, sizeof(last_record), "thread %lu record %lu\r\n", (unsigned long)i, (unsigned long)(TEST_RECORDS_PER_THREAD - 1));
+        ASSERT_IS_NOT_NULL(strstr(text, last_record));
+    }
+
+    //cleanup
+    (void)fclose(output);
+}
+
+END_TEST_SUITE(async_logger_unittests)
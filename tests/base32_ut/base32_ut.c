@@ -512,4 +512,275 @@ BEGIN_TEST_SUITE(base32_ut)
         STRING_delete(input);
     }
 
+    /* Tests_SRS_BASE32_01_001: [ If stream is NULL Base32_Encode_Stream_Init shall return. ] */
+    /* Tests_SRS_BASE32_01_009: [ If stream is NULL Base32_Decode_Stream_Init shall return. ] */
+    TEST_FUNCTION(Base32_Stream_Init_stream_NULL)
+    {
+        //arrange
+
+        //act
+        Base32_Encode_Stream_Init(NULL);
+        Base32_Decode_Stream_Init(NULL);
+
+        //assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /* Tests_SRS_BASE32_01_002: [ Base32_Encode_Stream_Init shall set stream to hold no bytes. ] */
+    /* Tests_SRS_BASE32_01_005: [ Base32_Encode_Stream_Update shall write the encoding of every complete block of 5 bytes formed by the bytes held in stream followed by source, keep the remaining bytes in stream, set written to the number of characters written and return 0. ] */
+    /* Tests_SRS_BASE32_01_008: [ Base32_Encode_Stream_Final shall write the encoding of the bytes held in stream padded with =, set written to the number of characters written, set stream to hold no bytes and return 0. ] */
+    TEST_FUNCTION(Base32_Encode_Stream_chunks_success)
+    {
+        size_t index;
+        size_t num_elements = sizeof(test_val_len)/sizeof(test_val_len[0]);
+
+        for (index = 0; index < num_elements; index++)
+        {
+            size_t chunk_size;
+            for (chunk_size = 1; chunk_size <= test_val_len[index].input_len; chunk_size++)
+            {
+                //arrange
+                BASE32_ENCODE_STREAM stream;
+                char encoded[64];
+                size_t encoded_len = 0;
+                size_t written;
+                size_t pos;
+                int result = 0;
+
+                Base32_Encode_Stream_Init(&stream);
+
+                //act
+                for (pos = 0; (result == 0) && (pos < test_val_len[index].input_len); pos += chunk_size)
+                {
+                    size_t count = (test_val_len[index].input_len - pos < chunk_size) ? test_val_len[index].input_len - pos : chunk_size;
+                    result = Base32_Encode_Stream_Update(&stream, test_val_len[index].input_data + pos, count, encoded + encoded_len, ((count + 4) / 5) * 8, &written);
+                    encoded_len += written;
+                }
+                if (result == 0)
+                {
+                    result = Base32_Encode_Stream_Final(&stream, encoded + encoded_len, sizeof(encoded) - encoded_len, &written);
+                    encoded_len += written;
+                }
+                encoded[encoded_len] = '\0';
+
+                //assert
+                ASSERT_ARE_EQUAL(int, 0, result);
+                ASSERT_ARE_EQUAL(char_ptr, test_val_len[index].base32_data, encoded);
+                ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+            }
+        }
+    }
+
+    /* Tests_SRS_BASE32_01_003: [ If stream or written is NULL, or source is NULL while size is not 0, or destination is NULL while destinationSize is not 0, Base32_Encode_Stream_Update shall fail and return a non-zero value. ] */
+    TEST_FUNCTION(Base32_Encode_Stream_Update_NULL_arguments_fail)
+    {
+        //arrange
+        BASE32_ENCODE_STREAM stream;
+        char encoded[8];
+        size_t written;
+
+        Base32_Encode_Stream_Init(&stream);
+
+        //act
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, Base32_Encode_Stream_Update(NULL, (const unsigned char*)"abcde", 5, encoded, sizeof(encoded), &written));
+        ASSERT_ARE_NOT_EQUAL(int, 0, Base32_Encode_Stream_Update(&stream, NULL, 5, encoded, sizeof(encoded), &written));
+        ASSERT_ARE_NOT_EQUAL(int, 0, Base32_Encode_Stream_Update(&stream, (const unsigned char*)"abcde", 5, NULL, sizeof(encoded), &written));
+        ASSERT_ARE_NOT_EQUAL(int, 0, Base32_Encode_Stream_Update(&stream, (const unsigned char*)"abcde", 5, encoded, sizeof(encoded), NULL));
+    }
+
+    /* Tests_SRS_BASE32_01_004: [ If destinationSize is smaller than 8 characters for every complete block of 5 bytes formed by the bytes held in stream followed by source, Base32_Encode_Stream_Update shall fail and return a non-zero value. ] */
+    TEST_FUNCTION(Base32_Encode_Stream_Update_destination_too_small_fail)
+    {
+        //arrange
+        BASE32_ENCODE_STREAM stream;
+        char encoded[8];
+        size_t written;
+        int result;
+
+        Base32_Encode_Stream_Init(&stream);
+        (void)Base32_Encode_Stream_Update(&stream, (const unsigned char*)"ab", 2, NULL, 0, &written);
+
+        //act
+        result = Base32_Encode_Stream_Update(&stream, (const unsigned char*)"cdefghij", 8, encoded, sizeof(encoded), &written);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
+    /* Tests_SRS_BASE32_01_006: [ If stream or written is NULL, or destination is NULL while destinationSize is not 0, Base32_Encode_Stream_Final shall fail and return a non-zero value. ] */
+    TEST_FUNCTION(Base32_Encode_Stream_Final_NULL_arguments_fail)
+    {
+        //arrange
+        BASE32_ENCODE_STREAM stream;
+        char encoded[8];
+        size_t written;
+
+        Base32_Encode_Stream_Init(&stream);
+
+        //act
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, Base32_Encode_Stream_Final(NULL, encoded, sizeof(encoded), &written));
+        ASSERT_ARE_NOT_EQUAL(int, 0, Base32_Encode_Stream_Final(&stream, NULL, sizeof(encoded), &written));
+        ASSERT_ARE_NOT_EQUAL(int, 0, Base32_Encode_Stream_Final(&stream, encoded, sizeof(encoded), NULL));
+    }
+
+    /* Tests_SRS_BASE32_01_007: [ If stream holds bytes and destinationSize is smaller than 8, Base32_Encode_Stream_Final shall fail and return a non-zero value. ] */
+    TEST_FUNCTION(Base32_Encode_Stream_Final_destination_too_small_fail)
+    {
+        //arrange
+        BASE32_ENCODE_STREAM stream;
+        char encoded[7];
+        size_t written;
+        int result;
+
+        Base32_Encode_Stream_Init(&stream);
+        (void)Base32_Encode_Stream_Update(&stream, (const unsigned char*)"a", 1, NULL, 0, &written);
+
+        //act
+        result = Base32_Encode_Stream_Final(&stream, encoded, sizeof(encoded), &written);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
+    /* Tests_SRS_BASE32_01_010: [ Base32_Decode_Stream_Init shall set stream to hold no characters and to accept more characters. ] */
+    /* Tests_SRS_BASE32_01_014: [ Otherwise Base32_Decode_Stream_Update shall write the bytes of every complete block of 8 characters, keep the remaining characters in stream, set written to the number of bytes written and return 0. ] */
+    /* Tests_SRS_BASE32_01_017: [ Otherwise Base32_Decode_Stream_Final shall set stream to hold no characters and to accept more characters and return 0. ] */
+    TEST_FUNCTION(Base32_Decode_Stream_chunks_success)
+    {
+        size_t index;
+        size_t num_elements = sizeof(test_val_len)/sizeof(test_val_len[0]);
+
+        for (index = 0; index < num_elements; index++)
+        {
+            const char* source = test_val_len[index].base32_data;
+            size_t source_len = strlen(source);
+            size_t chunk_size;
+            for (chunk_size = 1; chunk_size <= source_len; chunk_size++)
+            {
+                //arrange
+                BASE32_DECODE_STREAM stream;
+                unsigned char decoded[64];
+                size_t decoded_len = 0;
+                size_t written;
+                size_t pos;
+                int result = 0;
+
+                Base32_Decode_Stream_Init(&stream);
+
+                //act
+                for (pos = 0; (result == 0) && (pos < source_len); pos += chunk_size)
+                {
+                    size_t count = (source_len - pos < chunk_size) ? source_len - pos : chunk_size;
+                    result = Base32_Decode_Stream_Update(&stream, source + pos, count, decoded + decoded_len, ((count + 7) / 8) * 5, &written);
+                    decoded_len += written;
+                }
+
+                //assert
+                ASSERT_ARE_EQUAL(int, 0, result);
+                ASSERT_ARE_EQUAL(int, 0, Base32_Decode_Stream_Final(&stream));
+                ASSERT_ARE_EQUAL(size_t, test_val_len[index].input_len, decoded_len);
+                ASSERT_ARE_EQUAL(int, 0, memcmp(decoded, test_val_len[index].input_data, decoded_len));
+                ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+            }
+        }
+    }
+
+    /* Tests_SRS_BASE32_01_011: [ If stream or written is NULL, or source is NULL while sourceLength is not 0, or destination is NULL while destinationSize is not 0, Base32_Decode_Stream_Update shall fail and return a non-zero value. ] */
+    TEST_FUNCTION(Base32_Decode_Stream_Update_NULL_arguments_fail)
+    {
+        //arrange
+        BASE32_DECODE_STREAM stream;
+        unsigned char decoded[5];
+        size_t written;
+
+        Base32_Decode_Stream_Init(&stream);
+
+        //act
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, Base32_Decode_Stream_Update(NULL, "aebagbaf", 8, decoded, sizeof(decoded), &written));
+        ASSERT_ARE_NOT_EQUAL(int, 0, Base32_Decode_Stream_Update(&stream, NULL, 8, decoded, sizeof(decoded), &written));
+        ASSERT_ARE_NOT_EQUAL(int, 0, Base32_Decode_Stream_Update(&stream, "aebagbaf", 8, NULL, sizeof(decoded), &written));
+        ASSERT_ARE_NOT_EQUAL(int, 0, Base32_Decode_Stream_Update(&stream, "aebagbaf", 8, decoded, sizeof(decoded), NULL));
+    }
+
+    /* Tests_SRS_BASE32_01_012: [ If destinationSize is smaller than 5 bytes for every complete block of 8 characters formed by the characters held in stream followed by source, Base32_Decode_Stream_Update shall fail and return a non-zero value. ] */
+    TEST_FUNCTION(Base32_Decode_Stream_Update_destination_too_small_fail)
+    {
+        //arrange
+        BASE32_DECODE_STREAM stream;
+        unsigned char decoded[5];
+        size_t written;
+        int result;
+
+        Base32_Decode_Stream_Init(&stream);
+        (void)Base32_Decode_Stream_Update(&stream, "aeba", 4, NULL, 0, &written);
+
+        //act
+        result = Base32_Decode_Stream_Update(&stream, "gbafaydqqcik", 12, decoded, sizeof(decoded), &written);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
+    /* Tests_SRS_BASE32_01_013: [ If the characters contain a character outside of the base32 alphabet, padding that does not end a block of 8 with 1, 3, 4 or 6 =, or any character after the block holding =, Base32_Decode_Stream_Update shall fail and return a non-zero value. ] */
+    TEST_FUNCTION(Base32_Decode_Stream_Update_invalid_source_fail)
+    {
+        //arrange
+        static const char* invalid_sources[] = { "aebagba1", "aebagba\xC3", "ae=====a", "a=======", "aeb=====", "ae======aebagbaf", "ae======a" };
+        size_t index;
+
+        for (index = 0; index < sizeof(invalid_sources) / sizeof(invalid_sources[0]); index++)
+        {
+            BASE32_DECODE_STREAM stream;
+            unsigned char decoded[10];
+            size_t written;
+            int result;
+
+            Base32_Decode_Stream_Init(&stream);
+
+            //act
+            result = Base32_Decode_Stream_Update(&stream, invalid_sources[index], strlen(invalid_sources[index]), decoded, sizeof(decoded), &written);
+
+            //assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        }
+    }
+
+    /* Tests_SRS_BASE32_01_015: [ If stream is NULL Base32_Decode_Stream_Final shall fail and return a non-zero value. ] */
+    TEST_FUNCTION(Base32_Decode_Stream_Final_stream_NULL_fail)
+    {
+        //arrange
+        int result;
+
+        //act
+        result = Base32_Decode_Stream_Final(NULL);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
+    /* Tests_SRS_BASE32_01_016: [ If stream holds characters that do not form a complete block of 8, Base32_Decode_Stream_Final shall fail and return a non-zero value. ] */
+    TEST_FUNCTION(Base32_Decode_Stream_Final_incomplete_block_fail)
+    {
+        //arrange
+        BASE32_DECODE_STREAM stream;
+        unsigned char decoded[5];
+        size_t written;
+        int result;
+
+        Base32_Decode_Stream_Init(&stream);
+        (void)Base32_Decode_Stream_Update(&stream, "aebagbafay", 10, decoded, sizeof(decoded), &written);
+
+        //act
+        result = Base32_Decode_Stream_Final(&stream);
+
+        //assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
 END_TEST_SUITE(base32_ut)
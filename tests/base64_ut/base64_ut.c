@@ -1806,5 +1806,623 @@ TEST_FUNCTION(Base64_Decoder_invalid_length_fails_6)
 
 }
 
+/*Tests_SRS_BASE64_01_013: [ If the source string contains characters that are not valid base64 then Base64_Decoder shall return NULL. ]*/
+TEST_FUNCTION(Base64_Decoder_invalid_character_fails)
+{
+    ///Arrange
+    BUFFER_HANDLE result;
+
+    ///act
+    result = Base64_Decoder("QU*D");
+
+    ///assert
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_BASE64_01_001: [ Base64_Encode_Length shall return the number of characters in the base64 encoding of size bytes, not counting the terminating \0. ]*/
+TEST_FUNCTION(Base64_Encode_Length_succeeds)
+{
+    ///act
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, Base64_Encode_Length(0));
+    ASSERT_ARE_EQUAL(size_t, 4, Base64_Encode_Length(1));
+    ASSERT_ARE_EQUAL(size_t, 4, Base64_Encode_Length(2));
+    ASSERT_ARE_EQUAL(size_t, 4, Base64_Encode_Length(3));
+    ASSERT_ARE_EQUAL(size_t, 8, Base64_Encode_Length(4));
+}
+
+/*Tests_SRS_BASE64_01_002: [ If the encoded length does not fit in a size_t, Base64_Encode_Length shall return 0. ]*/
+TEST_FUNCTION(Base64_Encode_Length_with_huge_size_returns_0)
+{
+    ///act
+    size_t result = Base64_Encode_Length((size_t)-1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+/*Tests_SRS_BASE64_01_005: [ Base64_Encode_Into shall write the base64 encoding of source, padded with =, followed by a terminating \0 in destination and return 0. ]*/
+TEST_FUNCTION(Base64_Encode_Into_exhaustive_succeeds)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(testVector_BINARY_with_equal_signs) / sizeof(testVector_BINARY_with_equal_signs[0]); i++)
+    {
+        ///arrange
+        char encoded[64];
+        int result;
+
+        ///act
+        result = Base64_Encode_Into(testVector_BINARY_with_equal_signs[i].inputData, testVector_BINARY_with_equal_signs[i].inputLength, encoded, sizeof(encoded));
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, testVector_BINARY_with_equal_signs[i].expectedOutput, encoded);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+}
+
+/*Tests_SRS_BASE64_01_005: [ Base64_Encode_Into shall write the base64 encoding of source, padded with =, followed by a terminating \0 in destination and return 0. ]*/
+TEST_FUNCTION(Base64_Encode_Into_exact_size_succeeds)
+{
+    ///arrange
+    const char* leviathan = "any carnal pleasure.";
+    char encoded[29];
+    int result;
+
+    ///act
+    result = Base64_Encode_Into((const unsigned char*)leviathan, strlen(leviathan), encoded, sizeof(encoded));
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, "YW55IGNhcm5hbCBwbGVhc3VyZS4=", encoded);
+}
+
+/*Tests_SRS_BASE64_01_003: [ If destination is NULL, or source is NULL while size is not 0, Base64_Encode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Into_with_NULL_source_fails)
+{
+    ///arrange
+    char encoded[8];
+
+    ///act
+    int result = Base64_Encode_Into(NULL, 1, encoded, sizeof(encoded));
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_01_003: [ If destination is NULL, or source is NULL while size is not 0, Base64_Encode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Into_with_NULL_destination_fails)
+{
+    ///act
+    int result = Base64_Encode_Into((const unsigned char*)"a", 1, NULL, 8);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_01_004: [ If destinationSize is smaller than Base64_Encode_Length(size) + 1, Base64_Encode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Into_with_small_destination_fails)
+{
+    ///arrange
+    char encoded[4];
+
+    ///act
+    int result = Base64_Encode_Into((const unsigned char*)"a", 1, encoded, sizeof(encoded));
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_01_006: [ Base64_Decode_Length shall return the number of bytes encoded by the first sourceLength characters of source, taking the = padding into account. ]*/
+TEST_FUNCTION(Base64_Decode_Length_succeeds)
+{
+    ///act
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 1, Base64_Decode_Length("YQ==", 4));
+    ASSERT_ARE_EQUAL(size_t, 2, Base64_Decode_Length("YWI=", 4));
+    ASSERT_ARE_EQUAL(size_t, 3, Base64_Decode_Length("YWJj", 4));
+    ASSERT_ARE_EQUAL(size_t, 3, Base64_Decode_Length("YWJjYQ==", 4));
+}
+
+/*Tests_SRS_BASE64_01_007: [ If source is NULL or sourceLength is not a multiple of 4, Base64_Decode_Length shall return 0. ]*/
+TEST_FUNCTION(Base64_Decode_Length_with_invalid_length_returns_0)
+{
+    ///act
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 0, Base64_Decode_Length(NULL, 4));
+    ASSERT_ARE_EQUAL(size_t, 0, Base64_Decode_Length("YQ=", 3));
+}
+
+/*Tests_SRS_BASE64_01_012: [ Otherwise Base64_Decode_Into shall write the decoded bytes in destination, set decodedSize to their number and return 0. ]*/
+TEST_FUNCTION(Base64_Decode_Into_exhaustive_succeeds)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(testVector_BINARY_with_equal_signs) / sizeof(testVector_BINARY_with_equal_signs[0]); i++)
+    {
+        ///arrange
+        const char* source = testVector_BINARY_with_equal_signs[i].expectedOutput;
+        unsigned char decoded[64];
+        size_t decodedSize = 0;
+        int result;
+
+        ///act
+        result = Base64_Decode_Into(source, strlen(source), decoded, Base64_Decode_Length(source, strlen(source)), &decodedSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, testVector_BINARY_with_equal_signs[i].inputLength, decodedSize);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(decoded, testVector_BINARY_with_equal_signs[i].inputData, decodedSize));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+}
+
+/*Tests_SRS_BASE64_01_012: [ Otherwise Base64_Decode_Into shall write the decoded bytes in destination, set decodedSize to their number and return 0. ]*/
+TEST_FUNCTION(Base64_Decode_Into_does_not_need_a_terminated_source)
+{
+    ///arrange
+    unsigned char decoded[3];
+    size_t decodedSize = 0;
+
+    ///act
+    int result = Base64_Decode_Into("YWJj!!!!", 4, decoded, sizeof(decoded), &decodedSize);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 3, decodedSize);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(decoded, "abc", 3));
+}
+
+/*Tests_SRS_BASE64_01_008: [ If source or decodedSize is NULL, or destination is NULL while destinationSize is not 0, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Into_with_NULL_arguments_fails)
+{
+    ///arrange
+    unsigned char decoded[3];
+    size_t decodedSize;
+
+    ///act
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Into(NULL, 4, decoded, sizeof(decoded), &decodedSize));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Into("YWJj", 4, NULL, sizeof(decoded), &decodedSize));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Into("YWJj", 4, decoded, sizeof(decoded), NULL));
+}
+
+/*Tests_SRS_BASE64_01_009: [ If sourceLength is not a multiple of 4, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Into_with_invalid_length_fails)
+{
+    ///arrange
+    unsigned char decoded[3];
+    size_t decodedSize;
+
+    ///act
+    int result = Base64_Decode_Into("YWJ", 3, decoded, sizeof(decoded), &decodedSize);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_01_010: [ If destinationSize is smaller than Base64_Decode_Length(source, sourceLength), Base64_Decode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Into_with_small_destination_fails)
+{
+    ///arrange
+    unsigned char decoded[2];
+    size_t decodedSize;
+
+    ///act
+    int result = Base64_Decode_Into("YWJj", 4, decoded, sizeof(decoded), &decodedSize);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_01_011: [ If source contains a character outside of the base64 alphabet, or = anywhere but in the last 2 positions, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Into_with_invalid_characters_fails)
+{
+    ///arrange
+    static const char* invalidSources[] = { "YW-j", "YWJjYW\xC3j", "YQ==YWJj", "Y===", "YW=j", "====" };
+    size_t i;
+
+    for (i = 0; i < sizeof(invalidSources) / sizeof(invalidSources[0]); i++)
+    {
+        unsigned char decoded[6];
+        size_t decodedSize;
+
+        ///act
+        int result = Base64_Decode_Into(invalidSources[i], strlen(invalidSources[i]), decoded, sizeof(decoded), &decodedSize);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+}
+
+/*the encoding of the bytes 0 to 255: long enough for the vector code, and it holds every character of the alphabet*/
+static const char every_byte_value_encoded[] =
+    "AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJCUmJygpKissLS4vMDEyMzQ1Njc4OTo7PD0+P0BBQkNERUZHSElKS0xNTk9QUVJTVFVWV1hZWltcXV5fYGFi"
+    "Y2RlZmdoaWprbG1ub3BxcnN0dXZ3eHl6e3x9fn+AgYKDhIWGh4iJiouMjY6PkJGSk5SVlpeYmZqbnJ2en6ChoqOkpaanqKmqq6ytrq+wsbKztLW2t7i5uru8vb6/wMHCw8TF"
+    "xsfIycrLzM3Oz9DR0tPU1dbX2Nna29zd3t/g4eLj5OXm5+jp6uvs7e7v8PHy8/T19vf4+fr7/P3+/w==";
+
+/*Tests_SRS_BASE64_01_005: [ Base64_Encode_Into shall write the base64 encoding of source, padded with =, followed by a terminating \0 in destination and return 0. ]*/
+/*Tests_SRS_BASE64_01_012: [ Otherwise Base64_Decode_Into shall write the decoded bytes in destination, set decodedSize to their number and return 0. ]*/
+TEST_FUNCTION(Base64_Encode_Into_and_Decode_Into_round_trip_every_length_up_to_256_bytes)
+{
+    ///arrange
+    unsigned char source[256];
+    char encoded[sizeof(every_byte_value_encoded)];
+    unsigned char decoded[256];
+    size_t size;
+
+    for (size = 0; size < sizeof(source); size++)
+    {
+        source[size] = (unsigned char)size;
+    }
+
+    for (size = 0; size <= sizeof(source); size++)
+    {
+        size_t decodedSize = 0;
+        size_t encodedLength;
+
+        ///act
+        int encodeResult = Base64_Encode_Into(source, size, encoded, sizeof(encoded));
+        int decodeResult;
+        encodedLength = strlen(encoded);
+        decodeResult = Base64_Decode_Into(encoded, encodedLength, decoded, sizeof(decoded), &decodedSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, encodeResult);
+        ASSERT_ARE_EQUAL(size_t, Base64_Encode_Length(size), encodedLength);
+        /*the complete groups of 3 bytes encode the same way in any prefix*/
+        ASSERT_ARE_EQUAL(int, 0, strncmp(every_byte_value_encoded, encoded, (size / 3) * 4));
+        ASSERT_ARE_EQUAL(int, 0, decodeResult);
+        ASSERT_ARE_EQUAL(size_t, size, decodedSize);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(source, decoded, size));
+    }
+    ASSERT_ARE_EQUAL(char_ptr, every_byte_value_encoded, encoded);
+}
+
+/*Tests_SRS_BASE64_01_011: [ If source contains a character outside of the base64 alphabet, or = anywhere but in the last 2 positions, Base64_Decode_Into shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Into_with_an_invalid_character_anywhere_in_a_long_source_fails)
+{
+    ///arrange
+    static const char invalidCharacters[] = { '-', '_', '=', '\x80', ':', '@', '[', '`', '{' };
+    char source[sizeof(every_byte_value_encoded)];
+    unsigned char decoded[256];
+    size_t position;
+    size_t i;
+
+    (void)memcpy(source, every_byte_value_encoded, sizeof(source));
+
+    /*the last 2 characters are the padding*/
+    for (position = 0; position < sizeof(source) - 3; position++)
+    {
+        for (i = 0; i < sizeof(invalidCharacters); i++)
+        {
+            size_t decodedSize;
+            int result;
+            source[position] = invalidCharacters[i];
+
+            ///act
+            result = Base64_Decode_Into(source, sizeof(source) - 1, decoded, sizeof(decoded), &decodedSize);
+
+            ///assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        }
+        source[position] = every_byte_value_encoded[position];
+    }
+}
+
+/*Tests_SRS_BASE64_01_014: [ If stream is NULL, Base64_Encode_Stream_Init shall return. ]*/
+/*Tests_SRS_BASE64_01_022: [ If stream is NULL, Base64_Decode_Stream_Init shall return. ]*/
+TEST_FUNCTION(Base64_Stream_Init_with_NULL_stream_returns)
+{
+    ///act
+    Base64_Encode_Stream_Init(NULL);
+    Base64_Decode_Stream_Init(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_BASE64_01_015: [ Base64_Encode_Stream_Init shall set stream to hold no bytes. ]*/
+/*Tests_SRS_BASE64_01_018: [ Base64_Encode_Stream_Update shall write the encoding of every complete group of 3 bytes formed by the bytes held in stream followed by source, keep the remaining bytes in stream, set written to the number of characters written and return 0. ]*/
+/*Tests_SRS_BASE64_01_021: [ Base64_Encode_Stream_Final shall write the encoding of the bytes held in stream padded with =, set written to the number of characters written, set stream to hold no bytes and return 0. ]*/
+TEST_FUNCTION(Base64_Encode_Stream_in_chunks_of_every_size_succeeds)
+{
+    const char* leviathan = "any carnal pleasure.";
+    size_t size = strlen(leviathan);
+    size_t chunkSize;
+
+    for (chunkSize = 1; chunkSize <= size; chunkSize++)
+    {
+        ///arrange
+        BASE64_ENCODE_STREAM stream;
+        char encoded[29];
+        size_t length = 0;
+        size_t written;
+        size_t i;
+        int result = 0;
+
+        Base64_Encode_Stream_Init(&stream);
+
+        ///act
+        for (i = 0; (result == 0) && (i < size); i += chunkSize)
+        {
+            size_t count = ((size - i) < chunkSize) ? (size - i) : chunkSize;
+            result = Base64_Encode_Stream_Update(&stream, (const unsigned char*)leviathan + i, count, encoded + length, Base64_Encode_Length(count), &written);
+            length += written;
+        }
+        if (result == 0)
+        {
+            result = Base64_Encode_Stream_Final(&stream, encoded + length, sizeof(encoded) - length, &written);
+            length += written;
+        }
+        encoded[length] = '\0';
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, "YW55IGNhcm5hbCBwbGVhc3VyZS4=", encoded);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+}
+
+/*Tests_SRS_BASE64_01_018: [ Base64_Encode_Stream_Update shall write the encoding of every complete group of 3 bytes formed by the bytes held in stream followed by source, keep the remaining bytes in stream, set written to the number of characters written and return 0. ]*/
+TEST_FUNCTION(Base64_Encode_Stream_Update_keeps_an_incomplete_group)
+{
+    ///arrange
+    BASE64_ENCODE_STREAM stream;
+    char encoded[4];
+    size_t written = 42;
+    int result;
+
+    Base64_Encode_Stream_Init(&stream);
+
+    ///act
+    result = Base64_Encode_Stream_Update(&stream, (const unsigned char*)"ab", 2, NULL, 0, &written);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, written);
+    ASSERT_ARE_EQUAL(int, 0, Base64_Encode_Stream_Final(&stream, encoded, sizeof(encoded), &written));
+    ASSERT_ARE_EQUAL(size_t, 4, written);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(encoded, "YWI=", 4));
+}
+
+/*Tests_SRS_BASE64_01_016: [ If stream or written is NULL, or source is NULL while size is not 0, or destination is NULL while destinationSize is not 0, Base64_Encode_Stream_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Stream_Update_with_NULL_arguments_fails)
+{
+    ///arrange
+    BASE64_ENCODE_STREAM stream;
+    char encoded[4];
+    size_t written;
+
+    Base64_Encode_Stream_Init(&stream);
+
+    ///act
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Stream_Update(NULL, (const unsigned char*)"abc", 3, encoded, sizeof(encoded), &written));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Stream_Update(&stream, NULL, 3, encoded, sizeof(encoded), &written));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Stream_Update(&stream, (const unsigned char*)"abc", 3, NULL, sizeof(encoded), &written));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Stream_Update(&stream, (const unsigned char*)"abc", 3, encoded, sizeof(encoded), NULL));
+}
+
+/*Tests_SRS_BASE64_01_017: [ If destinationSize is smaller than the number of characters encoding the complete groups of 3 bytes formed by the bytes held in stream followed by source, Base64_Encode_Stream_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Stream_Update_with_small_destination_fails)
+{
+    ///arrange
+    BASE64_ENCODE_STREAM stream;
+    char encoded[4];
+    size_t written;
+
+    Base64_Encode_Stream_Init(&stream);
+    (void)Base64_Encode_Stream_Update(&stream, (const unsigned char*)"ab", 2, NULL, 0, &written);
+
+    ///act
+    int result = Base64_Encode_Stream_Update(&stream, (const unsigned char*)"cdef", 4, encoded, sizeof(encoded), &written);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_01_019: [ If stream or written is NULL, or destination is NULL while destinationSize is not 0, Base64_Encode_Stream_Final shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Stream_Final_with_NULL_arguments_fails)
+{
+    ///arrange
+    BASE64_ENCODE_STREAM stream;
+    char encoded[4];
+    size_t written;
+
+    Base64_Encode_Stream_Init(&stream);
+
+    ///act
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Stream_Final(NULL, encoded, sizeof(encoded), &written));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Stream_Final(&stream, NULL, sizeof(encoded), &written));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Encode_Stream_Final(&stream, encoded, sizeof(encoded), NULL));
+}
+
+/*Tests_SRS_BASE64_01_020: [ If stream holds bytes and destinationSize is smaller than 4, Base64_Encode_Stream_Final shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Encode_Stream_Final_with_small_destination_fails)
+{
+    ///arrange
+    BASE64_ENCODE_STREAM stream;
+    char encoded[3];
+    size_t written;
+
+    Base64_Encode_Stream_Init(&stream);
+    (void)Base64_Encode_Stream_Update(&stream, (const unsigned char*)"a", 1, NULL, 0, &written);
+
+    ///act
+    int result = Base64_Encode_Stream_Final(&stream, encoded, sizeof(encoded), &written);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_01_021: [ Base64_Encode_Stream_Final shall write the encoding of the bytes held in stream padded with =, set written to the number of characters written, set stream to hold no bytes and return 0. ]*/
+TEST_FUNCTION(Base64_Encode_Stream_Final_on_complete_groups_writes_nothing)
+{
+    ///arrange
+    BASE64_ENCODE_STREAM stream;
+    char encoded[4];
+    size_t written;
+
+    Base64_Encode_Stream_Init(&stream);
+    (void)Base64_Encode_Stream_Update(&stream, (const unsigned char*)"abc", 3, encoded, sizeof(encoded), &written);
+
+    ///act
+    int result = Base64_Encode_Stream_Final(&stream, NULL, 0, &written);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, written);
+}
+
+/*Tests_SRS_BASE64_01_023: [ Base64_Decode_Stream_Init shall set stream to hold no characters and to accept more characters. ]*/
+/*Tests_SRS_BASE64_01_027: [ Otherwise Base64_Decode_Stream_Update shall write the bytes of every complete group of 4 characters, keep the remaining characters in stream, set written to the number of bytes written and return 0. ]*/
+/*Tests_SRS_BASE64_01_030: [ Otherwise Base64_Decode_Stream_Final shall set stream to hold no characters and to accept more characters and return 0. ]*/
+TEST_FUNCTION(Base64_Decode_Stream_in_chunks_of_every_size_succeeds)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(testVector_BINARY_with_equal_signs) / sizeof(testVector_BINARY_with_equal_signs[0]); i++)
+    {
+        const char* source = testVector_BINARY_with_equal_signs[i].expectedOutput;
+        size_t sourceLength = strlen(source);
+        size_t chunkSize;
+
+        for (chunkSize = 1; chunkSize <= sourceLength; chunkSize++)
+        {
+            ///arrange
+            BASE64_DECODE_STREAM stream;
+            unsigned char decoded[64];
+            size_t decodedSize = 0;
+            size_t written;
+            size_t j;
+            int result = 0;
+
+            Base64_Decode_Stream_Init(&stream);
+
+            ///act
+            for (j = 0; (result == 0) && (j < sourceLength); j += chunkSize)
+            {
+                size_t count = ((sourceLength - j) < chunkSize) ? (sourceLength - j) : chunkSize;
+                result = Base64_Decode_Stream_Update(&stream, source + j, count, decoded + decodedSize, ((count + 3) / 4) * 3, &written);
+                decodedSize += written;
+            }
+
+            ///assert
+            ASSERT_ARE_EQUAL(int, 0, result);
+            ASSERT_ARE_EQUAL(int, 0, Base64_Decode_Stream_Final(&stream));
+            ASSERT_ARE_EQUAL(size_t, testVector_BINARY_with_equal_signs[i].inputLength, decodedSize);
+            ASSERT_ARE_EQUAL(int, 0, memcmp(decoded, testVector_BINARY_with_equal_signs[i].inputData, decodedSize));
+            ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        }
+    }
+}
+
+/*Tests_SRS_BASE64_01_024: [ If stream or written is NULL, or source is NULL while sourceLength is not 0, or destination is NULL while destinationSize is not 0, Base64_Decode_Stream_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Stream_Update_with_NULL_arguments_fails)
+{
+    ///arrange
+    BASE64_DECODE_STREAM stream;
+    unsigned char decoded[3];
+    size_t written;
+
+    Base64_Decode_Stream_Init(&stream);
+
+    ///act
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Stream_Update(NULL, "YWJj", 4, decoded, sizeof(decoded), &written));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Stream_Update(&stream, NULL, 4, decoded, sizeof(decoded), &written));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Stream_Update(&stream, "YWJj", 4, NULL, sizeof(decoded), &written));
+    ASSERT_ARE_NOT_EQUAL(int, 0, Base64_Decode_Stream_Update(&stream, "YWJj", 4, decoded, sizeof(decoded), NULL));
+}
+
+/*Tests_SRS_BASE64_01_025: [ If destinationSize is smaller than 3 bytes for every complete group of 4 characters formed by the characters held in stream followed by source, Base64_Decode_Stream_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Stream_Update_with_small_destination_fails)
+{
+    ///arrange
+    BASE64_DECODE_STREAM stream;
+    unsigned char decoded[3];
+    size_t written;
+
+    Base64_Decode_Stream_Init(&stream);
+    (void)Base64_Decode_Stream_Update(&stream, "YW", 2, NULL, 0, &written);
+
+    ///act
+    int result = Base64_Decode_Stream_Update(&stream, "JjYWJj", 6, decoded, sizeof(decoded), &written);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_01_026: [ If the characters contain a character outside of the base64 alphabet, = anywhere but at the end of a group of 4, or any character after the group holding =, Base64_Decode_Stream_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Stream_Update_with_invalid_characters_fails)
+{
+    ///arrange
+    static const char* invalidSources[] = { "YW-j", "YWJjYW\xC3j", "YQ==YWJj", "Y===", "YW=j", "====", "YQ==Y" };
+    size_t i;
+
+    for (i = 0; i < sizeof(invalidSources) / sizeof(invalidSources[0]); i++)
+    {
+        BASE64_DECODE_STREAM stream;
+        unsigned char decoded[6];
+        size_t written;
+
+        Base64_Decode_Stream_Init(&stream);
+
+        ///act
+        int result = Base64_Decode_Stream_Update(&stream, invalidSources[i], strlen(invalidSources[i]), decoded, sizeof(decoded), &written);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+}
+
+/*Tests_SRS_BASE64_01_026: [ If the characters contain a character outside of the base64 alphabet, = anywhere but at the end of a group of 4, or any character after the group holding =, Base64_Decode_Stream_Update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Stream_Update_after_padding_fails)
+{
+    ///arrange
+    BASE64_DECODE_STREAM stream;
+    unsigned char decoded[3];
+    size_t written;
+
+    Base64_Decode_Stream_Init(&stream);
+    ASSERT_ARE_EQUAL(int, 0, Base64_Decode_Stream_Update(&stream, "YQ==", 4, decoded, sizeof(decoded), &written));
+
+    ///act
+    int result = Base64_Decode_Stream_Update(&stream, "YWJj", 4, decoded, sizeof(decoded), &written);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_01_028: [ If stream is NULL, Base64_Decode_Stream_Final shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Stream_Final_with_NULL_stream_fails)
+{
+    ///act
+    int result = Base64_Decode_Stream_Final(NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_BASE64_01_029: [ If stream holds characters that do not form a complete group of 4, Base64_Decode_Stream_Final shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(Base64_Decode_Stream_Final_with_incomplete_group_fails)
+{
+    ///arrange
+    BASE64_DECODE_STREAM stream;
+    unsigned char decoded[3];
+    size_t written;
+
+    Base64_Decode_Stream_Init(&stream);
+    (void)Base64_Decode_Stream_Update(&stream, "YWJjYW", 6, decoded, sizeof(decoded), &written);
+
+    ///act
+    int result = Base64_Decode_Stream_Final(&stream);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
 
 END_TEST_SUITE(base64_unittests);
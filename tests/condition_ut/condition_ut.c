@@ -185,6 +185,41 @@ TEST_FUNCTION(Condition_Post_Handle_Succeed)
     Condition_Deinit(handle);
 }
 
+// Tests_SRS_CONDITION_01_001: [ Condition_PostAll shall return COND_INVALID_ARG if handle is NULL ]
+TEST_FUNCTION(Condition_PostAll_Handle_NULL_Failure)
+{
+    //arrange
+    COND_RESULT result;
+
+    //act
+    result = Condition_PostAll(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(COND_RESULT, COND_INVALID_ARG, result);
+}
+
+// Tests_SRS_CONDITION_01_002: [ Condition_PostAll shall unblock every thread waiting on the condition and return COND_OK ]
+TEST_FUNCTION(Condition_PostAll_without_waiters_Succeed)
+{
+    //arrange
+    COND_HANDLE handle = NULL;
+    COND_RESULT result;
+
+    EXPECTED_CALL(gballoc_malloc(4));
+    EXPECTED_CALL(gballoc_free(0));
+
+    handle = Condition_Init();
+
+    //act
+    result = Condition_PostAll(handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(COND_RESULT, COND_OK, result);
+
+    //free
+    Condition_Deinit(handle);
+}
+
 // Tests_SRS_CONDITION_18_004: [ Condition_Wait shall return COND_INVALID_ARG if handle is NULL ]
 TEST_FUNCTION(Condition_Wait_Handle_NULL_Fail)
 {
@@ -388,6 +423,126 @@ TEST_FUNCTION(Condition_Wait_ok_on_trigger_with_timeout)
     umock_c_reset_all_calls();
 }
 
+#define POST_ALL_WAITER_COUNT 3
+
+typedef struct POST_ALL_CONTEXT_TAG
+{
+    LOCK_HANDLE lock;
+    COND_HANDLE condition;
+    int waiting_count;
+    int released;
+    int woken_count;
+} POST_ALL_CONTEXT;
+
+static int post_all_waiter_thread_proc(void *h)
+{
+    POST_ALL_CONTEXT* context = (POST_ALL_CONTEXT*)h;
+    COND_RESULT result = COND_OK;
+
+    Lock(context->lock);
+    context->waiting_count++;
+    while ((context->released == 0) && (result == COND_OK))
+    {
+        result = Condition_Wait(context->condition, context->lock, 10000);
+    }
+    if (result == COND_OK)
+    {
+        context->woken_count++;
+    }
+    Unlock(context->lock);
+    return 0;
+}
+
+// Tests_SRS_CONDITION_01_002: [ Condition_PostAll shall unblock every thread waiting on the condition and return COND_OK ]
+TEST_FUNCTION(Condition_PostAll_wakes_every_waiter)
+{
+    // arrange
+    POST_ALL_CONTEXT context;
+    THREAD_HANDLE threads[POST_ALL_WAITER_COUNT];
+    COND_RESULT result;
+    int waiting_count;
+    int i;
+    context.condition = Condition_Init();
+    context.lock = Lock_Init();
+    context.waiting_count = 0;
+    context.released = 0;
+    context.woken_count = 0;
+    for (i = 0; i < POST_ALL_WAITER_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&threads[i], post_all_waiter_thread_proc, &context));
+    }
+    do
+    {
+        ThreadAPI_Sleep(10);
+        Lock(context.lock);
+        waiting_count = context.waiting_count;
+        Unlock(context.lock);
+    } while (waiting_count < POST_ALL_WAITER_COUNT);
+
+    // act
+    Lock(context.lock);
+    context.released = 1;
+    result = Condition_PostAll(context.condition);
+    Unlock(context.lock);
+    for (i = 0; i < POST_ALL_WAITER_COUNT; i++)
+    {
+        ThreadAPI_Join(threads[i], NULL);
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(COND_RESULT, COND_OK, result);
+    ASSERT_ARE_EQUAL(int, POST_ALL_WAITER_COUNT, context.woken_count);
+    Lock_Deinit(context.lock);
+    Condition_Deinit(context.condition);
+    umock_c_reset_all_calls();
+}
+
+// Tests_SRS_CONDITION_01_004: [ A post shall only unblock threads that are waiting on the condition when it is made; posts beyond the number of waiters shall not unblock a later Condition_Wait ]
+TEST_FUNCTION(Condition_Post_repeated_for_one_waiter_does_not_unblock_a_later_wait)
+{
+    // arrange
+    POST_ALL_CONTEXT context;
+    THREAD_HANDLE thread;
+    COND_RESULT result;
+    int waiting_count;
+    int i;
+    context.condition = Condition_Init();
+    context.lock = Lock_Init();
+    context.waiting_count = 0;
+    context.released = 0;
+    context.woken_count = 0;
+    ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&thread, post_all_waiter_thread_proc, &context));
+    do
+    {
+        ThreadAPI_Sleep(10);
+        Lock(context.lock);
+        waiting_count = context.waiting_count;
+        Unlock(context.lock);
+    } while (waiting_count < 1);
+
+    Lock(context.lock);
+    context.released = 1;
+    for (i = 0; i < 5; i++)
+    {
+        (void)Condition_Post(context.condition);
+    }
+    (void)Condition_PostAll(context.condition);
+    Unlock(context.lock);
+    ThreadAPI_Join(thread, NULL);
+
+    // act
+    Lock(context.lock);
+    result = Condition_Wait(context.condition, context.lock, 150);
+    Unlock(context.lock);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 1, context.woken_count);
+    ASSERT_ARE_EQUAL(COND_RESULT, COND_TIMEOUT, result);
+    Lock_Deinit(context.lock);
+    Condition_Deinit(context.condition);
+    umock_c_reset_all_calls();
+}
+
 END_TEST_SUITE(Condition_UnitTests);
 
 /*if malloc is defined as gballoc_malloc at this moment, there'd be serious trouble*/
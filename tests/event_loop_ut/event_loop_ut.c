@@ -0,0 +1,942 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#endif
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+
+/*the loop runs on a real epoll instance and real socket pairs; allocations and the xio are mocked*/
+static size_t malloc_call_count;
+static size_t malloc_fail_index;
+
+static void* my_gballoc_malloc(size_t size)
+{
+    void* result;
+
+    if (malloc_call_count++ == malloc_fail_index)
+    {
+        result = NULL;
+    }
+    else
+    {
+        result = malloc(size);
+    }
+
+    return result;
+}
+
+static void* my_gballoc_realloc(void* ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+static void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/xio.h"
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/event_loop.h"
+
+#define TEST_XIO                ((XIO_HANDLE)0x4242)
+#define TEST_TIMER_MS           20
+#define TEST_WAIT_MS            1000
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+/*what the callbacks of a test saw*/
+typedef struct TEST_STATE_TAG
+{
+    EVENT_LOOP_HANDLE event_loop;
+    int fds[2];
+    int other_fds[2];
+    EVENT_LOOP_WATCH_HANDLE watches[2];
+    EVENT_LOOP_TIMER_HANDLE timer;
+    EVENT_LOOP_XIO_HANDLE event_loop_xio;
+    size_t ready_count;
+    unsigned int ready_events;
+    size_t timer_count;
+    size_t dowork_count;
+    int setoption_result;
+    XIO_EVENT_BINDING event_binding;
+    bool remove_xio_on_dowork;
+} TEST_STATE;
+
+static TEST_STATE test_state;
+
+static int my_xio_setoption(XIO_HANDLE xio, const char* optionName, const void* value)
+{
+    (void)xio;
+    (void)optionName;
+
+    if (test_state.setoption_result == 0)
+    {
+        test_state.event_binding = *(const XIO_EVENT_BINDING*)value;
+    }
+
+    return test_state.setoption_result;
+}
+
+static void my_xio_dowork(XIO_HANDLE xio)
+{
+    (void)xio;
+
+    test_state.dowork_count++;
+    if (test_state.remove_xio_on_dowork)
+    {
+        event_loop_remove_xio(test_state.event_loop_xio);
+        test_state.event_loop_xio = NULL;
+    }
+}
+
+static void on_fd_ready(void* context, unsigned int events)
+{
+    TEST_STATE* state = (TEST_STATE*)context;
+
+    state->ready_count++;
+    state->ready_events |= events;
+}
+
+/*whichever watch is ready first releases the other one*/
+static void unwatch_other_on_fd_ready(void* context, unsigned int events)
+{
+    TEST_STATE* state = (TEST_STATE*)context;
+
+    on_fd_ready(context, events);
+    if (state->watches[0] != NULL)
+    {
+        event_loop_unwatch_fd(state->watches[0]);
+        state->watches[0] = NULL;
+    }
+    if (state->watches[1] != NULL)
+    {
+        event_loop_unwatch_fd(state->watches[1]);
+        state->watches[1] = NULL;
+    }
+}
+
+static void on_timer(void* context)
+{
+    TEST_STATE* state = (TEST_STATE*)context;
+
+    state->timer_count++;
+}
+
+static void cancel_own_timer(void* context)
+{
+    TEST_STATE* state = (TEST_STATE*)context;
+
+    state->timer_count++;
+    event_loop_timer_cancel(state->timer);
+    state->timer = NULL;
+}
+
+static void stop_on_timer(void* context)
+{
+    TEST_STATE* state = (TEST_STATE*)context;
+
+    state->timer_count++;
+    event_loop_stop(state->event_loop);
+}
+
+static uint64_t get_time_ms(void)
+{
+    struct timeval now;
+    (void)gettimeofday(&now, NULL);
+    return ((uint64_t)now.tv_sec * 1000) + ((uint64_t)now.tv_usec / 1000);
+}
+
+/*runs the loop until the counter reaches count, or TEST_WAIT_MS went by*/
+static void run_until(const size_t* counter, size_t count)
+{
+    uint64_t start_ms = get_time_ms();
+
+    while ((*counter < count) && (get_time_ms() - start_ms < TEST_WAIT_MS))
+    {
+        ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, 10));
+    }
+}
+
+static void write_byte(int fd)
+{
+    unsigned char byte = 0x42;
+    ASSERT_ARE_EQUAL(int, 1, (int)write(fd, &byte, 1));
+}
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(event_loop_unittests)
+
+TEST_SUITE_INITIALIZE(TestSuiteInitialize)
+{
+    int result;
+
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    umock_c_init(on_umock_c_error);
+
+    result = umocktypes_charptr_register_types();
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    REGISTER_UMOCK_ALIAS_TYPE(XIO_HANDLE, void*);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+    REGISTER_GLOBAL_MOCK_HOOK(xio_setoption, my_xio_setoption);
+    REGISTER_GLOBAL_MOCK_HOOK(xio_dowork, my_xio_dowork);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(f)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    malloc_call_count = 0;
+    malloc_fail_index = SIZE_MAX;
+
+    test_state.event_loop = NULL;
+    ASSERT_ARE_EQUAL(int, 0, socketpair(AF_UNIX, SOCK_STREAM, 0, test_state.fds));
+    ASSERT_ARE_EQUAL(int, 0, socketpair(AF_UNIX, SOCK_STREAM, 0, test_state.other_fds));
+    test_state.watches[0] = NULL;
+    test_state.watches[1] = NULL;
+    test_state.timer = NULL;
+    test_state.event_loop_xio = NULL;
+    test_state.ready_count = 0;
+    test_state.ready_events = 0;
+    test_state.timer_count = 0;
+    test_state.dowork_count = 0;
+    test_state.setoption_result = 0;
+    test_state.event_binding.set_interest = NULL;
+    test_state.event_binding.context = NULL;
+    test_state.remove_xio_on_dowork = false;
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(cleans)
+{
+    if (test_state.event_loop != NULL)
+    {
+        event_loop_destroy(test_state.event_loop);
+    }
+    (void)close(test_state.fds[0]);
+    (void)close(test_state.fds[1]);
+    (void)close(test_state.other_fds[0]);
+    (void)close(test_state.other_fds[1]);
+
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* event_loop_create */
+
+/*Tests_SRS_EVENT_LOOP_01_001: [ event_loop_create shall allocate a loop, create an epoll instance, an eventfd registered with it and a tick counter. ]*/
+TEST_FUNCTION(event_loop_create_succeeds)
+{
+    //act
+    test_state.event_loop = event_loop_create();
+
+    //assert
+    ASSERT_IS_NOT_NULL(test_state.event_loop);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_002: [ If any of the above fails, event_loop_create shall free everything it created and return NULL. ]*/
+TEST_FUNCTION(when_allocating_the_loop_fails_event_loop_create_fails)
+{
+    //arrange
+    EVENT_LOOP_HANDLE event_loop;
+    malloc_fail_index = 0;
+
+    //act
+    event_loop = event_loop_create();
+
+    //assert
+    ASSERT_IS_NULL(event_loop);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_002: [ If any of the above fails, event_loop_create shall free everything it created and return NULL. ]*/
+TEST_FUNCTION(when_creating_the_tick_counter_fails_event_loop_create_fails)
+{
+    //arrange
+    EVENT_LOOP_HANDLE event_loop;
+    malloc_fail_index = 1;
+
+    //act
+    event_loop = event_loop_create();
+
+    //assert
+    ASSERT_IS_NULL(event_loop);
+}
+
+/* event_loop_destroy */
+
+/*Tests_SRS_EVENT_LOOP_01_003: [ If event_loop is NULL, event_loop_destroy shall return. ]*/
+TEST_FUNCTION(event_loop_destroy_with_NULL_returns)
+{
+    //act
+    event_loop_destroy(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_EVENT_LOOP_01_004: [ event_loop_destroy shall free the watches and timers that were not released, close the descriptors of the loop and free it. ]*/
+TEST_FUNCTION(event_loop_destroy_frees_the_watches_and_timers_left)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+    ASSERT_IS_NOT_NULL(event_loop_watch_fd(test_state.event_loop, test_state.fds[0], EVENT_LOOP_READABLE, on_fd_ready, &test_state));
+    ASSERT_IS_NOT_NULL(event_loop_timer_start(test_state.event_loop, 0, TEST_TIMER_MS, on_timer, &test_state));
+    ASSERT_IS_NOT_NULL(event_loop_timer_start(test_state.event_loop, TEST_WAIT_MS, 0, on_timer, &test_state));
+
+    //act
+    event_loop_destroy(test_state.event_loop);
+    test_state.event_loop = NULL;
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.ready_count);
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.timer_count);
+}
+
+/* event_loop_run_once */
+
+/*Tests_SRS_EVENT_LOOP_01_005: [ If event_loop is NULL, event_loop_run_once shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(event_loop_run_once_with_NULL_event_loop_fails)
+{
+    //act
+    int result = event_loop_run_once(NULL, 0);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_006: [ event_loop_run_once shall wait with epoll_wait up to max_wait_ms, or less if a timer is due earlier, or without limit if max_wait_ms is EVENT_LOOP_WAIT_INFINITE and no timer is running. ]*/
+TEST_FUNCTION(event_loop_run_once_with_nothing_ready_waits_max_wait_ms)
+{
+    //arrange
+    uint64_t start_ms;
+    int result;
+    test_state.event_loop = event_loop_create();
+    start_ms = get_time_ms();
+
+    //act
+    result = event_loop_run_once(test_state.event_loop, TEST_TIMER_MS);
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(get_time_ms() - start_ms >= TEST_TIMER_MS - 1);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_006: [ event_loop_run_once shall wait with epoll_wait up to max_wait_ms, or less if a timer is due earlier, or without limit if max_wait_ms is EVENT_LOOP_WAIT_INFINITE and no timer is running. ]*/
+TEST_FUNCTION(event_loop_run_once_waits_only_until_the_first_timer_is_due)
+{
+    //arrange
+    uint64_t start_ms;
+    test_state.event_loop = event_loop_create();
+    ASSERT_IS_NOT_NULL(event_loop_timer_start(test_state.event_loop, TEST_TIMER_MS, 0, on_timer, &test_state));
+    start_ms = get_time_ms();
+
+    //act
+    while ((test_state.timer_count == 0) && (get_time_ms() - start_ms < TEST_WAIT_MS))
+    {
+        ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, EVENT_LOOP_WAIT_INFINITE));
+    }
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_state.timer_count);
+    ASSERT_IS_TRUE(get_time_ms() - start_ms < TEST_WAIT_MS);
+}
+
+/* event_loop_run */
+
+/*Tests_SRS_EVENT_LOOP_01_008: [ If event_loop is NULL, event_loop_run shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(event_loop_run_with_NULL_event_loop_fails)
+{
+    //act
+    int result = event_loop_run(NULL);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_009: [ event_loop_run shall call event_loop_run_once until event_loop_stop is called and then return 0, or return a non-zero value as soon as event_loop_run_once fails. ]*/
+/*Tests_SRS_EVENT_LOOP_01_010: [ event_loop_stop shall write to the eventfd of the loop, which makes event_loop_run return after the current iteration. ]*/
+TEST_FUNCTION(event_loop_run_returns_once_stopped_from_a_timer)
+{
+    //arrange
+    int result;
+    test_state.event_loop = event_loop_create();
+    ASSERT_IS_NOT_NULL(event_loop_timer_start(test_state.event_loop, TEST_TIMER_MS, TEST_TIMER_MS, stop_on_timer, &test_state));
+
+    //act
+    result = event_loop_run(test_state.event_loop);
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, test_state.timer_count);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_010: [ event_loop_stop shall write to the eventfd of the loop, which makes event_loop_run return after the current iteration. ]*/
+TEST_FUNCTION(event_loop_run_returns_when_stopped_before_it_runs)
+{
+    //arrange
+    int result;
+    test_state.event_loop = event_loop_create();
+    event_loop_stop(test_state.event_loop);
+
+    //act
+    result = event_loop_run(test_state.event_loop);
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+}
+
+/* event_loop_watch_fd */
+
+/*Tests_SRS_EVENT_LOOP_01_012: [ If event_loop or on_fd_ready is NULL or fd is negative, event_loop_watch_fd shall fail and return NULL. ]*/
+TEST_FUNCTION(event_loop_watch_fd_with_invalid_arguments_fails)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+
+    //act
+    //assert
+    ASSERT_IS_NULL(event_loop_watch_fd(NULL, test_state.fds[0], EVENT_LOOP_READABLE, on_fd_ready, &test_state));
+    ASSERT_IS_NULL(event_loop_watch_fd(test_state.event_loop, -1, EVENT_LOOP_READABLE, on_fd_ready, &test_state));
+    ASSERT_IS_NULL(event_loop_watch_fd(test_state.event_loop, test_state.fds[0], EVENT_LOOP_READABLE, NULL, &test_state));
+}
+
+/*Tests_SRS_EVENT_LOOP_01_013: [ If allocating the watch or adding fd to the epoll instance fails, event_loop_watch_fd shall fail and return NULL. ]*/
+TEST_FUNCTION(when_allocating_the_watch_fails_event_loop_watch_fd_fails)
+{
+    //arrange
+    EVENT_LOOP_WATCH_HANDLE watch;
+    test_state.event_loop = event_loop_create();
+    malloc_call_count = 0;
+    malloc_fail_index = 0;
+
+    //act
+    watch = event_loop_watch_fd(test_state.event_loop, test_state.fds[0], EVENT_LOOP_READABLE, on_fd_ready, &test_state);
+
+    //assert
+    ASSERT_IS_NULL(watch);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_013: [ If allocating the watch or adding fd to the epoll instance fails, event_loop_watch_fd shall fail and return NULL. ]*/
+TEST_FUNCTION(watching_the_same_fd_twice_fails)
+{
+    //arrange
+    EVENT_LOOP_WATCH_HANDLE watch;
+    test_state.event_loop = event_loop_create();
+    ASSERT_IS_NOT_NULL(event_loop_watch_fd(test_state.event_loop, test_state.fds[0], EVENT_LOOP_READABLE, on_fd_ready, &test_state));
+
+    //act
+    watch = event_loop_watch_fd(test_state.event_loop, test_state.fds[0], EVENT_LOOP_READABLE, on_fd_ready, &test_state);
+
+    //assert
+    ASSERT_IS_NULL(watch);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_011: [ When the descriptor is ready for one of the events of a watch, event_loop_run_once shall call on_fd_ready with the context and the ready events. ]*/
+/*Tests_SRS_EVENT_LOOP_01_014: [ event_loop_watch_fd shall add fd to the epoll instance for events and return the watch; a watch for no event is not added until its events are set. ]*/
+TEST_FUNCTION(a_readable_fd_calls_on_fd_ready)
+{
+    //arrange
+    EVENT_LOOP_WATCH_HANDLE watch;
+    test_state.event_loop = event_loop_create();
+    watch = event_loop_watch_fd(test_state.event_loop, test_state.fds[0], EVENT_LOOP_READABLE, on_fd_ready, &test_state);
+    ASSERT_IS_NOT_NULL(watch);
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, 0));
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.ready_count);
+    write_byte(test_state.fds[1]);
+
+    //act
+    run_until(&test_state.ready_count, 1);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_state.ready_count);
+    ASSERT_ARE_EQUAL(int, EVENT_LOOP_READABLE, (int)test_state.ready_events);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_014: [ event_loop_watch_fd shall add fd to the epoll instance for events and return the watch; a watch for no event is not added until its events are set. ]*/
+TEST_FUNCTION(a_watch_for_no_event_is_not_called)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+    ASSERT_IS_NOT_NULL(event_loop_watch_fd(test_state.event_loop, test_state.fds[0], 0, on_fd_ready, &test_state));
+    write_byte(test_state.fds[1]);
+
+    //act
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, TEST_TIMER_MS));
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.ready_count);
+}
+
+/* event_loop_watch_set_events */
+
+/*Tests_SRS_EVENT_LOOP_01_015: [ If watch is NULL, event_loop_watch_set_events shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(event_loop_watch_set_events_with_NULL_watch_fails)
+{
+    //act
+    int result = event_loop_watch_set_events(NULL, EVENT_LOOP_READABLE);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_016: [ event_loop_watch_set_events shall add, modify or remove the descriptor in the epoll instance so that it waits for events, and return 0. ]*/
+TEST_FUNCTION(event_loop_watch_set_events_switches_to_writable)
+{
+    //arrange
+    EVENT_LOOP_WATCH_HANDLE watch;
+    int result;
+    test_state.event_loop = event_loop_create();
+    watch = event_loop_watch_fd(test_state.event_loop, test_state.fds[0], EVENT_LOOP_READABLE, on_fd_ready, &test_state);
+    ASSERT_IS_NOT_NULL(watch);
+
+    //act
+    result = event_loop_watch_set_events(watch, EVENT_LOOP_WRITABLE);
+    run_until(&test_state.ready_count, 1);
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, EVENT_LOOP_WRITABLE, (int)test_state.ready_events);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_016: [ event_loop_watch_set_events shall add, modify or remove the descriptor in the epoll instance so that it waits for events, and return 0. ]*/
+TEST_FUNCTION(event_loop_watch_set_events_to_0_pauses_the_watch)
+{
+    //arrange
+    EVENT_LOOP_WATCH_HANDLE watch;
+    int result;
+    test_state.event_loop = event_loop_create();
+    watch = event_loop_watch_fd(test_state.event_loop, test_state.fds[0], EVENT_LOOP_READABLE | EVENT_LOOP_WRITABLE, on_fd_ready, &test_state);
+    ASSERT_IS_NOT_NULL(watch);
+    write_byte(test_state.fds[1]);
+
+    //act
+    result = event_loop_watch_set_events(watch, 0);
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, TEST_TIMER_MS));
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.ready_count);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_017: [ If epoll_ctl fails, event_loop_watch_set_events shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_epoll_ctl_fails_event_loop_watch_set_events_fails)
+{
+    //arrange
+    EVENT_LOOP_WATCH_HANDLE watch;
+    int result;
+    test_state.event_loop = event_loop_create();
+    watch = event_loop_watch_fd(test_state.event_loop, test_state.fds[0], 0, on_fd_ready, &test_state);
+    ASSERT_IS_NOT_NULL(watch);
+    (void)close(test_state.fds[0]);
+    test_state.fds[0] = -1;
+
+    //act
+    result = event_loop_watch_set_events(watch, EVENT_LOOP_READABLE);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* event_loop_unwatch_fd */
+
+/*Tests_SRS_EVENT_LOOP_01_022: [ If watch is NULL, event_loop_unwatch_fd shall return. ]*/
+TEST_FUNCTION(event_loop_unwatch_fd_with_NULL_returns)
+{
+    //act
+    event_loop_unwatch_fd(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_EVENT_LOOP_01_023: [ event_loop_unwatch_fd shall remove the descriptor from the epoll instance and free the watch. ]*/
+TEST_FUNCTION(an_unwatched_fd_is_not_reported)
+{
+    //arrange
+    EVENT_LOOP_WATCH_HANDLE watch;
+    test_state.event_loop = event_loop_create();
+    watch = event_loop_watch_fd(test_state.event_loop, test_state.fds[0], EVENT_LOOP_READABLE, on_fd_ready, &test_state);
+    ASSERT_IS_NOT_NULL(watch);
+    write_byte(test_state.fds[1]);
+
+    //act
+    event_loop_unwatch_fd(watch);
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, TEST_TIMER_MS));
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.ready_count);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_024: [ A watch released while events are dispatched shall get no further callback and be freed once the dispatch is over. ]*/
+TEST_FUNCTION(a_watch_released_by_another_callback_is_not_called)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+    test_state.watches[0] = event_loop_watch_fd(test_state.event_loop, test_state.fds[0], EVENT_LOOP_READABLE, unwatch_other_on_fd_ready, &test_state);
+    test_state.watches[1] = event_loop_watch_fd(test_state.event_loop, test_state.other_fds[0], EVENT_LOOP_READABLE, unwatch_other_on_fd_ready, &test_state);
+    ASSERT_IS_NOT_NULL(test_state.watches[0]);
+    ASSERT_IS_NOT_NULL(test_state.watches[1]);
+    write_byte(test_state.fds[1]);
+    write_byte(test_state.other_fds[1]);
+
+    //act
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, TEST_WAIT_MS));
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, TEST_TIMER_MS));
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_state.ready_count);
+}
+
+/* event_loop_timer_start */
+
+/*Tests_SRS_EVENT_LOOP_01_025: [ If event_loop or on_timer is NULL, event_loop_timer_start shall fail and return NULL. ]*/
+TEST_FUNCTION(event_loop_timer_start_with_invalid_arguments_fails)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+
+    //act
+    //assert
+    ASSERT_IS_NULL(event_loop_timer_start(NULL, 0, 0, on_timer, &test_state));
+    ASSERT_IS_NULL(event_loop_timer_start(test_state.event_loop, 0, 0, NULL, &test_state));
+}
+
+/*Tests_SRS_EVENT_LOOP_01_026: [ If reading the tick counter, allocating the timer or growing the heap fails, event_loop_timer_start shall fail and return NULL. ]*/
+TEST_FUNCTION(when_allocating_the_timer_fails_event_loop_timer_start_fails)
+{
+    //arrange
+    EVENT_LOOP_TIMER_HANDLE timer;
+    test_state.event_loop = event_loop_create();
+    malloc_call_count = 0;
+    malloc_fail_index = 0;
+
+    //act
+    timer = event_loop_timer_start(test_state.event_loop, 0, 0, on_timer, &test_state);
+
+    //assert
+    ASSERT_IS_NULL(timer);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_018: [ When a timer is due, event_loop_run_once shall call its on_timer with its context. ]*/
+/*Tests_SRS_EVENT_LOOP_01_027: [ event_loop_timer_start shall put the timer in the heap of the loop, due delay_ms from now, and return it. ]*/
+TEST_FUNCTION(a_one_shot_timer_fires_once)
+{
+    //arrange
+    EVENT_LOOP_TIMER_HANDLE timer;
+    test_state.event_loop = event_loop_create();
+
+    //act
+    timer = event_loop_timer_start(test_state.event_loop, TEST_TIMER_MS, 0, on_timer, &test_state);
+    run_until(&test_state.timer_count, 1);
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, TEST_TIMER_MS * 2));
+
+    //assert
+    ASSERT_IS_NOT_NULL(timer);
+    ASSERT_ARE_EQUAL(size_t, 1, test_state.timer_count);
+
+    //cleanup
+    event_loop_timer_cancel(timer);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_027: [ event_loop_timer_start shall put the timer in the heap of the loop, due delay_ms from now, and return it. ]*/
+TEST_FUNCTION(timers_fire_in_due_order)
+{
+    //arrange
+    EVENT_LOOP_TIMER_HANDLE timers[20];
+    size_t i;
+    test_state.event_loop = event_loop_create();
+    for (i = 0; i < 20; i++)
+    {
+        /*the heap grows past its initial capacity*/
+        timers[i] = event_loop_timer_start(test_state.event_loop, (uint32_t)(TEST_WAIT_MS - (i * 10)), 0, on_timer, &test_state);
+        ASSERT_IS_NOT_NULL(timers[i]);
+    }
+    test_state.timer = event_loop_timer_start(test_state.event_loop, TEST_TIMER_MS, 0, on_timer, &test_state);
+
+    //act
+    run_until(&test_state.timer_count, 1);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_state.timer_count);
+
+    //cleanup
+    for (i = 0; i < 20; i++)
+    {
+        event_loop_timer_cancel(timers[i]);
+    }
+    event_loop_timer_cancel(test_state.timer);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_019: [ A periodic timer shall be due again period_ms after its on_timer returns. ]*/
+TEST_FUNCTION(a_periodic_timer_fires_repeatedly)
+{
+    //arrange
+    EVENT_LOOP_TIMER_HANDLE timer;
+    test_state.event_loop = event_loop_create();
+    timer = event_loop_timer_start(test_state.event_loop, 0, TEST_TIMER_MS / 4, on_timer, &test_state);
+    ASSERT_IS_NOT_NULL(timer);
+
+    //act
+    run_until(&test_state.timer_count, 3);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 3, test_state.timer_count);
+
+    //cleanup
+    event_loop_timer_cancel(timer);
+}
+
+/* event_loop_timer_cancel */
+
+/*Tests_SRS_EVENT_LOOP_01_028: [ If timer is NULL, event_loop_timer_cancel shall return. ]*/
+TEST_FUNCTION(event_loop_timer_cancel_with_NULL_returns)
+{
+    //act
+    event_loop_timer_cancel(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_EVENT_LOOP_01_020: [ event_loop_timer_cancel shall take the timer out of the heap and free it. ]*/
+TEST_FUNCTION(a_cancelled_timer_does_not_fire)
+{
+    //arrange
+    EVENT_LOOP_TIMER_HANDLE timer;
+    test_state.event_loop = event_loop_create();
+    timer = event_loop_timer_start(test_state.event_loop, 0, 0, on_timer, &test_state);
+    ASSERT_IS_NOT_NULL(timer);
+
+    //act
+    event_loop_timer_cancel(timer);
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, TEST_TIMER_MS));
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.timer_count);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_021: [ A timer cancelled from its own on_timer shall be freed once on_timer returns. ]*/
+TEST_FUNCTION(a_periodic_timer_can_cancel_itself)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+    test_state.timer = event_loop_timer_start(test_state.event_loop, 0, 1, cancel_own_timer, &test_state);
+    ASSERT_IS_NOT_NULL(test_state.timer);
+
+    //act
+    run_until(&test_state.timer_count, 1);
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, TEST_TIMER_MS));
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_state.timer_count);
+    ASSERT_IS_NULL(test_state.timer);
+}
+
+/* event_loop_add_xio */
+
+/*Tests_SRS_EVENT_LOOP_01_029: [ If event_loop or xio is NULL, event_loop_add_xio shall fail and return NULL. ]*/
+TEST_FUNCTION(event_loop_add_xio_with_invalid_arguments_fails)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+    umock_c_reset_all_calls();
+
+    //act
+    //assert
+    ASSERT_IS_NULL(event_loop_add_xio(NULL, TEST_XIO, 0));
+    ASSERT_IS_NULL(event_loop_add_xio(test_state.event_loop, NULL, 0));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_EVENT_LOOP_01_030: [ If allocating, starting the housekeeping timer or setting the option fails, event_loop_add_xio shall free everything it created and return NULL. ]*/
+TEST_FUNCTION(when_the_xio_does_not_take_the_binding_event_loop_add_xio_fails)
+{
+    //arrange
+    EVENT_LOOP_XIO_HANDLE event_loop_xio;
+    test_state.event_loop = event_loop_create();
+    test_state.setoption_result = 1;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(xio_setoption(TEST_XIO, OPTION_XIO_EVENT_BINDING, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    //act
+    event_loop_xio = event_loop_add_xio(test_state.event_loop, TEST_XIO, 0);
+
+    //assert
+    ASSERT_IS_NULL(event_loop_xio);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_EVENT_LOOP_01_031: [ event_loop_add_xio shall set the OPTION_XIO_EVENT_BINDING option of the xio to a binding whose set_interest watches the descriptors of the xio, and return a handle for it. ]*/
+/*Tests_SRS_EVENT_LOOP_01_032: [ When the xio sets its interest in a descriptor, the loop shall watch the descriptor for those events, or stop watching it when events is 0. ]*/
+/*Tests_SRS_EVENT_LOOP_01_033: [ When a descriptor of the xio is ready, the loop shall call xio_dowork on the xio. ]*/
+TEST_FUNCTION(event_loop_add_xio_calls_xio_dowork_when_its_socket_is_readable)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+
+    //act
+    test_state.event_loop_xio = event_loop_add_xio(test_state.event_loop, TEST_XIO, 0);
+    ASSERT_IS_NOT_NULL(test_state.event_loop_xio);
+    ASSERT_IS_NOT_NULL(test_state.event_binding.set_interest);
+    ASSERT_ARE_EQUAL(int, 0, test_state.event_binding.set_interest(test_state.event_binding.context, test_state.fds[0], XIO_EVENT_READABLE));
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, 0));
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.dowork_count);
+    write_byte(test_state.fds[1]);
+    run_until(&test_state.dowork_count, 1);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_state.dowork_count);
+
+    //cleanup
+    event_loop_remove_xio(test_state.event_loop_xio);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_032: [ When the xio sets its interest in a descriptor, the loop shall watch the descriptor for those events, or stop watching it when events is 0. ]*/
+TEST_FUNCTION(an_xio_interest_of_0_stops_the_dowork_calls)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+    test_state.event_loop_xio = event_loop_add_xio(test_state.event_loop, TEST_XIO, 0);
+    ASSERT_IS_NOT_NULL(test_state.event_loop_xio);
+    ASSERT_ARE_EQUAL(int, 0, test_state.event_binding.set_interest(test_state.event_binding.context, test_state.fds[0], XIO_EVENT_READABLE | XIO_EVENT_WRITABLE));
+    ASSERT_ARE_EQUAL(int, 0, test_state.event_binding.set_interest(test_state.event_binding.context, test_state.fds[0], XIO_EVENT_READABLE));
+    write_byte(test_state.fds[1]);
+
+    //act
+    ASSERT_ARE_EQUAL(int, 0, test_state.event_binding.set_interest(test_state.event_binding.context, test_state.fds[0], 0));
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, TEST_TIMER_MS));
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.dowork_count);
+
+    //cleanup
+    event_loop_remove_xio(test_state.event_loop_xio);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_034: [ Every housekeeping_ms the loop shall call xio_dowork on the xio. ]*/
+TEST_FUNCTION(event_loop_add_xio_calls_xio_dowork_every_housekeeping_ms)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+    test_state.event_loop_xio = event_loop_add_xio(test_state.event_loop, TEST_XIO, TEST_TIMER_MS / 4);
+    ASSERT_IS_NOT_NULL(test_state.event_loop_xio);
+
+    //act
+    run_until(&test_state.dowork_count, 2);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 2, test_state.dowork_count);
+
+    //cleanup
+    event_loop_remove_xio(test_state.event_loop_xio);
+}
+
+/* event_loop_remove_xio */
+
+/*Tests_SRS_EVENT_LOOP_01_035: [ If event_loop_xio is NULL, event_loop_remove_xio shall return. ]*/
+TEST_FUNCTION(event_loop_remove_xio_with_NULL_returns)
+{
+    //act
+    event_loop_remove_xio(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_EVENT_LOOP_01_036: [ event_loop_remove_xio shall set the OPTION_XIO_EVENT_BINDING option of the xio to a binding with a NULL set_interest, stop watching its descriptors, cancel the housekeeping timer and free the handle. ]*/
+TEST_FUNCTION(event_loop_remove_xio_detaches_the_xio)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+    test_state.event_loop_xio = event_loop_add_xio(test_state.event_loop, TEST_XIO, TEST_TIMER_MS / 4);
+    ASSERT_IS_NOT_NULL(test_state.event_loop_xio);
+    ASSERT_ARE_EQUAL(int, 0, test_state.event_binding.set_interest(test_state.event_binding.context, test_state.fds[0], XIO_EVENT_READABLE));
+    write_byte(test_state.fds[1]);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(xio_setoption(TEST_XIO, OPTION_XIO_EVENT_BINDING, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*watch*/
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*descriptor of the xio*/
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*housekeeping timer*/
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    //act
+    event_loop_remove_xio(test_state.event_loop_xio);
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, TEST_TIMER_MS));
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(test_state.event_binding.set_interest);
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.dowork_count);
+}
+
+/*Tests_SRS_EVENT_LOOP_01_036: [ event_loop_remove_xio shall set the OPTION_XIO_EVENT_BINDING option of the xio to a binding with a NULL set_interest, stop watching its descriptors, cancel the housekeeping timer and free the handle. ]*/
+TEST_FUNCTION(event_loop_remove_xio_can_be_called_from_xio_dowork)
+{
+    //arrange
+    test_state.event_loop = event_loop_create();
+    test_state.event_loop_xio = event_loop_add_xio(test_state.event_loop, TEST_XIO, TEST_TIMER_MS / 4);
+    ASSERT_IS_NOT_NULL(test_state.event_loop_xio);
+    ASSERT_ARE_EQUAL(int, 0, test_state.event_binding.set_interest(test_state.event_binding.context, test_state.fds[0], XIO_EVENT_READABLE));
+    test_state.remove_xio_on_dowork = true;
+    write_byte(test_state.fds[1]);
+
+    //act
+    run_until(&test_state.dowork_count, 1);
+    ASSERT_ARE_EQUAL(int, 0, event_loop_run_once(test_state.event_loop, TEST_TIMER_MS));
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 1, test_state.dowork_count);
+    ASSERT_IS_NULL(test_state.event_loop_xio);
+}
+
+END_TEST_SUITE(event_loop_unittests)
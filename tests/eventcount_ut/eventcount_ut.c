@@ -0,0 +1,425 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+
+static void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/gballoc.h"
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/eventcount.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+
+#define TEST_WAITER_COUNT       4
+#define TEST_ITEM_COUNT         200000
+#define TEST_WAIT_MS            10000
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+TEST_DEFINE_ENUM_TYPE(EVENTCOUNT_RESULT, EVENTCOUNT_RESULT_VALUES)
+
+typedef struct TEST_CONTEXT_TAG
+{
+    EVENTCOUNT_HANDLE eventcount;
+    LOCK_HANDLE lock;
+    /*all below are guarded by lock*/
+    size_t registered_count;
+    size_t produced_count;
+    size_t consumed_count;
+    bool done;
+    size_t timeout_count;
+} TEST_CONTEXT;
+
+static int waiter_thread(void* context)
+{
+    TEST_CONTEXT* test_context = (TEST_CONTEXT*)context;
+    uint32_t key = eventcount_prepare_wait(test_context->eventcount);
+
+    (void)Lock(test_context->lock);
+    test_context->registered_count++;
+    (void)Unlock(test_context->lock);
+
+    if (eventcount_wait(test_context->eventcount, key, TEST_WAIT_MS) != EVENTCOUNT_OK)
+    {
+        (void)Lock(test_context->lock);
+        test_context->timeout_count++;
+        (void)Unlock(test_context->lock);
+    }
+
+    return 0;
+}
+
+/*the lock only protects the counters: the eventcount has to deliver every wakeup by itself*/
+static bool take_item(TEST_CONTEXT* test_context, bool* done)
+{
+    bool result;
+
+    (void)Lock(test_context->lock);
+    if (test_context->consumed_count < test_context->produced_count)
+    {
+        test_context->consumed_count++;
+        result = true;
+    }
+    else
+    {
+        result = false;
+    }
+    *done = test_context->done;
+    (void)Unlock(test_context->lock);
+
+    return result;
+}
+
+static int consumer_thread(void* context)
+{
+    TEST_CONTEXT* test_context = (TEST_CONTEXT*)context;
+    bool done = false;
+
+    while (!done)
+    {
+        if (!take_item(test_context, &done) && !done)
+        {
+            uint32_t key = eventcount_prepare_wait(test_context->eventcount);
+            if (take_item(test_context, &done) || done)
+            {
+                eventcount_cancel_wait(test_context->eventcount);
+            }
+            else if (eventcount_wait(test_context->eventcount, key, TEST_WAIT_MS) == EVENTCOUNT_TIMEOUT)
+            {
+                (void)Lock(test_context->lock);
+                test_context->timeout_count++;
+                (void)Unlock(test_context->lock);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int producer_thread(void* context)
+{
+    TEST_CONTEXT* test_context = (TEST_CONTEXT*)context;
+    size_t i;
+
+    for (i = 0; i < TEST_ITEM_COUNT; i++)
+    {
+        (void)Lock(test_context->lock);
+        test_context->produced_count++;
+        (void)Unlock(test_context->lock);
+        eventcount_notify_one(test_context->eventcount);
+    }
+
+    return 0;
+}
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(eventcount_unittests)
+
+TEST_SUITE_INITIALIZE(TestSuiteInitialize)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    umock_c_init(on_umock_c_error);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(f)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(cleans)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* eventcount_create */
+
+/*Tests_SRS_EVENTCOUNT_01_001: [ eventcount_create shall allocate an eventcount with no waiters and return it. ]*/
+TEST_FUNCTION(eventcount_create_succeeds)
+{
+    //arrange
+    EVENTCOUNT_HANDLE eventcount;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    //act
+    eventcount = eventcount_create();
+
+    //assert
+    ASSERT_IS_NOT_NULL(eventcount);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    eventcount_destroy(eventcount);
+}
+
+/*Tests_SRS_EVENTCOUNT_01_002: [ If any error occurs, eventcount_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_allocating_fails_eventcount_create_fails)
+{
+    //arrange
+    EVENTCOUNT_HANDLE eventcount;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    eventcount = eventcount_create();
+
+    //assert
+    ASSERT_IS_NULL(eventcount);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* eventcount_destroy */
+
+/*Tests_SRS_EVENTCOUNT_01_003: [ If eventcount is NULL, eventcount_destroy shall return. ]*/
+TEST_FUNCTION(eventcount_destroy_with_NULL_returns)
+{
+    //act
+    eventcount_destroy(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_EVENTCOUNT_01_004: [ eventcount_destroy shall free the eventcount. ]*/
+TEST_FUNCTION(eventcount_destroy_frees_the_eventcount)
+{
+    //arrange
+    EVENTCOUNT_HANDLE eventcount = eventcount_create();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(eventcount));
+
+    //act
+    eventcount_destroy(eventcount);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* eventcount_prepare_wait, eventcount_cancel_wait, eventcount_wait, eventcount_notify_one, eventcount_notify_all */
+
+/*Tests_SRS_EVENTCOUNT_01_005: [ If eventcount is NULL, eventcount_prepare_wait shall return 0. ]*/
+/*Tests_SRS_EVENTCOUNT_01_007: [ If eventcount is NULL, eventcount_cancel_wait shall return. ]*/
+/*Tests_SRS_EVENTCOUNT_01_009: [ If eventcount is NULL, eventcount_wait shall fail and return EVENTCOUNT_INVALID_ARG. ]*/
+/*Tests_SRS_EVENTCOUNT_01_015: [ If eventcount is NULL, eventcount_notify_one and eventcount_notify_all shall return. ]*/
+TEST_FUNCTION(eventcount_functions_with_NULL_fail)
+{
+    //act
+    //assert
+    ASSERT_ARE_EQUAL(uint32_t, 0, eventcount_prepare_wait(NULL));
+    eventcount_cancel_wait(NULL);
+    ASSERT_ARE_EQUAL(EVENTCOUNT_RESULT, EVENTCOUNT_INVALID_ARG, eventcount_wait(NULL, 0, 0));
+    eventcount_notify_one(NULL);
+    eventcount_notify_all(NULL);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_EVENTCOUNT_01_006: [ eventcount_prepare_wait shall register the calling thread as a waiter and then return the number of notifications that found a waiter as the key. ]*/
+/*Tests_SRS_EVENTCOUNT_01_008: [ eventcount_cancel_wait shall withdraw the registration made by eventcount_prepare_wait. ]*/
+/*Tests_SRS_EVENTCOUNT_01_016: [ If no thread is registered, eventcount_notify_one and eventcount_notify_all shall return without making a system call. ]*/
+TEST_FUNCTION(notifications_without_a_registered_waiter_do_not_change_the_key)
+{
+    //arrange
+    EVENTCOUNT_HANDLE eventcount = eventcount_create();
+    uint32_t first_key;
+    uint32_t second_key;
+    first_key = eventcount_prepare_wait(eventcount);
+    eventcount_cancel_wait(eventcount);
+
+    //act
+    eventcount_notify_one(eventcount);
+    eventcount_notify_all(eventcount);
+    second_key = eventcount_prepare_wait(eventcount);
+
+    //assert
+    ASSERT_ARE_EQUAL(uint32_t, first_key, second_key);
+
+    //cleanup
+    eventcount_cancel_wait(eventcount);
+    eventcount_destroy(eventcount);
+}
+
+/*Tests_SRS_EVENTCOUNT_01_010: [ eventcount_wait shall return EVENTCOUNT_OK without blocking if a notification found a waiter since the eventcount_prepare_wait that returned key. ]*/
+/*Tests_SRS_EVENTCOUNT_01_017: [ Otherwise eventcount_notify_one shall make the key of every registered thread stale and wake one thread blocked in eventcount_wait. ]*/
+TEST_FUNCTION(eventcount_wait_after_a_notification_returns_at_once)
+{
+    //arrange
+    EVENTCOUNT_HANDLE eventcount = eventcount_create();
+    uint32_t key = eventcount_prepare_wait(eventcount);
+    eventcount_notify_one(eventcount);
+
+    //act
+    EVENTCOUNT_RESULT result = eventcount_wait(eventcount, key, 0);
+
+    //assert
+    ASSERT_ARE_EQUAL(EVENTCOUNT_RESULT, EVENTCOUNT_OK, result);
+
+    //cleanup
+    eventcount_destroy(eventcount);
+}
+
+/*Tests_SRS_EVENTCOUNT_01_012: [ If timeout_milliseconds is greater than 0, eventcount_wait shall return EVENTCOUNT_TIMEOUT once timeout_milliseconds have passed since the call without such a notification. ]*/
+/*Tests_SRS_EVENTCOUNT_01_013: [ eventcount_wait shall withdraw the registration made by eventcount_prepare_wait before returning. ]*/
+TEST_FUNCTION(eventcount_wait_without_a_notification_times_out)
+{
+    //arrange
+    EVENTCOUNT_HANDLE eventcount = eventcount_create();
+    uint32_t key = eventcount_prepare_wait(eventcount);
+    EVENTCOUNT_RESULT result;
+
+    //act
+    result = eventcount_wait(eventcount, key, 50);
+
+    //assert
+    ASSERT_ARE_EQUAL(EVENTCOUNT_RESULT, EVENTCOUNT_TIMEOUT, result);
+    eventcount_notify_all(eventcount);
+    ASSERT_ARE_EQUAL(uint32_t, key, eventcount_prepare_wait(eventcount));
+
+    //cleanup
+    eventcount_cancel_wait(eventcount);
+    eventcount_destroy(eventcount);
+}
+
+/*Tests_SRS_EVENTCOUNT_01_011: [ Otherwise eventcount_wait shall block until such a notification and return EVENTCOUNT_OK. ]*/
+/*Tests_SRS_EVENTCOUNT_01_018: [ Otherwise eventcount_notify_all shall make the key of every registered thread stale and wake every thread blocked in eventcount_wait. ]*/
+TEST_FUNCTION(eventcount_notify_all_wakes_every_waiter)
+{
+    //arrange
+    TEST_CONTEXT context;
+    THREAD_HANDLE threads[TEST_WAITER_COUNT];
+    size_t registered_count;
+    size_t i;
+    context.eventcount = eventcount_create();
+    context.lock = Lock_Init();
+    context.registered_count = 0;
+    context.timeout_count = 0;
+    for (i = 0; i < TEST_WAITER_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&threads[i], waiter_thread, &context));
+    }
+    do
+    {
+        ThreadAPI_Sleep(10);
+        (void)Lock(context.lock);
+        registered_count = context.registered_count;
+        (void)Unlock(context.lock);
+    } while (registered_count < TEST_WAITER_COUNT);
+    /*give the waiters time to block*/
+    ThreadAPI_Sleep(50);
+
+    //act
+    eventcount_notify_all(context.eventcount);
+    for (i = 0; i < TEST_WAITER_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Join(threads[i], NULL));
+    }
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 0, context.timeout_count);
+
+    //cleanup
+    (void)Lock_Deinit(context.lock);
+    eventcount_destroy(context.eventcount);
+}
+
+/*Tests_SRS_EVENTCOUNT_01_011: [ Otherwise eventcount_wait shall block until such a notification and return EVENTCOUNT_OK. ]*/
+/*Tests_SRS_EVENTCOUNT_01_017: [ Otherwise eventcount_notify_one shall make the key of every registered thread stale and wake one thread blocked in eventcount_wait. ]*/
+TEST_FUNCTION(no_notification_is_lost_between_a_producer_and_consumers)
+{
+    //arrange
+    TEST_CONTEXT context;
+    THREAD_HANDLE consumers[2];
+    THREAD_HANDLE producer;
+    bool done;
+    size_t i;
+    context.eventcount = eventcount_create();
+    context.lock = Lock_Init();
+    context.produced_count = 0;
+    context.consumed_count = 0;
+    context.done = false;
+    context.timeout_count = 0;
+    for (i = 0; i < 2; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&consumers[i], consumer_thread, &context));
+    }
+
+    //act
+    ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&producer, producer_thread, &context));
+    ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Join(producer, NULL));
+    do
+    {
+        ThreadAPI_Sleep(1);
+        (void)Lock(context.lock);
+        context.done = (context.consumed_count == TEST_ITEM_COUNT);
+        done = context.done;
+        (void)Unlock(context.lock);
+    } while (!done);
+    eventcount_notify_all(context.eventcount);
+    for (i = 0; i < 2; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Join(consumers[i], NULL));
+    }
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, TEST_ITEM_COUNT, context.consumed_count);
+    ASSERT_ARE_EQUAL(size_t, 0, context.timeout_count);
+
+    //cleanup
+    (void)Lock_Deinit(context.lock);
+    eventcount_destroy(context.eventcount);
+}
+
+END_TEST_SUITE(eventcount_unittests)
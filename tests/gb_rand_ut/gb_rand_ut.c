@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "azure_c_shared_utility/gb_rand.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+BEGIN_TEST_SUITE(gb_rand_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* gb_rand */
+
+TEST_FUNCTION(gb_rand_returns_non_negative_values_that_change)
+{
+    // arrange
+    int first;
+    int i;
+    int changed = 0;
+
+    // act
+    first = gb_rand();
+
+    // assert
+    ASSERT_IS_TRUE(first >= 0);
+    for (i = 0; i < 1000; i++)
+    {
+        int value = gb_rand();
+        ASSERT_IS_TRUE(value >= 0);
+        if (value != first)
+        {
+            changed = 1;
+        }
+    }
+    ASSERT_ARE_EQUAL(int, 1, changed);
+}
+
+/* gb_rand_bytes */
+
+TEST_FUNCTION(gb_rand_bytes_with_NULL_buffer_returns)
+{
+    // arrange
+
+    // act
+    gb_rand_bytes(NULL, 4);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(gb_rand_bytes_with_0_length_leaves_the_buffer_unchanged)
+{
+    // arrange
+    unsigned char buffer[4] = { 0x42, 0x42, 0x42, 0x42 };
+    unsigned char expected[4] = { 0x42, 0x42, 0x42, 0x42 };
+
+    // act
+    gb_rand_bytes(buffer, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, memcmp(buffer, expected, sizeof(buffer)));
+}
+
+TEST_FUNCTION(gb_rand_bytes_fills_only_the_requested_bytes)
+{
+    // arrange
+    unsigned char buffer[20];
+    size_t length;
+
+    for (length = 1; length < sizeof(buffer); length++)
+    {
+        (void)memset(buffer, 0x5A, sizeof(buffer));
+
+        // act
+        gb_rand_bytes(buffer, length);
+
+        // assert
+        ASSERT_ARE_EQUAL(int, 0x5A, buffer[length]);
+    }
+}
+
+TEST_FUNCTION(gb_rand_bytes_produces_a_different_nonce_each_call)
+{
+    // arrange
+    unsigned char nonce_1[16];
+    unsigned char nonce_2[16];
+
+    // act
+    gb_rand_bytes(nonce_1, sizeof(nonce_1));
+    gb_rand_bytes(nonce_2, sizeof(nonce_2));
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, memcmp(nonce_1, nonce_2, sizeof(nonce_1)));
+}
+
+END_TEST_SUITE(gb_rand_ut)
@@ -170,4 +170,258 @@ TEST_FUNCTION(HMACSHA256_ComputeHash_Succeeds)
     ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hash), expectedHash, 8));
 }
 
+/* RFC 4231, test case 7: key and payload both span several SHA-256 blocks */
+TEST_FUNCTION(HMACSHA256_ComputeHash_With_Multi_Block_Key_And_Payload_Succeeds)
+{
+    // arrange
+    unsigned char key[131];
+    static const unsigned char buffer[] = "This is a test using a larger than block-size key and a larger than block-size data. The key needs to be hashed before being used by the HMAC algorithm.";
+    unsigned char expectedHash[32] = { 155, 9, 255, 167, 27, 148, 47, 203, 39, 99, 95, 188, 213, 176, 233, 68, 191, 220, 99, 100, 79, 7, 19, 147, 138, 127, 81, 83, 92, 58, 53, 226 };
+    (void)memset(key, 0xAA, sizeof(key));
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHash(key, sizeof(key), buffer, sizeof(buffer) - 1, hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, result);
+    ASSERT_ARE_EQUAL(int, 32, (int)BUFFER_length(hash));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hash), expectedHash, sizeof(expectedHash)));
+}
+
+/* HMACSHA256_CreateKey */
+
+TEST_FUNCTION(HMACSHA256_CreateKey_With_NULL_Key_Fails)
+{
+    // act
+    HMACSHA256_KEY_HANDLE result = HMACSHA256_CreateKey(NULL, 3);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(HMACSHA256_CreateKey_With_Zero_Key_Size_Fails)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+
+    // act
+    HMACSHA256_KEY_HANDLE result = HMACSHA256_CreateKey(key, 0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(HMACSHA256_CreateKey_Allocates_The_Key)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    HMACSHA256_KEY_HANDLE result = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    HMACSHA256_DestroyKey(result);
+}
+
+TEST_FUNCTION(HMACSHA256_CreateKey_When_Allocation_Fails_Returns_NULL)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    // act
+    HMACSHA256_KEY_HANDLE result = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* HMACSHA256_DestroyKey */
+
+TEST_FUNCTION(HMACSHA256_DestroyKey_With_NULL_Does_Nothing)
+{
+    // arrange
+    umock_c_reset_all_calls();
+
+    // act
+    HMACSHA256_DestroyKey(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(HMACSHA256_DestroyKey_Frees_The_Key)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    HMACSHA256_KEY_HANDLE hmacKey = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(gballoc_free(hmacKey));
+
+    // act
+    HMACSHA256_DestroyKey(hmacKey);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* HMACSHA256_ComputeHashWithKey */
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_With_NULL_Key_Fails)
+{
+    // arrange
+    static const unsigned char buffer[] = "testPayload";
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashWithKey(NULL, buffer, sizeof(buffer) - 1, hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_INVALID_ARG, result);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_With_NULL_Payload_Fails)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    HMACSHA256_KEY_HANDLE hmacKey = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashWithKey(hmacKey, NULL, 11, hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_INVALID_ARG, result);
+
+    // cleanup
+    HMACSHA256_DestroyKey(hmacKey);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_With_Zero_Payload_Size_Fails)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    static const unsigned char buffer[] = "testPayload";
+    HMACSHA256_KEY_HANDLE hmacKey = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashWithKey(hmacKey, buffer, 0, hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_INVALID_ARG, result);
+
+    // cleanup
+    HMACSHA256_DestroyKey(hmacKey);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_With_NULL_Hash_Fails)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    static const unsigned char buffer[] = "testPayload";
+    HMACSHA256_KEY_HANDLE hmacKey = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashWithKey(hmacKey, buffer, sizeof(buffer) - 1, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_INVALID_ARG, result);
+
+    // cleanup
+    HMACSHA256_DestroyKey(hmacKey);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_Succeeds)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    static const unsigned char buffer[] = "testPayload";
+    unsigned char expectedHash[32] = { 108, 7, 130, 47, 104, 233, 39, 188, 126, 122, 134, 187, 63, 19, 52, 120, 172, 7, 43, 25, 133, 60, 92, 217, 59, 59, 69, 116, 85, 104, 55, 224 };
+    HMACSHA256_KEY_HANDLE hmacKey = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+
+    // act
+    HMACSHA256_RESULT result = HMACSHA256_ComputeHashWithKey(hmacKey, buffer, sizeof(buffer) - 1, hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hash), expectedHash, sizeof(expectedHash)));
+
+    // cleanup
+    HMACSHA256_DestroyKey(hmacKey);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_With_Multi_Block_Key_Succeeds)
+{
+    // arrange
+    unsigned char key[131];
+    static const unsigned char buffer[] = "This is a test using a larger than block-size key and a larger than block-size data. The key needs to be hashed before being used by the HMAC algorithm.";
+    unsigned char expectedHash[32] = { 155, 9, 255, 167, 27, 148, 47, 203, 39, 99, 95, 188, 213, 176, 233, 68, 191, 220, 99, 100, 79, 7, 19, 147, 138, 127, 81, 83, 92, 58, 53, 226 };
+    HMACSHA256_KEY_HANDLE hmacKey;
+    HMACSHA256_RESULT result;
+    (void)memset(key, 0xAA, sizeof(key));
+    hmacKey = HMACSHA256_CreateKey(key, sizeof(key));
+
+    // act
+    result = HMACSHA256_ComputeHashWithKey(hmacKey, buffer, sizeof(buffer) - 1, hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hash), expectedHash, sizeof(expectedHash)));
+
+    // cleanup
+    HMACSHA256_DestroyKey(hmacKey);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKey_Does_Not_Allocate)
+{
+    // arrange
+    static const unsigned char key[] = "key";
+    static const unsigned char buffer[] = "testPayload";
+    unsigned char first[HMACSHA256_HASH_SIZE];
+    unsigned char second[HMACSHA256_HASH_SIZE];
+    HMACSHA256_KEY_HANDLE hmacKey = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+    umock_c_reset_all_calls();
+
+    // act
+    HMACSHA256_RESULT result1 = HMACSHA256_ComputeHashWithKeyInto(hmacKey, buffer, sizeof(buffer) - 1, first);
+    HMACSHA256_RESULT result2 = HMACSHA256_ComputeHashWithKeyInto(hmacKey, buffer, sizeof(buffer) - 1, second);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, result1);
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, result2);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(first, second, sizeof(first)));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    HMACSHA256_DestroyKey(hmacKey);
+}
+
+TEST_FUNCTION(HMACSHA256_ComputeHashWithKeyInto_Matches_ComputeHash)
+{
+    // arrange
+    static const unsigned char key[] = "a key that is a bit longer than usual, but still shorter than a block";
+    static const unsigned char buffer[] = "myhub.azure-devices.net/devices/mydevice\n1500000000";
+    unsigned char actual[HMACSHA256_HASH_SIZE];
+    HMACSHA256_KEY_HANDLE hmacKey = HMACSHA256_CreateKey(key, sizeof(key) - 1);
+    HMACSHA256_RESULT result;
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, HMACSHA256_ComputeHash(key, sizeof(key) - 1, buffer, sizeof(buffer) - 1, hash));
+
+    // act
+    result = HMACSHA256_ComputeHashWithKeyInto(hmacKey, buffer, sizeof(buffer) - 1, actual);
+
+    // assert
+    ASSERT_ARE_EQUAL(HMACSHA256_RESULT, HMACSHA256_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hash), actual, sizeof(actual)));
+
+    // cleanup
+    HMACSHA256_DestroyKey(hmacKey);
+}
+
 END_TEST_SUITE(HMACSHA256_UnitTests)
@@ -54,6 +54,7 @@ extern "C"
 #include "azure_c_shared_utility/socketio.h"
 #include "azure_c_shared_utility/strings.h"
 #include "azure_c_shared_utility/base64.h"
+#include "azure_c_shared_utility/tickcounter.h"
 
 IMPLEMENT_UMOCK_C_ENUM_TYPE(IO_OPEN_RESULT, IO_OPEN_RESULT_VALUES);
 IMPLEMENT_UMOCK_C_ENUM_TYPE(IO_SEND_RESULT, IO_SEND_RESULT_VALUES);
@@ -61,7 +62,9 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(IO_SEND_RESULT, IO_SEND_RESULT_VALUES);
 #define TEST_OPTION_HANDLER                     (OPTIONHANDLER_HANDLE)0x4244
 #define TEST_SOCKETIO_INTERFACE_DESCRIPTION     (const IO_INTERFACE_DESCRIPTION*)0x4242
 #define TEST_IO_HANDLE                          (XIO_HANDLE)0x4243
+#define TEST_TUNNEL_IO_HANDLE                   (XIO_HANDLE)0x4250
 #define TEST_STRING_HANDLE                      (STRING_HANDLE)0x4244
+#define TEST_TICK_COUNTER_HANDLE                (TICK_COUNTER_HANDLE)0x4245
 
 MOCK_FUNCTION_WITH_CODE(, void, test_on_io_open_complete, void*, context, IO_OPEN_RESULT, open_result)
 MOCK_FUNCTION_END();
@@ -234,6 +237,15 @@ static int my_xio_close(XIO_HANDLE xio, ON_IO_CLOSE_COMPLETE on_io_close_complet
     return 0;
 }
 
+static tickcounter_ms_t g_current_ms;
+
+static int my_tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, tickcounter_ms_t* current_ms)
+{
+    (void)tick_counter;
+    *current_ms = g_current_ms;
+    return 0;
+}
+
 static const char connect_response[] = "HTTP/1.1 200\r\n\r\n";
 static const HTTP_PROXY_IO_CONFIG default_http_proxy_io_config = {
     "test_host",
@@ -271,6 +283,16 @@ static const HTTP_PROXY_IO_CONFIG http_proxy_io_config_with_username_cased = {
     "lE_pAsSwOrD"
     };
 
+static const HTTP_PROXY_IO_POOL_CONFIG http_proxy_io_pool_config = {
+    "a_proxy",
+    4444,
+    NULL,
+    NULL,
+    1,
+    30000,
+    5000
+};
+
 static const SOCKETIO_CONFIG socketio_config =
 {
     "a_proxy",
@@ -313,6 +335,8 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_HOOK(OptionHandler_Create, my_OptionHandler_Create);
     REGISTER_GLOBAL_MOCK_HOOK(xio_open, my_xio_open);
     REGISTER_GLOBAL_MOCK_HOOK(xio_close, my_xio_close);
+    REGISTER_GLOBAL_MOCK_HOOK(tickcounter_get_current_ms, my_tickcounter_get_current_ms);
+    REGISTER_GLOBAL_MOCK_RETURN(tickcounter_create, TEST_TICK_COUNTER_HANDLE);
     REGISTER_GLOBAL_MOCK_RETURN(OptionHandler_Create, TEST_OPTION_HANDLER);
     REGISTER_GLOBAL_MOCK_RETURN(socketio_get_interface_description, TEST_SOCKETIO_INTERFACE_DESCRIPTION);
     REGISTER_GLOBAL_MOCK_RETURN(xio_create, TEST_IO_HANDLE);
@@ -334,6 +358,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(ON_IO_CLOSE_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(ON_SEND_COMPLETE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TICK_COUNTER_HANDLE, void*);
     REGISTER_UMOCKC_PAIRED_CREATE_DESTROY_CALLS(xio_create, xio_destroy);
 }
 
@@ -353,6 +378,7 @@ TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
     }
 
     umock_c_reset_all_calls();
+    g_current_ms = 0;
 }
 
 TEST_FUNCTION_CLEANUP(TestMethodCleanup)
@@ -2900,4 +2926,565 @@ TEST_FUNCTION(when_on_underlying_io_error_is_called_while_waiting_for_underlying
     http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
 }
 
+/* http_proxy_io_pool */
+
+static HTTP_PROXY_IO_POOL_HANDLE create_pool_with_established_tunnel(void)
+{
+    HTTP_PROXY_IO_POOL_HANDLE pool = http_proxy_io_pool_create(&http_proxy_io_pool_config);
+    (void)http_proxy_io_pool_add_host(pool, "test_host", 443);
+    http_proxy_io_pool_dowork(pool);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_OK);
+    g_on_bytes_received(g_on_bytes_received_context, (const unsigned char*)connect_response, sizeof(connect_response) - 1);
+    return pool;
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_105: [ `http_proxy_io_pool_create` shall create a pool of tunnels through the proxy given in `config`, copying the proxy host name and credentials. ]*/
+TEST_FUNCTION(http_proxy_io_pool_create_succeeds)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool;
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "a_proxy"))
+        .IgnoreArgument_destination();
+    STRICT_EXPECTED_CALL(tickcounter_create());
+
+    // act
+    pool = http_proxy_io_pool_create(&http_proxy_io_pool_config);
+
+    // assert
+    ASSERT_IS_NOT_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_106: [ If `config` or its `proxy_hostname` member is NULL, `tunnels_per_host` is 0, or only one of `username` and `password` is non-NULL, `http_proxy_io_pool_create` shall fail and return NULL. ]*/
+TEST_FUNCTION(http_proxy_io_pool_create_with_NULL_config_fails)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool;
+
+    // act
+    pool = http_proxy_io_pool_create(NULL);
+
+    // assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_106: [ If `config` or its `proxy_hostname` member is NULL, `tunnels_per_host` is 0, or only one of `username` and `password` is non-NULL, `http_proxy_io_pool_create` shall fail and return NULL. ]*/
+TEST_FUNCTION(http_proxy_io_pool_create_with_0_tunnels_per_host_fails)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_CONFIG config = http_proxy_io_pool_config;
+    HTTP_PROXY_IO_POOL_HANDLE pool;
+    config.tunnels_per_host = 0;
+
+    // act
+    pool = http_proxy_io_pool_create(&config);
+
+    // assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_107: [ If any failure occurs, `http_proxy_io_pool_create` shall free all resources allocated so far and return NULL. ]*/
+TEST_FUNCTION(when_tickcounter_create_fails_http_proxy_io_pool_create_fails)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool;
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "a_proxy"))
+        .IgnoreArgument_destination();
+    STRICT_EXPECTED_CALL(tickcounter_create())
+        .SetReturn(NULL);
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    pool = http_proxy_io_pool_create(&http_proxy_io_pool_config);
+
+    // assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_109: [ If `pool` is NULL, `http_proxy_io_pool_destroy` shall do nothing. ]*/
+TEST_FUNCTION(http_proxy_io_pool_destroy_with_NULL_does_nothing)
+{
+    // act
+    http_proxy_io_pool_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_108: [ `http_proxy_io_pool_destroy` shall destroy all tunnels still held by the pool and free the pool. ]*/
+TEST_FUNCTION(http_proxy_io_pool_destroy_destroys_the_established_tunnels)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = create_pool_with_established_tunnel();
+    umock_c_reset_all_calls();
+
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(xio_destroy(TEST_IO_HANDLE));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_destroy(TEST_TICK_COUNTER_HANDLE));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    http_proxy_io_pool_destroy(pool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_110: [ `http_proxy_io_pool_add_host` shall register `hostname` and `port` as a target for which `tunnels_per_host` tunnels are kept established. ]*/
+/* Tests_SRS_HTTP_PROXY_IO_01_112: [ If the host and port were already added, `http_proxy_io_pool_add_host` shall succeed without adding them again. ]*/
+TEST_FUNCTION(http_proxy_io_pool_add_host_adds_a_host_only_once)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = http_proxy_io_pool_create(&http_proxy_io_pool_config);
+    int result_1;
+    int result_2;
+    umock_c_reset_all_calls();
+
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_host"))
+        .IgnoreArgument_destination();
+
+    // act
+    result_1 = http_proxy_io_pool_add_host(pool, "test_host", 443);
+    result_2 = http_proxy_io_pool_add_host(pool, "test_host", 443);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result_1);
+    ASSERT_ARE_EQUAL(int, 0, result_2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_111: [ If `pool` or `hostname` is NULL, `http_proxy_io_pool_add_host` shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(http_proxy_io_pool_add_host_with_NULL_hostname_fails)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = http_proxy_io_pool_create(&http_proxy_io_pool_config);
+    int result;
+    umock_c_reset_all_calls();
+
+    // act
+    result = http_proxy_io_pool_add_host(pool, NULL, 443);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_115: [ For each empty tunnel slot of each registered host, `http_proxy_io_pool_dowork` shall create an HTTP proxy IO for the host and open it, which connects to the proxy and sends the CONNECT request. ]*/
+/* Tests_SRS_HTTP_PROXY_IO_01_116: [ TCP keep-alive shall be enabled on the tunnel by setting the `tcp_keepalive` option on its socket IO. Failure to set the option shall be ignored. ]*/
+TEST_FUNCTION(http_proxy_io_pool_dowork_opens_a_tunnel_for_each_empty_slot)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = http_proxy_io_pool_create(&http_proxy_io_pool_config);
+    (void)http_proxy_io_pool_add_host(pool, "test_host", 443);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument_current_ms();
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_host"))
+        .IgnoreArgument_destination();
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "a_proxy"))
+        .IgnoreArgument_destination();
+    STRICT_EXPECTED_CALL(socketio_get_interface_description());
+    STRICT_EXPECTED_CALL(xio_create(TEST_SOCKETIO_INTERFACE_DESCRIPTION, &socketio_config))
+        .ValidateArgumentValue_io_create_parameters_AsType(UMOCK_TYPE(SOCKETIO_CONFIG*));
+    STRICT_EXPECTED_CALL(xio_setoption(TEST_IO_HANDLE, "tcp_keepalive", IGNORED_PTR_ARG))
+        .IgnoreArgument_value()
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(xio_open(TEST_IO_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .IgnoreArgument_on_io_open_complete()
+        .IgnoreArgument_on_io_open_complete_context()
+        .IgnoreArgument_on_bytes_received()
+        .IgnoreArgument_on_bytes_received_context()
+        .IgnoreArgument_on_io_error()
+        .IgnoreArgument_on_io_error_context();
+
+    // act
+    http_proxy_io_pool_dowork(pool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_121: [ `http_proxy_io_pool_dowork` shall call `xio_dowork` for every tunnel that is being established or idle. ]*/
+TEST_FUNCTION(http_proxy_io_pool_dowork_drives_an_established_tunnel)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = create_pool_with_established_tunnel();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument_current_ms();
+    STRICT_EXPECTED_CALL(xio_dowork(TEST_IO_HANDLE));
+
+    // act
+    http_proxy_io_pool_dowork(pool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_122: [ A tunnel that stays idle, or being established, for longer than a non-zero `idle_timeout_ms` shall be destroyed and re-established, so the proxy never sees an idle connection long enough to drop it. ]*/
+TEST_FUNCTION(http_proxy_io_pool_dowork_replaces_a_tunnel_idle_for_longer_than_the_idle_timeout)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = create_pool_with_established_tunnel();
+    umock_c_reset_all_calls();
+    g_current_ms = 30000;
+
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument_current_ms();
+    STRICT_EXPECTED_CALL(xio_dowork(TEST_IO_HANDLE));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(xio_destroy(TEST_IO_HANDLE));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "test_host"))
+        .IgnoreArgument_destination();
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "a_proxy"))
+        .IgnoreArgument_destination();
+    STRICT_EXPECTED_CALL(socketio_get_interface_description());
+    STRICT_EXPECTED_CALL(xio_create(TEST_SOCKETIO_INTERFACE_DESCRIPTION, &socketio_config))
+        .ValidateArgumentValue_io_create_parameters_AsType(UMOCK_TYPE(SOCKETIO_CONFIG*));
+    STRICT_EXPECTED_CALL(xio_setoption(TEST_IO_HANDLE, "tcp_keepalive", IGNORED_PTR_ARG))
+        .IgnoreArgument_value();
+    EXPECTED_CALL(xio_open(TEST_IO_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    // act
+    http_proxy_io_pool_dowork(pool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_119: [ If establishing a pooled tunnel fails, the tunnel shall be destroyed by the next `http_proxy_io_pool_dowork` and re-established only after `retry_interval_ms`. ]*/
+TEST_FUNCTION(a_failed_pooled_tunnel_is_destroyed_and_not_reopened_before_the_retry_interval)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = http_proxy_io_pool_create(&http_proxy_io_pool_config);
+    (void)http_proxy_io_pool_add_host(pool, "test_host", 443);
+    http_proxy_io_pool_dowork(pool);
+    g_on_io_open_complete(g_on_io_open_complete_context, IO_OPEN_ERROR);
+    umock_c_reset_all_calls();
+    g_current_ms = 4999;
+
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument_current_ms();
+    STRICT_EXPECTED_CALL(xio_destroy(TEST_IO_HANDLE));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument_current_ms();
+
+    // act
+    http_proxy_io_pool_dowork(pool);
+    http_proxy_io_pool_dowork(pool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_045: [ `http_proxy_io_pool` - the value is the `HTTP_PROXY_IO_POOL_HANDLE` used by subsequent opens, NULL detaches the pool. ]*/
+TEST_FUNCTION(http_proxy_io_set_option_with_the_pool_option_does_not_call_the_underlying_io)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = http_proxy_io_pool_create(&http_proxy_io_pool_config);
+    CONCRETE_IO_HANDLE http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&http_proxy_io_config_no_username);
+    int result;
+    umock_c_reset_all_calls();
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_setoption(http_io, OPTION_HTTP_PROXY_IO_POOL, pool);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_097: [ If a pool was attached with the option `http_proxy_io_pool`, `http_proxy_io_open` shall take an established tunnel from the pool for the same target host, port, proxy and credentials. ]*/
+/* Tests_SRS_HTTP_PROXY_IO_01_099: [ When a tunnel is taken from the pool, `on_io_open_complete` shall be called with `IO_OPEN_OK` and `http_proxy_io_open` shall return 0. ]*/
+TEST_FUNCTION(http_proxy_io_open_with_a_pool_takes_an_established_tunnel)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = create_pool_with_established_tunnel();
+    CONCRETE_IO_HANDLE http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&http_proxy_io_config_no_username);
+    int result;
+    (void)http_proxy_io_get_interface_description()->concrete_io_setoption(http_io, OPTION_HTTP_PROXY_IO_POOL, pool);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_on_io_open_complete((void*)0x4242, IO_OPEN_OK));
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_098: [ When a tunnel is taken from the pool, the `on_bytes_received` and `on_io_error` callbacks shall be indicated by the tunnel and all subsequent send, close and dowork calls shall be forwarded to it. ]*/
+TEST_FUNCTION(bytes_received_on_a_tunnel_taken_from_the_pool_are_indicated_to_the_user)
+{
+    // arrange
+    unsigned char test_buffer[] = { 0x42 };
+    HTTP_PROXY_IO_POOL_HANDLE pool = create_pool_with_established_tunnel();
+    ON_BYTES_RECEIVED tunnel_on_bytes_received = g_on_bytes_received;
+    void* tunnel_on_bytes_received_context = g_on_bytes_received_context;
+    CONCRETE_IO_HANDLE http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&http_proxy_io_config_no_username);
+    (void)http_proxy_io_get_interface_description()->concrete_io_setoption(http_io, OPTION_HTTP_PROXY_IO_POOL, pool);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_on_bytes_received((void*)0x4243, IGNORED_PTR_ARG, sizeof(test_buffer)))
+        .ValidateArgumentBuffer(2, test_buffer, sizeof(test_buffer));
+
+    // act
+    tunnel_on_bytes_received(tunnel_on_bytes_received_context, test_buffer, sizeof(test_buffer));
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_098: [ When a tunnel is taken from the pool, the `on_bytes_received` and `on_io_error` callbacks shall be indicated by the tunnel and all subsequent send, close and dowork calls shall be forwarded to it. ]*/
+/* Tests_SRS_HTTP_PROXY_IO_01_103: [ `http_proxy_io_destroy` shall destroy the tunnel taken from the pool, if any. ]*/
+/* Tests_SRS_HTTP_PROXY_IO_01_125: [ Closing a tunnel taken from the pool shall close its connection to the proxy; the tunnel shall not be returned to the pool. ]*/
+TEST_FUNCTION(close_on_a_tunnel_taken_from_the_pool_closes_the_tunnel)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = create_pool_with_established_tunnel();
+    CONCRETE_IO_HANDLE http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&http_proxy_io_config_no_username);
+    int result;
+    (void)http_proxy_io_get_interface_description()->concrete_io_setoption(http_io, OPTION_HTTP_PROXY_IO_POOL, pool);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(xio_close(TEST_IO_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .IgnoreArgument_on_io_close_complete()
+        .IgnoreArgument_callback_context();
+    STRICT_EXPECTED_CALL(test_on_io_close_complete((void*)0x4245));
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_close(http_io, test_on_io_close_complete, (void*)0x4245);
+    g_on_io_close_complete(g_on_io_close_complete_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_123: [ If a tunnel was taken from the pool by the last open, `xio_setoption` shall also be called on the underlying IO of the tunnel, so that the option applies to the live connection. ]*/
+TEST_FUNCTION(http_proxy_io_set_option_after_taking_a_tunnel_sets_the_option_on_the_tunnel)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool;
+    CONCRETE_IO_HANDLE http_io;
+    int result;
+    int keepalive = 1;
+    REGISTER_GLOBAL_MOCK_RETURN(xio_create, TEST_TUNNEL_IO_HANDLE);
+    pool = create_pool_with_established_tunnel();
+    REGISTER_GLOBAL_MOCK_RETURN(xio_create, TEST_IO_HANDLE);
+    http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&http_proxy_io_config_no_username);
+    (void)http_proxy_io_get_interface_description()->concrete_io_setoption(http_io, OPTION_HTTP_PROXY_IO_POOL, pool);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(xio_setoption(TEST_IO_HANDLE, "tcp_keepalive", &keepalive));
+    STRICT_EXPECTED_CALL(xio_setoption(TEST_TUNNEL_IO_HANDLE, "tcp_keepalive", &keepalive));
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_setoption(http_io, "tcp_keepalive", &keepalive);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_044: [ if `xio_setoption` fails, `http_proxy_io_set_option` shall return a non-zero value. ]*/
+TEST_FUNCTION(when_setting_the_option_on_the_tunnel_fails_http_proxy_io_set_option_fails)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool;
+    CONCRETE_IO_HANDLE http_io;
+    int result;
+    int keepalive = 1;
+    REGISTER_GLOBAL_MOCK_RETURN(xio_create, TEST_TUNNEL_IO_HANDLE);
+    pool = create_pool_with_established_tunnel();
+    REGISTER_GLOBAL_MOCK_RETURN(xio_create, TEST_IO_HANDLE);
+    http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&http_proxy_io_config_no_username);
+    (void)http_proxy_io_get_interface_description()->concrete_io_setoption(http_io, OPTION_HTTP_PROXY_IO_POOL, pool);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(xio_setoption(TEST_IO_HANDLE, "tcp_keepalive", &keepalive));
+    STRICT_EXPECTED_CALL(xio_setoption(TEST_TUNNEL_IO_HANDLE, "tcp_keepalive", &keepalive))
+        .SetReturn(1);
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_setoption(http_io, "tcp_keepalive", &keepalive);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_124: [ If a tunnel was taken from the pool by the last open, `http_proxy_io_retrieve_options` shall call `xio_retrieveoptions` on the underlying IO of the tunnel instead. ]*/
+TEST_FUNCTION(http_proxy_io_retrieve_options_after_taking_a_tunnel_retrieves_the_options_of_the_tunnel)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool;
+    CONCRETE_IO_HANDLE http_io;
+    OPTIONHANDLER_HANDLE result;
+    REGISTER_GLOBAL_MOCK_RETURN(xio_create, TEST_TUNNEL_IO_HANDLE);
+    pool = create_pool_with_established_tunnel();
+    REGISTER_GLOBAL_MOCK_RETURN(xio_create, TEST_IO_HANDLE);
+    http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&http_proxy_io_config_no_username);
+    (void)http_proxy_io_get_interface_description()->concrete_io_setoption(http_io, OPTION_HTTP_PROXY_IO_POOL, pool);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(xio_retrieveoptions(TEST_TUNNEL_IO_HANDLE));
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_retrieveoptions(http_io);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_OPTION_HANDLER, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_104: [ A tunnel taken from the pool shall be removed from it and its slot shall be refilled by the next `http_proxy_io_pool_dowork`. ]*/
+/* Tests_SRS_HTTP_PROXY_IO_01_100: [ If no pool is attached or the pool has no established tunnel for the target, `http_proxy_io_open` shall open its own underlying IO and perform the CONNECT handshake. ]*/
+TEST_FUNCTION(http_proxy_io_open_with_an_exhausted_pool_opens_the_underlying_io)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = create_pool_with_established_tunnel();
+    CONCRETE_IO_HANDLE http_io_1 = http_proxy_io_get_interface_description()->concrete_io_create((void*)&http_proxy_io_config_no_username);
+    CONCRETE_IO_HANDLE http_io_2 = http_proxy_io_get_interface_description()->concrete_io_create((void*)&http_proxy_io_config_no_username);
+    int result;
+    (void)http_proxy_io_get_interface_description()->concrete_io_setoption(http_io_1, OPTION_HTTP_PROXY_IO_POOL, pool);
+    (void)http_proxy_io_get_interface_description()->concrete_io_setoption(http_io_2, OPTION_HTTP_PROXY_IO_POOL, pool);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io_1, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(xio_open(TEST_IO_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .IgnoreArgument_on_io_open_complete()
+        .IgnoreArgument_on_io_open_complete_context()
+        .IgnoreArgument_on_bytes_received()
+        .IgnoreArgument_on_bytes_received_context()
+        .IgnoreArgument_on_io_error()
+        .IgnoreArgument_on_io_error_context();
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_open(http_io_2, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io_1);
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io_2);
+    http_proxy_io_pool_destroy(pool);
+}
+
+/* Tests_SRS_HTTP_PROXY_IO_01_101: [ If a tunnel taken from the pool by a previous open is not yet closed, `http_proxy_io_open` shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(http_proxy_io_open_while_a_pooled_tunnel_is_open_fails)
+{
+    // arrange
+    HTTP_PROXY_IO_POOL_HANDLE pool = create_pool_with_established_tunnel();
+    CONCRETE_IO_HANDLE http_io = http_proxy_io_get_interface_description()->concrete_io_create((void*)&http_proxy_io_config_no_username);
+    int result;
+    (void)http_proxy_io_get_interface_description()->concrete_io_setoption(http_io, OPTION_HTTP_PROXY_IO_POOL, pool);
+    (void)http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+    umock_c_reset_all_calls();
+
+    // act
+    result = http_proxy_io_get_interface_description()->concrete_io_open(http_io, test_on_io_open_complete, (void*)0x4242, test_on_bytes_received, (void*)0x4243, test_on_io_error, (void*)0x4244);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    http_proxy_io_get_interface_description()->concrete_io_destroy(http_io);
+    http_proxy_io_pool_destroy(pool);
+}
+
 END_TEST_SUITE(http_proxy_io_unittests)
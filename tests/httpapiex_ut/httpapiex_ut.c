@@ -77,6 +77,9 @@ void my_gballoc_free(void* ptr)
 #include "azure_c_shared_utility/buffer_.h"
 #include "azure_c_shared_utility/httpheaders.h"
 #include "azure_c_shared_utility/httpapi.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/gb_rand.h"
 
 static size_t currentHTTPAPI_SaveOption_call;
 static size_t whenShallHTTPAPI_SaveOption_fail;
@@ -288,6 +291,7 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTPAPI_REQUEST_TYPE, HTTPAPI_REQUEST_TYPE_VALUES);
 #define TEST_BUFFER_RESP_BODY   (BUFFER_HANDLE) 0x49
 unsigned char* TEST_BUFFER = (unsigned char*)"333333";
 #define TEST_BUFFER_SIZE 6
+#define TEST_TICK_COUNTER       (TICK_COUNTER_HANDLE) 0x4A
 
 static TEST_MUTEX_HANDLE g_testByTest;
 static TEST_MUTEX_HANDLE g_dllByDll;
@@ -414,6 +418,13 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL(temp_str);
 }
 
+static bool recordStatusCodeShouldRetry(void* context, HTTPAPIEX_RESULT result, unsigned int statusCode)
+{
+    (void)result;
+    *(unsigned int*)context = statusCode;
+    return false;
+}
+
 BEGIN_TEST_SUITE(httpapiex_unittests)
 
 TEST_SUITE_INITIALIZE(TestClassInitialize)
@@ -441,6 +452,7 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_UMOCK_ALIAS_TYPE(HTTP_HEADERS_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(HTTP_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(const unsigned char*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TICK_COUNTER_HANDLE, void*);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
@@ -475,6 +487,10 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_HOOK(VECTOR_size, real_VECTOR_size);
     REGISTER_GLOBAL_MOCK_HOOK(mallocAndStrcpy_s, real_mallocAndStrcpy_s);
     REGISTER_GLOBAL_MOCK_HOOK(size_tToString, real_size_tToString);
+    REGISTER_GLOBAL_MOCK_RETURN(tickcounter_create, TEST_TICK_COUNTER);
+    REGISTER_GLOBAL_MOCK_RETURN(tickcounter_get_current_ms, 0);
+    REGISTER_GLOBAL_MOCK_RETURN(gb_rand, 0);
+    REGISTER_GLOBAL_MOCK_RETURN(HTTPHeaders_GetHeaderCount, HTTP_HEADERS_OK);
 }
 
 TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -3336,4 +3352,334 @@ TEST_FUNCTION(HTTPAPIEX_Destroy_with_NULL_argument_does_nothing)
     ///destroy
 }
 
+/*Tests_SRS_HTTPAPIEX_07_001: [ If optionName is OPTION_HTTPAPIEX_RETRY_POLICY then HTTPAPIEX_SetOption shall not pass the option to HTTPAPI and shall treat value as a const HTTPAPIEX_RETRY_POLICY*. ]*/
+/*Tests_SRS_HTTPAPIEX_07_004: [ Otherwise HTTPAPIEX_SetOption shall copy the retry policy, use it for all subsequent calls to HTTPAPIEX_ExecuteRequest and return HTTPAPIEX_OK. ]*/
+TEST_FUNCTION(HTTPAPIEX_SetOption_retry_policy_succeeds)
+{
+    /// arrange
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 3, 100, 1000, 0, true, NULL, NULL };
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_create());
+    STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(HTTPAPIEX_RETRY_POLICY)));
+
+    /// act
+    result = HTTPAPIEX_SetOption(httpapiexhandle, OPTION_HTTPAPIEX_RETRY_POLICY, &retryPolicy);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_07_002: [ If the tick counter used to measure backoff, deadline and latency cannot be created then HTTPAPIEX_SetOption shall return HTTPAPIEX_ERROR. ]*/
+TEST_FUNCTION(HTTPAPIEX_SetOption_retry_policy_fails_when_tickcounter_create_fails)
+{
+    /// arrange
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 3, 100, 1000, 0, true, NULL, NULL };
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_create())
+        .SetReturn(NULL);
+
+    /// act
+    result = HTTPAPIEX_SetOption(httpapiexhandle, OPTION_HTTPAPIEX_RETRY_POLICY, &retryPolicy);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_07_008: [ An attempt shall not be retried when shouldRetry returns false or when maxRetries retries have already been made. ]*/
+/*Tests_SRS_HTTPAPIEX_07_009: [ Before retrying, HTTPAPIEX_ExecuteRequest shall sleep a random time between 0 and min(maxBackoffInMs, initialBackoffInMs * 2^retry) milliseconds. ]*/
+/*Tests_SRS_HTTPAPIEX_07_010: [ If the policy does not provide shouldRetry then an attempt shall be retried when it returned HTTPAPIEX_RECOVERYFAILED or when it completed with status code 408, 429, 500, 502, 503 or 504. ]*/
+/*Tests_SRS_HTTPAPIEX_07_013: [ The response headers of the last attempt shall be copied into the responseHttpHeadersHandle passed by the caller, if any. ]*/
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequest_with_retry_policy_retries_a_503_once)
+{
+    /// arrange
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 1, 100, 1000, 0, false, NULL, NULL };
+    HTTPAPIEX_STATISTICS statistics;
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    unsigned int httpStatusCode;
+    unsigned int throttled = 503;
+    unsigned int accepted = 200;
+    size_t zeroHeaders = 0;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    BUFFER_HANDLE requestHttpBody = TEST_BUFFER_REQ_BODY;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    BUFFER_HANDLE responseHttpBody = TEST_BUFFER_RESP_BODY;
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    (void)HTTPAPIEX_SetOption(httpapiexhandle, OPTION_HTTPAPIEX_RETRY_POLICY, &retryPolicy);
+    umock_c_reset_all_calls();
+
+    setupAllCallBeforeHTTPsequence();
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+
+    /*first attempt, answered with 503*/
+    STRICT_EXPECTED_CALL(HTTPHeaders_Alloc());
+    STRICT_EXPECTED_CALL(HTTPAPI_Init());
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPAPI_CreateConnection(TEST_HOSTNAME));
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(BUFFER_length(requestHttpBody))
+        .SetReturn(TEST_BUFFER_SIZE);
+    STRICT_EXPECTED_CALL(BUFFER_u_char(requestHttpBody))
+        .SetReturn(TEST_BUFFER);
+    STRICT_EXPECTED_CALL(HTTPAPI_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, IGNORED_PTR_ARG, TEST_BUFFER_SIZE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, responseHttpBody))
+        .IgnoreArgument(1)
+        .IgnoreArgument(5)
+        .IgnoreArgument(7)
+        .IgnoreArgument(8)
+        .CopyOutArgumentBuffer(7, &throttled, sizeof(throttled));
+    STRICT_EXPECTED_CALL(gb_rand());
+    STRICT_EXPECTED_CALL(gb_rand());
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(IGNORED_NUM_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPHeaders_Free(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+
+    /*second attempt, the connection is reused*/
+    STRICT_EXPECTED_CALL(HTTPHeaders_Alloc());
+    STRICT_EXPECTED_CALL(BUFFER_length(responseHttpBody))
+        .SetReturn(0);
+    STRICT_EXPECTED_CALL(BUFFER_length(requestHttpBody))
+        .SetReturn(TEST_BUFFER_SIZE);
+    STRICT_EXPECTED_CALL(BUFFER_u_char(requestHttpBody))
+        .SetReturn(TEST_BUFFER);
+    STRICT_EXPECTED_CALL(HTTPAPI_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, IGNORED_PTR_ARG, TEST_BUFFER_SIZE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, responseHttpBody))
+        .IgnoreArgument(1)
+        .IgnoreArgument(5)
+        .IgnoreArgument(7)
+        .IgnoreArgument(8)
+        .CopyOutArgumentBuffer(7, &accepted, sizeof(accepted));
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderCount(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .IgnoreArgument(1)
+        .IgnoreArgument(2)
+        .CopyOutArgumentBuffer(2, &zeroHeaders, sizeof(zeroHeaders));
+    STRICT_EXPECTED_CALL(HTTPHeaders_Free(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+
+    /// act
+    result = HTTPAPIEX_ExecuteRequest(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, requestHttpBody, &httpStatusCode, responseHttpHeaders, responseHttpBody);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(int, 200, httpStatusCode);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, HTTPAPIEX_GetStatistics(httpapiexhandle, &statistics));
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.requestCount);
+    ASSERT_ARE_EQUAL(size_t, 2, statistics.attemptCount);
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.retryCount);
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.throttledCount);
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.failedCount);
+
+    ///destroy
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_07_011: [ If honorRetryAfter is true and a 429 or 503 response carries a Retry-After header in seconds, that delay shall be used instead. ]*/
+/*Tests_SRS_HTTPAPIEX_07_018: [ The Retry-After delay shall be capped at maxBackoffInMs. ]*/
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequest_with_retry_policy_caps_the_Retry_After_delay_at_maxBackoffInMs)
+{
+    /// arrange
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 1, 100, 1000, 0, true, NULL, NULL };
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    unsigned int httpStatusCode;
+    unsigned int throttled = 503;
+    unsigned int accepted = 200;
+    size_t zeroHeaders = 0;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    BUFFER_HANDLE requestHttpBody = TEST_BUFFER_REQ_BODY;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    BUFFER_HANDLE responseHttpBody = TEST_BUFFER_RESP_BODY;
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    (void)HTTPAPIEX_SetOption(httpapiexhandle, OPTION_HTTPAPIEX_RETRY_POLICY, &retryPolicy);
+    umock_c_reset_all_calls();
+
+    setupAllCallBeforeHTTPsequence();
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+
+    /*first attempt, answered with 503*/
+    STRICT_EXPECTED_CALL(HTTPHeaders_Alloc());
+    STRICT_EXPECTED_CALL(HTTPAPI_Init());
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(HTTPAPI_CreateConnection(TEST_HOSTNAME));
+    STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(BUFFER_length(requestHttpBody))
+        .SetReturn(TEST_BUFFER_SIZE);
+    STRICT_EXPECTED_CALL(BUFFER_u_char(requestHttpBody))
+        .SetReturn(TEST_BUFFER);
+    STRICT_EXPECTED_CALL(HTTPAPI_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, IGNORED_PTR_ARG, TEST_BUFFER_SIZE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, responseHttpBody))
+        .IgnoreArgument(1)
+        .IgnoreArgument(5)
+        .IgnoreArgument(7)
+        .IgnoreArgument(8)
+        .CopyOutArgumentBuffer(7, &throttled, sizeof(throttled));
+    STRICT_EXPECTED_CALL(gb_rand());
+    STRICT_EXPECTED_CALL(gb_rand());
+    STRICT_EXPECTED_CALL(HTTPHeaders_FindHeaderValue(IGNORED_PTR_ARG, "Retry-After"))
+        .IgnoreArgument(1)
+        .SetReturn("3600");
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    /*an hour asked by the server, maxBackoffInMs slept*/
+    STRICT_EXPECTED_CALL(ThreadAPI_Sleep(1000));
+    STRICT_EXPECTED_CALL(HTTPHeaders_Free(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+
+    /*second attempt, the connection is reused*/
+    STRICT_EXPECTED_CALL(HTTPHeaders_Alloc());
+    STRICT_EXPECTED_CALL(BUFFER_length(responseHttpBody))
+        .SetReturn(0);
+    STRICT_EXPECTED_CALL(BUFFER_length(requestHttpBody))
+        .SetReturn(TEST_BUFFER_SIZE);
+    STRICT_EXPECTED_CALL(BUFFER_u_char(requestHttpBody))
+        .SetReturn(TEST_BUFFER);
+    STRICT_EXPECTED_CALL(HTTPAPI_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, IGNORED_PTR_ARG, TEST_BUFFER_SIZE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, responseHttpBody))
+        .IgnoreArgument(1)
+        .IgnoreArgument(5)
+        .IgnoreArgument(7)
+        .IgnoreArgument(8)
+        .CopyOutArgumentBuffer(7, &accepted, sizeof(accepted));
+    STRICT_EXPECTED_CALL(HTTPHeaders_GetHeaderCount(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .IgnoreArgument(1)
+        .IgnoreArgument(2)
+        .CopyOutArgumentBuffer(2, &zeroHeaders, sizeof(zeroHeaders));
+    STRICT_EXPECTED_CALL(HTTPHeaders_Free(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+
+    /// act
+    result = HTTPAPIEX_ExecuteRequest(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, requestHttpBody, &httpStatusCode, responseHttpHeaders, responseHttpBody);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(int, 200, httpStatusCode);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_07_017: [ When a retry policy is set, HTTPAPIEX_ExecuteRequest shall set the status code to 0 before each attempt, so that shouldRetry sees 0 for an attempt that did not complete. ]*/
+TEST_FUNCTION(HTTPAPIEX_ExecuteRequest_with_retry_policy_passes_status_code_0_to_shouldRetry_when_the_attempt_fails)
+{
+    /// arrange
+    HTTPAPIEX_RESULT result;
+    unsigned int seenStatusCode = 555;
+    HTTPAPIEX_RETRY_POLICY retryPolicy = { 0, 100, 1000, 0, false, recordStatusCodeShouldRetry, &seenStatusCode };
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    unsigned int httpStatusCode = 555;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    BUFFER_HANDLE requestHttpBody = TEST_BUFFER_REQ_BODY;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    BUFFER_HANDLE responseHttpBody = TEST_BUFFER_RESP_BODY;
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    (void)HTTPAPIEX_SetOption(httpapiexhandle, OPTION_HTTPAPIEX_RETRY_POLICY, &retryPolicy);
+    umock_c_reset_all_calls();
+    REGISTER_GLOBAL_MOCK_RETURN(HTTPAPI_ExecuteRequest, HTTPAPI_ERROR);
+
+    /// act
+    result = HTTPAPIEX_ExecuteRequest(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, requestHttpBody, &httpStatusCode, responseHttpHeaders, responseHttpBody);
+    REGISTER_GLOBAL_MOCK_RETURN(HTTPAPI_ExecuteRequest, HTTPAPI_OK);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, seenStatusCode);
+    ASSERT_ARE_EQUAL(int, 0, httpStatusCode);
+
+    ///destroy
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_07_015: [ If handle or statistics is NULL then HTTPAPIEX_GetStatistics shall return HTTPAPIEX_INVALID_ARG. ]*/
+TEST_FUNCTION(HTTPAPIEX_GetStatistics_with_NULL_handle_fails)
+{
+    /// arrange
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_STATISTICS statistics;
+
+    /// act
+    result = HTTPAPIEX_GetStatistics(NULL, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_HTTPAPIEX_07_015: [ If handle or statistics is NULL then HTTPAPIEX_GetStatistics shall return HTTPAPIEX_INVALID_ARG. ]*/
+TEST_FUNCTION(HTTPAPIEX_GetStatistics_with_NULL_statistics_fails)
+{
+    /// arrange
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    umock_c_reset_all_calls();
+
+    /// act
+    result = HTTPAPIEX_GetStatistics(httpapiexhandle, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///destroy
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
+/*Tests_SRS_HTTPAPIEX_07_006: [ Every call to HTTPAPIEX_ExecuteRequest that gets past argument validation shall be counted in requestCount, and in failedCount when it does not return HTTPAPIEX_OK. ]*/
+/*Tests_SRS_HTTPAPIEX_07_016: [ Otherwise HTTPAPIEX_GetStatistics shall copy the counters of handle into statistics and return HTTPAPIEX_OK. ]*/
+TEST_FUNCTION(HTTPAPIEX_GetStatistics_counts_requests_without_retry_policy)
+{
+    /// arrange
+    HTTPAPIEX_HANDLE httpapiexhandle = HTTPAPIEX_Create(TEST_HOSTNAME);
+    HTTPAPIEX_RESULT result;
+    HTTPAPIEX_STATISTICS statistics;
+    unsigned int httpStatusCode;
+    HTTP_HEADERS_HANDLE requestHttpHeaders;
+    HTTP_HEADERS_HANDLE responseHttpHeaders;
+    createHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    (void)HTTPAPIEX_ExecuteRequest(httpapiexhandle, HTTPAPI_REQUEST_PATCH, TEST_RELATIVE_PATH, requestHttpHeaders, TEST_BUFFER_REQ_BODY, &httpStatusCode, responseHttpHeaders, TEST_BUFFER_RESP_BODY);
+    umock_c_reset_all_calls();
+
+    /// act
+    result = HTTPAPIEX_GetStatistics(httpapiexhandle, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(HTTPAPIEX_RESULT, HTTPAPIEX_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.requestCount);
+    ASSERT_ARE_EQUAL(size_t, 1, statistics.attemptCount);
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.retryCount);
+    ASSERT_ARE_EQUAL(size_t, 0, statistics.failedCount);
+
+    ///destroy
+    destroyHttpObjects(&requestHttpHeaders, &responseHttpHeaders);
+    HTTPAPIEX_Destroy(httpapiexhandle);
+}
+
 END_TEST_SUITE(httpapiex_unittests)
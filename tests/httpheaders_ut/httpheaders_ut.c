@@ -71,25 +71,6 @@ void my_gballoc_free(void* ptr)
 
 #define ENABLE_MOCKS
 
-#include "azure_c_shared_utility/map.h"
-
-MAP_HANDLE my_Map_Create(MAP_FILTER_CALLBACK mapFilterFunc)
-{
-    (void)mapFilterFunc;
-    return (MAP_HANDLE)malloc(1);
-}
-
-MAP_HANDLE my_Map_Clone(MAP_HANDLE handle)
-{
-    (void)handle;
-    return (MAP_HANDLE)malloc(1);
-}
-
-void my_Map_Destroy(MAP_HANDLE handle)
-{
-    free(handle);
-}
-
 #include "azure_c_shared_utility/gballoc.h"
 
 #undef ENABLE_MOCKS
@@ -104,8 +85,6 @@ static TEST_MUTEX_HANDLE g_testByTest;
 TEST_DEFINE_ENUM_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 
-IMPLEMENT_UMOCK_C_ENUM_TYPE(MAP_RESULT, MAP_RESULT_VALUES);
-
 /*test assets*/
 #define NAME1 "name1"
 #define VALUE1 "value1"
@@ -121,6 +100,7 @@ static const char *NAME1_TRICK3 = "name1: value1";
 #define TEMP_BUFFER_SIZE 1024
 static char tempBuffer[TEMP_BUFFER_SIZE];
 
+/*more headers than fit in the allocation made by HTTPHeaders_Alloc*/
 #define MAX_NAME_VALUE_PAIR 100
 
 static TEST_MUTEX_HANDLE g_dllByDll;
@@ -134,6 +114,14 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL(temp_str);
 }
 
+/*a value that does not fit in the storage that comes with HTTPHeaders_Alloc*/
+static const char* getLongValue(void)
+{
+    (void)memset(tempBuffer, 'x', TEMP_BUFFER_SIZE - 1);
+    tempBuffer[TEMP_BUFFER_SIZE - 1] = '\0';
+    return tempBuffer;
+}
+
 BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
 
     TEST_SUITE_INITIALIZE(TestClassInitialize)
@@ -150,17 +138,6 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         result = umocktypes_charptr_register_types();
         ASSERT_ARE_EQUAL(int, 0, result);
 
-        REGISTER_TYPE(MAP_RESULT, MAP_RESULT);
-        REGISTER_UMOCK_ALIAS_TYPE(MAP_FILTER_CALLBACK, void*);
-        REGISTER_UMOCK_ALIAS_TYPE(MAP_HANDLE, void*);
-
-        REGISTER_GLOBAL_MOCK_HOOK(Map_Create, my_Map_Create);
-        REGISTER_GLOBAL_MOCK_HOOK(Map_Clone, my_Map_Clone);
-        REGISTER_GLOBAL_MOCK_HOOK(Map_Destroy, my_Map_Destroy);
-        REGISTER_GLOBAL_MOCK_RETURN(Map_AddOrUpdate, MAP_OK);
-        REGISTER_GLOBAL_MOCK_RETURN(Map_GetValueFromKey, VALUE1);
-        REGISTER_GLOBAL_MOCK_RETURN(Map_GetInternals, MAP_OK);
-
         REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
         REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
         REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
@@ -197,6 +174,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
 
 
     /*Tests_SRS_HTTP_HEADERS_99_002:[ This API shall produce a HTTP_HANDLE that can later be used in subsequent calls to the module.]*/
+    /*Tests_SRS_HTTP_HEADERS_99_038: [ HTTPHeaders_Alloc shall allocate the handle, room for the first headers and the first bytes of header storage in a single allocation. ]*/
     TEST_FUNCTION(HTTPHeaders_Alloc_happy_path_succeeds)
     {
         ///arrange
@@ -204,8 +182,6 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Map_Create(IGNORED_PTR_ARG));
-
         ///act
         handle = HTTPHeaders_Alloc();
 
@@ -255,8 +231,6 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_HANDLE handle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_Destroy(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
@@ -267,28 +241,6 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     }
 
-
-    /*Tests_SRS_HTTP_HEADERS_99_003:[ The function shall return NULL when the function cannot execute properly]*/
-    TEST_FUNCTION(HTTPHeaders_Alloc_fails_when_Map_Create_fails)
-    {
-        ///arrange
-        HTTP_HEADERS_HANDLE httpHandle;
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(Map_Create(IGNORED_PTR_ARG))
-            .SetReturn(NULL);
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        httpHandle = HTTPHeaders_Alloc();
-
-        ///assert
-        ASSERT_IS_NULL(httpHandle);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    }
-
     /*Tests_SRS_HTTP_HEADERS_99_004:[ After a successful init, HTTPHeaders_GetHeaderCount shall report 0 existing headers.]*/
     TEST_FUNCTION(HTTPHeaders_Alloc_succeeds_and_GetHeaderCount_returns_0)
     {
@@ -296,13 +248,8 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_RESULT res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         size_t nHeaders;
-        size_t zero = 0;
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .IgnoreAllArguments()
-            .CopyOutArgumentBuffer(4, &zero, sizeof(zero));
-
         ///act
         res = HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
 
@@ -324,51 +271,40 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist*/
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_PTR_ARG, NAME1, VALUE1))
-            .IgnoreArgument(1);
-
         ///act
         res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
 
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        /*the header fits in the storage that comes with the handle*/
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-        //checking content
-
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*Codes_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
-    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_fails_when_Map_AddOrUpdate_fails)
+    /*Tests_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_fails_when_malloc_fails)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist*/
-
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_PTR_ARG, NAME1, VALUE1))
-            .IgnoreArgument(1)
-            .SetReturn(MAP_ERROR);
+        whenShallmalloc_fail = currentmalloc_call + 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
 
         ///act
-        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, getLongValue());
 
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        //checking content
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 0, nHeaders);
+        ASSERT_IS_NULL(HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
@@ -379,16 +315,10 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
+        char* headerValue;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist*/
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_PTR_ARG, NAME1, VALUE1))
-            .IgnoreArgument(1);
-
         ///act
         res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
 
@@ -397,13 +327,14 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         //checking content
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, HTTPHeaders_GetHeader(httpHandle, 0, &headerValue));
+        ASSERT_ARE_EQUAL(char_ptr, HEADER1, headerValue);
 
         ///cleanup
+        free(headerValue);
         HTTPHeaders_Free(httpHandle);
     }
 
-
-
     /*Tests_SRS_HTTP_HEADERS_99_014:[ The function shall return when the handle is not valid or when name parameter is NULL or when value parameter is NULL.]*/
     TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_NULL_handle_fails)
     {
@@ -460,100 +391,73 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1);
-
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_PTR_ARG, NAME1, VALUE1 ", " VALUE1))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
         ///act
-        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE2);
 
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1 ", " VALUE2, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 1, nHeaders);
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
     /*Tests_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
-    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_same_Name_appends_fails_when_Map_AddOrUpdate_fails)
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_same_Name_fails_when_gballoc_fails)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1);
-
+        whenShallmalloc_fail = currentmalloc_call + 1;
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_PTR_ARG, NAME1, VALUE1 ", " VALUE1))
-            .IgnoreArgument(1)
-            .SetReturn(MAP_ERROR);
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
         ///act
-        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, getLongValue());
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ERROR, res);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*Tests_SRS_HTTP_HEADERS_99_015:[ The function shall return HTTP_HEADERS_ALLOC_FAILED when an internal request to allocate memory fails.]*/
-    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_same_Name_fails_when_gballoc_fails)
+    /*Tests_SRS_HTTP_HEADERS_99_017:[ If the name already exists in the collection of headers, the function shall concatenate the new value after the existing value, separated by a comma and a space as in: old-value+", "+new-value.]*/
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_same_Name_and_long_value_succeeds)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
+        const char* value;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1);
-
-        whenShallmalloc_fail = currentmalloc_call + 1;
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
 
         ///act
-        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, getLongValue());
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        value = HTTPHeaders_FindHeaderValue(httpHandle, NAME1);
+        ASSERT_IS_NOT_NULL(value);
+        ASSERT_ARE_EQUAL(size_t, strlen(VALUE1 ", ") + TEMP_BUFFER_SIZE - 1, strlen(value));
+        ASSERT_ARE_EQUAL(int, 0, strncmp(value, VALUE1 ", xxx", strlen(VALUE1 ", xxx")));
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
@@ -564,26 +468,19 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME2))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_PTR_ARG, NAME2, VALUE2))
-            .IgnoreArgument(1);
-
         ///act
         res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
 
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 2, nHeaders);
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
@@ -593,27 +490,60 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     TEST_FUNCTION(HTTPHeaders_When_Second_Added_Header_Is_A_Substring_Of_An_Existing_Header_2_Headers_Are_Added)
     {
         ///arrange
-        HTTP_HEADERS_RESULT result;
+        HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, "ab"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "ab", VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, "a"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
+        ///act
+        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, "a", VALUE2);
 
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_PTR_ARG, "a", VALUE1))
-            .IgnoreArgument(1);
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 2, nHeaders);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, HTTPHeaders_FindHeaderValue(httpHandle, "ab"));
+        ASSERT_ARE_EQUAL(char_ptr, VALUE2, HTTPHeaders_FindHeaderValue(httpHandle, "a"));
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_012:[ Calling this API shall record a header from name and value parameters.]*/
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_grows_past_the_headers_that_fit_in_HTTPHeaders_Alloc)
+    {
+        ///arrange
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        size_t nHeaders;
+        size_t i;
+        umock_c_reset_all_calls();
 
         ///act
-        result = HTTPHeaders_AddHeaderNameValuePair(httpHandle, "a", VALUE1);
+        for (i = 0; i < MAX_NAME_VALUE_PAIR; i++)
+        {
+            char name[32];
+            char value[32];
+            (void)sprintf(name, "name%u", (unsigned int)i);
+            (void)sprintf(value, "value%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, HTTPHeaders_AddHeaderNameValuePair(httpHandle, name, value));
+        }
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, result);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, MAX_NAME_VALUE_PAIR, nHeaders);
+        for (i = 0; i < MAX_NAME_VALUE_PAIR; i++)
+        {
+            char name[32];
+            char value[32];
+            const char* storedName;
+            const char* storedValue;
+            (void)sprintf(name, "NAME%u", (unsigned int)i);
+            (void)sprintf(value, "value%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(char_ptr, value, HTTPHeaders_FindHeaderValue(httpHandle, name));
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, HTTPHeaders_GetHeaderNameValue(httpHandle, i, &storedName, &storedValue));
+            ASSERT_ARE_EQUAL(char_ptr, value, storedValue);
+        }
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
@@ -638,6 +568,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///arrange
         const char* res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
         ///act
@@ -656,22 +587,16 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     TEST_FUNCTION(HTTPHeaders_FindHeaderValue_retrieves_previously_stored_value_succeeds)
     {
         ///arrange
-        const char* res1;
+        const char* res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1);
-
         ///act
-        res1 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1);
+        res = HTTPHeaders_FindHeaderValue(httpHandle, NAME1);
 
         ///assert
-        ASSERT_ARE_EQUAL(char_ptr, VALUE1, res1);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
@@ -686,23 +611,10 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         const char* res1;
         const char* res2;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME2))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME2))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE2);
-
         ///act
         res1 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1);
         res2 = HTTPHeaders_FindHeaderValue(httpHandle, NAME2);
@@ -720,27 +632,18 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     /*Tests_SRS_HTTP_HEADERS_99_021:[ In this case the return value shall point to a string that shall strcmp equal to the original stored string.]*/
     TEST_FUNCTION(HTTPHeaders_FindHeaderValue_retrieves_concatenation_of_previously_stored_values_for_header_name_succeeds)
     {
+        ///arrange
         const char* res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1); /*this key exists, was added above*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE2);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1 ", " VALUE2);
-
         ///act
         res = HTTPHeaders_FindHeaderValue(httpHandle, NAME1);
 
         ///assert
-        ASSERT_ARE_EQUAL(char_ptr,VALUE1 ", " VALUE2, res);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1 ", " VALUE2, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
@@ -748,98 +651,114 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     }
 
     /*Tests_SRS_HTTP_HEADERS_99_020:[ The return value shall be different than NULL when the name matches the name of a previously stored name:value pair.]*/
-    /*actually we are trying to see that finding a nonexisting value produces NULL*/
+    /*the trick names look like the serialized header, none of them is a stored name*/
     TEST_FUNCTION(HTTPHeaders_FindHeaderValue_returns_NULL_for_nonexistent_value)
     {
         ///arrange
-        const char* res2;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME2))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL);
-
         ///act
-        res2 = HTTPHeaders_FindHeaderValue(httpHandle, NAME2);
+        const char* res1 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1_TRICK1);
+        const char* res2 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1_TRICK2);
+        const char* res3 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1_TRICK3);
 
         ///assert
+        ASSERT_IS_NULL(res1);
         ASSERT_IS_NULL(res2);
+        ASSERT_IS_NULL(res3);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*trying to catch some errors here*/
     /*Tests_SRS_HTTP_HEADERS_99_020:[ The return value shall be different than NULL when the name matches the name of a previously stored name:value pair.]*/
     TEST_FUNCTION(HTTPHeaders_FindHeaderValue_with_nonexistent_header_succeeds)
     {
         ///arrange
-        const char* res1;
-        const char* res2;
-        const char* res3;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1_TRICK1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1_TRICK2))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1_TRICK3))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL);
+        ///act
+        const char* res = HTTPHeaders_FindHeaderValue(httpHandle, NAME2);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_040: [ Header names shall be compared without regard to case. ]*/
+    TEST_FUNCTION(HTTPHeaders_FindHeaderValue_ignores_the_case_of_the_name)
+    {
+        ///arrange
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "Content-Type", VALUE1);
+        umock_c_reset_all_calls();
 
         ///act
-        res1 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1_TRICK1);
-        res2 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1_TRICK2);
-        res3 = HTTPHeaders_FindHeaderValue(httpHandle, NAME1_TRICK3);
+        const char* res1 = HTTPHeaders_FindHeaderValue(httpHandle, "content-type");
+        const char* res2 = HTTPHeaders_FindHeaderValue(httpHandle, "CONTENT-TYPE");
 
         ///assert
-        ASSERT_IS_NULL(res1);
-        ASSERT_IS_NULL(res2);
-        ASSERT_IS_NULL(res3);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, res1);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, res2);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
+    /*Tests_SRS_HTTP_HEADERS_99_040: [ Header names shall be compared without regard to case. ]*/
+    /*Tests_SRS_HTTP_HEADERS_99_017:[ If the name already exists in the collection of headers, the function shall concatenate the new value after the existing value, separated by a comma and a space as in: old-value+", "+new-value.]*/
+    TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_same_Name_in_different_case_appends_and_keeps_the_first_name)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        char* headerValue;
+        size_t nHeaders;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "Accept", VALUE1);
+        umock_c_reset_all_calls();
+
+        ///act
+        res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, "ACCEPT", VALUE2);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 1, nHeaders);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, HTTPHeaders_GetHeader(httpHandle, 0, &headerValue));
+        ASSERT_ARE_EQUAL(char_ptr, "Accept: " VALUE1 ", " VALUE2, headerValue);
+
+        ///cleanup
+        free(headerValue);
+        HTTPHeaders_Free(httpHandle);
+    }
+
     /* Tests_SRS_HTTP_HEADERS_06_001: [This API will perform exactly as HTTPHeaders_AddHeaderNameValuePair except that if the header name already exists the already existing value will be replaced as opposed to concatenated to.] */
     TEST_FUNCTION(HTTPHeaders_ReplaceHeaderNameValuePair_succeeds)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
+        size_t nHeaders;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn(VALUE1); /*this key does not exist, the line below is adding it*/
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_PTR_ARG, NAME1, VALUE2))
-            .IgnoreArgument(1);
-
         ///act
         res = HTTPHeaders_ReplaceHeaderNameValuePair(httpHandle, NAME1, VALUE2);
 
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, VALUE2, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
+        (void)HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        ASSERT_ARE_EQUAL(size_t, 1, nHeaders);
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
@@ -853,118 +772,115 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL);
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_PTR_ARG, NAME1, VALUE2))
-            .IgnoreArgument(1);
-
         ///act
-        res = HTTPHeaders_ReplaceHeaderNameValuePair(httpHandle, NAME1, VALUE2);
+        res = HTTPHeaders_ReplaceHeaderNameValuePair(httpHandle, NAME1, VALUE1);
 
         ///assert
         ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*Tests_SRS_HTTP_HEADERS_99_024:[ The function shall return HTTP_HEADERS_INVALID_ARG when an invalid handle is passed.]*/
-    TEST_FUNCTION(HTTPHeaders_GetHeaderCount_with_NULL_handle_fails)
+    /*Tests_SRS_HTTP_HEADERS_99_039: [ If the new value fits in the storage of the existing value, it shall be stored in place without allocating. ]*/
+    TEST_FUNCTION(HTTPHeaders_ReplaceHeaderNameValuePair_with_shorter_value_reuses_the_storage)
     {
         ///arrange
-        HTTP_HEADERS_RESULT res1;
-        size_t nHeaders;
+        HTTP_HEADERS_RESULT res;
+        const char* before;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, getLongValue());
+        before = HTTPHeaders_FindHeaderValue(httpHandle, NAME1);
+        umock_c_reset_all_calls();
 
         ///act
-        res1 = HTTPHeaders_GetHeaderCount(NULL, &nHeaders);
+        res = HTTPHeaders_ReplaceHeaderNameValuePair(httpHandle, NAME1, VALUE1);
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res1);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(void_ptr, (void*)before, (void*)HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, before);
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
     }
 
-    /*Tests_SRS_HTTP_HEADERS_99_025:[ The function shall return HTTP_HEADERS_INVALID_ARG when headersCount is NULL.]*/
-    TEST_FUNCTION(HTTPHeaders_GetHeaderCount_with_NULL_headersCount_fails)
+    /*Tests_SRS_HTTP_HEADERS_99_039: [ If the new value fits in the storage of the existing value, it shall be stored in place without allocating. ]*/
+    TEST_FUNCTION(HTTPHeaders_ReplaceHeaderNameValuePair_with_a_part_of_the_existing_value_succeeds)
     {
         ///arrange
-        HTTP_HEADERS_RESULT res1;
+        HTTP_HEADERS_RESULT res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE2);
         umock_c_reset_all_calls();
 
         ///act
-        res1 = HTTPHeaders_GetHeaderCount(httpHandle, NULL);
+        res = HTTPHeaders_ReplaceHeaderNameValuePair(httpHandle, NAME1, HTTPHeaders_FindHeaderValue(httpHandle, NAME1) + strlen(VALUE1 ", "));
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res1);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE2, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*Tests_SRS_HTTP_HEADERS_99_026:[ The function shall write in *headersCount the number of currently stored headers and shall return HTTP_HEADERS_OK]*/
-    /*Tests_SRS_HTTP_HEADERS_99_023:[ Calling this API shall provide the number of stored headers.]*/
-    /*Tests_SRS_HTTP_HEADERS_99_016:[ The function shall store the name:value pair in such a way that when later retrieved by a call to GetHeader it will return a string that shall strcmp equal to the name+": "+value.]*/
-    TEST_FUNCTION(HTTPHeaders_GetHeaderCount_with_1_header_produces_1)
+    /*Tests_SRS_HTTP_HEADERS_99_024:[ The function shall return HTTP_HEADERS_INVALID_ARG when an invalid handle is passed.]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderCount_with_NULL_handle_fails)
     {
         ///arrange
-        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         size_t nHeaders;
-        const char* keys[] = { "NAME1" };
-        const char* values[] = { "VALUE1" };
-        const char* const ** pKeys = (const char* const **)&keys;
-        const char* const ** pValues = (const char* const **)&values;
-        const size_t one = 1;
-        HTTP_HEADERS_RESULT res;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
-        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
-        umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one));
+        ///act
+        HTTP_HEADERS_RESULT res = HTTPHeaders_GetHeaderCount(NULL, &nHeaders);
 
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_025:[ The function shall return HTTP_HEADERS_INVALID_ARG when headersCount is NULL.]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderCount_with_NULL_headersCount_fails)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        umock_c_reset_all_calls();
 
         ///act
-        res = HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
+        res = HTTPHeaders_GetHeaderCount(httpHandle, NULL);
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
-        ASSERT_ARE_EQUAL(size_t, (size_t)1, nHeaders);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*Tests_SRS_HTTP_HEADERS_99_037:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs.]*/
-    TEST_FUNCTION(HTTPHeaders_GetHeaderCount_fails_when_Map_GetInternals_fails)
+    /*Tests_SRS_HTTP_HEADERS_99_026:[ The function shall write in *headersCount the number of currently stored headers and shall return HTTP_HEADERS_OK]*/
+    /*Tests_SRS_HTTP_HEADERS_99_023:[ Calling this API shall provide the number of stored headers.]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderCount_with_1_header_produces_1)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
-        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         size_t nHeaders;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .IgnoreAllArguments()
-            .SetReturn(MAP_ERROR);
-
         ///act
         res = HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ERROR, res);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        ASSERT_ARE_EQUAL(size_t, 1, nHeaders);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-
         ///cleanup
         HTTPHeaders_Free(httpHandle);
     }
@@ -975,31 +891,12 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     {
         ///arrange
         HTTP_HEADERS_RESULT res;
-        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         size_t nHeaders;
-        const char* keys[2] = { "NAME1", "NAME2" };
-        const char* values[2] = { "VALUE1", "VALUE2" };
-        const char* const ** pKeys = (const char* const **)&keys;
-        const char* const ** pValues = (const char* const **)&values;
-
-        const size_t two = 2;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME2))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
         umock_c_reset_all_calls();
 
-
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &two, sizeof(two));
-
         ///act
         res = HTTPHeaders_GetHeaderCount(httpHandle, &nHeaders);
 
@@ -1032,9 +929,6 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///arrange
         HTTP_HEADERS_RESULT res;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
@@ -1054,24 +948,16 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     TEST_FUNCTION(HTTPHeaders_GetHeader_with_index_too_big_fails_1)
     {
         ///arrange
-        HTTP_HEADERS_RESULT res1;
-        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        HTTP_HEADERS_RESULT res;
         char* headerValue;
-        const char* thisIsNULL = NULL;
-        const char* zero = 0;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &thisIsNULL, sizeof(thisIsNULL))
-            .CopyOutArgumentBuffer(3, &thisIsNULL, sizeof(thisIsNULL))
-            .CopyOutArgumentBuffer(4, &zero, sizeof(zero));
-
         ///act
-        res1 = HTTPHeaders_GetHeader(httpHandle, 0, &headerValue);
+        res = HTTPHeaders_GetHeader(httpHandle, 0, &headerValue);
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res1);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
@@ -1083,31 +969,17 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     TEST_FUNCTION(HTTPHeaders_GetHeader_with_index_too_big_fails_2)
     {
         ///arrange
-        HTTP_HEADERS_RESULT res1;
-        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        const char* keys[1] = { "NAME1" };
-        const char* values[1] = { "VALUE1" };
-        const char* const ** pKeys = (const char* const **)&keys;
-        const char* const ** pValues = (const char* const **)&values;
-        const size_t one = 1;
+        HTTP_HEADERS_RESULT res;
         char* headerValue;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one));
-
         ///act
-        res1 = HTTPHeaders_GetHeader(httpHandle, 1, &headerValue);
+        res = HTTPHeaders_GetHeader(httpHandle, 1, &headerValue);
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res1);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
@@ -1122,23 +994,9 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_RESULT res1;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         char* headerValue;
-        const char* keys[1] = { "a" };
-        const char** pKeys = &keys[0];
-        const char* values[1] = { "b" };
-        const char** pValues = &values[0];
-        const size_t one = 1;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, "a"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "a", "b");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one));
-
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
 
@@ -1156,29 +1014,18 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     }
 
     /*Tests_SRS_HTTP_HEADERS_99_034:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs]*/
-    TEST_FUNCTION(HTTPHeaders_GetHeader_fails_when_Map_GetInternals_fails)
+    TEST_FUNCTION(HTTPHeaders_GetHeader_succeeds_fails_when_malloc_fails)
     {
         ///arrange
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         char* headerValue;
-        const char* keys[1] = { "a" };
-        const char** pKeys = &keys[0];
-        const char* values[1] = { "b" };
-        const char** pValues = &values[0];
-        const size_t one = 1;
         HTTP_HEADERS_RESULT res1;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, "a"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "a", "b");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one))
-            .SetReturn(MAP_ERROR);
+        whenShallmalloc_fail = currentmalloc_call + 1;
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
 
         ///act
         res1 = HTTPHeaders_GetHeader(httpHandle, 0, &headerValue);
@@ -1191,44 +1038,242 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTPHeaders_Free(httpHandle);
     }
 
-    /*Tests_SRS_HTTP_HEADERS_99_034:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs]*/
-    TEST_FUNCTION(HTTPHeaders_GetHeader_succeeds_fails_when_malloc_fails)
+    /*Tests_SRS_HTTP_HEADERS_99_041: [ If handle, name or value is NULL then HTTPHeaders_GetHeaderNameValue shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderNameValue_with_NULL_handle_fails)
     {
         ///arrange
+        const char* name;
+        const char* value;
+
+        ///act
+        HTTP_HEADERS_RESULT res = HTTPHeaders_GetHeaderNameValue(NULL, 0, &name, &value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_041: [ If handle, name or value is NULL then HTTPHeaders_GetHeaderNameValue shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderNameValue_with_NULL_name_fails)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        const char* value;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
-        char* headerValue;
-        const char* keys[1] = { "a" };
-        const char** pKeys = &keys[0];
-        const char* values[1] = { "b" };
-        const char** pValues = &values[0];
-        const size_t one = 1;
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        umock_c_reset_all_calls();
+
+        ///act
+        res = HTTPHeaders_GetHeaderNameValue(httpHandle, 0, NULL, &value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_041: [ If handle, name or value is NULL then HTTPHeaders_GetHeaderNameValue shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderNameValue_with_NULL_value_fails)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        const char* name;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        umock_c_reset_all_calls();
+
+        ///act
+        res = HTTPHeaders_GetHeaderNameValue(httpHandle, 0, &name, NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_042: [ If index is not smaller than the number of stored headers then HTTPHeaders_GetHeaderNameValue shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderNameValue_with_index_too_big_fails)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        const char* name;
+        const char* value;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        umock_c_reset_all_calls();
+
+        ///act
+        res = HTTPHeaders_GetHeaderNameValue(httpHandle, 1, &name, &value);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_043: [ Otherwise HTTPHeaders_GetHeaderNameValue shall set *name and *value to the stored strings of the header at index, without allocating, and return HTTP_HEADERS_OK. ]*/
+    TEST_FUNCTION(HTTPHeaders_GetHeaderNameValue_succeeds)
+    {
+        ///arrange
         HTTP_HEADERS_RESULT res1;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, "a"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
-        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "a", "b");
+        HTTP_HEADERS_RESULT res2;
+        const char* name1;
+        const char* value1;
+        const char* name2;
+        const char* value2;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one));
+        ///act
+        res1 = HTTPHeaders_GetHeaderNameValue(httpHandle, 0, &name1, &value1);
+        res2 = HTTPHeaders_GetHeaderNameValue(httpHandle, 1, &name2, &value2);
 
-        whenShallmalloc_fail = currentmalloc_call + 1;
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
-            .IgnoreArgument(1);
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res1);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res2);
+        ASSERT_ARE_EQUAL(char_ptr, NAME1, name1);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, value1);
+        ASSERT_ARE_EQUAL(char_ptr, NAME2, name2);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE2, value2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_044: [ If handle or serializedSize is NULL then HTTPHeaders_Serialize shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    TEST_FUNCTION(HTTPHeaders_Serialize_with_NULL_handle_fails)
+    {
+        ///arrange
+        size_t serializedSize;
 
         ///act
-        res1 = HTTPHeaders_GetHeader(httpHandle, 0, &headerValue);
+        HTTP_HEADERS_RESULT res = HTTPHeaders_Serialize(NULL, tempBuffer, TEMP_BUFFER_SIZE, &serializedSize);
 
         ///assert
-        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ERROR, res1);
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_044: [ If handle or serializedSize is NULL then HTTPHeaders_Serialize shall return HTTP_HEADERS_INVALID_ARG. ]*/
+    TEST_FUNCTION(HTTPHeaders_Serialize_with_NULL_serializedSize_fails)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        umock_c_reset_all_calls();
+
+        ///act
+        res = HTTPHeaders_Serialize(httpHandle, tempBuffer, TEMP_BUFFER_SIZE, NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_045: [ HTTPHeaders_Serialize shall set *serializedSize to the number of bytes needed to write every header as name+": "+value+"\r\n", in insertion order, without a terminating '\0'. ]*/
+    /*Tests_SRS_HTTP_HEADERS_99_046: [ If destination is NULL then HTTPHeaders_Serialize shall only compute *serializedSize and return HTTP_HEADERS_OK. ]*/
+    TEST_FUNCTION(HTTPHeaders_Serialize_with_NULL_destination_computes_the_size)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        size_t serializedSize;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
+        umock_c_reset_all_calls();
+
+        ///act
+        res = HTTPHeaders_Serialize(httpHandle, NULL, 0, &serializedSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        ASSERT_ARE_EQUAL(size_t, strlen(HEADER1 "\r\n" HEADER2 "\r\n"), serializedSize);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_047: [ If destinationSize is smaller than *serializedSize then HTTPHeaders_Serialize shall not write to destination and shall return HTTP_HEADERS_INSUFFICIENT_BUFFER. ]*/
+    TEST_FUNCTION(HTTPHeaders_Serialize_with_small_buffer_fails)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        size_t serializedSize;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        umock_c_reset_all_calls();
+        tempBuffer[0] = '\0';
+
+        ///act
+        res = HTTPHeaders_Serialize(httpHandle, tempBuffer, strlen(HEADER1 "\r\n") - 1, &serializedSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INSUFFICIENT_BUFFER, res);
+        ASSERT_ARE_EQUAL(size_t, strlen(HEADER1 "\r\n"), serializedSize);
+        ASSERT_ARE_EQUAL(char, '\0', tempBuffer[0]);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_048: [ Otherwise HTTPHeaders_Serialize shall write the headers to destination and return HTTP_HEADERS_OK. ]*/
+    TEST_FUNCTION(HTTPHeaders_Serialize_succeeds)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        size_t serializedSize;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME2, VALUE2);
+        umock_c_reset_all_calls();
+
+        ///act
+        res = HTTPHeaders_Serialize(httpHandle, tempBuffer, TEMP_BUFFER_SIZE, &serializedSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        ASSERT_ARE_EQUAL(size_t, strlen(HEADER1 "\r\n" HEADER2 "\r\n"), serializedSize);
+        tempBuffer[serializedSize] = '\0';
+        ASSERT_ARE_EQUAL(char_ptr, HEADER1 "\r\n" HEADER2 "\r\n", tempBuffer);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        HTTPHeaders_Free(httpHandle);
+    }
+
+    /*Tests_SRS_HTTP_HEADERS_99_048: [ Otherwise HTTPHeaders_Serialize shall write the headers to destination and return HTTP_HEADERS_OK. ]*/
+    TEST_FUNCTION(HTTPHeaders_Serialize_with_no_headers_succeeds)
+    {
+        ///arrange
+        HTTP_HEADERS_RESULT res;
+        size_t serializedSize;
+        HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
+        umock_c_reset_all_calls();
+
+        ///act
+        res = HTTPHeaders_Serialize(httpHandle, tempBuffer, TEMP_BUFFER_SIZE, &serializedSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+        ASSERT_ARE_EQUAL(size_t, 0, serializedSize);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
-        free(headerValue);
     }
 
     /*Tests_SRS_HTTP_HEADERS_99_031:[ If name contains the character ":" then the return value shall be HTTP_HEADERS_INVALID_ARG.]*/
@@ -1254,26 +1299,12 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     TEST_FUNCTION(HTTPHeaders_AddHeaderNameValuePair_with_colon_in_value_succeeds_1)
     {
         ///arrange
-        const char* keys[1] = { "a" };
-        const char** pKeys = &keys[0];
-        const char* values[1] = { ":" };
-        const char** pValues = &values[0];
-        const size_t one = 1;
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         char* headerValue;
         HTTP_HEADERS_RESULT res1;
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, "a"))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist, the line below is adding it*/
         (void)HTTPHeaders_AddHeaderNameValuePair(httpHandle, "a", ":");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .IgnoreArgument(1)
-            .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
-            .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
-            .CopyOutArgumentBuffer(4, &one, sizeof(one));
-
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
 
@@ -1330,13 +1361,6 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         HTTP_HEADERS_HANDLE httpHandle = HTTPHeaders_Alloc();
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG, NAME1))
-            .IgnoreArgument(1)
-            .SetReturn((const char*)NULL); /*this key does not exist*/
-
-        STRICT_EXPECTED_CALL(Map_AddOrUpdate(IGNORED_PTR_ARG, NAME1, VALUE1))
-            .IgnoreArgument(1);
-
         ///act
         res = HTTPHeaders_AddHeaderNameValuePair(httpHandle, NAME1, " \r\t\n" VALUE1); /*notice how there are some LWS characters in the value*/
 
@@ -1345,6 +1369,7 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         //checking content
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, HTTPHeaders_FindHeaderValue(httpHandle, NAME1));
 
         ///cleanup
         HTTPHeaders_Free(httpHandle);
@@ -1364,17 +1389,18 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
     }
 
     /*Tests_SRS_HTTP_HEADERS_02_004: [Otherwise HTTPHeaders_Clone shall clone the content of handle to a new handle.*/
+    /*Tests_SRS_HTTP_HEADERS_99_049: [ HTTPHeaders_Clone shall allocate the clone, its headers and their strings in a single allocation. ]*/
     TEST_FUNCTION(HTTPHEADERS_Clone_happy_path)
     {
         ///arrange
         HTTP_HEADERS_HANDLE result;
         HTTP_HEADERS_HANDLE source = HTTPHeaders_Alloc();
+        (void)HTTPHeaders_AddHeaderNameValuePair(source, NAME1, VALUE1);
+        (void)HTTPHeaders_AddHeaderNameValuePair(source, NAME2, VALUE2);
         umock_c_reset_all_calls();
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(Map_Clone(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
 
         ///act
         result = HTTPHeaders_Clone(source);
@@ -1382,34 +1408,44 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
         ///assert
         ASSERT_IS_NOT_NULL(result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, HTTPHeaders_FindHeaderValue(result, NAME1));
+        ASSERT_ARE_EQUAL(char_ptr, VALUE2, HTTPHeaders_FindHeaderValue(result, NAME2));
 
         ///cleanup
         HTTPHeaders_Free(source);
         HTTPHeaders_Free(result);
     }
 
-    /*Tests_SRS_HTTP_HEADERS_02_005: [If cloning fails for any reason, then HTTPHeaders_Clone shall return NULL.] */
-    TEST_FUNCTION(HTTPHEADERS_Clone_fails_when_map_clone_fails)
+    /*Tests_SRS_HTTP_HEADERS_99_049: [ HTTPHeaders_Clone shall allocate the clone, its headers and their strings in a single allocation. ]*/
+    TEST_FUNCTION(HTTPHEADERS_Clone_of_many_headers_makes_a_single_allocation)
     {
         ///arrange
         HTTP_HEADERS_HANDLE result;
+        size_t sourceSize;
+        size_t resultSize;
+        size_t i;
         HTTP_HEADERS_HANDLE source = HTTPHeaders_Alloc();
+        for (i = 0; i < MAX_NAME_VALUE_PAIR; i++)
+        {
+            char name[32];
+            (void)sprintf(name, "name%u", (unsigned int)i);
+            (void)HTTPHeaders_AddHeaderNameValuePair(source, name, VALUE1);
+        }
+        (void)HTTPHeaders_Serialize(source, NULL, 0, &sourceSize);
         umock_c_reset_all_calls();
 
         STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(Map_Clone(IGNORED_PTR_ARG))
-            .IgnoreArgument(1).SetReturn(NULL);
-
-        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
 
         ///act
         result = HTTPHeaders_Clone(source);
 
         ///assert
-        ASSERT_IS_NULL(result);
+        ASSERT_IS_NOT_NULL(result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        (void)HTTPHeaders_Serialize(result, NULL, 0, &resultSize);
+        ASSERT_ARE_EQUAL(size_t, sourceSize, resultSize);
+        ASSERT_ARE_EQUAL(char_ptr, VALUE1, HTTPHeaders_FindHeaderValue(result, "NAME99"));
 
         ///cleanup
         HTTPHeaders_Free(source);
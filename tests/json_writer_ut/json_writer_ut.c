@@ -0,0 +1,795 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+
+static void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void* my_gballoc_realloc(void* ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+static void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/gballoc.h"
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/json_writer.h"
+#include "azure_c_shared_utility/strings.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(json_writer_unittests)
+
+TEST_SUITE_INITIALIZE(TestSuiteInitialize)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    umock_c_init(on_umock_c_error);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(f)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(cleans)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* json_writer_create */
+
+/*Tests_SRS_JSON_WRITER_01_001: [ json_writer_create shall allocate a writer and a buffer of initialCapacity bytes, or of a small default size if initialCapacity is 0. ]*/
+/*Tests_SRS_JSON_WRITER_01_025: [ json_writer_get_string shall return the \0 terminated text written so far. ]*/
+TEST_FUNCTION(json_writer_create_succeeds)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(100));
+
+    //act
+    writer = json_writer_create(100);
+
+    //assert
+    ASSERT_IS_NOT_NULL(writer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "", json_writer_get_string(writer));
+    ASSERT_ARE_EQUAL(size_t, 0, json_writer_get_length(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_002: [ If any allocation fails, json_writer_create shall fail and return NULL. ]*/
+TEST_FUNCTION(json_writer_create_fails_when_allocating_the_writer_fails)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    writer = json_writer_create(0);
+
+    //assert
+    ASSERT_IS_NULL(writer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_JSON_WRITER_01_002: [ If any allocation fails, json_writer_create shall fail and return NULL. ]*/
+TEST_FUNCTION(json_writer_create_fails_when_allocating_the_buffer_fails)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    //act
+    writer = json_writer_create(0);
+
+    //assert
+    ASSERT_IS_NULL(writer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* json_writer_destroy */
+
+/*Tests_SRS_JSON_WRITER_01_003: [ If writer is NULL, json_writer_destroy shall return. ]*/
+TEST_FUNCTION(json_writer_destroy_with_NULL_writer_returns)
+{
+    //act
+    json_writer_destroy(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_JSON_WRITER_01_004: [ json_writer_destroy shall free the buffer and the writer. ]*/
+TEST_FUNCTION(json_writer_destroy_frees_the_buffer_and_the_writer)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    //act
+    json_writer_destroy(writer);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* json_writer_reset */
+
+/*Tests_SRS_JSON_WRITER_01_006: [ json_writer_reset shall empty the text and close every container, keeping the buffer. ]*/
+TEST_FUNCTION(json_writer_reset_allows_a_new_document)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_begin_object(writer);
+    (void)json_writer_write_key(writer, "a");
+    umock_c_reset_all_calls();
+
+    //act
+    json_writer_reset(writer);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "", json_writer_get_string(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_begin_array(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_end_array(writer));
+    ASSERT_ARE_EQUAL(char_ptr, "[]", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/* json_writer_begin_object, json_writer_end_object, json_writer_begin_array, json_writer_end_array */
+
+/*Tests_SRS_JSON_WRITER_01_007: [ If writer is NULL, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(json_writer_functions_with_NULL_writer_fail)
+{
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_begin_object(NULL));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_end_object(NULL));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_begin_array(NULL));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_end_array(NULL));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_key(NULL, "a"));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_string(NULL, "a"));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_int64(NULL, 1));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_double(NULL, 1.0));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_bool(NULL, true));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_null(NULL));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_raw(NULL, "1"));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_JSON_WRITER_01_008: [ If the string argument of json_writer_write_key, json_writer_write_string or json_writer_write_raw is NULL, the function shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(json_writer_functions_with_NULL_string_fail)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_begin_object(writer);
+    umock_c_reset_all_calls();
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_key(writer, NULL));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_key(writer, "a"));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_string(writer, NULL));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_raw(writer, NULL));
+    ASSERT_ARE_EQUAL(char_ptr, "{\"a\":", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_012: [ json_writer_begin_object and json_writer_begin_array shall write { or [ and return 0. ]*/
+/*Tests_SRS_JSON_WRITER_01_015: [ json_writer_end_object and json_writer_end_array shall write } or ] and return 0. ]*/
+/*Tests_SRS_JSON_WRITER_01_010: [ A value that is not the first element of an array shall be preceded by a comma. ]*/
+TEST_FUNCTION(json_writer_writes_nested_containers)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    umock_c_reset_all_calls();
+
+    //act
+    ASSERT_ARE_EQUAL(int, 0, json_writer_begin_array(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_begin_object(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_end_object(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_begin_array(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_end_array(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_begin_object(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_key(writer, "k"));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_begin_array(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_end_array(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_end_object(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_end_array(writer));
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, "[{},[],{\"k\":[]}]", json_writer_get_string(writer));
+    ASSERT_ARE_EQUAL(size_t, strlen("[{},[],{\"k\":[]}]"), json_writer_get_length(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_009: [ If a value cannot be written at this point of the document, because the writer is in an object and no key was written for it, or the document already holds a complete value, the json_writer_begin_* and json_writer_write_* value functions shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(json_writer_value_without_key_in_object_fails)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_begin_object(writer);
+    umock_c_reset_all_calls();
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_string(writer, "a"));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_int64(writer, 1));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_begin_object(writer));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_begin_array(writer));
+    ASSERT_ARE_EQUAL(char_ptr, "{", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_009: [ If a value cannot be written at this point of the document, because the writer is in an object and no key was written for it, or the document already holds a complete value, the json_writer_begin_* and json_writer_write_* value functions shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(json_writer_second_root_value_fails)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_write_null(writer);
+    umock_c_reset_all_calls();
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_null(writer));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_begin_array(writer));
+    ASSERT_ARE_EQUAL(char_ptr, "null", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_011: [ If JSON_WRITER_MAX_DEPTH objects and arrays are already open, json_writer_begin_object and json_writer_begin_array shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(json_writer_begin_array_deeper_than_max_depth_fails)
+{
+    //arrange
+    size_t i;
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    for (i = 0; i < JSON_WRITER_MAX_DEPTH; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, json_writer_begin_array(writer));
+    }
+    umock_c_reset_all_calls();
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_begin_array(writer));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_begin_object(writer));
+    ASSERT_ARE_EQUAL(size_t, JSON_WRITER_MAX_DEPTH, json_writer_get_length(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_014: [ If the innermost open container is not an object (for json_writer_end_object) or not an array (for json_writer_end_array), or a key was written without its value, the function shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(json_writer_end_mismatched_container_fails)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    umock_c_reset_all_calls();
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_end_array(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_begin_array(writer));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_end_object(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_begin_object(writer));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_end_array(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_key(writer, "a"));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_end_object(writer));
+    ASSERT_ARE_EQUAL(char_ptr, "[{\"a\":", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/* json_writer_write_key */
+
+/*Tests_SRS_JSON_WRITER_01_017: [ json_writer_write_key shall write a comma if the object already has a member, then the key quoted and escaped like json_writer_write_string does, then a colon, and return 0. ]*/
+TEST_FUNCTION(json_writer_write_key_separates_members)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_begin_object(writer);
+    umock_c_reset_all_calls();
+
+    //act
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_key(writer, "a"));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_int64(writer, 1));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_key(writer, "b\"c"));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_bool(writer, false));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_end_object(writer));
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, "{\"a\":1,\"b\\\"c\":false}", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_016: [ If the innermost open container is not an object, or the previous key has no value yet, json_writer_write_key shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(json_writer_write_key_outside_object_fails)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    umock_c_reset_all_calls();
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_key(writer, "a"));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_begin_array(writer));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_key(writer, "a"));
+    ASSERT_ARE_EQUAL(char_ptr, "[", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_016: [ If the innermost open container is not an object, or the previous key has no value yet, json_writer_write_key shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(json_writer_write_key_twice_fails)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_begin_object(writer);
+    (void)json_writer_write_key(writer, "a");
+    umock_c_reset_all_calls();
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_key(writer, "b"));
+    ASSERT_ARE_EQUAL(char_ptr, "{\"a\":", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/* json_writer_write_string */
+
+/*Tests_SRS_JSON_WRITER_01_018: [ json_writer_write_string shall write value between quotes, with " \ and / preceded by a backslash, characters below 0x20 written as \u00XX with XX their upper case hex code, and every other byte copied as it is, and return 0. ]*/
+TEST_FUNCTION(json_writer_write_string_escapes_special_characters)
+{
+    //arrange
+    int result;
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    umock_c_reset_all_calls();
+
+    //act
+    result = json_writer_write_string(writer, "a\"b\\c/d\x01\x1F\n");
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, "\"a\\\"b\\\\c\\/d\\u0001\\u001F\\u000A\"", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_018: [ json_writer_write_string shall write value between quotes, with " \ and / preceded by a backslash, characters below 0x20 written as \u00XX with XX their upper case hex code, and every other byte copied as it is, and return 0. ]*/
+TEST_FUNCTION(json_writer_write_string_copies_UTF8_as_it_is)
+{
+    //arrange
+    int result;
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    umock_c_reset_all_calls();
+
+    //act
+    result = json_writer_write_string(writer, "caf\xC3\xA9 \xE2\x82\xAC");
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, "\"caf\xC3\xA9 \xE2\x82\xAC\"", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_018: [ json_writer_write_string shall write value between quotes, with " \ and / preceded by a backslash, characters below 0x20 written as \u00XX with XX their upper case hex code, and every other byte copied as it is, and return 0. ]*/
+TEST_FUNCTION(json_writer_write_string_matches_STRING_new_JSON_at_every_position)
+{
+    //arrange
+    static const char specials[] = { '"', '\\', '/', '\x01', '\x1F', '\t' };
+    char input[41];
+    size_t position;
+    size_t special;
+
+    for (position = 0; position < sizeof(input) - 1; position++)
+    {
+        for (special = 0; special < sizeof(specials); special++)
+        {
+            JSON_WRITER_HANDLE writer = json_writer_create(0);
+            STRING_HANDLE expected;
+
+            (void)memset(input, 'x', sizeof(input) - 1);
+            input[sizeof(input) - 1] = '\0';
+            input[position] = specials[special];
+            expected = STRING_new_JSON(input);
+
+            //act
+            ASSERT_ARE_EQUAL(int, 0, json_writer_write_string(writer, input));
+
+            //assert
+            ASSERT_ARE_EQUAL(char_ptr, STRING_c_str(expected), json_writer_get_string(writer));
+
+            //cleanup
+            STRING_delete(expected);
+            json_writer_destroy(writer);
+        }
+    }
+}
+
+/*Tests_SRS_JSON_WRITER_01_010: [ A value that is not the first element of an array shall be preceded by a comma. ]*/
+TEST_FUNCTION(json_writer_write_values_in_array_are_separated)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_begin_array(writer);
+    umock_c_reset_all_calls();
+
+    //act
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_string(writer, "a"));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_string(writer, ""));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_raw(writer, "{\"x\":1}"));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_end_array(writer));
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, "[\"a\",\"\",{\"x\":1}]", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/* json_writer_write_int64 */
+
+/*Tests_SRS_JSON_WRITER_01_019: [ json_writer_write_int64 shall write value in decimal and return 0. ]*/
+TEST_FUNCTION(json_writer_write_int64_writes_the_limits)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_begin_array(writer);
+    umock_c_reset_all_calls();
+
+    //act
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_int64(writer, 0));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_int64(writer, -42));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_int64(writer, INT64_MAX));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_int64(writer, INT64_MIN));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_end_array(writer));
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, "[0,-42,9223372036854775807,-9223372036854775808]", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/* json_writer_write_double */
+
+/*Tests_SRS_JSON_WRITER_01_021: [ json_writer_write_double shall write the shortest of the 15 and 17 significant digit representations of value that reads back as value, and return 0. ]*/
+TEST_FUNCTION(json_writer_write_double_writes_numbers_that_read_back)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_begin_array(writer);
+    umock_c_reset_all_calls();
+
+    //act
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_double(writer, 0.5));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_double(writer, 0.1));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_double(writer, 0.1 + 0.2));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_end_array(writer));
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, "[0.5,0.1,0.30000000000000004]", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_020: [ If value is NaN or infinite, json_writer_write_double shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(json_writer_write_double_with_non_finite_values_fails)
+{
+    //arrange
+    volatile double zero = 0.0;
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_begin_array(writer);
+    umock_c_reset_all_calls();
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_double(writer, 1.0 / zero));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_double(writer, -1.0 / zero));
+    ASSERT_ARE_NOT_EQUAL(int, 0, json_writer_write_double(writer, zero / zero));
+    ASSERT_ARE_EQUAL(char_ptr, "[", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/* json_writer_write_bool, json_writer_write_null, json_writer_write_raw */
+
+/*Tests_SRS_JSON_WRITER_01_022: [ json_writer_write_bool shall write true or false, json_writer_write_null shall write null, and both shall return 0. ]*/
+/*Tests_SRS_JSON_WRITER_01_023: [ json_writer_write_raw shall write json as it is, as one value, and return 0. ]*/
+TEST_FUNCTION(json_writer_write_literals_succeeds)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_begin_object(writer);
+    umock_c_reset_all_calls();
+
+    //act
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_key(writer, "t"));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_bool(writer, true));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_key(writer, "f"));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_bool(writer, false));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_key(writer, "n"));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_null(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_key(writer, "r"));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_raw(writer, "[1,2]"));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_end_object(writer));
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, "{\"t\":true,\"f\":false,\"n\":null,\"r\":[1,2]}", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/* buffer growth */
+
+/*Tests_SRS_JSON_WRITER_01_026: [ If the buffer cannot grow, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail, return a non-zero value and leave the text as it was. ]*/
+/*Tests_SRS_JSON_WRITER_01_013: [ When the buffer is too small for a write, it shall be grown by calling realloc to at least twice its size. ]*/
+TEST_FUNCTION(json_writer_write_string_fails_when_the_buffer_cannot_grow)
+{
+    //arrange
+    int result;
+    JSON_WRITER_HANDLE writer = json_writer_create(4);
+    (void)json_writer_begin_array(writer);
+    (void)json_writer_write_int64(writer, 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    result = json_writer_write_string(writer, "a string longer than the buffer");
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "[1", json_writer_get_string(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_string(writer, "a string longer than the buffer"));
+    ASSERT_ARE_EQUAL(char_ptr, "[1,\"a string longer than the buffer\"", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_026: [ If the buffer cannot grow, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail, return a non-zero value and leave the text as it was. ]*/
+TEST_FUNCTION(json_writer_write_key_fails_when_the_buffer_cannot_grow)
+{
+    //arrange
+    int result;
+    JSON_WRITER_HANDLE writer = json_writer_create(8);
+    (void)json_writer_begin_object(writer);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    result = json_writer_write_key(writer, "a_key_longer_than_the_buffer");
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "{", json_writer_get_string(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_key(writer, "a_key_longer_than_the_buffer"));
+    ASSERT_ARE_EQUAL(char_ptr, "{\"a_key_longer_than_the_buffer\":", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_026: [ If the buffer cannot grow, the json_writer_begin_*, json_writer_end_* and json_writer_write_* functions shall fail, return a non-zero value and leave the text as it was. ]*/
+TEST_FUNCTION(json_writer_write_string_with_escapes_fails_when_the_buffer_cannot_grow_half_way)
+{
+    //arrange
+    int result;
+    JSON_WRITER_HANDLE writer = json_writer_create(32);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    result = json_writer_write_string(writer, "\x01\x01\x01\x01\x01\x01\x01\x01");
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "", json_writer_get_string(writer));
+    ASSERT_ARE_EQUAL(size_t, 0, json_writer_get_length(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/* json_writer_get_string, json_writer_get_length */
+
+/*Tests_SRS_JSON_WRITER_01_024: [ If writer is NULL, json_writer_get_string shall return NULL. ]*/
+/*Tests_SRS_JSON_WRITER_01_027: [ If writer is NULL, json_writer_get_length shall return 0. ]*/
+TEST_FUNCTION(json_writer_getters_with_NULL_writer)
+{
+    //assert
+    ASSERT_IS_NULL(json_writer_get_string(NULL));
+    ASSERT_ARE_EQUAL(size_t, 0, json_writer_get_length(NULL));
+}
+
+/*Tests_SRS_JSON_WRITER_01_028: [ json_writer_get_length shall return the number of characters written so far. ]*/
+TEST_FUNCTION(json_writer_get_length_follows_growth)
+{
+    //arrange
+    size_t i;
+    JSON_WRITER_HANDLE writer = json_writer_create(1);
+    (void)json_writer_begin_array(writer);
+    umock_c_reset_all_calls();
+
+    //act
+    for (i = 0; i < 1000; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, json_writer_write_int64(writer, 7));
+    }
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 1 + 1000 * 2 - 1, json_writer_get_length(writer));
+    ASSERT_ARE_EQUAL(size_t, json_writer_get_length(writer), strlen(json_writer_get_string(writer)));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/* json_writer_detach_STRING */
+
+/*Tests_SRS_JSON_WRITER_01_030: [ json_writer_detach_STRING shall create the STRING by calling STRING_new_with_memory with the buffer, without copying the text. ]*/
+/*Tests_SRS_JSON_WRITER_01_032: [ On success the writer shall be reset and shall allocate a new buffer on its next write. ]*/
+TEST_FUNCTION(json_writer_detach_STRING_hands_over_the_buffer)
+{
+    //arrange
+    STRING_HANDLE result;
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    const char* text;
+    (void)json_writer_begin_object(writer);
+    (void)json_writer_write_key(writer, "a");
+    (void)json_writer_write_string(writer, "b");
+    (void)json_writer_end_object(writer);
+    text = json_writer_get_string(writer);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*the STRING, the text is not copied*/
+
+    //act
+    result = json_writer_detach_STRING(writer);
+
+    //assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, (void*)text, (void*)STRING_c_str(result));
+    ASSERT_ARE_EQUAL(char_ptr, "{\"a\":\"b\"}", STRING_c_str(result));
+    ASSERT_ARE_EQUAL(char_ptr, "", json_writer_get_string(writer));
+    ASSERT_ARE_EQUAL(int, 0, json_writer_write_string(writer, "next"));
+    ASSERT_ARE_EQUAL(char_ptr, "\"next\"", json_writer_get_string(writer));
+
+    //cleanup
+    STRING_delete(result);
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_029: [ If writer is NULL, or no value was written, or an object or array is still open, json_writer_detach_STRING shall fail and return NULL. ]*/
+TEST_FUNCTION(json_writer_detach_STRING_with_incomplete_document_fails)
+{
+    //arrange
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    umock_c_reset_all_calls();
+
+    //assert
+    ASSERT_IS_NULL(json_writer_detach_STRING(NULL));
+    ASSERT_IS_NULL(json_writer_detach_STRING(writer));
+    (void)json_writer_begin_array(writer);
+    ASSERT_IS_NULL(json_writer_detach_STRING(writer));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "[", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+/*Tests_SRS_JSON_WRITER_01_031: [ If STRING_new_with_memory fails, json_writer_detach_STRING shall fail, return NULL and keep the text. ]*/
+TEST_FUNCTION(json_writer_detach_STRING_fails_when_STRING_new_with_memory_fails)
+{
+    //arrange
+    STRING_HANDLE result;
+    JSON_WRITER_HANDLE writer = json_writer_create(0);
+    (void)json_writer_write_int64(writer, 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    result = json_writer_detach_STRING(writer);
+
+    //assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "1", json_writer_get_string(writer));
+
+    //cleanup
+    json_writer_destroy(writer);
+}
+
+END_TEST_SUITE(json_writer_unittests)
@@ -11,11 +11,152 @@
 #include "testrunnerswitcher.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
 
 TEST_DEFINE_ENUM_TYPE(LOCK_RESULT, LOCK_RESULT_VALUES);
 
 static TEST_MUTEX_HANDLE g_dllByDll;
 
+#define TEST_THREAD_COUNT       4
+#define TEST_INCREMENTS         100000
+
+typedef LOCK_RESULT(*TEST_ACQUIRE_FUNCTION)(void* handle);
+
+typedef struct TEST_ACQUIRE_CONTEXT_TAG
+{
+    TEST_ACQUIRE_FUNCTION acquire;
+    void* handle;
+    LOCK_RESULT result;
+} TEST_ACQUIRE_CONTEXT;
+
+typedef struct TEST_COUNTER_CONTEXT_TAG
+{
+    ADAPTIVE_LOCK_HANDLE adaptive_lock;
+    RWLOCK_HANDLE rw_lock;
+    /*both are only changed together under the lock*/
+    size_t first;
+    size_t second;
+    size_t torn_reads;
+} TEST_COUNTER_CONTEXT;
+
+static LOCK_RESULT try_lock(void* handle)
+{
+    return Lock_Try((LOCK_HANDLE)handle);
+}
+
+static LOCK_RESULT timed_lock_10ms(void* handle)
+{
+    return Lock_Timed((LOCK_HANDLE)handle, 10);
+}
+
+static LOCK_RESULT adaptive_try_lock(void* handle)
+{
+    return AdaptiveLock_Try((ADAPTIVE_LOCK_HANDLE)handle);
+}
+
+static LOCK_RESULT adaptive_timed_lock_10ms(void* handle)
+{
+    return AdaptiveLock_Timed((ADAPTIVE_LOCK_HANDLE)handle, 10);
+}
+
+static LOCK_RESULT rwlock_try_read_lock(void* handle)
+{
+    return RWLock_TryReadLock((RWLOCK_HANDLE)handle);
+}
+
+static LOCK_RESULT rwlock_try_write_lock(void* handle)
+{
+    return RWLock_TryWriteLock((RWLOCK_HANDLE)handle);
+}
+
+static int acquire_thread(void* context)
+{
+    TEST_ACQUIRE_CONTEXT* acquire_context = (TEST_ACQUIRE_CONTEXT*)context;
+    acquire_context->result = acquire_context->acquire(acquire_context->handle);
+    return 0;
+}
+
+/*acquiring from another thread: some platforms let the owner acquire its lock again*/
+static LOCK_RESULT acquire_from_other_thread(TEST_ACQUIRE_FUNCTION acquire, void* handle)
+{
+    TEST_ACQUIRE_CONTEXT context;
+    THREAD_HANDLE thread;
+    int thread_result;
+
+    context.acquire = acquire;
+    context.handle = handle;
+    context.result = LOCK_ERROR;
+    ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&thread, acquire_thread, &context));
+    ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Join(thread, &thread_result));
+
+    return context.result;
+}
+
+static int timed_lock_10s_and_unlock_thread(void* context)
+{
+    TEST_ACQUIRE_CONTEXT* acquire_context = (TEST_ACQUIRE_CONTEXT*)context;
+    acquire_context->result = Lock_Timed((LOCK_HANDLE)acquire_context->handle, 10000);
+    if (acquire_context->result == LOCK_OK)
+    {
+        (void)Unlock((LOCK_HANDLE)acquire_context->handle);
+    }
+    return 0;
+}
+
+static int adaptive_lock_increment_thread(void* context)
+{
+    TEST_COUNTER_CONTEXT* counter_context = (TEST_COUNTER_CONTEXT*)context;
+    size_t i;
+
+    for (i = 0; i < TEST_INCREMENTS; i++)
+    {
+        (void)AdaptiveLock_Lock(counter_context->adaptive_lock);
+        counter_context->first++;
+        (void)AdaptiveLock_Unlock(counter_context->adaptive_lock);
+    }
+
+    return 0;
+}
+
+static int rwlock_writer_thread(void* context)
+{
+    TEST_COUNTER_CONTEXT* counter_context = (TEST_COUNTER_CONTEXT*)context;
+    size_t i;
+
+    for (i = 0; i < TEST_INCREMENTS; i++)
+    {
+        (void)RWLock_WriteLock(counter_context->rw_lock);
+        counter_context->first++;
+        counter_context->second++;
+        (void)RWLock_WriteUnlock(counter_context->rw_lock);
+    }
+
+    return 0;
+}
+
+static int rwlock_reader_thread(void* context)
+{
+    TEST_COUNTER_CONTEXT* counter_context = (TEST_COUNTER_CONTEXT*)context;
+    size_t torn_reads = 0;
+    size_t i;
+
+    for (i = 0; i < TEST_INCREMENTS; i++)
+    {
+        (void)RWLock_ReadLock(counter_context->rw_lock);
+        if (counter_context->first != counter_context->second)
+        {
+            torn_reads++;
+        }
+        (void)RWLock_ReadUnlock(counter_context->rw_lock);
+    }
+
+    (void)RWLock_WriteLock(counter_context->rw_lock);
+    counter_context->torn_reads += torn_reads;
+    (void)RWLock_WriteUnlock(counter_context->rw_lock);
+
+    return 0;
+}
+
 BEGIN_TEST_SUITE(LOCK_UnitTests)
 
 TEST_SUITE_INITIALIZE(a)
@@ -124,6 +265,404 @@ TEST_FUNCTION(LOCK_DeInit_NULL_fails)
     ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, result);
 }
 
+/* Lock_Try */
+
+/* Tests_SRS_LOCK_01_001: [ Lock_Try on NULL handle passed returns LOCK_ERROR ]*/
+TEST_FUNCTION(Lock_Try_with_NULL_fails)
+{
+    //act
+    LOCK_RESULT result = Lock_Try(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, result);
+}
+
+/* Tests_SRS_LOCK_01_002: [ Lock_Try shall acquire the lock and return LOCK_OK if no thread holds it ]*/
+TEST_FUNCTION(Lock_Try_on_a_free_lock_succeeds)
+{
+    //arrange
+    LOCK_HANDLE handle = Lock_Init();
+
+    //act
+    LOCK_RESULT result = Lock_Try(handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, result);
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_BUSY, acquire_from_other_thread(try_lock, handle));
+
+    //cleanup
+    (void)Unlock(handle);
+    (void)Lock_Deinit(handle);
+}
+
+/* Tests_SRS_LOCK_01_003: [ Lock_Try shall return LOCK_BUSY without waiting if the lock is held ]*/
+TEST_FUNCTION(Lock_Try_on_a_held_lock_returns_LOCK_BUSY)
+{
+    //arrange
+    LOCK_HANDLE handle = Lock_Init();
+    (void)Lock(handle);
+
+    //act
+    LOCK_RESULT result = acquire_from_other_thread(try_lock, handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_BUSY, result);
+
+    //cleanup
+    (void)Unlock(handle);
+    (void)Lock_Deinit(handle);
+}
+
+/* Lock_Timed */
+
+/* Tests_SRS_LOCK_01_005: [ Lock_Timed on NULL handle passed returns LOCK_ERROR ]*/
+TEST_FUNCTION(Lock_Timed_with_NULL_fails)
+{
+    //act
+    LOCK_RESULT result = Lock_Timed(NULL, 10);
+
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, result);
+}
+
+/* Tests_SRS_LOCK_01_006: [ Lock_Timed shall acquire the lock and return LOCK_OK if it is released within timeout_milliseconds ]*/
+TEST_FUNCTION(Lock_Timed_acquires_a_lock_released_before_the_timeout)
+{
+    //arrange
+    LOCK_HANDLE handle = Lock_Init();
+    TEST_ACQUIRE_CONTEXT context;
+    THREAD_HANDLE thread;
+    int thread_result;
+    context.handle = handle;
+    context.result = LOCK_ERROR;
+    (void)Lock(handle);
+
+    //act
+    ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&thread, timed_lock_10s_and_unlock_thread, &context));
+    ThreadAPI_Sleep(50);
+    (void)Unlock(handle);
+    ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Join(thread, &thread_result));
+
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, context.result);
+
+    //cleanup
+    (void)Lock_Deinit(handle);
+}
+
+/* Tests_SRS_LOCK_01_007: [ Lock_Timed shall return LOCK_TIMEOUT if the lock is still held after timeout_milliseconds ]*/
+TEST_FUNCTION(Lock_Timed_on_a_held_lock_times_out)
+{
+    //arrange
+    LOCK_HANDLE handle = Lock_Init();
+    (void)Lock(handle);
+
+    //act
+    LOCK_RESULT result = acquire_from_other_thread(timed_lock_10ms, handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_TIMEOUT, result);
+
+    //cleanup
+    (void)Unlock(handle);
+    (void)Lock_Deinit(handle);
+}
+
+/* AdaptiveLock */
+
+/* Tests_SRS_LOCK_01_009: [ AdaptiveLock_Init shall create an exclusive lock that is not held and return it ]*/
+/* Tests_SRS_LOCK_01_012: [ AdaptiveLock_Deinit shall free the lock and return LOCK_OK ]*/
+TEST_FUNCTION(AdaptiveLock_Init_and_Deinit_succeed)
+{
+    //act
+    ADAPTIVE_LOCK_HANDLE handle = AdaptiveLock_Init();
+
+    //assert
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, AdaptiveLock_Deinit(handle));
+}
+
+/* Tests_SRS_LOCK_01_011: [ AdaptiveLock_Deinit on NULL handle passed returns LOCK_ERROR ]*/
+/* Tests_SRS_LOCK_01_013: [ AdaptiveLock_Lock on NULL handle passed returns LOCK_ERROR ]*/
+/* Tests_SRS_LOCK_01_016: [ AdaptiveLock_Unlock on NULL handle passed returns LOCK_ERROR ]*/
+/* Tests_SRS_LOCK_01_019: [ AdaptiveLock_Try on NULL handle passed returns LOCK_ERROR ]*/
+/* Tests_SRS_LOCK_01_022: [ AdaptiveLock_Timed on NULL handle passed returns LOCK_ERROR ]*/
+TEST_FUNCTION(AdaptiveLock_functions_with_NULL_fail)
+{
+    //act
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, AdaptiveLock_Deinit(NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, AdaptiveLock_Lock(NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, AdaptiveLock_Unlock(NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, AdaptiveLock_Try(NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, AdaptiveLock_Timed(NULL, 10));
+}
+
+/* Tests_SRS_LOCK_01_015: [ AdaptiveLock_Lock shall return LOCK_OK once it holds the lock ]*/
+/* Tests_SRS_LOCK_01_017: [ AdaptiveLock_Unlock shall release the lock, wake one thread waiting for it, and return LOCK_OK ]*/
+/* Tests_SRS_LOCK_01_021: [ AdaptiveLock_Try shall return LOCK_BUSY without spinning or waiting if the lock is held ]*/
+TEST_FUNCTION(AdaptiveLock_Lock_holds_the_lock_until_AdaptiveLock_Unlock)
+{
+    //arrange
+    ADAPTIVE_LOCK_HANDLE handle = AdaptiveLock_Init();
+
+    //act
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, AdaptiveLock_Lock(handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_BUSY, acquire_from_other_thread(adaptive_try_lock, handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, AdaptiveLock_Unlock(handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, acquire_from_other_thread(adaptive_try_lock, handle));
+
+    //cleanup
+    (void)AdaptiveLock_Unlock(handle);
+    (void)AdaptiveLock_Deinit(handle);
+}
+
+/* Tests_SRS_LOCK_01_020: [ AdaptiveLock_Try shall acquire the lock and return LOCK_OK if no thread holds it ]*/
+TEST_FUNCTION(AdaptiveLock_Try_on_a_free_lock_succeeds)
+{
+    //arrange
+    ADAPTIVE_LOCK_HANDLE handle = AdaptiveLock_Init();
+
+    //act
+    LOCK_RESULT result = AdaptiveLock_Try(handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, result);
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_BUSY, acquire_from_other_thread(adaptive_try_lock, handle));
+
+    //cleanup
+    (void)AdaptiveLock_Unlock(handle);
+    (void)AdaptiveLock_Deinit(handle);
+}
+
+/* Tests_SRS_LOCK_01_023: [ AdaptiveLock_Timed shall spin like AdaptiveLock_Lock and then wait at most until timeout_milliseconds have passed, returning LOCK_OK if it acquired the lock and LOCK_TIMEOUT otherwise ]*/
+TEST_FUNCTION(AdaptiveLock_Timed_on_a_held_lock_times_out)
+{
+    //arrange
+    ADAPTIVE_LOCK_HANDLE handle = AdaptiveLock_Init();
+    (void)AdaptiveLock_Lock(handle);
+
+    //act
+    LOCK_RESULT result = acquire_from_other_thread(adaptive_timed_lock_10ms, handle);
+
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_TIMEOUT, result);
+
+    //cleanup
+    (void)AdaptiveLock_Unlock(handle);
+    (void)AdaptiveLock_Deinit(handle);
+}
+
+/* Tests_SRS_LOCK_01_023: [ AdaptiveLock_Timed shall spin like AdaptiveLock_Lock and then wait at most until timeout_milliseconds have passed, returning LOCK_OK if it acquired the lock and LOCK_TIMEOUT otherwise ]*/
+TEST_FUNCTION(AdaptiveLock_Timed_on_a_free_lock_succeeds)
+{
+    //arrange
+    ADAPTIVE_LOCK_HANDLE handle = AdaptiveLock_Init();
+
+    //act
+    LOCK_RESULT result = AdaptiveLock_Timed(handle, 10);
+
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, result);
+
+    //cleanup
+    (void)AdaptiveLock_Unlock(handle);
+    (void)AdaptiveLock_Deinit(handle);
+}
+
+/* Tests_SRS_LOCK_01_014: [ If the lock is held, AdaptiveLock_Lock shall spin for a bounded time and then wait until the lock is released ]*/
+TEST_FUNCTION(AdaptiveLock_serializes_threads)
+{
+    //arrange
+    TEST_COUNTER_CONTEXT context;
+    THREAD_HANDLE threads[TEST_THREAD_COUNT];
+    size_t i;
+    context.adaptive_lock = AdaptiveLock_Init();
+    context.first = 0;
+    ASSERT_IS_NOT_NULL(context.adaptive_lock);
+
+    //act
+    for (i = 0; i < TEST_THREAD_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&threads[i], adaptive_lock_increment_thread, &context));
+    }
+    for (i = 0; i < TEST_THREAD_COUNT; i++)
+    {
+        int thread_result;
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Join(threads[i], &thread_result));
+    }
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, TEST_THREAD_COUNT * TEST_INCREMENTS, context.first);
+
+    //cleanup
+    (void)AdaptiveLock_Deinit(context.adaptive_lock);
+}
+
+/* RWLock */
+
+/* Tests_SRS_LOCK_01_024: [ RWLock_Init shall create a reader-writer lock that is not held and return it ]*/
+/* Tests_SRS_LOCK_01_027: [ RWLock_Deinit shall free the lock and return LOCK_OK ]*/
+TEST_FUNCTION(RWLock_Init_and_Deinit_succeed)
+{
+    //act
+    RWLOCK_HANDLE handle = RWLock_Init();
+
+    //assert
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, RWLock_Deinit(handle));
+}
+
+/* Tests_SRS_LOCK_01_026: [ RWLock_Deinit on NULL handle passed returns LOCK_ERROR ]*/
+/* Tests_SRS_LOCK_01_028: [ RWLock_ReadLock, RWLock_ReadUnlock, RWLock_WriteLock, RWLock_WriteUnlock, RWLock_TryReadLock and RWLock_TryWriteLock on NULL handle passed return LOCK_ERROR ]*/
+TEST_FUNCTION(RWLock_functions_with_NULL_fail)
+{
+    //act
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, RWLock_Deinit(NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, RWLock_ReadLock(NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, RWLock_ReadUnlock(NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, RWLock_WriteLock(NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, RWLock_WriteUnlock(NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, RWLock_TryReadLock(NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, RWLock_TryWriteLock(NULL));
+}
+
+/* Tests_SRS_LOCK_01_029: [ RWLock_ReadLock shall wait while a writer holds the lock, then acquire it for reading alongside other readers and return LOCK_OK ]*/
+/* Tests_SRS_LOCK_01_032: [ RWLock_TryReadLock and RWLock_TryWriteLock shall acquire the lock and return LOCK_OK if they would not have to wait ]*/
+/* Tests_SRS_LOCK_01_033: [ RWLock_TryReadLock and RWLock_TryWriteLock shall return LOCK_BUSY without waiting if they would have to wait ]*/
+TEST_FUNCTION(readers_share_the_lock_and_keep_writers_out)
+{
+    //arrange
+    RWLOCK_HANDLE handle = RWLock_Init();
+
+    //act
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, RWLock_ReadLock(handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, acquire_from_other_thread(rwlock_try_read_lock, handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_BUSY, acquire_from_other_thread(rwlock_try_write_lock, handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, RWLock_ReadUnlock(handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_BUSY, acquire_from_other_thread(rwlock_try_write_lock, handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, RWLock_ReadUnlock(handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, RWLock_TryWriteLock(handle));
+
+    //cleanup
+    (void)RWLock_WriteUnlock(handle);
+    (void)RWLock_Deinit(handle);
+}
+
+/* Tests_SRS_LOCK_01_030: [ RWLock_ReadUnlock and RWLock_WriteUnlock shall release the lock and return LOCK_OK ]*/
+/* Tests_SRS_LOCK_01_031: [ RWLock_WriteLock shall wait while anyone holds the lock, then acquire it alone and return LOCK_OK ]*/
+TEST_FUNCTION(a_writer_keeps_readers_and_writers_out)
+{
+    //arrange
+    RWLOCK_HANDLE handle = RWLock_Init();
+
+    //act
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, RWLock_WriteLock(handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_BUSY, acquire_from_other_thread(rwlock_try_read_lock, handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_BUSY, acquire_from_other_thread(rwlock_try_write_lock, handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, RWLock_WriteUnlock(handle));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, RWLock_TryReadLock(handle));
+
+    //cleanup
+    (void)RWLock_ReadUnlock(handle);
+    (void)RWLock_Deinit(handle);
+}
+
+/* Tests_SRS_LOCK_01_029: [ RWLock_ReadLock shall wait while a writer holds the lock, then acquire it for reading alongside other readers and return LOCK_OK ]*/
+/* Tests_SRS_LOCK_01_031: [ RWLock_WriteLock shall wait while anyone holds the lock, then acquire it alone and return LOCK_OK ]*/
+TEST_FUNCTION(readers_never_see_a_write_in_progress)
+{
+    //arrange
+    TEST_COUNTER_CONTEXT context;
+    THREAD_HANDLE threads[TEST_THREAD_COUNT];
+    size_t i;
+    context.rw_lock = RWLock_Init();
+    context.first = 0;
+    context.second = 0;
+    context.torn_reads = 0;
+    ASSERT_IS_NOT_NULL(context.rw_lock);
+
+    //act
+    for (i = 0; i < TEST_THREAD_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&threads[i], ((i % 2) == 0) ? rwlock_writer_thread : rwlock_reader_thread, &context));
+    }
+    for (i = 0; i < TEST_THREAD_COUNT; i++)
+    {
+        int thread_result;
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Join(threads[i], &thread_result));
+    }
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 0, context.torn_reads);
+    ASSERT_ARE_EQUAL(size_t, (TEST_THREAD_COUNT / 2) * TEST_INCREMENTS, context.first);
+
+    //cleanup
+    (void)RWLock_Deinit(context.rw_lock);
+}
+
+#ifdef LOCK_COLLECT_CONTENTION
+/* Tests_SRS_LOCK_01_035: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall return LOCK_ERROR if any argument is NULL ]*/
+TEST_FUNCTION(GetContentionCounters_with_NULL_arguments_fail)
+{
+    //arrange
+    LOCK_HANDLE lock = Lock_Init();
+    ADAPTIVE_LOCK_HANDLE adaptive_lock = AdaptiveLock_Init();
+    RWLOCK_HANDLE rw_lock = RWLock_Init();
+    LOCK_CONTENTION_COUNTERS counters;
+
+    //act
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, Lock_GetContentionCounters(NULL, &counters));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, Lock_GetContentionCounters(lock, NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, AdaptiveLock_GetContentionCounters(NULL, &counters));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, AdaptiveLock_GetContentionCounters(adaptive_lock, NULL));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, RWLock_GetContentionCounters(NULL, &counters, &counters));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, RWLock_GetContentionCounters(rw_lock, NULL, &counters));
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_ERROR, RWLock_GetContentionCounters(rw_lock, &counters, NULL));
+
+    //cleanup
+    (void)RWLock_Deinit(rw_lock);
+    (void)AdaptiveLock_Deinit(adaptive_lock);
+    (void)Lock_Deinit(lock);
+}
+
+/* Tests_SRS_LOCK_01_036: [ Lock_GetContentionCounters, AdaptiveLock_GetContentionCounters and RWLock_GetContentionCounters shall fill in how many times the lock was acquired and how many attempts found it held, and return LOCK_OK ]*/
+TEST_FUNCTION(contention_counters_count_acquisitions_and_attempts_on_a_held_lock)
+{
+    //arrange
+    LOCK_HANDLE lock = Lock_Init();
+    RWLOCK_HANDLE rw_lock = RWLock_Init();
+    LOCK_CONTENTION_COUNTERS counters;
+    LOCK_CONTENTION_COUNTERS write_counters;
+    (void)Lock(lock);
+    (void)acquire_from_other_thread(try_lock, lock);
+    (void)Unlock(lock);
+    (void)RWLock_ReadLock(rw_lock);
+    (void)acquire_from_other_thread(rwlock_try_write_lock, rw_lock);
+    (void)RWLock_ReadUnlock(rw_lock);
+
+    //act
+    //assert
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, Lock_GetContentionCounters(lock, &counters));
+    ASSERT_ARE_EQUAL(uint64_t, 1, counters.acquired);
+    ASSERT_ARE_EQUAL(uint64_t, 1, counters.contended);
+    ASSERT_ARE_EQUAL(LOCK_RESULT, LOCK_OK, RWLock_GetContentionCounters(rw_lock, &counters, &write_counters));
+    ASSERT_ARE_EQUAL(uint64_t, 1, counters.acquired);
+    ASSERT_ARE_EQUAL(uint64_t, 0, counters.contended);
+    ASSERT_ARE_EQUAL(uint64_t, 0, write_counters.acquired);
+    ASSERT_ARE_EQUAL(uint64_t, 1, write_counters.contended);
+
+    //cleanup
+    (void)RWLock_Deinit(rw_lock);
+    (void)Lock_Deinit(lock);
+}
+#endif
+
 /* Extra negative tests - only supported on Win32 since the behavior on other platforms is undefined. */
 #ifdef WIN32
 TEST_FUNCTION(LOCK_Init_Unlock_fails)
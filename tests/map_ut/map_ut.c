@@ -76,20 +76,27 @@ static TEST_MUTEX_HANDLE g_dllByDll;
 
 #include "azure_c_shared_utility/strings.h"
 
-STRING_HANDLE my_STRING_construct(const char* psz)
-{
-    (void)psz;
-    return (STRING_HANDLE)malloc(1);
-}
+#include "azure_c_shared_utility/json_writer.h"
 
 void my_STRING_delete(STRING_HANDLE handle)
 {
     free(handle);
 }
 
-STRING_HANDLE my_STRING_new_JSON(const char* source)
+JSON_WRITER_HANDLE my_json_writer_create(size_t initialCapacity)
+{
+    (void)initialCapacity;
+    return (JSON_WRITER_HANDLE)malloc(1);
+}
+
+void my_json_writer_destroy(JSON_WRITER_HANDLE writer)
 {
-    (void)source;
+    free(writer);
+}
+
+STRING_HANDLE my_json_writer_detach_STRING(JSON_WRITER_HANDLE writer)
+{
+    (void)writer;
     return (STRING_HANDLE)malloc(1);
 }
 
@@ -173,13 +180,15 @@ BEGIN_TEST_SUITE(map_unittests)
 
         REGISTER_UMOCK_ALIAS_TYPE(MAP_HANDLE, void*);
         REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(JSON_WRITER_HANDLE, void*);
 
         REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
         REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
         REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
-        REGISTER_GLOBAL_MOCK_HOOK(STRING_construct, my_STRING_construct);
         REGISTER_GLOBAL_MOCK_HOOK(STRING_delete, my_STRING_delete);
-        REGISTER_GLOBAL_MOCK_HOOK(STRING_new_JSON, my_STRING_new_JSON);
+        REGISTER_GLOBAL_MOCK_HOOK(json_writer_create, my_json_writer_create);
+        REGISTER_GLOBAL_MOCK_HOOK(json_writer_destroy, my_json_writer_destroy);
+        REGISTER_GLOBAL_MOCK_HOOK(json_writer_detach_STRING, my_json_writer_detach_STRING);
     }
 
     TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -2750,6 +2759,7 @@ BEGIN_TEST_SUITE(map_unittests)
 
     /*Tests_SRS_MAP_02_048: [Map_ToJSON shall produce a STRING_HANDLE representing the content of the MAP.]*/
     /*Tests_SRS_MAP_02_049: [If the MAP is empty, then Map_ToJSON shall produce the string "{}".] */
+    /*Tests_SRS_MAP_01_001: [ Map_ToJSON shall write the JSON with a single JSON writer created by json_writer_create, sized for the whole map, and hand its buffer over with json_writer_detach_STRING. ]*/
     TEST_FUNCTION(Map_ToJSON_with_empty_MAP_produces_empty_JSON)
     {
         ///arrange
@@ -2757,103 +2767,11 @@ BEGIN_TEST_SUITE(map_unittests)
         STRING_HANDLE toJSON;
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "}"))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-        STRING_delete(toJSON);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_empty_MAP_produces_empty_JSON_fails_when_STRING_concat_fails)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "}"))
-            .IgnoreArgument(1).SetReturn(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_empty_MAP_produces_empty_JSON_fails_when_STRING_construct_fails)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1).SetReturn(NULL);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_050: [If the map has properties then Map_ToJSON shall produce the following string:{"name1":"value1", "name2":"value2" ...}] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_succeeds)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "}"))/*now JSON is {"redkey":"redoor"}*/
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(json_writer_create(3));
+        STRICT_EXPECTED_CALL(json_writer_begin_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_end_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_detach_STRING(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_destroy(IGNORED_PTR_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -2868,82 +2786,15 @@ BEGIN_TEST_SUITE(map_unittests)
     }
 
     /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_1)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "}"))/*now JSON is {"redkey":"redoor"}*/
-            .IgnoreArgument(1).SetReturn(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_2)
+    TEST_FUNCTION(Map_ToJSON_with_empty_MAP_fails_when_json_writer_create_fails)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-            .IgnoreArgument(1)
-            .IgnoreArgument(2)
-            .SetReturn(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(json_writer_create(3))
+            .SetReturn(NULL);
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -2957,33 +2808,17 @@ BEGIN_TEST_SUITE(map_unittests)
     }
 
     /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_3)
+    TEST_FUNCTION(Map_ToJSON_with_empty_MAP_fails_when_json_writer_begin_object_fails)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-            .IgnoreArgument(1)
+        STRICT_EXPECTED_CALL(json_writer_create(3));
+        STRICT_EXPECTED_CALL(json_writer_begin_object(IGNORED_PTR_ARG))
             .SetReturn(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(json_writer_destroy(IGNORED_PTR_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -2997,64 +2832,18 @@ BEGIN_TEST_SUITE(map_unittests)
     }
 
     /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_4)
+    TEST_FUNCTION(Map_ToJSON_with_empty_MAP_fails_when_json_writer_end_object_fails)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-            .IgnoreArgument(1)
-            .IgnoreArgument(2)
+        STRICT_EXPECTED_CALL(json_writer_create(3));
+        STRICT_EXPECTED_CALL(json_writer_begin_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_end_object(IGNORED_PTR_ARG))
             .SetReturn(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_5)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor"))
-            .SetReturn(NULL); /*prepare the value*/
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(json_writer_destroy(IGNORED_PTR_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -3068,45 +2857,19 @@ BEGIN_TEST_SUITE(map_unittests)
     }
 
     /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_6)
+    TEST_FUNCTION(Map_ToJSON_with_empty_MAP_fails_when_json_writer_detach_STRING_fails)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")).SetReturn(NULL); /*prepare the key*/
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fail_when_STRING_fails_7)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1)
+        STRICT_EXPECTED_CALL(json_writer_create(3));
+        STRICT_EXPECTED_CALL(json_writer_begin_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_end_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_detach_STRING(IGNORED_PTR_ARG))
             .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(json_writer_destroy(IGNORED_PTR_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -3120,58 +2883,22 @@ BEGIN_TEST_SUITE(map_unittests)
     }
 
     /*Tests_SRS_MAP_02_050: [If the map has properties then Map_ToJSON shall produce the following string:{"name1":"value1", "name2":"value2" ...}] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_succeeds)
+    /*Tests_SRS_MAP_01_001: [ Map_ToJSON shall write the JSON with a single JSON writer created by json_writer_create, sized for the whole map, and hand its buffer over with json_writer_detach_STRING. ]*/
+    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_succeeds)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
         (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-        }
-
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ","))
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-        }
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "}"))/*now JSON is {"redkey":"redoor"}*/
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(json_writer_create(3 + (6 + 7 + 6))); /*{} and "redkey":"reddoor",*/
+        STRICT_EXPECTED_CALL(json_writer_begin_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_write_key(IGNORED_PTR_ARG, "redkey"));
+        STRICT_EXPECTED_CALL(json_writer_write_string(IGNORED_PTR_ARG, "reddoor"));
+        STRICT_EXPECTED_CALL(json_writer_end_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_detach_STRING(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_destroy(IGNORED_PTR_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -3185,579 +2912,49 @@ BEGIN_TEST_SUITE(map_unittests)
         STRING_delete(toJSON);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_1)
+    /*Tests_SRS_MAP_01_002: [ Bytes from 0x80 up in keys and values shall be written as they are, so UTF-8 keys and values are kept in the JSON. ]*/
+    TEST_FUNCTION(Map_ToJSON_with_non_ASCII_key_and_value_succeeds)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
+        (void)Map_AddOrUpdate(handle, "cl\xC3\xA9", "caf\xC3\xA9");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-        }
-
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ","))
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-        }
-
-        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "}"))/*now JSON is {"redkey":"redoor"}*/
-            .IgnoreArgument(1)
-            .SetReturn(1);
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(json_writer_create(3 + (4 + 5 + 6)));
+        STRICT_EXPECTED_CALL(json_writer_begin_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_write_key(IGNORED_PTR_ARG, "cl\xC3\xA9"));
+        STRICT_EXPECTED_CALL(json_writer_write_string(IGNORED_PTR_ARG, "caf\xC3\xA9"));
+        STRICT_EXPECTED_CALL(json_writer_end_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_detach_STRING(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_destroy(IGNORED_PTR_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_2)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-        }
-
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ","))
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2)
-                .SetReturn(1);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-        }
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_3)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-        }
-
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ","))
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1)
-                .SetReturn(1);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-        }
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_4)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-        }
-
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ","))
-                .IgnoreArgument(1);
-
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2)
-                .SetReturn(1);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-        }
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_5)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-        }
-
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ","))
-                .IgnoreArgument(1).SetReturn(1);
-
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-        }
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_6)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-        }
-
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowdoor")).SetReturn(NULL); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-        }
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_7)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-        }
-
-        { /*artificial scope for second key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("yellowkey")).SetReturn(NULL); /*prepare the key*/
-        }
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_8)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2)
-                .SetReturn(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-        }
-
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_9)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey":"reddoor"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2)
-                .SetReturn(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-        }
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
-        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-        ///cleanup
-        Map_Destroy(handle);
-    }
-
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_10)
-    {
-        ///arrange
-        MAP_HANDLE handle = Map_Create(NULL);
-        STRING_HANDLE toJSON;
-        (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
-        umock_c_reset_all_calls();
-
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2);
-            STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, ":")) /*now JSON is {"redkey":*/
-                .IgnoreArgument(1)
-                .SetReturn(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-        }
-
-        ///act
-        toJSON = Map_ToJSON(handle);
-
-        ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_IS_NOT_NULL(toJSON);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
+        STRING_delete(toJSON);
     }
 
     /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_11)
+    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fails_when_json_writer_write_key_fails)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
         (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        { /*artificial scope for first key:value*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-            STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")); /*prepare the value*/
-            STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG)) /*now JSON is {"redkey"*/
-                .IgnoreArgument(1)
-                .IgnoreArgument(2)
-                .SetReturn(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the value*/
-                .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-                .IgnoreArgument(1);
-        }
+        STRICT_EXPECTED_CALL(json_writer_create(IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(json_writer_begin_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_write_key(IGNORED_PTR_ARG, "redkey"))
+            .SetReturn(1);
+        STRICT_EXPECTED_CALL(json_writer_destroy(IGNORED_PTR_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -3771,24 +2968,20 @@ BEGIN_TEST_SUITE(map_unittests)
     }
 
     /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_12)
+    TEST_FUNCTION(Map_ToJSON_with_1_MAP_element_fails_when_json_writer_write_string_fails)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
         STRING_HANDLE toJSON;
         (void)Map_AddOrUpdate(handle, "redkey", "reddoor");
-        (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_new_JSON("reddoor")).SetReturn(NULL); /*prepare the value*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)) /*delete the key*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(json_writer_create(IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(json_writer_begin_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_write_key(IGNORED_PTR_ARG, "redkey"));
+        STRICT_EXPECTED_CALL(json_writer_write_string(IGNORED_PTR_ARG, "reddoor"))
+            .SetReturn(1);
+        STRICT_EXPECTED_CALL(json_writer_destroy(IGNORED_PTR_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -3801,8 +2994,8 @@ BEGIN_TEST_SUITE(map_unittests)
         Map_Destroy(handle);
     }
 
-    /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_13)
+    /*Tests_SRS_MAP_02_050: [If the map has properties then Map_ToJSON shall produce the following string:{"name1":"value1", "name2":"value2" ...}] */
+    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_succeeds)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
@@ -3811,25 +3004,30 @@ BEGIN_TEST_SUITE(map_unittests)
         (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(STRING_new_JSON("redkey")).SetReturn(NULL); /*prepare the key*/
-        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(json_writer_create(3 + (6 + 7 + 6) + (9 + 10 + 6)));
+        STRICT_EXPECTED_CALL(json_writer_begin_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_write_key(IGNORED_PTR_ARG, "redkey"));
+        STRICT_EXPECTED_CALL(json_writer_write_string(IGNORED_PTR_ARG, "reddoor"));
+        STRICT_EXPECTED_CALL(json_writer_write_key(IGNORED_PTR_ARG, "yellowkey"));
+        STRICT_EXPECTED_CALL(json_writer_write_string(IGNORED_PTR_ARG, "yellowdoor"));
+        STRICT_EXPECTED_CALL(json_writer_end_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_detach_STRING(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_destroy(IGNORED_PTR_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
 
         ///assert
-        ASSERT_IS_NULL(toJSON);
+        ASSERT_IS_NOT_NULL(toJSON);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
         Map_Destroy(handle);
+        STRING_delete(toJSON);
     }
 
     /*Tests_SRS_MAP_02_051: [If any error occurs while producing the output, then Map_ToJSON shall fail and return NULL.] */
-    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_fails_when_STRING_fails_14)
+    TEST_FUNCTION(Map_ToJSON_with_2_MAP_elements_stops_at_the_first_failure)
     {
         ///arrange
         MAP_HANDLE handle = Map_Create(NULL);
@@ -3838,9 +3036,13 @@ BEGIN_TEST_SUITE(map_unittests)
         (void)Map_AddOrUpdate(handle, "yellowkey", "yellowdoor");
         umock_c_reset_all_calls();
 
-        STRICT_EXPECTED_CALL(STRING_construct("{"))
-            .IgnoreArgument(1)
-            .SetReturn(NULL);
+        STRICT_EXPECTED_CALL(json_writer_create(IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(json_writer_begin_object(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(json_writer_write_key(IGNORED_PTR_ARG, "redkey"));
+        STRICT_EXPECTED_CALL(json_writer_write_string(IGNORED_PTR_ARG, "reddoor"));
+        STRICT_EXPECTED_CALL(json_writer_write_key(IGNORED_PTR_ARG, "yellowkey"))
+            .SetReturn(1);
+        STRICT_EXPECTED_CALL(json_writer_destroy(IGNORED_PTR_ARG));
 
         ///act
         toJSON = Map_ToJSON(handle);
@@ -3853,5 +3055,4 @@ BEGIN_TEST_SUITE(map_unittests)
         Map_Destroy(handle);
     }
 
-
 END_TEST_SUITE(map_unittests)
@@ -0,0 +1,340 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+
+static void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/gballoc.h"
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/mpsc_queue.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/doublylinkedlist.h"
+
+#define TEST_PRODUCER_COUNT     4
+#define TEST_ITEMS_PER_PRODUCER 100000
+
+typedef struct TEST_ITEM_TAG
+{
+    MPSC_QUEUE_NODE node;
+    size_t producer;
+    size_t sequence;
+} TEST_ITEM;
+
+typedef struct TEST_PRODUCER_TAG
+{
+    MPSC_QUEUE_HANDLE queue;
+    size_t index;
+    TEST_ITEM* items;
+} TEST_PRODUCER;
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static int producer_thread(void* context)
+{
+    TEST_PRODUCER* producer = (TEST_PRODUCER*)context;
+    size_t i;
+
+    for (i = 0; i < TEST_ITEMS_PER_PRODUCER; i++)
+    {
+        producer->items[i].producer = producer->index;
+        producer->items[i].sequence = i;
+        (void)mpsc_queue_push(producer->queue, &producer->items[i].node);
+    }
+
+    return 0;
+}
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(mpsc_queue_unittests)
+
+TEST_SUITE_INITIALIZE(TestSuiteInitialize)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    umock_c_init(on_umock_c_error);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(f)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(cleans)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* mpsc_queue_create */
+
+/* Tests_SRS_MPSC_QUEUE_01_001: [ mpsc_queue_create shall allocate an empty queue and return it. ]*/
+TEST_FUNCTION(mpsc_queue_create_succeeds)
+{
+    //arrange
+    MPSC_QUEUE_HANDLE queue;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+
+    //act
+    queue = mpsc_queue_create();
+
+    //assert
+    ASSERT_IS_NOT_NULL(queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(mpsc_queue_pop(queue));
+
+    //cleanup
+    mpsc_queue_destroy(queue);
+}
+
+/* Tests_SRS_MPSC_QUEUE_01_002: [ If allocating fails, mpsc_queue_create shall return NULL. ]*/
+TEST_FUNCTION(when_allocating_fails_mpsc_queue_create_fails)
+{
+    //arrange
+    MPSC_QUEUE_HANDLE queue;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    queue = mpsc_queue_create();
+
+    //assert
+    ASSERT_IS_NULL(queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* mpsc_queue_destroy */
+
+/* Tests_SRS_MPSC_QUEUE_01_003: [ If queue is NULL, mpsc_queue_destroy shall return. ]*/
+TEST_FUNCTION(mpsc_queue_destroy_with_NULL_returns)
+{
+    //act
+    mpsc_queue_destroy(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_MPSC_QUEUE_01_004: [ mpsc_queue_destroy shall free the queue without touching the nodes left in it. ]*/
+TEST_FUNCTION(mpsc_queue_destroy_frees_the_queue)
+{
+    //arrange
+    MPSC_QUEUE_HANDLE queue = mpsc_queue_create();
+    TEST_ITEM item;
+    ASSERT_ARE_EQUAL(int, 0, mpsc_queue_push(queue, &item.node));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    //act
+    mpsc_queue_destroy(queue);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* mpsc_queue_push */
+
+/* Tests_SRS_MPSC_QUEUE_01_005: [ If queue or node is NULL, mpsc_queue_push shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(mpsc_queue_push_with_invalid_arguments_fails)
+{
+    //arrange
+    MPSC_QUEUE_HANDLE queue = mpsc_queue_create();
+    TEST_ITEM item;
+    umock_c_reset_all_calls();
+
+    //act
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, mpsc_queue_push(NULL, &item.node));
+    ASSERT_ARE_NOT_EQUAL(int, 0, mpsc_queue_push(queue, NULL));
+    ASSERT_IS_NULL(mpsc_queue_pop(queue));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    mpsc_queue_destroy(queue);
+}
+
+/* Tests_SRS_MPSC_QUEUE_01_006: [ mpsc_queue_push shall make node the back of the queue with an atomic exchange, link the previous back to it, and return 0. ]*/
+/* Tests_SRS_MPSC_QUEUE_01_009: [ mpsc_queue_pop shall take the oldest node out of the queue and return it. ]*/
+TEST_FUNCTION(nodes_are_popped_in_push_order)
+{
+    //arrange
+    MPSC_QUEUE_HANDLE queue = mpsc_queue_create();
+    TEST_ITEM items[3];
+    umock_c_reset_all_calls();
+
+    //act
+    ASSERT_ARE_EQUAL(int, 0, mpsc_queue_push(queue, &items[0].node));
+    ASSERT_ARE_EQUAL(int, 0, mpsc_queue_push(queue, &items[1].node));
+    ASSERT_ARE_EQUAL(int, 0, mpsc_queue_push(queue, &items[2].node));
+
+    //assert
+    ASSERT_ARE_EQUAL(void_ptr, &items[0].node, mpsc_queue_pop(queue));
+    ASSERT_ARE_EQUAL(void_ptr, &items[1].node, mpsc_queue_pop(queue));
+    ASSERT_ARE_EQUAL(void_ptr, &items[2].node, mpsc_queue_pop(queue));
+    ASSERT_IS_NULL(mpsc_queue_pop(queue));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    mpsc_queue_destroy(queue);
+}
+
+/* Tests_SRS_MPSC_QUEUE_01_009: [ mpsc_queue_pop shall take the oldest node out of the queue and return it. ]*/
+TEST_FUNCTION(a_node_can_be_pushed_again_after_it_is_popped)
+{
+    //arrange
+    MPSC_QUEUE_HANDLE queue = mpsc_queue_create();
+    TEST_ITEM items[2];
+    size_t i;
+
+    //act
+    //assert
+    for (i = 0; i < 10; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, mpsc_queue_push(queue, &items[i % 2].node));
+        ASSERT_ARE_EQUAL(void_ptr, &items[i % 2].node, mpsc_queue_pop(queue));
+        ASSERT_IS_NULL(mpsc_queue_pop(queue));
+    }
+
+    //cleanup
+    mpsc_queue_destroy(queue);
+}
+
+/* mpsc_queue_pop */
+
+/* Tests_SRS_MPSC_QUEUE_01_007: [ If queue is NULL, mpsc_queue_pop shall return NULL. ]*/
+TEST_FUNCTION(mpsc_queue_pop_with_NULL_returns_NULL)
+{
+    //act
+    MPSC_QUEUE_NODE* node = mpsc_queue_pop(NULL);
+
+    //assert
+    ASSERT_IS_NULL(node);
+}
+
+/* Tests_SRS_MPSC_QUEUE_01_008: [ If the queue is empty, mpsc_queue_pop shall return NULL. ]*/
+TEST_FUNCTION(mpsc_queue_pop_on_an_empty_queue_returns_NULL)
+{
+    //arrange
+    MPSC_QUEUE_HANDLE queue = mpsc_queue_create();
+
+    //act
+    MPSC_QUEUE_NODE* node = mpsc_queue_pop(queue);
+
+    //assert
+    ASSERT_IS_NULL(node);
+
+    //cleanup
+    mpsc_queue_destroy(queue);
+}
+
+/* Tests_SRS_MPSC_QUEUE_01_009: [ mpsc_queue_pop shall take the oldest node out of the queue and return it. ]*/
+/* Tests_SRS_MPSC_QUEUE_01_010: [ If a producer has swapped in a new back but not linked it yet, mpsc_queue_pop shall return NULL. ]*/
+TEST_FUNCTION(nodes_pushed_by_several_threads_are_all_popped_in_the_order_of_each_thread)
+{
+    //arrange
+    MPSC_QUEUE_HANDLE queue = mpsc_queue_create();
+    TEST_PRODUCER producers[TEST_PRODUCER_COUNT];
+    THREAD_HANDLE threads[TEST_PRODUCER_COUNT];
+    size_t next_sequence[TEST_PRODUCER_COUNT];
+    size_t popped = 0;
+    size_t i;
+    ASSERT_IS_NOT_NULL(queue);
+
+    for (i = 0; i < TEST_PRODUCER_COUNT; i++)
+    {
+        producers[i].queue = queue;
+        producers[i].index = i;
+        producers[i].items = (TEST_ITEM*)malloc(TEST_ITEMS_PER_PRODUCER * sizeof(TEST_ITEM));
+        ASSERT_IS_NOT_NULL(producers[i].items);
+        next_sequence[i] = 0;
+    }
+
+    for (i = 0; i < TEST_PRODUCER_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&threads[i], producer_thread, &producers[i]));
+    }
+
+    //act
+    while (popped < TEST_PRODUCER_COUNT * TEST_ITEMS_PER_PRODUCER)
+    {
+        MPSC_QUEUE_NODE* node = mpsc_queue_pop(queue);
+        if (node == NULL)
+        {
+            ThreadAPI_Sleep(0);
+        }
+        else
+        {
+            TEST_ITEM* item = containingRecord(node, TEST_ITEM, node);
+            ASSERT_ARE_EQUAL(size_t, next_sequence[item->producer], item->sequence);
+            next_sequence[item->producer]++;
+            popped++;
+        }
+    }
+
+    //assert
+    for (i = 0; i < TEST_PRODUCER_COUNT; i++)
+    {
+        int thread_result;
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Join(threads[i], &thread_result));
+        ASSERT_ARE_EQUAL(size_t, TEST_ITEMS_PER_PRODUCER, next_sequence[i]);
+    }
+    ASSERT_IS_NULL(mpsc_queue_pop(queue));
+
+    //cleanup
+    for (i = 0; i < TEST_PRODUCER_COUNT; i++)
+    {
+        free(producers[i].items);
+    }
+    mpsc_queue_destroy(queue);
+}
+
+END_TEST_SUITE(mpsc_queue_unittests)
@@ -175,5 +175,88 @@ BEGIN_TEST_SUITE(refcount_unittests)
         //cleanup
     }
 
+    TEST_FUNCTION(refcount_with_weak_ref_DEC_REF_after_create_says_we_should_free)
+    {
+        ///arrange
+        WEAK_POS_HANDLE p;
+        p = WeakPos_Create(4);
+        umock_c_reset_all_calls();
+
+        ///act
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        WeakPos_Destroy(p);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+    }
+
+    TEST_FUNCTION(refcount_TRY_INC_REF_while_a_reference_exists_takes_a_reference)
+    {
+        ///arrange
+        WEAK_POS_HANDLE p, weak_p, locked_p;
+        p = WeakPos_Create(4);
+        weak_p = WeakPos_GetWeak(p);
+        umock_c_reset_all_calls();
+
+        ///act
+        locked_p = WeakPos_Lock(weak_p);
+
+        ///assert
+        ASSERT_IS_TRUE(locked_p == p);
+        ASSERT_ARE_EQUAL(int, 4, WeakPos_GetX(locked_p));
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        WeakPos_Destroy(locked_p);
+        WeakPos_Destroy(p);
+        WeakPos_DestroyWeak(weak_p);
+    }
+
+    TEST_FUNCTION(refcount_a_weak_ref_does_not_keep_the_object_alive)
+    {
+        ///arrange
+        WEAK_POS_HANDLE p, clone_of_p, weak_p, locked_p;
+        p = WeakPos_Create(4);
+        clone_of_p = WeakPos_Clone(p);
+        weak_p = WeakPos_GetWeak(p);
+        WeakPos_Destroy(p);
+        WeakPos_Destroy(clone_of_p);
+        umock_c_reset_all_calls();
+
+        ///act
+        locked_p = WeakPos_Lock(weak_p);
+
+        ///assert
+        ASSERT_IS_NULL(locked_p);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+        WeakPos_DestroyWeak(weak_p);
+    }
+
+    TEST_FUNCTION(refcount_with_a_weak_ref_the_memory_is_freed_by_the_last_weak_release)
+    {
+        ///arrange
+        WEAK_POS_HANDLE p, weak_p;
+        p = WeakPos_Create(4);
+        weak_p = WeakPos_GetWeak(p);
+        umock_c_reset_all_calls();
+
+        ///act
+        WeakPos_Destroy(p);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        WeakPos_DestroyWeak(weak_p);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        //cleanup
+    }
+
 END_TEST_SUITE(refcount_unittests)
 
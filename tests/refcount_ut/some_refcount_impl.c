@@ -43,3 +43,92 @@ void Pos_Destroy(POS_HANDLE posHandle)
         }
     }
 }
+
+typedef struct weak_pos
+{
+    int x;
+}weak_pos;
+
+DEFINE_REFCOUNT_TYPE_WITH_WEAK_REF(weak_pos);
+
+WEAK_POS_HANDLE WeakPos_Create(int x)
+{
+    weak_pos* result = REFCOUNT_TYPE_CREATE(weak_pos);
+    if (result != NULL)
+    {
+        result->x = x;
+    }
+    return result;
+}
+
+WEAK_POS_HANDLE WeakPos_Clone(WEAK_POS_HANDLE weakPosHandle)
+{
+    if (weakPosHandle != NULL)
+    {
+        weak_pos* p = weakPosHandle;
+        INC_REF(weak_pos, p);
+    }
+    return weakPosHandle;
+}
+
+static void WeakPos_ReleaseWeak(weak_pos* p)
+{
+    if (DEC_WEAK_REF(weak_pos, p) == DEC_RETURN_ZERO)
+    {
+        free(p);
+    }
+}
+
+void WeakPos_Destroy(WEAK_POS_HANDLE weakPosHandle)
+{
+    if (weakPosHandle != NULL)
+    {
+        weak_pos* p = weakPosHandle;
+        if (DEC_REF(weak_pos, p) == DEC_RETURN_ZERO)
+        {
+            /*this is where what the object owns would be released*/
+            p->x = 0;
+            WeakPos_ReleaseWeak(p);
+        }
+    }
+}
+
+WEAK_POS_HANDLE WeakPos_GetWeak(WEAK_POS_HANDLE weakPosHandle)
+{
+    if (weakPosHandle != NULL)
+    {
+        weak_pos* p = weakPosHandle;
+        INC_WEAK_REF(weak_pos, p);
+    }
+    return weakPosHandle;
+}
+
+WEAK_POS_HANDLE WeakPos_Lock(WEAK_POS_HANDLE weakPosHandle)
+{
+    WEAK_POS_HANDLE result;
+    if (weakPosHandle == NULL)
+    {
+        result = NULL;
+    }
+    else
+    {
+        weak_pos* p = weakPosHandle;
+        int succeeded;
+        TRY_INC_REF(weak_pos, p, succeeded);
+        result = succeeded ? weakPosHandle : NULL;
+    }
+    return result;
+}
+
+void WeakPos_DestroyWeak(WEAK_POS_HANDLE weakPosHandle)
+{
+    if (weakPosHandle != NULL)
+    {
+        WeakPos_ReleaseWeak(weakPosHandle);
+    }
+}
+
+int WeakPos_GetX(WEAK_POS_HANDLE weakPosHandle)
+{
+    return weakPosHandle->x;
+}
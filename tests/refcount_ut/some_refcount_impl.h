@@ -15,6 +15,17 @@ extern POS_HANDLE Pos_Create(int x);
 extern POS_HANDLE Pos_Clone(POS_HANDLE posHandle);
 extern void Pos_Destroy(POS_HANDLE posHandle);
 
+/*the weak references are WEAK_POS_HANDLEs too, that only WeakPos_Lock and WeakPos_DestroyWeak take*/
+typedef struct weak_pos* WEAK_POS_HANDLE;
+
+extern WEAK_POS_HANDLE WeakPos_Create(int x);
+extern WEAK_POS_HANDLE WeakPos_Clone(WEAK_POS_HANDLE weakPosHandle);
+extern void WeakPos_Destroy(WEAK_POS_HANDLE weakPosHandle);
+extern WEAK_POS_HANDLE WeakPos_GetWeak(WEAK_POS_HANDLE weakPosHandle);
+extern WEAK_POS_HANDLE WeakPos_Lock(WEAK_POS_HANDLE weakPosHandle);
+extern void WeakPos_DestroyWeak(WEAK_POS_HANDLE weakPosHandle);
+extern int WeakPos_GetX(WEAK_POS_HANDLE weakPosHandle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,933 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#else
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#endif
+
+static void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+
+#define ENABLE_MOCKS
+
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/sastoken.h"
+#include "azure_c_shared_utility/hmacsha256.h"
+#include "azure_c_shared_utility/base64.h"
+#include "azure_c_shared_utility/buffer_.h"
+#include "azure_c_shared_utility/agenttime.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/crt_abstractions.h"
+
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/sastoken_cache.h"
+
+IMPLEMENT_UMOCK_C_ENUM_TYPE(LOCK_RESULT, LOCK_RESULT_VALUES);
+
+#define TEST_LOCK_HANDLE (LOCK_HANDLE)0x4242
+#define TEST_LIST_HANDLE (SINGLYLINKEDLIST_HANDLE)0x4243
+#define TEST_LIST_ITEM_HANDLE (LIST_ITEM_HANDLE)0x4244
+#define TEST_DECODED_KEY_HANDLE (BUFFER_HANDLE)0x4245
+#define TEST_HMAC_KEY_HANDLE (HMACSHA256_KEY_HANDLE)0x4246
+#define TEST_STRING_HANDLE (STRING_HANDLE)0x4247
+#define TEST_TOKEN_LIFETIME 3600
+#define TEST_RENEWAL_PERCENTAGE 80
+#define TEST_START_TIME 1000
+#define TEST_MAX_ENTRIES 16
+
+static const char* TEST_KEY = "a2V5";
+static const char* TEST_SCOPE = "myhub.azure-devices.net/devices/dev1";
+static const char* TEST_KEY_NAME = "owner";
+static unsigned char TEST_DECODED_KEY[] = { 'k', 'e', 'y' };
+
+static time_t current_time;
+static const void* added_entry;
+static int built_tokens;
+
+static time_t my_get_time(time_t* p)
+{
+    (void)p;
+    return current_time;
+}
+
+static double my_get_difftime(time_t stopTime, time_t startTime)
+{
+    return (double)(stopTime - startTime);
+}
+
+static int my_mallocAndStrcpy_s(char** destination, const char* source)
+{
+    *destination = (char*)malloc(strlen(source) + 1);
+    (void)strcpy(*destination, source);
+    return 0;
+}
+
+static LIST_ITEM_HANDLE my_singlylinkedlist_add(SINGLYLINKEDLIST_HANDLE list, const void* item)
+{
+    (void)list;
+    added_entry = item;
+    return TEST_LIST_ITEM_HANDLE;
+}
+
+static const void* my_singlylinkedlist_item_get_value(LIST_ITEM_HANDLE item_handle)
+{
+    (void)item_handle;
+    return added_entry;
+}
+
+/* the fake list holds at most the one entry added by the test */
+static LIST_ITEM_HANDLE my_singlylinkedlist_get_head_item(SINGLYLINKEDLIST_HANDLE list)
+{
+    (void)list;
+    return (added_entry == NULL) ? NULL : TEST_LIST_ITEM_HANDLE;
+}
+
+static LIST_ITEM_HANDLE my_singlylinkedlist_find(SINGLYLINKEDLIST_HANDLE list, LIST_MATCH_FUNCTION match_function, const void* match_context)
+{
+    (void)match_function;
+    (void)match_context;
+    return my_singlylinkedlist_get_head_item(list);
+}
+
+static int my_singlylinkedlist_remove(SINGLYLINKEDLIST_HANDLE list, LIST_ITEM_HANDLE item_handle)
+{
+    (void)list;
+    (void)item_handle;
+    added_entry = NULL;
+    return 0;
+}
+
+static char* my_SASToken_Build(HMACSHA256_KEY_HANDLE key, const char* scope, const char* keyName, size_t expiry)
+{
+    char* result = (char*)malloc(64);
+    (void)key;
+    (void)scope;
+    (void)keyName;
+    (void)sprintf(result, "token%d-%lu", ++built_tokens, (unsigned long)expiry);
+    return result;
+}
+
+static STRING_HANDLE my_STRING_construct(const char* psz)
+{
+    (void)psz;
+    return TEST_STRING_HANDLE;
+}
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+    static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+    {
+        char temp_str[256];
+        (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+        ASSERT_FAIL(temp_str);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+static SASTOKEN_CACHE_HANDLE create_cache(void)
+{
+    SASTOKEN_CACHE_HANDLE result = SASTokenCache_Create(TEST_TOKEN_LIFETIME, TEST_RENEWAL_PERCENTAGE, TEST_MAX_ENTRIES);
+    ASSERT_IS_NOT_NULL(result);
+    return result;
+}
+
+static void setup_create_entry_expectations(const char* keyName)
+{
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_KEY));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_SCOPE));
+    if (keyName != NULL)
+    {
+        STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, keyName));
+    }
+    STRICT_EXPECTED_CALL(Base64_Decoder(TEST_KEY));
+    STRICT_EXPECTED_CALL(BUFFER_u_char(TEST_DECODED_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(BUFFER_length(TEST_DECODED_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(HMACSHA256_CreateKey(TEST_DECODED_KEY, sizeof(TEST_DECODED_KEY)));
+    STRICT_EXPECTED_CALL(BUFFER_delete(TEST_DECODED_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_LIST_HANDLE, IGNORED_PTR_ARG));
+}
+
+static void setup_new_entry_expectations(const char* keyName)
+{
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_LIST_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    setup_create_entry_expectations(keyName);
+}
+
+static void setup_destroy_entry_expectations(void)
+{
+    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_LIST_HANDLE, TEST_LIST_ITEM_HANDLE));
+    STRICT_EXPECTED_CALL(HMACSHA256_DestroyKey(TEST_HMAC_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+}
+
+/* creates a cache that is full once it holds one entry, and populates it with an entry whose token was built at TEST_START_TIME */
+static SASTOKEN_CACHE_HANDLE create_full_cache_with_token(void)
+{
+    SASTOKEN_CACHE_HANDLE result = SASTokenCache_Create(TEST_TOKEN_LIFETIME, TEST_RENEWAL_PERCENTAGE, 1);
+    STRING_HANDLE token;
+    ASSERT_IS_NOT_NULL(result);
+    current_time = TEST_START_TIME;
+    token = SASTokenCache_GetToken(result, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+    ASSERT_IS_NOT_NULL(token);
+    umock_c_reset_all_calls();
+    return result;
+}
+
+/* populates the cache with one entry whose token was built at TEST_START_TIME */
+static SASTOKEN_CACHE_HANDLE create_cache_with_token(void)
+{
+    SASTOKEN_CACHE_HANDLE result = create_cache();
+    STRING_HANDLE token;
+    current_time = TEST_START_TIME;
+    token = SASTokenCache_GetToken(result, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+    ASSERT_IS_NOT_NULL(token);
+    umock_c_reset_all_calls();
+    return result;
+}
+
+BEGIN_TEST_SUITE(sastoken_cache_unittests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    int result;
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    umock_c_init(on_umock_c_error);
+
+    result = umocktypes_charptr_register_types();
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    REGISTER_UMOCK_ALIAS_TYPE(time_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(time_t*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(size_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(SINGLYLINKEDLIST_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LIST_ITEM_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LIST_MATCH_FUNCTION, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(HMACSHA256_KEY_HANDLE, void*);
+    REGISTER_TYPE(LOCK_RESULT, LOCK_RESULT);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(gballoc_malloc, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+
+    REGISTER_GLOBAL_MOCK_RETURN(Lock_Init, TEST_LOCK_HANDLE);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Unlock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock_Deinit, LOCK_OK);
+
+    REGISTER_GLOBAL_MOCK_RETURN(singlylinkedlist_create, TEST_LIST_HANDLE);
+    REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_add, my_singlylinkedlist_add);
+    REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_item_get_value, my_singlylinkedlist_item_get_value);
+    REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_find, my_singlylinkedlist_find);
+    REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_get_head_item, my_singlylinkedlist_get_head_item);
+    REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_remove, my_singlylinkedlist_remove);
+
+    REGISTER_GLOBAL_MOCK_HOOK(get_time, my_get_time);
+    REGISTER_GLOBAL_MOCK_HOOK(get_difftime, my_get_difftime);
+    REGISTER_GLOBAL_MOCK_HOOK(mallocAndStrcpy_s, my_mallocAndStrcpy_s);
+
+    REGISTER_GLOBAL_MOCK_RETURN(Base64_Decoder, TEST_DECODED_KEY_HANDLE);
+    REGISTER_GLOBAL_MOCK_RETURN(BUFFER_u_char, TEST_DECODED_KEY);
+    REGISTER_GLOBAL_MOCK_RETURN(BUFFER_length, sizeof(TEST_DECODED_KEY));
+    REGISTER_GLOBAL_MOCK_RETURN(HMACSHA256_CreateKey, TEST_HMAC_KEY_HANDLE);
+    REGISTER_GLOBAL_MOCK_HOOK(SASToken_Build, my_SASToken_Build);
+    REGISTER_GLOBAL_MOCK_HOOK(STRING_construct, my_STRING_construct);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    current_time = TEST_START_TIME;
+    added_entry = NULL;
+    built_tokens = 0;
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* SASTokenCache_Create */
+
+/*Tests_SRS_SASTOKEN_CACHE_01_001: [ If tokenLifetime is 0, renewalPercentage is 0 or greater than 100, or maxEntries is 0, SASTokenCache_Create shall fail and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_Create_with_zero_lifetime_fails)
+{
+    // act
+    SASTOKEN_CACHE_HANDLE result = SASTokenCache_Create(0, TEST_RENEWAL_PERCENTAGE, TEST_MAX_ENTRIES);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_001: [ If tokenLifetime is 0, renewalPercentage is 0 or greater than 100, or maxEntries is 0, SASTokenCache_Create shall fail and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_Create_with_zero_renewal_percentage_fails)
+{
+    // act
+    SASTOKEN_CACHE_HANDLE result = SASTokenCache_Create(TEST_TOKEN_LIFETIME, 0, TEST_MAX_ENTRIES);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_001: [ If tokenLifetime is 0, renewalPercentage is 0 or greater than 100, or maxEntries is 0, SASTokenCache_Create shall fail and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_Create_with_zero_max_entries_fails)
+{
+    // act
+    SASTOKEN_CACHE_HANDLE result = SASTokenCache_Create(TEST_TOKEN_LIFETIME, TEST_RENEWAL_PERCENTAGE, 0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_001: [ If tokenLifetime is 0, renewalPercentage is 0 or greater than 100, or maxEntries is 0, SASTokenCache_Create shall fail and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_Create_with_renewal_percentage_above_100_fails)
+{
+    // act
+    SASTOKEN_CACHE_HANDLE result = SASTokenCache_Create(TEST_TOKEN_LIFETIME, 101, TEST_MAX_ENTRIES);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_002: [ SASTokenCache_Create shall allocate the cache, a lock by calling Lock_Init and an empty list of entries by calling singlylinkedlist_create. ]*/
+TEST_FUNCTION(SASTokenCache_Create_succeeds)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE result;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(Lock_Init());
+    STRICT_EXPECTED_CALL(singlylinkedlist_create());
+
+    // act
+    result = SASTokenCache_Create(TEST_TOKEN_LIFETIME, TEST_RENEWAL_PERCENTAGE, TEST_MAX_ENTRIES);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(result);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_003: [ If any of these fail, SASTokenCache_Create shall free what it allocated and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_Create_when_malloc_fails_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE result;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    // act
+    result = SASTokenCache_Create(TEST_TOKEN_LIFETIME, TEST_RENEWAL_PERCENTAGE, TEST_MAX_ENTRIES);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_003: [ If any of these fail, SASTokenCache_Create shall free what it allocated and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_Create_when_Lock_Init_fails_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE result;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(Lock_Init())
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = SASTokenCache_Create(TEST_TOKEN_LIFETIME, TEST_RENEWAL_PERCENTAGE, TEST_MAX_ENTRIES);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_003: [ If any of these fail, SASTokenCache_Create shall free what it allocated and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_Create_when_singlylinkedlist_create_fails_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE result;
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(Lock_Init());
+    STRICT_EXPECTED_CALL(singlylinkedlist_create())
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = SASTokenCache_Create(TEST_TOKEN_LIFETIME, TEST_RENEWAL_PERCENTAGE, TEST_MAX_ENTRIES);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* SASTokenCache_Destroy */
+
+/*Tests_SRS_SASTOKEN_CACHE_01_004: [ If cache is NULL, SASTokenCache_Destroy shall return. ]*/
+TEST_FUNCTION(SASTokenCache_Destroy_with_NULL_returns)
+{
+    // act
+    SASTokenCache_Destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_005: [ SASTokenCache_Destroy shall free every entry with its prepared key and token, the list, the lock and the cache. ]*/
+TEST_FUNCTION(SASTokenCache_Destroy_frees_entries)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache_with_token();
+    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_LIST_HANDLE));
+    STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(TEST_LIST_ITEM_HANDLE));
+    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_LIST_HANDLE, TEST_LIST_ITEM_HANDLE));
+    STRICT_EXPECTED_CALL(HMACSHA256_DestroyKey(TEST_HMAC_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_LIST_HANDLE));
+    STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_LIST_HANDLE));
+    STRICT_EXPECTED_CALL(Lock_Deinit(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    SASTokenCache_Destroy(cache);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* SASTokenCache_GetToken */
+
+/*Tests_SRS_SASTOKEN_CACHE_01_006: [ If cache, key or scope is NULL, SASTokenCache_GetToken shall fail and return NULL. keyName is optional. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_with_NULL_cache_fails)
+{
+    // act
+    STRING_HANDLE result = SASTokenCache_GetToken(NULL, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_006: [ If cache, key or scope is NULL, SASTokenCache_GetToken shall fail and return NULL. keyName is optional. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_with_NULL_key_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache();
+    STRING_HANDLE result;
+    umock_c_reset_all_calls();
+
+    // act
+    result = SASTokenCache_GetToken(cache, NULL, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_006: [ If cache, key or scope is NULL, SASTokenCache_GetToken shall fail and return NULL. keyName is optional. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_with_NULL_scope_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache();
+    STRING_HANDLE result;
+    umock_c_reset_all_calls();
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, NULL, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_008: [ If get_time fails, SASTokenCache_GetToken shall fail and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_when_get_time_fails_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache();
+    STRING_HANDLE result;
+    umock_c_reset_all_calls();
+    current_time = (time_t)-1;
+    STRICT_EXPECTED_CALL(get_time(NULL));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_009: [ The lookup, any renewal and the copy of the token shall be done while holding the cache lock. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_when_Lock_fails_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache();
+    STRING_HANDLE result;
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE))
+        .SetReturn(LOCK_ERROR);
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_007: [ SASTokenCache_GetToken shall obtain the current time by calling get_time. ]*/
+/*Tests_SRS_SASTOKEN_CACHE_01_009: [ The lookup, any renewal and the copy of the token shall be done while holding the cache lock. ]*/
+/*Tests_SRS_SASTOKEN_CACHE_01_010: [ SASTokenCache_GetToken shall look up the entry for (key, scope, keyName) by calling singlylinkedlist_find. ]*/
+/*Tests_SRS_SASTOKEN_CACHE_01_011: [ If there is no entry, SASTokenCache_GetToken shall create one and add it to the list by calling singlylinkedlist_add. ]*/
+/*Tests_SRS_SASTOKEN_CACHE_01_012: [ The key shall be decoded from base64 by calling Base64_Decoder and prepared once for signing by calling HMACSHA256_CreateKey. ]*/
+/*Tests_SRS_SASTOKEN_CACHE_01_014: [ If the entry has no token or the renewal point of its token has passed, SASTokenCache_GetToken shall build a new token expiring tokenLifetime seconds from now by calling SASToken_Build. ]*/
+/*Tests_SRS_SASTOKEN_CACHE_01_017: [ SASTokenCache_GetToken shall return a copy of the token created by calling STRING_construct. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_first_request_builds_the_token)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache();
+    STRING_HANDLE result;
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(TEST_START_TIME, 0));
+    setup_new_entry_expectations(TEST_KEY_NAME);
+    STRICT_EXPECTED_CALL(SASToken_Build(TEST_HMAC_KEY_HANDLE, TEST_SCOPE, TEST_KEY_NAME, TEST_START_TIME + TEST_TOKEN_LIFETIME));
+    STRICT_EXPECTED_CALL(gballoc_free(NULL));
+    STRICT_EXPECTED_CALL(STRING_construct("token1-4600"));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_STRING_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_006: [ If cache, key or scope is NULL, SASTokenCache_GetToken shall fail and return NULL. keyName is optional. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_with_NULL_keyName_succeeds)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache();
+    STRING_HANDLE result;
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(TEST_START_TIME, 0));
+    setup_new_entry_expectations(NULL);
+    STRICT_EXPECTED_CALL(SASToken_Build(TEST_HMAC_KEY_HANDLE, TEST_SCOPE, NULL, TEST_START_TIME + TEST_TOKEN_LIFETIME));
+    STRICT_EXPECTED_CALL(gballoc_free(NULL));
+    STRICT_EXPECTED_CALL(STRING_construct("token1-4600"));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_STRING_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_014: [ If the entry has no token or the renewal point of its token has passed, SASTokenCache_GetToken shall build a new token expiring tokenLifetime seconds from now by calling SASToken_Build. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_before_the_renewal_point_returns_the_cached_token)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache_with_token();
+    STRING_HANDLE result;
+    current_time = TEST_START_TIME + (TEST_TOKEN_LIFETIME * TEST_RENEWAL_PERCENTAGE / 100) - 1;
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(current_time, 0));
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_LIST_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(TEST_LIST_ITEM_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_construct("token1-4600"));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_STRING_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_014: [ If the entry has no token or the renewal point of its token has passed, SASTokenCache_GetToken shall build a new token expiring tokenLifetime seconds from now by calling SASToken_Build. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_after_the_renewal_point_renews_the_token)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache_with_token();
+    STRING_HANDLE result;
+    current_time = TEST_START_TIME + (TEST_TOKEN_LIFETIME * TEST_RENEWAL_PERCENTAGE / 100);
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(current_time, 0));
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_LIST_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(TEST_LIST_ITEM_HANDLE));
+    STRICT_EXPECTED_CALL(SASToken_Build(TEST_HMAC_KEY_HANDLE, TEST_SCOPE, TEST_KEY_NAME, current_time + TEST_TOKEN_LIFETIME));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_construct("token2-7480"));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_STRING_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_015: [ If SASToken_Build fails, SASTokenCache_GetToken shall keep returning the previous token until it expires. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_when_renewal_fails_returns_the_unexpired_token)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache_with_token();
+    STRING_HANDLE result;
+    current_time = TEST_START_TIME + TEST_TOKEN_LIFETIME - 1;
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(current_time, 0));
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_LIST_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(TEST_LIST_ITEM_HANDLE));
+    STRICT_EXPECTED_CALL(SASToken_Build(TEST_HMAC_KEY_HANDLE, TEST_SCOPE, TEST_KEY_NAME, current_time + TEST_TOKEN_LIFETIME))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(STRING_construct("token1-4600"));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_STRING_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_016: [ If there is no unexpired token, SASTokenCache_GetToken shall fail and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_when_renewal_fails_after_expiry_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache_with_token();
+    STRING_HANDLE result;
+    current_time = TEST_START_TIME + TEST_TOKEN_LIFETIME;
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(current_time, 0));
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_LIST_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(TEST_LIST_ITEM_HANDLE));
+    STRICT_EXPECTED_CALL(SASToken_Build(TEST_HMAC_KEY_HANDLE, TEST_SCOPE, TEST_KEY_NAME, current_time + TEST_TOKEN_LIFETIME))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_013: [ If creating or adding the entry fails, SASTokenCache_GetToken shall fail and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_when_Base64_Decoder_fails_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache();
+    STRING_HANDLE result;
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(TEST_START_TIME, 0));
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_LIST_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_KEY));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_SCOPE));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_KEY_NAME));
+    STRICT_EXPECTED_CALL(Base64_Decoder(TEST_KEY))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(NULL));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_013: [ If creating or adding the entry fails, SASTokenCache_GetToken shall fail and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_when_HMACSHA256_CreateKey_fails_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache();
+    STRING_HANDLE result;
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(TEST_START_TIME, 0));
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_LIST_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_KEY));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_SCOPE));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_KEY_NAME));
+    STRICT_EXPECTED_CALL(Base64_Decoder(TEST_KEY));
+    STRICT_EXPECTED_CALL(BUFFER_u_char(TEST_DECODED_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(BUFFER_length(TEST_DECODED_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(HMACSHA256_CreateKey(TEST_DECODED_KEY, sizeof(TEST_DECODED_KEY)))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(NULL));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(BUFFER_delete(TEST_DECODED_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_013: [ If creating or adding the entry fails, SASTokenCache_GetToken shall fail and return NULL. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_when_singlylinkedlist_add_fails_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache();
+    STRING_HANDLE result;
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(TEST_START_TIME, 0));
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_LIST_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_KEY));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_SCOPE));
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, TEST_KEY_NAME));
+    STRICT_EXPECTED_CALL(Base64_Decoder(TEST_KEY));
+    STRICT_EXPECTED_CALL(BUFFER_u_char(TEST_DECODED_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(BUFFER_length(TEST_DECODED_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(HMACSHA256_CreateKey(TEST_DECODED_KEY, sizeof(TEST_DECODED_KEY)));
+    STRICT_EXPECTED_CALL(BUFFER_delete(TEST_DECODED_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(singlylinkedlist_add(TEST_LIST_HANDLE, IGNORED_PTR_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(HMACSHA256_DestroyKey(TEST_HMAC_KEY_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(NULL));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    added_entry = NULL;
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_017: [ SASTokenCache_GetToken shall return a copy of the token created by calling STRING_construct. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_when_STRING_construct_fails_fails)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_cache_with_token();
+    STRING_HANDLE result;
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(TEST_START_TIME, 0));
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_LIST_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(TEST_LIST_ITEM_HANDLE));
+    STRICT_EXPECTED_CALL(STRING_construct("token1-4600"))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_019: [ If there is no entry and the cache already holds maxEntries entries, SASTokenCache_GetToken shall remove and free every entry that has no unexpired token. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_on_a_full_cache_evicts_the_expired_entries)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_full_cache_with_token();
+    STRING_HANDLE result;
+    current_time = TEST_START_TIME + TEST_TOKEN_LIFETIME;
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(current_time, 0));
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_LIST_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_LIST_HANDLE));
+    STRICT_EXPECTED_CALL(singlylinkedlist_get_next_item(TEST_LIST_ITEM_HANDLE));
+    STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(TEST_LIST_ITEM_HANDLE));
+    setup_destroy_entry_expectations();
+    setup_create_entry_expectations(TEST_KEY_NAME);
+    STRICT_EXPECTED_CALL(SASToken_Build(TEST_HMAC_KEY_HANDLE, TEST_SCOPE, TEST_KEY_NAME, current_time + TEST_TOKEN_LIFETIME));
+    STRICT_EXPECTED_CALL(gballoc_free(NULL));
+    STRICT_EXPECTED_CALL(STRING_construct("token2-8200"));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_STRING_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+/*Tests_SRS_SASTOKEN_CACHE_01_020: [ If the cache is still full, SASTokenCache_GetToken shall remove and free the least recently requested entry. ]*/
+TEST_FUNCTION(SASTokenCache_GetToken_on_a_full_cache_without_expired_entries_evicts_the_least_recently_used_entry)
+{
+    // arrange
+    SASTOKEN_CACHE_HANDLE cache = create_full_cache_with_token();
+    STRING_HANDLE result;
+    current_time = TEST_START_TIME + 1;
+    STRICT_EXPECTED_CALL(get_time(NULL));
+    STRICT_EXPECTED_CALL(Lock(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(get_difftime(current_time, 0));
+    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_LIST_HANDLE, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_LIST_HANDLE));
+    STRICT_EXPECTED_CALL(singlylinkedlist_get_next_item(TEST_LIST_ITEM_HANDLE));
+    STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(TEST_LIST_ITEM_HANDLE));
+    STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(TEST_LIST_ITEM_HANDLE));
+    setup_destroy_entry_expectations();
+    setup_create_entry_expectations(TEST_KEY_NAME);
+    STRICT_EXPECTED_CALL(SASToken_Build(TEST_HMAC_KEY_HANDLE, TEST_SCOPE, TEST_KEY_NAME, current_time + TEST_TOKEN_LIFETIME));
+    STRICT_EXPECTED_CALL(gballoc_free(NULL));
+    STRICT_EXPECTED_CALL(STRING_construct("token2-4601"));
+    STRICT_EXPECTED_CALL(Unlock(TEST_LOCK_HANDLE));
+
+    // act
+    result = SASTokenCache_GetToken(cache, TEST_KEY, TEST_SCOPE, TEST_KEY_NAME);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_STRING_HANDLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    SASTokenCache_Destroy(cache);
+}
+
+END_TEST_SUITE(sastoken_cache_unittests)
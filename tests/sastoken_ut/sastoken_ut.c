@@ -3,13 +3,16 @@
 
 #ifdef __cplusplus
 #include <cstdlib>
+#include <cstring>
 #else
 #include <stdlib.h>
+#include <string.h>
 #endif
 
 static void* my_gballoc_malloc(size_t size)
 {
-    return malloc(size);
+    /* zeroed so that char* out arguments recorded by umock_c are always terminated */
+    return calloc(1, size);
 }
 
 static void my_gballoc_free(void* ptr)
@@ -78,6 +81,36 @@ STRING_HANDLE my_URL_Encode(STRING_HANDLE input)
     return (STRING_HANDLE)malloc(1);
 }
 
+static char hashed_payload[64];
+
+HMACSHA256_RESULT my_HMACSHA256_ComputeHashWithKeyInto(HMACSHA256_KEY_HANDLE key, const unsigned char* payload, size_t payloadLen, unsigned char* hash)
+{
+    (void)key;
+    (void)memset(hashed_payload, 0, sizeof(hashed_payload));
+    (void)memcpy(hashed_payload, payload, payloadLen < sizeof(hashed_payload) ? payloadLen : sizeof(hashed_payload) - 1);
+    (void)memset(hash, 0, HMACSHA256_HASH_SIZE);
+    return HMACSHA256_OK;
+}
+
+int my_Base64_Encode_Into(const unsigned char* source, size_t size, char* destination, size_t destinationSize)
+{
+    (void)source;
+    (void)size;
+    (void)destinationSize;
+    (void)strcpy(destination, "AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA+=");
+    return 0;
+}
+
+int my_URL_EncodeInto(const char* text, size_t textLength, char* destination, size_t destinationSize, size_t* encodedLength)
+{
+    (void)text;
+    (void)textLength;
+    (void)destinationSize;
+    (void)strcpy(destination, "SIG%2b%3d");
+    *encodedLength = 9;
+    return 0;
+}
+
 #include "azure_c_shared_utility/sastoken.h"
 
 #define TEST_STRING_HANDLE (STRING_HANDLE)0x46
@@ -93,6 +126,7 @@ STRING_HANDLE my_URL_Encode(STRING_HANDLE input)
 #define TEST_BASE64SIGNATURE_HANDLE (STRING_HANDLE)0x54
 #define TEST_URLENCODEDSIGNATURE_HANDLE (STRING_HANDLE)0x55
 #define TEST_DECODEDKEY_HANDLE (BUFFER_HANDLE)0x56
+#define TEST_HMAC_KEY_HANDLE (HMACSHA256_KEY_HANDLE)0x57
 #define TEST_TIME_T ((time_t)3600)
 #define TEST_PTR_DECODEDKEY (unsigned char*)0x123
 #define TEST_LENGTH_DECODEDKEY (size_t)32
@@ -145,6 +179,7 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_UMOCK_ALIAS_TYPE(size_t, unsigned int);
     REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(HMACSHA256_KEY_HANDLE, void*);
 
     result = umocktypes_charptr_register_types();
     ASSERT_ARE_EQUAL(int, 0, result);
@@ -170,6 +205,9 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_HOOK(URL_Encode, my_URL_Encode);
     REGISTER_GLOBAL_MOCK_RETURN(HMACSHA256_ComputeHash, HMACSHA256_OK);
     REGISTER_GLOBAL_MOCK_RETURN(size_tToString, 0);
+    REGISTER_GLOBAL_MOCK_HOOK(HMACSHA256_ComputeHashWithKeyInto, my_HMACSHA256_ComputeHashWithKeyInto);
+    REGISTER_GLOBAL_MOCK_HOOK(Base64_Encode_Into, my_Base64_Encode_Into);
+    REGISTER_GLOBAL_MOCK_HOOK(URL_EncodeInto, my_URL_EncodeInto);
 
     REGISTER_GLOBAL_MOCK_RETURN(get_time, TEST_TIME_T);
     REGISTER_GLOBAL_MOCK_HOOK(get_difftime, my_get_difftime);
@@ -1798,4 +1836,166 @@ TEST_FUNCTION(SASToken_CreateString_succeeds)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+/* SASToken_Build */
+
+/*Tests_SRS_SASTOKEN_01_001: [ If key or scope is NULL, SASToken_Build shall fail and return NULL. ]*/
+TEST_FUNCTION(SASToken_Build_with_NULL_key_fails)
+{
+    // act
+    char* result = SASToken_Build(NULL, "scope", "name", TEST_EXPIRY);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_01_001: [ If key or scope is NULL, SASToken_Build shall fail and return NULL. ]*/
+TEST_FUNCTION(SASToken_Build_with_NULL_scope_fails)
+{
+    // act
+    char* result = SASToken_Build(TEST_HMAC_KEY_HANDLE, NULL, "name", TEST_EXPIRY);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_01_002: [ SASToken_Build shall convert expiry to a string by calling size_tToString. ]*/
+/*Tests_SRS_SASTOKEN_01_004: [ SASToken_Build shall allocate a single buffer large enough for the token with the longest possible signature. ]*/
+/*Tests_SRS_SASTOKEN_01_006: [ SASToken_Build shall compute the HMAC-SHA256 of scope, "\n" and the expiry string by calling HMACSHA256_ComputeHashWithKeyInto. ]*/
+/*Tests_SRS_SASTOKEN_01_007: [ The hash shall be base64 encoded by calling Base64_Encode_Into and the result URL encoded in place in the token by calling URL_EncodeInto. ]*/
+/*Tests_SRS_SASTOKEN_01_009: [ The token shall be "SharedAccessSignature sr=<scope>&sig=<signature>&se=<expiry>", followed by "&skn=<keyName>" when keyName is not NULL. ]*/
+TEST_FUNCTION(SASToken_Build_without_keyName_succeeds)
+{
+    // arrange
+    char* result;
+    STRICT_EXPECTED_CALL(size_tToString(IGNORED_PTR_ARG, IGNORED_NUM_ARG, TEST_EXPIRY)).CopyOutArgumentBuffer(1, TEST_TOKEN_EXPIRATION_TIME, sizeof(TEST_TOKEN_EXPIRATION_TIME));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(HMACSHA256_ComputeHashWithKeyInto(TEST_HMAC_KEY_HANDLE, IGNORED_PTR_ARG, 10, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Base64_Encode_Into(IGNORED_PTR_ARG, HMACSHA256_HASH_SIZE, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(URL_EncodeInto(IGNORED_PTR_ARG, 44, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
+
+    // act
+    result = SASToken_Build(TEST_HMAC_KEY_HANDLE, "scope", NULL, TEST_EXPIRY);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "scope\n7200", hashed_payload);
+    ASSERT_ARE_EQUAL(char_ptr, "SharedAccessSignature sr=scope&sig=SIG%2b%3d&se=7200", result);
+
+    // cleanup
+    free(result);
+}
+
+/*Tests_SRS_SASTOKEN_01_009: [ The token shall be "SharedAccessSignature sr=<scope>&sig=<signature>&se=<expiry>", followed by "&skn=<keyName>" when keyName is not NULL. ]*/
+TEST_FUNCTION(SASToken_Build_with_keyName_succeeds)
+{
+    // arrange
+    char* result;
+    STRICT_EXPECTED_CALL(size_tToString(IGNORED_PTR_ARG, IGNORED_NUM_ARG, TEST_EXPIRY)).CopyOutArgumentBuffer(1, TEST_TOKEN_EXPIRATION_TIME, sizeof(TEST_TOKEN_EXPIRATION_TIME));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(HMACSHA256_ComputeHashWithKeyInto(TEST_HMAC_KEY_HANDLE, IGNORED_PTR_ARG, 15, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Base64_Encode_Into(IGNORED_PTR_ARG, HMACSHA256_HASH_SIZE, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(URL_EncodeInto(IGNORED_PTR_ARG, 44, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
+
+    // act
+    result = SASToken_Build(TEST_HMAC_KEY_HANDLE, "myhub/dev1", "owner", TEST_EXPIRY);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(char_ptr, "myhub/dev1\n7200", hashed_payload);
+    ASSERT_ARE_EQUAL(char_ptr, "SharedAccessSignature sr=myhub/dev1&sig=SIG%2b%3d&se=7200&skn=owner", result);
+
+    // cleanup
+    free(result);
+}
+
+/*Tests_SRS_SASTOKEN_01_003: [ If size_tToString fails, SASToken_Build shall fail and return NULL. ]*/
+TEST_FUNCTION(SASToken_Build_when_size_tToString_fails_fails)
+{
+    // arrange
+    char* result;
+    STRICT_EXPECTED_CALL(size_tToString(IGNORED_PTR_ARG, IGNORED_NUM_ARG, TEST_EXPIRY)).SetReturn(1);
+
+    // act
+    result = SASToken_Build(TEST_HMAC_KEY_HANDLE, "scope", NULL, TEST_EXPIRY);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_01_005: [ If allocating the buffer fails, SASToken_Build shall fail and return NULL. ]*/
+TEST_FUNCTION(SASToken_Build_when_malloc_fails_fails)
+{
+    // arrange
+    char* result;
+    STRICT_EXPECTED_CALL(size_tToString(IGNORED_PTR_ARG, IGNORED_NUM_ARG, TEST_EXPIRY)).CopyOutArgumentBuffer(1, TEST_TOKEN_EXPIRATION_TIME, sizeof(TEST_TOKEN_EXPIRATION_TIME));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)).SetReturn(NULL);
+
+    // act
+    result = SASToken_Build(TEST_HMAC_KEY_HANDLE, "scope", NULL, TEST_EXPIRY);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_01_008: [ If computing, encoding or URL encoding the signature fails, SASToken_Build shall free the buffer and return NULL. ]*/
+TEST_FUNCTION(SASToken_Build_when_HMAC_fails_fails)
+{
+    // arrange
+    char* result;
+    STRICT_EXPECTED_CALL(size_tToString(IGNORED_PTR_ARG, IGNORED_NUM_ARG, TEST_EXPIRY)).CopyOutArgumentBuffer(1, TEST_TOKEN_EXPIRATION_TIME, sizeof(TEST_TOKEN_EXPIRATION_TIME));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(HMACSHA256_ComputeHashWithKeyInto(TEST_HMAC_KEY_HANDLE, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetReturn(HMACSHA256_ERROR);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = SASToken_Build(TEST_HMAC_KEY_HANDLE, "scope", NULL, TEST_EXPIRY);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_01_008: [ If computing, encoding or URL encoding the signature fails, SASToken_Build shall free the buffer and return NULL. ]*/
+TEST_FUNCTION(SASToken_Build_when_Base64_Encode_Into_fails_fails)
+{
+    // arrange
+    char* result;
+    STRICT_EXPECTED_CALL(size_tToString(IGNORED_PTR_ARG, IGNORED_NUM_ARG, TEST_EXPIRY)).CopyOutArgumentBuffer(1, TEST_TOKEN_EXPIRATION_TIME, sizeof(TEST_TOKEN_EXPIRATION_TIME));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(HMACSHA256_ComputeHashWithKeyInto(TEST_HMAC_KEY_HANDLE, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Base64_Encode_Into(IGNORED_PTR_ARG, HMACSHA256_HASH_SIZE, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(1);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = SASToken_Build(TEST_HMAC_KEY_HANDLE, "scope", NULL, TEST_EXPIRY);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SASTOKEN_01_008: [ If computing, encoding or URL encoding the signature fails, SASToken_Build shall free the buffer and return NULL. ]*/
+TEST_FUNCTION(SASToken_Build_when_URL_EncodeInto_fails_fails)
+{
+    // arrange
+    char* result;
+    STRICT_EXPECTED_CALL(size_tToString(IGNORED_PTR_ARG, IGNORED_NUM_ARG, TEST_EXPIRY)).CopyOutArgumentBuffer(1, TEST_TOKEN_EXPIRATION_TIME, sizeof(TEST_TOKEN_EXPIRATION_TIME));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(HMACSHA256_ComputeHashWithKeyInto(TEST_HMAC_KEY_HANDLE, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Base64_Encode_Into(IGNORED_PTR_ARG, HMACSHA256_HASH_SIZE, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(URL_EncodeInto(IGNORED_PTR_ARG, 44, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetReturn(1);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    result = SASToken_Build(TEST_HMAC_KEY_HANDLE, "scope", NULL, TEST_EXPIRY);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(sastoken_unittests)
@@ -0,0 +1,384 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+
+static void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/gballoc.h"
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/spsc_ring.h"
+#include "azure_c_shared_utility/threadapi.h"
+
+#define TEST_TRANSFER_COUNT     1000000
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static int producer_thread(void* context)
+{
+    SPSC_RING_HANDLE ring = (SPSC_RING_HANDLE)context;
+    uintptr_t i;
+
+    for (i = 1; i <= TEST_TRANSFER_COUNT; i++)
+    {
+        while (spsc_ring_push(ring, (void*)i) != 0)
+        {
+            ThreadAPI_Sleep(0);
+        }
+    }
+
+    return 0;
+}
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(spsc_ring_unittests)
+
+TEST_SUITE_INITIALIZE(TestSuiteInitialize)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    umock_c_init(on_umock_c_error);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(f)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(cleans)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* spsc_ring_create */
+
+/*Tests_SRS_SPSC_RING_01_001: [ If capacity is 0 or too large for the items to be allocated, spsc_ring_create shall fail and return NULL. ]*/
+TEST_FUNCTION(spsc_ring_create_with_0_capacity_fails)
+{
+    //act
+    SPSC_RING_HANDLE ring = spsc_ring_create(0);
+
+    //assert
+    ASSERT_IS_NULL(ring);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SPSC_RING_01_001: [ If capacity is 0 or too large for the items to be allocated, spsc_ring_create shall fail and return NULL. ]*/
+TEST_FUNCTION(spsc_ring_create_with_a_too_large_capacity_fails)
+{
+    //act
+    SPSC_RING_HANDLE ring = spsc_ring_create(SIZE_MAX / 2);
+
+    //assert
+    ASSERT_IS_NULL(ring);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SPSC_RING_01_002: [ spsc_ring_create shall allocate a ring with room for capacity items rounded up to a power of 2. ]*/
+TEST_FUNCTION(spsc_ring_create_succeeds)
+{
+    //arrange
+    SPSC_RING_HANDLE ring;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(8 * sizeof(void*)));
+
+    //act
+    ring = spsc_ring_create(5);
+
+    //assert
+    ASSERT_IS_NOT_NULL(ring);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, spsc_ring_get_count(ring));
+
+    //cleanup
+    spsc_ring_destroy(ring);
+}
+
+/*Tests_SRS_SPSC_RING_01_003: [ If any allocation fails, spsc_ring_create shall free what it allocated and return NULL. ]*/
+TEST_FUNCTION(when_allocating_the_ring_fails_spsc_ring_create_fails)
+{
+    //arrange
+    SPSC_RING_HANDLE ring;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    ring = spsc_ring_create(8);
+
+    //assert
+    ASSERT_IS_NULL(ring);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SPSC_RING_01_003: [ If any allocation fails, spsc_ring_create shall free what it allocated and return NULL. ]*/
+TEST_FUNCTION(when_allocating_the_items_fails_spsc_ring_create_fails)
+{
+    //arrange
+    SPSC_RING_HANDLE ring;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    //act
+    ring = spsc_ring_create(8);
+
+    //assert
+    ASSERT_IS_NULL(ring);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* spsc_ring_destroy */
+
+/*Tests_SRS_SPSC_RING_01_004: [ If ring is NULL, spsc_ring_destroy shall return. ]*/
+TEST_FUNCTION(spsc_ring_destroy_with_NULL_returns)
+{
+    //act
+    spsc_ring_destroy(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SPSC_RING_01_005: [ spsc_ring_destroy shall free the ring without touching the items left in it. ]*/
+TEST_FUNCTION(spsc_ring_destroy_frees_the_ring)
+{
+    //arrange
+    SPSC_RING_HANDLE ring = spsc_ring_create(4);
+    ASSERT_ARE_EQUAL(int, 0, spsc_ring_push(ring, (void*)0x42));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    //act
+    spsc_ring_destroy(ring);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* spsc_ring_push */
+
+/*Tests_SRS_SPSC_RING_01_006: [ If ring is NULL, spsc_ring_push shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(spsc_ring_push_with_NULL_ring_fails)
+{
+    //act
+    int result = spsc_ring_push(NULL, (void*)0x42);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_SPSC_RING_01_007: [ If the ring is full, spsc_ring_push shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(spsc_ring_push_on_a_full_ring_fails)
+{
+    //arrange
+    SPSC_RING_HANDLE ring = spsc_ring_create(3);
+    uintptr_t i;
+    int result;
+    for (i = 1; i <= 4; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, spsc_ring_push(ring, (void*)i));
+    }
+    umock_c_reset_all_calls();
+
+    //act
+    result = spsc_ring_push(ring, (void*)0x42);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 4, spsc_ring_get_count(ring));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    spsc_ring_destroy(ring);
+}
+
+/*Tests_SRS_SPSC_RING_01_008: [ spsc_ring_push shall store item in the slot after the last item and then publish it with a release store of the tail index, and return 0. ]*/
+/*Tests_SRS_SPSC_RING_01_011: [ spsc_ring_pop shall take the oldest item, release its slot with a release store of the head index, and return 0. ]*/
+TEST_FUNCTION(items_are_popped_in_push_order_across_the_end_of_the_ring)
+{
+    //arrange
+    SPSC_RING_HANDLE ring = spsc_ring_create(4);
+    uintptr_t i;
+    umock_c_reset_all_calls();
+
+    //act
+    //assert
+    for (i = 1; i <= 100; i++)
+    {
+        void* item;
+        ASSERT_ARE_EQUAL(int, 0, spsc_ring_push(ring, (void*)i));
+        ASSERT_ARE_EQUAL(int, 0, spsc_ring_push(ring, (void*)(i + 1000)));
+        ASSERT_ARE_EQUAL(int, 0, spsc_ring_pop(ring, &item));
+        ASSERT_ARE_EQUAL(void_ptr, (void*)i, item);
+        ASSERT_ARE_EQUAL(int, 0, spsc_ring_pop(ring, &item));
+        ASSERT_ARE_EQUAL(void_ptr, (void*)(i + 1000), item);
+    }
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    spsc_ring_destroy(ring);
+}
+
+/* spsc_ring_pop */
+
+/*Tests_SRS_SPSC_RING_01_009: [ If ring or item is NULL, spsc_ring_pop shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(spsc_ring_pop_with_invalid_arguments_fails)
+{
+    //arrange
+    SPSC_RING_HANDLE ring = spsc_ring_create(4);
+    void* item;
+    ASSERT_ARE_EQUAL(int, 0, spsc_ring_push(ring, (void*)0x42));
+
+    //act
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, spsc_ring_pop(NULL, &item));
+    ASSERT_ARE_NOT_EQUAL(int, 0, spsc_ring_pop(ring, NULL));
+    ASSERT_ARE_EQUAL(size_t, 1, spsc_ring_get_count(ring));
+
+    //cleanup
+    spsc_ring_destroy(ring);
+}
+
+/*Tests_SRS_SPSC_RING_01_010: [ If the ring is empty, spsc_ring_pop shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(spsc_ring_pop_on_an_empty_ring_fails)
+{
+    //arrange
+    SPSC_RING_HANDLE ring = spsc_ring_create(4);
+    void* item;
+    ASSERT_ARE_EQUAL(int, 0, spsc_ring_push(ring, (void*)0x42));
+    ASSERT_ARE_EQUAL(int, 0, spsc_ring_pop(ring, &item));
+
+    //act
+    int result = spsc_ring_pop(ring, &item);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    //cleanup
+    spsc_ring_destroy(ring);
+}
+
+/*Tests_SRS_SPSC_RING_01_008: [ spsc_ring_push shall store item in the slot after the last item and then publish it with a release store of the tail index, and return 0. ]*/
+/*Tests_SRS_SPSC_RING_01_011: [ spsc_ring_pop shall take the oldest item, release its slot with a release store of the head index, and return 0. ]*/
+TEST_FUNCTION(a_producer_thread_hands_items_to_a_consumer_thread_in_order)
+{
+    //arrange
+    SPSC_RING_HANDLE ring = spsc_ring_create(256);
+    THREAD_HANDLE producer;
+    uintptr_t expected = 1;
+    int thread_result;
+    ASSERT_IS_NOT_NULL(ring);
+    ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&producer, producer_thread, ring));
+
+    //act
+    while (expected <= TEST_TRANSFER_COUNT)
+    {
+        void* item;
+        if (spsc_ring_pop(ring, &item) != 0)
+        {
+            ThreadAPI_Sleep(0);
+        }
+        else
+        {
+            ASSERT_ARE_EQUAL(void_ptr, (void*)expected, item);
+            expected++;
+        }
+    }
+
+    //assert
+    ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Join(producer, &thread_result));
+    ASSERT_ARE_EQUAL(size_t, 0, spsc_ring_get_count(ring));
+
+    //cleanup
+    spsc_ring_destroy(ring);
+}
+
+/* spsc_ring_get_count */
+
+/*Tests_SRS_SPSC_RING_01_012: [ If ring is NULL, spsc_ring_get_count shall return 0. ]*/
+TEST_FUNCTION(spsc_ring_get_count_with_NULL_returns_0)
+{
+    //act
+    size_t count = spsc_ring_get_count(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 0, count);
+}
+
+/*Tests_SRS_SPSC_RING_01_013: [ spsc_ring_get_count shall return the number of items pushed and not yet popped. ]*/
+TEST_FUNCTION(spsc_ring_get_count_counts_the_items_in_the_ring)
+{
+    //arrange
+    SPSC_RING_HANDLE ring = spsc_ring_create(4);
+    void* item;
+    ASSERT_ARE_EQUAL(int, 0, spsc_ring_push(ring, (void*)1));
+    ASSERT_ARE_EQUAL(int, 0, spsc_ring_push(ring, (void*)2));
+    ASSERT_ARE_EQUAL(int, 0, spsc_ring_push(ring, (void*)3));
+    ASSERT_ARE_EQUAL(int, 0, spsc_ring_pop(ring, &item));
+
+    //act
+    size_t count = spsc_ring_get_count(ring);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 2, count);
+
+    //cleanup
+    spsc_ring_destroy(ring);
+}
+
+END_TEST_SUITE(spsc_ring_unittests)
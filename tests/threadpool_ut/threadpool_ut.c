@@ -0,0 +1,714 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+
+/*the pool runs on real threads, locks and conditions; only the allocations are mocked so that they can be made to fail*/
+static size_t malloc_call_count;
+static size_t malloc_fail_index;
+
+static void* my_gballoc_malloc(size_t size)
+{
+    void* result;
+
+    if (malloc_call_count++ == malloc_fail_index)
+    {
+        result = NULL;
+    }
+    else
+    {
+        result = malloc(size);
+    }
+
+    return result;
+}
+
+static void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/gballoc.h"
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/threadpool.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/threadapi.h"
+
+#define TEST_WAIT_MS            5000
+#define TEST_BLOCK_MS           1000
+#define TEST_WORK_ITEM_COUNT    1000
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+/*state shared by the work items of a test and the test itself*/
+typedef struct TEST_STATE_TAG
+{
+    LOCK_HANDLE lock;
+    COND_HANDLE changed;
+    THREADPOOL_HANDLE threadpool;
+    THREADPOOL_TIMER_HANDLE timer;
+    size_t run_count;
+    size_t started_count;
+    size_t running_count;
+    size_t max_running_count;
+    size_t block_until_running;
+    int schedule_result;
+} TEST_STATE;
+
+static TEST_STATE test_state;
+
+static void count_work(void* context)
+{
+    TEST_STATE* state = (TEST_STATE*)context;
+
+    (void)Lock(state->lock);
+    state->run_count++;
+    (void)Condition_Post(state->changed);
+    (void)Unlock(state->lock);
+}
+
+static void schedule_children_work(void* context)
+{
+    TEST_STATE* state = (TEST_STATE*)context;
+    size_t i;
+
+    for (i = 0; i < 100; i++)
+    {
+        if (threadpool_schedule(state->threadpool, count_work, state) != 0)
+        {
+            state->schedule_result = 1;
+        }
+    }
+    count_work(state);
+}
+
+/*stays running until block_until_running items have started, or TEST_BLOCK_MS went by*/
+static void blocking_work(void* context)
+{
+    TEST_STATE* state = (TEST_STATE*)context;
+    int waits = 0;
+
+    (void)Lock(state->lock);
+    state->started_count++;
+    state->running_count++;
+    if (state->running_count > state->max_running_count)
+    {
+        state->max_running_count = state->running_count;
+    }
+    (void)Condition_Post(state->changed);
+    while ((state->started_count < state->block_until_running) && (waits++ < TEST_BLOCK_MS / 10))
+    {
+        (void)Condition_Wait(state->changed, state->lock, 10);
+    }
+    state->running_count--;
+    state->run_count++;
+    (void)Unlock(state->lock);
+}
+
+static void schedule_late_work(void* context)
+{
+    TEST_STATE* state = (TEST_STATE*)context;
+
+    /*give threadpool_destroy time to start*/
+    ThreadAPI_Sleep(200);
+    state->schedule_result = threadpool_schedule(state->threadpool, count_work, state);
+}
+
+static void cancel_own_timer_work(void* context)
+{
+    TEST_STATE* state = (TEST_STATE*)context;
+    THREADPOOL_TIMER_HANDLE timer;
+
+    (void)Lock(state->lock);
+    timer = state->timer;
+    (void)Unlock(state->lock);
+
+    threadpool_timer_cancel(timer);
+    count_work(state);
+}
+
+/*waits until run_count reaches count, returns the run count*/
+static size_t wait_for_run_count(TEST_STATE* state, size_t count)
+{
+    size_t result;
+    int waits = 0;
+
+    (void)Lock(state->lock);
+    while ((state->run_count < count) && (waits++ < TEST_WAIT_MS / 10))
+    {
+        (void)Condition_Wait(state->changed, state->lock, 10);
+    }
+    result = state->run_count;
+    (void)Unlock(state->lock);
+
+    return result;
+}
+
+static size_t get_run_count(TEST_STATE* state)
+{
+    size_t result;
+
+    (void)Lock(state->lock);
+    result = state->run_count;
+    (void)Unlock(state->lock);
+
+    return result;
+}
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(threadpool_unittests)
+
+TEST_SUITE_INITIALIZE(TestSuiteInitialize)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    umock_c_init(on_umock_c_error);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(f)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    malloc_call_count = 0;
+    malloc_fail_index = SIZE_MAX;
+
+    test_state.lock = Lock_Init();
+    ASSERT_IS_NOT_NULL(test_state.lock);
+    test_state.changed = Condition_Init();
+    ASSERT_IS_NOT_NULL(test_state.changed);
+    test_state.threadpool = NULL;
+    test_state.timer = NULL;
+    test_state.run_count = 0;
+    test_state.started_count = 0;
+    test_state.running_count = 0;
+    test_state.max_running_count = 0;
+    test_state.block_until_running = 0;
+    test_state.schedule_result = 0;
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(cleans)
+{
+    Condition_Deinit(test_state.changed);
+    (void)Lock_Deinit(test_state.lock);
+
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* threadpool_create */
+
+/*Tests_SRS_THREADPOOL_01_001: [ If min_threads is 0 or max_threads is smaller than min_threads, threadpool_create shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_create_with_0_min_threads_fails)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool;
+
+    //act
+    threadpool = threadpool_create(0, 4);
+
+    //assert
+    ASSERT_IS_NULL(threadpool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_THREADPOOL_01_001: [ If min_threads is 0 or max_threads is smaller than min_threads, threadpool_create shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_create_with_max_threads_below_min_threads_fails)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool;
+
+    //act
+    threadpool = threadpool_create(2, 1);
+
+    //assert
+    ASSERT_IS_NULL(threadpool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_THREADPOOL_01_002: [ threadpool_create shall allocate the pool and max_threads worker slots, each with a queue guarded by a lock created with Lock_Init. ]*/
+/*Tests_SRS_THREADPOOL_01_003: [ threadpool_create shall create the pool lock, the timer lock and two conditions with Lock_Init and Condition_Init, a timer wheel of THREADPOOL_TIMER_RESOLUTION_MS ticks with timer_wheel_create, and start min_threads workers with ThreadAPI_Create. ]*/
+/*Tests_SRS_THREADPOOL_01_005: [ If threadpool is NULL, threadpool_destroy shall return. ]*/
+TEST_FUNCTION(threadpool_create_succeeds)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool;
+
+    //act
+    threadpool = threadpool_create(2, 4);
+
+    //assert
+    ASSERT_IS_NOT_NULL(threadpool);
+
+    //cleanup
+    threadpool_destroy(threadpool);
+    threadpool_destroy(NULL);
+}
+
+/*Tests_SRS_THREADPOOL_01_004: [ If any of the above fails, threadpool_create shall free everything it created, stop the workers it started and return NULL. ]*/
+TEST_FUNCTION(threadpool_create_fails_when_any_allocation_fails)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool;
+    size_t allocation_count;
+    size_t i;
+    char temp_str[128];
+
+    malloc_call_count = 0;
+    threadpool = threadpool_create(2, 4);
+    ASSERT_IS_NOT_NULL(threadpool);
+    allocation_count = malloc_call_count;
+    threadpool_destroy(threadpool);
+
+    for (i = 0; i < allocation_count; i++)
+    {
+        malloc_call_count = 0;
+        malloc_fail_index = i;
+        (void)sprintf(temp_str, "On failed allocation %lu", (unsigned long)i);
+
+        //act
+        threadpool = threadpool_create(2, 4);
+
+        //assert
+        ASSERT_IS_NULL_WITH_MSG(threadpool, temp_str);
+    }
+}
+
+/* threadpool_schedule */
+
+/*Tests_SRS_THREADPOOL_01_009: [ If threadpool or work_function is NULL, threadpool_schedule shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_with_NULL_threadpool_fails)
+{
+    //arrange
+    int result;
+
+    //act
+    result = threadpool_schedule(NULL, count_work, &test_state);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_THREADPOOL_01_009: [ If threadpool or work_function is NULL, threadpool_schedule shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_with_NULL_work_function_fails)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    int result;
+
+    //act
+    result = threadpool_schedule(threadpool, NULL, &test_state);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    //cleanup
+    threadpool_destroy(threadpool);
+}
+
+/*Tests_SRS_THREADPOOL_01_011: [ When called from one of the pool's workers, threadpool_schedule shall queue the work at the back of that worker's queue; otherwise it shall queue it at the back of the shared queue. ]*/
+/*Tests_SRS_THREADPOOL_01_016: [ threadpool_schedule shall wake an idle worker by calling Condition_Post, if there is one that is not already being woken, and return 0. ]*/
+TEST_FUNCTION(threadpool_schedule_runs_the_work)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    int result;
+
+    //act
+    result = threadpool_schedule(threadpool, count_work, &test_state);
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, wait_for_run_count(&test_state, 1));
+
+    //cleanup
+    threadpool_destroy(threadpool);
+}
+
+/*Tests_SRS_THREADPOOL_01_007: [ threadpool_destroy shall refuse new work, wake every idle worker, and join every worker once all the queued work has run. ]*/
+TEST_FUNCTION(threadpool_destroy_runs_all_the_scheduled_work)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(2, 4);
+    size_t i;
+
+    for (i = 0; i < TEST_WORK_ITEM_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule(threadpool, count_work, &test_state));
+    }
+
+    //act
+    threadpool_destroy(threadpool);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, TEST_WORK_ITEM_COUNT, test_state.run_count);
+}
+
+/*Tests_SRS_THREADPOOL_01_011: [ When called from one of the pool's workers, threadpool_schedule shall queue the work at the back of that worker's queue; otherwise it shall queue it at the back of the shared queue. ]*/
+/*Tests_SRS_THREADPOOL_01_013: [ A worker shall run the most recently queued item of its own queue first, then the oldest item of the shared queue, then the oldest item of another worker's queue. ]*/
+TEST_FUNCTION(threadpool_schedule_from_a_worker_runs_the_work)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(2, 2);
+    test_state.threadpool = threadpool;
+
+    //act
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule(threadpool, schedule_children_work, &test_state));
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 101, wait_for_run_count(&test_state, 101));
+    ASSERT_ARE_EQUAL(int, 0, test_state.schedule_result);
+
+    //cleanup
+    threadpool_destroy(threadpool);
+}
+
+/*Tests_SRS_THREADPOOL_01_012: [ If the queue cannot grow, threadpool_schedule shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_fails_when_the_queue_cannot_grow)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    int result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    result = threadpool_schedule(threadpool, count_work, &test_state);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    threadpool_destroy(threadpool);
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.run_count);
+}
+
+/*Tests_SRS_THREADPOOL_01_014: [ If no worker is idle and fewer than max_threads workers are running, threadpool_schedule shall start a new worker by calling ThreadAPI_Create. ]*/
+TEST_FUNCTION(threadpool_schedule_starts_workers_up_to_max_threads)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 4);
+    size_t i;
+    test_state.block_until_running = 4;
+
+    //act
+    for (i = 0; i < 4; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule(threadpool, blocking_work, &test_state));
+    }
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 4, wait_for_run_count(&test_state, 4));
+    ASSERT_ARE_EQUAL(size_t, 4, test_state.max_running_count);
+
+    //cleanup
+    threadpool_destroy(threadpool);
+}
+
+/*Tests_SRS_THREADPOOL_01_014: [ If no worker is idle and fewer than max_threads workers are running, threadpool_schedule shall start a new worker by calling ThreadAPI_Create. ]*/
+TEST_FUNCTION(threadpool_schedule_does_not_start_more_than_max_threads_workers)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 2);
+    size_t i;
+    /*the first items wait for a third one, which can only start if the pool goes above 2 workers*/
+    test_state.block_until_running = 3;
+
+    //act
+    for (i = 0; i < 6; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule(threadpool, blocking_work, &test_state));
+    }
+    threadpool_destroy(threadpool);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 6, test_state.run_count);
+    ASSERT_ARE_EQUAL(size_t, 2, test_state.max_running_count);
+}
+
+/*Tests_SRS_THREADPOOL_01_010: [ Once threadpool_destroy has started, threadpool_schedule shall fail and return a non-zero value. ]*/
+/*Tests_SRS_THREADPOOL_01_020: [ Once threadpool_destroy has started, a worker that finds no work anywhere shall exit. ]*/
+TEST_FUNCTION(threadpool_schedule_after_threadpool_destroy_started_fails)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    test_state.threadpool = threadpool;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule(threadpool, schedule_late_work, &test_state));
+
+    //act
+    threadpool_destroy(threadpool);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, test_state.schedule_result);
+    ASSERT_ARE_EQUAL(size_t, 0, test_state.run_count);
+}
+
+/* threadpool_timer_start */
+
+/*Tests_SRS_THREADPOOL_01_017: [ If threadpool or work_function is NULL, threadpool_timer_start shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_threadpool_fails)
+{
+    //arrange
+    THREADPOOL_TIMER_HANDLE timer;
+
+    //act
+    timer = threadpool_timer_start(NULL, 10, 0, count_work, &test_state);
+
+    //assert
+    ASSERT_IS_NULL(timer);
+}
+
+/*Tests_SRS_THREADPOOL_01_017: [ If threadpool or work_function is NULL, threadpool_timer_start shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_fails)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    THREADPOOL_TIMER_HANDLE timer;
+
+    //act
+    timer = threadpool_timer_start(threadpool, 10, 0, NULL, &test_state);
+
+    //assert
+    ASSERT_IS_NULL(timer);
+
+    //cleanup
+    threadpool_destroy(threadpool);
+}
+
+/*Tests_SRS_THREADPOOL_01_021: [ If any of the above fails, threadpool_timer_start shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_fails_when_allocating_the_timer_fails)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    THREADPOOL_TIMER_HANDLE timer;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    timer = threadpool_timer_start(threadpool, 10, 0, count_work, &test_state);
+
+    //assert
+    ASSERT_IS_NULL(timer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    threadpool_destroy(threadpool);
+}
+
+/*Tests_SRS_THREADPOOL_01_021: [ If any of the above fails, threadpool_timer_start shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_fails_when_timer_wheel_schedule_fails)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    THREADPOOL_TIMER_HANDLE timer;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    //act
+    timer = threadpool_timer_start(threadpool, 10, 0, count_work, &test_state);
+
+    //assert
+    ASSERT_IS_NULL(timer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    threadpool_destroy(threadpool);
+}
+
+/*Tests_SRS_THREADPOOL_01_018: [ threadpool_timer_start shall allocate a timer. ]*/
+/*Tests_SRS_THREADPOOL_01_019: [ The first call to threadpool_timer_start shall start the timer thread by calling ThreadAPI_Create. ]*/
+/*Tests_SRS_THREADPOOL_01_022: [ When a timer is due, its work function shall be scheduled on the workers. ]*/
+/*Tests_SRS_THREADPOOL_01_024: [ threadpool_timer_start shall schedule the timer with timer_wheel_schedule, delay_ms from now, and return it. ]*/
+TEST_FUNCTION(threadpool_timer_start_runs_a_one_shot_timer_once)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    THREADPOOL_TIMER_HANDLE timer;
+
+    //act
+    timer = threadpool_timer_start(threadpool, 20, 0, count_work, &test_state);
+
+    //assert
+    ASSERT_IS_NOT_NULL(timer);
+    ASSERT_ARE_EQUAL(size_t, 1, wait_for_run_count(&test_state, 1));
+    ThreadAPI_Sleep(100);
+    ASSERT_ARE_EQUAL(size_t, 1, get_run_count(&test_state));
+
+    //cleanup
+    threadpool_timer_cancel(timer);
+    threadpool_destroy(threadpool);
+}
+
+/*Tests_SRS_THREADPOOL_01_024: [ threadpool_timer_start shall schedule the timer with timer_wheel_schedule, delay_ms from now, and return it. ]*/
+TEST_FUNCTION(threadpool_timer_start_does_not_run_the_timer_before_it_is_due)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    THREADPOOL_TIMER_HANDLE timer;
+
+    //act
+    timer = threadpool_timer_start(threadpool, 500, 0, count_work, &test_state);
+    ThreadAPI_Sleep(200);
+
+    //assert
+    ASSERT_IS_NOT_NULL(timer);
+    ASSERT_ARE_EQUAL(size_t, 0, get_run_count(&test_state));
+    ASSERT_ARE_EQUAL(size_t, 1, wait_for_run_count(&test_state, 1));
+
+    //cleanup
+    threadpool_timer_cancel(timer);
+    threadpool_destroy(threadpool);
+}
+
+/*Tests_SRS_THREADPOOL_01_023: [ A periodic timer shall be put back in the wheel, period_ms after its run completes. ]*/
+TEST_FUNCTION(threadpool_timer_start_runs_a_periodic_timer_until_it_is_cancelled)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    THREADPOOL_TIMER_HANDLE timer;
+    size_t run_count;
+
+    //act
+    timer = threadpool_timer_start(threadpool, 10, 10, count_work, &test_state);
+
+    //assert
+    ASSERT_IS_NOT_NULL(timer);
+    ASSERT_ARE_EQUAL(size_t, 5, wait_for_run_count(&test_state, 5));
+    threadpool_timer_cancel(timer);
+    /*a run that had started before the cancel completes*/
+    ThreadAPI_Sleep(50);
+    run_count = get_run_count(&test_state);
+    ThreadAPI_Sleep(100);
+    ASSERT_ARE_EQUAL(size_t, run_count, get_run_count(&test_state));
+
+    //cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_cancel */
+
+/*Tests_SRS_THREADPOOL_01_025: [ If timer is NULL, threadpool_timer_cancel shall return. ]*/
+TEST_FUNCTION(threadpool_timer_cancel_with_NULL_timer_returns)
+{
+    //act
+    threadpool_timer_cancel(NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_THREADPOOL_01_026: [ threadpool_timer_cancel shall cancel the timer with timer_wheel_cancel and free it. ]*/
+TEST_FUNCTION(threadpool_timer_cancel_before_the_timer_is_due_prevents_the_run)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    THREADPOOL_TIMER_HANDLE timer = threadpool_timer_start(threadpool, 100, 0, count_work, &test_state);
+    ASSERT_IS_NOT_NULL(timer);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(timer));
+
+    //act
+    threadpool_timer_cancel(timer);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ThreadAPI_Sleep(300);
+    ASSERT_ARE_EQUAL(size_t, 0, get_run_count(&test_state));
+
+    //cleanup
+    threadpool_destroy(threadpool);
+}
+
+/*Tests_SRS_THREADPOOL_01_027: [ A timer cancelled while its work function is queued or running shall be freed once the run is over. ]*/
+TEST_FUNCTION(threadpool_timer_cancel_from_the_timer_work_function_stops_the_timer)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 1);
+    THREADPOOL_TIMER_HANDLE timer;
+
+    //act
+    (void)Lock(test_state.lock);
+    timer = threadpool_timer_start(threadpool, 10, 10, cancel_own_timer_work, &test_state);
+    test_state.timer = timer;
+    (void)Unlock(test_state.lock);
+
+    //assert
+    ASSERT_IS_NOT_NULL(timer);
+    ASSERT_ARE_EQUAL(size_t, 1, wait_for_run_count(&test_state, 1));
+    ThreadAPI_Sleep(100);
+    ASSERT_ARE_EQUAL(size_t, 1, get_run_count(&test_state));
+
+    //cleanup
+    threadpool_destroy(threadpool);
+}
+
+/*Tests_SRS_THREADPOOL_01_006: [ threadpool_destroy shall stop the timer thread and join it, so that no timer fires afterwards. ]*/
+/*Tests_SRS_THREADPOOL_01_008: [ threadpool_destroy shall free the timers that were not cancelled and every resource of the pool. ]*/
+TEST_FUNCTION(threadpool_destroy_frees_the_timers_that_were_not_cancelled)
+{
+    //arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(1, 2);
+    ASSERT_IS_NOT_NULL(threadpool_timer_start(threadpool, 10, 10, count_work, &test_state));
+    ASSERT_IS_NOT_NULL(threadpool_timer_start(threadpool, 1000, 0, count_work, &test_state));
+    (void)wait_for_run_count(&test_state, 2);
+
+    //act
+    threadpool_destroy(threadpool);
+
+    //assert
+    ASSERT_IS_TRUE(test_state.run_count >= 2);
+}
+
+END_TEST_SUITE(threadpool_unittests)
@@ -0,0 +1,821 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+
+static void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/timer_wheel.h"
+
+#define TEST_TICK_COUNTER_HANDLE    (TICK_COUNTER_HANDLE)0x4245
+#define TEST_MAX_RUNS               16
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+/*time is what the test says it is*/
+static tickcounter_ms_t g_current_ms;
+static int g_tickcounter_result;
+
+static int my_tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, tickcounter_ms_t* current_ms)
+{
+    (void)tick_counter;
+    if (g_tickcounter_result == 0)
+    {
+        *current_ms = g_current_ms;
+    }
+    return g_tickcounter_result;
+}
+
+static TICK_COUNTER_HANDLE my_tickcounter_create(void)
+{
+    return TEST_TICK_COUNTER_HANDLE;
+}
+
+/*what the callbacks did, in order*/
+typedef struct TEST_TIMER_TAG
+{
+    size_t id;
+    TIMER_WHEEL_TIMER_HANDLE timer;
+    /*what the callback does to other_timer (or to timer, if NULL)*/
+    TIMER_WHEEL_TIMER_HANDLE other_timer;
+    uint32_t restart_ms;
+    bool cancel;
+} TEST_TIMER;
+
+static size_t g_run_count;
+static size_t g_run_ids[TEST_MAX_RUNS];
+static tickcounter_ms_t g_run_ms[TEST_MAX_RUNS];
+
+static void on_test_timer(void* context)
+{
+    TEST_TIMER* test_timer = (TEST_TIMER*)context;
+    TIMER_WHEEL_TIMER_HANDLE target = (test_timer->other_timer != NULL) ? test_timer->other_timer : test_timer->timer;
+
+    if (g_run_count < TEST_MAX_RUNS)
+    {
+        g_run_ids[g_run_count] = test_timer->id;
+        g_run_ms[g_run_count] = g_current_ms;
+    }
+    g_run_count++;
+
+    if (test_timer->cancel)
+    {
+        timer_wheel_cancel(target);
+    }
+    else if (test_timer->restart_ms != 0)
+    {
+        (void)timer_wheel_restart(target, test_timer->restart_ms);
+    }
+}
+
+static TIMER_WHEEL_HANDLE g_schedule_timer_wheel;
+static TIMER_WHEEL_TIMER_HANDLE g_scheduled_timer;
+
+static void on_schedule_timer(void* context)
+{
+    g_scheduled_timer = timer_wheel_schedule(g_schedule_timer_wheel, 0, on_test_timer, context);
+    g_run_count++;
+}
+
+static void init_test_timer(TEST_TIMER* test_timer, size_t id)
+{
+    test_timer->id = id;
+    test_timer->timer = NULL;
+    test_timer->other_timer = NULL;
+    test_timer->restart_ms = 0;
+    test_timer->cancel = false;
+}
+
+static void run_at(TIMER_WHEEL_HANDLE timer_wheel, tickcounter_ms_t ms)
+{
+    g_current_ms = ms;
+    timer_wheel_dowork(timer_wheel);
+}
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(timer_wheel_unittests)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    int result;
+
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    result = umock_c_init(on_umock_c_error);
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+    REGISTER_GLOBAL_MOCK_HOOK(tickcounter_create, my_tickcounter_create);
+    REGISTER_GLOBAL_MOCK_HOOK(tickcounter_get_current_ms, my_tickcounter_get_current_ms);
+    REGISTER_UMOCK_ALIAS_TYPE(TICK_COUNTER_HANDLE, void*);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+    g_current_ms = 0;
+    g_tickcounter_result = 0;
+    g_run_count = 0;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* timer_wheel_create */
+
+/*Tests_SRS_TIMER_WHEEL_01_001: [ If tick_ms is 0, timer_wheel_create shall fail and return NULL. ]*/
+TEST_FUNCTION(timer_wheel_create_with_0_tick_ms_fails)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel;
+
+    // act
+    timer_wheel = timer_wheel_create(0);
+
+    // assert
+    ASSERT_IS_NULL(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_002: [ timer_wheel_create shall allocate a timer wheel and create a tick counter with tickcounter_create. ]*/
+/*Tests_SRS_TIMER_WHEEL_01_003: [ timer_wheel_create shall start counting time from the current value of the tick counter and return the timer wheel. ]*/
+TEST_FUNCTION(timer_wheel_create_succeeds)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create());
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+
+    // act
+    timer_wheel = timer_wheel_create(10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(timer_wheel);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_004: [ If any error occurs, timer_wheel_create shall free what it allocated and return NULL. ]*/
+TEST_FUNCTION(when_allocating_fails_timer_wheel_create_fails)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    // act
+    timer_wheel = timer_wheel_create(10);
+
+    // assert
+    ASSERT_IS_NULL(timer_wheel);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_004: [ If any error occurs, timer_wheel_create shall free what it allocated and return NULL. ]*/
+TEST_FUNCTION(when_tickcounter_create_fails_timer_wheel_create_fails)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create())
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    timer_wheel = timer_wheel_create(10);
+
+    // assert
+    ASSERT_IS_NULL(timer_wheel);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_004: [ If any error occurs, timer_wheel_create shall free what it allocated and return NULL. ]*/
+TEST_FUNCTION(when_tickcounter_get_current_ms_fails_timer_wheel_create_fails)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel;
+    g_tickcounter_result = 1;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create());
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(tickcounter_destroy(TEST_TICK_COUNTER_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    timer_wheel = timer_wheel_create(10);
+
+    // assert
+    ASSERT_IS_NULL(timer_wheel);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* timer_wheel_destroy */
+
+/*Tests_SRS_TIMER_WHEEL_01_005: [ If timer_wheel is NULL, timer_wheel_destroy shall return. ]*/
+TEST_FUNCTION(timer_wheel_destroy_with_NULL_returns)
+{
+    // act
+    timer_wheel_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_006: [ timer_wheel_destroy shall free every timer that was not cancelled, without calling its callback, the tick counter and the timer wheel. ]*/
+TEST_FUNCTION(timer_wheel_destroy_frees_the_timers_without_running_them)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timers[2];
+    init_test_timer(&test_timers[0], 0);
+    init_test_timer(&test_timers[1], 1);
+    test_timers[0].timer = timer_wheel_schedule(timer_wheel, 10, on_test_timer, &test_timers[0]);
+    test_timers[1].timer = timer_wheel_schedule(timer_wheel, 100000, on_test_timer, &test_timers[1]);
+    run_at(timer_wheel, 10);
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_count);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_destroy(TEST_TICK_COUNTER_HANDLE));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    timer_wheel_destroy(timer_wheel);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* timer_wheel_schedule */
+
+/*Tests_SRS_TIMER_WHEEL_01_007: [ If timer_wheel or on_timer is NULL, timer_wheel_schedule shall fail and return NULL. ]*/
+TEST_FUNCTION(timer_wheel_schedule_with_NULL_arguments_fails)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timer;
+    init_test_timer(&test_timer, 0);
+
+    // act
+    // assert
+    ASSERT_IS_NULL(timer_wheel_schedule(NULL, 10, on_test_timer, &test_timer));
+    ASSERT_IS_NULL(timer_wheel_schedule(timer_wheel, 10, NULL, &test_timer));
+
+    // cleanup
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_008: [ If allocating the timer fails, timer_wheel_schedule shall fail and return NULL. ]*/
+TEST_FUNCTION(when_allocating_fails_timer_wheel_schedule_fails)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timer;
+    uint32_t wait_ms;
+    init_test_timer(&test_timer, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    // act
+    test_timer.timer = timer_wheel_schedule(timer_wheel, 10, on_test_timer, &test_timer);
+
+    // assert
+    ASSERT_IS_NULL(test_timer.timer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, timer_wheel_get_wait_ms(timer_wheel, &wait_ms));
+    ASSERT_ARE_EQUAL(uint32_t, TIMER_WHEEL_WAIT_INFINITE, wait_ms);
+
+    // cleanup
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_009: [ timer_wheel_schedule shall read the tick counter and put the timer in the slot of the tick delay_ms from now, rounded up to tick_ms. ]*/
+/*Tests_SRS_TIMER_WHEEL_01_017: [ timer_wheel_dowork shall read the tick counter and run every tick up to the current one. ]*/
+TEST_FUNCTION(a_timer_runs_once_its_delay_rounded_up_to_the_tick_went_by)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel;
+    TEST_TIMER test_timer;
+    init_test_timer(&test_timer, 0);
+    g_current_ms = 1000;
+    timer_wheel = timer_wheel_create(10);
+    g_current_ms = 1003;
+    test_timer.timer = timer_wheel_schedule(timer_wheel, 15, on_test_timer, &test_timer);
+
+    // act
+    run_at(timer_wheel, 1018);
+    ASSERT_ARE_EQUAL(size_t, 0, g_run_count);
+    run_at(timer_wheel, 1019);
+    ASSERT_ARE_EQUAL(size_t, 0, g_run_count);
+    run_at(timer_wheel, 1020);
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_count);
+    run_at(timer_wheel, 2000);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_count);
+
+    // cleanup
+    timer_wheel_cancel(test_timer.timer);
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_019: [ When the ticks of a level come round, timer_wheel_dowork shall move the timers of the next slot of the level above to the level below. ]*/
+TEST_FUNCTION(timers_in_every_level_run_exactly_at_their_deadline)
+{
+    // arrange
+    static const uint32_t delays[] = { 1, 63, 64, 65, 4095, 4096, 4161, 300000, 16777216, 2000000000, UINT32_MAX };
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timers[sizeof(delays) / sizeof(delays[0])];
+    size_t i;
+
+    /*scheduled from the last one, so that timers are inserted out of order*/
+    for (i = sizeof(delays) / sizeof(delays[0]); i > 0; i--)
+    {
+        init_test_timer(&test_timers[i - 1], i - 1);
+        test_timers[i - 1].timer = timer_wheel_schedule(timer_wheel, delays[i - 1], on_test_timer, &test_timers[i - 1]);
+        ASSERT_IS_NOT_NULL(test_timers[i - 1].timer);
+    }
+
+    // act
+    // assert
+    for (i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+    {
+        run_at(timer_wheel, (tickcounter_ms_t)delays[i] - 1);
+        ASSERT_ARE_EQUAL(size_t, i, g_run_count);
+        run_at(timer_wheel, delays[i]);
+        ASSERT_ARE_EQUAL(size_t, i + 1, g_run_count);
+        ASSERT_ARE_EQUAL(size_t, i, g_run_ids[i]);
+    }
+
+    // cleanup
+    for (i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+    {
+        timer_wheel_cancel(test_timers[i].timer);
+    }
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_018: [ timer_wheel_dowork shall skip the ticks that have no timer to run or to move between levels. ]*/
+/*Tests_SRS_TIMER_WHEEL_01_020: [ timer_wheel_dowork shall call the callback of every timer that is due, in the order of their deadlines, with its context. ]*/
+TEST_FUNCTION(timer_wheel_dowork_runs_the_timers_due_in_the_order_of_their_deadlines)
+{
+    // arrange
+    static const uint32_t delays[] = { 5000, 70, 3, 70, 300000 };
+    static const size_t expected_ids[] = { 2, 1, 3, 0, 4 };
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timers[sizeof(delays) / sizeof(delays[0])];
+    size_t i;
+
+    for (i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+    {
+        init_test_timer(&test_timers[i], i);
+        test_timers[i].timer = timer_wheel_schedule(timer_wheel, delays[i], on_test_timer, &test_timers[i]);
+    }
+
+    // act
+    run_at(timer_wheel, 1000000);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, sizeof(delays) / sizeof(delays[0]), g_run_count);
+    for (i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+    {
+        ASSERT_ARE_EQUAL(size_t, expected_ids[i], g_run_ids[i]);
+    }
+
+    // cleanup
+    for (i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+    {
+        timer_wheel_cancel(test_timers[i].timer);
+    }
+    timer_wheel_destroy(timer_wheel);
+}
+
+TEST_FUNCTION(a_timer_scheduled_from_a_callback_runs_in_a_later_dowork)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TIMER_WHEEL_TIMER_HANDLE timer;
+    TEST_TIMER test_timer;
+    init_test_timer(&test_timer, 7);
+    g_schedule_timer_wheel = timer_wheel;
+    g_scheduled_timer = NULL;
+    timer = timer_wheel_schedule(timer_wheel, 10, on_schedule_timer, &test_timer);
+
+    // act
+    run_at(timer_wheel, 10);
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_count);
+    ASSERT_IS_NOT_NULL(g_scheduled_timer);
+    run_at(timer_wheel, 11);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 2, g_run_count);
+    ASSERT_ARE_EQUAL(size_t, 7, g_run_ids[1]);
+
+    // cleanup
+    timer_wheel_cancel(g_scheduled_timer);
+    timer_wheel_cancel(timer);
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_016: [ If timer_wheel is NULL, timer_wheel_dowork shall return. ]*/
+TEST_FUNCTION(timer_wheel_dowork_with_NULL_returns)
+{
+    // act
+    timer_wheel_dowork(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(when_tickcounter_get_current_ms_fails_timer_wheel_dowork_runs_nothing_new)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timer;
+    init_test_timer(&test_timer, 0);
+    test_timer.timer = timer_wheel_schedule(timer_wheel, 10, on_test_timer, &test_timer);
+    g_tickcounter_result = 1;
+
+    // act
+    run_at(timer_wheel, 20);
+    ASSERT_ARE_EQUAL(size_t, 0, g_run_count);
+    g_tickcounter_result = 0;
+    run_at(timer_wheel, 20);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_count);
+
+    // cleanup
+    timer_wheel_cancel(test_timer.timer);
+    timer_wheel_destroy(timer_wheel);
+}
+
+TEST_FUNCTION(a_tick_counter_that_wraps_does_not_move_the_deadlines)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel;
+    TEST_TIMER test_timer;
+    init_test_timer(&test_timer, 0);
+    g_current_ms = (tickcounter_ms_t)0 - 50;
+    timer_wheel = timer_wheel_create(1);
+    test_timer.timer = timer_wheel_schedule(timer_wheel, 100, on_test_timer, &test_timer);
+
+    // act
+    run_at(timer_wheel, 49);
+    ASSERT_ARE_EQUAL(size_t, 0, g_run_count);
+    run_at(timer_wheel, 50);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_count);
+
+    // cleanup
+    timer_wheel_cancel(test_timer.timer);
+    timer_wheel_destroy(timer_wheel);
+}
+
+/* timer_wheel_restart */
+
+/*Tests_SRS_TIMER_WHEEL_01_010: [ If timer is NULL, timer_wheel_restart shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(timer_wheel_restart_with_NULL_timer_fails)
+{
+    // act
+    int result = timer_wheel_restart(NULL, 10);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_011: [ If the timer is waiting, timer_wheel_restart shall take it out of its slot. ]*/
+/*Tests_SRS_TIMER_WHEEL_01_012: [ timer_wheel_restart shall put the timer in the slot of the tick delay_ms from now and return 0. ]*/
+TEST_FUNCTION(timer_wheel_restart_pushes_the_deadline_of_a_waiting_timer_back)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timer;
+    init_test_timer(&test_timer, 0);
+    test_timer.timer = timer_wheel_schedule(timer_wheel, 100, on_test_timer, &test_timer);
+    run_at(timer_wheel, 90);
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, timer_wheel_restart(test_timer.timer, 5000));
+    run_at(timer_wheel, 5089);
+    ASSERT_ARE_EQUAL(size_t, 0, g_run_count);
+    run_at(timer_wheel, 5090);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_count);
+
+    // cleanup
+    timer_wheel_cancel(test_timer.timer);
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_012: [ timer_wheel_restart shall put the timer in the slot of the tick delay_ms from now and return 0. ]*/
+TEST_FUNCTION(a_timer_that_restarts_itself_from_its_callback_runs_periodically)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timer;
+    tickcounter_ms_t ms;
+    init_test_timer(&test_timer, 0);
+    test_timer.restart_ms = 100;
+    test_timer.timer = timer_wheel_schedule(timer_wheel, 100, on_test_timer, &test_timer);
+
+    // act
+    for (ms = 1; ms <= 1000; ms++)
+    {
+        run_at(timer_wheel, ms);
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 10, g_run_count);
+    for (ms = 0; ms < 10; ms++)
+    {
+        ASSERT_ARE_EQUAL(uint32_t, (uint32_t)((ms + 1) * 100), (uint32_t)g_run_ms[ms]);
+    }
+
+    // cleanup
+    timer_wheel_cancel(test_timer.timer);
+    timer_wheel_destroy(timer_wheel);
+}
+
+TEST_FUNCTION(a_timer_restarted_from_a_callback_of_the_same_tick_does_not_run_in_that_tick)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timers[2];
+    init_test_timer(&test_timers[0], 0);
+    init_test_timer(&test_timers[1], 1);
+    test_timers[0].timer = timer_wheel_schedule(timer_wheel, 10, on_test_timer, &test_timers[0]);
+    test_timers[1].timer = timer_wheel_schedule(timer_wheel, 10, on_test_timer, &test_timers[1]);
+    test_timers[0].other_timer = test_timers[1].timer;
+    test_timers[0].restart_ms = 20;
+
+    // act
+    run_at(timer_wheel, 10);
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_count);
+    run_at(timer_wheel, 30);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 2, g_run_count);
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_ids[1]);
+
+    // cleanup
+    timer_wheel_cancel(test_timers[0].timer);
+    timer_wheel_cancel(test_timers[1].timer);
+    timer_wheel_destroy(timer_wheel);
+}
+
+/* timer_wheel_cancel */
+
+/*Tests_SRS_TIMER_WHEEL_01_013: [ If timer is NULL, timer_wheel_cancel shall return. ]*/
+TEST_FUNCTION(timer_wheel_cancel_with_NULL_returns)
+{
+    // act
+    timer_wheel_cancel(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_014: [ If the timer is waiting, timer_wheel_cancel shall take it out of its slot so that its callback is not called. ]*/
+/*Tests_SRS_TIMER_WHEEL_01_015: [ timer_wheel_cancel shall free the timer. ]*/
+TEST_FUNCTION(a_cancelled_timer_does_not_run)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timer;
+    uint32_t wait_ms;
+    init_test_timer(&test_timer, 0);
+    test_timer.timer = timer_wheel_schedule(timer_wheel, 100000, on_test_timer, &test_timer);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    // act
+    timer_wheel_cancel(test_timer.timer);
+    run_at(timer_wheel, 200000);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, g_run_count);
+    ASSERT_ARE_EQUAL(int, 0, timer_wheel_get_wait_ms(timer_wheel, &wait_ms));
+    ASSERT_ARE_EQUAL(uint32_t, TIMER_WHEEL_WAIT_INFINITE, wait_ms);
+
+    // cleanup
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_014: [ If the timer is waiting, timer_wheel_cancel shall take it out of its slot so that its callback is not called. ]*/
+TEST_FUNCTION(a_timer_cancelled_from_a_callback_of_the_same_tick_does_not_run)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timers[2];
+    init_test_timer(&test_timers[0], 0);
+    init_test_timer(&test_timers[1], 1);
+    test_timers[0].timer = timer_wheel_schedule(timer_wheel, 10, on_test_timer, &test_timers[0]);
+    test_timers[1].timer = timer_wheel_schedule(timer_wheel, 10, on_test_timer, &test_timers[1]);
+    test_timers[0].other_timer = test_timers[1].timer;
+    test_timers[0].cancel = true;
+
+    // act
+    run_at(timer_wheel, 100);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_count);
+    ASSERT_ARE_EQUAL(size_t, 0, g_run_ids[0]);
+
+    // cleanup
+    timer_wheel_cancel(test_timers[0].timer);
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_015: [ timer_wheel_cancel shall free the timer. ]*/
+TEST_FUNCTION(a_timer_can_cancel_itself_from_its_callback)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timer;
+    init_test_timer(&test_timer, 0);
+    test_timer.cancel = true;
+    test_timer.timer = timer_wheel_schedule(timer_wheel, 10, on_test_timer, &test_timer);
+
+    // act
+    run_at(timer_wheel, 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, g_run_count);
+
+    // cleanup
+    timer_wheel_destroy(timer_wheel);
+}
+
+/* timer_wheel_get_wait_ms */
+
+/*Tests_SRS_TIMER_WHEEL_01_021: [ If timer_wheel or wait_ms is NULL, timer_wheel_get_wait_ms shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(timer_wheel_get_wait_ms_with_NULL_arguments_fails)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    uint32_t wait_ms;
+
+    // act
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, timer_wheel_get_wait_ms(NULL, &wait_ms));
+    ASSERT_ARE_NOT_EQUAL(int, 0, timer_wheel_get_wait_ms(timer_wheel, NULL));
+
+    // cleanup
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_022: [ If no timer is waiting, timer_wheel_get_wait_ms shall set wait_ms to TIMER_WHEEL_WAIT_INFINITE and return 0. ]*/
+TEST_FUNCTION(timer_wheel_get_wait_ms_without_timers_returns_infinite)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    uint32_t wait_ms = 0;
+
+    // act
+    int result = timer_wheel_get_wait_ms(timer_wheel, &wait_ms);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, TIMER_WHEEL_WAIT_INFINITE, wait_ms);
+
+    // cleanup
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_023: [ Otherwise timer_wheel_get_wait_ms shall set wait_ms to the time until the first tick that has a timer to run or to move between levels, 0 if that tick has come, and return 0. ]*/
+TEST_FUNCTION(waiting_for_timer_wheel_get_wait_ms_never_overshoots_a_deadline)
+{
+    // arrange
+    static const uint32_t delays[] = { 3, 1000, 250000 };
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(10);
+    TEST_TIMER test_timers[sizeof(delays) / sizeof(delays[0])];
+    uint32_t wait_ms;
+    size_t wait_count = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+    {
+        init_test_timer(&test_timers[i], i);
+        test_timers[i].timer = timer_wheel_schedule(timer_wheel, delays[i], on_test_timer, &test_timers[i]);
+    }
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, timer_wheel_get_wait_ms(timer_wheel, &wait_ms));
+    while (wait_ms != TIMER_WHEEL_WAIT_INFINITE)
+    {
+        run_at(timer_wheel, g_current_ms + wait_ms);
+        ASSERT_ARE_EQUAL(int, 0, timer_wheel_get_wait_ms(timer_wheel, &wait_ms));
+        wait_count++;
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 3, g_run_count);
+    ASSERT_ARE_EQUAL(uint32_t, 10, (uint32_t)g_run_ms[0]);
+    ASSERT_ARE_EQUAL(uint32_t, 1000, (uint32_t)g_run_ms[1]);
+    ASSERT_ARE_EQUAL(uint32_t, 250000, (uint32_t)g_run_ms[2]);
+    /*the waits get longer as the timers get further away*/
+    ASSERT_IS_TRUE(wait_count < 20);
+
+    // cleanup
+    for (i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+    {
+        timer_wheel_cancel(test_timers[i].timer);
+    }
+    timer_wheel_destroy(timer_wheel);
+}
+
+/*Tests_SRS_TIMER_WHEEL_01_023: [ Otherwise timer_wheel_get_wait_ms shall set wait_ms to the time until the first tick that has a timer to run or to move between levels, 0 if that tick has come, and return 0. ]*/
+TEST_FUNCTION(timer_wheel_get_wait_ms_returns_0_when_a_timer_is_due)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timer_wheel = timer_wheel_create(1);
+    TEST_TIMER test_timer;
+    uint32_t wait_ms;
+    int result;
+    init_test_timer(&test_timer, 0);
+    test_timer.timer = timer_wheel_schedule(timer_wheel, 10, on_test_timer, &test_timer);
+    g_current_ms = 15;
+
+    // act
+    result = timer_wheel_get_wait_ms(timer_wheel, &wait_ms);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, wait_ms);
+
+    // cleanup
+    timer_wheel_cancel(test_timer.timer);
+    timer_wheel_destroy(timer_wheel);
+}
+
+END_TEST_SUITE(timer_wheel_unittests)
@@ -0,0 +1,476 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+
+static void* my_gballoc_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+static void* my_gballoc_calloc(size_t nmemb, size_t size)
+{
+    return calloc(nmemb, size);
+}
+
+static void* my_gballoc_realloc(void* ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+static void my_gballoc_free(void* ptr)
+{
+    free(ptr);
+}
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/gballoc.h"
+#undef ENABLE_MOCKS
+
+#include "azure_c_shared_utility/trace_logger.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#define TEST_TRACE_FILE             "trace_logger_ut.trace"
+#define TEST_THREAD_COUNT           4
+#define TEST_RECORDS_PER_THREAD     1000
+#define TEST_OUTPUT_SIZE            (512 * 1024)
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static char test_output[TEST_OUTPUT_SIZE];
+
+/*decodes the test trace file and returns what the decoder wrote*/
+static const char* decode(TRACE_LOGGER_DECODE_FORMAT format)
+{
+    FILE* output = tmpfile();
+    size_t size;
+    ASSERT_IS_NOT_NULL(output);
+    ASSERT_ARE_EQUAL(int, 0, trace_logger_decode(TEST_TRACE_FILE, output, format));
+    rewind(output);
+    size = fread(test_output, 1, sizeof(test_output) - 1, output);
+    test_output[size] = '\0';
+    (void)fclose(output);
+    return test_output;
+}
+
+static size_t count_occurrences(const char* text, const char* what)
+{
+    size_t result = 0;
+    const char* found = strstr(text, what);
+    while (found != NULL)
+    {
+        result++;
+        found = strstr(found + strlen(what), what);
+    }
+    return result;
+}
+
+static void test_logger(LOG_CATEGORY log_category, const char* file, const char* func, int line, unsigned int options, const char* format, ...)
+{
+    (void)log_category;
+    (void)file;
+    (void)func;
+    (void)line;
+    (void)options;
+    (void)format;
+}
+
+static int logging_thread(void* context)
+{
+    size_t thread_index = (size_t)context;
+    size_t i;
+    for (i = 0; i < TEST_RECORDS_PER_THREAD; i++)
+    {
+        LogInfo("thread %lu record %lu", (unsigned long)thread_index, (unsigned long)i);
+    }
+    return 0;
+}
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(trace_logger_unittests)
+
+TEST_SUITE_INITIALIZE(TestSuiteInitialize)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    umock_c_init(on_umock_c_error);
+
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_malloc, my_gballoc_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_calloc, my_gballoc_calloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_realloc, my_gballoc_realloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_free, my_gballoc_free);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    (void)remove(TEST_TRACE_FILE);
+
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(f)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(cleans)
+{
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* trace_logger_start */
+
+/*Tests_SRS_TRACE_LOGGER_01_001: [ If path is NULL, record_count is 0 or string_table_size cannot hold a string, or the file would be too large, trace_logger_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(trace_logger_start_with_invalid_arguments_fails)
+{
+    //act
+    int result_null_path = trace_logger_start(NULL, 16, 4096);
+    int result_zero_count = trace_logger_start(TEST_TRACE_FILE, 0, 4096);
+    int result_huge_count = trace_logger_start(TEST_TRACE_FILE, (size_t)-1, 4096);
+    int result_small_string_table = trace_logger_start(TEST_TRACE_FILE, 16, 1);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_null_path);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_zero_count);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_huge_count);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_small_string_table);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_006: [ If any error occurs, trace_logger_start shall free what it allocated and return a non-zero value. ]*/
+TEST_FUNCTION(when_allocating_the_string_cache_fails_trace_logger_start_fails)
+{
+    //arrange
+    int result;
+    STRICT_EXPECTED_CALL(gballoc_calloc(IGNORED_NUM_ARG, IGNORED_NUM_ARG))
+        .SetReturn(NULL);
+
+    //act
+    result = trace_logger_start(TEST_TRACE_FILE, 16, 4096);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_TRUE(xlogging_get_log_function() != trace_logger_log);
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_006: [ If any error occurs, trace_logger_start shall free what it allocated and return a non-zero value. ]*/
+TEST_FUNCTION(when_the_file_cannot_be_created_trace_logger_start_fails)
+{
+    //act
+    int result = trace_logger_start("no_such_directory/trace_logger_ut.trace", 16, 4096);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(xlogging_get_log_function() != trace_logger_log);
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_005: [ trace_logger_start shall install trace_logger_log with xlogging_set_log_function and return 0. ]*/
+/*Tests_SRS_TRACE_LOGGER_01_008: [ trace_logger_stop shall put back the log function that was installed before trace_logger_start. ]*/
+TEST_FUNCTION(trace_logger_start_installs_trace_logger_log_and_trace_logger_stop_restores_the_previous_one)
+{
+    //arrange
+    LOGGER_LOG previous = xlogging_get_log_function();
+    int result;
+    LOGGER_LOG installed;
+    xlogging_set_log_function(test_logger);
+
+    //act
+    result = trace_logger_start(TEST_TRACE_FILE, 16, 4096);
+    installed = xlogging_get_log_function();
+    trace_logger_stop();
+
+    //assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(installed == trace_logger_log);
+    ASSERT_IS_TRUE(xlogging_get_log_function() == test_logger);
+
+    //cleanup
+    xlogging_set_log_function(previous);
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_002: [ If the logger is already started, trace_logger_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(trace_logger_start_when_already_started_fails)
+{
+    //arrange
+    int result;
+    ASSERT_ARE_EQUAL(int, 0, trace_logger_start(TEST_TRACE_FILE, 16, 4096));
+
+    //act
+    result = trace_logger_start(TEST_TRACE_FILE, 16, 4096);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    //cleanup
+    trace_logger_stop();
+}
+
+/* trace_logger_stop */
+
+/*Tests_SRS_TRACE_LOGGER_01_007: [ If the logger is not started, trace_logger_stop shall return. ]*/
+TEST_FUNCTION(trace_logger_stop_when_not_started_returns)
+{
+    //act
+    trace_logger_stop();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* trace_logger_log */
+
+/*Tests_SRS_TRACE_LOGGER_01_013: [ trace_logger_log shall store the timestamp, the id of the calling thread, log_category, options, line and the addresses of format, file and func in the record. ]*/
+/*Tests_SRS_TRACE_LOGGER_01_014: [ trace_logger_log shall store the arguments the conversions of format consume without formatting them, cutting strings and dropping the arguments that do not fit. ]*/
+/*Tests_SRS_TRACE_LOGGER_01_015: [ trace_logger_log shall add format, file and func to the string table the first time it sees each of their addresses. ]*/
+/*Tests_SRS_TRACE_LOGGER_01_021: [ As text, each record shall be written as its time in seconds since trace_logger_start, its thread id and the message in the format of consolelogger_log. ]*/
+TEST_FUNCTION(logged_records_are_decoded_as_text)
+{
+    //arrange
+    const char* output;
+    ASSERT_ARE_EQUAL(int, 0, trace_logger_start(TEST_TRACE_FILE, 16, 4096));
+
+    //act
+    LogInfo("int %d string %s unsigned %u hex 0x%02x double %.2f char %c percent %%", -5, "abc", 7u, 255, 1.5, 'z');
+    LogError("size %lu long long %lld", (unsigned long)12, -3LL);
+    trace_logger_stop();
+    output = decode(TRACE_LOGGER_DECODE_TEXT);
+
+    //assert
+    ASSERT_IS_NOT_NULL(strstr(output, "] Info: int -5 string abc unsigned 7 hex 0xff double 1.50 char z percent %\n"));
+    ASSERT_IS_NOT_NULL(strstr(output, "] Error: File:"));
+    ASSERT_IS_NOT_NULL(strstr(output, "trace_logger_ut.c Func:"));
+    ASSERT_IS_NOT_NULL(strstr(output, "size 12 long long -3\n"));
+    ASSERT_ARE_EQUAL(size_t, 2, count_occurrences(output, "\n"));
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_022: [ As JSON, each record shall be written as an object with its sequence, time, thread, category, file, func, line, format, arguments and message. ]*/
+TEST_FUNCTION(logged_records_are_decoded_as_json)
+{
+    //arrange
+    const char* output;
+    ASSERT_ARE_EQUAL(int, 0, trace_logger_start(TEST_TRACE_FILE, 16, 4096));
+
+    //act
+    LogInfo("int %d string %s unsigned %u double %g", -5, "a\"b", 7u, 1.5);
+    trace_logger_stop();
+    output = decode(TRACE_LOGGER_DECODE_JSON);
+
+    //assert
+    ASSERT_IS_NOT_NULL(strstr(output, "{\"sequence\":0,\"time\":"));
+    ASSERT_IS_NOT_NULL(strstr(output, "\"category\":\"Info\""));
+    ASSERT_IS_NOT_NULL(strstr(output, "\"format\":\"int %d string %s unsigned %u double %g\""));
+    ASSERT_IS_NOT_NULL(strstr(output, "\"arguments\":[-5,\"a\\\"b\",7,1.5]"));
+    ASSERT_IS_NOT_NULL(strstr(output, "\"message\":\"int -5 string a\\\"b unsigned 7 double 1.5\"}\n"));
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_014: [ trace_logger_log shall store the arguments the conversions of format consume without formatting them, cutting strings and dropping the arguments that do not fit. ]*/
+TEST_FUNCTION(widths_and_precisions_given_as_arguments_are_decoded)
+{
+    //arrange
+    const char* output;
+    ASSERT_ARE_EQUAL(int, 0, trace_logger_start(TEST_TRACE_FILE, 16, 4096));
+
+    //act
+    LogInfo("[%*d] [%-5s] [%.*s] [%s]", 4, 7, "ab", 3, "abcdef", (const char*)NULL);
+    trace_logger_stop();
+    output = decode(TRACE_LOGGER_DECODE_TEXT);
+
+    //assert
+    ASSERT_IS_NOT_NULL(strstr(output, "Info: [   7] [ab   ] [abc] [(null)]\n"));
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_014: [ trace_logger_log shall store the arguments the conversions of format consume without formatting them, cutting strings and dropping the arguments that do not fit. ]*/
+TEST_FUNCTION(a_string_that_does_not_fit_in_the_record_is_cut)
+{
+    //arrange
+    char long_string[TRACE_LOGGER_RECORD_SIZE * 2];
+    const char* output;
+    (void)memset(long_string, 'x', sizeof(long_string) - 1);
+    long_string[sizeof(long_string) - 1] = '\0';
+    ASSERT_ARE_EQUAL(int, 0, trace_logger_start(TEST_TRACE_FILE, 16, 4096));
+
+    //act
+    LogInfo("%s %d", long_string, 42);
+    trace_logger_stop();
+    output = decode(TRACE_LOGGER_DECODE_TEXT);
+
+    //assert
+    ASSERT_IS_NOT_NULL(strstr(output, "xxx ...\n"));
+    ASSERT_IS_NULL(strstr(output, "42"));
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_020: [ trace_logger_decode shall write the records in the order they were logged, one per line, rendering the message from the stored format string and arguments. ]*/
+TEST_FUNCTION(when_the_ring_wraps_the_oldest_records_are_overwritten)
+{
+    //arrange
+    const char* output;
+    int i;
+    ASSERT_ARE_EQUAL(int, 0, trace_logger_start(TEST_TRACE_FILE, 3, 4096));
+
+    //act
+    for (i = 0; i < 10; i++)
+    {
+        LogInfo("record %d", i);
+    }
+    trace_logger_stop();
+    output = decode(TRACE_LOGGER_DECODE_TEXT);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, 4, count_occurrences(output, "\n"));
+    ASSERT_IS_NULL(strstr(output, "record 5\n"));
+    ASSERT_IS_NOT_NULL(strstr(output, "record 6\n"));
+    ASSERT_IS_TRUE(strstr(output, "record 6\n") < strstr(output, "record 9\n"));
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_015: [ trace_logger_log shall add format, file and func to the string table the first time it sees each of their addresses. ]*/
+TEST_FUNCTION(a_format_that_does_not_fit_in_the_string_table_is_decoded_as_its_address)
+{
+    //arrange
+    const char* output;
+    ASSERT_ARE_EQUAL(int, 0, trace_logger_start(TEST_TRACE_FILE, 16, 16));
+
+    //act
+    LogInfo("a format string that is longer than the string table %d", 1);
+    trace_logger_stop();
+    output = decode(TRACE_LOGGER_DECODE_TEXT);
+
+    //assert
+    ASSERT_IS_NOT_NULL(strstr(output, "Info: <format 0x"));
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_009: [ trace_logger_stop shall make trace_logger_log ignore calls that start after this point and wait for the calls in progress to return. ]*/
+/*Tests_SRS_TRACE_LOGGER_01_011: [ If the logger is not running, trace_logger_log shall return. ]*/
+TEST_FUNCTION(trace_logger_log_after_trace_logger_stop_is_ignored)
+{
+    //arrange
+    const char* output;
+    ASSERT_ARE_EQUAL(int, 0, trace_logger_start(TEST_TRACE_FILE, 16, 4096));
+    LogInfo("before");
+    trace_logger_stop();
+
+    //act
+    trace_logger_log(AZ_LOG_INFO, __FILE__, FUNC_NAME, __LINE__, LOG_LINE, "after");
+    output = decode(TRACE_LOGGER_DECODE_TEXT);
+
+    //assert
+    ASSERT_IS_NOT_NULL(strstr(output, "before"));
+    ASSERT_IS_NULL(strstr(output, "after"));
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_016: [ trace_logger_log shall then mark the record as written with its sequence number. ]*/
+TEST_FUNCTION(trace_logger_log_from_several_threads_keeps_every_record)
+{
+    //arrange
+    THREAD_HANDLE threads[TEST_THREAD_COUNT];
+    const char* output;
+    size_t i;
+    ASSERT_ARE_EQUAL(int, 0, trace_logger_start(TEST_TRACE_FILE, TEST_THREAD_COUNT * TEST_RECORDS_PER_THREAD, 4096));
+
+    //act
+    for (i = 0; i < TEST_THREAD_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Create(&threads[i], logging_thread, (void*)i));
+    }
+    for (i = 0; i < TEST_THREAD_COUNT; i++)
+    {
+        int thread_result;
+        ASSERT_ARE_EQUAL(int, THREADAPI_OK, ThreadAPI_Join(threads[i], &thread_result));
+    }
+    trace_logger_stop();
+    output = decode(TRACE_LOGGER_DECODE_TEXT);
+
+    //assert
+    ASSERT_ARE_EQUAL(size_t, TEST_THREAD_COUNT * TEST_RECORDS_PER_THREAD, count_occurrences(output, "\n"));
+    ASSERT_ARE_EQUAL(size_t, TEST_THREAD_COUNT, count_occurrences(output, " record 999\n"));
+    ASSERT_IS_NULL(strstr(output, "dropped"));
+}
+
+/* trace_logger_decode */
+
+/*Tests_SRS_TRACE_LOGGER_01_017: [ If path or output is NULL or format is not a TRACE_LOGGER_DECODE_FORMAT, trace_logger_decode shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(trace_logger_decode_with_invalid_arguments_fails)
+{
+    //arrange
+    FILE* output = tmpfile();
+    int result_null_path;
+    int result_null_output;
+    int result_invalid_format;
+    ASSERT_IS_NOT_NULL(output);
+
+    //act
+    result_null_path = trace_logger_decode(NULL, output, TRACE_LOGGER_DECODE_TEXT);
+    result_null_output = trace_logger_decode(TEST_TRACE_FILE, NULL, TRACE_LOGGER_DECODE_TEXT);
+    result_invalid_format = trace_logger_decode(TEST_TRACE_FILE, output, (TRACE_LOGGER_DECODE_FORMAT)42);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_null_path);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_null_output);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_invalid_format);
+
+    //cleanup
+    (void)fclose(output);
+}
+
+/*Tests_SRS_TRACE_LOGGER_01_018: [ If the file cannot be read, is not a trace file or was written by a process with another pointer size or record size, trace_logger_decode shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(trace_logger_decode_of_a_file_that_is_not_a_trace_fails)
+{
+    //arrange
+    FILE* output = tmpfile();
+    FILE* not_a_trace = fopen(TEST_TRACE_FILE, "wb");
+    char content[512];
+    int result_not_a_trace;
+    int result_missing;
+    ASSERT_IS_NOT_NULL(output);
+    ASSERT_IS_NOT_NULL(not_a_trace);
+    (void)memset(content, 'A', sizeof(content));
+    ASSERT_ARE_EQUAL(size_t, sizeof(content), fwrite(content, 1, sizeof(content), not_a_trace));
+    (void)fclose(not_a_trace);
+
+    //act
+    result_not_a_trace = trace_logger_decode(TEST_TRACE_FILE, output, TRACE_LOGGER_DECODE_TEXT);
+    result_missing = trace_logger_decode("no_such_directory/trace_logger_ut.trace", output, TRACE_LOGGER_DECODE_TEXT);
+
+    //assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_not_a_trace);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_missing);
+
+    //cleanup
+    (void)fclose(output);
+}
+
+END_TEST_SUITE(trace_logger_unittests)
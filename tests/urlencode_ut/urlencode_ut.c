@@ -5,10 +5,12 @@
 #include <cstdlib>
 #include <cstdio>
 #include <cstddef>
+#include <cstring>
 #else
 #include <stdlib.h>
 #include <stdio.h>
 #include <stddef.h>
+#include <string.h>
 #endif
 
 void* real_malloc(size_t size)
@@ -572,6 +574,9 @@ static const struct
 
 const char* UNRESERVED_CHAR = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._";
 
+/*every unreserved character, twice, so that runs span several 16 byte blocks*/
+static const char unreservedCharacters[] = "!()*-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz!()*-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+
 static TEST_MUTEX_HANDLE g_dllByDll;
 
 DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
@@ -1300,4 +1305,254 @@ TEST_FUNCTION(URL_Decode_Extended_ASCII_chars)
     }
 }
 
+/* Into Tests */
+/*Tests_SRS_URL_ENCODE_01_001: [ URL_EncodeLength shall return the number of characters in the encoding of the first textLength characters of text, not counting the terminating \0. ]*/
+TEST_FUNCTION(URL_EncodeLength_succeeds)
+{
+    // arrange
+    // act
+    size_t result = URL_EncodeLength("a b\xe9", 4);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1 + 3 + 1 + 6, result);
+}
+
+/*Tests_SRS_URL_ENCODE_01_002: [ If text is NULL or textLength is too large for the encoded length to fit in a size_t, URL_EncodeLength shall return 0. ]*/
+TEST_FUNCTION(URL_EncodeLength_with_NULL_text_returns_0)
+{
+    // arrange
+    // act
+    size_t result = URL_EncodeLength(NULL, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+/*Tests_SRS_URL_ENCODE_01_005: [ URL_EncodeInto shall write the encoding of the first textLength characters of text followed by a \0 in destination, set encodedLength to the number of characters before the \0 and return 0. ]*/
+/*Tests_SRS_URL_ENCODE_01_006: [ Unreserved characters shall be copied, other 7-bit characters shall be encoded as %xx and 8-bit characters shall be taken as Latin-1 and encoded as their UTF-8 sequence %c2%xx or %c3%xx, using lower case hexadecimal digits. ]*/
+TEST_FUNCTION(URL_EncodeInto_Exhaustive_chars)
+{
+    size_t i;
+    size_t numberOfTests = sizeof(testVector) / sizeof(testVector[i]);
+    for (i = 0; i < numberOfTests; i++)
+    {
+        // arrange
+        char encoded[16];
+        size_t encodedLength = 0;
+        size_t textLength = strlen(testVector[i].inputData);
+
+        // act
+        int result = URL_EncodeInto(testVector[i].inputData, textLength, encoded, URL_EncodeLength(testVector[i].inputData, textLength) + 1, &encodedLength);
+
+        // assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, testVector[i].expectedOutput, encoded);
+        ASSERT_ARE_EQUAL(size_t, strlen(testVector[i].expectedOutput), encodedLength);
+    }
+}
+
+/*Tests_SRS_URL_ENCODE_01_005: [ URL_EncodeInto shall write the encoding of the first textLength characters of text followed by a \0 in destination, set encodedLength to the number of characters before the \0 and return 0. ]*/
+TEST_FUNCTION(URL_EncodeInto_encodes_only_textLength_characters)
+{
+    // arrange
+    char encoded[64];
+    size_t encodedLength = 0;
+
+    // act
+    int result = URL_EncodeInto("/getalarm('Le Pichet')", 13, encoded, sizeof(encoded), &encodedLength);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, "%2fgetalarm(%27Le", encoded);
+    ASSERT_ARE_EQUAL(size_t, 17, encodedLength);
+}
+
+/*Tests_SRS_URL_ENCODE_01_003: [ If text, destination or encodedLength is NULL, URL_EncodeInto shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(URL_EncodeInto_with_NULL_arguments_fails)
+{
+    // arrange
+    char encoded[16];
+    size_t encodedLength;
+
+    // act
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_EncodeInto(NULL, 1, encoded, sizeof(encoded), &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_EncodeInto("a", 1, NULL, sizeof(encoded), &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_EncodeInto("a", 1, encoded, sizeof(encoded), NULL));
+}
+
+/*Tests_SRS_URL_ENCODE_01_004: [ If destinationSize is smaller than URL_EncodeLength(text, textLength) + 1, URL_EncodeInto shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(URL_EncodeInto_with_small_destination_fails)
+{
+    // arrange
+    char encoded[16];
+    size_t encodedLength;
+
+    // act
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_EncodeInto("hello world", 11, encoded, 13, &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_EncodeInto("hello", 5, encoded, 5, &encodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_EncodeInto("", 0, encoded, 0, &encodedLength));
+    ASSERT_ARE_EQUAL(int, 0, URL_EncodeInto("hello world", 11, encoded, 14, &encodedLength));
+}
+
+/*Tests_SRS_URL_ENCODE_01_008: [ URL_DecodeInto shall write the decoding of the first textLength characters of text followed by a \0 in destination, set decodedLength to the number of characters before the \0 and return 0. ]*/
+TEST_FUNCTION(URL_DecodeInto_ASCII_chars)
+{
+    size_t i;
+    size_t numberOfTests = sizeof(testVectorASCII) / sizeof(testVectorASCII[i]);
+    for (i = 0; i < numberOfTests; i++)
+    {
+        // arrange
+        char decoded[8];
+        size_t decodedLength = 0;
+        size_t textLength = strlen(testVectorASCII[i].endcodedRep);
+
+        // act
+        int result = URL_DecodeInto(testVectorASCII[i].endcodedRep, textLength, decoded, textLength + 1, &decodedLength);
+
+        // assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, testVectorASCII[i].charRep, decoded);
+        ASSERT_ARE_EQUAL(size_t, strlen(testVectorASCII[i].charRep), decodedLength);
+    }
+}
+
+/*Tests_SRS_URL_ENCODE_01_007: [ If text, destination or decodedLength is NULL, URL_DecodeInto shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(URL_DecodeInto_with_NULL_arguments_fails)
+{
+    // arrange
+    char decoded[16];
+    size_t decodedLength;
+
+    // act
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_DecodeInto(NULL, 1, decoded, sizeof(decoded), &decodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_DecodeInto("a", 1, NULL, sizeof(decoded), &decodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_DecodeInto("a", 1, decoded, sizeof(decoded), NULL));
+}
+
+/*Tests_SRS_URL_ENCODE_01_009: [ If text contains a character that would have been encoded, URL_DecodeInto shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(URL_DecodeInto_with_reserved_character_fails)
+{
+    // arrange
+    char decoded[16];
+    size_t decodedLength;
+
+    // act
+    int result = URL_DecodeInto("hello world", 11, decoded, sizeof(decoded), &decodedLength);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_URL_ENCODE_01_010: [ If a % is not followed by 2 hexadecimal digits encoding a 7-bit character, URL_DecodeInto shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(URL_DecodeInto_with_invalid_percent_encoding_fails)
+{
+    // arrange
+    char decoded[16];
+    size_t decodedLength;
+
+    // act
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_DecodeInto("abc%2", 5, decoded, sizeof(decoded), &decodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_DecodeInto("abc%2g", 6, decoded, sizeof(decoded), &decodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_DecodeInto("%c3%a9", 6, decoded, sizeof(decoded), &decodedLength));
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_DecodeInto("%20%2f", 5, decoded, sizeof(decoded), &decodedLength));
+}
+
+/*Tests_SRS_URL_ENCODE_01_011: [ If destinationSize is too small for the decoded text and its \0, URL_DecodeInto shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(URL_DecodeInto_with_small_destination_fails)
+{
+    // arrange
+    char decoded[16];
+    size_t decodedLength;
+
+    // act
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, URL_DecodeInto("hello%20world", 13, decoded, 11, &decodedLength));
+    ASSERT_ARE_EQUAL(int, 0, URL_DecodeInto("hello%20world", 13, decoded, 12, &decodedLength));
+    ASSERT_ARE_EQUAL(char_ptr, "hello world", decoded);
+}
+
+/*Tests_SRS_URL_ENCODE_01_001: [ URL_EncodeLength shall return the number of characters in the encoding of the first textLength characters of text, not counting the terminating \0. ]*/
+/*Tests_SRS_URL_ENCODE_01_005: [ URL_EncodeInto shall write the encoding of the first textLength characters of text followed by a \0 in destination, set encodedLength to the number of characters before the \0 and return 0. ]*/
+/*Tests_SRS_URL_ENCODE_01_006: [ Unreserved characters shall be copied, other 7-bit characters shall be encoded as %xx and 8-bit characters shall be taken as Latin-1 and encoded as their UTF-8 sequence %c2%xx or %c3%xx, using lower case hexadecimal digits. ]*/
+TEST_FUNCTION(URL_EncodeInto_with_a_reserved_character_anywhere_in_a_long_run_succeeds)
+{
+    static const char reserved[] = { ' ', '\'', '+', ',', '/', ':', '@', '[', '^', '`', '{', '~', '\x7f', '\x80', '\xc1', '\xff' };
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < sizeof(reserved); i++)
+    {
+        char single[8];
+        size_t singleLength;
+        ASSERT_ARE_EQUAL(int, 0, URL_EncodeInto(&reserved[i], 1, single, sizeof(single), &singleLength));
+
+        for (j = 0; j < sizeof(unreservedCharacters) - 1; j++)
+        {
+            // arrange
+            char text[sizeof(unreservedCharacters)];
+            char expected[sizeof(unreservedCharacters) + 8];
+            char encoded[sizeof(unreservedCharacters) + 8];
+            size_t encodedLength = 0;
+            int result;
+            (void)memcpy(text, unreservedCharacters, sizeof(unreservedCharacters));
+            text[j] = reserved[i];
+            (void)memcpy(expected, unreservedCharacters, j);
+            (void)memcpy(expected + j, single, singleLength);
+            (void)memcpy(expected + j + singleLength, unreservedCharacters + j + 1, sizeof(unreservedCharacters) - j - 1);
+
+            // act
+            result = URL_EncodeInto(text, sizeof(text) - 1, encoded, sizeof(encoded), &encodedLength);
+
+            // assert
+            ASSERT_ARE_EQUAL(int, 0, result);
+            ASSERT_ARE_EQUAL(char_ptr, expected, encoded);
+            ASSERT_ARE_EQUAL(size_t, strlen(expected), encodedLength);
+            ASSERT_ARE_EQUAL(size_t, encodedLength, URL_EncodeLength(text, sizeof(text) - 1));
+        }
+    }
+}
+
+/*Tests_SRS_URL_ENCODE_01_008: [ URL_DecodeInto shall write the decoding of the first textLength characters of text followed by a \0 in destination, set decodedLength to the number of characters before the \0 and return 0. ]*/
+TEST_FUNCTION(URL_DecodeInto_copies_a_long_run_of_unreserved_characters)
+{
+    // arrange
+    char decoded[sizeof(unreservedCharacters)];
+    size_t decodedLength = 0;
+
+    // act
+    int result = URL_DecodeInto(unreservedCharacters, sizeof(unreservedCharacters) - 1, decoded, sizeof(decoded), &decodedLength);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, unreservedCharacters, decoded);
+    ASSERT_ARE_EQUAL(size_t, sizeof(unreservedCharacters) - 1, decodedLength);
+}
+
+/*Tests_SRS_URL_ENCODE_01_009: [ If text contains a character that would have been encoded, URL_DecodeInto shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(URL_DecodeInto_with_a_reserved_character_anywhere_in_a_long_run_fails)
+{
+    size_t j;
+
+    for (j = 0; j < sizeof(unreservedCharacters) - 1; j++)
+    {
+        // arrange
+        char text[sizeof(unreservedCharacters)];
+        char decoded[sizeof(unreservedCharacters)];
+        size_t decodedLength;
+        int result;
+        (void)memcpy(text, unreservedCharacters, sizeof(unreservedCharacters));
+        text[j] = (j % 2 == 0) ? '/' : '\xe9';
+
+        // act
+        result = URL_DecodeInto(text, sizeof(text) - 1, decoded, sizeof(decoded), &decodedLength);
+
+        // assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+}
+
 END_TEST_SUITE(URLEncode_UnitTests)
@@ -16,6 +16,7 @@
 #else
 #include <stddef.h>
 #include <stdbool.h>
+#include <string.h>
 #endif
 
 #include "testrunnerswitcher.h"
@@ -561,4 +562,306 @@ TEST_FUNCTION(utf8_checker_with_4th_char_bad_fails)
     ASSERT_IS_FALSE(result);
 }
 
+/* Tests_SRS_UTF8_CHECKER_01_001: [ `utf8_checker_is_valid_utf8` shall verify that the sequence of chars pointed to by `utf8_str` represent UTF-8 encoded codepoints. ]*/
+/* Tests_SRS_UTF8_CHECKER_01_006: [ 00000000 0xxxxxxx 0xxxxxxx ]*/
+TEST_FUNCTION(utf8_checker_with_a_long_ascii_string_succeeds)
+{
+    // arrange
+    bool result;
+    unsigned char test_str[200];
+    size_t i;
+
+    for (i = 0; i < sizeof(test_str); i++)
+    {
+        test_str[i] = (unsigned char)(i & 0x7F);
+    }
+
+    // act
+    result = utf8_checker_is_valid_utf8(test_str, sizeof(test_str));
+
+    // assert
+    ASSERT_IS_TRUE(result);
+}
+
+/* Tests_SRS_UTF8_CHECKER_01_001: [ `utf8_checker_is_valid_utf8` shall verify that the sequence of chars pointed to by `utf8_str` represent UTF-8 encoded codepoints. ]*/
+TEST_FUNCTION(utf8_checker_with_a_bad_byte_anywhere_in_a_long_ascii_string_fails)
+{
+    // arrange
+    unsigned char test_str[200];
+    size_t i;
+
+    (void)memset(test_str, 'a', sizeof(test_str));
+
+    for (i = 0; i < sizeof(test_str); i++)
+    {
+        bool result;
+        test_str[i] = 0xBF;
+
+        // act
+        result = utf8_checker_is_valid_utf8(test_str, sizeof(test_str));
+
+        // assert
+        ASSERT_IS_FALSE(result);
+
+        test_str[i] = 'a';
+    }
+}
+
+/* Tests_SRS_UTF8_CHECKER_01_001: [ `utf8_checker_is_valid_utf8` shall verify that the sequence of chars pointed to by `utf8_str` represent UTF-8 encoded codepoints. ]*/
+/* Tests_SRS_UTF8_CHECKER_01_008: [ zzzzyyyy yyxxxxxx 1110zzzz 10yyyyyy 10xxxxxx ]*/
+TEST_FUNCTION(utf8_checker_with_a_multi_byte_char_anywhere_in_a_long_ascii_string_succeeds)
+{
+    // arrange
+    unsigned char test_str[200];
+    size_t i;
+
+    (void)memset(test_str, 'a', sizeof(test_str));
+
+    for (i = 0; i < sizeof(test_str) - 2; i++)
+    {
+        bool result;
+        test_str[i] = 0xE2;
+        test_str[i + 1] = 0x82;
+        test_str[i + 2] = 0xAC;
+
+        // act
+        result = utf8_checker_is_valid_utf8(test_str, sizeof(test_str));
+
+        // assert
+        ASSERT_IS_TRUE(result);
+
+        test_str[i] = 'a';
+        test_str[i + 1] = 'a';
+        test_str[i + 2] = 'a';
+    }
+}
+
+/* Tests_SRS_UTF8_CHECKER_01_001: [ `utf8_checker_is_valid_utf8` shall verify that the sequence of chars pointed to by `utf8_str` represent UTF-8 encoded codepoints. ]*/
+/* Tests_SRS_UTF8_CHECKER_01_009: [ 000uuuuu zzzzyyyy yyxxxxxx 11110uuu 10uuzzzz 10yyyyyy 10xxxxxx ]*/
+TEST_FUNCTION(utf8_checker_with_a_truncated_char_at_the_end_of_a_long_ascii_string_fails)
+{
+    // arrange
+    bool result;
+    unsigned char test_str[100];
+
+    (void)memset(test_str, 'a', sizeof(test_str));
+    test_str[sizeof(test_str) - 3] = 0xF0;
+    test_str[sizeof(test_str) - 2] = 0x90;
+    test_str[sizeof(test_str) - 1] = 0x80;
+
+    // act
+    result = utf8_checker_is_valid_utf8(test_str, sizeof(test_str));
+
+    // assert
+    ASSERT_IS_FALSE(result);
+}
+
+/* utf8_checker_state_init */
+
+/* Tests_SRS_UTF8_CHECKER_01_010: [ If `state` is NULL, `utf8_checker_state_init` shall return. ]*/
+TEST_FUNCTION(utf8_checker_state_init_with_NULL_state_returns)
+{
+    // arrange
+
+    // act
+    utf8_checker_state_init(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+/* Tests_SRS_UTF8_CHECKER_01_011: [ `utf8_checker_state_init` shall set `state` to the start of a message with no bytes seen. ]*/
+/* Tests_SRS_UTF8_CHECKER_01_017: [ `utf8_checker_is_complete` shall return true if the bytes seen so far are valid UTF-8 that does not end in the middle of a code point, and false otherwise. ]*/
+TEST_FUNCTION(utf8_checker_state_init_starts_a_complete_empty_message)
+{
+    // arrange
+    UTF8_CHECKER_STATE state;
+    bool result;
+
+    // act
+    utf8_checker_state_init(&state);
+    result = utf8_checker_is_complete(&state);
+
+    // assert
+    ASSERT_IS_TRUE(result);
+}
+
+/* utf8_checker_validate_fragment */
+
+/* Tests_SRS_UTF8_CHECKER_01_012: [ If `state` or `utf8_str` is NULL, `utf8_checker_validate_fragment` shall return false. ]*/
+TEST_FUNCTION(utf8_checker_validate_fragment_with_NULL_state_fails)
+{
+    // arrange
+    bool result;
+
+    // act
+    result = utf8_checker_validate_fragment(NULL, (const unsigned char*)"a", 1);
+
+    // assert
+    ASSERT_IS_FALSE(result);
+}
+
+/* Tests_SRS_UTF8_CHECKER_01_012: [ If `state` or `utf8_str` is NULL, `utf8_checker_validate_fragment` shall return false. ]*/
+TEST_FUNCTION(utf8_checker_validate_fragment_with_NULL_utf8_str_fails)
+{
+    // arrange
+    UTF8_CHECKER_STATE state;
+    bool result;
+    utf8_checker_state_init(&state);
+
+    // act
+    result = utf8_checker_validate_fragment(&state, NULL, 1);
+
+    // assert
+    ASSERT_IS_FALSE(result);
+}
+
+/* Tests_SRS_UTF8_CHECKER_01_013: [ `utf8_checker_validate_fragment` shall validate the bytes of `utf8_str` as the continuation of the bytes previously passed with `state`, so that a code point may be split across fragments. ]*/
+/* Tests_SRS_UTF8_CHECKER_01_014: [ `utf8_checker_validate_fragment` shall return false if the bytes seen so far cannot be the start of valid UTF-8, and true otherwise. ]*/
+/* Tests_SRS_UTF8_CHECKER_01_017: [ `utf8_checker_is_complete` shall return true if the bytes seen so far are valid UTF-8 that does not end in the middle of a code point, and false otherwise. ]*/
+TEST_FUNCTION(utf8_checker_validate_fragment_with_a_code_point_split_across_fragments_succeeds)
+{
+    // arrange
+    UTF8_CHECKER_STATE state;
+    unsigned char fragment_1[] = { 'a', 0xF0, 0x90 };
+    unsigned char fragment_2[] = { 0x80 };
+    unsigned char fragment_3[] = { 0x80, 'b' };
+    bool result_1;
+    bool result_2;
+    bool result_3;
+    utf8_checker_state_init(&state);
+
+    // act
+    result_1 = utf8_checker_validate_fragment(&state, fragment_1, sizeof(fragment_1));
+    ASSERT_IS_FALSE(utf8_checker_is_complete(&state));
+    result_2 = utf8_checker_validate_fragment(&state, fragment_2, sizeof(fragment_2));
+    ASSERT_IS_FALSE(utf8_checker_is_complete(&state));
+    result_3 = utf8_checker_validate_fragment(&state, fragment_3, sizeof(fragment_3));
+
+    // assert
+    ASSERT_IS_TRUE(result_1);
+    ASSERT_IS_TRUE(result_2);
+    ASSERT_IS_TRUE(result_3);
+    ASSERT_IS_TRUE(utf8_checker_is_complete(&state));
+}
+
+/* Tests_SRS_UTF8_CHECKER_01_013: [ `utf8_checker_validate_fragment` shall validate the bytes of `utf8_str` as the continuation of the bytes previously passed with `state`, so that a code point may be split across fragments. ]*/
+/* Tests_SRS_UTF8_CHECKER_01_014: [ `utf8_checker_validate_fragment` shall return false if the bytes seen so far cannot be the start of valid UTF-8, and true otherwise. ]*/
+TEST_FUNCTION(utf8_checker_validate_fragment_with_an_overlong_code_point_split_across_fragments_fails)
+{
+    // arrange
+    UTF8_CHECKER_STATE state;
+    unsigned char fragment_1[] = { 0xE0 };
+    unsigned char fragment_2[] = { 0x9F, 0xBF };
+    bool result_1;
+    bool result_2;
+    utf8_checker_state_init(&state);
+
+    // act
+    result_1 = utf8_checker_validate_fragment(&state, fragment_1, sizeof(fragment_1));
+    result_2 = utf8_checker_validate_fragment(&state, fragment_2, sizeof(fragment_2));
+
+    // assert
+    ASSERT_IS_TRUE(result_1);
+    ASSERT_IS_FALSE(result_2);
+    ASSERT_IS_FALSE(utf8_checker_is_complete(&state));
+}
+
+/* Tests_SRS_UTF8_CHECKER_01_013: [ `utf8_checker_validate_fragment` shall validate the bytes of `utf8_str` as the continuation of the bytes previously passed with `state`, so that a code point may be split across fragments. ]*/
+TEST_FUNCTION(utf8_checker_validate_fragment_with_an_ascii_byte_after_an_unfinished_code_point_fails)
+{
+    // arrange
+    UTF8_CHECKER_STATE state;
+    unsigned char fragment_1[] = { 'a', 0xC2 };
+    unsigned char fragment_2[] = { 'b' };
+    bool result;
+    utf8_checker_state_init(&state);
+    (void)utf8_checker_validate_fragment(&state, fragment_1, sizeof(fragment_1));
+
+    // act
+    result = utf8_checker_validate_fragment(&state, fragment_2, sizeof(fragment_2));
+
+    // assert
+    ASSERT_IS_FALSE(result);
+}
+
+/* Tests_SRS_UTF8_CHECKER_01_015: [ Once `utf8_checker_validate_fragment` returned false, it shall return false for every following fragment until `state` is initialized again. ]*/
+TEST_FUNCTION(utf8_checker_validate_fragment_after_a_failure_fails)
+{
+    // arrange
+    UTF8_CHECKER_STATE state;
+    unsigned char fragment_1[] = { 0xFF };
+    unsigned char fragment_2[] = { 'a' };
+    bool result;
+    utf8_checker_state_init(&state);
+    (void)utf8_checker_validate_fragment(&state, fragment_1, sizeof(fragment_1));
+
+    // act
+    result = utf8_checker_validate_fragment(&state, fragment_2, sizeof(fragment_2));
+
+    // assert
+    ASSERT_IS_FALSE(result);
+    ASSERT_IS_FALSE(utf8_checker_is_complete(&state));
+}
+
+/* Tests_SRS_UTF8_CHECKER_01_015: [ Once `utf8_checker_validate_fragment` returned false, it shall return false for every following fragment until `state` is initialized again. ]*/
+TEST_FUNCTION(utf8_checker_validate_fragment_after_init_following_a_failure_succeeds)
+{
+    // arrange
+    UTF8_CHECKER_STATE state;
+    unsigned char fragment_1[] = { 0xFF };
+    unsigned char fragment_2[] = { 'a' };
+    bool result;
+    utf8_checker_state_init(&state);
+    (void)utf8_checker_validate_fragment(&state, fragment_1, sizeof(fragment_1));
+    utf8_checker_state_init(&state);
+
+    // act
+    result = utf8_checker_validate_fragment(&state, fragment_2, sizeof(fragment_2));
+
+    // assert
+    ASSERT_IS_TRUE(result);
+    ASSERT_IS_TRUE(utf8_checker_is_complete(&state));
+}
+
+/* Tests_SRS_UTF8_CHECKER_01_013: [ `utf8_checker_validate_fragment` shall validate the bytes of `utf8_str` as the continuation of the bytes previously passed with `state`, so that a code point may be split across fragments. ]*/
+TEST_FUNCTION(utf8_checker_validate_fragment_with_every_split_matches_utf8_checker_is_valid_utf8)
+{
+    // arrange
+    unsigned char test_str[] = { 'a', 0xC2, 0x80, 0xE0, 0xA0, 0x80, 'b', 0xF0, 0x90, 0x80, 0x80, 0xEF, 0xBF, 0xBF, 'c' };
+    size_t split;
+
+    for (split = 0; split <= sizeof(test_str); split++)
+    {
+        UTF8_CHECKER_STATE state;
+        bool result_1;
+        bool result_2;
+        utf8_checker_state_init(&state);
+
+        // act
+        result_1 = utf8_checker_validate_fragment(&state, test_str, split);
+        result_2 = utf8_checker_validate_fragment(&state, test_str + split, sizeof(test_str) - split);
+
+        // assert
+        ASSERT_IS_TRUE(result_1);
+        ASSERT_IS_TRUE(result_2);
+        ASSERT_IS_TRUE(utf8_checker_is_complete(&state));
+    }
+}
+
+/* utf8_checker_is_complete */
+
+/* Tests_SRS_UTF8_CHECKER_01_016: [ If `state` is NULL, `utf8_checker_is_complete` shall return false. ]*/
+TEST_FUNCTION(utf8_checker_is_complete_with_NULL_state_fails)
+{
+    // arrange
+    bool result;
+
+    // act
+    result = utf8_checker_is_complete(NULL);
+
+    // assert
+    ASSERT_IS_FALSE(result);
+}
+
 END_TEST_SUITE(utf8_checker_ut)
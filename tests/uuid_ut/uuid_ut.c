@@ -16,6 +16,7 @@
 #define ENABLE_MOCKS
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/uniqueid.h"
+#include "azure_c_shared_utility/gb_rand.h"
 #undef ENABLE_MOCKS
 
 #include "azure_c_shared_utility/uuid.h"
@@ -47,6 +48,12 @@ static UNIQUEID_RESULT mock_UniqueId_Generate(char* uid, size_t bufferSize)
     return mock_UniqueId_Generate_result;
 }
 
+static unsigned char mock_gb_rand_bytes_value;
+static void mock_gb_rand_bytes(unsigned char* buffer, size_t length)
+{
+    (void)memset(buffer, mock_gb_rand_bytes_value, length);
+}
+
 static void initialize_variables()
 {
     mock_UniqueId_Generate_result = UNIQUEID_OK;
@@ -61,11 +68,13 @@ static void register_global_mock_returns()
 static void register_global_function_hooks()
 {
     REGISTER_GLOBAL_MOCK_HOOK(UniqueId_Generate, mock_UniqueId_Generate);
+    REGISTER_GLOBAL_MOCK_HOOK(gb_rand_bytes, mock_gb_rand_bytes);
 }
 
 static void register_mock_aliases()
 {
     REGISTER_UMOCK_ALIAS_TYPE(UNIQUEID_RESULT, int);
+    REGISTER_UMOCK_ALIAS_TYPE(unsigned char*, void*);
 }
 
 
@@ -328,4 +337,179 @@ TEST_FUNCTION(UUID_from_string_succeed)
 // Tests_SRS_UUID_09_009: [ If `uuid` fails to be generated, UUID_from_string shall return a non-zero value ]
 // To be implemented once sscanf mock is implemented.
 
+// Tests_SRS_UUID_01_001: [ If `uuids` is NULL or `count` is 0, UUID_generate_n shall return a non-zero value ]
+TEST_FUNCTION(UUID_generate_n_NULL_uuids)
+{
+    //Arrange
+    int result;
+
+    umock_c_reset_all_calls();
+
+    //Act
+    result = UUID_generate_n(NULL, 1);
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_UUID_01_001: [ If `uuids` is NULL or `count` is 0, UUID_generate_n shall return a non-zero value ]
+TEST_FUNCTION(UUID_generate_n_zero_count)
+{
+    //Arrange
+    int result;
+    UUID_T uuid;
+
+    umock_c_reset_all_calls();
+
+    //Act
+    result = UUID_generate_n(&uuid, 0);
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_UUID_01_002: [ If the size of `count` UUIDs does not fit in a size_t, UUID_generate_n shall return a non-zero value ]
+TEST_FUNCTION(UUID_generate_n_count_too_large)
+{
+    //Arrange
+    int result;
+    UUID_T uuid;
+
+    umock_c_reset_all_calls();
+
+    //Act
+    result = UUID_generate_n(&uuid, ((size_t)-1) / sizeof(UUID_T) + 1);
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_UUID_01_003: [ UUID_generate_n shall fill the `count` UUIDs with random bytes obtained from gb_rand_bytes in a single call ]
+// Tests_SRS_UUID_01_004: [ UUID_generate_n shall set the version of each UUID to 4 (random) and its variant to the one of RFC 4122 ]
+// Tests_SRS_UUID_01_005: [ If no failures occur, UUID_generate_n shall return zero ]
+TEST_FUNCTION(UUID_generate_n_succeed)
+{
+    //Arrange
+    int result;
+    UUID_T uuids[3];
+    size_t i;
+    int j;
+
+    mock_gb_rand_bytes_value = 0xFF;
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, sizeof(uuids)));
+
+    //Act
+    result = UUID_generate_n(uuids, 3);
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    for (i = 0; i < 3; i++)
+    {
+        for (j = 0; j < UUID_OCTET_COUNT; j++)
+        {
+            int expected = (j == 6) ? 0x4F : ((j == 8) ? 0xBF : 0xFF);
+            ASSERT_ARE_EQUAL(int, expected, uuids[i][j]);
+        }
+    }
+}
+
+// Tests_SRS_UUID_01_004: [ UUID_generate_n shall set the version of each UUID to 4 (random) and its variant to the one of RFC 4122 ]
+TEST_FUNCTION(UUID_generate_n_sets_version_and_variant_bits)
+{
+    //Arrange
+    int result;
+    UUID_T uuid;
+    char uuid_string[UUID_STRING_BUFFER_SIZE];
+
+    mock_gb_rand_bytes_value = 0x00;
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, sizeof(uuid)));
+
+    //Act
+    result = UUID_generate_n(&uuid, 1);
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, UUID_to_string_into(&uuid, uuid_string, sizeof(uuid_string)));
+    ASSERT_ARE_EQUAL(char_ptr, "00000000-0000-4000-8000-000000000000", uuid_string);
+}
+
+// Tests_SRS_UUID_01_006: [ If `uuid` or `destination` is NULL, UUID_to_string_into shall return a non-zero value ]
+TEST_FUNCTION(UUID_to_string_into_NULL_uuid)
+{
+    //Arrange
+    int result;
+    char uuid_string[UUID_STRING_BUFFER_SIZE];
+
+    umock_c_reset_all_calls();
+
+    //Act
+    result = UUID_to_string_into(NULL, uuid_string, sizeof(uuid_string));
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_UUID_01_006: [ If `uuid` or `destination` is NULL, UUID_to_string_into shall return a non-zero value ]
+TEST_FUNCTION(UUID_to_string_into_NULL_destination)
+{
+    //Arrange
+    int result;
+
+    umock_c_reset_all_calls();
+
+    //Act
+    result = UUID_to_string_into(&TEST_UUID, NULL, UUID_STRING_BUFFER_SIZE);
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_UUID_01_007: [ If `destinationSize` is less than UUID_STRING_BUFFER_SIZE, UUID_to_string_into shall return a non-zero value ]
+TEST_FUNCTION(UUID_to_string_into_destination_too_small)
+{
+    //Arrange
+    int result;
+    char uuid_string[UUID_STRING_BUFFER_SIZE];
+
+    umock_c_reset_all_calls();
+
+    //Act
+    result = UUID_to_string_into(&TEST_UUID, uuid_string, UUID_STRING_BUFFER_SIZE - 1);
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+// Tests_SRS_UUID_01_008: [ UUID_to_string_into shall write each byte of `uuid` as a 2-digit lowercase HEX value, with dashes as per RFC 4122, followed by a null character ]
+// Tests_SRS_UUID_01_009: [ If no failures occur, UUID_to_string_into shall return zero ]
+TEST_FUNCTION(UUID_to_string_into_succeed)
+{
+    //Arrange
+    int result;
+    char uuid_string[UUID_STRING_BUFFER_SIZE];
+
+    umock_c_reset_all_calls();
+
+    //Act
+    result = UUID_to_string_into(&TEST_UUID, uuid_string, sizeof(uuid_string));
+
+    //Assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, TEST_UUID_STRING, uuid_string);
+}
+
 END_TEST_SUITE(uuid_unittests)
@@ -498,6 +498,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(pfCloneOption, void*);
     REGISTER_UMOCK_ALIAS_TYPE(pfSetOption, void*);
     REGISTER_UMOCK_ALIAS_TYPE(pfDestroyOption, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(unsigned char*, void*);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -2808,9 +2809,10 @@ TEST_FUNCTION(on_underlying_io_open_complete_with_OK_prepares_and_sends_the_WebS
     /* get the random 16 bytes */
     for (i = 0; i < 16; i++)
     {
-        EXPECTED_CALL(gb_rand()).SetReturn((int)i);
         expected_nonce[i] = (unsigned char)i;
     }
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 16))
+        .CopyOutArgumentBuffer_buffer(expected_nonce, sizeof(expected_nonce));
 
     STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 16))
         .ValidateArgumentBuffer(1, expected_nonce, 16);
@@ -2853,9 +2855,10 @@ TEST_FUNCTION(when_base64_encode_fails_on_underlying_io_open_complete_triggers_t
     /* get the random 16 bytes */
     for (i = 0; i < 16; i++)
     {
-        EXPECTED_CALL(gb_rand()).SetReturn((int)i);
         expected_nonce[i] = (unsigned char)i;
     }
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 16))
+        .CopyOutArgumentBuffer_buffer(expected_nonce, sizeof(expected_nonce));
 
     STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 16))
         .ValidateArgumentBuffer(1, expected_nonce, 16)
@@ -2891,9 +2894,10 @@ TEST_FUNCTION(when_allocating_memory_for_the_websocket_upgrade_request_fails_the
     /* get the random 16 bytes */
     for (i = 0; i < 16; i++)
     {
-        EXPECTED_CALL(gb_rand()).SetReturn((int)i);
         expected_nonce[i] = (unsigned char)i;
     }
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 16))
+        .CopyOutArgumentBuffer_buffer(expected_nonce, sizeof(expected_nonce));
 
     STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 16))
         .ValidateArgumentBuffer(1, expected_nonce, 16);
@@ -2934,9 +2938,10 @@ TEST_FUNCTION(uws_client_open_async_after_WS_OPEN_ERROR_NOT_ENOUGH_MEMORY_succee
     /* get the random 16 bytes */
     for (i = 0; i < 16; i++)
     {
-        EXPECTED_CALL(gb_rand()).SetReturn((int)i);
         expected_nonce[i] = (unsigned char)i;
     }
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 16))
+        .CopyOutArgumentBuffer_buffer(expected_nonce, sizeof(expected_nonce));
 
     STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 16))
         .ValidateArgumentBuffer(1, expected_nonce, 16);
@@ -2985,9 +2990,10 @@ TEST_FUNCTION(when_sending_the_upgrade_request_fails_the_error_WS_OPEN_ERROR_CAN
     /* get the random 16 bytes */
     for (i = 0; i < 16; i++)
     {
-        EXPECTED_CALL(gb_rand()).SetReturn((int)i);
         expected_nonce[i] = (unsigned char)i;
     }
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 16))
+        .CopyOutArgumentBuffer_buffer(expected_nonce, sizeof(expected_nonce));
 
     STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 16))
         .ValidateArgumentBuffer(1, expected_nonce, 16);
@@ -3034,9 +3040,10 @@ TEST_FUNCTION(uws_client_open_async_after_WS_OPEN_ERROR_CANNOT_SEND_UPGRADE_REQU
     /* get the random 16 bytes */
     for (i = 0; i < 16; i++)
     {
-        EXPECTED_CALL(gb_rand()).SetReturn((int)i);
         expected_nonce[i] = (unsigned char)i;
     }
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 16))
+        .CopyOutArgumentBuffer_buffer(expected_nonce, sizeof(expected_nonce));
 
     STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 16))
         .ValidateArgumentBuffer(1, expected_nonce, 16);
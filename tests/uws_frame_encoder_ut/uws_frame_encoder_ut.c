@@ -101,6 +101,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_HOOK(BUFFER_enlarge, real_BUFFER_enlarge);
 
     REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(unsigned char*, void*);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -884,7 +885,7 @@ TEST_FUNCTION(uws_frame_encoder_encodes_a_reserved_control_frame_F)
 }
 
 /* Tests_SRS_UWS_FRAME_ENCODER_01_015: [ Defines whether the "Payload data" is masked. ]*/
-/* Tests_SRS_UWS_FRAME_ENCODER_01_053: [ In order to obtain a 32 bit value for masking, `gb_rand` shall be used 4 times (for each byte). ]*/
+/* Tests_SRS_UWS_FRAME_ENCODER_01_053: [ In order to obtain a 32 bit value for masking, `gb_rand_bytes` shall be called to fill the 4 bytes of the masking key. ]*/
 /* Tests_SRS_UWS_FRAME_ENCODER_01_016: [ If set to 1, a masking key is present in masking-key, and this is used to unmask the "Payload data" as per Section 5.3. ]*/
 /* Tests_SRS_UWS_FRAME_ENCODER_01_026: [ This field is present if the mask bit is set to 1 and is absent if the mask bit is set to 0. ]*/
 /* Tests_SRS_UWS_FRAME_ENCODER_01_042: [ The payload length, indicated in the framing as frame-payload-length, does NOT include the length of the masking key. ]*/
@@ -893,6 +894,7 @@ TEST_FUNCTION(uws_frame_encoder_encode_encodes_a_masked_zero_length_binary_frame
     // arrange
     BUFFER_HANDLE result;
     BUFFER_HANDLE newly_created_buffer;
+    unsigned char masking_key[] = { 0xFF, 0xFF, 0xFF, 0xFF };
     unsigned char expected_bytes[] = { 0x82, 0x80, 0xFF, 0xFF, 0xFF, 0xFF };
 
     STRICT_EXPECTED_CALL(BUFFER_new())
@@ -901,14 +903,8 @@ TEST_FUNCTION(uws_frame_encoder_encode_encodes_a_masked_zero_length_binary_frame
         .ValidateArgumentValue_handle(&newly_created_buffer);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
         .ValidateArgumentValue_handle(&newly_created_buffer);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 4))
+        .CopyOutArgumentBuffer_buffer(masking_key, sizeof(masking_key));
 
     // act
     result = uws_frame_encoder_encode(WS_BINARY_FRAME, NULL, 0, true, true, 0);
@@ -925,7 +921,7 @@ TEST_FUNCTION(uws_frame_encoder_encode_encodes_a_masked_zero_length_binary_frame
 }
 
 /* Tests_SRS_UWS_FRAME_ENCODER_01_015: [ Defines whether the "Payload data" is masked. ]*/
-/* Tests_SRS_UWS_FRAME_ENCODER_01_053: [ In order to obtain a 32 bit value for masking, `gb_rand` shall be used 4 times (for each byte). ]*/
+/* Tests_SRS_UWS_FRAME_ENCODER_01_053: [ In order to obtain a 32 bit value for masking, `gb_rand_bytes` shall be called to fill the 4 bytes of the masking key. ]*/
 /* Tests_SRS_UWS_FRAME_ENCODER_01_016: [ If set to 1, a masking key is present in masking-key, and this is used to unmask the "Payload data" as per Section 5.3. ]*/
 /* Tests_SRS_UWS_FRAME_ENCODER_01_026: [ This field is present if the mask bit is set to 1 and is absent if the mask bit is set to 0. ]*/
 /* Tests_SRS_UWS_FRAME_ENCODER_01_042: [ The payload length, indicated in the framing as frame-payload-length, does NOT include the length of the masking key. ]*/
@@ -934,6 +930,7 @@ TEST_FUNCTION(uws_frame_encoder_encode_encodes_a_masked_zero_length_binary_frame
     // arrange
     BUFFER_HANDLE result;
     BUFFER_HANDLE newly_created_buffer;
+    unsigned char masking_key[] = { 0x42, 0x43, 0x44, 0x45 };
     unsigned char expected_bytes[] = { 0x82, 0x80, 0x42, 0x43, 0x44, 0x45 };
 
     STRICT_EXPECTED_CALL(BUFFER_new())
@@ -942,14 +939,8 @@ TEST_FUNCTION(uws_frame_encoder_encode_encodes_a_masked_zero_length_binary_frame
         .ValidateArgumentValue_handle(&newly_created_buffer);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
         .ValidateArgumentValue_handle(&newly_created_buffer);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x42);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x43);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x44);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x45);
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 4))
+        .CopyOutArgumentBuffer_buffer(masking_key, sizeof(masking_key));
 
     // act
     result = uws_frame_encoder_encode(WS_BINARY_FRAME, NULL, 0, true, true, 0);
@@ -1204,6 +1195,7 @@ TEST_FUNCTION(uws_frame_encoder_encode_masks_a_1_byte_frame_with_0_as_mask)
     // arrange
     BUFFER_HANDLE result;
     BUFFER_HANDLE newly_created_buffer;
+    unsigned char masking_key[] = { 0x00, 0x00, 0x00, 0x00 };
     unsigned char payload[] = { 0x42 };
     unsigned char expected_bytes[] = { 0x82, 0x81, 0x00, 0x00, 0x00, 0x00, 0x42 };
 
@@ -1213,14 +1205,8 @@ TEST_FUNCTION(uws_frame_encoder_encode_masks_a_1_byte_frame_with_0_as_mask)
         .ValidateArgumentValue_handle(&newly_created_buffer);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
         .ValidateArgumentValue_handle(&newly_created_buffer);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x00);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x00);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x00);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x00);
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 4))
+        .CopyOutArgumentBuffer_buffer(masking_key, sizeof(masking_key));
 
     // act
     result = uws_frame_encoder_encode(WS_BINARY_FRAME, payload, sizeof(payload), true, true, 0);
@@ -1250,6 +1236,7 @@ TEST_FUNCTION(uws_frame_encoder_encode_masks_a_1_byte_frame_with_0xFF_as_mask)
     // arrange
     BUFFER_HANDLE result;
     BUFFER_HANDLE newly_created_buffer;
+    unsigned char masking_key[] = { 0xFF, 0x00, 0x00, 0x00 };
     unsigned char payload[] = { 0x42 };
     unsigned char expected_bytes[] = { 0x82, 0x81, 0xFF, 0x00, 0x00, 0x00, 0xBD };
 
@@ -1259,14 +1246,8 @@ TEST_FUNCTION(uws_frame_encoder_encode_masks_a_1_byte_frame_with_0xFF_as_mask)
         .ValidateArgumentValue_handle(&newly_created_buffer);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
         .ValidateArgumentValue_handle(&newly_created_buffer);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x00);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x00);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x00);
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 4))
+        .CopyOutArgumentBuffer_buffer(masking_key, sizeof(masking_key));
 
     // act
     result = uws_frame_encoder_encode(WS_BINARY_FRAME, payload, sizeof(payload), true, true, 0);
@@ -1296,6 +1277,7 @@ TEST_FUNCTION(uws_frame_encoder_encode_masks_a_4_byte_frame_with_0xFF_as_mask)
     // arrange
     BUFFER_HANDLE result;
     BUFFER_HANDLE newly_created_buffer;
+    unsigned char masking_key[] = { 0xFF, 0xFF, 0xFF, 0xFF };
     unsigned char payload[] = { 0x42, 0x43, 0x44, 0x45 };
     unsigned char expected_bytes[] = { 0x82, 0x84, 0xFF, 0xFF, 0xFF, 0xFF, 0xBD, 0xBC, 0xBB, 0xBA };
 
@@ -1305,14 +1287,8 @@ TEST_FUNCTION(uws_frame_encoder_encode_masks_a_4_byte_frame_with_0xFF_as_mask)
         .ValidateArgumentValue_handle(&newly_created_buffer);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
         .ValidateArgumentValue_handle(&newly_created_buffer);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 4))
+        .CopyOutArgumentBuffer_buffer(masking_key, sizeof(masking_key));
 
     // act
     result = uws_frame_encoder_encode(WS_BINARY_FRAME, payload, sizeof(payload), true, true, 0);
@@ -1342,6 +1318,7 @@ TEST_FUNCTION(uws_frame_encoder_encode_masks_a_5_byte_frame_with_0xFF_as_mask)
     // arrange
     BUFFER_HANDLE result;
     BUFFER_HANDLE newly_created_buffer;
+    unsigned char masking_key[] = { 0xFF, 0xFF, 0xFF, 0xFF };
     unsigned char payload[] = { 0x42, 0x43, 0x44, 0x45, 0x01 };
     unsigned char expected_bytes[] = { 0x82, 0x85, 0xFF, 0xFF, 0xFF, 0xFF, 0xBD, 0xBC, 0xBB, 0xBA, 0xFE };
 
@@ -1351,14 +1328,8 @@ TEST_FUNCTION(uws_frame_encoder_encode_masks_a_5_byte_frame_with_0xFF_as_mask)
         .ValidateArgumentValue_handle(&newly_created_buffer);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
         .ValidateArgumentValue_handle(&newly_created_buffer);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 4))
+        .CopyOutArgumentBuffer_buffer(masking_key, sizeof(masking_key));
 
     // act
     result = uws_frame_encoder_encode(WS_BINARY_FRAME, payload, sizeof(payload), true, true, 0);
@@ -1388,6 +1359,7 @@ TEST_FUNCTION(uws_frame_encoder_encode_masks_a_8_byte_frame_with_different_mask_
     // arrange
     BUFFER_HANDLE result;
     BUFFER_HANDLE newly_created_buffer;
+    unsigned char masking_key[] = { 0x00, 0xFF, 0xAA, 0x42 };
     unsigned char payload[] = { 0x42, 0x43, 0x44, 0x45, 0x01, 0x02, 0xFF, 0xAA };
     unsigned char expected_bytes[] = { 0x82, 0x88, 0x00, 0xFF, 0xAA, 0x42, 0x42, 0xBC, 0xEE, 0x07, 0x01, 0xFD, 0x55, 0xE8 };
 
@@ -1397,14 +1369,8 @@ TEST_FUNCTION(uws_frame_encoder_encode_masks_a_8_byte_frame_with_different_mask_
         .ValidateArgumentValue_handle(&newly_created_buffer);
     STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG))
         .ValidateArgumentValue_handle(&newly_created_buffer);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x00);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xFF);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0xAA);
-    STRICT_EXPECTED_CALL(gb_rand())
-        .SetReturn(0x42);
+    STRICT_EXPECTED_CALL(gb_rand_bytes(IGNORED_PTR_ARG, 4))
+        .CopyOutArgumentBuffer_buffer(masking_key, sizeof(masking_key));
 
     // act
     result = uws_frame_encoder_encode(WS_BINARY_FRAME, payload, sizeof(payload), true, true, 0);
@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#endif
+
+/*traces are compiled out of this file, while src/xlogging.c keeps them*/
+#define XLOGGING_MAX_CATEGORY AZ_LOG_INFO
+
+#include "testrunnerswitcher.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+static LOGGER_LOG saved_log_function;
+static size_t log_call_count;
+static size_t evaluation_count;
+
+static void counting_logger(LOG_CATEGORY log_category, const char* file, const char* func, int line, unsigned int options, const char* format, ...)
+{
+    (void)log_category;
+    (void)file;
+    (void)func;
+    (void)line;
+    (void)options;
+    (void)format;
+    log_call_count++;
+}
+
+static int evaluate_argument(void)
+{
+    evaluation_count++;
+    return 42;
+}
+
+BEGIN_TEST_SUITE(xlogging_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(g_testByTest);
+    TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    saved_log_function = xlogging_get_log_function();
+    xlogging_set_log_function(counting_logger);
+    xlogging_set_max_category(AZ_LOG_TRACE);
+    log_call_count = 0;
+    evaluation_count = 0;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    xlogging_set_max_category(AZ_LOG_TRACE);
+    xlogging_set_log_function(saved_log_function);
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* xlogging_set_max_category */
+
+TEST_FUNCTION(xlogging_get_max_category_returns_what_was_set)
+{
+    // act
+    xlogging_set_max_category(AZ_LOG_ERROR);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, (int)AZ_LOG_ERROR, (int)xlogging_get_max_category());
+}
+
+TEST_FUNCTION(categories_up_to_the_maximum_are_logged)
+{
+    // arrange
+    xlogging_set_max_category(AZ_LOG_INFO);
+
+    // act
+    LogInfo("value %d", evaluate_argument());
+    LogError("value %d", evaluate_argument());
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 2, log_call_count);
+    ASSERT_ARE_EQUAL(size_t, 2, evaluation_count);
+}
+
+TEST_FUNCTION(a_category_above_the_runtime_maximum_is_skipped_without_evaluating_its_arguments)
+{
+    // arrange
+    xlogging_set_max_category(AZ_LOG_ERROR);
+
+    // act
+    LogInfo("value %d", evaluate_argument());
+    LOG(AZ_LOG_INFO, LOG_LINE, "value %d", evaluate_argument());
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, log_call_count);
+    ASSERT_ARE_EQUAL(size_t, 0, evaluation_count);
+}
+
+TEST_FUNCTION(errors_are_logged_at_any_maximum)
+{
+    // arrange
+    xlogging_set_max_category(AZ_LOG_ERROR);
+
+    // act
+    LogError("value %d", evaluate_argument());
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, log_call_count);
+}
+
+TEST_FUNCTION(a_category_above_XLOGGING_MAX_CATEGORY_is_compiled_out)
+{
+    // act
+    LOG(AZ_LOG_TRACE, LOG_LINE, "value %d", evaluate_argument());
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, log_call_count);
+    ASSERT_ARE_EQUAL(size_t, 0, evaluation_count);
+}
+
+/* LogBinary */
+
+TEST_FUNCTION(LogBinary_above_XLOGGING_MAX_CATEGORY_is_compiled_out)
+{
+    // arrange
+    unsigned char data[20] = { 0 };
+
+    // act
+    LogBinary("data", data, sizeof(data));
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, log_call_count);
+}
+
+TEST_FUNCTION(LogBinary_logs_a_header_and_a_line_per_16_bytes)
+{
+    // arrange
+    unsigned char data[20] = { 0 };
+
+    // act
+    (LogBinary)("data", data, sizeof(data));
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 3, log_call_count);
+}
+
+TEST_FUNCTION(LogBinary_when_traces_are_off_at_runtime_logs_nothing)
+{
+    // arrange
+    unsigned char data[20] = { 0 };
+    xlogging_set_max_category(AZ_LOG_INFO);
+
+    // act
+    (LogBinary)("data", data, sizeof(data));
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, log_call_count);
+}
+
+TEST_FUNCTION(LogBinary_without_a_log_function_logs_nothing)
+{
+    // arrange
+    unsigned char data[20] = { 0 };
+    xlogging_set_log_function(NULL);
+
+    // act
+    (LogBinary)("data", data, sizeof(data));
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, log_call_count);
+}
+
+END_TEST_SUITE(xlogging_ut)
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*
+ * Renders a file written by trace_logger as text, or as one JSON object per line with --json.
+ * The file has to come from a build with the same pointer size and TRACE_LOGGER_RECORD_SIZE.
+ *
+ * usage: trace_decoder [--json] trace_file
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "azure_c_shared_utility/trace_logger.h"
+
+int main(int argc, char** argv)
+{
+    int result;
+    TRACE_LOGGER_DECODE_FORMAT format = TRACE_LOGGER_DECODE_TEXT;
+    const char* path = NULL;
+
+    if ((argc == 2) && (strcmp(argv[1], "--json") != 0))
+    {
+        path = argv[1];
+    }
+    else if ((argc == 3) && (strcmp(argv[1], "--json") == 0))
+    {
+        format = TRACE_LOGGER_DECODE_JSON;
+        path = argv[2];
+    }
+
+    if (path == NULL)
+    {
+        (void)fprintf(stderr, "usage: trace_decoder [--json] trace_file\n");
+        result = 2;
+    }
+    else if (trace_logger_decode(path, stdout, format) != 0)
+    {
+        (void)fprintf(stderr, "cannot decode %s\n", path);
+        result = 1;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}